@@ -165,6 +165,20 @@ public:
 					case KEY_F11:
 						getProfiler().resetAll();
 					break;
+					case KEY_F12:
+					{
+						/*
+							The latest start/stop events of all threads can be written as trace.
+							Open it in chrome://tracing to see when each profiled part ran.
+						*/
+						IWriteFile* file = SceneManager->getFileSystem()->createAndWriteFile("profile_trace.json");
+						if ( file )
+						{
+							getProfiler().writeTrace(file, EPTF_CHROME_JSON);
+							file->drop();
+						}
+					}
+					break;
 					case KEY_KEY_F:
 						GuiProfiler->setFrozen(!GuiProfiler->getFrozen());
 					break;
@@ -363,14 +377,15 @@ int main()
 			L"<F9>  to reset the \"grp runtime\" data\n"
 			L"<F10> to reset the scope 3 data\n"
 			L"<F11> to reset all data\n"
+			L"<F12> to write a trace to profile_trace.json\n"
 			L"<f>   to freeze/unfreeze the display\n"
-			, recti(10,10, 250, 140), true, true, 0, -1, true);
+			, recti(10,10, 250, 152), true, true, 0, -1, true);
 	staticText->setWordWrap(false);
 
 	/*
 		IGUIProfiler is can be used to show active profiling data at runtime.
 	*/
-	receiver.GuiProfiler = env->addProfilerDisplay(core::recti(40, 140, 600, 470));
+	receiver.GuiProfiler = env->addProfilerDisplay(core::recti(40, 155, 600, 470));
 	receiver.GuiProfiler->setDrawBackground(true);
 
 	/*
@@ -24,6 +24,12 @@ namespace io
 		//! CLimitReadFile
 		ERFT_LIMIT_READ_FILE = MAKE_IRR_ID('r','l','i','m'),
 
+		//! CMappedReadFile, implements IMemoryReadFile
+		ERFT_MAPPED_READ_FILE = MAKE_IRR_ID('r','m','a','p'),
+
+		//! CBufferedReadFile
+		ERFT_BUFFERED_READ_FILE = MAKE_IRR_ID('r','b','u','f'),
+
 		//! Unknown type
 		EFIT_UNKNOWN        = MAKE_IRR_ID('u','n','k','n')
 	};
@@ -14,6 +14,7 @@
 #include "EGUIAlignment.h"
 #include "IAttributes.h"
 #include "IGUIEnvironment.h"
+#include "SGUIRectGrid.h"
 
 namespace irr
 {
@@ -32,7 +33,7 @@ public:
 		MaxSize(0,0), MinSize(1,1), IsVisible(true), IsEnabled(true),
 		IsSubElement(false), NoClip(false), ID(id), IsTabStop(false), TabOrder(-1), IsTabGroup(false),
 		AlignLeft(EGUIA_UPPERLEFT), AlignRight(EGUIA_UPPERLEFT), AlignTop(EGUIA_UPPERLEFT), AlignBottom(EGUIA_UPPERLEFT),
-		Environment(environment), Type(type)
+		Environment(environment), Type(type), ChildIndexDirty(true)
 	{
 		#ifdef _DEBUG
 		setDebugName("IGUIElement");
@@ -43,6 +44,7 @@ public:
 		{
 			parent->addChildToEnd(this);
 			recalculateAbsolutePosition(true);
+			invalidate();
 		}
 	}
 
@@ -150,6 +152,8 @@ public:
 	/** \param noClip If true, the element will not be clipped by its parent's clipping rectangle. */
 	void setNotClipped(bool noClip)
 	{
+		if (NoClip != noClip)
+			invalidateParentIndices(true);
 		NoClip = noClip;
 		updateAbsolutePosition();
 	}
@@ -266,10 +270,32 @@ public:
 		// we have to search from back to front, because later children
 		// might be drawn over the top of earlier ones.
 
-		core::list<IGUIElement*>::ConstIterator it = Children.getLast();
+		if (isVisible() && Children.size() >= 16)
+		{
+			// many children, only check those which can be hit at the point
+			updateChildIndex();
+
+			u32 cellCount;
+			const u32* cell = ChildIndex.getCell(point, cellCount);
+			const core::array<u32>& everywhere = ChildIndex.Everywhere;
+			s32 c = (s32)cellCount - 1;
+			s32 e = (s32)everywhere.size() - 1;
+			while (c >= 0 || e >= 0)
+			{
+				u32 id;
+				if (e < 0 || (c >= 0 && cell[c] > everywhere[e]))
+					id = cell[c--];
+				else
+					id = everywhere[e--];
 
-		if (isVisible())
+				target = IndexedChildren[id]->getElementFromPoint(point);
+				if (target)
+					return target;
+			}
+		}
+		else if (isVisible())
 		{
+			core::list<IGUIElement*>::ConstIterator it = Children.getLast();
 			while(it != Children.end())
 			{
 				target = (*it)->getElementFromPoint(point);
@@ -295,6 +321,27 @@ public:
 	}
 
 
+	//! Returns true if the element can only be hit inside of its clipping rectangle
+	/** The parent uses this for its index of the children. Elements which
+	override isPointInside or getElementFromPoint to be hit outside of
+	their clipping rectangle have to return false. */
+	virtual bool isHitInsideClippingRect() const
+	{
+		return true;
+	}
+
+
+	//! Marks the visible area of the element to be drawn again
+	/** Only needed when the dirty rectangle mode of the environment is
+	enabled and the element changed in a way which the environment
+	doesn't notice, see IGUIEnvironment::setDirtyRectangleMode(). */
+	void invalidate()
+	{
+		if (Environment)
+			Environment->invalidateRect(AbsoluteClippingRect);
+	}
+
+
 	//! Adds a GUI element as new child of this element.
 	virtual void addChild(IGUIElement* child)
 	{
@@ -302,6 +349,7 @@ public:
 		{
 			addChildToEnd(child);
 			child->updateAbsolutePosition();
+			child->invalidate();
 		}
 	}
 
@@ -312,6 +360,9 @@ public:
 		for (; it != Children.end(); ++it)
 			if ((*it) == child)
 			{
+				child->invalidate();
+				invalidateParentIndices(true);
+				ChildIndexDirty = true;
 				(*it)->Parent = 0;
 				(*it)->drop();
 				Children.erase(it);
@@ -382,6 +433,8 @@ public:
 	//! Sets the visible state of this element.
 	virtual void setVisible(bool visible)
 	{
+		if (IsVisible != visible)
+			invalidate();
 		IsVisible = visible;
 	}
 
@@ -500,6 +553,8 @@ public:
 	//! Sets the enabled state of this element.
 	virtual void setEnabled(bool enabled)
 	{
+		if (IsEnabled != enabled)
+			invalidate();
 		IsEnabled = enabled;
 	}
 
@@ -508,6 +563,7 @@ public:
 	virtual void setText(const wchar_t* text)
 	{
 		Text = text;
+		invalidate();
 	}
 
 
@@ -557,6 +613,8 @@ public:
 	/** \return True if successful, false if not. */
 	virtual bool bringToFront(IGUIElement* element)
 	{
+		if (!Children.empty() && element == *Children.getLast()) // already there
+			return true;
 		core::list<IGUIElement*>::Iterator it = Children.begin();
 		for (; it != Children.end(); ++it)
 		{
@@ -564,6 +622,8 @@ public:
 			{
 				Children.erase(it);
 				Children.push_back(element);
+				ChildIndexDirty = true;
+				element->invalidate();
 				return true;
 			}
 		}
@@ -585,6 +645,8 @@ public:
 			{
 				Children.erase(it);
 				Children.push_front(child);
+				ChildIndexDirty = true;
+				child->invalidate();
 				return true;
 			}
 		}
@@ -856,6 +918,8 @@ protected:
 			child->LastParentRect = getAbsolutePosition();
 			child->Parent = this;
 			Children.push_back(child);
+			ChildIndexDirty = true;
+			child->invalidateParentIndices(true);
 		}
 	}
 
@@ -972,9 +1036,20 @@ protected:
 		if (!Parent)
 			parentAbsoluteClip = AbsoluteRect;
 
+		const core::rect<s32> oldClippingRect(AbsoluteClippingRect);
 		AbsoluteClippingRect = AbsoluteRect;
 		AbsoluteClippingRect.clipAgainst(parentAbsoluteClip);
 
+		if (AbsoluteClippingRect != oldClippingRect)
+		{
+			if (Environment && IsVisible)
+			{
+				Environment->invalidateRect(oldClippingRect);
+				Environment->invalidateRect(AbsoluteClippingRect);
+			}
+			invalidateParentIndices(false);
+		}
+
 		LastParentRect = parentAbsolute;
 
 		if ( recursive )
@@ -988,6 +1063,56 @@ protected:
 		}
 	}
 
+	//! Marks the index of the children of the parent, or of all parents, as outdated
+	void invalidateParentIndices(bool allParents)
+	{
+		IGUIElement* p = Parent;
+		while (p)
+		{
+			p->ChildIndexDirty = true;
+			if (!allParents)
+				break;
+			p = p->Parent;
+		}
+	}
+
+	//! Returns true if this element and its children can only be hit inside of its clipping rectangle
+	bool isSubtreeHitInsideClippingRect() const
+	{
+		if (!isHitInsideClippingRect())
+			return false;
+
+		core::list<IGUIElement*>::ConstIterator it = Children.begin();
+		for (; it != Children.end(); ++it)
+		{
+			if ((*it)->NoClip || !(*it)->isSubtreeHitInsideClippingRect())
+				return false;
+		}
+		return true;
+	}
+
+	//! Puts the children into the grid of ChildIndex
+	void updateChildIndex()
+	{
+		if (!ChildIndexDirty && IndexedChildren.size() == Children.size())
+			return;
+
+		IndexedChildren.set_used(0);
+		ChildIndex.clear();
+
+		core::list<IGUIElement*>::ConstIterator it = Children.begin();
+		for (; it != Children.end(); ++it)
+		{
+			IndexedChildren.push_back(*it);
+			if ((*it)->isSubtreeHitInsideClippingRect())
+				ChildIndex.addRect((*it)->AbsoluteClippingRect);
+			else
+				ChildIndex.addRect(core::rect<s32>(1,1,0,0)); // invalid, checked everywhere
+		}
+		ChildIndex.build();
+		ChildIndexDirty = false;
+	}
+
 protected:
 
 	//! List of all children of this element
@@ -1059,6 +1184,17 @@ protected:
 
 	//! type of element
 	EGUI_ELEMENT_TYPE Type;
+
+	//! children in the order of the ids in ChildIndex
+	core::array<IGUIElement*> IndexedChildren;
+
+	//! grid of the clipping rectangles of the children for getElementFromPoint
+	SGUIRectGrid ChildIndex;
+
+	//! is ChildIndex outdated?
+	bool ChildIndexDirty;
+
+	friend class CGUIEnvironment;
 };
 
 
@@ -14,6 +14,7 @@
 #include "IXMLReader.h"
 #include "IXMLWriter.h"
 #include "path.h"
+#include "irrArray.h"
 
 namespace irr
 {
@@ -78,6 +79,32 @@ public:
 	            Can be set to false to control that size yourself, p.E when not the full size should be used for UI. */
 	virtual void drawAll(bool useScreenSize=true) = 0;
 
+	//! Enables drawing only the parts of the gui which changed
+	/** In this mode drawAll() keeps the gui in a render target texture of
+	the size of the root element and only draws the invalidated rectangles
+	of it again, then it draws the texture to the screen. The environment
+	invalidates the areas of elements which are added, removed, moved,
+	shown, hidden, enabled, disabled, hovered, focused or get input events.
+	Elements which change otherwise, like animations or texts set by the
+	application, need IGUIElement::invalidate() or invalidateRect().
+	As the texture has an opaque background this is meant for screens which
+	only show the gui, like tools or tests with the software drivers.
+	Drivers which can't render into textures of the screen size draw the
+	whole gui each frame.
+	\param enable True to enable the mode.
+	\param background Color of the texture below the gui. */
+	virtual void setDirtyRectangleMode(bool enable, video::SColor background=video::SColor(255,0,0,0)) = 0;
+
+	//! Returns true if the dirty rectangle mode is enabled
+	virtual bool getDirtyRectangleMode() const = 0;
+
+	//! Marks an area of the screen to be drawn again in the dirty rectangle mode
+	/** \param rect Area in screen coordinates. */
+	virtual void invalidateRect(const core::rect<s32>& rect) = 0;
+
+	//! Returns the areas which the last drawAll() drew again in the dirty rectangle mode
+	virtual const core::array<core::rect<s32> >& getRedrawnRectangles() const = 0;
+
 	//! Sets the focus to an element.
 	/** Causes a EGET_ELEMENT_FOCUS_LOST event followed by a
 	EGET_ELEMENT_FOCUSED event. If someone absorbed either of the events,
@@ -10,6 +10,7 @@
 #include "ITexture.h"
 #include "path.h"
 #include "irrArray.h"
+#include "rect.h"
 
 namespace irr
 {
@@ -46,6 +47,29 @@ public:
 	\return Pointer to newly created image, or 0 upon error. */
 	virtual IImage* loadImage(io::IReadFile* file) const = 0;
 
+	//! Check if the loader can decode parts of an image without decoding all of it
+	/** \return True if loadImagePart is implemented by this loader. */
+	virtual bool isImagePartLoadingSupported() const
+	{
+		return false;
+	}
+
+	//! Creates a surface from a part of the file, optionally downscaled
+	/** Loaders supporting this decode directly from the file and stop
+	reading once the requested area is complete, so creating thumbnails
+	or tiles only touches a fraction of the data.
+	\param file File handle to load from.
+	\param sourceRect Area of the image to load, in pixels of the
+	full resolution image. An empty rectangle selects the whole image.
+	\param scaleDenom The image is downscaled by this factor. Use
+	getImagePartRect() to find out the size of the resulting image.
+	\return Pointer to newly created image, or 0 upon error or when
+	isImagePartLoadingSupported() returns false. */
+	virtual IImage* loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const
+	{
+		return 0;
+	}
+
 	//! Creates a multiple surfaces from the file eg. whole cube map.
 	/** \param file File handle to check.
 	\param type Pointer to E_TEXTURE_TYPE where a recommended type of the texture will be stored.
@@ -59,6 +83,29 @@ public:
 };
 
 
+//! Get the area a part of an image covers once the image is downscaled
+/** \param imageSize Size of the full resolution image.
+\param sourceRect Area of the image in pixels of the full resolution image.
+An empty rectangle selects the whole image.
+\param scaleDenom Factor by which the image is downscaled.
+\return Area in pixels of the downscaled image, clipped against it. */
+inline core::rect<s32> getImagePartRect(const core::dimension2d<u32>& imageSize, const core::rect<s32>& sourceRect, u32 scaleDenom)
+{
+	const s32 scale = scaleDenom > 1 ? (s32)scaleDenom : 1;
+	const core::rect<s32> scaledImage(0, 0, (imageSize.Width+scale-1)/scale, (imageSize.Height+scale-1)/scale);
+
+	if (!sourceRect.isValid() || sourceRect.getArea() == 0)
+		return scaledImage;
+
+	core::rect<s32> part(core::max_(sourceRect.UpperLeftCorner.X, 0)/scale,
+		core::max_(sourceRect.UpperLeftCorner.Y, 0)/scale,
+		(core::max_(sourceRect.LowerRightCorner.X, 0)+scale-1)/scale,
+		(core::max_(sourceRect.LowerRightCorner.Y, 0)+scale-1)/scale);
+	part.clipAgainst(scaledImage);
+	return part;
+}
+
+
 } // end namespace video
 } // end namespace irr
 
@@ -0,0 +1,123 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_JOB_SYSTEM_H_INCLUDED__
+#define __I_JOB_SYSTEM_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+
+namespace irr
+{
+
+//! Function which a job calls, data is the pointer given when the job was added
+typedef void (*JobFunction)(void* data);
+
+//! Function which a parallel for job calls for the indices begin to end-1
+typedef void (*JobRangeFunction)(void* data, u32 begin, u32 end);
+
+//! Identifies a job to wait for it or to let other jobs depend on it
+/** Handles can be kept after the job is done, they only tell that it is
+done then. A default constructed handle belongs to no job and is always done. */
+struct SJobHandle
+{
+	SJobHandle() : Index(0xffffffff), Generation(0) {}
+
+	u32 Index;
+	u32 Generation;
+};
+
+//! Runs jobs on worker threads
+/** The device owns the job system, see IrrlichtDevice::getJobSystem(). Each
+thread has a queue of jobs and threads without jobs take the jobs of others.
+Jobs can depend on other jobs and only start when those are done. Jobs can be
+added from all threads, also from other jobs.
+
+The thread which created the device is the main thread and runs jobs while it
+waits for them. With one thread, see SIrrlichtCreationParameters::JobThreads,
+there are no worker threads and the main thread runs the jobs which it adds
+before the add functions return. Jobs added by other threads then run when the
+main thread waits or calls runMainThreadJobs. */
+class IJobSystem : public virtual IReferenceCounted
+{
+public:
+
+	//! Returns the number of threads which run jobs, including the main thread
+	virtual u32 getThreadCount() const = 0;
+
+	//! Adds a job
+	/** \param function Function which the job calls.
+	\param data Pointer passed to the function.
+	\param dependencies Jobs which have to be done before this job starts.
+	\param dependencyCount Number of handles in dependencies.
+	\return Handle of the job. */
+	virtual SJobHandle addJob(JobFunction function, void* data,
+		const SJobHandle* dependencies=0, u32 dependencyCount=0) = 0;
+
+	//! Adds a job which calls a function for the indices 0 to count-1 on all threads
+	/** The indices are passed in ranges of up to grainSize indices. The job is
+	done when the function returned for all of them.
+	\param function Function which is called for the ranges.
+	\param data Pointer passed to the function.
+	\param count Number of indices.
+	\param grainSize Largest number of indices in one call, 0 chooses ranges
+	which give each thread a few calls.
+	\param dependencies Jobs which have to be done before this job starts.
+	\param dependencyCount Number of handles in dependencies.
+	\return Handle of the job. */
+	virtual SJobHandle addParallelFor(JobRangeFunction function, void* data, u32 count, u32 grainSize=0,
+		const SJobHandle* dependencies=0, u32 dependencyCount=0) = 0;
+
+	//! Adds a job which only runs on the main thread
+	/** Use it to continue the work of other jobs where only the main thread
+	may work, like with the video driver. Main thread jobs run when the main
+	thread waits for jobs and in runMainThreadJobs, which IrrlichtDevice::run()
+	calls.
+	\param function Function which the job calls.
+	\param data Pointer passed to the function.
+	\param dependencies Jobs which have to be done before this job starts.
+	\param dependencyCount Number of handles in dependencies.
+	\return Handle of the job. */
+	virtual SJobHandle addMainThreadJob(JobFunction function, void* data,
+		const SJobHandle* dependencies=0, u32 dependencyCount=0) = 0;
+
+	//! Runs the main thread jobs which can start, only call it from the main thread
+	/** \return Number of jobs which ran. */
+	virtual u32 runMainThreadJobs() = 0;
+
+	//! Returns true when the job is done
+	virtual bool isDone(const SJobHandle& job) const = 0;
+
+	//! Runs jobs until the job is done
+	/** Jobs can wait for jobs which they added. Jobs which wait for main
+	thread jobs only go on when the main thread waits for jobs or calls
+	runMainThreadJobs. */
+	virtual void wait(const SJobHandle& job) = 0;
+
+	//! Runs jobs until all jobs are done, don't call it from jobs
+	virtual void waitForAll() = 0;
+
+	//! Returns true when called from the main thread
+	virtual bool isMainThread() const = 0;
+
+	//! Calls a function for the indices 0 to count-1 on all threads and returns when it is done
+	/** See addParallelFor. */
+	void parallelFor(JobRangeFunction function, void* data, u32 count, u32 grainSize=0)
+	{
+		wait(addParallelFor(function, data, count, grainSize));
+	}
+
+	//! Calls a function on the main thread and returns when it is done
+	/** Other threads wait for the main thread, see wait. */
+	void runOnMainThread(JobFunction function, void* data)
+	{
+		if (isMainThread())
+			function(data);
+		else
+			wait(addMainThreadJob(function, data));
+	}
+};
+
+} // end namespace irr
+
+#endif
@@ -94,6 +94,11 @@ public:
 	filtered with these levels. If you want to be a text displayed,
 	independent on what level filter is set, use ELL_NONE. */
 	virtual void log(const wchar_t* text, ELOG_LEVEL ll=ELL_INFORMATION) = 0;
+
+	//! Waits until all texts logged so far are printed out
+	/** Loggers which print texts in a thread of their own print them
+	some time after log returned, see SIrrlichtCreationParameters::LoggingThread. */
+	virtual void flush() {}
 };
 
 } // end namespace
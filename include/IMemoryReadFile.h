@@ -13,6 +13,8 @@ namespace io
 {
 
 	//! Interface providing read access to a memory read file.
+	/** Implemented by memory read files (ERFT_MEMORY_READ_FILE) and by
+	large files from disk which are mapped into memory (ERFT_MAPPED_READ_FILE). */
 	class IMemoryReadFile : public IReadFile
 	{
 	public:
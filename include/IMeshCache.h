@@ -89,7 +89,7 @@ namespace scene
 		//! Get the name of a loaded mesh, based on its index. (Name is often identical to the filename).
 		/** \deprecated Use getMeshName() instead. This method may be removed by
 		Irrlicht 1.9 */
-		_IRR_DEPRECATED_ const io::path& getMeshFilename(u32 index) const
+		_IRR_DEPRECATED_ io::path getMeshFilename(u32 index) const
 		{
 			return getMeshName(index).getInternalName();
 		}
@@ -97,7 +97,7 @@ namespace scene
 		//! Get the name of a loaded mesh, if there is any. (Name is often identical to the filename).
 		/** \deprecated Use getMeshName() instead. This method may be removed by
 		Irrlicht 1.9 */
-		_IRR_DEPRECATED_ const io::path& getMeshFilename(const IMesh* const mesh) const
+		_IRR_DEPRECATED_ io::path getMeshFilename(const IMesh* const mesh) const
 		{
 			return getMeshName(mesh).getInternalName();
 		}
@@ -125,13 +125,15 @@ namespace scene
 
 		//! Get the name of a loaded mesh, based on its index.
 		/** \param index: Index of the mesh, number between 0 and getMeshCount()-1.
+		The name is returned as a copy, as mesh load requests can add
+		meshes on other threads in the meantime.
 		\return The name if mesh was found and has a name, else the path is empty. */
-		virtual const io::SNamedPath& getMeshName(u32 index) const = 0;
+		virtual io::SNamedPath getMeshName(u32 index) const = 0;
 
 		//! Get the name of the loaded mesh if there is any.
 		/** \param mesh Pointer to mesh to query.
 		\return The name if mesh was found and has a name, else the path is empty. */
-		virtual const io::SNamedPath& getMeshName(const IMesh* const mesh) const = 0;
+		virtual io::SNamedPath getMeshName(const IMesh* const mesh) const = 0;
 
 		//! Renames a loaded mesh.
 		/** Note that renaming meshes might change the ordering of the
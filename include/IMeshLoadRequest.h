@@ -0,0 +1,49 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_MESH_LOAD_REQUEST_H_INCLUDED__
+#define __I_MESH_LOAD_REQUEST_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+#include "IJobSystem.h"
+#include "path.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IAnimatedMesh;
+
+	//! A mesh which is loaded on a job thread, see ISceneManager::createMeshLoadRequest()
+	/** The request is done when the mesh was loaded and added to the mesh
+	cache, or when loading it failed. */
+	class IMeshLoadRequest : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Returns the name of the mesh in the mesh cache
+		virtual const io::path& getName() const = 0;
+
+		//! Returns true when the mesh was loaded or loading it failed
+		virtual bool isDone() const = 0;
+
+		//! Returns the loaded mesh
+		/** \return The mesh, or 0 while the request is not done or when
+		loading failed. The mesh cache holds the mesh, so don't drop it. */
+		virtual IAnimatedMesh* getMesh() const = 0;
+
+		//! Runs jobs until the request is done, only call it from the main thread
+		/** \return The loaded mesh, or 0 when loading failed. */
+		virtual IAnimatedMesh* wait() = 0;
+
+		//! Returns the job which loads the mesh
+		/** Other jobs can depend on it to use the mesh when it is loaded. */
+		virtual SJobHandle getJob() const = 0;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
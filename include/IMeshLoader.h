@@ -52,6 +52,18 @@ public:
 	See IReferenceCounted::drop() for more information. */
 	virtual IAnimatedMesh* createMesh(io::IReadFile* file) = 0;
 
+	//! Returns true if createMesh() may run on a job thread
+	/** See ISceneManager::createMeshLoadRequest(). The scene manager never
+	calls createMesh() of one loader on two threads at once. Thread safe
+	loaders use the video driver only through IVideoDriver::getTexture()
+	and IVideoDriver::makeNormalMapTexture(), which leave the work to the
+	main thread, and open no other files than the one they load. Their log
+	texts reach the event receiver on the main thread as well. */
+	virtual bool isThreadSafe() const
+	{
+		return false;
+	}
+
 	//! Set a new texture loader which this meshloader can use when searching for textures.
 	/** NOTE: Not all meshloaders do support this interface. Meshloaders which
 	support it will return a non-null value in getMeshTextureLoader from the start. Setting a
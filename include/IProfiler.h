@@ -15,11 +15,71 @@ namespace irr
 {
 
 class ITimer;
+class CProfiler;
+
+namespace io
+{
+	class IWriteFile;
+}
+
+//! Formats for IProfiler::writeTrace
+enum E_PROFILE_TRACE_FORMAT
+{
+	//! JSON which can be opened in chrome://tracing and similar trace viewers.
+	/** Each thread gets its own row, zones are begin/end event pairs with microsecond timestamps. */
+	EPTF_CHROME_JSON = 0,
+
+	//! Compact binary format, all numbers are little endian.
+	/** Header: "IRTR", u32 version (1), u32 number of ids, u32 number of threads.
+	Each id: s32 id, then the name and the group name, each as u32 length and utf-8 characters.
+	Each thread: u32 thread number, name as u32 length and characters, u32 number of events.
+	Each event: u64 nanoseconds since the profiler was created, s32 id, u32 1 for zone begin and 0 for zone end. */
+	EPTF_BINARY
+};
+
+//! Counters of the work done in a frame, see IProfiler::getCounter
+/** The engine only counts when it was compiled with _IRR_COMPILE_WITH_PROFILING_. */
+enum E_PROFILE_COUNTER
+{
+	//! Calls of IVideoDriver::drawVertexPrimitiveList
+	EPC_DRAW_CALLS = 0,
+
+	//! Primitives passed to the video driver
+	EPC_PRIMITIVES,
+
+	//! Triangles which the software renderers rasterized after clipping and culling
+	EPC_TRIANGLES,
+
+	//! Horizontal spans which the software renderers filled
+	EPC_SPANS,
+
+	//! Texels which the software renderers fetched, estimated from the covered area and the texture layers
+	EPC_TEXELS,
+
+	//! Vertex and index buffers copied to the hardware
+	EPC_BUFFER_UPLOADS,
+
+	//! Not a counter, only the number of counters
+	EPC_COUNT
+};
+
+//! Names of the counters for printing
+const c8* const ProfileCounterNames[] =
+{
+	"draw calls",
+	"primitives",
+	"triangles",
+	"spans",
+	"texels",
+	"buffer uploads",
+	0
+};
 
 //! Used to store the profile data (and also used for profile group data).
 struct SProfileData
 {
 	friend class IProfiler;
+	friend class CProfiler;
 
     SProfileData()
 	{
@@ -54,13 +114,27 @@ struct SProfileData
 	}
 
 	//! Longest time a profile call for this id took from start until it was stopped again.
+	/** In milliseconds */
 	u32 getLongestTime() const
 	{
-		return LongestTime;
+		return (u32)(LongestTime / 1000000);
 	}
 
 	//! Time spend between start/stop
+	/** In milliseconds */
 	u32 getTimeSum() const
+	{
+		return (u32)(TimeSum / 1000000);
+	}
+
+	//! Longest time a profile call for this id took, in nanoseconds.
+	u64 getLongestTimeNs() const
+	{
+		return LongestTime;
+	}
+
+	//! Time spend between start/stop, in nanoseconds.
+	u64 getTimeSumNs() const
 	{
 		return TimeSum;
 	}
@@ -75,28 +149,26 @@ private:
 		CountCalls = 0;
 		LongestTime = 0;
 		TimeSum = 0;
-		LastTimeStarted = 0;
-		StartStopCounter = 0;
 	}
 
 	s32 Id;
     u32 GroupIndex;
 	core::stringw Name;
 
-	s32 StartStopCounter; // 0 means stopped > 0 means it runs.
-    u32 CountCalls;
-    u32 LongestTime;
-    u32 TimeSum;
-
-    u32 LastTimeStarted;
+	// changed by all threads which profile this id. Start times and run counters are kept per thread.
+    volatile s32 CountCalls;
+    volatile u64 LongestTime;	// nanoseconds
+    volatile u64 TimeSum;	// nanoseconds
 };
 
 //! Code-profiler. Please check the example in the Irrlicht examples folder about how to use it.
 // Implementer notes:
 // The design is all about allowing to use the central start/stop mechanism with minimal time overhead.
-// This is why the class works without a virtual functions interface contrary to the usual Irrlicht design.
+// This is why the class works mostly without a virtual functions interface contrary to the usual Irrlicht design.
 // And also why it works with id's instead of strings in the start/stop functions even if it makes using
-// the class slightly harder.
+// the class slightly harder. start/stop find the data for an id in lookup tables and then make a single
+// virtual call into the implementation, which owns the clock and the per-thread state.
+// start/stop can be called from any thread, but all ids should be added before other threads use them.
 // The class comes without reference-counting because the profiler instance is never released (TBD).
 class IProfiler
 {
@@ -136,7 +208,7 @@ public:
 	inline bool findDataIndex(u32 & result, const core::stringw &name) const;
 
 	//! Get the profile data
-	/** \param index A value between 0 and getProfileDataCount()-1.	Indices can change when new id's are added.*/
+	/** \param index A value between 0 and getProfileDataCount()-1. Indices don't change when new id's are added.*/
     const SProfileData& getProfileDataByIndex(u32 index) const
     {
 		return ProfileDatas[index];
@@ -170,6 +242,7 @@ public:
 
 	//! Start profile-timing for the given id
 	/** This increases an internal run-counter for the given id. It will profile as long as that counter is > 0.
+	Each thread has its own run-counters.
 	NOTE: you have to add the id first with one of the ::add functions
 	*/
 	inline void start(s32 id);
@@ -205,10 +278,61 @@ public:
 	\param groupIndex_	*/
     virtual void printGroup(core::stringw &result, u32 groupIndex, bool suppressUncalled) const = 0;
 
+	//! Write the latest start/stop events of all threads into a file
+	/** Each thread keeps its most recent events in a ring buffer, older events are dropped.
+	Threads which profile while the trace is written can lose a few of their oldest events.
+	\param file Receives the trace.
+	\param format Format of the trace.
+	\return true when the trace was written. */
+	virtual bool writeTrace(io::IWriteFile* file, E_PROFILE_TRACE_FORMAT format=EPTF_CHROME_JSON) const = 0;
+
+	//! Removes the recorded events of all threads
+	/** No other thread should profile during this call. */
+	virtual void clearTrace() = 0;
+
+	//! Name the calling thread in traces
+	virtual void setThreadName(const core::stringc& name) = 0;
+
+	//! Add time which was measured without start/stop to the data of an id
+	/** Meant for code which runs too often and too short to profile each run, like the stages of a renderer.
+	The times are summed up first and then added once, which counts as a single call. They are not written to traces.
+	\param id Any id which you did add to the profiler before.
+	\param nanoseconds The measured time. */
+	inline void addTime(s32 id, u64 nanoseconds);
+
+	//! Add to a counter of the current frame
+	/** Can be called from any thread. */
+	virtual void addToCounter(E_PROFILE_COUNTER counter, u64 value) = 0;
+
+	//! Get the value of a counter
+	/** \param counter Which counter
+	\param lastFrame When true the value of the last finished frame, otherwise what was counted since then.
+	\return Value of the counter */
+	virtual u64 getCounter(E_PROFILE_COUNTER counter, bool lastFrame=true) const = 0;
+
+	//! Finish the frame of the counters
+	/** The video drivers call it in endScene, applications without a video driver can call it themselves. */
+	virtual void endFrame() = 0;
+
 protected:
 
     inline u32 addGroup(const core::stringw &name);
 
+	//! Index of the profile data for id or -1 when it does not exist
+	inline s32 getDataIndex(s32 id) const;
+
+	//! Find the lookup table and the position in it for id, false when it is too far from the usual id's
+	inline static bool getLookupSlot(s32 id, u32& table, u32& slot);
+
+	//! Start profile-timing for ProfileDatas[index] in the calling thread
+	virtual void startIndex(u32 index) = 0;
+
+	//! Stop profile-timing for ProfileDatas[index] in the calling thread
+	virtual void stopIndex(u32 index) = 0;
+
+	//! Add a measured time to ProfileDatas[index]
+	virtual void addTimeIndex(u32 index, u64 nanoseconds) = 0;
+
 	// I would prefer using os::Timer, but os.h is not in the public interface so far.
 	// Timer must be initialized by the implementation.
     ITimer * Timer;
@@ -216,6 +340,10 @@ protected:
     core::array<SProfileData> ProfileGroups;
 
 private:
+	//! Index into ProfileDatas per id, -1 for unused id's.
+	//! The tables hold the ids counting up from -INT_MAX (Irrlicht), up from 0 (applications) and down from INT_MAX (automatic).
+	core::array<s32> IdLookup[3];
+
     s32 NextAutoId;	// for giving out id's automatically
 };
 
@@ -280,50 +408,60 @@ protected:
 
 void IProfiler::start(s32 id)
 {
-	s32 idx = ProfileDatas.binary_search(SProfileData(id));
-	if ( idx >= 0 && Timer )
+	const s32 idx = getDataIndex(id);
+	if ( idx >= 0 )
+		startIndex((u32)idx);
+}
+
+void IProfiler::stop(s32 id)
+{
+	const s32 idx = getDataIndex(id);
+	if ( idx >= 0 )
+		stopIndex((u32)idx);
+}
+
+void IProfiler::addTime(s32 id, u64 nanoseconds)
+{
+	const s32 idx = getDataIndex(id);
+	if ( idx >= 0 )
+		addTimeIndex((u32)idx, nanoseconds);
+}
+
+bool IProfiler::getLookupSlot(s32 id, u32& table, u32& slot)
+{
+	// a direct lookup for the first few thousand ids of each range, larger tables would just waste memory
+	const u32 MAX_LOOKUP_SLOTS = 4096;
+
+	if ( id < 0 )
+	{
+		table = 0;
+		slot = (u32)(id + INT_MAX);	// INT_MIN wraps to a large slot
+	}
+	else if ( id > INT_MAX/2 )
 	{
-		++ProfileDatas[idx].StartStopCounter;
-		if (ProfileDatas[idx].StartStopCounter == 1 )
-			ProfileDatas[idx].LastTimeStarted = Timer->getRealTime();
+		table = 2;
+		slot = (u32)(INT_MAX - id);
 	}
+	else
+	{
+		table = 1;
+		slot = (u32)id;
+	}
+	return slot < MAX_LOOKUP_SLOTS;
 }
 
-void IProfiler::stop(s32 id)
+s32 IProfiler::getDataIndex(s32 id) const
 {
-	if ( Timer )
+	u32 table, slot;
+	if ( getLookupSlot(id, table, slot) )
+		return slot < IdLookup[table].size() ? IdLookup[table][slot] : -1;
+
+	for ( u32 i=0; i < ProfileDatas.size(); ++i )
 	{
-		u32 timeNow = Timer->getRealTime();
-		s32 idx = ProfileDatas.binary_search(SProfileData(id));
-		if ( idx >= 0 )
-		{
-			SProfileData &data = ProfileDatas[idx];
-			--ProfileDatas[idx].StartStopCounter;
-			if ( data.LastTimeStarted != 0 && ProfileDatas[idx].StartStopCounter == 0)
-			{
-				// update data for this id
-				++data.CountCalls;
-				u32 diffTime = timeNow - data.LastTimeStarted;
-				data.TimeSum += diffTime;
-				if ( diffTime > data.LongestTime )
-					data.LongestTime = diffTime;
-				data.LastTimeStarted = 0;
-
-				// update data of it's group
-				SProfileData & group = ProfileGroups[data.GroupIndex];
-				++group.CountCalls;
-				group.TimeSum += diffTime;
-				if ( diffTime > group.LongestTime )
-					group.LongestTime = diffTime;
-				group.LastTimeStarted = 0;
-			}
-			else if ( ProfileDatas[idx].StartStopCounter < 0 )
-			{
-				// ignore additional stop calls
-				ProfileDatas[idx].StartStopCounter = 0;
-			}
-		}
+		if ( ProfileDatas[i].Id == id )
+			return (s32)i;
 	}
+	return -1;
 }
 
 s32 IProfiler::add(const core::stringw &name, const core::stringw &groupName)
@@ -351,16 +489,24 @@ void IProfiler::add(s32 id, const core::stringw &name, const core::stringw &grou
 		groupIdx = addGroup(groupName);
 	}
 
-	SProfileData data(id);
-	s32 idx = ProfileDatas.binary_search(data);
+	s32 idx = getDataIndex(id);
 	if ( idx < 0 )
 	{
+		SProfileData data(id);
 		data.reset();
 		data.GroupIndex = groupIdx;
 		data.Name = name;
 
+		// new data goes to the end, so indices which are in use don't change
 		ProfileDatas.push_back(data);
-		ProfileDatas.sort();
+
+		u32 table, slot;
+		if ( getLookupSlot(id, table, slot) )
+		{
+			while ( IdLookup[table].size() <= slot )
+				IdLookup[table].push_back(-1);
+			IdLookup[table][slot] = (s32)ProfileDatas.size()-1;
+		}
 	}
 	else
 	{
@@ -399,8 +545,7 @@ bool IProfiler::findDataIndex(u32 & result, const core::stringw &name) const
 
 const SProfileData* IProfiler::getProfileDataById(u32 id)
 {
-	SProfileData data(id);
-    s32 idx = ProfileDatas.binary_search(data);
+    s32 idx = getDataIndex((s32)id);
 	if ( idx >= 0 )
 		return &ProfileDatas[idx];
 	return NULL;
@@ -422,7 +567,7 @@ bool IProfiler::findGroupIndex(u32 & result, const core::stringw &name) const
 
 void IProfiler::resetDataById(s32 id)
 {
-	s32 idx = ProfileDatas.binary_search(SProfileData(id));
+	s32 idx = getDataIndex(id);
     if ( idx >= 0 )
     {
 		resetDataByIndex((u32)idx);
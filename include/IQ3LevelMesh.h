@@ -37,6 +37,26 @@ namespace scene
 
 		//! returns the requested brush entity
 		virtual IMesh* getBrushEntityMesh(quake3::IEntity &ent) const = 0;
+
+		//! Returns the visibility cluster which contains a position
+		/** The position is in the coordinate system of the mesh.
+		\return Index of the cluster, or -1 if the position is outside
+		of the level or the level has no bsp tree. */
+		virtual s32 getCluster(const core::vector3df& position) const = 0;
+
+		//! Returns if anything of one cluster can be seen from another one
+		/** Uses the potentially visible set of the level. Clusters which
+		are -1 and levels without visibility data see everything. */
+		virtual bool isClusterVisible(s32 from, s32 to) const = 0;
+
+		//! Collects the level geometry which can be seen from a cluster
+		/** \param cluster Cluster of the viewer, see getCluster(). -1
+		collects all faces.
+		\param indices Receives one index list for each mesh buffer of
+		getMesh(quake3::E_Q3_MESH_GEOMETRY). The faces keep the order they
+		have in the mesh buffers.
+		\return Number of visible triangles. */
+		virtual u32 getVisibleIndices(s32 cluster, core::array<core::array<u16> >& indices) const = 0;
 	};
 
 } // end namespace scene
@@ -13,6 +13,7 @@
 
 namespace irr
 {
+	class IJobSystem;
 
 namespace scene
 {
@@ -45,6 +46,47 @@ namespace scene
 		{}
 	};
 
+	//! Moving ellipsoid for ISceneCollisionManager::getCollisionResultPositions()
+	/** The members match the parameters of
+	ISceneCollisionManager::getCollisionResultPosition(). */
+	struct SCollisionResponse
+	{
+		//! Triangles of the world
+		ITriangleSelector* Selector;
+
+		//! Position of the ellipsoid
+		core::vector3df Position;
+
+		//! Radius of the ellipsoid
+		core::vector3df Radius;
+
+		//! Direction and speed of the movement of the ellipsoid
+		core::vector3df Direction;
+
+		//! Direction and force of gravity
+		core::vector3df Gravity;
+
+		f32 SlidingSpeed;
+
+		//! New position of the ellipsoid
+		core::vector3df ResultPosition;
+
+		//! Last triangle causing a collision, stays unchanged without collision
+		core::triangle3df Triangle;
+
+		//! Position of the collision
+		core::vector3df HitPosition;
+
+		//! True if the ellipsoid is falling down, caused by gravity
+		bool Falling;
+
+		//! Node with which the ellipsoid collided, stays unchanged without collision
+		ISceneNode* Node;
+
+		SCollisionResponse() : Selector(0), SlidingSpeed(0.0005f), Falling(false), Node(0)
+		{}
+	};
+
 	//! The Scene Collision Manager provides methods for performing collision tests and picking on scene nodes.
 	class ISceneCollisionManager : public virtual IReferenceCounted
 	{
@@ -122,6 +164,20 @@ namespace scene
 			const core::vector3df& gravityDirectionAndSpeed
 			= core::vector3df(0.0f, 0.0f, 0.0f)) = 0;
 
+		//! Collides many moving ellipsoids with their worlds at once
+		/** Gives the same results as calling getCollisionResultPosition()
+		for each ellipsoid. The triangles which each ellipsoid might touch
+		are taken from the selectors one ellipsoid after another, unless
+		the selector is thread safe (see ITriangleSelector::isThreadSafe()).
+		The ellipsoids then slide along those triangles on the threads of
+		the job system.
+		\param responses: Ellipsoids to move, the results are written into them.
+		\param count: Number of ellipsoids.
+		\param jobs: Job system to use, like IrrlichtDevice::getJobSystem(),
+		or 0 to collide on the calling thread. */
+		virtual void getCollisionResultPositions(SCollisionResponse* responses, u32 count,
+			IJobSystem* jobs = 0) = 0;
+
 		//! Returns a 3d ray which would go through the 2d screen coordinates.
 		/** \param pos: Screen coordinates in pixels.
 		\param camera: Camera from which the ray starts. If null, the
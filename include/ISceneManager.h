@@ -25,6 +25,7 @@ namespace irr
 {
 	struct SKeyMap;
 	struct SEvent;
+	class IJobSystem;
 
 namespace io
 {
@@ -113,12 +114,14 @@ namespace scene
 	class IMeshBuffer;
 	class IMeshCache;
 	class IMeshLoader;
+	class IMeshLoadRequest;
 	class IMeshManipulator;
 	class IMeshSceneNode;
 	class IMeshWriter;
 	class IMetaTriangleSelector;
 	class IOctreeSceneNode;
 	class IParticleSystemSceneNode;
+	class IQ3LevelMesh;
 	class ISceneCollisionManager;
 	class ISceneLoader;
 	class ISceneNode;
@@ -402,6 +405,27 @@ namespace scene
 		IReferenceCounted::drop() for more information. */
 		virtual IAnimatedMesh* getMesh(io::IReadFile* file) = 0;
 
+		//! Starts loading a mesh on the job threads of the device
+		/** The mesh loaders which getMesh() would use load the mesh on a job
+		thread when all of them are thread safe, see
+		IMeshLoader::isThreadSafe(), and on the main thread otherwise. The
+		requests of a scene manager load one mesh after the other, so a
+		loader never runs twice at the same time. The loaders wait while the
+		main thread loads the textures of the mesh or passes their log texts
+		to the event receiver. The loaded mesh is added
+		to the mesh cache like with getMesh(), which waits for the requests
+		before it loads meshes itself.
+		Requesting a mesh which is still loading returns the same request
+		again and requesting a mesh from the mesh cache returns a request which
+		is done already. Scene managers created without a device load the mesh
+		before this method returns. Only call it from the main thread.
+		\param filename Filename of the mesh to load.
+		\param alternativeCacheName Name of the mesh in the mesh cache, see getMesh().
+		\return The request. This pointer should be dropped. See
+		IReferenceCounted::drop() for more information. */
+		virtual IMeshLoadRequest* createMeshLoadRequest(const io::path& filename,
+			const io::path& alternativeCacheName=io::path("")) = 0;
+
 		//! Get interface to the mesh cache which is shared between all existing scene managers.
 		/** With this interface, it is possible to manually add new loaded
 		meshes (if ISceneManager::getMesh() is not sufficient), to remove them and to iterate
@@ -901,6 +925,19 @@ namespace scene
 												ISceneNode* parent=0, s32 id=-1
 												) = 0;
 
+		//! Adds a scene node for the geometry of a quake3 level.
+		/** Each frame the node finds the cluster of the camera in the bsp
+		tree of the level and draws only the faces in the potentially
+		visible set of that cluster. The faces of the last clusters are
+		cached. Only the mesh quake3::E_Q3_MESH_GEOMETRY is drawn, the
+		shader, fog and unresolved meshes need their own scene nodes.
+		\param mesh The level, as loaded from a .bsp file.
+		\param parent Parent of the scene node. Can be 0 if no parent.
+		\param id Id of the node. This id can be used to identify the scene node.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual ISceneNode* addQuake3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent=0, s32 id=-1) = 0;
+
 
 		//! Adds an empty scene node to the scene graph.
 		/** Can be used for doing advanced transformations
@@ -1556,6 +1593,10 @@ namespace scene
 		an xml based format. .irr files can Be edited with the Irrlicht
 		Engine Editor, irrEdit (http://www.ambiera.com/irredit/). To
 		load .irr files again, see ISceneManager::loadScene().
+		When the file name has the extension .irrbin, the scene is
+		written in a binary format instead, which holds the same data
+		but loads much faster. Use it for shipping scenes, it can't be
+		edited with text editors or irrEdit.
 		\param filename Name of the file.
 		\param userDataSerializer If you want to save some user data
 		for every scene node into the file, implement the
@@ -1574,6 +1615,8 @@ namespace scene
 		an xml based format. .irr files can Be edited with the Irrlicht
 		Engine Editor, irrEdit (http://www.ambiera.com/irredit/). To
 		load .irr files again, see ISceneManager::loadScene().
+		Files with the extension .irrbin are written in the binary
+		format, see the other saveScene method.
 		\param file File where the scene is saved into.
 		\param userDataSerializer If you want to save some user data
 		for every scene node into the file, implement the
@@ -1612,7 +1655,8 @@ namespace scene
 		ISceneManager::addExternalSceneLoader. .irr files can Be edited
 		with the Irrlicht Engine Editor, irrEdit
 		(http://www.ambiera.com/irredit/) or saved directly by the engine
-		using ISceneManager::saveScene().
+		using ISceneManager::saveScene(). Binary .irrbin scenes
+		written by saveScene are loaded as well.
 		\param filename Name of the file to load from.
 		\param userDataSerializer If you want to load user data
 		possibily saved in that file for some scene nodes in the file,
@@ -1686,6 +1730,31 @@ namespace scene
 		\return True if node is not visible in the current scene, else
 		false. */
 		virtual bool isCulled(const ISceneNode* node) const =0;
+
+		//! Lets drawAll() animate the scene on the threads of a job system
+		/** By default all scene nodes are animated one after another in
+		OnAnimate(). With a job system, drawAll() first calls the animators
+		of the nodes whose enabled animators are all thread safe (see
+		ISceneNodeAnimator::isThreadSafe()) on the job threads. It then
+		updates the absolute positions of the nodes below the root level by
+		level on the job threads, leaving out nodes with other animators,
+		animated mesh nodes and their children. Nodes whose only enabled
+		animator is a collision response animator are then collided in one
+		batch with ISceneCollisionManager::getCollisionResultPositions(),
+		when all nodes of the triangles of their world got their absolute
+		position in these steps already, so the world is the same as in
+		OnAnimate(). Worlds with animated meshes or with nodes which other
+		animators move keep being collided in OnAnimate(). The collision
+		callbacks of the batch are called before OnAnimate(). OnAnimate()
+		then does the rest one node after another in the usual order.
+		Scene nodes which override updateAbsolutePosition() have to be
+		thread safe there.
+		\param jobs Job system to use, like IrrlichtDevice::getJobSystem(),
+		or 0 to animate one node after another. */
+		virtual void setAnimationJobSystem(IJobSystem* jobs) = 0;
+
+		//! Returns the job system which animates the scene, or 0
+		virtual IJobSystem* getAnimationJobSystem() const = 0;
 	};
 
 
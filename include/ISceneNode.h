@@ -49,7 +49,10 @@ namespace scene
 			: RelativeTranslation(position), RelativeRotation(rotation), RelativeScale(scale),
 				Parent(0), SceneManager(mgr), TriangleSelector(0), ID(id),
 				AutomaticCullingState(EAC_BOX), DebugDataVisible(EDS_OFF),
-				IsVisible(true), IsDebugObject(false)
+				IsVisible(true), IsDebugObject(false),
+				AnimatedEarly(false), AbsolutePositionUpdatedEarly(false),
+				RelativeTransformationChanged(true), AbsoluteTransformationVersion(0),
+				ParentTransformationVersion(0)
 		{
 			if (parent)
 				parent->addChild(this);
@@ -109,24 +112,18 @@ namespace scene
 		{
 			if (IsVisible)
 			{
-				// animate this node with all animators
-
-				ISceneNodeAnimatorList::Iterator ait = Animators.begin();
-				while (ait != Animators.end())
-					{
-					// continue to the next node before calling animateNode()
-					// so that the animator may remove itself from the scene
-					// node without the iterator becoming invalid
-					ISceneNodeAnimator* anim = *ait;
-					++ait;
-					if ( anim->isEnabled() )
-					{
-						anim->animateNode(this, timeMs);
-					}
-				}
+				// animate this node with all animators, unless the scene
+				// manager did already in its parallel animation
+				if (AnimatedEarly)
+					AnimatedEarly = false;
+				else
+					runAnimators(timeMs);
 
 				// update absolute position
-				updateAbsolutePosition();
+				if (AbsolutePositionUpdatedEarly)
+					AbsolutePositionUpdatedEarly = false;
+				else
+					updateAbsolutePosition();
 
 				// perform the post render process on all children
 
@@ -137,6 +134,37 @@ namespace scene
 		}
 
 
+		//! Calls the enabled animators of this node, but not of its children
+		/** The next OnAnimate() call doesn't call them again. The scene manager
+		uses it to run the thread safe animators on worker threads, see
+		ISceneManager::setAnimationJobSystem().
+		\param timeMs Current time in milliseconds. */
+		void animateEarly(u32 timeMs)
+		{
+			runAnimators(timeMs);
+			AnimatedEarly = true;
+		}
+
+
+		//! Updates the absolute position, the next OnAnimate() call doesn't update it again
+		/** The parent has to be updated already. */
+		void updateAbsolutePositionEarly()
+		{
+			updateAbsolutePosition();
+			AbsolutePositionUpdatedEarly = true;
+		}
+
+
+		//! Forgets the work of animateEarly() and updateAbsolutePositionEarly() which OnAnimate() didn't use
+		/** The scene manager calls it after OnAnimate(), as nodes which got
+		hidden or removed in between aren't reached by OnAnimate(). */
+		void endEarlyAnimation()
+		{
+			AnimatedEarly = false;
+			AbsolutePositionUpdatedEarly = false;
+		}
+
+
 		//! Renders the node.
 		virtual void render() = 0;
 
@@ -213,6 +241,16 @@ namespace scene
 		}
 
 
+		//! Returns a number which changes each time the absolute transformation is calculated again
+		/** Can be used to cache data which depends on the absolute
+		transformation, e.g. transformed triangles of a triangle selector.
+		\return Version of the absolute transformation. */
+		u32 getAbsoluteTransformationVersion() const
+		{
+			return AbsoluteTransformationVersion;
+		}
+
+
 		//! Returns the relative transformation of the scene node.
 		/** The relative transformation is stored internally as 3
 		vectors: translation, rotation and scale. To get the relative
@@ -304,6 +342,7 @@ namespace scene
 				child->remove(); // remove from old parent
 				Children.push_back(child);
 				child->Parent = this;
+				child->RelativeTransformationChanged = true;
 			}
 		}
 
@@ -321,6 +360,7 @@ namespace scene
 				if ((*it) == child)
 				{
 					(*it)->Parent = 0;
+					(*it)->RelativeTransformationChanged = true;
 					(*it)->drop();
 					Children.erase(it);
 					return true;
@@ -340,6 +380,7 @@ namespace scene
 			for (; it != Children.end(); ++it)
 			{
 				(*it)->Parent = 0;
+				(*it)->RelativeTransformationChanged = true;
 				(*it)->drop();
 			}
 
@@ -482,6 +523,7 @@ namespace scene
 		virtual void setScale(const core::vector3df& scale)
 		{
 			RelativeScale = scale;
+			RelativeTransformationChanged = true;
 		}
 
 
@@ -502,6 +544,7 @@ namespace scene
 		virtual void setRotation(const core::vector3df& rotation)
 		{
 			RelativeRotation = rotation;
+			RelativeTransformationChanged = true;
 		}
 
 
@@ -521,6 +564,7 @@ namespace scene
 		virtual void setPosition(const core::vector3df& newpos)
 		{
 			RelativeTranslation = newpos;
+			RelativeTransformationChanged = true;
 		}
 
 
@@ -661,16 +705,31 @@ namespace scene
 
 		//! Updates the absolute position based on the relative and the parents position
 		/** Note: This does not recursively update the parents absolute positions, so if you have a deeper
-			hierarchy you might want to update the parents first.*/
+			hierarchy you might want to update the parents first.
+			The absolute transformation is only calculated again when the relative transformation
+			was set or when the parent's absolute transformation changed since the last update.*/
 		virtual void updateAbsolutePosition()
 		{
 			if (Parent)
 			{
+				if (!RelativeTransformationChanged &&
+					ParentTransformationVersion == Parent->AbsoluteTransformationVersion)
+					return;
+
 				AbsoluteTransformation =
 					Parent->getAbsoluteTransformation() * getRelativeTransformation();
+				ParentTransformationVersion = Parent->AbsoluteTransformationVersion;
 			}
 			else
+			{
+				if (!RelativeTransformationChanged)
+					return;
+
 				AbsoluteTransformation = getRelativeTransformation();
+			}
+
+			RelativeTransformationChanged = false;
+			++AbsoluteTransformationVersion;
 		}
 
 
@@ -765,6 +824,24 @@ namespace scene
 
 	protected:
 
+		//! Calls animateNode() of the enabled animators
+		void runAnimators(u32 timeMs)
+		{
+			ISceneNodeAnimatorList::Iterator ait = Animators.begin();
+			while (ait != Animators.end())
+			{
+				// continue to the next node before calling animateNode()
+				// so that the animator may remove itself from the scene
+				// node without the iterator becoming invalid
+				ISceneNodeAnimator* anim = *ait;
+				++ait;
+				if ( anim->isEnabled() )
+				{
+					anim->animateNode(this, timeMs);
+				}
+			}
+		}
+
 		//! A clone function for the ISceneNode members.
 		/** This method can be used by clone() implementations of
 		derived classes
@@ -777,6 +854,7 @@ namespace scene
 			RelativeTranslation = toCopyFrom->RelativeTranslation;
 			RelativeRotation = toCopyFrom->RelativeRotation;
 			RelativeScale = toCopyFrom->RelativeScale;
+			RelativeTransformationChanged = true;
 			ID = toCopyFrom->ID;
 			setTriangleSelector(toCopyFrom->TriangleSelector);
 			AutomaticCullingState = toCopyFrom->AutomaticCullingState;
@@ -864,6 +942,21 @@ namespace scene
 
 		//! Is debug object?
 		bool IsDebugObject;
+
+		//! Set when animateEarly() or updateAbsolutePositionEarly() did the work of the next OnAnimate()
+		bool AnimatedEarly;
+		bool AbsolutePositionUpdatedEarly;
+
+		//! Set when the relative transformation changed since the last updateAbsolutePosition()
+		/** Derived classes which change the relative members directly, or whose
+		getRelativeTransformation() uses other members, have to set it too. */
+		bool RelativeTransformationChanged;
+
+		//! Changes each time updateAbsolutePosition() calculates AbsoluteTransformation
+		u32 AbsoluteTransformationVersion;
+
+		//! AbsoluteTransformationVersion of the parent used for AbsoluteTransformation
+		u32 ParentTransformationVersion;
 	};
 
 
@@ -74,6 +74,17 @@ namespace scene
 			return false;
 		}
 
+		//! Returns if the animator may run on a worker thread
+		/** Thread safe animators only change the node which they animate and
+		themselves and don't use the scene manager or the video driver. The
+		scene manager runs them at the same time for several nodes when it
+		animates in parallel, see ISceneManager::setAnimationJobSystem(). Such
+		an animator should not be added to several nodes then. */
+		virtual bool isThreadSafe() const
+		{
+			return false;
+		}
+
 		//! Reset a time-based movement by changing the starttime.
 		/** By default most animators start on object creation.
 			This value is ignored by animators which don't work with a starttime.
@@ -6,6 +6,7 @@
 #define __I_SCENE_NODE_ANIMATOR_COLLISION_RESPONSE_H_INCLUDED__
 
 #include "ISceneNode.h"
+#include "ISceneCollisionManager.h"
 
 namespace irr
 {
@@ -161,6 +162,22 @@ namespace scene
 		*/
 		virtual void setCollisionCallback(ICollisionCallback* callback) = 0;
 
+		//! Starts the next animateNode() call for a batch of ISceneCollisionManager::getCollisionResultPositions()
+		/** The scene manager uses it to collide many nodes at once, see
+		ISceneManager::setAnimationJobSystem().
+		\param node: Node which will be animated.
+		\param timeMs: Time of the animation.
+		\param response: Gets the ellipsoid to move.
+		\return False if the animator can't be batched, it's animated as usual then. */
+		virtual bool beginBatchedCollision(ISceneNode* node, u32 timeMs, SCollisionResponse& response)
+		{
+			return false;
+		}
+
+		//! Passes the result of the batch, the next animateNode() call uses it
+		/** Only called after beginBatchedCollision() returned true. */
+		virtual void endBatchedCollision(const SCollisionResponse& response) {}
+
 	};
 
 
@@ -97,6 +97,18 @@ enum E_TEXTURE_CREATION_FLAG
 	  */
 	ETCF_AUTO_GENERATE_MIP_MAPS = 0x00000100,
 
+	//! Allow compressing textures loaded from files into DXT or ETC2 formats.
+	/** Default is false.
+	Compression is lossy but saves video memory and bandwidth. It only
+	happens when a texture cache directory is set with
+	IVideoDriver::setTextureCacheDirectory() and when the driver supports
+	one of the formats. Compressed textures are kept in the cache, so each
+	file is only compressed once, see also
+	IVideoDriver::addTextureToCompressionCache(). Only 2d textures with
+	sizes which are powers of two are compressed, others are loaded as
+	before. */
+	ETCF_ALLOW_COMPRESSION = 0x00000200,
+
 	/** This flag is never used, it only forces the compiler to compile
 	these enumeration values to 32 bit. */
 	ETCF_FORCE_32_BIT_DO_NOT_USE = 0x7fffffff
@@ -187,6 +187,17 @@ public:
 	\return The scene node associated with that triangle.
 	*/
 	virtual ISceneNode* getSceneNodeForTriangle(u32 triangleIndex) const = 0;
+
+	//! Returns true if the box queries may run on several threads at once
+	/** Selectors which update their triangles or caches in getTriangles()
+	return false. A thread safe selector has to fill the whole array
+	when more triangles lie in the box than fit into it.
+	ISceneCollisionManager::getCollisionResultPositions() uses it to
+	query the selectors on the threads of a job system. */
+	virtual bool isThreadSafe() const
+	{
+		return false;
+	}
 };
 
 } // end namespace scene
@@ -1153,6 +1153,35 @@ namespace video
 		\return The current texture creation flag enabled mode. */
 		virtual bool getTextureCreationFlag(E_TEXTURE_CREATION_FLAG flag) const =0;
 
+		//! Sets a directory in which drivers can keep data they compute from textures.
+		/** Drivers which have to do expensive work when creating textures,
+		like the mip map generation of the software renderers, store the
+		results there and load them the next time the same texture data is
+		used. Files are named by a hash of the texture data, so the
+		directory can be shared by all textures and applications.
+		\param path Existing directory, an empty path disables the cache,
+		which is the default. */
+		virtual void setTextureCacheDirectory(const io::path& path) =0;
+
+		//! Returns the directory set with setTextureCacheDirectory()
+		virtual const io::path& getTextureCacheDirectory() const =0;
+
+		//! Compresses a texture file into the texture cache directory.
+		/** Textures loaded with ETCF_ALLOW_COMPRESSION find the result in
+		the cache and don't have to be compressed again, so this can fill
+		the cache before the textures are needed, for example during the
+		installation of an application. It works with every driver, also
+		with those which can't use compressed textures themselves.
+		Mip map levels are created when ETCF_CREATE_MIP_MAPS is enabled,
+		just like it happens when the texture is loaded.
+		\param filename Texture file. Only 2d textures with sizes which
+		are powers of two can be compressed.
+		\param format ECF_DXT1 or ECF_DXT5 for DXT compression, ECF_ETC2_RGB
+		or ECF_ETC2_ARGB for ETC2. The variant with alpha channel is used
+		when the texture has transparent texels.
+		\return True if the compressed texture is in the cache now. */
+		virtual bool addTextureToCompressionCache(const io::path& filename, ECOLOR_FORMAT format) =0;
+
 		//! Creates a software images from a file.
 		/** No hardware texture will be created for those images. This
 		method is useful for example if you want to read a heightmap
@@ -1212,6 +1241,32 @@ namespace video
 			return (imageArray.size() > 0) ? imageArray[0] : 0;
 		}
 
+		//! Creates a software image from a part of an image file.
+		/** Image loaders which support it (see
+		IImageLoader::isImagePartLoadingSupported) decode only as much of
+		the file as is needed for the requested area, others load the
+		whole image which is then cropped and scaled.
+		This is useful for example to create thumbnails of large images.
+		\param filename Name of the file from which the image is created.
+		\param sourceRect Area of the image to load, in pixels of the
+		full resolution image. An empty rectangle selects the whole image.
+		\param scaleDenom The image is downscaled by this factor, see
+		getImagePartRect for the resulting size.
+		\return The created image.
+		If you no longer need the image, you should call IImage::drop().
+		See IReferenceCounted::drop() for more information. */
+		virtual IImage* createImagePartFromFile(const io::path& filename, const core::rect<s32>& sourceRect, u32 scaleDenom=1) = 0;
+
+		//! Creates a software image from a part of an image file.
+		/** \param file File from which the image is created.
+		\param sourceRect Area of the image to load, in pixels of the
+		full resolution image. An empty rectangle selects the whole image.
+		\param scaleDenom The image is downscaled by this factor.
+		\return The created image.
+		If you no longer need the image, you should call IImage::drop().
+		See IReferenceCounted::drop() for more information. */
+		virtual IImage* createImagePartFromFile(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom=1) = 0;
+
 		//! Writes the provided image to a file.
 		/** Requires that there is a suitable image writer registered
 		for writing the image.
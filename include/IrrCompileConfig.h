@@ -176,6 +176,18 @@
 //! Maximum number of texture an SMaterial can have, up to 8 are supported by Irrlicht.
 #define _IRR_MATERIAL_MAX_TEXTURES_ 8
 
+//! Define _IRR_COMPILE_WITH_MAPPED_READ_FILE_ to map large files from disk into memory
+/** IFileSystem::createAndOpenFile then returns an IMemoryReadFile for files of
+at least _IRR_MAPPED_READ_FILE_MIN_SIZE_ bytes, which loaders can parse without
+copying them. Smaller files are still read with stdio. */
+#define _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+#ifdef NO_IRR_COMPILE_WITH_MAPPED_READ_FILE_
+#undef _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+#endif
+#ifndef _IRR_MAPPED_READ_FILE_MIN_SIZE_
+#define _IRR_MAPPED_READ_FILE_MIN_SIZE_ 262144
+#endif
+
 //! Whether to support XML and XML-based formats (irrmesh, collada...)
 #define _IRR_COMPILE_WITH_XML_
 #ifdef NO_IRR_COMPILE_WITH_XML_
@@ -198,6 +210,25 @@ while it runs and enabling it will slow down the engine. */
 #undef _IRR_COMPILE_WITH_PROFILING_
 #endif
 
+//! Remove engine log messages with a lower level than this when compiling
+/** The messages of the engine with a lower ELOG_LEVEL compile to nothing and
+can't be enabled with ILogger::setLogLevel anymore. The default 0 (ELL_DEBUG)
+keeps all of them, 2 (ELL_WARNING) only keeps warnings and errors. Messages
+with ELL_NONE are always kept. */
+#ifndef _IRR_COMPILE_LOG_LEVEL_
+#define _IRR_COMPILE_LOG_LEVEL_ 0
+#endif
+
+//! Use SSE2 instructions in some performance critical places
+/** Enabled when the compiler generates SSE2 code anyway (all x86-64 targets).
+The code has always a plain C++ version which is used otherwise. */
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _IRR_COMPILE_WITH_SSE2_
+#endif
+#ifdef NO_IRR_COMPILE_WITH_SSE2_
+#undef _IRR_COMPILE_WITH_SSE2_
+#endif
+
 #ifdef NO_IRR_COMPILE_WITH_X11_DEVICE_
 #undef _IRR_COMPILE_WITH_X11_DEVICE_
 #undef _IRR_X11_DYNAMIC_LOAD_
@@ -610,6 +641,12 @@ tool <http://developer.nvidia.com/object/nvperfhud_home.html>. */
 #ifdef NO_IRR_COMPILE_WITH_IRR_SCENE_LOADER_
 #undef _IRR_COMPILE_WITH_IRR_SCENE_LOADER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BIN_SCENE_LOADER_ if you want to be able to load
+/** binary .irrbin scenes using ISceneManager::loadScene */
+#define _IRR_COMPILE_WITH_IRR_BIN_SCENE_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BIN_SCENE_LOADER_
+#undef _IRR_COMPILE_WITH_IRR_BIN_SCENE_LOADER_
+#endif
 
 //! Define _IRR_COMPILE_WITH_SKINNED_MESH_SUPPORT_ if you want to use bone based
 /** animated meshes. If you compile without this, you will be unable to load
@@ -647,6 +684,11 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_IRR_MESH_LOADER_
 #undef _IRR_COMPILE_WITH_IRR_MESH_LOADER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BIN_MESH_LOADER_ if you want to load cooked binary .irrbinmesh files
+#define _IRR_COMPILE_WITH_IRR_BIN_MESH_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BIN_MESH_LOADER_
+#undef _IRR_COMPILE_WITH_IRR_BIN_MESH_LOADER_
+#endif
 //! Define _IRR_COMPILE_WITH_HALFLIFE_LOADER_ if you want to load Halflife animated files
 #define _IRR_COMPILE_WITH_HALFLIFE_LOADER_
 #ifdef NO_IRR_COMPILE_WITH_HALFLIFE_LOADER_
@@ -758,6 +800,16 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_B3D_WRITER_
 #undef _IRR_COMPILE_WITH_B3D_WRITER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BIN_MESH_WRITER_ if you want to write cooked binary .irrbinmesh files
+#define _IRR_COMPILE_WITH_IRR_BIN_MESH_WRITER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BIN_MESH_WRITER_
+#undef _IRR_COMPILE_WITH_IRR_BIN_MESH_WRITER_
+#endif
+//! Define _IRR_COMPILE_WITH_IRR_BIN_SCENE_WRITER_ if you want to save binary .irrbin scenes
+#define _IRR_COMPILE_WITH_IRR_BIN_SCENE_WRITER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BIN_SCENE_WRITER_
+#undef _IRR_COMPILE_WITH_IRR_BIN_SCENE_WRITER_
+#endif
 
 //! Define _IRR_COMPILE_WITH_BMP_LOADER_ if you want to load .bmp files
 //! Disabling this loader will also disable the built-in font
@@ -861,6 +913,12 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_PPM_WRITER_
 #undef _IRR_COMPILE_WITH_PPM_WRITER_
 #endif
+//! Define _IRR_COMPILE_WITH_PVR_WRITER_ if you want to write .pvr files
+/** Also needed for the compressed texture cache, see ETCF_ALLOW_COMPRESSION */
+#define _IRR_COMPILE_WITH_PVR_WRITER_
+#ifdef NO_IRR_COMPILE_WITH_PVR_WRITER_
+#undef _IRR_COMPILE_WITH_PVR_WRITER_
+#endif
 //! Define _IRR_COMPILE_WITH_PSD_WRITER_ if you want to write .psd files
 #define _IRR_COMPILE_WITH_PSD_WRITER_
 #ifdef NO_IRR_COMPILE_WITH_PSD_WRITER_
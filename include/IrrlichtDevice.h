@@ -21,6 +21,7 @@ namespace irr
 	class ILogger;
 	class IEventReceiver;
 	class IRandomizer;
+	class IJobSystem;
 
 	namespace io {
 		class IFileSystem;
@@ -152,6 +153,13 @@ namespace irr
 		\return Pointer to the default IRandomizer object. */
 		virtual IRandomizer* createDefaultRandomizer() const =0;
 
+		//! Provides access to the job system which runs work on several threads.
+		/** The number of threads is set with SIrrlichtCreationParameters::JobThreads.
+		run() calls IJobSystem::runMainThreadJobs and the device waits for all
+		jobs before it is destroyed.
+		\return Pointer to the job system. */
+		virtual IJobSystem* getJobSystem() = 0;
+
 		//! Sets the caption of the window.
 		/** \param text: New text of the window caption. */
 		virtual void setWindowCaption(const wchar_t* text) = 0;
@@ -0,0 +1,167 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_GUI_RECT_GRID_H_INCLUDED__
+#define __S_GUI_RECT_GRID_H_INCLUDED__
+
+#include "irrArray.h"
+#include "rect.h"
+#include "irrMath.h"
+
+namespace irr
+{
+namespace gui
+{
+
+	//! Uniform grid of rectangles which finds the rectangles which can contain a point
+	/** IGUIElement uses this to find its children at a point without testing
+	all of them. Rectangles get ids in the order in which they are added and
+	the ids in a cell are sorted. Like in rect::isPointInside the lower right
+	corner belongs to a rectangle. Invalid rectangles and those which cover a
+	large part of the grid are in no cell, their ids are in Everywhere. */
+	struct SGUIRectGrid
+	{
+		SGUIRectGrid() : CellWidth(1), CellHeight(1), CellsX(0), CellsY(0) {}
+
+		//! Removes all rectangles
+		void clear()
+		{
+			Rects.set_used(0);
+			CellStart.set_used(0);
+			CellIds.set_used(0);
+			Everywhere.set_used(0);
+			CellsX = 0;
+			CellsY = 0;
+		}
+
+		//! Adds a rectangle, call build() when all are added
+		/** \return Id of the rectangle. */
+		u32 addRect(const core::rect<s32>& rect)
+		{
+			Rects.push_back(rect);
+			return Rects.size() - 1;
+		}
+
+		//! Sorts the rectangles into the cells
+		void build()
+		{
+			CellStart.set_used(0);
+			CellIds.set_used(0);
+			Everywhere.set_used(0);
+			CellsX = 0;
+			CellsY = 0;
+
+			u32 bounded = 0;
+			for (u32 i=0; i<Rects.size(); ++i)
+			{
+				if (!Rects[i].isValid())
+					continue;
+				if (bounded == 0)
+					Bounds = Rects[i];
+				else
+				{
+					Bounds.addInternalPoint(Rects[i].UpperLeftCorner);
+					Bounds.addInternalPoint(Rects[i].LowerRightCorner);
+				}
+				++bounded;
+			}
+
+			if (bounded)
+			{
+				// about one rectangle per cell
+				CellsX = core::clamp((u32)sqrtf((f32)bounded), 1u, 64u);
+				CellsY = CellsX;
+				CellWidth = (Bounds.getWidth() + (s32)CellsX) / (s32)CellsX;
+				CellHeight = (Bounds.getHeight() + (s32)CellsY) / (s32)CellsY;
+				CellStart.set_used(CellsX * CellsY + 1);
+				for (u32 c=0; c<CellStart.size(); ++c)
+					CellStart[c] = 0;
+			}
+
+			// count the rectangles of each cell, then fill them in
+			for (u32 pass=0; pass<2; ++pass)
+			{
+				for (u32 i=0; i<Rects.size(); ++i)
+				{
+					const core::rect<s32>& r = Rects[i];
+					u32 x0=0, y0=0, x1=0, y1=0;
+					if (r.isValid())
+					{
+						x0 = (r.UpperLeftCorner.X - Bounds.UpperLeftCorner.X) / CellWidth;
+						y0 = (r.UpperLeftCorner.Y - Bounds.UpperLeftCorner.Y) / CellHeight;
+						x1 = (r.LowerRightCorner.X - Bounds.UpperLeftCorner.X) / CellWidth;
+						y1 = (r.LowerRightCorner.Y - Bounds.UpperLeftCorner.Y) / CellHeight;
+					}
+					if (!r.isValid() || (x1 - x0 + 1) * (y1 - y0 + 1) * 2 > CellsX * CellsY)
+					{
+						if (pass == 0)
+							Everywhere.push_back(i);
+						continue;
+					}
+					for (u32 y=y0; y<=y1; ++y)
+					{
+						for (u32 x=x0; x<=x1; ++x)
+						{
+							const u32 cell = y * CellsX + x;
+							if (pass == 0)
+								++CellStart[cell + 1];
+							else
+								CellIds[CellStart[cell + 1]++] = i;
+						}
+					}
+				}
+
+				if (pass == 0 && bounded)
+				{
+					for (u32 c=1; c<CellStart.size(); ++c)
+						CellStart[c] += CellStart[c - 1];
+					CellIds.set_used(CellStart.getLast());
+					// CellStart[cell+1] is the fill position of cell in the second pass
+					// and ends up as its end, which is the start of the next cell
+					for (u32 c=CellStart.size()-1; c>0; --c)
+						CellStart[c] = CellStart[c - 1];
+				}
+			}
+		}
+
+		//! Returns the sorted ids of the rectangles in the cell of a point
+		/** The ids in Everywhere have to be checked as well.
+		\param point Point to look up.
+		\param count Receives the number of ids.
+		\return Pointer to the ids. */
+		const u32* getCell(const core::position2d<s32>& point, u32& count) const
+		{
+			count = 0;
+			if (!CellsX || !Bounds.isPointInside(point))
+				return 0;
+
+			const u32 cell = (point.Y - Bounds.UpperLeftCorner.Y) / CellHeight * CellsX +
+				(point.X - Bounds.UpperLeftCorner.X) / CellWidth;
+			count = CellStart[cell + 1] - CellStart[cell];
+			return CellIds.const_pointer() + CellStart[cell];
+		}
+
+		//! Rectangles in the order in which they were added
+		core::array<core::rect<s32> > Rects;
+
+		//! Ids of the rectangles which are in no cell, sorted
+		core::array<u32> Everywhere;
+
+		//! Area covered by the cells
+		core::rect<s32> Bounds;
+		s32 CellWidth;
+		s32 CellHeight;
+		u32 CellsX;
+		u32 CellsY;
+
+		//! Ids of all cells, the ids of cell c are CellIds[CellStart[c]] to CellIds[CellStart[c+1]-1]
+		core::array<u32> CellStart;
+		core::array<u32> CellIds;
+	};
+
+} // end namespace gui
+} // end namespace irr
+
+#endif
+
@@ -47,6 +47,8 @@ namespace irr
 #else
 			LoggingLevel(ELL_INFORMATION),
 #endif
+			LoggingThread(false),
+			JobThreads(1),
 			DisplayAdapter(0),
 			DriverMultithreaded(false),
 			UsePerformanceTimer(true),
@@ -90,6 +92,8 @@ namespace irr
 			EventReceiver = other.EventReceiver;
 			WindowId = other.WindowId;
 			LoggingLevel = other.LoggingLevel;
+			LoggingThread = other.LoggingThread;
+			JobThreads = other.JobThreads;
 			DisplayAdapter = other.DisplayAdapter;
 			DriverMultithreaded = other.DriverMultithreaded;
 			UsePerformanceTimer = other.UsePerformanceTimer;
@@ -301,6 +305,25 @@ namespace irr
 		*/
 		ELOG_LEVEL LoggingLevel;
 
+		//! Print the log texts in a thread of its own.
+		/** Default is false. Logging then only copies the text into a queue,
+		so threads can log at the same time and don't wait for the console.
+		The same text logged several times in a row is printed once with the
+		number of repeats. Errors are printed before log returns, other texts
+		can be waited for with ILogger::flush(). The event receiver still gets
+		the texts on the thread which logs them, or on the main thread for the
+		texts of job threads. Ignored where the system has no threads.
+		*/
+		bool LoggingThread;
+
+		//! Number of threads which run the jobs of IrrlichtDevice::getJobSystem().
+		/** Default is 1, which starts no worker threads and runs all jobs on
+		the thread which creates the device. 0 uses one thread per processor.
+		The device thread counts as one of them. Where the system has no threads
+		there is only the device thread.
+		*/
+		u32 JobThreads;
+
 		//! Allows to select which graphic card is used for rendering when more than one card is in the system.
 		/** So far only supported on D3D */
 		u32 DisplayAdapter;
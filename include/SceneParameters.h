@@ -174,6 +174,18 @@ namespace scene
 	**/
 	const c8* const DEBUG_NORMAL_COLOR = "DEBUG_Normal_Color";
 
+	//! Name of the parameter for setting the directory of the octree cache.
+	/** Octree scene nodes and octree triangle selectors write their trees
+	into this directory and read them again when they are created for the
+	same mesh, instead of building them. The files are named after a hash of
+	the mesh, so changed meshes get new files. The directory has to exist,
+	by default it is empty and no cache is used. Use it like this:
+	\code
+	SceneManager->getParameters()->setAttribute(scene::OCTREE_CACHE_DIRECTORY, "cache/octrees");
+	\endcode
+	**/
+	const c8* const OCTREE_CACHE_DIRECTORY = "Octree_Cache_Directory";
+
 
 } // end namespace scene
 } // end namespace irr
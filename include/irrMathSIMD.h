@@ -0,0 +1,189 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_MATH_SIMD_H_INCLUDED__
+#define __IRR_MATH_SIMD_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "irrTypes.h"
+#include "vector3d.h"
+#include "aabbox3d.h"
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+namespace core
+{
+	/*
+		Kernels of CMatrix4 working on the 16 values of D3D style row major
+		matrices. The ...Scalar versions are plain C++ for all types and are
+		the reference. The versions without suffix use SSE2 for f32 when
+		_IRR_COMPILE_WITH_SSE2_ is defined and calculate the same results, as
+		they do the same operations in the same order. Only unaligned loads
+		and stores are used, so matrices and vectors need no alignment.
+	*/
+
+	//! Sets out to the product m1*m2 like CMatrix4::setbyproduct, out must not be m1 or m2
+	template <class T>
+	inline void multiplyMatrix4Scalar(T* out, const T* m1, const T* m2)
+	{
+		for (u32 i=0; i<16; i+=4)
+		{
+			out[i] = m1[0]*m2[i] + m1[4]*m2[i+1] + m1[8]*m2[i+2] + m1[12]*m2[i+3];
+			out[i+1] = m1[1]*m2[i] + m1[5]*m2[i+1] + m1[9]*m2[i+2] + m1[13]*m2[i+3];
+			out[i+2] = m1[2]*m2[i] + m1[6]*m2[i+1] + m1[10]*m2[i+2] + m1[14]*m2[i+3];
+			out[i+3] = m1[3]*m2[i] + m1[7]*m2[i+1] + m1[11]*m2[i+2] + m1[15]*m2[i+3];
+		}
+	}
+
+	//! Transforms count vectors like CMatrix4::transformVect, out may be in
+	template <class T>
+	inline void transformVectsMatrix4Scalar(const T* m, vector3df* out, const vector3df* in, u32 count)
+	{
+		for (u32 i=0; i<count; ++i)
+		{
+			const f32 x = in[i].X*m[0] + in[i].Y*m[4] + in[i].Z*m[8] + m[12];
+			const f32 y = in[i].X*m[1] + in[i].Y*m[5] + in[i].Z*m[9] + m[13];
+			const f32 z = in[i].X*m[2] + in[i].Y*m[6] + in[i].Z*m[10] + m[14];
+			out[i].set(x, y, z);
+		}
+	}
+
+	//! Transforms the box like CMatrix4::transformBoxEx
+	template <class T>
+	inline void transformBoxMatrix4Scalar(const T* m, aabbox3d<f32>& box)
+	{
+		const f32 Amin[3] = {box.MinEdge.X, box.MinEdge.Y, box.MinEdge.Z};
+		const f32 Amax[3] = {box.MaxEdge.X, box.MaxEdge.Y, box.MaxEdge.Z};
+
+		f32 Bmin[3];
+		f32 Bmax[3];
+
+		Bmin[0] = Bmax[0] = m[12];
+		Bmin[1] = Bmax[1] = m[13];
+		Bmin[2] = Bmax[2] = m[14];
+
+		for (u32 i = 0; i < 3; ++i)
+		{
+			for (u32 j = 0; j < 3; ++j)
+			{
+				const f32 a = m[j*4+i] * Amin[j];
+				const f32 b = m[j*4+i] * Amax[j];
+
+				if (a < b)
+				{
+					Bmin[i] += a;
+					Bmax[i] += b;
+				}
+				else
+				{
+					Bmin[i] += b;
+					Bmax[i] += a;
+				}
+			}
+		}
+
+		box.MinEdge.set(Bmin[0], Bmin[1], Bmin[2]);
+		box.MaxEdge.set(Bmax[0], Bmax[1], Bmax[2]);
+	}
+
+	//! Sets out to the product m1*m2 like CMatrix4::setbyproduct, out must not be m1 or m2
+	template <class T>
+	inline void multiplyMatrix4(T* out, const T* m1, const T* m2)
+	{
+		multiplyMatrix4Scalar(out, m1, m2);
+	}
+
+	//! Transforms count vectors like CMatrix4::transformVect, out may be in
+	template <class T>
+	inline void transformVectsMatrix4(const T* m, vector3df* out, const vector3df* in, u32 count)
+	{
+		transformVectsMatrix4Scalar(m, out, in, count);
+	}
+
+	//! Transforms the box like CMatrix4::transformBoxEx
+	template <class T>
+	inline void transformBoxMatrix4(const T* m, aabbox3d<f32>& box)
+	{
+		transformBoxMatrix4Scalar(m, box);
+	}
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+
+	//! Stores the first 3 values of v in out
+	inline void storeVector3SSE2(vector3df& out, __m128 v)
+	{
+		_mm_storel_pi((__m64*)&out.X, v);
+		_mm_store_ss(&out.Z, _mm_movehl_ps(v, v));
+	}
+
+	//! SSE2 version for f32, each row of the result is a sum of the rows of m1
+	inline void multiplyMatrix4(f32* out, const f32* m1, const f32* m2)
+	{
+		const __m128 r0 = _mm_loadu_ps(m1);
+		const __m128 r1 = _mm_loadu_ps(m1+4);
+		const __m128 r2 = _mm_loadu_ps(m1+8);
+		const __m128 r3 = _mm_loadu_ps(m1+12);
+
+		for (u32 i=0; i<16; i+=4)
+		{
+			__m128 v = _mm_mul_ps(r0, _mm_set1_ps(m2[i]));
+			v = _mm_add_ps(v, _mm_mul_ps(r1, _mm_set1_ps(m2[i+1])));
+			v = _mm_add_ps(v, _mm_mul_ps(r2, _mm_set1_ps(m2[i+2])));
+			v = _mm_add_ps(v, _mm_mul_ps(r3, _mm_set1_ps(m2[i+3])));
+			_mm_storeu_ps(out+i, v);
+		}
+	}
+
+	//! SSE2 version for f32
+	inline void transformVectsMatrix4(const f32* m, vector3df* out, const vector3df* in, u32 count)
+	{
+		const __m128 r0 = _mm_loadu_ps(m);
+		const __m128 r1 = _mm_loadu_ps(m+4);
+		const __m128 r2 = _mm_loadu_ps(m+8);
+		const __m128 r3 = _mm_loadu_ps(m+12);
+
+		for (u32 i=0; i<count; ++i)
+		{
+			__m128 v = _mm_mul_ps(r0, _mm_set1_ps(in[i].X));
+			v = _mm_add_ps(v, _mm_mul_ps(r1, _mm_set1_ps(in[i].Y)));
+			v = _mm_add_ps(v, _mm_mul_ps(r2, _mm_set1_ps(in[i].Z)));
+			v = _mm_add_ps(v, r3);
+			storeVector3SSE2(out[i], v);
+		}
+	}
+
+	//! SSE2 version for f32, selects like the scalar version also for NaNs
+	inline void transformBoxMatrix4(const f32* m, aabbox3d<f32>& box)
+	{
+		const f32 Amin[3] = {box.MinEdge.X, box.MinEdge.Y, box.MinEdge.Z};
+		const f32 Amax[3] = {box.MaxEdge.X, box.MaxEdge.Y, box.MaxEdge.Z};
+
+		__m128 bmin = _mm_loadu_ps(m+12);
+		__m128 bmax = bmin;
+
+		for (u32 j=0; j<3; ++j)
+		{
+			const __m128 row = _mm_loadu_ps(m+j*4);
+			const __m128 a = _mm_mul_ps(row, _mm_set1_ps(Amin[j]));
+			const __m128 b = _mm_mul_ps(row, _mm_set1_ps(Amax[j]));
+			const __m128 less = _mm_cmplt_ps(a, b);
+			bmin = _mm_add_ps(bmin, _mm_or_ps(_mm_and_ps(less, a), _mm_andnot_ps(less, b)));
+			bmax = _mm_add_ps(bmax, _mm_or_ps(_mm_and_ps(less, b), _mm_andnot_ps(less, a)));
+		}
+
+		storeVector3SSE2(box.MinEdge, bmin);
+		storeVector3SSE2(box.MaxEdge, bmax);
+	}
+
+#endif // _IRR_COMPILE_WITH_SSE2_
+
+} // end namespace core
+} // end namespace irr
+
+#endif
+
@@ -104,6 +104,7 @@
 #include "IImageLoader.h"
 #include "IImageWriter.h"
 #include "IIndexBuffer.h"
+#include "IJobSystem.h"
 #include "ILightSceneNode.h"
 #include "ILogger.h"
 #include "IMaterialRenderer.h"
@@ -112,6 +113,7 @@
 #include "IMeshBuffer.h"
 #include "IMeshCache.h"
 #include "IMeshLoader.h"
+#include "IMeshLoadRequest.h"
 #include "IMeshManipulator.h"
 #include "IMeshSceneNode.h"
 #include "IMeshWriter.h"
@@ -131,6 +133,7 @@
 #include "irrList.h"
 #include "irrMap.h"
 #include "irrMath.h"
+#include "irrMathSIMD.h"
 #include "irrString.h"
 #include "irrTypes.h"
 #include "path.h"
@@ -175,6 +178,7 @@
 #include "SceneParameters.h"
 #include "SColor.h"
 #include "SExposedVideoData.h"
+#include "SGUIRectGrid.h"
 #include "SIrrCreationParameters.h"
 #include "SKeyMap.h"
 #include "SLight.h"
@@ -38,7 +38,7 @@ class line2d
 		bool operator==(const line2d<T>& other) const
 		{ return (start==other.start && end==other.end) || (end==other.start && start==other.end);}
 		bool operator!=(const line2d<T>& other) const
-		{ return !(start==other.start && end==other.end) || (end==other.start && start==other.end);}
+		{ return !(*this == other);}
 
 		// functions
 		//! Set this line to new line going through the two points.
@@ -38,7 +38,7 @@ class line3d
 		bool operator==(const line3d<T>& other) const
 		{ return (start==other.start && end==other.end) || (end==other.start && start==other.end);}
 		bool operator!=(const line3d<T>& other) const
-		{ return !(start==other.start && end==other.end) || (end==other.start && start==other.end);}
+		{ return !(*this == other);}
 
 		// functions
 		//! Set this line to a new line going through the two points.
@@ -12,6 +12,7 @@
 #include "aabbox3d.h"
 #include "rect.h"
 #include "irrString.h"
+#include "irrMathSIMD.h"
 
 // enable this to keep track of changes to the matrix
 // and make simpler identity check for seldom changing matrices
@@ -145,6 +146,14 @@ namespace core
 			use it if you know you never have a identity matrix */
 			CMatrix4<T>& setbyproduct_nocheck(const CMatrix4<T>& other_a,const CMatrix4<T>& other_b );
 
+			//! Sets each matrix in out to the product of the matrices with the same index in a and b
+			/** Like calling setbyproduct_nocheck for each of them. Uses SSE2 for
+			f32 matrices when _IRR_COMPILE_WITH_SSE2_ is defined.
+			\param out: Array of count matrices, can be the same as a or b.
+			\param a: Array of count left hand matrices.
+			\param b: Array of count right hand matrices. */
+			static void setbyproducts(CMatrix4<T>* out, const CMatrix4<T>* a, const CMatrix4<T>* b, u32 count);
+
 			//! Multiply by another matrix.
 			/** Calculate other*this */
 			CMatrix4<T> operator*(const CMatrix4<T>& other) const;
@@ -241,6 +250,13 @@ namespace core
 			/** This operation is performed as if the vector was 4d with the 4th component =1 */
 			void transformVect( vector3df& out, const vector3df& in ) const;
 
+			//! Transforms count vectors by this matrix like transformVect does
+			/** Faster than transforming them one by one, uses SSE2 for f32 matrices
+			when _IRR_COMPILE_WITH_SSE2_ is defined.
+			\param out: Array of count vectors, can be the same as in.
+			\param in: Array of count vectors to transform. */
+			void transformVects(vector3df* out, const vector3df* in, u32 count) const;
+
 			//! An alternate transform vector method, writing into an array of 4 floats
 			/** This operation is performed as if the vector was 4d with the 4th component =1.
 				NOTE: out[3] will be written to (4th vector component)*/
@@ -694,28 +710,7 @@ namespace core
 	template <class T>
 	inline CMatrix4<T>& CMatrix4<T>::setbyproduct_nocheck(const CMatrix4<T>& other_a,const CMatrix4<T>& other_b )
 	{
-		const T *m1 = other_a.M;
-		const T *m2 = other_b.M;
-
-		M[0] = m1[0]*m2[0] + m1[4]*m2[1] + m1[8]*m2[2] + m1[12]*m2[3];
-		M[1] = m1[1]*m2[0] + m1[5]*m2[1] + m1[9]*m2[2] + m1[13]*m2[3];
-		M[2] = m1[2]*m2[0] + m1[6]*m2[1] + m1[10]*m2[2] + m1[14]*m2[3];
-		M[3] = m1[3]*m2[0] + m1[7]*m2[1] + m1[11]*m2[2] + m1[15]*m2[3];
-
-		M[4] = m1[0]*m2[4] + m1[4]*m2[5] + m1[8]*m2[6] + m1[12]*m2[7];
-		M[5] = m1[1]*m2[4] + m1[5]*m2[5] + m1[9]*m2[6] + m1[13]*m2[7];
-		M[6] = m1[2]*m2[4] + m1[6]*m2[5] + m1[10]*m2[6] + m1[14]*m2[7];
-		M[7] = m1[3]*m2[4] + m1[7]*m2[5] + m1[11]*m2[6] + m1[15]*m2[7];
-
-		M[8] = m1[0]*m2[8] + m1[4]*m2[9] + m1[8]*m2[10] + m1[12]*m2[11];
-		M[9] = m1[1]*m2[8] + m1[5]*m2[9] + m1[9]*m2[10] + m1[13]*m2[11];
-		M[10] = m1[2]*m2[8] + m1[6]*m2[9] + m1[10]*m2[10] + m1[14]*m2[11];
-		M[11] = m1[3]*m2[8] + m1[7]*m2[9] + m1[11]*m2[10] + m1[15]*m2[11];
-
-		M[12] = m1[0]*m2[12] + m1[4]*m2[13] + m1[8]*m2[14] + m1[12]*m2[15];
-		M[13] = m1[1]*m2[12] + m1[5]*m2[13] + m1[9]*m2[14] + m1[13]*m2[15];
-		M[14] = m1[2]*m2[12] + m1[6]*m2[13] + m1[10]*m2[14] + m1[14]*m2[15];
-		M[15] = m1[3]*m2[12] + m1[7]*m2[13] + m1[11]*m2[14] + m1[15]*m2[15];
+		multiplyMatrix4(M, other_a.M, other_b.M);
 #if defined ( USE_MATRIX_TEST )
 		definitelyIdentityMatrix=false;
 #endif
@@ -742,6 +737,21 @@ namespace core
 #endif
 	}
 
+	//! set each matrix to the product of two other matrices
+	template <class T>
+	inline void CMatrix4<T>::setbyproducts(CMatrix4<T>* out, const CMatrix4<T>* a, const CMatrix4<T>* b, u32 count)
+	{
+		// the products are built in copies when out is one of the operands
+		const bool inPlace = (out == a || out == b);
+		for (u32 i=0; i<count; ++i)
+		{
+			if (inPlace)
+				out[i] = a[i] * b[i];
+			else
+				out[i].setbyproduct_nocheck(a[i], b[i]);
+		}
+	}
+
 	//! multiply by another matrix
 	template <class T>
 	inline CMatrix4<T> CMatrix4<T>::operator*(const CMatrix4<T>& m2) const
@@ -755,28 +765,7 @@ namespace core
 #endif
 
 		CMatrix4<T> m3 ( EM4CONST_NOTHING );
-
-		const T *m1 = M;
-
-		m3[0] = m1[0]*m2[0] + m1[4]*m2[1] + m1[8]*m2[2] + m1[12]*m2[3];
-		m3[1] = m1[1]*m2[0] + m1[5]*m2[1] + m1[9]*m2[2] + m1[13]*m2[3];
-		m3[2] = m1[2]*m2[0] + m1[6]*m2[1] + m1[10]*m2[2] + m1[14]*m2[3];
-		m3[3] = m1[3]*m2[0] + m1[7]*m2[1] + m1[11]*m2[2] + m1[15]*m2[3];
-
-		m3[4] = m1[0]*m2[4] + m1[4]*m2[5] + m1[8]*m2[6] + m1[12]*m2[7];
-		m3[5] = m1[1]*m2[4] + m1[5]*m2[5] + m1[9]*m2[6] + m1[13]*m2[7];
-		m3[6] = m1[2]*m2[4] + m1[6]*m2[5] + m1[10]*m2[6] + m1[14]*m2[7];
-		m3[7] = m1[3]*m2[4] + m1[7]*m2[5] + m1[11]*m2[6] + m1[15]*m2[7];
-
-		m3[8] = m1[0]*m2[8] + m1[4]*m2[9] + m1[8]*m2[10] + m1[12]*m2[11];
-		m3[9] = m1[1]*m2[8] + m1[5]*m2[9] + m1[9]*m2[10] + m1[13]*m2[11];
-		m3[10] = m1[2]*m2[8] + m1[6]*m2[9] + m1[10]*m2[10] + m1[14]*m2[11];
-		m3[11] = m1[3]*m2[8] + m1[7]*m2[9] + m1[11]*m2[10] + m1[15]*m2[11];
-
-		m3[12] = m1[0]*m2[12] + m1[4]*m2[13] + m1[8]*m2[14] + m1[12]*m2[15];
-		m3[13] = m1[1]*m2[12] + m1[5]*m2[13] + m1[9]*m2[14] + m1[13]*m2[15];
-		m3[14] = m1[2]*m2[12] + m1[6]*m2[13] + m1[10]*m2[14] + m1[14]*m2[15];
-		m3[15] = m1[3]*m2[12] + m1[7]*m2[13] + m1[11]*m2[14] + m1[15]*m2[15];
+		multiplyMatrix4(m3.M, M, m2.M);
 		return m3;
 	}
 
@@ -1211,6 +1200,13 @@ namespace core
 	}
 
 
+	template <class T>
+	inline void CMatrix4<T>::transformVects(vector3df* out, const vector3df* in, u32 count) const
+	{
+		transformVectsMatrix4(M, out, in, count);
+	}
+
+
 	template <class T>
 	inline void CMatrix4<T>::transformVect(T *out, const core::vector3df &in) const
 	{
@@ -1286,45 +1282,7 @@ namespace core
 			return;
 #endif
 
-		const f32 Amin[3] = {box.MinEdge.X, box.MinEdge.Y, box.MinEdge.Z};
-		const f32 Amax[3] = {box.MaxEdge.X, box.MaxEdge.Y, box.MaxEdge.Z};
-
-		f32 Bmin[3];
-		f32 Bmax[3];
-
-		Bmin[0] = Bmax[0] = M[12];
-		Bmin[1] = Bmax[1] = M[13];
-		Bmin[2] = Bmax[2] = M[14];
-
-		const CMatrix4<T> &m = *this;
-
-		for (u32 i = 0; i < 3; ++i)
-		{
-			for (u32 j = 0; j < 3; ++j)
-			{
-				const f32 a = m(j,i) * Amin[j];
-				const f32 b = m(j,i) * Amax[j];
-
-				if (a < b)
-				{
-					Bmin[i] += a;
-					Bmax[i] += b;
-				}
-				else
-				{
-					Bmin[i] += b;
-					Bmax[i] += a;
-				}
-			}
-		}
-
-		box.MinEdge.X = Bmin[0];
-		box.MinEdge.Y = Bmin[1];
-		box.MinEdge.Z = Bmin[2];
-
-		box.MaxEdge.X = Bmax[0];
-		box.MaxEdge.Y = Bmax[1];
-		box.MaxEdge.Z = Bmax[2];
+		transformBoxMatrix4(M, box);
 	}
 
 
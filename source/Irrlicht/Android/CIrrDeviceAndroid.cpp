@@ -94,6 +94,7 @@ bool CIrrDeviceAndroid::run()
 		return false;
 
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 
 	s32 id;
 	s32 Events = 0;
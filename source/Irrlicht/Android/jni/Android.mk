@@ -41,6 +41,7 @@ LOCAL_SRC_FILES := \
 					CAttributes.cpp \
 					CB3DMeshFileLoader.cpp \
 					CB3DMeshWriter.cpp \
+					CIrrBinMeshWriter.cpp \
 					CBillboardSceneNode.cpp \
 					CBoneSceneNode.cpp \
 					CBSPMeshFileLoader.cpp \
@@ -98,6 +99,8 @@ LOCAL_SRC_FILES := \
 					CGUIWindow.cpp \
 					CGUIProfiler.cpp \
 					CImage.cpp \
+					CMipMapGenerator.cpp \
+					CTextureCompressor.cpp \
 					CImageLoaderBMP.cpp \
 					CImageLoaderDDS.cpp \
 					CImageLoaderJPG.cpp \
@@ -115,23 +118,28 @@ LOCAL_SRC_FILES := \
 					CImageWriterPPM.cpp \
 					CImageWriterPSD.cpp \
 					CImageWriterTGA.cpp \
+					CImageWriterPVR.cpp \
 					CImageLoaderPVR.cpp \
 					CIrrDeviceConsole.cpp \
 					CIrrDeviceFB.cpp \
 					CIrrDeviceLinux.cpp \
 					CIrrDeviceSDL.cpp \
 					CIrrDeviceStub.cpp \
+					CJobSystem.cpp \
 					CIrrDeviceWin32.cpp \
 					CIrrMeshFileLoader.cpp \
+					CIrrBinMeshFileLoader.cpp \
 					CIrrMeshWriter.cpp \
 					CLightSceneNode.cpp \
 					CLimitReadFile.cpp \
+					CBufferedReadFile.cpp \
 					CLMTSMeshFileLoader.cpp \
 					CLogger.cpp \
 					CLWOMeshFileLoader.cpp \
 					CMD2MeshFileLoader.cpp \
 					CMD3MeshFileLoader.cpp \
 					CMemoryFile.cpp \
+					CMappedReadFile.cpp \
 					CMeshCache.cpp \
 					CMeshManipulator.cpp \
 					CMeshSceneNode.cpp \
@@ -185,10 +193,13 @@ LOCAL_SRC_FILES := \
 					CPLYMeshWriter.cpp \
 					CProfiler.cpp \
 					CQ3LevelMesh.cpp \
+					CQ3LevelSceneNode.cpp \
 					CQuake3ShaderSceneNode.cpp \
 					CReadFile.cpp \
 					CSceneCollisionManager.cpp \
 					CSceneLoaderIrr.cpp \
+					CSceneLoaderIrrBin.cpp \
+					CSceneWriterIrrBin.cpp \
 					CSceneManager.cpp \
 					CSceneNodeAnimatorCameraFPS.cpp \
 					CSceneNodeAnimatorCameraMaya.cpp \
@@ -13,6 +13,8 @@
 #include "IReadFile.h"
 #include "IVideoDriver.h"
 #include "IMeshManipulator.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 #ifdef _DEBUG
 #define _IRR_DEBUG_3DS_LOADER_
@@ -169,6 +171,7 @@ bool C3DSMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* C3DSMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_3DS);)
 	if ( getMeshTextureLoader() )
 		getMeshTextureLoader()->setMeshFile(file);
 
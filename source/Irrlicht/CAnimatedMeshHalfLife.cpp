@@ -13,6 +13,8 @@
 #include "SMeshBuffer.h"
 #include "IVideoDriver.h"
 #include "IFileSystem.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -181,6 +183,7 @@ bool CHalflifeMDLMeshFileLoader::isALoadableFileExtension(const io::path& filena
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CHalflifeMDLMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_HALFLIFE);)
 	CAnimatedMeshHalfLife* msh = new CAnimatedMeshHalfLife();
 	if (msh)
 	{
@@ -577,6 +580,7 @@ void CAnimatedMeshHalfLife::buildVertices()
 	*/
 					}
 				} // tricmd
+				buffer->setDirty(EBT_VERTEX);
 			} // nummesh
 		} // model
 	} // bodypart
@@ -281,6 +281,7 @@ void CAnimatedMeshMD3::buildVertexArray(u32 frameA, u32 frameB, f32 interpolate,
 	}
 
 	dest->recalculateBoundingBox();
+	dest->setDirty(EBT_VERTEX);
 }
 
 
@@ -960,7 +960,7 @@ public:
 		}
 	}
 
-	virtual void setBoundingBox(const core::aabbox3d<f32>& value)
+	virtual void setBBox(const core::aabbox3d<f32>& value) _IRR_OVERRIDE_
 	{
 		reset();
 		if (IsFloat)
@@ -1002,7 +1002,7 @@ public:
 		}
 	}
 
-	virtual void setTriangle3d(const core::triangle3df& value)
+	virtual void setTriangle(const core::triangle3df& value) _IRR_OVERRIDE_
 	{
 		reset();
 		if (IsFloat)
@@ -1099,6 +1099,29 @@ public:
 		}
 	}
 
+	virtual void setLine3d(const core::line3df& v) _IRR_OVERRIDE_
+	{
+		reset();
+		if (IsFloat)
+		{
+			if (Count > 0) ValueF[0] = v.start.X;
+			if (Count > 1) ValueF[1] = v.start.Y;
+			if (Count > 2) ValueF[2] = v.start.Z;
+			if (Count > 3) ValueF[3] = v.end.X;
+			if (Count > 4) ValueF[4] = v.end.Y;
+			if (Count > 5) ValueF[5] = v.end.Z;
+		}
+		else
+		{
+			if (Count > 0) ValueI[0] = (s32)v.start.X;
+			if (Count > 1) ValueI[1] = (s32)v.start.Y;
+			if (Count > 2) ValueI[2] = (s32)v.start.Z;
+			if (Count > 3) ValueI[3] = (s32)v.end.X;
+			if (Count > 4) ValueI[4] = (s32)v.end.Y;
+			if (Count > 5) ValueI[5] = (s32)v.end.Z;
+		}
+	}
+
 	virtual void setDimension2d(const core::dimension2du& v) _IRR_OVERRIDE_
 	{
 		reset();
@@ -1571,6 +1594,7 @@ public:
 			for (i=0; enumerationLiterals[i]; ++i)
 				++literalCount;
 
+			EnumLiterals.set_used(0);
 			EnumLiterals.reallocate(literalCount);
 			for (i=0; enumerationLiterals[i]; ++i)
 				EnumLiterals.push_back(enumerationLiterals[i]);
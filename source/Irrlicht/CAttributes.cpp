@@ -32,6 +32,12 @@ CAttributes::~CAttributes()
 {
 	clear();
 
+	for (u32 t=0; t<EAT_COUNT; ++t)
+	{
+		for (u32 i=0; i<FreeAttributes[t].size(); ++i)
+			FreeAttributes[t][i]->drop();
+	}
+
 	if (Driver)
 		Driver->drop();
 }
@@ -41,34 +47,156 @@ CAttributes::~CAttributes()
 void CAttributes::clear()
 {
 	for (u32 i=0; i<Attributes.size(); ++i)
-		Attributes[i]->drop();
+	{
+		IAttribute* att = Attributes[i];
+
+		// Keep attributes nobody else holds for the next attributes of the same type
+		const E_ATTRIBUTE_TYPE type = att->getType();
+		if (att->getReferenceCount() == 1 && isRecyclableType(type))
+			FreeAttributes[type].push_back(att);
+		else
+			att->drop();
+	}
 
-	Attributes.clear();
+	Attributes.set_used(0);
+	NameHashes.set_used(0);
+	NameIndex.clear();
 }
 
 
-//! Sets a string attribute.
-//! \param attributeName: Name for the attribute
-//! \param value: Value for the attribute. Set this to 0 to delete the attribute
-void CAttributes::setAttribute(const c8* attributeName, const c8* value)
+//! Returns true for attribute types which addX can reinitialize by their setter
+bool CAttributes::isRecyclableType(E_ATTRIBUTE_TYPE type)
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
+	switch (type)
+	{
+	case EAT_TEXTURE:
+	case EAT_USER_POINTER:
+	case EAT_STRINGWARRAY:
+	case EAT_FLOATARRAY:
+	case EAT_INTARRAY:
+	case EAT_COUNT:
+	case EAT_UNKNOWN:
+		return false;
+	default:
+		return true;
+	}
+}
+
+
+//! Takes an attribute of the given type from the ones left over by clear()
+IAttribute* CAttributes::recycleAttribute(E_ATTRIBUTE_TYPE type, const c8* attributeName)
+{
+	core::array<IAttribute*>& pool = FreeAttributes[type];
+	if (pool.empty())
+		return 0;
+
+	IAttribute* att = pool.getLast();
+	pool.set_used(pool.size()-1);
+	att->Name = attributeName;
+	return att;
+}
+
+
+//! Hash function for attribute names (FNV-1a)
+u32 CAttributes::hashName(const c8* attributeName)
+{
+	u32 hash = 2166136261u;
+	if (attributeName)
+	{
+		for (const c8* c=attributeName; *c; ++c)
 		{
-			if (!value)
-			{
-				Attributes[i]->drop();
-				Attributes.erase(i);
-			}
-			else
-				Attributes[i]->setString(value);
+			hash ^= (u8)*c;
+			hash *= 16777619u;
+		}
+	}
+	return hash;
+}
+
+
+//! Appends an attribute and makes it known to the name lookup
+void CAttributes::addAttributeP(IAttribute* att)
+{
+	Attributes.push_back(att);
+	NameHashes.push_back(hashName(att->Name.c_str()));
+
+	if (Attributes.size() >= NAME_INDEX_MIN_ATTRIBUTES)
+	{
+		if (Attributes.size()*2 > NameIndex.size())
+			rebuildNameIndex();
+		else
+			insertNameIndex(Attributes.size()-1);
+	}
+}
 
+
+//! Removes and drops the attribute at the given index
+void CAttributes::removeAttributeP(u32 index)
+{
+	Attributes[index]->drop();
+	Attributes.erase(index);
+	NameHashes.erase(index);
+
+	// indices behind the erased one changed
+	if (Attributes.size() >= NAME_INDEX_MIN_ATTRIBUTES)
+		rebuildNameIndex();
+	else
+		NameIndex.clear();
+}
+
+
+//! Adds the attribute at index to the hash table, unless an earlier one has the same name
+void CAttributes::insertNameIndex(u32 index)
+{
+	const u32 mask = NameIndex.size()-1;
+	const u32 hash = NameHashes[index];
+	const core::stringc& name = Attributes[index]->Name;
+
+	for (u32 slot = hash & mask; ; slot = (slot+1) & mask)
+	{
+		const s32 entry = NameIndex[slot];
+		if (entry < 0)
+		{
+			NameIndex[slot] = (s32)index;
 			return;
 		}
+		if (NameHashes[entry] == hash && Attributes[entry]->Name == name)
+			return;
+	}
+}
+
 
-	if (value)
+//! Resizes the hash table to fit the current attributes and fills it again
+void CAttributes::rebuildNameIndex()
+{
+	u32 size = 32;
+	while (size < Attributes.size()*4)
+		size <<= 1;
+
+	NameIndex.set_used(size);
+	for (u32 i=0; i<size; ++i)
+		NameIndex[i] = -1;
+
+	for (u32 i=0; i<Attributes.size(); ++i)
+		insertNameIndex(i);
+}
+
+
+//! Sets a string attribute.
+//! \param attributeName: Name for the attribute
+//! \param value: Value for the attribute. Set this to 0 to delete the attribute
+void CAttributes::setAttribute(const c8* attributeName, const c8* value)
+{
+	const s32 index = findAttribute(attributeName);
+	if (index >= 0)
+	{
+		if (!value)
+			removeAttributeP(index);
+		else
+			Attributes[index]->setString(value);
+	}
+	else if (value)
 	{
-		Attributes.push_back(new CStringAttribute(attributeName, value));
+		addString(attributeName, value);
 	}
 }
 
@@ -118,25 +246,17 @@ core::stringc CAttributes::getAttributeAsString(s32 index) const
 //! \param value: Value for the attribute. Set this to 0 to delete the attribute
 void CAttributes::setAttribute(const c8* attributeName, const wchar_t* value)
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
+	const s32 index = findAttribute(attributeName);
+	if (index >= 0)
 	{
-		if (Attributes[i]->Name == attributeName)
-		{
-			if (!value)
-			{
-				Attributes[i]->drop();
-				Attributes.erase(i);
-			}
-			else
-				Attributes[i]->setString(value);
-
-			return;
-		}
+		if (!value)
+			removeAttributeP(index);
+		else
+			Attributes[index]->setString(value);
 	}
-
-	if (value)
+	else if (value)
 	{
-		Attributes.push_back(new CStringAttribute(attributeName, value));
+		addString(attributeName, value);
 	}
 }
 
@@ -183,7 +303,7 @@ core::stringw CAttributes::getAttributeAsStringW(s32 index) const
 //! Adds an attribute as an array of wide strings
 void CAttributes::addArray(const c8* attributeName, const core::array<core::stringw>& value)
 {
-	Attributes.push_back(new CStringWArrayAttribute(attributeName, value));
+	addAttributeP(new CStringWArrayAttribute(attributeName, value));
 }
 
 //! Sets an attribute value as an array of wide strings.
@@ -194,7 +314,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::array<core::
 		att->setArray(value);
 	else
 	{
-		Attributes.push_back(new CStringWArrayAttribute(attributeName, value));
+		addArray(attributeName, value);
 	}
 }
 
@@ -232,21 +352,36 @@ void CAttributes::setAttribute(s32 index, const core::array<core::stringw>& valu
 //! Returns attribute index from name, -1 if not found
 s32 CAttributes::findAttribute(const c8* attributeName) const
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
-			return i;
+	if (!attributeName)
+		return -1;
+
+	const u32 hash = hashName(attributeName);
+
+	if (NameIndex.empty())
+	{
+		for (u32 i=0; i<Attributes.size(); ++i)
+			if (NameHashes[i] == hash && Attributes[i]->Name == attributeName)
+				return i;
+
+		return -1;
+	}
 
-	return -1;
+	const u32 mask = NameIndex.size()-1;
+	for (u32 slot = hash & mask; ; slot = (slot+1) & mask)
+	{
+		const s32 entry = NameIndex[slot];
+		if (entry < 0)
+			return -1;
+		if (NameHashes[entry] == hash && Attributes[entry]->Name == attributeName)
+			return entry;
+	}
 }
 
 
 IAttribute* CAttributes::getAttributeP(const c8* attributeName) const
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
-			return Attributes[i];
-
-	return 0;
+	const s32 index = findAttribute(attributeName);
+	return index < 0 ? 0 : Attributes[index];
 }
 
 
@@ -258,7 +393,7 @@ void CAttributes::setAttribute(const c8* attributeName, bool value)
 		att->setBool(value);
 	else
 	{
-		Attributes.push_back(new CBoolAttribute(attributeName, value));
+		addBool(attributeName, value);
 	}
 }
 
@@ -283,7 +418,7 @@ void CAttributes::setAttribute(const c8* attributeName, s32 value)
 		att->setInt(value);
 	else
 	{
-		Attributes.push_back(new CIntAttribute(attributeName, value));
+		addInt(attributeName, value);
 	}
 }
 
@@ -307,7 +442,7 @@ void CAttributes::setAttribute(const c8* attributeName, f32 value)
 	if (att)
 		att->setFloat(value);
 	else
-		Attributes.push_back(new CFloatAttribute(attributeName, value));
+		addFloat(attributeName, value);
 }
 
 //! Gets a attribute as integer value
@@ -330,7 +465,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::SColor value)
 	if (att)
 		att->setColor(value);
 	else
-		Attributes.push_back(new CColorAttribute(attributeName, value));
+		addColor(attributeName, value);
 }
 
 //! Gets an attribute as color
@@ -352,7 +487,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::SColorf value)
 	if (att)
 		att->setColor(value);
 	else
-		Attributes.push_back(new CColorfAttribute(attributeName, value));
+		addColorf(attributeName, value);
 }
 
 //! Gets an attribute as floating point color
@@ -374,7 +509,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::position2di&
 	if (att)
 		att->setPosition(value);
 	else
-		Attributes.push_back(new CPosition2DAttribute(attributeName, value));
+		addPosition2d(attributeName, value);
 }
 
 //! Gets an attribute as 2d position
@@ -396,7 +531,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::rect<s32>& v
 	if (att)
 		att->setRect(value);
 	else
-		Attributes.push_back(new CRectAttribute(attributeName, value));
+		addRect(attributeName, value);
 }
 
 //! Gets an attribute as rectangle
@@ -418,7 +553,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::dimension2d<
 	if (att)
 		att->setDimension2d(value);
 	else
-		Attributes.push_back(new CDimension2dAttribute(attributeName, value));
+		addDimension2d(attributeName, value);
 }
 
 //! Gets an attribute as dimension2d
@@ -440,7 +575,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::vector3df& v
 	if (att)
 		att->setVector(value);
 	else
-		Attributes.push_back(new CVector3DAttribute(attributeName, value));
+		addVector3d(attributeName, value);
 }
 
 //! Sets a attribute as vector
@@ -450,7 +585,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::vector2df& v
 	if (att)
 		att->setVector2d(value);
 	else
-		Attributes.push_back(new CVector2DAttribute(attributeName, value));
+		addVector2d(attributeName, value);
 }
 
 //! Gets an attribute as vector
@@ -482,7 +617,7 @@ void CAttributes::setAttribute(const c8* attributeName, void* data, s32 dataSize
 	if (att)
 		att->setBinary(data, dataSizeInBytes);
 	else
-		Attributes.push_back(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
+		addBinary(attributeName, data, dataSizeInBytes);
 }
 
 //! Gets an attribute as binary data
@@ -501,7 +636,7 @@ void CAttributes::setAttribute(const c8* attributeName, const char* enumValue, c
 	if (att)
 		att->setEnum(enumValue, enumerationLiterals);
 	else
-		Attributes.push_back(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
+		addEnum(attributeName, enumValue, enumerationLiterals);
 }
 
 //! Gets an attribute as enumeration
@@ -552,7 +687,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::ITexture* value,
 	if (att)
 		att->setTexture(value, filename);
 	else
-		Attributes.push_back(new CTextureAttribute(attributeName, value, Driver, filename));
+		addTexture(attributeName, value, filename);
 }
 
 
@@ -796,37 +931,78 @@ void CAttributes::getAttributeEnumerationLiteralsOfEnumeration(s32 index, core::
 //! Adds an attribute as integer
 void CAttributes::addInt(const c8* attributeName, s32 value)
 {
-	Attributes.push_back(new CIntAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_INT, attributeName);
+	if (att)
+		att->setInt(value);
+	else
+		att = new CIntAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as float
 void CAttributes::addFloat(const c8* attributeName, f32 value)
 {
-	Attributes.push_back(new CFloatAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_FLOAT, attributeName);
+	if (att)
+		att->setFloat(value);
+	else
+		att = new CFloatAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as string
 void CAttributes::addString(const c8* attributeName, const char* value)
 {
-	Attributes.push_back(new CStringAttribute(attributeName, value));
+	CStringAttribute* att = (CStringAttribute*)recycleAttribute(EAT_STRING, attributeName);
+	if (att)
+	{
+		att->IsStringW = false;
+		att->ValueW = L"";
+		att->setString(value);
+	}
+	else
+		att = new CStringAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as wchar string
 void CAttributes::addString(const c8* attributeName, const wchar_t* value)
 {
-	Attributes.push_back(new CStringAttribute(attributeName, value));
+	CStringAttribute* att = (CStringAttribute*)recycleAttribute(EAT_STRING, attributeName);
+	if (att)
+	{
+		att->IsStringW = true;
+		att->Value = "";
+		att->setString(value);
+	}
+	else
+		att = new CStringAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as bool
 void CAttributes::addBool(const c8* attributeName, bool value)
 {
-	Attributes.push_back(new CBoolAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_BOOL, attributeName);
+	if (att)
+		att->setBool(value);
+	else
+		att = new CBoolAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as enum
 void CAttributes::addEnum(const c8* attributeName, const char* enumValue, const char* const* enumerationLiterals)
 {
-	Attributes.push_back(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
+	CEnumAttribute* att = (CEnumAttribute*)recycleAttribute(EAT_ENUM, attributeName);
+	if (att)
+	{
+		att->EnumLiterals.set_used(0);
+		att->setEnum(enumValue, enumerationLiterals);
+	}
+	else
+		att = new CEnumAttribute(attributeName, enumValue, enumerationLiterals);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as enum
@@ -839,56 +1015,96 @@ void CAttributes::addEnum(const c8* attributeName, s32 enumValue, const char* co
 //! Adds an attribute as color
 void CAttributes::addColor(const c8* attributeName, video::SColor value)
 {
-	Attributes.push_back(new CColorAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_COLOR, attributeName);
+	if (att)
+		att->setColor(value);
+	else
+		att = new CColorAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as floating point color
 void CAttributes::addColorf(const c8* attributeName, video::SColorf value)
 {
-	Attributes.push_back(new CColorfAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_COLORF, attributeName);
+	if (att)
+		att->setColor(value);
+	else
+		att = new CColorfAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as 3d vector
 void CAttributes::addVector3d(const c8* attributeName, const core::vector3df& value)
 {
-	Attributes.push_back(new CVector3DAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_VECTOR3D, attributeName);
+	if (att)
+		att->setVector(value);
+	else
+		att = new CVector3DAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as 2d vector
 void CAttributes::addVector2d(const c8* attributeName, const core::vector2df& value)
 {
-	Attributes.push_back(new CVector2DAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_VECTOR2D, attributeName);
+	if (att)
+		att->setVector2d(value);
+	else
+		att = new CVector2DAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 
 //! Adds an attribute as 2d position
 void CAttributes::addPosition2d(const c8* attributeName, const core::position2di& value)
 {
-	Attributes.push_back(new CPosition2DAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_POSITION2D, attributeName);
+	if (att)
+		att->setPosition(value);
+	else
+		att = new CPosition2DAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as rectangle
 void CAttributes::addRect(const c8* attributeName, const core::rect<s32>& value)
 {
-	Attributes.push_back(new CRectAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_RECT, attributeName);
+	if (att)
+		att->setRect(value);
+	else
+		att = new CRectAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as dimension2d
 void CAttributes::addDimension2d(const c8* attributeName, const core::dimension2d<u32>& value)
 {
-	Attributes.push_back(new CDimension2dAttribute(attributeName, value));
+	IAttribute* att = recycleAttribute(EAT_DIMENSION2D, attributeName);
+	if (att)
+		att->setDimension2d(value);
+	else
+		att = new CDimension2dAttribute(attributeName, value);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as binary data
 void CAttributes::addBinary(const c8* attributeName, void* data, s32 dataSizeInBytes)
 {
-	Attributes.push_back(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
+	IAttribute* att = recycleAttribute(EAT_BINARY, attributeName);
+	if (att)
+		att->setBinary(data, dataSizeInBytes);
+	else
+		att = new CBinaryAttribute(attributeName, data, dataSizeInBytes);
+	addAttributeP(att);
 }
 
 //! Adds an attribute as texture reference
 void CAttributes::addTexture(const c8* attributeName, video::ITexture* texture, const io::path& filename)
 {
-	Attributes.push_back(new CTextureAttribute(attributeName, texture, Driver, filename));
+	addAttributeP(new CTextureAttribute(attributeName, texture, Driver, filename));
 }
 
 //! Returns if an attribute with a name exists
@@ -1010,7 +1226,12 @@ void CAttributes::setAttribute(s32 index, video::ITexture* texture, const io::pa
 //! Adds an attribute as matrix
 void CAttributes::addMatrix(const c8* attributeName, const core::matrix4& v)
 {
-	Attributes.push_back(new CMatrixAttribute(attributeName, v));
+	IAttribute* att = recycleAttribute(EAT_MATRIX, attributeName);
+	if (att)
+		att->setMatrix(v);
+	else
+		att = new CMatrixAttribute(attributeName, v);
+	addAttributeP(att);
 }
 
 
@@ -1021,7 +1242,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::matrix4& v)
 	if (att)
 		att->setMatrix(v);
 	else
-		Attributes.push_back(new CMatrixAttribute(attributeName, v));
+		addMatrix(attributeName, v);
 }
 
 //! Gets an attribute as a matrix4
@@ -1055,7 +1276,12 @@ void CAttributes::setAttribute(s32 index, const core::matrix4& v)
 //! Adds an attribute as quaternion
 void CAttributes::addQuaternion(const c8* attributeName, const core::quaternion& v)
 {
-	Attributes.push_back(new CQuaternionAttribute(attributeName, v));
+	IAttribute* att = recycleAttribute(EAT_QUATERNION, attributeName);
+	if (att)
+		att->setQuaternion(v);
+	else
+		att = new CQuaternionAttribute(attributeName, v);
+	addAttributeP(att);
 }
 
 
@@ -1067,7 +1293,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::quaternion&
 		att->setQuaternion(v);
 	else
 	{
-		Attributes.push_back(new CQuaternionAttribute(attributeName, v));
+		addQuaternion(attributeName, v);
 	}
 }
 
@@ -1102,7 +1328,12 @@ if (index >= 0 && index < (s32)Attributes.size() )
 //! Adds an attribute as axis aligned bounding box
 void CAttributes::addBox3d(const c8* attributeName, const core::aabbox3df& v)
 {
-	Attributes.push_back(new CBBoxAttribute(attributeName, v));
+	IAttribute* att = recycleAttribute(EAT_BBOX, attributeName);
+	if (att)
+		att->setBBox(v);
+	else
+		att = new CBBoxAttribute(attributeName, v);
+	addAttributeP(att);
 }
 
 //! Sets an attribute as axis aligned bounding box
@@ -1113,7 +1344,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::aabbox3df& v
 		att->setBBox(v);
 	else
 	{
-		Attributes.push_back(new CBBoxAttribute(attributeName, v));
+		addBox3d(attributeName, v);
 	}
 }
 
@@ -1148,7 +1379,12 @@ if (index >= 0 && index < (s32)Attributes.size() )
 //! Adds an attribute as 3d plane
 void CAttributes::addPlane3d(const c8* attributeName, const core::plane3df& v)
 {
-	Attributes.push_back(new CPlaneAttribute(attributeName, v));
+	IAttribute* att = recycleAttribute(EAT_PLANE, attributeName);
+	if (att)
+		att->setPlane(v);
+	else
+		att = new CPlaneAttribute(attributeName, v);
+	addAttributeP(att);
 }
 
 //! Sets an attribute as 3d plane
@@ -1159,7 +1395,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::plane3df& v)
 		att->setPlane(v);
 	else
 	{
-		Attributes.push_back(new CPlaneAttribute(attributeName, v));
+		addPlane3d(attributeName, v);
 	}
 }
 
@@ -1194,7 +1430,12 @@ void CAttributes::setAttribute(s32 index, const core::plane3df& v)
 //! Adds an attribute as 3d triangle
 void CAttributes::addTriangle3d(const c8* attributeName, const core::triangle3df& v)
 {
-	Attributes.push_back(new CTriangleAttribute(attributeName, v));
+	IAttribute* att = recycleAttribute(EAT_TRIANGLE3D, attributeName);
+	if (att)
+		att->setTriangle(v);
+	else
+		att = new CTriangleAttribute(attributeName, v);
+	addAttributeP(att);
 }
 
 //! Sets an attribute as 3d triangle
@@ -1205,7 +1446,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::triangle3df&
 		att->setTriangle(v);
 	else
 	{
-		Attributes.push_back(new CTriangleAttribute(attributeName, v));
+		addTriangle3d(attributeName, v);
 	}
 }
 
@@ -1241,7 +1482,12 @@ void CAttributes::setAttribute(s32 index, const core::triangle3df& v)
 //! Adds an attribute as a 2d line
 void CAttributes::addLine2d(const c8* attributeName, const core::line2df& v)
 {
-	Attributes.push_back(new CLine2dAttribute(attributeName, v));
+	IAttribute* att = recycleAttribute(EAT_LINE2D, attributeName);
+	if (att)
+		att->setLine2d(v);
+	else
+		att = new CLine2dAttribute(attributeName, v);
+	addAttributeP(att);
 }
 
 //! Sets an attribute as a 2d line
@@ -1252,7 +1498,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::line2df& v)
 		att->setLine2d(v);
 	else
 	{
-		Attributes.push_back(new CLine2dAttribute(attributeName, v));
+		addLine2d(attributeName, v);
 	}
 }
 
@@ -1287,7 +1533,12 @@ void CAttributes::setAttribute(s32 index, const core::line2df& v)
 //! Adds an attribute as a 3d line
 void CAttributes::addLine3d(const c8* attributeName, const core::line3df& v)
 {
-	Attributes.push_back(new CLine3dAttribute(attributeName, v));
+	IAttribute* att = recycleAttribute(EAT_LINE3D, attributeName);
+	if (att)
+		att->setLine3d(v);
+	else
+		att = new CLine3dAttribute(attributeName, v);
+	addAttributeP(att);
 }
 
 //! Sets an attribute as a 3d line
@@ -1298,7 +1549,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::line3df& v)
 		att->setLine3d(v);
 	else
 	{
-		Attributes.push_back(new CLine3dAttribute(attributeName, v));
+		addLine3d(attributeName, v);
 	}
 }
 
@@ -1335,7 +1586,7 @@ void CAttributes::setAttribute(s32 index, const core::line3df& v)
 //! Adds an attribute as user pointer
 void CAttributes::addUserPointer(const c8* attributeName, void* userPointer)
 {
-	Attributes.push_back(new CUserPointerAttribute(attributeName, userPointer));
+	addAttributeP(new CUserPointerAttribute(attributeName, userPointer));
 }
 
 //! Sets an attribute as user pointer
@@ -1346,7 +1597,7 @@ void CAttributes::setAttribute(const c8* attributeName, void* userPointer)
 		att->setUserPointer(userPointer);
 	else
 	{
-		Attributes.push_back(new CUserPointerAttribute(attributeName, userPointer));
+		addUserPointer(attributeName, userPointer);
 	}
 }
 
@@ -724,9 +724,37 @@ protected:
 
 	void readAttributeFromXML(const io::IXMLReader* reader);
 
+	IAttribute* getAttributeP(const c8* attributeName) const;
+
+	//! Appends an attribute and adds it to the name lookup
+	void addAttributeP(IAttribute* att);
+
+	//! Removes and drops the attribute at the given index
+	void removeAttributeP(u32 index);
+
+	//! Returns an attribute left over by clear(), renamed to attributeName, or 0
+	IAttribute* recycleAttribute(E_ATTRIBUTE_TYPE type, const c8* attributeName);
+
+	void insertNameIndex(u32 index);
+	void rebuildNameIndex();
+
+	static bool isRecyclableType(E_ATTRIBUTE_TYPE type);
+	static u32 hashName(const c8* attributeName);
+
+	//! Below this count attributes are found by comparing the name hashes one by one
+	static const u32 NAME_INDEX_MIN_ATTRIBUTES = 16;
+
 	core::array<IAttribute*> Attributes;
 
-	IAttribute* getAttributeP(const c8* attributeName) const;
+	//! Hashes of the attribute names, same order as Attributes
+	core::array<u32> NameHashes;
+
+	//! Open addressing hash table with indices into Attributes, -1 for free slots.
+	//! Empty while there are less than NAME_INDEX_MIN_ATTRIBUTES attributes.
+	core::array<s32> NameIndex;
+
+	//! Attributes kept by clear() for reuse, sorted by type
+	core::array<IAttribute*> FreeAttributes[EAT_COUNT];
 
 	video::IVideoDriver* Driver;
 };
@@ -11,10 +11,13 @@
 
 #include "CB3DMeshFileLoader.h"
 #include "CMeshTextureLoader.h"
+#include "CBufferedReadFile.h"
 
 #include "IVideoDriver.h"
 #include "IFileSystem.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 #ifdef _DEBUG
 #define _B3D_READER_DEBUG
@@ -52,13 +55,15 @@ bool CB3DMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CB3DMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_B3D);)
 	if (!file)
 		return 0;
 
 	if ( getMeshTextureLoader() )
 		getMeshTextureLoader()->setMeshFile(file);
 
-	B3DFile = file;
+	// the chunks are read in many small pieces
+	B3DFile = io::CBufferedReadFile::createBufferedReadFile(file);
 	AnimatedMesh = new scene::CSkinnedMesh();
 	ShowWarning = true; // If true a warning is issued if too many textures are used
 	VerticesStart=0;
@@ -73,6 +78,9 @@ IAnimatedMesh* CB3DMeshFileLoader::createMesh(io::IReadFile* file)
 		AnimatedMesh = 0;
 	}
 
+	B3DFile->drop();
+	B3DFile = 0;
+
 	return AnimatedMesh;
 }
 
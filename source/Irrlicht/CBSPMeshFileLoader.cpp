@@ -7,6 +7,8 @@
 
 #include "CBSPMeshFileLoader.h"
 #include "CQ3LevelMesh.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -50,6 +52,7 @@ bool CBSPMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CBSPMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_BSP);)
 	s32 type = core::isFileExtension ( file->getFileName(), "bsp", "shader", "cfg" );
 	CQ3LevelMesh* q = 0;
 
@@ -67,11 +67,16 @@ void CBoneSceneNode::OnAnimate(u32 timeMs)
 {
 	if (IsVisible)
 	{
-		// animate this node with all animators
-
-		ISceneNodeAnimatorList::Iterator ait = Animators.begin();
-		for (; ait != Animators.end(); ++ait)
-			(*ait)->animateNode(this, timeMs);
+		// animate this node with all animators, unless the scene
+		// manager did already in its parallel animation
+		if (AnimatedEarly)
+			AnimatedEarly = false;
+		else
+		{
+			ISceneNodeAnimatorList::Iterator ait = Animators.begin();
+			for (; ait != Animators.end(); ++ait)
+				(*ait)->animateNode(this, timeMs);
+		}
 
 		// update absolute position
 		//updateAbsolutePosition();
@@ -0,0 +1,173 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CBufferedReadFile.h"
+
+namespace irr
+{
+namespace io
+{
+
+
+CBufferedReadFile::CBufferedReadFile(IReadFile* file, size_t bufferSize)
+: File(file), Buffer(0), BufferSize(bufferSize), BufferFill(0), BufferStart(0),
+	FilePos(0), Pos(0), Len(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CBufferedReadFile");
+	#endif
+
+	if (File)
+	{
+		File->grab();
+		Len = File->getSize();
+		FilePos = File->getPos();
+		Pos = FilePos;
+	}
+
+	if (!BufferSize)
+		BufferSize = 1;
+	Buffer = new c8[BufferSize];
+}
+
+
+CBufferedReadFile::~CBufferedReadFile()
+{
+	if (File)
+	{
+		seekFile(Pos);
+		File->drop();
+	}
+
+	delete [] Buffer;
+}
+
+
+//! returns how much was read
+size_t CBufferedReadFile::read(void* buffer, size_t sizeToRead)
+{
+	if (!File)
+		return 0;
+
+	c8* out = (c8*)buffer;
+	size_t done = 0;
+
+	while (done < sizeToRead)
+	{
+		// the buffer holds the next bytes
+		if (Pos >= BufferStart && Pos < BufferStart + (long)BufferFill)
+		{
+			size_t amount = BufferFill - (size_t)(Pos - BufferStart);
+			if (amount > sizeToRead - done)
+				amount = sizeToRead - done;
+
+			memcpy(out + done, Buffer + (Pos - BufferStart), amount);
+			Pos += (long)amount;
+			done += amount;
+		}
+		// large reads don't need the buffer
+		else if (sizeToRead - done >= BufferSize)
+		{
+			if (!seekFile(Pos))
+				break;
+
+			const size_t amount = File->read(out + done, sizeToRead - done);
+			FilePos += (long)amount;
+			Pos += (long)amount;
+			done += amount;
+			break;
+		}
+		else if (!fillBuffer())
+			break;
+	}
+
+	return done;
+}
+
+
+//! changes position in file, returns true if successful
+//! if relativeMovement==true, the pos is changed relative to current pos,
+//! otherwise from begin of file
+bool CBufferedReadFile::seek(long finalPos, bool relativeMovement)
+{
+	if (relativeMovement)
+		finalPos += Pos;
+
+	if (!File || finalPos < 0 || finalPos > Len)
+		return false;
+
+	// the other file is moved when it's read again
+	Pos = finalPos;
+	return true;
+}
+
+
+//! returns size of file
+long CBufferedReadFile::getSize() const
+{
+	return Len;
+}
+
+
+//! returns where in the file we are.
+long CBufferedReadFile::getPos() const
+{
+	return Pos;
+}
+
+
+//! returns name of file
+const io::path& CBufferedReadFile::getFileName() const
+{
+	static const io::path empty;
+	return File ? File->getFileName() : empty;
+}
+
+
+//! reads the next bytes of the other file into the buffer
+bool CBufferedReadFile::fillBuffer()
+{
+	BufferFill = 0;
+	if (!seekFile(Pos))
+		return false;
+
+	BufferStart = Pos;
+	BufferFill = File->read(Buffer, BufferSize);
+	FilePos += (long)BufferFill;
+	return BufferFill != 0;
+}
+
+
+//! moves the other file to the position
+bool CBufferedReadFile::seekFile(long pos)
+{
+	if (FilePos == pos)
+		return true;
+
+	if (!File->seek(pos))
+		return false;
+
+	FilePos = pos;
+	return true;
+}
+
+
+IReadFile* CBufferedReadFile::createBufferedReadFile(IReadFile* file, size_t bufferSize)
+{
+	if (!file)
+		return 0;
+
+	if (file->getType() == ERFT_MEMORY_READ_FILE || file->getType() == ERFT_MAPPED_READ_FILE)
+	{
+		file->grab();
+		return file;
+	}
+
+	return new CBufferedReadFile(file, bufferSize);
+}
+
+
+} // end namespace io
+} // end namespace irr
+
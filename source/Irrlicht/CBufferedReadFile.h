@@ -0,0 +1,80 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BUFFERED_READ_FILE_H_INCLUDED__
+#define __C_BUFFERED_READ_FILE_H_INCLUDED__
+
+#include "IReadFile.h"
+#include "irrString.h"
+
+namespace irr
+{
+
+namespace io
+{
+
+	/*!
+		Class reading ahead from another file, so many small reads don't
+		each go to the other file.
+	*/
+	class CBufferedReadFile : public IReadFile
+	{
+	public:
+
+		//! Constructor
+		CBufferedReadFile(IReadFile* file, size_t bufferSize);
+
+		//! Destructor, leaves the other file at the position of this file
+		virtual ~CBufferedReadFile();
+
+		//! returns how much was read
+		virtual size_t read(void* buffer, size_t sizeToRead) _IRR_OVERRIDE_;
+
+		//! changes position in file, returns true if successful
+		virtual bool seek(long finalPos, bool relativeMovement = false) _IRR_OVERRIDE_;
+
+		//! returns size of file
+		virtual long getSize() const _IRR_OVERRIDE_;
+
+		//! returns where in the file we are.
+		virtual long getPos() const _IRR_OVERRIDE_;
+
+		//! returns name of file
+		virtual const io::path& getFileName() const _IRR_OVERRIDE_;
+
+		//! Get the type of the class implementing this interface
+		virtual EREAD_FILE_TYPE getType() const _IRR_OVERRIDE_
+		{
+			return ERFT_BUFFERED_READ_FILE;
+		}
+
+		//! Returns a buffered file reading from the file.
+		/** Files in memory are returned grabbed themselves instead, as
+		reading from them is already cheap. Drop the returned file when
+		it is no longer needed. */
+		static IReadFile* createBufferedReadFile(IReadFile* file, size_t bufferSize=4096);
+
+	private:
+
+		//! reads the next bytes of the other file into the buffer
+		bool fillBuffer();
+
+		//! moves the other file to the position
+		bool seekFile(long pos);
+
+		IReadFile* File;
+		c8* Buffer;
+		size_t BufferSize;
+		size_t BufferFill;
+		long BufferStart;
+		long FilePos;
+		long Pos;
+		long Len;
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif
+
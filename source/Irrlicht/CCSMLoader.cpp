@@ -19,6 +19,8 @@
 #include "IVideoDriver.h"
 #include "SAnimatedMesh.h"
 #include "SMeshBufferLightMap.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 #ifdef _DEBUG
 #define _IRR_DEBUG_CSM_LOADER_
@@ -379,6 +381,7 @@ namespace scene
 	//! creates/loads an animated mesh from the file.
 	IAnimatedMesh* CCSMLoader::createMesh(io::IReadFile* file)
 	{
+		IRR_PROFILE(CProfileScope p1(EPID_ML_CSM);)
 		if ( getMeshTextureLoader() )
 			getMeshTextureLoader()->setMeshFile(file);
 
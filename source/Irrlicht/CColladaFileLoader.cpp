@@ -22,6 +22,8 @@
 #include "IMeshSceneNode.h"
 #include "SMeshBufferLightMap.h"
 #include "irrMap.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 #ifdef _DEBUG
 #define COLLADA_READER_DEBUG
@@ -32,97 +34,44 @@ namespace scene
 {
 namespace
 {
-	// currently supported COLLADA tag names
-	const core::stringc colladaSectionName =   "COLLADA";
-	const core::stringc librarySectionName =   "library";
-	const core::stringc libraryNodesSectionName = "library_nodes";
-	const core::stringc libraryGeometriesSectionName = "library_geometries";
-	const core::stringc libraryMaterialsSectionName = "library_materials";
-	const core::stringc libraryImagesSectionName = "library_images";
-	const core::stringc libraryVisualScenesSectionName = "library_visual_scenes";
-	const core::stringc libraryCamerasSectionName = "library_cameras";
-	const core::stringc libraryLightsSectionName = "library_lights";
-	const core::stringc libraryEffectsSectionName = "library_effects";
-	const core::stringc assetSectionName =     "asset";
-	const core::stringc sceneSectionName =     "scene";
-	const core::stringc visualSceneSectionName = "visual_scene";
-
-	const core::stringc lightPrefabName =      "light";
-	const core::stringc cameraPrefabName =     "camera";
-	const core::stringc materialSectionName =  "material";
-	const core::stringc geometrySectionName =  "geometry";
-	const core::stringc imageSectionName =     "image";
-	const core::stringc textureSectionName =   "texture";
-	const core::stringc effectSectionName =    "effect";
-
-	const core::stringc pointSectionName =     "point";
-	const core::stringc directionalSectionName ="directional";
-	const core::stringc spotSectionName =      "spot";
-	const core::stringc ambientSectionName =   "ambient";
-	const core::stringc meshSectionName =      "mesh";
-	const core::stringc sourceSectionName =    "source";
-	const core::stringc arraySectionName =     "array";
-	const core::stringc floatArraySectionName ="float_array";
-	const core::stringc intArraySectionName =  "int_array";
-	const core::stringc techniqueCommonSectionName = "technique_common";
-	const core::stringc accessorSectionName =  "accessor";
-	const core::stringc verticesSectionName =  "vertices";
-	const core::stringc inputTagName =         "input";
-	const core::stringc polylistSectionName =  "polylist";
-	const core::stringc trianglesSectionName = "triangles";
-	const core::stringc polygonsSectionName =  "polygons";
-	const core::stringc primitivesName =       "p";
-	const core::stringc vcountName =           "vcount";
-
-	const core::stringc upAxisNodeName =       "up_axis";
-	const core::stringc nodeSectionName =      "node";
-	const core::stringc lookatNodeName =       "lookat";
-	const core::stringc matrixNodeName =       "matrix";
-	const core::stringc perspectiveNodeName =  "perspective";
-	const core::stringc rotateNodeName =       "rotate";
-	const core::stringc scaleNodeName =        "scale";
-	const core::stringc translateNodeName =    "translate";
-	const core::stringc skewNodeName =         "skew";
-	const core::stringc minNodeName =          "min";
-	const core::stringc maxNodeName =          "max";
-	const core::stringc instanceName =         "instance";
-	const core::stringc instanceGeometryName = "instance_geometry";
-	const core::stringc instanceSceneName =    "instance_visual_scene";
-	const core::stringc instanceEffectName =   "instance_effect";
-	const core::stringc instanceMaterialName = "instance_material";
-	const core::stringc instanceLightName =    "instance_light";
-	const core::stringc instanceNodeName =     "instance_node";
-	const core::stringc instanceCameraName =   "instance_camera";
-	const core::stringc bindMaterialName =     "bind_material";
-	const core::stringc extraNodeName =        "extra";
-	const core::stringc techniqueNodeName =    "technique";
-	const core::stringc colorNodeName =        "color";
-	const core::stringc floatNodeName =        "float";
-	const core::stringc float2NodeName =       "float2";
-	const core::stringc float3NodeName =       "float3";
-
-	const core::stringc newParamName =         "newparam";
-	const core::stringc paramTagName =         "param";
-	const core::stringc initFromName =         "init_from";
-	const core::stringc dataName =             "data";
+	// names of the elements in ECOLLADA_ELEMENT, in the same order
+	const char* const elementNames[] = {
+		"COLLADA", "library", "library_nodes", "library_geometries",
+		"library_materials", "library_images", "library_visual_scenes",
+		"library_cameras", "library_lights", "library_effects", "asset",
+		"scene", "visual_scene", "light", "camera", "material", "geometry",
+		"image", "texture", "effect", "point", "directional", "spot",
+		"ambient", "mesh", "source", "array", "float_array", "int_array",
+		"technique_common", "accessor", "vertices", "input", "polylist",
+		"triangles", "polygons", "p", "vcount", "up_axis", "node", "lookat",
+		"matrix", "perspective", "rotate", "scale", "translate", "skew",
+		"min", "max", "instance", "instance_geometry",
+		"instance_visual_scene", "instance_effect", "instance_material",
+		"instance_light", "instance_node", "instance_camera",
+		"bind_material", "extra", "technique", "color", "float", "float2",
+		"float3", "newparam", "param", "init_from", "data", "wrap_s",
+		"wrap_t", "wrap_r", "wrap_p", "minfilter", "magfilter", "mipfilter",
+		"double_sided", "constant_attenuation", "linear_attenuation",
+		"quadratic_attenuation", "falloff_angle", "falloff_exponent",
+		"profile_COMMON", "constant", "lambert", "phong", "blinn",
+		"emission", "diffuse", "specular", "shininess", "reflective",
+		"reflectivity", "transparent", "transparency", "index_of_refraction", 0};
+
+	// attribute names of the texture wrap modes in the effect parameters
 	const core::stringc wrapsName =            "wrap_s";
 	const core::stringc wraptName =            "wrap_t";
 	const core::stringc wraprName =            "wrap_r";	// for downward compatibility to bug in old Irrlicht collada writer. Not standard but we wrote that accidentally up to Irrlicht 1.8, so we should still be able to load those files
 	const core::stringc wrappName =            "wrap_p";
-	const core::stringc minfilterName =        "minfilter";
-	const core::stringc magfilterName =        "magfilter";
-	const core::stringc mipfilterName =        "mipfilter";
 
-	const core::stringc textureNodeName =      "texture";
-	const core::stringc doubleSidedNodeName =  "double_sided";
-	const core::stringc constantAttenuationNodeName = "constant_attenuation";
-	const core::stringc linearAttenuationNodeName = "linear_attenuation";
-	const core::stringc quadraticAttenuationNodeName = "quadratic_attenuation";
-	const core::stringc falloffAngleNodeName = "falloff_angle";
-	const core::stringc falloffExponentNodeName = "falloff_exponent";
-
-	const core::stringc profileCOMMONSectionName = "profile_COMMON";
-	const core::stringc profileCOMMONAttributeName = "COMMON";
+	//! hashes an element name to one of the 1024 slots of the element table of the loader
+	inline u32 hashElementName(const c8* name, u32 seed)
+	{
+		// FNV-1a, the upper bits are mixed best
+		u32 hash = 2166136261u ^ seed;
+		while (*name)
+			hash = (hash ^ (u8)*name++) * 16777619u;
+		return hash >> 22;
+	}
 
 	const char* const inputSemanticNames[] = {"POSITION", "VERTEX", "NORMAL", "TEXCOORD",
 		"UV", "TANGENT", "IMAGE", "TEXTURE", "COLOR", 0};
@@ -326,7 +275,8 @@ namespace
 CColladaFileLoader::CColladaFileLoader(scene::ISceneManager* smgr,
 		io::IFileSystem* fs)
 : SceneManager(smgr), FileSystem(fs), DummyMesh(0),
-	FirstLoadedMesh(0), LoadedMeshCount(0), CreateInstances(false)
+	FirstLoadedMesh(0), LoadedMeshCount(0), CurrentElement(ECE_COUNT),
+	CreateInstances(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CColladaFileLoader");
@@ -349,6 +299,22 @@ CColladaFileLoader::CColladaFileLoader(scene::ISceneManager* smgr,
 
 
 	TextureLoader = new CMeshTextureLoader( FileSystem, SceneManager->getVideoDriver() );
+
+	// find a seed for which all element names get their own slot in the table
+	for (ElementSeed=0; ; ++ElementSeed)
+	{
+		memset(ElementTable, ECE_COUNT, sizeof(ElementTable));
+		u32 i;
+		for (i=0; i<ECE_COUNT; ++i)
+		{
+			u8& slot = ElementTable[hashElementName(elementNames[i], ElementSeed)];
+			if (slot != ECE_COUNT)
+				break;
+			slot = (u8)i;
+		}
+		if (i == ECE_COUNT)
+			break;
+	}
 }
 
 
@@ -377,6 +343,7 @@ bool CColladaFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CColladaFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_COLLADA);)
 	io::IXMLReaderUTF8* reader = FileSystem->createXMLReaderUTF8(file);
 	if (!reader)
 		return 0;
@@ -392,11 +359,11 @@ IAnimatedMesh* CColladaFileLoader::createMesh(io::IReadFile* file)
 
 	// read until COLLADA section, skip other parts
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
-			if (colladaSectionName == reader->getNodeName())
+			if (ECE_COLLADA == CurrentElement)
 				readColladaSection(reader);
 			else
 				skipSection(reader, true); // unknown section
@@ -442,6 +409,34 @@ IAnimatedMesh* CColladaFileLoader::createMesh(io::IReadFile* file)
 }
 
 
+//! returns the element with the given name, or ECE_COUNT if it is not read by this loader
+ECOLLADA_ELEMENT CColladaFileLoader::getElement(const c8* name) const
+{
+	const u8 element = ElementTable[hashElementName(name, ElementSeed)];
+	if (element != ECE_COUNT && !strcmp(elementNames[element], name))
+		return (ECOLLADA_ELEMENT)element;
+	return ECE_COUNT;
+}
+
+
+//! reads the next node and sets CurrentElement to its element
+bool CColladaFileLoader::readNext(io::IXMLReaderUTF8* reader)
+{
+	if (!reader->read())
+	{
+		CurrentElement = ECE_COUNT;
+		return false;
+	}
+
+	const io::EXML_NODE type = reader->getNodeType();
+	if (type == io::EXN_ELEMENT || type == io::EXN_ELEMENT_END)
+		CurrentElement = getElement(reader->getNodeName());
+	else
+		CurrentElement = ECE_COUNT;
+	return true;
+}
+
+
 //! skips an (unknown) section in the collada document
 void CColladaFileLoader::skipSection(io::IXMLReaderUTF8* reader, bool reportSkipping)
 {
@@ -473,6 +468,9 @@ void CColladaFileLoader::skipSection(io::IXMLReaderUTF8* reader, bool reportSkip
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 			--tagCounter;
 	}
+
+	// only the end of the section needs to be looked up
+	CurrentElement = getElement(reader->getNodeName());
 }
 
 
@@ -487,43 +485,43 @@ void CColladaFileLoader::readColladaSection(io::IXMLReaderUTF8* reader)
 	Version = core::floor32(version)*10000+core::round32(core::fract(version)*1000.0f);
 	// Version 1.4 can be checked for by if (Version >= 10400)
 
-	while(reader->read())
+	while(readNext(reader))
 	if (reader->getNodeType() == io::EXN_ELEMENT)
 	{
-		if (assetSectionName == reader->getNodeName())
+		if (ECE_ASSET == CurrentElement)
 			readAssetSection(reader);
 		else
-		if (librarySectionName == reader->getNodeName())
+		if (ECE_LIBRARY == CurrentElement)
 			readLibrarySection(reader);
 		else
-		if (libraryNodesSectionName == reader->getNodeName())
+		if (ECE_LIBRARY_NODES == CurrentElement)
 			readLibrarySection(reader);
 		else
-		if (libraryGeometriesSectionName == reader->getNodeName())
+		if (ECE_LIBRARY_GEOMETRIES == CurrentElement)
 			readLibrarySection(reader);
 		else
-		if (libraryMaterialsSectionName == reader->getNodeName())
+		if (ECE_LIBRARY_MATERIALS == CurrentElement)
 			readLibrarySection(reader);
 		else
-		if (libraryEffectsSectionName == reader->getNodeName())
+		if (ECE_LIBRARY_EFFECTS == CurrentElement)
 			readLibrarySection(reader);
 		else
-		if (libraryImagesSectionName == reader->getNodeName())
+		if (ECE_LIBRARY_IMAGES == CurrentElement)
 			readLibrarySection(reader);
 		else
-		if (libraryCamerasSectionName == reader->getNodeName())
+		if (ECE_LIBRARY_CAMERAS == CurrentElement)
 			readLibrarySection(reader);
 		else
-		if (libraryLightsSectionName == reader->getNodeName())
+		if (ECE_LIBRARY_LIGHTS == CurrentElement)
 			readLibrarySection(reader);
 		else
-		if (libraryVisualScenesSectionName == reader->getNodeName())
+		if (ECE_LIBRARY_VISUAL_SCENES == CurrentElement)
 			readVisualScene(reader);
 		else
-		if (assetSectionName == reader->getNodeName())
+		if (ECE_ASSET == CurrentElement)
 			readAssetSection(reader);
 		else
-		if (sceneSectionName == reader->getNodeName())
+		if (ECE_SCENE == CurrentElement)
 			readSceneSection(reader);
 		else
 		{
@@ -544,40 +542,40 @@ void CColladaFileLoader::readLibrarySection(io::IXMLReaderUTF8* reader)
 	if (reader->isEmptyElement())
 		return;
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
 			// animation section tbd
-			if (cameraPrefabName == reader->getNodeName())
+			if (ECE_CAMERA == CurrentElement)
 				readCameraPrefab(reader);
 			else
 			// code section tbd
 			// controller section tbd
-			if (geometrySectionName == reader->getNodeName())
+			if (ECE_GEOMETRY == CurrentElement)
 				readGeometry(reader);
 			else
-			if (imageSectionName == reader->getNodeName())
+			if (ECE_IMAGE == CurrentElement)
 				readImage(reader);
 			else
-			if (lightPrefabName == reader->getNodeName())
+			if (ECE_LIGHT == CurrentElement)
 				readLightPrefab(reader);
 			else
-			if (materialSectionName == reader->getNodeName())
+			if (ECE_MATERIAL == CurrentElement)
 				readMaterial(reader);
 			else
-			if (nodeSectionName == reader->getNodeName())
+			if (ECE_NODE == CurrentElement)
 			{
 				CScenePrefab p("");
 
 				readNodeSection(reader, SceneManager->getRootSceneNode(), &p);
 			}
 			else
-			if (effectSectionName == reader->getNodeName())
+			if (ECE_EFFECT == CurrentElement)
 				readEffect(reader);
 			else
 			// program section tbd
-			if (textureSectionName == reader->getNodeName())
+			if (ECE_TEXTURE == CurrentElement)
 				readTexture(reader);
 			else
 				skipSection(reader, true); // unknown section, not all allowed supported yet
@@ -585,21 +583,21 @@ void CColladaFileLoader::readLibrarySection(io::IXMLReaderUTF8* reader)
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
-			if (librarySectionName == reader->getNodeName())
+			if (ECE_LIBRARY == CurrentElement)
 				break; // end reading.
-			if (libraryNodesSectionName == reader->getNodeName())
+			if (ECE_LIBRARY_NODES == CurrentElement)
 				break; // end reading.
-			if (libraryGeometriesSectionName == reader->getNodeName())
+			if (ECE_LIBRARY_GEOMETRIES == CurrentElement)
 				break; // end reading.
-			if (libraryMaterialsSectionName == reader->getNodeName())
+			if (ECE_LIBRARY_MATERIALS == CurrentElement)
 				break; // end reading.
-			if (libraryEffectsSectionName == reader->getNodeName())
+			if (ECE_LIBRARY_EFFECTS == CurrentElement)
 				break; // end reading.
-			if (libraryImagesSectionName == reader->getNodeName())
+			if (ECE_LIBRARY_IMAGES == CurrentElement)
 				break; // end reading.
-			if (libraryLightsSectionName == reader->getNodeName())
+			if (ECE_LIBRARY_LIGHTS == CurrentElement)
 				break; // end reading.
-			if (libraryCamerasSectionName == reader->getNodeName())
+			if (ECE_LIBRARY_CAMERAS == CurrentElement)
 				break; // end reading.
 		}
 	}
@@ -610,20 +608,20 @@ void CColladaFileLoader::readLibrarySection(io::IXMLReaderUTF8* reader)
 void CColladaFileLoader::readVisualScene(io::IXMLReaderUTF8* reader)
 {
 	CScenePrefab* p = 0;
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
-			if (visualSceneSectionName == reader->getNodeName())
+			if (ECE_VISUAL_SCENE == CurrentElement)
 				p = new CScenePrefab(readId(reader));
 			else
-			if (p && nodeSectionName == reader->getNodeName()) // as a child of visual_scene
+			if (p && ECE_NODE == CurrentElement) // as a child of visual_scene
 				readNodeSection(reader, SceneManager->getRootSceneNode(), p);
 			else
-			if (assetSectionName == reader->getNodeName())
+			if (ECE_ASSET == CurrentElement)
 				readAssetSection(reader);
 			else
-			if (extraNodeName == reader->getNodeName())
+			if (ECE_EXTRA == CurrentElement)
 				skipSection(reader, false); // ignore all other sections
 			else
 			{
@@ -634,10 +632,10 @@ void CColladaFileLoader::readVisualScene(io::IXMLReaderUTF8* reader)
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
-			if (libraryVisualScenesSectionName == reader->getNodeName())
+			if (ECE_LIBRARY_VISUAL_SCENES == CurrentElement)
 				return;
 			else
-			if ((visualSceneSectionName == reader->getNodeName()) && p)
+			if ((ECE_VISUAL_SCENE == CurrentElement) && p)
 			{
 				Prefabs.push_back(p);
 				p = 0;
@@ -662,32 +660,32 @@ void CColladaFileLoader::readSceneSection(io::IXMLReaderUTF8* reader)
 	core::matrix4 transform; // transformation of this node
 	scene::IDummyTransformationSceneNode* node = 0;
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
-			if (lookatNodeName == reader->getNodeName())
+			if (ECE_LOOKAT == CurrentElement)
 				transform *= readLookAtNode(reader);
 			else
-			if (matrixNodeName == reader->getNodeName())
+			if (ECE_MATRIX == CurrentElement)
 				transform *= readMatrixNode(reader);
 			else
-			if (perspectiveNodeName == reader->getNodeName())
+			if (ECE_PERSPECTIVE == CurrentElement)
 				transform *= readPerspectiveNode(reader);
 			else
-			if (rotateNodeName == reader->getNodeName())
+			if (ECE_ROTATE == CurrentElement)
 				transform *= readRotateNode(reader);
 			else
-			if (scaleNodeName == reader->getNodeName())
+			if (ECE_SCALE == CurrentElement)
 				transform *= readScaleNode(reader);
 			else
-			if (skewNodeName == reader->getNodeName())
+			if (ECE_SKEW == CurrentElement)
 				transform *= readSkewNode(reader);
 			else
-			if (translateNodeName == reader->getNodeName())
+			if (ECE_TRANSLATE == CurrentElement)
 				transform *= readTranslateNode(reader);
 			else
-			if (nodeSectionName == reader->getNodeName())
+			if (ECE_NODE == CurrentElement)
 			{
 				// create dummy node if there is none yet.
 				if (!node)
@@ -696,10 +694,10 @@ void CColladaFileLoader::readSceneSection(io::IXMLReaderUTF8* reader)
 				readNodeSection(reader, node);
 			}
 			else
-			if ((instanceSceneName == reader->getNodeName()))
-				readInstanceNode(reader, SceneManager->getRootSceneNode(), 0, 0,instanceSceneName);
+			if ((ECE_INSTANCE_VISUAL_SCENE == CurrentElement))
+				readInstanceNode(reader, SceneManager->getRootSceneNode(), 0, 0, ECE_INSTANCE_VISUAL_SCENE);
 			else
-			if (extraNodeName == reader->getNodeName())
+			if (ECE_EXTRA == CurrentElement)
 				skipSection(reader, false);
 			else
 			{
@@ -709,7 +707,7 @@ void CColladaFileLoader::readSceneSection(io::IXMLReaderUTF8* reader)
 		}
 		else
 		if ((reader->getNodeType() == io::EXN_ELEMENT_END) &&
-			(sceneSectionName == reader->getNodeName()))
+			(ECE_SCENE == CurrentElement))
 				return;
 	}
 	if (node)
@@ -727,19 +725,19 @@ void CColladaFileLoader::readAssetSection(io::IXMLReaderUTF8* reader)
 	if (reader->isEmptyElement())
 		return;
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
-			if (upAxisNodeName == reader->getNodeName())
+			if (ECE_UP_AXIS == CurrentElement)
 			{
-					reader->read();
+					readNext(reader);
 					FlipAxis = (core::stringc("Z_UP") == reader->getNodeData());
 			}
 		}
 		else
 		if ((reader->getNodeType() == io::EXN_ELEMENT_END) &&
-			(assetSectionName == reader->getNodeName()))
+			(ECE_ASSET == CurrentElement))
 				return;
 	}
 }
@@ -774,43 +772,43 @@ void CColladaFileLoader::readNodeSection(io::IXMLReaderUTF8* reader, scene::ISce
 
 	// read the node
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
-			if (assetSectionName == reader->getNodeName())
+			if (ECE_ASSET == CurrentElement)
 				readAssetSection(reader);
 			else
-			if (lookatNodeName == reader->getNodeName())
+			if (ECE_LOOKAT == CurrentElement)
 				transform *= readLookAtNode(reader);
 			else
-			if (matrixNodeName == reader->getNodeName())
+			if (ECE_MATRIX == CurrentElement)
 				transform *= readMatrixNode(reader);
 			else
-			if (perspectiveNodeName == reader->getNodeName())
+			if (ECE_PERSPECTIVE == CurrentElement)
 				transform *= readPerspectiveNode(reader);
 			else
-			if (rotateNodeName == reader->getNodeName())
+			if (ECE_ROTATE == CurrentElement)
 				transform *= readRotateNode(reader);
 			else
-			if (scaleNodeName == reader->getNodeName())
+			if (ECE_SCALE == CurrentElement)
 				transform *= readScaleNode(reader);
 			else
-			if (skewNodeName == reader->getNodeName())
+			if (ECE_SKEW == CurrentElement)
 				transform *= readSkewNode(reader);
 			else
-			if (translateNodeName == reader->getNodeName())
+			if (ECE_TRANSLATE == CurrentElement)
 				transform *= readTranslateNode(reader);
 			else
-			if ((instanceName == reader->getNodeName()) ||
-				(instanceNodeName == reader->getNodeName()) ||
-				(instanceGeometryName == reader->getNodeName()) ||
-				(instanceLightName == reader->getNodeName()) ||
-				(instanceCameraName == reader->getNodeName())
+			if ((ECE_INSTANCE == CurrentElement) ||
+				(ECE_INSTANCE_NODE == CurrentElement) ||
+				(ECE_INSTANCE_GEOMETRY == CurrentElement) ||
+				(ECE_INSTANCE_LIGHT == CurrentElement) ||
+				(ECE_INSTANCE_CAMERA == CurrentElement)
 				)
 			{
 				scene::ISceneNode* newnode = 0;
-				readInstanceNode(reader, parent, &newnode, nodeprefab, reader->getNodeName());
+				readInstanceNode(reader, parent, &newnode, nodeprefab, CurrentElement);
 
 				if (node && newnode)
 				{
@@ -825,7 +823,7 @@ void CColladaFileLoader::readNodeSection(io::IXMLReaderUTF8* reader, scene::ISce
 				}
 			}
 			else
-			if (nodeSectionName == reader->getNodeName())
+			if (ECE_NODE == CurrentElement)
 			{
 				// create dummy node if there is none yet.
 				if (CreateInstances && !node)
@@ -842,7 +840,7 @@ void CColladaFileLoader::readNodeSection(io::IXMLReaderUTF8* reader, scene::ISce
 				readNodeSection(reader, node, nodeprefab);
 			}
 			else
-			if (extraNodeName == reader->getNodeName())
+			if (ECE_EXTRA == CurrentElement)
 				skipSection(reader, false);
 			else
 				skipSection(reader, true); // ignore all other sections
@@ -851,7 +849,7 @@ void CColladaFileLoader::readNodeSection(io::IXMLReaderUTF8* reader, scene::ISce
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
-			if (nodeSectionName == reader->getNodeName())
+			if (ECE_NODE == CurrentElement)
 				break;
 		}
 	}
@@ -1091,7 +1089,7 @@ core::matrix4 CColladaFileLoader::readTranslateNode(io::IXMLReaderUTF8* reader)
 //! reads any kind of <instance*> node
 void CColladaFileLoader::readInstanceNode(io::IXMLReaderUTF8* reader,
 		scene::ISceneNode* parent, scene::ISceneNode** outNode,
-		CScenePrefab* p, const core::stringc& type)
+		CScenePrefab* p, ECOLLADA_ELEMENT type)
 {
 	// find prefab of the specified id
 	core::stringc url = reader->getAttributeValue("url");
@@ -1103,14 +1101,14 @@ void CColladaFileLoader::readInstanceNode(io::IXMLReaderUTF8* reader,
 
 	if (!reader->isEmptyElement())
 	{
-		while(reader->read())
+		while(readNext(reader))
 		{
 			if (reader->getNodeType() == io::EXN_ELEMENT)
 			{
-				if (bindMaterialName == reader->getNodeName())
+				if (ECE_BIND_MATERIAL == CurrentElement)
 					readBindMaterialSection(reader,url);
 				else
-				if (extraNodeName == reader->getNodeName())
+				if (ECE_EXTRA == CurrentElement)
 					skipSection(reader, false);
 			}
 			else
@@ -1124,7 +1122,7 @@ void CColladaFileLoader::readInstanceNode(io::IXMLReaderUTF8* reader,
 
 void CColladaFileLoader::instantiateNode(scene::ISceneNode* parent,
 		scene::ISceneNode** outNode, CScenePrefab* p, const core::stringc& url,
-		const core::stringc& type)
+		ECOLLADA_ELEMENT type)
 {
 	#ifdef COLLADA_READER_DEBUG
 	os::Printer::log("COLLADA instantiate node", ELL_DEBUG);
@@ -1153,7 +1151,7 @@ void CColladaFileLoader::instantiateNode(scene::ISceneNode* parent,
 	}
 	if (p)
 	{
-		if (instanceGeometryName==type)
+		if (ECE_INSTANCE_GEOMETRY == type)
 		{
 			Prefabs.push_back(new CGeometryPrefab(url));
 			p->Children.push_back(Prefabs.getLast());
@@ -1174,7 +1172,7 @@ void CColladaFileLoader::readCameraPrefab(io::IXMLReaderUTF8* reader)
 	if (!reader->isEmptyElement())
 	{
 		// read techniques optics and imager (the latter is completely ignored, though)
-		readColladaParameters(reader, cameraPrefabName);
+		readColladaParameters(reader, ECE_CAMERA);
 
 		SColladaParam* p;
 
@@ -1213,37 +1211,37 @@ void CColladaFileLoader::readImage(io::IXMLReaderUTF8* reader)
 
 	if (Version >= 10400) // start with 1.4
 	{
-		while(reader->read())
+		while(readNext(reader))
 		{
 			if (reader->getNodeType() == io::EXN_ELEMENT)
 			{
-				if (assetSectionName == reader->getNodeName())
+				if (ECE_ASSET == CurrentElement)
 					skipSection(reader, false);
 				else
-				if (initFromName == reader->getNodeName())
+				if (ECE_INIT_FROM == CurrentElement)
 				{
-					reader->read();
+					readNext(reader);
 					image.Source = reader->getNodeData();
 					image.Source.trim();
 					unescape(image.Source);
 					image.SourceIsFilename=true;
 				}
 				else
-				if (dataName == reader->getNodeName())
+				if (ECE_DATA == CurrentElement)
 				{
-					reader->read();
+					readNext(reader);
 					image.Source = reader->getNodeData();
 					image.Source.trim();
 					image.SourceIsFilename=false;
 				}
 				else
-				if (extraNodeName == reader->getNodeName())
+				if (ECE_EXTRA == CurrentElement)
 					skipSection(reader, false);
 			}
 			else
 			if (reader->getNodeType() == io::EXN_ELEMENT_END)
 			{
-				if (initFromName == reader->getNodeName())
+				if (ECE_INIT_FROM == CurrentElement)
 					return;
 			}
 		}
@@ -1271,7 +1269,7 @@ void CColladaFileLoader::readTexture(io::IXMLReaderUTF8* reader)
 
 	if (!reader->isEmptyElement())
 	{
-		readColladaInputs(reader, textureSectionName);
+		readColladaInputs(reader, ECE_TEXTURE);
 		SColladaInput* input = getColladaInput(ECIS_IMAGE);
 		if (input)
 		{
@@ -1296,27 +1294,27 @@ void CColladaFileLoader::readMaterial(io::IXMLReaderUTF8* reader)
 
 	if (Version >= 10400)
 	{
-		while(reader->read())
+		while(readNext(reader))
 		{
 			if (reader->getNodeType() == io::EXN_ELEMENT &&
-				instanceEffectName == reader->getNodeName())
+				ECE_INSTANCE_EFFECT == CurrentElement)
 			{
 				material.InstanceEffectId = reader->getAttributeValue("url");
 				uriToId(material.InstanceEffectId);
 			}
 			else
 			if (reader->getNodeType() == io::EXN_ELEMENT_END &&
-				materialSectionName == reader->getNodeName())
+				ECE_MATERIAL == CurrentElement)
 			{
 				break;
 			}
-		} // end while reader->read();
+		} // end while readNext(reader);
 	}
 	else
 	{
 		if (!reader->isEmptyElement())
 		{
-			readColladaInputs(reader, materialSectionName);
+			readColladaInputs(reader, ECE_MATERIAL);
 			SColladaInput* input = getColladaInput(ECIS_TEXTURE);
 			if (input)
 			{
@@ -1332,7 +1330,7 @@ void CColladaFileLoader::readMaterial(io::IXMLReaderUTF8* reader)
 
 			//does not work because the wrong start node is chosen due to reading of inputs before
 #if 0
-			readColladaParameters(reader, materialSectionName);
+			readColladaParameters(reader, ECE_MATERIAL);
 
 			SColladaParam* p;
 
@@ -1355,21 +1353,6 @@ void CColladaFileLoader::readMaterial(io::IXMLReaderUTF8* reader)
 
 void CColladaFileLoader::readEffect(io::IXMLReaderUTF8* reader, SColladaEffect * effect)
 {
-	static const core::stringc constantNode("constant");
-	static const core::stringc lambertNode("lambert");
-	static const core::stringc phongNode("phong");
-	static const core::stringc blinnNode("blinn");
-	static const core::stringc emissionNode("emission");
-	static const core::stringc ambientNode("ambient");
-	static const core::stringc diffuseNode("diffuse");
-	static const core::stringc specularNode("specular");
-	static const core::stringc shininessNode("shininess");
-	static const core::stringc reflectiveNode("reflective");
-	static const core::stringc reflectivityNode("reflectivity");
-	static const core::stringc transparentNode("transparent");
-	static const core::stringc transparencyNode("transparency");
-	static const core::stringc indexOfRefractionNode("index_of_refraction");
-
 	if (!effect)
 	{
 		Effects.push_back(SColladaEffect());
@@ -1383,65 +1366,65 @@ void CColladaFileLoader::readEffect(io::IXMLReaderUTF8* reader, SColladaEffect *
 		os::Printer::log("COLLADA reading effect", core::stringc(effect->Id), ELL_DEBUG);
 		#endif
 	}
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
 			// first come the tags we descend, but ignore the top-levels
-			if (!reader->isEmptyElement() && ((profileCOMMONSectionName == reader->getNodeName()) ||
-				(techniqueNodeName == reader->getNodeName())))
+			if (!reader->isEmptyElement() && ((ECE_PROFILE_COMMON == CurrentElement) ||
+				(ECE_TECHNIQUE == CurrentElement)))
 				readEffect(reader,effect);
 			else
-			if (newParamName == reader->getNodeName())
+			if (ECE_NEWPARAM == CurrentElement)
 				readParameter(reader, effect->Parameters);
 			else
 			// these are the actual materials inside technique
-			if (constantNode == reader->getNodeName() ||
-				lambertNode == reader->getNodeName() ||
-				phongNode == reader->getNodeName() ||
-				blinnNode == reader->getNodeName())
+			if (ECE_CONSTANT == CurrentElement ||
+				ECE_LAMBERT == CurrentElement ||
+				ECE_PHONG == CurrentElement ||
+				ECE_BLINN == CurrentElement)
 			{
 				#ifdef COLLADA_READER_DEBUG
 				os::Printer::log("COLLADA reading effect part", reader->getNodeName(), ELL_DEBUG);
 				#endif
 				effect->Mat.setFlag(irr::video::EMF_GOURAUD_SHADING,
-					phongNode == reader->getNodeName() ||
-					blinnNode == reader->getNodeName());
-				while(reader->read())
+					ECE_PHONG == CurrentElement ||
+					ECE_BLINN == CurrentElement);
+				while(readNext(reader))
 				{
 					if (reader->getNodeType() == io::EXN_ELEMENT)
 					{
-						const core::stringc node = reader->getNodeName();
-						if (emissionNode == node || ambientNode == node ||
-							diffuseNode == node || specularNode == node ||
-							reflectiveNode == node || transparentNode == node )
+						const ECOLLADA_ELEMENT node = CurrentElement;
+						if (ECE_EMISSION == node || ECE_AMBIENT == node ||
+							ECE_DIFFUSE == node || ECE_SPECULAR == node ||
+							ECE_REFLECTIVE == node || ECE_TRANSPARENT == node )
 						{
 							// color or texture types
-							while(reader->read())
+							while(readNext(reader))
 							{
 								if (reader->getNodeType() == io::EXN_ELEMENT &&
-									colorNodeName == reader->getNodeName())
+									ECE_COLOR == CurrentElement)
 								{
 									const video::SColorf colorf = readColorNode(reader);
 									const video::SColor color = colorf.toSColor();
-									if (emissionNode == node)
+									if (ECE_EMISSION == node)
 										effect->Mat.EmissiveColor = color;
 									else
-									if (ambientNode == node)
+									if (ECE_AMBIENT == node)
 										effect->Mat.AmbientColor = color;
 									else
-									if (diffuseNode == node)
+									if (ECE_DIFFUSE == node)
 										effect->Mat.DiffuseColor = color;
 									else
-									if (specularNode == node)
+									if (ECE_SPECULAR == node)
 										effect->Mat.SpecularColor = color;
 									else
-									if (transparentNode == node)
+									if (ECE_TRANSPARENT == node)
 										effect->Transparency = colorf.getAlpha();
 								}
 								else
 								if (reader->getNodeType() == io::EXN_ELEMENT &&
-									textureNodeName == reader->getNodeName())
+									ECE_TEXTURE == CurrentElement)
 								{
 									effect->Textures.push_back(reader->getAttributeValue("texture"));
 									break;
@@ -1451,25 +1434,25 @@ void CColladaFileLoader::readEffect(io::IXMLReaderUTF8* reader, SColladaEffect *
 									skipSection(reader, false);
 								else
 								if (reader->getNodeType() == io::EXN_ELEMENT_END &&
-									node == reader->getNodeName())
+									node == CurrentElement)
 									break;
 							}
 						}
 						else
-						if (shininessNode == node || reflectivityNode == node ||
-							transparencyNode == node || indexOfRefractionNode == node )
+						if (ECE_SHININESS == node || ECE_REFLECTIVITY == node ||
+							ECE_TRANSPARENCY == node || ECE_INDEX_OF_REFRACTION == node )
 						{
 							// float or param types
-							while(reader->read())
+							while(readNext(reader))
 							{
 								if (reader->getNodeType() == io::EXN_ELEMENT &&
-									floatNodeName == reader->getNodeName())
+									ECE_FLOAT == CurrentElement)
 								{
 									f32 f = readFloatNode(reader);
-									if (shininessNode == node)
+									if (ECE_SHININESS == node)
 										effect->Mat.Shininess = f;
 									else
-									if (transparencyNode == node)
+									if (ECE_TRANSPARENCY == node)
 										effect->Transparency *= f;
 								}
 								else
@@ -1477,7 +1460,7 @@ void CColladaFileLoader::readEffect(io::IXMLReaderUTF8* reader, SColladaEffect *
 									skipSection(reader, false);
 								else
 								if (reader->getNodeType() == io::EXN_ELEMENT_END &&
-									node == reader->getNodeName())
+									node == CurrentElement)
 									break;
 							}
 						}
@@ -1486,19 +1469,19 @@ void CColladaFileLoader::readEffect(io::IXMLReaderUTF8* reader, SColladaEffect *
 					}
 					else
 					if (reader->getNodeType() == io::EXN_ELEMENT_END && (
-						constantNode == reader->getNodeName() ||
-						lambertNode == reader->getNodeName() ||
-						phongNode == reader->getNodeName() ||
-						blinnNode == reader->getNodeName()
+						ECE_CONSTANT == CurrentElement ||
+						ECE_LAMBERT == CurrentElement ||
+						ECE_PHONG == CurrentElement ||
+						ECE_BLINN == CurrentElement
 						))
 						break;
 				}
 			}
 			else
-			if (!reader->isEmptyElement() && (extraNodeName == reader->getNodeName()))
+			if (!reader->isEmptyElement() && (ECE_EXTRA == CurrentElement))
 				readEffect(reader,effect);
 			else
-			if (doubleSidedNodeName == reader->getNodeName())
+			if (ECE_DOUBLE_SIDED == CurrentElement)
 			{
 				// read the GoogleEarth extra flag for double sided polys
 				s32 doubleSided = 0;
@@ -1518,16 +1501,16 @@ void CColladaFileLoader::readEffect(io::IXMLReaderUTF8* reader, SColladaEffect *
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
-			if (effectSectionName == reader->getNodeName())
+			if (ECE_EFFECT == CurrentElement)
 				break;
 			else
-			if (profileCOMMONSectionName == reader->getNodeName())
+			if (ECE_PROFILE_COMMON == CurrentElement)
 				break;
 			else
-			if (techniqueNodeName == reader->getNodeName())
+			if (ECE_TECHNIQUE == CurrentElement)
 				break;
 			else
-			if (extraNodeName == reader->getNodeName())
+			if (ECE_EXTRA == CurrentElement)
 				break;
 		}
 	}
@@ -1619,11 +1602,11 @@ void CColladaFileLoader::readBindMaterialSection(io::IXMLReaderUTF8* reader, con
 	os::Printer::log("COLLADA reading bind material", ELL_DEBUG);
 	#endif
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
-			if (instanceMaterialName == reader->getNodeName())
+			if (ECE_INSTANCE_MATERIAL == CurrentElement)
 			{
 				// the symbol to retarget, and the target material
 				core::stringc meshbufferReference = reader->getAttributeValue("symbol");
@@ -1674,7 +1657,7 @@ void CColladaFileLoader::readBindMaterialSection(io::IXMLReaderUTF8* reader, con
 		}
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END &&
-			bindMaterialName == reader->getNodeName())
+			ECE_BIND_MATERIAL == CurrentElement)
 			break;
 	}
 }
@@ -1697,17 +1680,16 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 	// handles geometry node and the mesh children in this loop
 	// read sources with arrays and accessor for each mesh
 	if (!reader->isEmptyElement())
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
-			const char* nodeName = reader->getNodeName();
-			if (meshSectionName == nodeName)
+			if (ECE_MESH == CurrentElement)
 			{
 				// inside a mesh section. Don't have to do anything here.
 			}
 			else
-			if (sourceSectionName == nodeName)
+			if (ECE_SOURCE == CurrentElement)
 			{
 				// create a new source
 				sources.push_back(SSource());
@@ -1718,7 +1700,7 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 				#endif
 			}
 			else
-			if (arraySectionName == nodeName || floatArraySectionName == nodeName || intArraySectionName == nodeName)
+			if (ECE_ARRAY == CurrentElement || ECE_FLOAT_ARRAY == CurrentElement || ECE_INT_ARRAY == CurrentElement)
 			{
 				// create a new array and read it.
 				if (!sources.empty())
@@ -1730,7 +1712,7 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 
 					// check if type of array is ok
 					const char* type = reader->getAttributeValue("type");
-					okToReadArray = (type && (!strcmp("float", type) || !strcmp("int", type))) || floatArraySectionName == nodeName || intArraySectionName == nodeName;
+					okToReadArray = (type && (!strcmp("float", type) || !strcmp("int", type))) || ECE_FLOAT_ARRAY == CurrentElement || ECE_INT_ARRAY == CurrentElement;
 
 					#ifdef COLLADA_READER_DEBUG
 					os::Printer::log("Read array", sources.getLast().Array.Name.c_str(), ELL_DEBUG);
@@ -1744,7 +1726,7 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 
 			}
 			else
-			if (accessorSectionName == nodeName) // child of source (below a technique tag)
+			if (ECE_ACCESSOR == CurrentElement) // child of source (below a technique tag)
 			{
 				#ifdef COLLADA_READER_DEBUG
 				os::Printer::log("Reading accessor", ELL_DEBUG);
@@ -1758,7 +1740,7 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 
 				// the accessor contains some information on how to access (boi!) the array,
 				// the info is stored in collada style parameters, so just read them.
-				readColladaParameters(reader, accessorSectionName);
+				readColladaParameters(reader, ECE_ACCESSOR);
 				if (!sources.empty())
 				{
 					sources.getLast().Accessors.push_back(accessor);
@@ -1766,26 +1748,26 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 				}
 			}
 			else
-			if (verticesSectionName == nodeName)
+			if (ECE_VERTICES == CurrentElement)
 			{
 				#ifdef COLLADA_READER_DEBUG
 				os::Printer::log("Reading vertices", ELL_DEBUG);
 				#endif
 				// read vertex input position source
-				readColladaInputs(reader, verticesSectionName);
+				readColladaInputs(reader, ECE_VERTICES);
 			}
 			else
 			// lines and linestrips missing
-			if (polygonsSectionName == nodeName ||
-				polylistSectionName == nodeName ||
-				trianglesSectionName == nodeName)
+			if (ECE_POLYGONS == CurrentElement ||
+				ECE_POLYLIST == CurrentElement ||
+				ECE_TRIANGLES == CurrentElement)
 			{
 				// read polygons section
 				readPolygonSection(reader, sources, mesh, id);
 			}
 			else
 			// trifans, and tristrips missing
-			if (doubleSidedNodeName == reader->getNodeName())
+			if (ECE_DOUBLE_SIDED == CurrentElement)
 			{
 				// read the extra flag for double sided polys
 				s32 doubleSided = 0;
@@ -1800,9 +1782,9 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 			}
 			else
 			 // techniqueCommon or 'technique profile=common' must not be skipped
-			if ((techniqueCommonSectionName != nodeName) // Collada 1.2/1.3
-				&& (techniqueNodeName != nodeName) // Collada 1.4+
-				&& (extraNodeName != nodeName))
+			if ((ECE_TECHNIQUE_COMMON != CurrentElement) // Collada 1.2/1.3
+				&& (ECE_TECHNIQUE != CurrentElement) // Collada 1.4+
+				&& (ECE_EXTRA != CurrentElement))
 			{
 				os::Printer::log("COLLADA loader warning: Wrong tag usage found in geometry", reader->getNodeName(), ELL_WARNING);
 				skipSection(reader, true); // ignore all other sections
@@ -1815,18 +1797,7 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 			if (okToReadArray && !sources.empty())
 			{
 				core::array<f32>& a = sources.getLast().Array.Data;
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
-
-				for (u32 i=0; i<a.size(); ++i)
-				{
-					findNextNoneWhiteSpace(&p);
-					if (*p)
-						a[i] = readFloat(&p);
-					else
-						a[i] = 0.0f;
-				}
+				readFloats(reader->getNodeData(), a.pointer(), a.size());
 			} // end reading array
 
 			okToReadArray = false;
@@ -1835,13 +1806,13 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
-			if (geometrySectionName == reader->getNodeName())
+			if (ECE_GEOMETRY == CurrentElement)
 			{
 				// end of geometry section reached, cancel out
 				break;
 			}
 		}
-	} // end while reader->read();
+	} // end while readNext(reader);
 
 	// add mesh as geometry
 
@@ -1912,10 +1883,10 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 
 	core::stringc materialName = reader->getAttributeValue("material");
 
-	core::stringc polygonType = reader->getNodeName();
+	const ECOLLADA_ELEMENT polygonType = CurrentElement;
 	const int polygonCount = reader->getAttributeValueAsInt("count"); // Not useful because it only determines the number of primitives, which have arbitrary vertices in case of polygon
 	core::array<SPolygon> polygons;
-	if (polygonType == polygonsSectionName)
+	if (polygonType == ECE_POLYGONS)
 		polygons.reallocate(polygonCount);
 	core::array<int> vCounts;
 	bool parsePolygonOK = false;
@@ -1926,14 +1897,12 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 
 	// read all <input> and primitives
 	if (!reader->isEmptyElement())
-	while(reader->read())
+	while(readNext(reader))
 	{
-		const char* nodeName = reader->getNodeName();
-
 		if (reader->getNodeType() == io::EXN_ELEMENT)
 		{
 			// polygon node may contain params
-			if (inputTagName == nodeName)
+			if (ECE_INPUT == CurrentElement)
 			{
 				// read input tag
 				readColladaInput(reader, localInputs);
@@ -1959,13 +1928,13 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 				++inputSemanticCount;
 			}
 			else
-			if (primitivesName == nodeName)
+			if (ECE_P == CurrentElement)
 			{
 				parsePolygonOK = true;
 				polygons.push_back(SPolygon());
 			}
 			else
-			if (vcountName == nodeName)
+			if (ECE_VCOUNT == CurrentElement)
 			{
 				parseVcountOK = true;
 			} // end  is polygon node
@@ -1973,13 +1942,13 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
-			if (primitivesName == nodeName)
+			if (ECE_P == CurrentElement)
 				parsePolygonOK = false; // end parsing a polygon
 			else
-			if (vcountName == nodeName)
+			if (ECE_VCOUNT == CurrentElement)
 				parseVcountOK = false; // end parsing vcounts
 			else
-			if (polygonType == nodeName)
+			if (polygonType == CurrentElement)
 				break; // cancel out and create mesh
 
 		} // end is element end
@@ -1988,71 +1957,46 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 		{
 			if (parseVcountOK)
 			{
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
-				while(*p)
-				{
-					findNextNoneWhiteSpace(&p);
-					if (*p)
-						vCounts.push_back(readInt(&p));
-				}
+				readIntList(reader->getNodeData(), vCounts);
 				parseVcountOK = false;
 			}
 			else
 			if (parsePolygonOK && polygons.size())
 			{
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
 				SPolygon& poly = polygons.getLast();
-				if (polygonType == polygonsSectionName)
+				if (polygonType == ECE_POLYGONS)
 					poly.Indices.reallocate((maxOffset+1)*3);
 				else
 					poly.Indices.reallocate(polygonCount*(maxOffset+1)*3);
 
 				if (vCounts.empty())
-				{
-					while(*p)
-					{
-						findNextNoneWhiteSpace(&p);
-						poly.Indices.push_back(readInt(&p));
-					}
-				}
+					readIntList(reader->getNodeData(), poly.Indices);
 				else
 				{
-					for (u32 i = 0; i < vCounts.size(); i++)
+					core::array<s32> corners;
+					readIntList(reader->getNodeData(), corners);
+
+					u32 first = 0;
+					for (u32 i = 0; i < vCounts.size() && inputSemanticCount; i++)
 					{
-						const int polyVCount = vCounts[i];
-						core::array<int> polyCorners;
+						const u32 size = core::min_((u32)vCounts[i] * inputSemanticCount, corners.size() - first);
 
-						for (u32 j = 0; j < polyVCount * inputSemanticCount; j++)
+						// add the polygon as a fan of triangles around its first corner
+						for (u32 k = 2 * inputSemanticCount; k + inputSemanticCount <= size; k += inputSemanticCount)
 						{
-							if (!*p)
-								break;
-							findNextNoneWhiteSpace(&p);
-							polyCorners.push_back(readInt(&p));
+							for (u32 j = 0; j < inputSemanticCount; ++j)
+								poly.Indices.push_back(corners[first + j]);
+							for (u32 j = 0; j < 2 * inputSemanticCount; ++j)
+								poly.Indices.push_back(corners[first + k - inputSemanticCount + j]);
 						}
-
-						while (polyCorners.size() >= 3 * inputSemanticCount)
-						{
-							// add one triangle's worth of indices
-							for (u32 k = 0; k < inputSemanticCount * 3; ++k)
-							{
-								poly.Indices.push_back(polyCorners[k]);
-							}
-
-							// remove one corner from our poly
-							polyCorners.erase(inputSemanticCount,inputSemanticCount);
-						}
-						polyCorners.clear();
+						first += size;
 					}
 					vCounts.clear();
 				}
 				parsePolygonOK = false;
 			}
 		}
-	} // end while reader->read()
+	} // end while readNext(reader)
 
 	// find source array (we'll ignore accessors for this implementation)
 	for (u32 i=0; i<localInputs.size(); ++i)
@@ -2213,7 +2157,7 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 				}
 			} // end for all vertices
 
-			if (polygonsSectionName == polygonType &&
+			if (ECE_POLYGONS == polygonType &&
 				indices.size() > 3)
 			{
 				// need to tessellate for polygons of 4 or more vertices
@@ -2387,57 +2331,57 @@ void CColladaFileLoader::readLightPrefab(io::IXMLReaderUTF8* reader)
 	{
 		if (Version >= 10400) // start with 1.4
 		{
-			while(reader->read())
+			while(readNext(reader))
 			{
 				if (reader->getNodeType() == io::EXN_ELEMENT)
 				{
-					if (pointSectionName == reader->getNodeName())
+					if (ECE_POINT == CurrentElement)
 						prefab->LightData.Type=video::ELT_POINT;
 					else
-					if (directionalSectionName == reader->getNodeName())
+					if (ECE_DIRECTIONAL == CurrentElement)
 						prefab->LightData.Type=video::ELT_DIRECTIONAL;
 					else
-					if (spotSectionName == reader->getNodeName())
+					if (ECE_SPOT == CurrentElement)
 						prefab->LightData.Type=video::ELT_SPOT;
 					else
-					if (ambientSectionName == reader->getNodeName())
+					if (ECE_AMBIENT == CurrentElement)
 						prefab->LightData.Type=ELT_AMBIENT;
 					else
-					if (colorNodeName == reader->getNodeName())
+					if (ECE_COLOR == CurrentElement)
 						prefab->LightData.DiffuseColor=readColorNode(reader);
 					else
-					if (constantAttenuationNodeName == reader->getNodeName())
+					if (ECE_CONSTANT_ATTENUATION == CurrentElement)
 						readFloatsInsideElement(reader,&prefab->LightData.Attenuation.X,1);
 					else
-					if (linearAttenuationNodeName == reader->getNodeName())
+					if (ECE_LINEAR_ATTENUATION == CurrentElement)
 						readFloatsInsideElement(reader,&prefab->LightData.Attenuation.Y,1);
 					else
-					if (quadraticAttenuationNodeName == reader->getNodeName())
+					if (ECE_QUADRATIC_ATTENUATION == CurrentElement)
 						readFloatsInsideElement(reader,&prefab->LightData.Attenuation.Z,1);
 					else
-					if (falloffAngleNodeName == reader->getNodeName())
+					if (ECE_FALLOFF_ANGLE == CurrentElement)
 					{
 						readFloatsInsideElement(reader,&prefab->LightData.OuterCone,1);
 						prefab->LightData.OuterCone *= core::DEGTORAD;
 					}
 					else
-					if (falloffExponentNodeName == reader->getNodeName())
+					if (ECE_FALLOFF_EXPONENT == CurrentElement)
 						readFloatsInsideElement(reader,&prefab->LightData.Falloff,1);
 				}
 				else
 				if (reader->getNodeType() == io::EXN_ELEMENT_END)
 				{
-					if ((pointSectionName == reader->getNodeName()) ||
-						(directionalSectionName == reader->getNodeName()) ||
-						(spotSectionName == reader->getNodeName()) ||
-						(ambientSectionName == reader->getNodeName()))
+					if ((ECE_POINT == CurrentElement) ||
+						(ECE_DIRECTIONAL == CurrentElement) ||
+						(ECE_SPOT == CurrentElement) ||
+						(ECE_AMBIENT == CurrentElement))
 						break;
 				}
 			}
 		}
 		else
 		{
-			readColladaParameters(reader, lightPrefabName);
+			readColladaParameters(reader, ECE_LIGHT);
 
 			SColladaParam* p = getColladaParameter(ECPN_COLOR);
 			if (p && p->Type == ECPT_FLOAT3)
@@ -2500,30 +2444,30 @@ void CColladaFileLoader::readColladaInput(io::IXMLReaderUTF8* reader, core::arra
 }
 
 //! parses all collada inputs inside an element and stores them in Inputs
-void CColladaFileLoader::readColladaInputs(io::IXMLReaderUTF8* reader, const core::stringc& parentName)
+void CColladaFileLoader::readColladaInputs(io::IXMLReaderUTF8* reader, ECOLLADA_ELEMENT parent)
 {
 	Inputs.clear();
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		if (reader->getNodeType() == io::EXN_ELEMENT &&
-			inputTagName == reader->getNodeName())
+			ECE_INPUT == CurrentElement)
 		{
 			readColladaInput(reader, Inputs);
 		}
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
-			if (parentName == reader->getNodeName())
+			if (parent == CurrentElement)
 				return; // end of parent reached
 		}
 
-	} // end while reader->read();
+	} // end while readNext(reader);
 }
 
 //! parses all collada parameters inside an element and stores them in ColladaParameters
 void CColladaFileLoader::readColladaParameters(io::IXMLReaderUTF8* reader,
-		const core::stringc& parentName)
+		ECOLLADA_ELEMENT parent)
 {
 	ColladaParameters.clear();
 
@@ -2532,11 +2476,10 @@ void CColladaFileLoader::readColladaParameters(io::IXMLReaderUTF8* reader,
 
 	const char* const typeNames[] = {"float", "float2", "float3", 0};
 
-	while(reader->read())
+	while(readNext(reader))
 	{
-		const char* nodeName = reader->getNodeName();
 		if (reader->getNodeType() == io::EXN_ELEMENT &&
-			paramTagName == nodeName)
+			ECE_PARAM == CurrentElement)
 		{
 			// parse param
 			SColladaParam p;
@@ -2581,11 +2524,11 @@ void CColladaFileLoader::readColladaParameters(io::IXMLReaderUTF8* reader,
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
-			if (parentName == reader->getNodeName())
+			if (parent == CurrentElement)
 				return; // end of parent reached
 		}
 
-	} // end while reader->read();
+	} // end while readNext(reader);
 }
 
 
@@ -2603,7 +2546,15 @@ inline f32 CColladaFileLoader::readFloat(const c8** p)
 //! the end of the parsed float
 inline s32 CColladaFileLoader::readInt(const c8** p)
 {
-	return (s32)readFloat(p);
+	const c8* end;
+	const s32 i = core::strtol10(*p, &end);
+
+	// some exporters write ints like floats
+	if (*end && *end!=' ' && *end!='\n' && *end!='\r' && *end!='\t')
+		return (s32)readFloat(p);
+
+	*p = end;
+	return i;
 }
 
 
@@ -2621,33 +2572,69 @@ void CColladaFileLoader::findNextNoneWhiteSpace(const c8** start)
 }
 
 
+//! parses up to count floats from the text, the missing ones are set to 0
+void CColladaFileLoader::readFloats(const c8* p, f32* floats, u32 count)
+{
+	u32 i=0;
+	for (; i<count; ++i)
+	{
+		findNextNoneWhiteSpace(&p);
+		if (!*p)
+			break;
+		floats[i] = readFloat(&p);
+	}
+	for (; i<count; ++i)
+		floats[i] = 0.0f;
+}
+
+
+//! parses up to count ints from the text, the missing ones are set to 0
+void CColladaFileLoader::readInts(const c8* p, s32* ints, u32 count)
+{
+	u32 i=0;
+	for (; i<count; ++i)
+	{
+		findNextNoneWhiteSpace(&p);
+		if (!*p)
+			break;
+		ints[i] = readInt(&p);
+	}
+	for (; i<count; ++i)
+		ints[i] = 0;
+}
+
+
+//! parses all ints of the text and adds them to the array
+void CColladaFileLoader::readIntList(const c8* p, core::array<s32>& ints)
+{
+	for (;;)
+	{
+		findNextNoneWhiteSpace(&p);
+		if (!*p)
+			break;
+
+		const c8* start = p;
+		const s32 i = readInt(&p);
+		if (p == start)
+			break; // not a number
+		ints.push_back(i);
+	}
+}
+
+
 //! reads floats from inside of xml element until end of xml element
 void CColladaFileLoader::readFloatsInsideElement(io::IXMLReaderUTF8* reader, f32* floats, u32 count)
 {
 	if (reader->isEmptyElement())
 		return;
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		// TODO: check for comments inside the element
 		// and ignore them.
 
 		if (reader->getNodeType() == io::EXN_TEXT)
-		{
-			// parse float data
-			core::stringc data = reader->getNodeData();
-			data.trim();
-			const c8* p = &data[0];
-
-			for (u32 i=0; i<count; ++i)
-			{
-				findNextNoneWhiteSpace(&p);
-				if (*p)
-					floats[i] = readFloat(&p);
-				else
-					floats[i] = 0.0f;
-			}
-		}
+			readFloats(reader->getNodeData(), floats, count);
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 			break; // end parsing text
@@ -2661,27 +2648,13 @@ void CColladaFileLoader::readIntsInsideElement(io::IXMLReaderUTF8* reader, s32*
 	if (reader->isEmptyElement())
 		return;
 
-	while(reader->read())
+	while(readNext(reader))
 	{
 		// TODO: check for comments inside the element
 		// and ignore them.
 
 		if (reader->getNodeType() == io::EXN_TEXT)
-		{
-			// parse float data
-			core::stringc data = reader->getNodeData();
-			data.trim();
-			const c8* p = &data[0];
-
-			for (u32 i=0; i<count; ++i)
-			{
-				findNextNoneWhiteSpace(&p);
-				if (*p)
-					ints[i] = readInt(&p);
-				else
-					ints[i] = 0;
-			}
-		}
+			readInts(reader->getNodeData(), ints, count);
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 			break; // end parsing text
@@ -2692,7 +2665,7 @@ void CColladaFileLoader::readIntsInsideElement(io::IXMLReaderUTF8* reader, s32*
 video::SColorf CColladaFileLoader::readColorNode(io::IXMLReaderUTF8* reader)
 {
 	if (reader->getNodeType() == io::EXN_ELEMENT &&
-		colorNodeName == reader->getNodeName())
+		ECE_COLOR == CurrentElement)
 	{
 		f32 color[4];
 		readFloatsInsideElement(reader,color,4);
@@ -2711,7 +2684,7 @@ f32 CColladaFileLoader::readFloatNode(io::IXMLReaderUTF8* reader)
 
 	f32 result = 0.0f;
 	if (reader->getNodeType() == io::EXN_ELEMENT &&
-		floatNodeName == reader->getNodeName())
+		ECE_FLOAT == CurrentElement)
 	{
 		readFloatsInsideElement(reader,&result,1);
 	}
@@ -2846,40 +2819,40 @@ void CColladaFileLoader::readParameter(io::IXMLReaderUTF8* reader, io::IAttribut
 	const core::stringc name = reader->getAttributeValue("sid");
 	if (!reader->isEmptyElement())
 	{
-		while(reader->read())
+		while(readNext(reader))
 		{
 			if (reader->getNodeType() == io::EXN_ELEMENT)
 			{
-				if (floatNodeName == reader->getNodeName())
+				if (ECE_FLOAT == CurrentElement)
 				{
 					const f32 f = readFloatNode(reader);
 					parameters->addFloat(name.c_str(), f);
 				}
 				else
-				if (float2NodeName == reader->getNodeName())
+				if (ECE_FLOAT2 == CurrentElement)
 				{
 					f32 f[2];
 					readFloatsInsideElement(reader, f, 2);
 //						Parameters.addVector2d(name.c_str(), core::vector2df(f[0],f[1]));
 				}
 				else
-				if (float3NodeName == reader->getNodeName())
+				if (ECE_FLOAT3 == CurrentElement)
 				{
 					f32 f[3];
 					readFloatsInsideElement(reader, f, 3);
 					parameters->addVector3d(name.c_str(), core::vector3df(f[0],f[1],f[2]));
 				}
 				else
-				if ((initFromName == reader->getNodeName()) ||
-					(sourceSectionName == reader->getNodeName()))
+				if ((ECE_INIT_FROM == CurrentElement) ||
+					(ECE_SOURCE == CurrentElement))
 				{
-					reader->read();
+					readNext(reader);
 					parameters->addString(name.c_str(), reader->getNodeData());
 				}
 				else
-				if (wrapsName == reader->getNodeName())
+				if (ECE_WRAP_S == CurrentElement)
 				{
-					reader->read();
+					readNext(reader);
 					const core::stringc val = reader->getNodeData();
 					if (val == "WRAP")
 						parameters->addInt(wrapsName.c_str(), (int)video::ETC_REPEAT);
@@ -2893,9 +2866,9 @@ void CColladaFileLoader::readParameter(io::IXMLReaderUTF8* reader, io::IAttribut
 						parameters->addInt(wrapsName.c_str(), (int)video::ETC_CLAMP_TO_BORDER);
 				}
 				else
-				if (wraptName == reader->getNodeName())
+				if (ECE_WRAP_T == CurrentElement)
 				{
-					reader->read();
+					readNext(reader);
 					const core::stringc val = reader->getNodeData();
 					if (val == "WRAP")
 						parameters->addInt(wraptName.c_str(), (int)video::ETC_REPEAT);
@@ -2909,9 +2882,9 @@ void CColladaFileLoader::readParameter(io::IXMLReaderUTF8* reader, io::IAttribut
 						parameters->addInt(wraptName.c_str(), (int)video::ETC_CLAMP_TO_BORDER);
 				}
 				else
-				if (minfilterName == reader->getNodeName())
+				if (ECE_MINFILTER == CurrentElement)
 				{
-					reader->read();
+					readNext(reader);
 					const core::stringc val = reader->getNodeData();
 					if (val == "LINEAR_MIPMAP_LINEAR")
 						parameters->addBool("trilinear", true);
@@ -2920,9 +2893,9 @@ void CColladaFileLoader::readParameter(io::IXMLReaderUTF8* reader, io::IAttribut
 						parameters->addBool("bilinear", true);
 				}
 				else
-				if (magfilterName == reader->getNodeName())
+				if (ECE_MAGFILTER == CurrentElement)
 				{
-					reader->read();
+					readNext(reader);
 					const core::stringc val = reader->getNodeData();
 					if (val != "LINEAR")
 					{
@@ -2931,7 +2904,7 @@ void CColladaFileLoader::readParameter(io::IXMLReaderUTF8* reader, io::IAttribut
 					}
 				}
 				else
-				if (mipfilterName == reader->getNodeName())
+				if (ECE_MIPFILTER == CurrentElement)
 				{
 					parameters->addBool("anisotropic", true);
 				}
@@ -2939,7 +2912,7 @@ void CColladaFileLoader::readParameter(io::IXMLReaderUTF8* reader, io::IAttribut
 			else
 			if(reader->getNodeType() == io::EXN_ELEMENT_END)
 			{
-				if (newParamName == reader->getNodeName())
+				if (ECE_NEWPARAM == CurrentElement)
 					break;
 			}
 		}
@@ -26,6 +26,108 @@ namespace scene
 
 class IColladaPrefab;
 
+//! Elements of Collada files which are read by the loader
+enum ECOLLADA_ELEMENT
+{
+	ECE_COLLADA = 0,
+	ECE_LIBRARY,
+	ECE_LIBRARY_NODES,
+	ECE_LIBRARY_GEOMETRIES,
+	ECE_LIBRARY_MATERIALS,
+	ECE_LIBRARY_IMAGES,
+	ECE_LIBRARY_VISUAL_SCENES,
+	ECE_LIBRARY_CAMERAS,
+	ECE_LIBRARY_LIGHTS,
+	ECE_LIBRARY_EFFECTS,
+	ECE_ASSET,
+	ECE_SCENE,
+	ECE_VISUAL_SCENE,
+	ECE_LIGHT,
+	ECE_CAMERA,
+	ECE_MATERIAL,
+	ECE_GEOMETRY,
+	ECE_IMAGE,
+	ECE_TEXTURE,
+	ECE_EFFECT,
+	ECE_POINT,
+	ECE_DIRECTIONAL,
+	ECE_SPOT,
+	ECE_AMBIENT,
+	ECE_MESH,
+	ECE_SOURCE,
+	ECE_ARRAY,
+	ECE_FLOAT_ARRAY,
+	ECE_INT_ARRAY,
+	ECE_TECHNIQUE_COMMON,
+	ECE_ACCESSOR,
+	ECE_VERTICES,
+	ECE_INPUT,
+	ECE_POLYLIST,
+	ECE_TRIANGLES,
+	ECE_POLYGONS,
+	ECE_P,
+	ECE_VCOUNT,
+	ECE_UP_AXIS,
+	ECE_NODE,
+	ECE_LOOKAT,
+	ECE_MATRIX,
+	ECE_PERSPECTIVE,
+	ECE_ROTATE,
+	ECE_SCALE,
+	ECE_TRANSLATE,
+	ECE_SKEW,
+	ECE_MIN,
+	ECE_MAX,
+	ECE_INSTANCE,
+	ECE_INSTANCE_GEOMETRY,
+	ECE_INSTANCE_VISUAL_SCENE,
+	ECE_INSTANCE_EFFECT,
+	ECE_INSTANCE_MATERIAL,
+	ECE_INSTANCE_LIGHT,
+	ECE_INSTANCE_NODE,
+	ECE_INSTANCE_CAMERA,
+	ECE_BIND_MATERIAL,
+	ECE_EXTRA,
+	ECE_TECHNIQUE,
+	ECE_COLOR,
+	ECE_FLOAT,
+	ECE_FLOAT2,
+	ECE_FLOAT3,
+	ECE_NEWPARAM,
+	ECE_PARAM,
+	ECE_INIT_FROM,
+	ECE_DATA,
+	ECE_WRAP_S,
+	ECE_WRAP_T,
+	ECE_WRAP_R,
+	ECE_WRAP_P,
+	ECE_MINFILTER,
+	ECE_MAGFILTER,
+	ECE_MIPFILTER,
+	ECE_DOUBLE_SIDED,
+	ECE_CONSTANT_ATTENUATION,
+	ECE_LINEAR_ATTENUATION,
+	ECE_QUADRATIC_ATTENUATION,
+	ECE_FALLOFF_ANGLE,
+	ECE_FALLOFF_EXPONENT,
+	ECE_PROFILE_COMMON,
+	ECE_CONSTANT,
+	ECE_LAMBERT,
+	ECE_PHONG,
+	ECE_BLINN,
+	ECE_EMISSION,
+	ECE_DIFFUSE,
+	ECE_SPECULAR,
+	ECE_SHININESS,
+	ECE_REFLECTIVE,
+	ECE_REFLECTIVITY,
+	ECE_TRANSPARENT,
+	ECE_TRANSPARENCY,
+	ECE_INDEX_OF_REFRACTION,
+
+	ECE_COUNT
+};
+
 enum ECOLLADA_PARAM_NAME
 {
 	ECPN_COLOR = 0,
@@ -198,6 +300,12 @@ public:
 
 private:
 
+	//! returns the element with the given name, or ECE_COUNT if it is not read by this loader
+	ECOLLADA_ELEMENT getElement(const c8* name) const;
+
+	//! reads the next node and sets CurrentElement to its element
+	bool readNext(io::IXMLReaderUTF8* reader);
+
 	//! skips an (unknown) section in the collada document
 	void skipSection(io::IXMLReaderUTF8* reader, bool reportSkipping);
 
@@ -253,12 +361,12 @@ private:
 	//! reads a <instance> node
 	void readInstanceNode(io::IXMLReaderUTF8* reader,
 			scene::ISceneNode* parent, scene::ISceneNode** outNode,
-			CScenePrefab* p=0, const core::stringc& type=core::stringc());
+			CScenePrefab* p=0, ECOLLADA_ELEMENT type=ECE_COUNT);
 
 	//! creates a scene node from Prefabs (with name given in 'url')
 	void instantiateNode(scene::ISceneNode* parent, scene::ISceneNode** outNode=0,
 			CScenePrefab* p=0, const core::stringc& url="",
-			const core::stringc& type=core::stringc());
+			ECOLLADA_ELEMENT type=ECE_COUNT);
 
 	//! reads a <light> element and stores it as prefab
 	void readLightPrefab(io::IXMLReaderUTF8* reader);
@@ -292,6 +400,15 @@ private:
 	//! places pointer to next begin of a token
 	void findNextNoneWhiteSpace(const c8** p);
 
+	//! parses up to count floats from the text, the missing ones are set to 0
+	void readFloats(const c8* p, f32* floats, u32 count);
+
+	//! parses up to count ints from the text, the missing ones are set to 0
+	void readInts(const c8* p, s32* ints, u32 count);
+
+	//! parses all ints of the text and adds them to the array
+	void readIntList(const c8* p, core::array<s32>& ints);
+
 	//! reads floats from inside of xml element until end of xml element
 	void readFloatsInsideElement(io::IXMLReaderUTF8* reader, f32* floats, u32 count);
 
@@ -302,14 +419,14 @@ private:
 	void clearData();
 
 	//! parses all collada parameters inside an element and stores them in ColladaParameters
-	void readColladaParameters(io::IXMLReaderUTF8* reader, const core::stringc& parentName);
+	void readColladaParameters(io::IXMLReaderUTF8* reader, ECOLLADA_ELEMENT parent);
 
 	//! returns a collada parameter or none if not found
 	SColladaParam* getColladaParameter(ECOLLADA_PARAM_NAME name);
 
 	//! parses all collada inputs inside an element and stores them in Inputs. Reads
 	//! until first tag which is not an input tag or the end of the parent is reached
-	void readColladaInputs(io::IXMLReaderUTF8* reader, const core::stringc& parentName);
+	void readColladaInputs(io::IXMLReaderUTF8* reader, ECOLLADA_ELEMENT parent);
 
 	//! reads a collada input tag and adds it to the input parameter
 	void readColladaInput(io::IXMLReaderUTF8* reader, core::array<SColladaInput>& inputs);
@@ -359,6 +476,12 @@ private:
 	u32 Version;
 	bool FlipAxis;
 
+	//! element of the current node, ECE_COUNT for unknown elements and other nodes
+	ECOLLADA_ELEMENT CurrentElement;
+	//! perfect hash table from element names to elements, see getElement
+	u8 ElementTable[1024];
+	u32 ElementSeed;
+
 	core::array<IColladaPrefab*> Prefabs;
 	core::array<SColladaParam> ColladaParameters;
 	core::array<SColladaImage> Images;
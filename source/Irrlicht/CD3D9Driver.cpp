@@ -17,6 +17,8 @@
 #include "CD3D9ParallaxMapRenderer.h"
 #include "CD3D9HLSLMaterialRenderer.h"
 #include "SIrrCreationParameters.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 template<typename T, typename T2>
 inline T function_cast(T2 ptr) {
@@ -991,6 +993,7 @@ bool CD3D9Driver::updateVertexHardwareBuffer(SHWBufferLink_d3d9 *hwBuffer)
 		return false;
 
 	const scene::IMeshBuffer* mb = hwBuffer->MeshBuffer;
+	IRR_PROFILE(getProfiler().addToCounter(EPC_BUFFER_UPLOADS, 1);)
 	const void* vertices=mb->getVertices();
 	const u32 vertexCount=mb->getVertexCount();
 	const E_VERTEX_TYPE vType=mb->getVertexType();
@@ -1057,6 +1060,7 @@ bool CD3D9Driver::updateIndexHardwareBuffer(SHWBufferLink_d3d9 *hwBuffer)
 		return false;
 
 	const scene::IMeshBuffer* mb = hwBuffer->MeshBuffer;
+	IRR_PROFILE(getProfiler().addToCounter(EPC_BUFFER_UPLOADS, 1);)
 	const u16* indices=mb->getIndices();
 	const u32 indexCount=mb->getIndexCount();
 	u32 indexSize = 2;
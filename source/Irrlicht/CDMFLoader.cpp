@@ -30,6 +30,8 @@
 #include "irrString.h"
 #include "irrMath.h"
 #include "dmfsupport.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -67,6 +69,7 @@ void CDMFLoader::addMaterialPath(core::stringc& filename, const core::stringc& m
  See IReferenceCounted::drop() for more information.*/
 IAnimatedMesh* CDMFLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_DMF);)
 	if (!file)
 		return 0;
 
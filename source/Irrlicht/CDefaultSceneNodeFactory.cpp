@@ -53,6 +53,7 @@ CDefaultSceneNodeFactory::CDefaultSceneNodeFactory(ISceneManager* mgr)
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_ANIMATED_MESH, "animatedMesh"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_PARTICLE_SYSTEM, "particleSystem"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_VOLUME_LIGHT, "volumeLight"));
+	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_Q3_LEVEL, "q3Level"));
 	// SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_MD3_SCENE_NODE, "md3"));
 
 	// legacy, for version <= 1.4.x irr files
@@ -116,6 +117,8 @@ ISceneNode* CDefaultSceneNodeFactory::addSceneNode(ESCENE_NODE_TYPE type, IScene
 		return Manager->addParticleSystemSceneNode(true, parent);
 	case ESNT_VOLUME_LIGHT:
 		return (ISceneNode*)Manager->addVolumeLightSceneNode(parent);
+	case ESNT_Q3_LEVEL:
+		return Manager->addQuake3LevelSceneNode(0, parent);
 	default:
 		break;
 	}
@@ -45,6 +45,14 @@ core::matrix4 CDummyTransformationSceneNode::getRelativeTransformation() const
 	return RelativeTransformationMatrix;
 }
 
+//! Updates the absolute position, always as the matrix may have changed
+void CDummyTransformationSceneNode::updateAbsolutePosition()
+{
+	// the matrix is changed through the reference of getRelativeTransformationMatrix
+	RelativeTransformationChanged = true;
+	IDummyTransformationSceneNode::updateAbsolutePosition();
+}
+
 //! Creates a clone of this scene node and its children.
 ISceneNode* CDummyTransformationSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
 {
@@ -30,6 +30,9 @@ namespace scene
 		//! Returns the relative transformation of the scene node.
 		virtual core::matrix4 getRelativeTransformation() const _IRR_OVERRIDE_;
 
+		//! Updates the absolute position, always as the matrix may have changed
+		virtual void updateAbsolutePosition() _IRR_OVERRIDE_;
+
 		//! does nothing.
 		virtual void render() _IRR_OVERRIDE_ {}
 
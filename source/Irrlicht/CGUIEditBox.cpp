@@ -34,7 +34,7 @@ CGUIEditBox::CGUIEditBox(const wchar_t* text, bool border,
 	: IGUIEditBox(environment, parent, id, rectangle), OverwriteMode(false), MouseMarking(false),
 	Border(border), Background(true), OverrideColorEnabled(false), MarkBegin(0), MarkEnd(0),
 	OverrideColor(video::SColor(101,255,255,255)), OverrideFont(0), LastBreakFont(0),
-	Operator(0), BlinkStartTime(0), CursorBlinkTime(350), CursorChar(L"_"), CursorPos(0), HScrollPos(0), VScrollPos(0), Max(0),
+	Operator(0), BlinkStartTime(0), CursorBlinkTime(350), CursorBlinkPhase(0), CursorChar(L"_"), CursorPos(0), HScrollPos(0), VScrollPos(0), Max(0),
 	WordWrap(false), MultiLine(false), AutoScroll(true), PasswordBox(false),
 	PasswordChar(L'*'), HAlign(EGUIA_UPPERLEFT), VAlign(EGUIA_CENTER),
 	CurrentTextRect(0,0,1,1), FrameRect(rectangle)
@@ -1050,6 +1050,23 @@ void CGUIEditBox::draw()
 }
 
 
+//! invalidates the edit box when the cursor blinks
+void CGUIEditBox::OnPostRender(u32 timeMs)
+{
+	if (CursorBlinkTime && Environment->getDirtyRectangleMode() && Environment->hasFocus(this))
+	{
+		const u32 phase = (timeMs - BlinkStartTime) / CursorBlinkTime;
+		if (phase != CursorBlinkPhase)
+		{
+			CursorBlinkPhase = phase;
+			invalidate();
+		}
+	}
+
+	IGUIElement::OnPostRender(timeMs);
+}
+
+
 //! Sets the new caption of this element.
 void CGUIEditBox::setText(const wchar_t* text)
 {
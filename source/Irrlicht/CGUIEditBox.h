@@ -102,6 +102,9 @@ namespace gui
 		//! draws the element and its children
 		virtual void draw() _IRR_OVERRIDE_;
 
+		//! invalidates the edit box when the cursor blinks
+		virtual void OnPostRender(u32 timeMs) _IRR_OVERRIDE_;
+
 		//! Sets the new caption of this element.
 		virtual void setText(const wchar_t* text) _IRR_OVERRIDE_;
 
@@ -184,6 +187,7 @@ namespace gui
 
 		u32 BlinkStartTime;
 		irr::u32 CursorBlinkTime;
+		u32 CursorBlinkPhase;
 		core::stringw CursorChar; // IGUIFont::draw needs stringw instead of wchar_t
 		s32 CursorPos;
 		s32 HScrollPos, VScrollPos; // scroll position in characters
@@ -59,7 +59,8 @@ const io::path CGUIEnvironment::DefaultFontName = "#DefaultFont";
 CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, IOSOperator* op)
 : IGUIElement(EGUIET_ROOT, 0, 0, 0, core::rect<s32>(driver ? core::dimension2d<s32>(driver->getScreenSize()) : core::dimension2d<s32>(0,0))),
 	Driver(driver), Hovered(0), HoveredNoSubelement(0), Focus(0), LastHoveredMousePos(0,0), CurrentSkin(0),
-	FileSystem(fs), UserReceiver(0), Operator(op), FocusFlags(EFF_SET_ON_LMOUSE_DOWN|EFF_SET_ON_TAB)
+	FileSystem(fs), UserReceiver(0), Operator(op), FocusFlags(EFF_SET_ON_LMOUSE_DOWN|EFF_SET_ON_TAB),
+	DirtyRectangleMode(false), DirtyCache(0)
 {
 	if (Driver)
 		Driver->grab();
@@ -163,6 +164,8 @@ CGUIEnvironment::~CGUIEnvironment()
 
 	if (Driver)
 	{
+		if (DirtyCache)
+			Driver->removeTexture(DirtyCache);
 		Driver->drop();
 		Driver = 0;
 	}
@@ -212,13 +215,176 @@ void CGUIEnvironment::drawAll(bool useScreenSize)
 	if (ToolTip.Element)
 		bringToFront(ToolTip.Element);
 
-	draw();
+	if (DirtyRectangleMode && Driver && Driver->queryFeature(video::EVDF_RENDER_TO_TARGET))
+		drawDirtyRectangles();
+	else
+		draw();
 	OnPostRender ( os::Timer::getTime () );
 
 	clearDeletionQueue();
 }
 
 
+//! draws the invalidated rectangles into the cache texture and the texture to the screen
+void CGUIEnvironment::drawDirtyRectangles()
+{
+	RedrawnRectangles.set_used(0);
+
+	// the texture covers the screen up to the lower right corner of the gui
+	const core::dimension2du size(core::max_(AbsoluteRect.LowerRightCorner.X, 1), core::max_(AbsoluteRect.LowerRightCorner.Y, 1));
+	if (!DirtyCache || DirtyCache->getOriginalSize() != size)
+	{
+		if (DirtyCache)
+			Driver->removeTexture(DirtyCache);
+		// the cache has to map to the screen pixel by pixel
+		const bool allowNPOT = Driver->getTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2);
+		Driver->setTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2, true);
+		DirtyCache = Driver->addRenderTargetTexture(size, "GUIEnvironment.DirtyCache");
+		Driver->setTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2, allowNPOT);
+		DirtyRectangles.set_used(0);
+		DirtyRectangles.push_back(AbsoluteRect);
+	}
+
+	// drivers which only render into larger textures have to draw everything
+	if (!DirtyCache || DirtyCache->getSize() != size)
+	{
+		RedrawnRectangles.push_back(AbsoluteRect);
+		draw();
+		return;
+	}
+
+	if (!DirtyRectangles.empty())
+	{
+		// overlapping rectangles are drawn together
+		bool merged = true;
+		while (merged)
+		{
+			merged = false;
+			for (u32 i=0; i<DirtyRectangles.size(); ++i)
+			{
+				for (u32 j=i+1; j<DirtyRectangles.size(); ++j)
+				{
+					if (DirtyRectangles[i].isRectCollided(DirtyRectangles[j]))
+					{
+						DirtyRectangles[i].addInternalPoint(DirtyRectangles[j].UpperLeftCorner);
+						DirtyRectangles[i].addInternalPoint(DirtyRectangles[j].LowerRightCorner);
+						DirtyRectangles.erase(j);
+						--j;
+						merged = true;
+					}
+				}
+			}
+		}
+
+		// elements can invalidate while they are drawn, that is for the next frame
+		RedrawnRectangles.swap(DirtyRectangles);
+
+		Driver->setRenderTarget(DirtyCache, 0);
+		for (u32 i=0; i<RedrawnRectangles.size(); ++i)
+		{
+			const core::rect<s32>& rect = RedrawnRectangles[i];
+			Driver->draw2DRectangle(DirtyBackground, rect);
+
+			// elements outside of rect are clipped away completely
+			SavedClippingRects.set_used(0);
+			limitClippingRects(this, rect);
+			draw();
+			for (u32 k=0; k<SavedClippingRects.size(); ++k)
+				SavedClippingRects[k].Element->AbsoluteClippingRect = SavedClippingRects[k].Rect;
+		}
+		Driver->setRenderTarget(0, 0);
+	}
+
+	Driver->draw2DImage(DirtyCache, AbsoluteRect.UpperLeftCorner, AbsoluteRect);
+}
+
+
+//! clips the clipping rectangles of element and its children against rect
+void CGUIEnvironment::limitClippingRects(IGUIElement* element, const core::rect<s32>& rect)
+{
+	SClippingRect saved;
+	saved.Element = element;
+	saved.Rect = element->AbsoluteClippingRect;
+	SavedClippingRects.push_back(saved);
+
+	element->AbsoluteClippingRect.clipAgainst(rect);
+
+	core::list<IGUIElement*>::ConstIterator it = element->Children.begin();
+	for (; it != element->Children.end(); ++it)
+		limitClippingRects(*it, rect);
+}
+
+
+//! Enables drawing only the parts of the gui which changed
+void CGUIEnvironment::setDirtyRectangleMode(bool enable, video::SColor background)
+{
+	DirtyRectangleMode = enable;
+	DirtyBackground = background;
+	DirtyRectangles.set_used(0);
+	RedrawnRectangles.set_used(0);
+
+	if (enable)
+		DirtyRectangles.push_back(AbsoluteRect);
+	else if (DirtyCache)
+	{
+		Driver->removeTexture(DirtyCache);
+		DirtyCache = 0;
+	}
+}
+
+
+//! Returns true if the dirty rectangle mode is enabled
+bool CGUIEnvironment::getDirtyRectangleMode() const
+{
+	return DirtyRectangleMode;
+}
+
+
+//! Marks an area of the screen to be drawn again in the dirty rectangle mode
+void CGUIEnvironment::invalidateRect(const core::rect<s32>& rect)
+{
+	if (!DirtyRectangleMode)
+		return;
+
+	core::rect<s32> r(rect);
+	r.clipAgainst(AbsoluteRect);
+	if (r.getWidth() <= 0 || r.getHeight() <= 0)
+		return;
+
+	// many changes at once, like resizing, are drawn as one rectangle
+	if (DirtyRectangles.size() >= 64)
+	{
+		for (u32 i=1; i<DirtyRectangles.size(); ++i)
+		{
+			r.addInternalPoint(DirtyRectangles[i].UpperLeftCorner);
+			r.addInternalPoint(DirtyRectangles[i].LowerRightCorner);
+		}
+		r.addInternalPoint(DirtyRectangles[0].UpperLeftCorner);
+		r.addInternalPoint(DirtyRectangles[0].LowerRightCorner);
+		DirtyRectangles.set_used(0);
+	}
+	DirtyRectangles.push_back(r);
+}
+
+
+//! Returns the areas which the last drawAll() drew again in the dirty rectangle mode
+const core::array<core::rect<s32> >& CGUIEnvironment::getRedrawnRectangles() const
+{
+	return RedrawnRectangles;
+}
+
+
+//! invalidates an element which gets input, sub elements like scrollbars change their parent
+void CGUIEnvironment::invalidateInputElement(IGUIElement* element)
+{
+	while (element && element->isSubElement() && element->getParent())
+		element = element->getParent();
+
+	if (element && element != this)
+		element->invalidate();
+}
+
+
 //! sets the focus to an element
 bool CGUIEnvironment::setFocus(IGUIElement* element)
 {
@@ -279,6 +445,9 @@ bool CGUIEnvironment::setFocus(IGUIElement* element)
 		}
 	}
 
+	invalidateInputElement(Focus);
+	invalidateInputElement(element);
+
 	if (currentFocus)
 		currentFocus->drop();
 
@@ -322,6 +491,7 @@ bool CGUIEnvironment::removeFocus(IGUIElement* element)
 	}
 	if (Focus)
 	{
+		invalidateInputElement(Focus);
 		Focus->drop();
 		Focus = 0;
 	}
@@ -544,6 +714,11 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 
 	if (Hovered != lastHovered)
 	{
+		if (lastHovered && lastHovered != this)
+			lastHovered->invalidate();
+		if (Hovered && Hovered != this)
+			Hovered->invalidate();
+
 		SEvent event;
 		event.EventType = EET_GUI_EVENT;
 
@@ -610,6 +785,13 @@ bool CGUIEnvironment::postEventFromUser(const SEvent& event)
 
 		updateHoveredElement(core::position2d<s32>(event.MouseInput.X, event.MouseInput.Y));
 
+		// plain mouse moves only change the hovered elements
+		if (DirtyRectangleMode && (event.MouseInput.Event != EMIE_MOUSE_MOVED || event.MouseInput.ButtonStates))
+		{
+			invalidateInputElement(Focus);
+			invalidateInputElement(Hovered);
+		}
+
 		if ( Hovered != Focus )
 		{
 			IGUIElement * focusCandidate = Hovered;
@@ -649,6 +831,8 @@ bool CGUIEnvironment::postEventFromUser(const SEvent& event)
 		break;
 	case EET_KEY_INPUT_EVENT:
 		{
+			invalidateInputElement(Focus);
+
 			if (Focus && Focus->OnEvent(event))
 				return true;
 
@@ -717,6 +901,8 @@ void CGUIEnvironment::setSkin(IGUISkin* skin)
 
 	if (CurrentSkin)
 		CurrentSkin->grab();
+
+	invalidateRect(AbsoluteRect);
 }
 
 
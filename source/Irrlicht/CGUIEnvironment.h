@@ -33,6 +33,18 @@ public:
 	//! draws all gui elements
 	virtual void drawAll(bool useScreenSize) _IRR_OVERRIDE_;
 
+	//! Enables drawing only the parts of the gui which changed
+	virtual void setDirtyRectangleMode(bool enable, video::SColor background) _IRR_OVERRIDE_;
+
+	//! Returns true if the dirty rectangle mode is enabled
+	virtual bool getDirtyRectangleMode() const _IRR_OVERRIDE_;
+
+	//! Marks an area of the screen to be drawn again in the dirty rectangle mode
+	virtual void invalidateRect(const core::rect<s32>& rect) _IRR_OVERRIDE_;
+
+	//! Returns the areas which the last drawAll() drew again in the dirty rectangle mode
+	virtual const core::array<core::rect<s32> >& getRedrawnRectangles() const _IRR_OVERRIDE_;
+
 	//! returns the current video driver
 	virtual video::IVideoDriver* getVideoDriver() const _IRR_OVERRIDE_;
 
@@ -282,6 +294,15 @@ private:
 
 	void updateHoveredElement(core::position2d<s32> mousePos);
 
+	//! draws the invalidated rectangles into the cache texture and the texture to the screen
+	void drawDirtyRectangles();
+
+	//! clips the clipping rectangles of element and its children against rect
+	void limitClippingRects(IGUIElement* element, const core::rect<s32>& rect);
+
+	//! invalidates an element which gets input, sub elements like scrollbars change their parent
+	void invalidateInputElement(IGUIElement* element);
+
 	void loadBuiltInFont();
 
 	struct SFont
@@ -333,6 +354,19 @@ private:
 	u32 FocusFlags;
 	core::array<IGUIElement*> DeletionQueue;
 
+	struct SClippingRect
+	{
+		IGUIElement* Element;
+		core::rect<s32> Rect;
+	};
+
+	bool DirtyRectangleMode;
+	video::SColor DirtyBackground;
+	video::ITexture* DirtyCache;
+	core::array<core::rect<s32> > DirtyRectangles;
+	core::array<core::rect<s32> > RedrawnRectangles;
+	core::array<SClippingRect> SavedClippingRects;
+
 	static const io::path DefaultFontName;
 };
 
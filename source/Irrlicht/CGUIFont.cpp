@@ -18,15 +18,21 @@ namespace irr
 namespace gui
 {
 
+//! Number of texts for which the glyphs are kept, must be a power of two
+const u32 LAYOUT_CACHE_SIZE = 256;
+
 //! constructor
 CGUIFont::CGUIFont(IGUIEnvironment *env, const io::path& filename)
-: Driver(0), SpriteBank(0), Environment(env), WrongCharacter(0),
+: LayoutSprites(0), Driver(0), SpriteBank(0), Environment(env), WrongCharacter(0),
 	MaxHeight(0), GlobalKerningWidth(0), GlobalKerningHeight(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CGUIFont");
 	#endif
 
+	for (u32 i = 0; i < 256; ++i)
+		GlyphBlocks[i] = -1;
+
 	if (Environment)
 	{
 		// don't grab environment, to avoid circular references
@@ -70,6 +76,7 @@ bool CGUIFont::load(io::IXMLReader* xml, const io::path& directory)
 		return false;
 
 	SpriteBank->clear();
+	clearLayoutCache();
 
 	while (xml->read())
 	{
@@ -165,7 +172,8 @@ bool CGUIFont::load(io::IXMLReader* xml, const io::path& directory)
 				}
 				rectangle.LowerRightCorner.Y = val;
 
-				CharacterMap.insert(ch,Areas.size());
+				if (CharacterMap.insert(ch,Areas.size()))
+					setGlyph(ch, Areas.size());
 
 				// make frame
 				f.rectNumber = SpriteBank->getPositions().size();
@@ -260,6 +268,8 @@ bool CGUIFont::loadTexture(video::IImage* image, const io::path& name)
 	if (!image || !SpriteBank)
 		return false;
 
+	clearLayoutCache();
+
 	s32 lowerRightPositions = 0;
 
 	video::IImage* tmpImage=image;
@@ -374,6 +384,7 @@ void CGUIFont::readPositions(video::IImage* image, s32& lowerRightPositions)
 				// map letter to character
 				wchar_t ch = (wchar_t)(lowerRightPositions + 32);
 				CharacterMap.set(ch, lowerRightPositions);
+				setGlyph(ch, lowerRightPositions);
 
 				++lowerRightPositions;
 			}
@@ -388,6 +399,8 @@ void CGUIFont::readPositions(video::IImage* image, s32& lowerRightPositions)
 //! set an Pixel Offset on Drawing ( scale position on width )
 void CGUIFont::setKerningWidth(s32 kerning)
 {
+	if (kerning != GlobalKerningWidth)
+		clearLayoutCache();
 	GlobalKerningWidth = kerning;
 }
 
@@ -434,6 +447,18 @@ u32 CGUIFont::getSpriteNoFromChar(const wchar_t *c) const
 
 s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 {
+	if ((u32)c < 0x10000)
+	{
+		const s32 block = GlyphBlocks[(u32)c >> 8];
+		if (block >= 0)
+		{
+			const s32 area = GlyphTable[block + ((u32)c & 0xFF)];
+			if (area >= 0)
+				return area;
+		}
+		return WrongCharacter;
+	}
+
 	core::map<wchar_t, s32>::Node* n = CharacterMap.find(c);
 	if (n)
 		return n->getValue();
@@ -441,9 +466,26 @@ s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 		return WrongCharacter;
 }
 
+//! adds a character of the basic multilingual plane to the lookup table
+void CGUIFont::setGlyph(const wchar_t c, s32 area)
+{
+	if ((u32)c >= 0x10000)
+		return;
+
+	s32& block = GlyphBlocks[(u32)c >> 8];
+	if (block < 0)
+	{
+		block = GlyphTable.size();
+		for (u32 i = 0; i < 256; ++i)
+			GlyphTable.push_back(-1);
+	}
+	GlyphTable[block + ((u32)c & 0xFF)] = area;
+}
+
 void CGUIFont::setInvisibleCharacters( const wchar_t *s )
 {
 	Invisible = s;
+	clearLayoutCache();
 }
 
 
@@ -503,28 +545,90 @@ void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
 	if (!Driver || !SpriteBank)
 		return;
 
-	core::dimension2d<s32> textDimension;	// NOTE: don't make this u32 or the >> later on can fail when the dimension width is < position width
-	core::position2d<s32> offset = position.UpperLeftCorner;
+	STextLayout& layout = getLayout(text);
 
-	if (hcenter || vcenter || clip)
-		textDimension = getDimension(text.c_str());
+	core::position2d<s32> offset = position.UpperLeftCorner;
 
 	if (hcenter)
-		offset.X += (position.getWidth() - textDimension.Width) >> 1;
+		offset.X += (position.getWidth() - layout.Dimension.Width) >> 1;
 
 	if (vcenter)
-		offset.Y += (position.getHeight() - textDimension.Height) >> 1;
+		offset.Y += (position.getHeight() - layout.Dimension.Height) >> 1;
 
 	if (clip)
 	{
-		core::rect<s32> clippedRect(offset, textDimension);
+		core::rect<s32> clippedRect(offset, layout.Dimension);
 		clippedRect.clipAgainst(*clip);
 		if (!clippedRect.isValid())
 			return;
 	}
 
-	core::array<u32> indices(text.size());
-	core::array<core::position2di> offsets(text.size());
+	// texts are usually drawn at the same place in each frame, so the glyphs stay where they are
+	if (offset != layout.Origin)
+	{
+		const core::position2d<s32> move = offset - layout.Origin;
+		for (u32 i = 0; i < layout.Pages.size(); ++i)
+		{
+			core::array<core::position2d<s32> >& positions = layout.Pages[i].Positions;
+			for (u32 j = 0; j < positions.size(); ++j)
+				positions[j] += move;
+		}
+		layout.Origin = offset;
+	}
+
+	// one draw call for each texture
+	for (u32 i = 0; i < layout.Pages.size(); ++i)
+	{
+		const STextPage& page = layout.Pages[i];
+		if (!page.Positions.empty())
+			Driver->draw2DImageBatch(SpriteBank->getTexture(page.Texture), page.Positions,
+				page.SourceRects, clip, color, true);
+	}
+}
+
+
+//! returns the cached glyphs of text, creates them if needed
+CGUIFont::STextLayout& CGUIFont::getLayout(const core::stringw& text)
+{
+	// changes of the sprite bank from outside invalidate all texts
+	const u32 sprites = SpriteBank->getSprites().size() + SpriteBank->getPositions().size() + SpriteBank->getTextureCount();
+	if (LayoutSprites != sprites)
+	{
+		clearLayoutCache();
+		LayoutSprites = sprites;
+	}
+
+	if (LayoutCache.empty())
+	{
+		LayoutCache.reallocate(LAYOUT_CACHE_SIZE);
+		for (u32 i = 0; i < LAYOUT_CACHE_SIZE; ++i)
+			LayoutCache.push_back(STextLayout());
+	}
+
+	u32 hash = 2166136261u;
+	for (u32 i = 0; i < text.size(); ++i)
+		hash = (hash ^ (u32)text[i]) * 16777619u;
+
+	STextLayout& layout = LayoutCache[hash & (LAYOUT_CACHE_SIZE - 1)];
+	if (layout.Valid && layout.Text == text)
+		return layout;
+
+	layout.Text = text;
+	layout.Valid = true;
+	layout.Dimension = core::dimension2d<s32>(getDimension(text.c_str()));
+	layout.Origin.set(0, 0);
+	for (u32 i = 0; i < layout.Pages.size(); ++i)
+	{
+		layout.Pages[i].Positions.set_used(0);
+		layout.Pages[i].SourceRects.set_used(0);
+	}
+
+	const core::array<SGUISprite>& spriteList = SpriteBank->getSprites();
+	const core::array<core::rect<s32> >& rectangles = SpriteBank->getPositions();
+	const u32 textureCount = SpriteBank->getTextureCount();
+
+	core::position2d<s32> offset(0, 0);
+	STextPage* page = 0;
 
 	for(u32 i = 0;i < text.size();i++)
 	{
@@ -545,28 +649,51 @@ void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
 		if (lineBreak)
 		{
 			offset.Y += MaxHeight;
-			offset.X = position.UpperLeftCorner.X;
-
-			if ( hcenter )
-			{
-				offset.X += (position.getWidth() - textDimension.Width) >> 1;
-			}
+			offset.X = 0;
 			continue;
 		}
 
-		SFontArea& area = Areas[getAreaFromCharacter(c)];
+		const SFontArea& area = Areas[getAreaFromCharacter(c)];
 
 		offset.X += area.underhang;
-		if ( Invisible.findFirst ( c ) < 0 )
+		if ( Invisible.findFirst ( c ) < 0 && area.spriteno < spriteList.size() &&
+			!spriteList[area.spriteno].Frames.empty() )
 		{
-			indices.push_back(area.spriteno);
-			offsets.push_back(offset);
+			// fonts don't animate, always the first frame
+			const SGUISpriteFrame& frame = spriteList[area.spriteno].Frames[0];
+			if (frame.rectNumber < rectangles.size() && frame.textureNumber < textureCount)
+			{
+				if (!page || page->Texture != frame.textureNumber)
+				{
+					// pages are sorted by texture like the batches of the sprite bank
+					u32 p = 0;
+					while (p < layout.Pages.size() && layout.Pages[p].Texture < frame.textureNumber)
+						++p;
+					if (p == layout.Pages.size() || layout.Pages[p].Texture != frame.textureNumber)
+					{
+						layout.Pages.insert(STextPage(), p);
+						layout.Pages[p].Texture = frame.textureNumber;
+					}
+					page = &layout.Pages[p];
+				}
+
+				page->Positions.push_back(offset);
+				page->SourceRects.push_back(rectangles[frame.rectNumber]);
+			}
 		}
 
 		offset.X += area.width + area.overhang + GlobalKerningWidth;
 	}
 
-	SpriteBank->draw2DSpriteBatch(indices, offsets, clip, color);
+	return layout;
+}
+
+
+//! forgets the glyphs of all texts
+void CGUIFont::clearLayoutCache()
+{
+	for (u32 i = 0; i < LayoutCache.size(); ++i)
+		LayoutCache[i].Valid = false;
 }
 
 
@@ -98,14 +98,49 @@ private:
 
 	void readPositions(video::IImage* texture, s32& lowerRightPositions);
 
+	//! Glyphs which use the same texture
+	struct STextPage
+	{
+		STextPage() : Texture(0) {}
+
+		u32 Texture;
+		core::array<core::position2d<s32> > Positions;
+		core::array<core::rect<s32> > SourceRects;
+	};
+
+	//! Glyphs of a text, ready for draw2DImageBatch
+	struct STextLayout
+	{
+		STextLayout() : Valid(false) {}
+
+		core::stringw Text;
+		core::dimension2d<s32> Dimension;
+		//! Position of the upper left corner of the text, which the glyph positions are relative to
+		core::position2d<s32> Origin;
+		core::array<STextPage> Pages;
+		bool Valid;
+	};
+
 	s32 getAreaFromCharacter (const wchar_t c) const;
+	void setGlyph(const wchar_t c, s32 area);
 	void setMaxHeight();
 
+	//! Returns the cached glyphs of text, creates them if needed
+	STextLayout& getLayout(const core::stringw& text);
+	void clearLayoutCache();
+
 	void pushTextureCreationFlags(bool(&flags)[3]);
 	void popTextureCreationFlags(const bool(&flags)[3]);
 
 	core::array<SFontArea>		Areas;
 	core::map<wchar_t, s32>		CharacterMap;
+	//! Start of each block of 256 characters of the basic multilingual plane in GlyphTable, -1 if none is in the font
+	s32				GlyphBlocks[256];
+	//! Areas of the characters in the used blocks, -1 for characters not in the font
+	core::array<s32>		GlyphTable;
+	//! Direct mapped cache of the drawn texts
+	core::array<STextLayout>	LayoutCache;
+	u32				LayoutSprites;
 	video::IVideoDriver*		Driver;
 	IGUISpriteBank*			SpriteBank;
 	IGUIEnvironment*		Environment;
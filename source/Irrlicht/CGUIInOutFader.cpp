@@ -41,8 +41,11 @@ void CGUIInOutFader::draw()
 	if (now > EndTime && Action == EFA_FADE_IN)
 	{
 		Action = EFA_NOTHING;
+		invalidate();
 		return;
 	}
+	if (now <= EndTime)
+		invalidate();	// still fading
 
 	video::IVideoDriver* driver = Environment->getVideoDriver();
 
@@ -137,6 +140,7 @@ void CGUIInOutFader::fadeIn(u32 time)
 	EndTime = StartTime + time;
 	Action = EFA_FADE_IN;
 	setColor(Color[0],Color[1]);
+	invalidate();
 }
 
 
@@ -147,6 +151,7 @@ void CGUIInOutFader::fadeOut(u32 time)
 	EndTime = StartTime + time;
 	Action = EFA_FADE_OUT;
 	setColor(Color[0],Color[1]);
+	invalidate();
 }
 
 
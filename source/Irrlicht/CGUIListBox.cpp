@@ -544,7 +544,18 @@ void CGUIListBox::draw()
 
 	bool hl = (HighlightWhenNotFocused || Environment->hasFocus(this) || Environment->hasFocus(ScrollBar));
 
-	for (s32 i=0; i<(s32)Items.size(); ++i)
+	// only the items in the visible range, all items have the same height
+	s32 first = 0;
+	s32 end = (s32)Items.size();
+	if (ItemHeight > 0)
+	{
+		first = core::max_(0, (AbsoluteRect.UpperLeftCorner.Y - frameRect.LowerRightCorner.Y) / ItemHeight);
+		end = core::min_(end, (AbsoluteRect.LowerRightCorner.Y - frameRect.UpperLeftCorner.Y) / ItemHeight + 1);
+		frameRect.UpperLeftCorner.Y += first * ItemHeight;
+		frameRect.LowerRightCorner.Y += first * ItemHeight;
+	}
+
+	for (s32 i=first; i<end; ++i)
 	{
 		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
 			frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
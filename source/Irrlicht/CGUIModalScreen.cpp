@@ -74,6 +74,11 @@ bool CGUIModalScreen::isPointInside(const core::position2d<s32>& point) const
     return true;
 }
 
+bool CGUIModalScreen::isHitInsideClippingRect() const
+{
+    return false;
+}
+
 //! called if an event happened.
 bool CGUIModalScreen::OnEvent(const SEvent& event)
 {
@@ -153,6 +158,8 @@ void CGUIModalScreen::draw()
 		return;
 
 	u32 now = os::Timer::getTime();
+	if (now - MouseDownTime < 300)
+		invalidate();	// blinking
 	if (now - MouseDownTime < 300 && (now / 70)%2)
 	{
 		core::list<IGUIElement*>::Iterator it = Children.begin();
@@ -46,6 +46,9 @@ namespace gui
 		//! Modals are infinite so every point is inside
 		virtual bool isPointInside(const core::position2d<s32>& point) const _IRR_OVERRIDE_;
 
+		//! So the modal is also hit outside of its clipping rectangle
+		virtual bool isHitInsideClippingRect() const _IRR_OVERRIDE_;
+
 		//! Writes attributes of the element.
 		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const _IRR_OVERRIDE_;
 
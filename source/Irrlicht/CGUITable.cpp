@@ -34,7 +34,7 @@ CGUITable::CGUITable(IGUIEnvironment* environment, IGUIElement* parent,
 	CellHeightPadding(2), CellWidthPadding(5), ActiveTab(-1),
 	CurrentOrdering(EGOM_NONE), DrawFlags(EGTDF_ROWS | EGTDF_COLUMNS | EGTDF_ACTIVE_ROW ),
 	ScrollBarSize(0),
-	OverrideFont(0)
+	OverrideFont(0), BrokenTextFont(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CGUITable");
@@ -220,12 +220,8 @@ void CGUITable::setColumnWidth(u32 columnIndex, u32 width)
 		if ( width < MIN_WIDTH )
 			width = MIN_WIDTH;
 
+		// the texts of the cells are broken again when they get drawn
 		Columns[columnIndex].Width = width;
-
-		for ( u32 i=0; i < Rows.size(); ++i )
-		{
-			breakText( Rows[i].Items[columnIndex].Text, Rows[i].Items[columnIndex].BrokenText, Columns[columnIndex].Width );
-		}
 	}
 	recalculateWidths();
 }
@@ -258,19 +254,18 @@ u32 CGUITable::addRow(u32 rowIndex)
 		rowIndex = Rows.size();
 	}
 
-	Row row;
-
-	if ( rowIndex == Rows.size() )
-		Rows.push_back(row);
-	else
-		Rows.insert(row, rowIndex);
+	Rows.push_back(Row());
 
-	Rows[rowIndex].Items.reallocate(Columns.size());
+	Row& row = Rows.getLast();
+	row.Items.reallocate(Columns.size());
 	for ( u32 i = 0 ; i < Columns.size() ; ++i )
 	{
-		Rows[rowIndex].Items.push_back(Cell());
+		row.Items.push_back(Cell());
 	}
 
+	// rows after the new one move down by swapping cells, they are not copied
+	moveRow(Rows.size()-1, rowIndex);
+
 	recalculateHeights();
 	return rowIndex;
 }
@@ -278,10 +273,11 @@ u32 CGUITable::addRow(u32 rowIndex)
 
 void CGUITable::removeRow(u32 rowIndex)
 {
-	if ( rowIndex > Rows.size() )
+	if ( rowIndex >= Rows.size() )
 		return;
 
-	Rows.erase( rowIndex );
+	moveRow(rowIndex, Rows.size()-1);
+	Rows.erase( Rows.size()-1 );
 
 	if ( !(Selected < s32(Rows.size())) )
 		Selected = Rows.size() - 1;
@@ -296,7 +292,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
-		breakText( Rows[rowIndex].Items[columnIndex].Text, Rows[rowIndex].Items[columnIndex].BrokenText, Columns[columnIndex].Width );
+		Rows[rowIndex].Items[columnIndex].BrokenTextWidth = -1;
 
 		IGUISkin* skin = Environment->getSkin();
 		if ( skin )
@@ -309,7 +305,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
-		breakText( Rows[rowIndex].Items[columnIndex].Text, Rows[rowIndex].Items[columnIndex].BrokenText, Columns[columnIndex].Width );
+		Rows[rowIndex].Items[columnIndex].BrokenTextWidth = -1;
 		Rows[rowIndex].Items[columnIndex].Color = color;
 		Rows[rowIndex].Items[columnIndex].IsOverrideColor = true;
 	}
@@ -672,9 +668,7 @@ void CGUITable::swapRows(u32 rowIndexA, u32 rowIndexB)
 	if ( rowIndexB >= Rows.size() )
 		return;
 
-	Row swap = Rows[rowIndexA];
-	Rows[rowIndexA] = Rows[rowIndexB];
-	Rows[rowIndexB] = swap;
+	Rows[rowIndexA].Items.swap(Rows[rowIndexB].Items);
 
 	if ( Selected == s32(rowIndexA) )
 		Selected = rowIndexB;
@@ -765,55 +759,86 @@ bool CGUITable::selectColumnHeader(s32 xpos, s32 ypos)
 }
 
 
-void CGUITable::orderRows(s32 columnIndex, EGUI_ORDERING_MODE mode)
+//! Moves a row to another index, the rows between move by one
+void CGUITable::moveRow(u32 from, u32 to)
 {
-	Row swap;
+	for ( ; from < to; ++from )
+		Rows[from].Items.swap(Rows[from+1].Items);
+	for ( ; from > to; --from )
+		Rows[from].Items.swap(Rows[from-1].Items);
+}
 
+
+namespace
+{
+	//! Index of a row and the text it is ordered by
+	struct SRowOrder
+	{
+		const core::stringw* Text;
+		u32 Index;
+		bool Descending;
+
+		// rows with the same text keep their order, so the sort is stable
+		bool operator<(const SRowOrder& other) const
+		{
+			if ( *Text < *other.Text )
+				return !Descending;
+			if ( *other.Text < *Text )
+				return Descending;
+			return Index < other.Index;
+		}
+	};
+}
+
+
+void CGUITable::orderRows(s32 columnIndex, EGUI_ORDERING_MODE mode)
+{
 	if ( columnIndex == -1 )
 		columnIndex = getActiveColumn();
-	if ( columnIndex < 0 )
+	if ( columnIndex < 0 || columnIndex >= (s32)Columns.size() )
+		return;
+
+	if ( mode != EGOM_ASCENDING && mode != EGOM_DESCENDING )
 		return;
 
-	if ( mode == EGOM_ASCENDING )
+	// sort the row indices, the rows themselves are moved only once afterwards
+	core::array<SRowOrder> order(Rows.size());
+	for ( u32 i = 0 ; i < Rows.size() ; ++i )
 	{
-		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
-		{
-			for ( s32 j = 0 ; j < s32(Rows.size()) - i - 1 ; ++j )
-			{
-				if ( Rows[j+1].Items[columnIndex].Text < Rows[j].Items[columnIndex].Text )
-				{
-					swap = Rows[j];
-					Rows[j] = Rows[j+1];
-					Rows[j+1] = swap;
-
-					if ( Selected == j )
-						Selected = j+1;
-					else if( Selected == j+1 )
-						Selected = j;
-				}
-			}
-		}
+		SRowOrder row;
+		row.Text = &Rows[i].Items[columnIndex].Text;
+		row.Index = i;
+		row.Descending = (mode == EGOM_DESCENDING);
+		order.push_back(row);
 	}
-	else if ( mode == EGOM_DESCENDING )
+	order.sort();
+
+	// row order[i].Index goes to i, follow each cycle of the permutation and swap the cells along it
+	core::array<bool> placed;
+	placed.set_used(Rows.size());
+	for ( u32 i = 0 ; i < Rows.size() ; ++i )
+		placed[i] = false;
+
+	s32 newSelected = Selected;
+	for ( u32 i = 0 ; i < Rows.size() ; ++i )
 	{
-		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
+		if ( (s32)order[i].Index == Selected )
+			newSelected = i;
+
+		if ( placed[i] )
+			continue;
+
+		u32 current = i;
+		while ( order[current].Index != i )
 		{
-			for ( s32 j = 0 ; j < s32(Rows.size()) - i - 1 ; ++j )
-			{
-				if ( Rows[j].Items[columnIndex].Text < Rows[j+1].Items[columnIndex].Text)
-				{
-					swap = Rows[j];
-					Rows[j] = Rows[j+1];
-					Rows[j+1] = swap;
-
-					if ( Selected == j )
-						Selected = j+1;
-					else if( Selected == j+1 )
-						Selected = j;
-				}
-			}
+			const u32 next = order[current].Index;
+			Rows[current].Items.swap(Rows[next].Items);
+			placed[current] = true;
+			current = next;
 		}
+		placed[current] = true;
 	}
+	Selected = newSelected;
 }
 
 
@@ -869,6 +894,17 @@ void CGUITable::draw()
 	if ( ScrollBarSize != skin->getSize(EGDS_SCROLLBAR_SIZE) )
 		checkScrollbars();
 
+	// texts which were broken with another font have to be broken again
+	if ( font != BrokenTextFont )
+	{
+		for ( u32 i = 0 ; i < Rows.size() ; ++i )
+		{
+			for ( u32 j = 0 ; j < Rows[i].Items.size() ; ++j )
+				Rows[i].Items[j].BrokenTextWidth = -1;
+		}
+		BrokenTextFont = font;
+	}
+
 	// CAREFUL: near identical calculations for tableRect and clientClip are also done in checkScrollbars and selectColumnHeader
 	// Area of table used for drawing without scrollbars
 	core::rect<s32> tableRect(AbsoluteRect);
@@ -909,8 +945,19 @@ void CGUITable::draw()
 	core::rect<s32> rowRect(scrolledTableClient);
 	rowRect.LowerRightCorner.Y = rowRect.UpperLeftCorner.Y + ItemHeight;
 
+	// only the rows in the visible range, all rows have the same height
+	u32 first = 0;
+	u32 end = Rows.size();
+	if ( ItemHeight > 0 )
+	{
+		first = (u32)core::max_(0, (AbsoluteRect.UpperLeftCorner.Y - rowRect.LowerRightCorner.Y) / ItemHeight);
+		end = (u32)core::max_(0, core::min_((s32)end, (AbsoluteRect.LowerRightCorner.Y - rowRect.UpperLeftCorner.Y) / ItemHeight + 1));
+		rowRect.UpperLeftCorner.Y += first * ItemHeight;
+		rowRect.LowerRightCorner.Y += first * ItemHeight;
+	}
+
 	u32 pos;
-	for ( u32 i = 0 ; i < Rows.size() ; ++i )
+	for ( u32 i = first ; i < end ; ++i )
 	{
 		if (rowRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
 			rowRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
@@ -935,16 +982,23 @@ void CGUITable::draw()
 				textRect.UpperLeftCorner.X = pos + CellWidthPadding;
 				textRect.LowerRightCorner.X = pos + Columns[j].Width - CellWidthPadding;
 
+				Cell& cell = Rows[i].Items[j];
+				if ( cell.BrokenTextWidth != (s32)Columns[j].Width )
+				{
+					breakText( cell.Text, cell.BrokenText, Columns[j].Width );
+					cell.BrokenTextWidth = (s32)Columns[j].Width;
+				}
+
 				// draw item text
 				if ((s32)i == Selected)
 				{
-					font->draw(Rows[i].Items[j].BrokenText.c_str(), textRect, skin->getColor(isEnabled() ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT), false, true, &clientClip);
+					font->draw(cell.BrokenText.c_str(), textRect, skin->getColor(isEnabled() ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT), false, true, &clientClip);
 				}
 				else
 				{
-					if ( !Rows[i].Items[j].IsOverrideColor )	// skin-colors can change
-						Rows[i].Items[j].Color = skin->getColor(EGDC_BUTTON_TEXT);
-					font->draw(Rows[i].Items[j].BrokenText.c_str(), textRect, isEnabled() ? Rows[i].Items[j].Color : skin->getColor(EGDC_GRAY_TEXT), false, true, &clientClip);
+					if ( !cell.IsOverrideColor )	// skin-colors can change
+						cell.Color = skin->getColor(EGDC_BUTTON_TEXT);
+					font->draw(cell.BrokenText.c_str(), textRect, isEnabled() ? cell.Color : skin->getColor(EGDC_GRAY_TEXT), false, true, &clientClip);
 				}
 
 				pos += Columns[j].Width;
@@ -1253,7 +1307,6 @@ void CGUITable::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWri
 
 			label = "Row"; label += i; label += "cell"; label += c; label += "text";
 			cell.Text = core::stringw(in->getAttributeAsString(label.c_str()).c_str());
-			breakText( cell.Text, cell.BrokenText, Columns[c].Width );
 			label = "Row"; label += i; label += "cell"; label += c; label += "color";
 			cell.Color = in->getAttributeAsColor(label.c_str());
 			label = "Row"; label += i; label += "cell"; label += c; label += "IsOverrideColor";
@@ -186,10 +186,12 @@ namespace gui
 
 		struct Cell
 		{
-			Cell() : IsOverrideColor(false), Data(0) {}
+			Cell() : BrokenTextWidth(-1), IsOverrideColor(false), Data(0) {}
 
 			core::stringw Text;
 			core::stringw BrokenText;
+			//! Column width BrokenText was made for, -1 when the text changed
+			s32 BrokenTextWidth;
 			bool IsOverrideColor;
 			video::SColor Color;
 			void *Data;
@@ -212,6 +214,7 @@ namespace gui
 		};
 
 		void breakText(const core::stringw &text, core::stringw & brokenText, u32 cellWidth);
+		void moveRow(u32 from, u32 to);
 		void selectNew(s32 ypos, bool onlyHover=false);
 		bool selectColumnHeader(s32 xpos, s32 ypos);
 		bool dragColumnStart(s32 xpos, s32 ypos);
@@ -243,6 +246,9 @@ namespace gui
 		s32 ScrollBarSize;
 
 		gui::IGUIFont* OverrideFont;
+
+		//! Font the texts of the cells were broken with
+		gui::IGUIFont* BrokenTextFont;
 	};
 
 } // end namespace gui
@@ -73,6 +73,11 @@ void CGUITreeViewNode::clearChildren()
 		( *it )->drop();
 	}
 	Children.clear();
+
+	if( Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 }
 
 IGUITreeViewNode* CGUITreeViewNode::addChildBack(
@@ -96,6 +101,10 @@ IGUITreeViewNode* CGUITreeViewNode::addChildBack(
 	{
 		data2->grab();
 	}
+	if( Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 	return newChild;
 }
 
@@ -120,6 +129,10 @@ IGUITreeViewNode* CGUITreeViewNode::addChildFront(
 	{
 		data2->grab();
 	}
+	if( Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 	return newChild;
 }
 
@@ -154,6 +167,10 @@ IGUITreeViewNode* CGUITreeViewNode::insertChildAfter(
 			break;
 		}
 	}
+	if( newChild && Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 	return newChild;
 }
 
@@ -188,6 +205,10 @@ IGUITreeViewNode* CGUITreeViewNode::insertChildBefore(
 			break;
 		}
 	}
+	if( newChild && Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 	return newChild;
 }
 
@@ -301,6 +322,10 @@ bool CGUITreeViewNode::deleteChild( IGUITreeViewNode* child )
 			break;
 		}
 	}
+	if( deleted && Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 	return deleted;
 }
 
@@ -326,6 +351,10 @@ bool CGUITreeViewNode::moveChildUp( IGUITreeViewNode* child )
 		}
 		itOther = itChild;
 	}
+	if( moved && Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 	return moved;
 }
 
@@ -352,11 +381,19 @@ bool CGUITreeViewNode::moveChildDown( IGUITreeViewNode* child )
 			break;
 		}
 	}
+	if( moved && Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 	return moved;
 }
 
 void CGUITreeViewNode::setExpanded( bool expanded )
 {
+	if( Expanded != expanded && Owner )
+	{
+		Owner->invalidateVisibleNodes();
+	}
 	Expanded = expanded;
 }
 
@@ -442,7 +479,8 @@ CGUITreeView::CGUITreeView(IGUIEnvironment* environment, IGUIElement* parent,
 	Selecting( false ),
 	Clip( clip ),
 	DrawBack( drawBack ),
-	ImageLeftOfIcon( true )
+	ImageLeftOfIcon( true ),
+	VisibleNodesDirty( true )
 {
 #ifdef _DEBUG
 	setDebugName( "CGUITreeView" );
@@ -608,14 +646,8 @@ void CGUITreeView::recalculateItemHeight()
 		}
 	}
 
-	TotalItemHeight = 0;
+	TotalItemHeight = ItemHeight * getVisibleNodes().size();
 	TotalItemWidth = AbsoluteRect.getWidth() * 2;
-	IGUITreeViewNode* node = Root->getFirstChild();
-	while( node )
-	{
-		TotalItemHeight += ItemHeight;
-		node = node->getNextVisible();
-	}
 
 	if ( ScrollBarV )
 	{
@@ -639,6 +671,22 @@ void CGUITreeView::recalculateItemHeight()
 
 }
 
+const core::array<IGUITreeViewNode*>& CGUITreeView::getVisibleNodes()
+{
+	if( VisibleNodesDirty )
+	{
+		VisibleNodes.set_used( 0 );
+		IGUITreeViewNode* node = Root->getFirstChild();
+		while( node )
+		{
+			VisibleNodes.push_back( node );
+			node = node->getNextVisible();
+		}
+		VisibleNodesDirty = false;
+	}
+	return VisibleNodes;
+}
+
 void CGUITreeView::updateScrollBarSize(s32 size)
 {
 	if ( size != ScrollBarSize )
@@ -772,17 +820,10 @@ void CGUITreeView::mouseAction( s32 xpos, s32 ypos, bool onlyHover /*= false*/ )
 	}
 
 	IGUITreeViewNode* hitNode = 0;
-	IGUITreeViewNode* node = Root->getFirstChild();
-	s32	n = 0;
-	while( node )
+	const core::array<IGUITreeViewNode*>& visibleNodes = getVisibleNodes();
+	if( selIdx >= 0 && selIdx < (s32)visibleNodes.size() )
 	{
-		if( selIdx == n )
-		{
-			hitNode = node;
-			break;
-		}
-		node = node->getNextVisible();
-		++n;
+		hitNode = visibleNodes[selIdx];
 	}
 
 	s32 scrollBarHPos = ScrollBarH ? ScrollBarH->getPos() : 0;
@@ -915,9 +956,21 @@ void CGUITreeView::draw()
 		frameRect.LowerRightCorner.Y -= ScrollBarV->getPos();
 	}
 
-	IGUITreeViewNode* node = Root->getFirstChild();
-	while( node )
+	// only the nodes in the visible range, all nodes have the same height
+	const core::array<IGUITreeViewNode*>& visibleNodes = getVisibleNodes();
+	u32 first = 0;
+	u32 end = visibleNodes.size();
+	if( ItemHeight > 0 )
 	{
+		first = (u32)core::max_( 0, ( AbsoluteRect.UpperLeftCorner.Y - frameRect.LowerRightCorner.Y ) / ItemHeight );
+		end = (u32)core::max_( 0, core::min_( (s32)end, ( AbsoluteRect.LowerRightCorner.Y - frameRect.UpperLeftCorner.Y ) / ItemHeight + 1 ) );
+		frameRect.UpperLeftCorner.Y += first * ItemHeight;
+		frameRect.LowerRightCorner.Y += first * ItemHeight;
+	}
+
+	for( u32 i = first; i < end; ++i )
+	{
+		IGUITreeViewNode* node = visibleNodes[i];
 		frameRect.UpperLeftCorner.X = AbsoluteRect.UpperLeftCorner.X + 1 + node->getLevel() * IndentWidth;
 		if ( ScrollBarH )
 		{
@@ -1088,8 +1141,6 @@ void CGUITreeView::draw()
 
 		frameRect.UpperLeftCorner.Y += ItemHeight;
 		frameRect.LowerRightCorner.Y += ItemHeight;
-
-		node = node->getNextVisible();
 	}
 
 	IGUIElement::draw();
@@ -6,6 +6,7 @@
 
 #include "IGUITreeView.h"
 #include "irrList.h"
+#include "irrArray.h"
 
 
 namespace irr
@@ -326,6 +327,13 @@ namespace gui
 		//! executes an mouse action (like selectNew of CGUIListBox)
 		void mouseAction( s32 xpos, s32 ypos, bool onlyHover = false );
 
+		//! The visible nodes in the order in which they are drawn, updated after the tree changed
+		const core::array<IGUITreeViewNode*>& getVisibleNodes();
+
+		//! The nodes call this when children were added, removed or moved, or when they were expanded or collapsed
+		void invalidateVisibleNodes()
+		{ VisibleNodesDirty = true; }
+
 		CGUITreeViewNode*	Root;
 		IGUITreeViewNode*	Selected;
 		s32			ItemHeight;
@@ -345,6 +353,8 @@ namespace gui
 		bool			Clip;
 		bool			DrawBack;
 		bool			ImageLeftOfIcon;
+		core::array<IGUITreeViewNode*>	VisibleNodes;
+		bool			VisibleNodesDirty;
 	};
 
 
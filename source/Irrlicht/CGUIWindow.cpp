@@ -129,6 +129,8 @@ bool CGUIWindow::OnEvent(const SEvent& event)
 			if (event.GUIEvent.EventType == EGET_ELEMENT_FOCUS_LOST)
 			{
 				Dragging = false;
+				if (IsActive)
+					invalidate();
 				IsActive = false;
 			}
 			else
@@ -137,10 +139,14 @@ bool CGUIWindow::OnEvent(const SEvent& event)
 				if (Parent && ((event.GUIEvent.Caller == this) || isMyChild(event.GUIEvent.Caller)))
 				{
 					Parent->bringToFront(this);
+					if (!IsActive)
+						invalidate();
 					IsActive = true;
 				}
 				else
 				{
+					if (IsActive)
+						invalidate();
 					IsActive = false;
 				}
 			}
@@ -5,6 +5,7 @@
 #include "CImage.h"
 #include "irrString.h"
 #include "CColorConverter.h"
+#include "CMipMapGenerator.h"
 #include "CBlit.h"
 #include "os.h"
 #include "SoftwareDriver2_helper.h"
@@ -277,6 +278,10 @@ void CImage::copyToScalingBoxFilter(IImage* target, s32 bias, bool blend)
 		return;
 	}
 
+	// halving is the common case (mip maps)
+	if (bias == 0 && !blend && CMipMapGenerator::halveBox(this, target))
+		return;
+
 	const core::dimension2d<u32> destSize = target->getDimension();
 
 	const f32 sourceXStep = (f32) Size.Width / (f32) destSize.Width;
@@ -10,8 +10,11 @@
 #include "SColor.h"
 #include "CColorConverter.h"
 #include "CImage.h"
+#include "CImageRowSink.h"
 #include "os.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -215,8 +218,50 @@ void CImageLoaderBMP::decompress4BitRLE(u8*& bmpData, s32 size, s32 width, s32 h
 
 
 
+//! converts bottom-up rows of the file into the image format
+void CImageLoaderBMP::convertRows(const SBMPHeader& header, const s32* paletteData, const u8* in, u8* out, s32 rows, s32 pitch, bool flip) const
+{
+	switch(header.BPP)
+	{
+	case 1:
+		CColorConverter::convert1BitTo16Bit(in, (s16*)out, header.Width, rows, pitch, flip);
+		break;
+	case 4:
+		CColorConverter::convert4BitTo16Bit(in, (s16*)out, header.Width, rows, paletteData, pitch, flip);
+		break;
+	case 8:
+		CColorConverter::convert8BitTo16Bit(in, (s16*)out, header.Width, rows, paletteData, pitch, flip);
+		break;
+	case 16:
+		CColorConverter::convert16BitTo16Bit((const s16*)in, (s16*)out, header.Width, rows, pitch, flip);
+		break;
+	case 24:
+		CColorConverter::convert24BitTo24Bit(in, out, header.Width, rows, pitch, flip, true);
+		break;
+	case 32: // thx to Reinhard Ostermeier
+		CColorConverter::convert32BitTo32Bit((const s32*)in, (s32*)out, header.Width, rows, pitch, flip);
+		break;
+	}
+}
+
+
 //! creates a surface from the file
 IImage* CImageLoaderBMP::loadImage(io::IReadFile* file) const
+{
+	IRR_PROFILE(CProfileScope p1(EPID_IL_BMP);)
+	return decodeImage(file, 0, 1);
+}
+
+
+//! creates a surface from a part of the file
+IImage* CImageLoaderBMP::loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const
+{
+	return decodeImage(file, &sourceRect, scaleDenom);
+}
+
+
+//! decodes the whole image when sourceRect is 0, otherwise only the requested part
+IImage* CImageLoaderBMP::decodeImage(io::IReadFile* file, const core::rect<s32>* sourceRect, u32 scaleDenom) const
 {
 	SBMPHeader header;
 
@@ -252,6 +297,44 @@ IImage* CImageLoaderBMP::loadImage(io::IReadFile* file) const
 		return 0;
 	}
 
+	if (header.Width <= 0 || header.Height <= 0) // top-down bitmaps are not handled
+	{
+		os::Printer::log("Bitmap size not supported.", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	ECOLOR_FORMAT format;
+	switch(header.BPP)
+	{
+	case 1:
+	case 4:
+	case 8:
+	case 16:
+		format = ECF_A1R5G5B5;
+		break;
+	case 24:
+		format = ECF_R8G8B8;
+		break;
+	case 32:
+		format = ECF_A8R8G8B8;
+		break;
+	default:
+		return 0;
+	}
+
+	// no default constructor from packed area! ARM problem!
+	core::dimension2d<u32> dim;
+	dim.Width = header.Width;
+	dim.Height = header.Height;
+
+	core::rect<s32> partRect;
+	if (sourceRect)
+	{
+		partRect = getImagePartRect(dim, *sourceRect, scaleDenom);
+		if (partRect.getWidth() <= 0 || partRect.getHeight() <= 0)
+			return 0;
+	}
+
 	// adjust bitmap data size to dword boundary
 	header.BitmapDataSize += (4-(header.BitmapDataSize%4))%4;
 
@@ -291,66 +374,85 @@ IImage* CImageLoaderBMP::loadImage(io::IReadFile* file) const
 	s32 lineData = widthInBytes + ((4-(widthInBytes%4)))%4;
 	pitch = lineData - widthInBytes;
 
-	u8* bmpData = new u8[header.BitmapDataSize];
-	file->read(bmpData, header.BitmapDataSize);
+	IImage* image = 0;
 
-	// decompress data if needed
-	switch(header.Compression)
+	if (header.Compression == 0)
 	{
-	case 1: // 8 bit rle
-		decompress8BitRLE(bmpData, header.BitmapDataSize, header.Width, header.Height, pitch);
-		break;
-	case 2: // 4 bit rle
-		decompress4BitRLE(bmpData, header.BitmapDataSize, header.Width, header.Height, pitch);
-		break;
-	}
+		// uncompressed data is read in strips of rows, so we never need a copy of the whole file data
+		const u32 stripRows = core::max_(IMAGE_LOADER_BLOCK_SIZE / (u32)lineData, 1u);
+		u8* strip = new u8[stripRows * lineData];
 
-	// create surface
+		if (!sourceRect)
+		{
+			image = new CImage(format, dim);
 
-	// no default constructor from packed area! ARM problem!
-	core::dimension2d<u32> dim;
-	dim.Width = header.Width;
-	dim.Height = header.Height;
+			// rows are stored bottom-up, so the first strip ends up at the end of the image
+			for (u32 y=0; y<dim.Height; y+=stripRows)
+			{
+				const u32 rows = core::min_(stripRows, dim.Height - y);
+				file->read(strip, rows * lineData);
+				convertRows(header, paletteData, strip, (u8*)image->getData() + (dim.Height - y - rows) * image->getPitch(), rows, pitch, true);
+			}
+		}
+		else
+		{
+			CImageRowSink sink(format, dim, partRect, scaleDenom);
+			u8* converted = new u8[dim.Width * IImage::getBitsPerPixelFromFormat(format) / 8];
 
-	IImage* image = 0;
-	switch(header.BPP)
+			for (u32 y=0; y<sink.getEndRow(); ++y)
+			{
+				if (!sink.wantsRow(y))
+					continue;
+				file->seek(header.BitmapDataOffset + (dim.Height - 1 - y) * lineData);
+				file->read(strip, lineData);
+				convertRows(header, paletteData, strip, converted, 1, pitch, false);
+				sink.writeRow(y, converted);
+			}
+
+			delete [] converted;
+			image = sink.grabImage();
+		}
+
+		delete [] strip;
+	}
+	else
 	{
-	case 1:
-		image = new CImage(ECF_A1R5G5B5, dim);
-		if (image)
-			CColorConverter::convert1BitTo16Bit(bmpData, (s16*)image->getData(), header.Width, header.Height, pitch, true);
-		break;
-	case 4:
-		image = new CImage(ECF_A1R5G5B5, dim);
-		if (image)
-			CColorConverter::convert4BitTo16Bit(bmpData, (s16*)image->getData(), header.Width, header.Height, paletteData, pitch, true);
-		break;
-	case 8:
-		image = new CImage(ECF_A1R5G5B5, dim);
-		if (image)
-			CColorConverter::convert8BitTo16Bit(bmpData, (s16*)image->getData(), header.Width, header.Height, paletteData, pitch, true);
-		break;
-	case 16:
-		image = new CImage(ECF_A1R5G5B5, dim);
-		if (image)
-			CColorConverter::convert16BitTo16Bit((s16*)bmpData, (s16*)image->getData(), header.Width, header.Height, pitch, true);
-		break;
-	case 24:
-		image = new CImage(ECF_R8G8B8, dim);
-		if (image)
-			CColorConverter::convert24BitTo24Bit(bmpData, (u8*)image->getData(), header.Width, header.Height, pitch, true, true);
-		break;
-	case 32: // thx to Reinhard Ostermeier
-		image = new CImage(ECF_A8R8G8B8, dim);
-		if (image)
-			CColorConverter::convert32BitTo32Bit((s32*)bmpData, (s32*)image->getData(), header.Width, header.Height, pitch, true);
-		break;
-	};
+		u8* bmpData = new u8[header.BitmapDataSize];
+		file->read(bmpData, header.BitmapDataSize);
+
+		// decompress data if needed
+		switch(header.Compression)
+		{
+		case 1: // 8 bit rle
+			decompress8BitRLE(bmpData, header.BitmapDataSize, header.Width, header.Height, pitch);
+			break;
+		case 2: // 4 bit rle
+			decompress4BitRLE(bmpData, header.BitmapDataSize, header.Width, header.Height, pitch);
+			break;
+		}
+
+		// create surface
+		image = new CImage(format, dim);
+		convertRows(header, paletteData, bmpData, (u8*)image->getData(), header.Height, pitch, true);
+		delete [] bmpData;
+
+		if (sourceRect)
+		{
+			// rle data has to be decompressed completely anyway
+			CImageRowSink sink(format, dim, partRect, scaleDenom);
+			for (u32 y=0; y<sink.getEndRow(); ++y)
+			{
+				if (sink.wantsRow(y))
+					sink.writeRow(y, (u8*)image->getData() + y * image->getPitch());
+			}
+			image->drop();
+			image = sink.grabImage();
+		}
+	}
 
 	// clean up
 
 	delete [] paletteData;
-	delete [] bmpData;
 
 	return image;
 }
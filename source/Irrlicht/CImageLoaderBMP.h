@@ -83,8 +83,23 @@ public:
 	//! creates a surface from the file
 	virtual IImage* loadImage(io::IReadFile* file) const _IRR_OVERRIDE_;
 
+	//! uncompressed bitmaps are decoded in strips of rows and only the needed rows are read
+	virtual bool isImagePartLoadingSupported() const _IRR_OVERRIDE_
+	{
+		return true;
+	}
+
+	//! creates a surface from a part of the file
+	virtual IImage* loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const _IRR_OVERRIDE_;
+
 private:
 
+	//! decodes the whole image when sourceRect is 0, otherwise only the requested part
+	IImage* decodeImage(io::IReadFile* file, const core::rect<s32>* sourceRect, u32 scaleDenom) const;
+
+	//! converts bottom-up rows of the file into the image format
+	void convertRows(const SBMPHeader& header, const s32* paletteData, const u8* in, u8* out, s32 rows, s32 pitch, bool flip) const;
+
 	void decompress8BitRLE(u8*& BmpData, s32 size, s32 width, s32 height, s32 pitch) const;
 
 	void decompress4BitRLE(u8*& BmpData, s32 size, s32 width, s32 height, s32 pitch) const;
@@ -21,6 +21,8 @@
 #include "CColorConverter.h"
 #include "CImage.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 // Header flag values
 #define DDSD_CAPS			0x00000001
@@ -688,6 +690,7 @@ bool CImageLoaderDDS::isALoadableFileFormat(io::IReadFile* file) const
 //! creates a surface from the file
 IImage* CImageLoaderDDS::loadImage(io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_DDS);)
 	ddsHeader header;
 	IImage* image = 0;
 	s32 width, height;
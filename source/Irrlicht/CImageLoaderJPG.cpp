@@ -8,8 +8,11 @@
 
 #include "IReadFile.h"
 #include "CImage.h"
+#include "CImageRowSink.h"
 #include "os.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -56,6 +59,19 @@ bool CImageLoaderJPG::isALoadableFileExtension(const io::path& filename) const
         core::stringc* filename;
     };
 
+    // struct for reading the jpeg data in blocks from the file
+    struct irr_jpeg_source_mgr
+    {
+        // public jpeg source fields
+        struct jpeg_source_mgr pub;
+
+        // file we read from
+        io::IReadFile* file;
+
+        // data of the current block
+        JOCTET buffer[4096];
+    };
+
 void CImageLoaderJPG::init_source (j_decompress_ptr cinfo)
 {
 	// DO NOTHING
@@ -65,7 +81,19 @@ void CImageLoaderJPG::init_source (j_decompress_ptr cinfo)
 
 boolean CImageLoaderJPG::fill_input_buffer (j_decompress_ptr cinfo)
 {
-	// DO NOTHING
+	irr_jpeg_source_mgr* src = (irr_jpeg_source_mgr*)cinfo->src;
+
+	size_t bytesRead = src->file->read(src->buffer, sizeof(src->buffer));
+	if (bytesRead == 0)
+	{
+		// Insert a fake EOI marker, so a truncated file still gives the part decoded so far
+		src->buffer[0] = (JOCTET) 0xFF;
+		src->buffer[1] = (JOCTET) JPEG_EOI;
+		bytesRead = 2;
+	}
+
+	src->pub.next_input_byte = src->buffer;
+	src->pub.bytes_in_buffer = bytesRead;
 	return TRUE;
 }
 
@@ -76,8 +104,18 @@ void CImageLoaderJPG::skip_input_data (j_decompress_ptr cinfo, long count)
 	jpeg_source_mgr * src = cinfo->src;
 	if(count > 0)
 	{
-		src->bytes_in_buffer -= count;
-		src->next_input_byte += count;
+		if ((size_t)count <= src->bytes_in_buffer)
+		{
+			src->bytes_in_buffer -= count;
+			src->next_input_byte += count;
+		}
+		else
+		{
+			// skip the rest directly in the file instead of reading it
+			count -= (long)src->bytes_in_buffer;
+			src->bytes_in_buffer = 0;
+			((irr_jpeg_source_mgr*)src)->file->seek(count, true);
+		}
 	}
 }
 
@@ -135,6 +173,21 @@ bool CImageLoaderJPG::isALoadableFileFormat(io::IReadFile* file) const
 
 //! creates a surface from the file
 IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
+{
+	IRR_PROFILE(CProfileScope p1(EPID_IL_JPG);)
+	return decodeImage(file, 0, 1);
+}
+
+
+//! creates a surface from a part of the file
+IImage* CImageLoaderJPG::loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const
+{
+	return decodeImage(file, &sourceRect, scaleDenom);
+}
+
+
+//! decodes the whole image or a part of it
+IImage* CImageLoaderJPG::decodeImage(io::IReadFile* file, const core::rect<s32>* sourceRect, u32 scaleDenom) const
 {
 	#ifndef _IRR_COMPILE_WITH_LIBJPEG_
 	os::Printer::log("Can't load as not compiled with _IRR_COMPILE_WITH_LIBJPEG_:", file->getFileName(), ELL_DEBUG);
@@ -146,9 +199,14 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 
 	core::stringc filename = file->getFileName();
 
-	u8 **rowPtr=0;
-	u8* input = new u8[file->getSize()];
-	file->read(input, file->getSize());
+	// everything which has to be released when the jpeg code signals an error
+	struct SDecodeState
+	{
+		SDecodeState() : row(0), image(0), sink(0) {}
+		u8* row;
+		IImage* image;
+		CImageRowSink* sink;
+	} state;
 
 	// allocate and initialize JPEG decompression object
 	struct jpeg_decompress_struct cinfo;
@@ -174,8 +232,10 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 
 		jpeg_destroy_decompress(&cinfo);
 
-		delete [] input;
-		delete [] rowPtr;
+		delete [] state.row;
+		delete state.sink;
+		if (state.image)
+			state.image->drop();
 
 		// return null pointer
 		return 0;
@@ -184,19 +244,18 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	// Now we can initialize the JPEG decompression object.
 	jpeg_create_decompress(&cinfo);
 
-	// specify data source
-	jpeg_source_mgr jsrc;
-
-	// Set up data pointer
-	jsrc.bytes_in_buffer = file->getSize();
-	jsrc.next_input_byte = (JOCTET*)input;
-	cinfo.src = &jsrc;
+	// specify data source, the file is read in blocks while decoding
+	irr_jpeg_source_mgr jsrc;
+	jsrc.file = file;
+	jsrc.pub.bytes_in_buffer = 0;
+	jsrc.pub.next_input_byte = 0;
+	cinfo.src = &jsrc.pub;
 
-	jsrc.init_source = init_source;
-	jsrc.fill_input_buffer = fill_input_buffer;
-	jsrc.skip_input_data = skip_input_data;
-	jsrc.resync_to_restart = jpeg_resync_to_restart;
-	jsrc.term_source = term_source;
+	jsrc.pub.init_source = init_source;
+	jsrc.pub.fill_input_buffer = fill_input_buffer;
+	jsrc.pub.skip_input_data = skip_input_data;
+	jsrc.pub.resync_to_restart = jpeg_resync_to_restart;
+	jsrc.pub.term_source = term_source;
 
 	// Decodes JPG input from whatever source
 	// Does everything AFTER jpeg_create_decompress
@@ -221,50 +280,71 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	cinfo.output_gamma=2.2;
 	cinfo.do_fancy_upsampling=FALSE;
 
+	core::rect<s32> partRect;
+	u32 step = 1;
+	if (sourceRect)
+	{
+		partRect = getImagePartRect(core::dimension2d<u32>(cinfo.image_width, cinfo.image_height), *sourceRect, scaleDenom);
+		if (partRect.getWidth() <= 0 || partRect.getHeight() <= 0)
+		{
+			jpeg_destroy_decompress(&cinfo);
+			return 0;
+		}
+
+		// let the decoder do as much of the downscaling as possible by using the reduced size IDCT
+		step = scaleDenom > 1 ? scaleDenom : 1;
+		u32 decoderScale = 8;
+		while (step % decoderScale)
+			decoderScale /= 2;
+		cinfo.scale_num = 1;
+		cinfo.scale_denom = decoderScale;
+		step /= decoderScale;
+	}
+
 	// Start decompressor
 	jpeg_start_decompress(&cinfo);
 
 	// Get image data
-	u16 rowspan = cinfo.image_width * cinfo.out_color_components;
-	u32 width = cinfo.image_width;
-	u32 height = cinfo.image_height;
-
-	// Allocate memory for buffer
-	u8* output = new u8[rowspan * height];
+	const u32 width = cinfo.output_width;
+	const u32 height = cinfo.output_height;
 
-	// Here we use the library's state variable cinfo.output_scanline as the
-	// loop counter, so that we don't have to keep track ourselves.
-	// Create array of row pointers for lib
-	rowPtr = new u8* [height];
+	if (sourceRect)
+		state.sink = new CImageRowSink(ECF_R8G8B8, core::dimension2d<u32>(width, height), partRect, step);
+	else
+		state.image = new CImage(ECF_R8G8B8, core::dimension2d<u32>(width, height));
 
-	for( u32 i = 0; i < height; i++ )
-		rowPtr[i] = &output[ i * rowspan ];
+	// CMYK and partial images are decoded one row at a time into a temporary row,
+	// everything else directly into the image. Converted CMYK rows for the sink
+	// are stored behind the CMYK data.
+	u8* cmykRow = 0;
+	if (useCMYK)
+	{
+		state.row = new u8[width * (state.sink ? 7 : 4)];
+		cmykRow = state.row + width * 4;
+	}
+	else if (state.sink)
+		state.row = new u8[width * 3];
 
-	u32 rowsRead = 0;
+	const u32 endRow = state.sink ? state.sink->getEndRow() : height;
 
-	while( cinfo.output_scanline < cinfo.output_height )
-		rowsRead += jpeg_read_scanlines( &cinfo, &rowPtr[rowsRead], cinfo.output_height - rowsRead );
+	// Here we use the library's state variable cinfo.output_scanline as the
+	// loop counter, so that we don't have to keep track ourselves.
+	while( cinfo.output_scanline < endRow )
+	{
+		const u32 y = cinfo.output_scanline;
+		u8* target = state.row ? state.row : (u8*)state.image->getData() + y * state.image->getPitch();
 
-	delete [] rowPtr;
-	// Finish decompression
+		JSAMPROW rowPtr = target;
+		jpeg_read_scanlines(&cinfo, &rowPtr, 1);
 
-	jpeg_finish_decompress(&cinfo);
+		if (state.sink && !state.sink->wantsRow(y))
+			continue;
 
-	// Release JPEG decompression object
-	// This is an important step since it will release a good deal of memory.
-	jpeg_destroy_decompress(&cinfo);
-
-	// convert image
-	IImage* image = 0;
-	if (useCMYK)
-	{
-		image = new CImage(ECF_R8G8B8,
-				core::dimension2d<u32>(width, height));
-		const u32 size = 3*width*height;
-		u8* data = (u8*)image->getData();
-		if (data)
+		if (useCMYK)
 		{
-			for (u32 i=0,j=0; i<size; i+=3, j+=4)
+			u8* data = state.sink ? cmykRow : (u8*)state.image->getData() + y * state.image->getPitch();
+			const u8* output = state.row;
+			for (u32 i=0,j=0; i<3*width; i+=3, j+=4)
 			{
 				// Also works without K, but has more contrast with K multiplied in
 //				data[i+0] = output[j+2];
@@ -274,14 +354,31 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 				data[i+1] = (char)(output[j+1]*(output[j+3]/255.f));
 				data[i+2] = (char)(output[j+0]*(output[j+3]/255.f));
 			}
+			if (state.sink)
+				state.sink->writeRow(y, cmykRow);
 		}
-		delete [] output;
+		else if (state.sink)
+			state.sink->writeRow(y, state.row);
 	}
+
+	delete [] state.row;
+
+	// Finish decompression, when only a part was needed the rest of the file is not read at all
+	if (cinfo.output_scanline < cinfo.output_height)
+		jpeg_abort_decompress(&cinfo);
 	else
-		image = new CImage(ECF_R8G8B8,
-				core::dimension2d<u32>(width, height), output);
+		jpeg_finish_decompress(&cinfo);
 
-	delete [] input;
+	// Release JPEG decompression object
+	// This is an important step since it will release a good deal of memory.
+	jpeg_destroy_decompress(&cinfo);
+
+	IImage* image = state.image;
+	if (state.sink)
+	{
+		image = state.sink->grabImage();
+		delete state.sink;
+	}
 
 	return image;
 
@@ -51,8 +51,20 @@ public:
 	//! creates a surface from the file
 	virtual IImage* loadImage(io::IReadFile* file) const _IRR_OVERRIDE_;
 
+	//! jpgs can be decoded at 1/2, 1/4 and 1/8 of their size
+	virtual bool isImagePartLoadingSupported() const _IRR_OVERRIDE_
+	{
+		return true;
+	}
+
+	//! creates a surface from a part of the file
+	virtual IImage* loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const _IRR_OVERRIDE_;
+
 private:
 
+	//! decodes the whole image when sourceRect is 0, otherwise only the requested part
+	IImage* decodeImage(io::IReadFile* file, const core::rect<s32>* sourceRect, u32 scaleDenom) const;
+
 #ifdef _IRR_COMPILE_WITH_LIBJPEG_
 	// several methods used via function pointers by jpeglib
 
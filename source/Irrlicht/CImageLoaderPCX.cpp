@@ -12,6 +12,8 @@
 #include "CImage.h"
 #include "os.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 
 namespace irr
@@ -50,6 +52,7 @@ bool CImageLoaderPCX::isALoadableFileFormat(io::IReadFile* file) const
 //! creates a image from the file
 IImage* CImageLoaderPCX::loadImage(io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_PCX);)
 	SPCXHeader header;
 	s32* paletteData = 0;
 
@@ -15,8 +15,11 @@
 #endif // _IRR_COMPILE_WITH_LIBPNG_
 
 #include "CImage.h"
+#include "CImageRowSink.h"
 #include "CReadFile.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -87,13 +90,34 @@ bool CImageLoaderPng::isALoadableFileFormat(io::IReadFile* file) const
 
 // load in the image data
 IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
+{
+	IRR_PROFILE(CProfileScope p1(EPID_IL_PNG);)
+	return decodeImage(file, 0, 1);
+}
+
+
+// load in a part of the image data
+IImage* CImageLoaderPng::loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const
+{
+	return decodeImage(file, &sourceRect, scaleDenom);
+}
+
+
+// decodes the whole image when sourceRect is 0, otherwise only the requested part
+IImage* CImageLoaderPng::decodeImage(io::IReadFile* file, const core::rect<s32>* sourceRect, u32 scaleDenom) const
 {
 #ifdef _IRR_COMPILE_WITH_LIBPNG_
 	if (!file)
 		return 0;
 
-	//Used to point to image rows
-	u8** RowPointers = 0;
+	// everything which has to be released when libpng signals an error
+	struct SDecodeState
+	{
+		SDecodeState() : Row(0), Image(0), Sink(0) {}
+		u8* Row;
+		IImage* Image;
+		CImageRowSink* Sink;
+	} state;
 
 	png_byte buffer[8];
 	// Read the first few bytes of the PNG file
@@ -132,7 +156,10 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 	if (setjmp(png_jmpbuf(png_ptr)))
 	{
 		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		delete [] RowPointers;
+		delete [] state.Row;
+		delete state.Sink;
+		if (state.Image)
+			state.Image->drop();
 		return 0;
 	}
 
@@ -147,13 +174,14 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 	u32 Height;
 	s32 BitDepth;
 	s32 ColorType;
+	s32 InterlaceType;
 	{
 		// Use temporary variables to avoid passing cast pointers
 		png_uint_32 w,h;
 		// Extract info
 		png_get_IHDR(png_ptr, info_ptr,
 			&w, &h,
-			&BitDepth, &ColorType, NULL, NULL, NULL);
+			&BitDepth, &ColorType, &InterlaceType, NULL, NULL);
 		Width=w;
 		Height=h;
 	}
@@ -196,6 +224,24 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 			png_set_gamma(png_ptr, screen_gamma, 0.45455);
 	}
 
+	core::rect<s32> partRect;
+	u32 step = 1;
+	if (sourceRect)
+	{
+		partRect = getImagePartRect(core::dimension2d<u32>(Width, Height), *sourceRect, scaleDenom);
+		if (partRect.getWidth() <= 0 || partRect.getHeight() <= 0)
+		{
+			png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+			return 0;
+		}
+		step = scaleDenom > 1 ? scaleDenom : 1;
+	}
+
+	// The first pass of an interlaced png contains every 8th pixel of every 8th row,
+	// that's all we need when scaling down by a multiple of 8.
+	const bool firstPassOnly = sourceRect && InterlaceType == PNG_INTERLACE_ADAM7 && step % 8 == 0;
+	const s32 passes = firstPassOnly ? 1 : png_set_interlace_handling(png_ptr);
+
 	// Update the changes in between, as we need to get the new color type
 	// for proper processing of the RGBA type
 	png_read_update_info(png_ptr, info_ptr);
@@ -220,53 +266,69 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 #endif
 	}
 
-	// Create the image structure to be filled by png data
-	video::IImage* image = 0;
-	if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA)
-		image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(Width, Height));
-	else
-		image = new CImage(ECF_R8G8B8, core::dimension2d<u32>(Width, Height));
-	if (!image)
-	{
-		os::Printer::log("LOAD PNG: Internal PNG create image struct failure\n", file->getFileName(), ELL_ERROR);
-		png_destroy_read_struct(&png_ptr, NULL, NULL);
-		return 0;
-	}
-
-	// Create array of pointers to rows in image data
-	RowPointers = new png_bytep[Height];
-	if (!RowPointers)
-	{
-		os::Printer::log("LOAD PNG: Internal PNG create row pointers failure\n", file->getFileName(), ELL_ERROR);
-		png_destroy_read_struct(&png_ptr, NULL, NULL);
-		delete image;
-		return 0;
-	}
+	const ECOLOR_FORMAT format = (ColorType==PNG_COLOR_TYPE_RGB_ALPHA) ? ECF_A8R8G8B8 : ECF_R8G8B8;
 
-	// Fill array of pointers to rows in image data
-	unsigned char* data = (unsigned char*)image->getData();
-	for (u32 i=0; i<Height; ++i)
+	if (!sourceRect || passes > 1)
 	{
-		RowPointers[i]=data;
-		data += image->getPitch();
+		// Create the image structure to be filled by png data
+		state.Image = new CImage(format, core::dimension2d<u32>(Width, Height));
+
+		// Read the rows directly into the image, for interlaced images each pass updates all rows
+		for (s32 pass=0; pass<passes; ++pass)
+		{
+			u8* data = (u8*)state.Image->getData();
+			for (u32 i=0; i<Height; ++i)
+			{
+				png_read_row(png_ptr, data, NULL);
+				data += state.Image->getPitch();
+			}
+		}
+
+		if (!sourceRect)
+		{
+			png_read_end(png_ptr, NULL);
+			png_destroy_read_struct(&png_ptr,&info_ptr, 0); // Clean up memory
+			return state.Image;
+		}
+
+		// Fully decoded interlaced image from which a part is needed
+		state.Sink = new CImageRowSink(format, core::dimension2d<u32>(Width, Height), partRect, step);
+		const u8* data = (const u8*)state.Image->getData();
+		for (u32 i=0; i<Height; ++i)
+		{
+			if (state.Sink->wantsRow(i))
+				state.Sink->writeRow(i, data);
+			data += state.Image->getPitch();
+		}
+		state.Image->drop();
+		state.Image = 0;
 	}
-
-	// for proper error handling
-	if (setjmp(png_jmpbuf(png_ptr)))
+	else
 	{
-		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		delete [] RowPointers;
-		delete image;
-		return 0;
+		// Decode one row at a time and stop once the part is complete
+		if (firstPassOnly)
+		{
+			Width = (Width + 7) / 8;
+			Height = (Height + 7) / 8;
+			step /= 8;
+		}
+		state.Sink = new CImageRowSink(format, core::dimension2d<u32>(Width, Height), partRect, step);
+		state.Row = new u8[png_get_rowbytes(png_ptr, info_ptr)];
+
+		const u32 endRow = state.Sink->getEndRow();
+		for (u32 i=0; i<endRow; ++i)
+		{
+			png_read_row(png_ptr, state.Row, NULL);
+			if (state.Sink->wantsRow(i))
+				state.Sink->writeRow(i, state.Row);
+		}
+		delete [] state.Row;
 	}
 
-	// Read data using the library function that handles all transformations including interlacing
-	png_read_image(png_ptr, RowPointers);
-
-	png_read_end(png_ptr, NULL);
-	delete [] RowPointers;
 	png_destroy_read_struct(&png_ptr,&info_ptr, 0); // Clean up memory
 
+	IImage* image = state.Sink->grabImage();
+	delete state.Sink;
 	return image;
 #else
 	return 0;
@@ -34,6 +34,20 @@ public:
 
 	//! creates a surface from the file
 	virtual IImage* loadImage(io::IReadFile* file) const _IRR_OVERRIDE_;
+
+	//! pngs are decoded row by row, interlaced ones can be downscaled by 8 using the first pass only
+	virtual bool isImagePartLoadingSupported() const _IRR_OVERRIDE_
+	{
+		return true;
+	}
+
+	//! creates a surface from a part of the file
+	virtual IImage* loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const _IRR_OVERRIDE_;
+
+private:
+
+	//! decodes the whole image when sourceRect is 0, otherwise only the requested part
+	IImage* decodeImage(io::IReadFile* file, const core::rect<s32>* sourceRect, u32 scaleDenom) const;
 };
 
 
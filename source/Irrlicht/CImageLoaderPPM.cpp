@@ -12,6 +12,8 @@
 #include "os.h"
 #include "fast_atof.h"
 #include "coreutil.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -48,6 +50,7 @@ bool CImageLoaderPPM::isALoadableFileFormat(io::IReadFile* file) const
 //! creates a surface from the file
 IImage* CImageLoaderPPM::loadImage(io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_PPM);)
 	IImage* image;
 
 	if (file->getSize() < 12)
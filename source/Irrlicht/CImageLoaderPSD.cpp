@@ -10,6 +10,8 @@
 #include "os.h"
 #include "CImage.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 
 namespace irr
@@ -52,6 +54,7 @@ bool CImageLoaderPSD::isALoadableFileFormat(io::IReadFile* file) const
 //! creates a surface from the file
 IImage* CImageLoaderPSD::loadImage(io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_PSD);)
 	u32* imageData = 0;
 
 	PsdHeader header;
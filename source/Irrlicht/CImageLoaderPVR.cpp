@@ -10,6 +10,8 @@
 #include "os.h"
 #include "CImage.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -43,6 +45,7 @@ bool CImageLoaderPVR::isALoadableFileFormat(io::IReadFile* file) const
 
 IImage* CImageLoaderPVR::loadImage(io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_PVR);)
 	core::array<IImage*> imageArray = loadImages(file, 0);
 
 	const u32 imageCount = imageArray.size();
@@ -56,7 +59,7 @@ IImage* CImageLoaderPVR::loadImage(io::IReadFile* file) const
 	if (imageCount > 1)
 		imageArray.erase(1, imageCount - 1);
 
-	return (imageCount > 1) ? imageArray[0] : 0;
+	return (imageCount > 0) ? imageArray[0] : 0;
 }
 
 core::array<IImage*> CImageLoaderPVR::loadImages(io::IReadFile* file, E_TEXTURE_TYPE* type) const
@@ -199,8 +202,8 @@ core::array<IImage*> CImageLoaderPVR::loadImages(io::IReadFile* file, E_TEXTURE_
 
 		for (u32 i = 1; i < header.MipMapCount; ++i)
 		{
-			u32 tmpWidth = header.Width >> i;
-			u32 tmpHeight = header.Height >> i;
+			u32 tmpWidth = core::max_(header.Width >> i, 1u);
+			u32 tmpHeight = core::max_(header.Height >> i, 1u);
 
 			dataSize += IImage::getDataSizeFromFormat(format, tmpWidth, tmpHeight);
 		}
@@ -234,8 +237,8 @@ core::array<IImage*> CImageLoaderPVR::loadImages(io::IReadFile* file, E_TEXTURE_
 			}
 			else
 			{
-				u32 tmpWidth = header.Width >> i;
-				u32 tmpHeight = header.Height >> i;
+				u32 tmpWidth = core::max_(header.Width >> i, 1u);
+				u32 tmpHeight = core::max_(header.Height >> i, 1u);
 
 				dataSize = IImage::getDataSizeFromFormat(format, tmpWidth, tmpHeight);
 
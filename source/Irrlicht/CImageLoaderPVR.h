@@ -7,8 +7,6 @@
 
 #include "IrrCompileConfig.h"
 
-#ifdef _IRR_COMPILE_WITH_PVR_LOADER_
-
 #include "IImageLoader.h"
 
 namespace irr
@@ -16,6 +14,8 @@ namespace irr
 namespace video
 {
 
+#if defined(_IRR_COMPILE_WITH_PVR_LOADER_) || defined(_IRR_COMPILE_WITH_PVR_WRITER_)
+
 #include "irrpack.h"
 
 struct SPVRHeader
@@ -36,6 +36,10 @@ struct SPVRHeader
 
 #include "irrunpack.h"
 
+#endif // compiled with loader or writer
+
+#ifdef _IRR_COMPILE_WITH_PVR_LOADER_
+
 class CImageLoaderPVR : public IImageLoader
 {
 public:
@@ -48,8 +52,9 @@ public:
 	virtual core::array<IImage*> loadImages(io::IReadFile* file, E_TEXTURE_TYPE* type) const _IRR_OVERRIDE_;
 };
 
+#endif
+
 }
 }
 
 #endif
-#endif
@@ -131,6 +131,8 @@ DUMMY -		This 404 bytes of data should be set to 0. This makes the Header exactl
 #include "CImage.h"
 #include "os.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 
 namespace irr
@@ -169,6 +171,7 @@ bool CImageLoaderRGB::isALoadableFileFormat(io::IReadFile* file) const
 				null pointer on fail */
 IImage* CImageLoaderRGB::loadImage(io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_RGB);)
 	IImage* image = 0;
 	s32* paletteData = 0;
 
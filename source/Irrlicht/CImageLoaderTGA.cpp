@@ -10,7 +10,10 @@
 #include "os.h"
 #include "CColorConverter.h"
 #include "CImage.h"
+#include "CImageRowSink.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 
 namespace irr
@@ -27,52 +30,88 @@ bool CImageLoaderTGA::isALoadableFileExtension(const io::path& filename) const
 }
 
 
-//! loads a compressed tga.
-u8 *CImageLoaderTGA::loadCompressedImage(io::IReadFile *file, const STGAHeader& header) const
+//! reads the next rows in file order, decompressing them if needed.
+void CImageLoaderTGA::readRows(io::IReadFile *file, const STGAHeader& header, SRLEState& rle, u8* out, u32 rows) const
 {
-	// This was written and sent in by Jon Pry, thank you very much!
-	// I only changed the formatting a little bit.
-
-	s32 bytesPerPixel = header.PixelDepth/8;
-	s32 imageSize =  header.ImageHeight * header.ImageWidth * bytesPerPixel;
-	u8* data = new u8[imageSize];
-	s32 currentByte = 0;
+	const u32 bytesPerPixel = header.PixelDepth/8;
+	const u32 size = rows * header.ImageWidth * bytesPerPixel;
 
-	while(currentByte < imageSize)
+	if (header.ImageType != 10)
 	{
-		u8 chunkheader = 0;
-		file->read(&chunkheader, sizeof(u8)); // Read The Chunk's Header
+		file->read(out, size);
+		return;
+	}
 
-		if(chunkheader < 128) // If The Chunk Is A 'RAW' Chunk
-		{
-			chunkheader++; // Add 1 To The Value To Get Total Number Of Raw Pixels
+	// This was written and sent in by Jon Pry, thank you very much!
+	// Changed to keep the state of the current chunk, so chunks can
+	// span over the strips of rows which are decoded at once.
 
-			file->read(&data[currentByte], bytesPerPixel * chunkheader);
-			currentByte += bytesPerPixel * chunkheader;
-		}
-		else
+	u32 currentByte = 0;
+	while(currentByte < size)
+	{
+		if (!rle.Count)
 		{
-			// thnx to neojzs for some fixes with this code
-
-			// If It's An RLE Header
-			chunkheader -= 127; // Subtract 127 To Get Rid Of The ID Bit
+			u8 chunkheader = 0;
+			file->read(&chunkheader, sizeof(u8)); // Read The Chunk's Header
 
-			s32 dataOffset = currentByte;
-			file->read(&data[dataOffset], bytesPerPixel);
+			if(chunkheader < 128) // If The Chunk Is A 'RAW' Chunk
+			{
+				rle.Count = chunkheader + 1; // Add 1 To The Value To Get Total Number Of Raw Pixels
+				rle.Run = false;
+			}
+			else
+			{
+				// thnx to neojzs for some fixes with this code
 
-			currentByte += bytesPerPixel;
+				// If It's An RLE Header
+				rle.Count = chunkheader - 127; // Subtract 127 To Get Rid Of The ID Bit
+				rle.Run = true;
+				file->read(rle.Pixel, bytesPerPixel);
+			}
+		}
 
-			for(s32 counter = 1; counter < chunkheader; counter++)
+		const u32 count = core::min_(rle.Count, (size - currentByte) / bytesPerPixel);
+		if (rle.Run)
+		{
+			for(u32 counter = 0; counter < count; counter++)
 			{
-				for(s32 elementCounter=0; elementCounter < bytesPerPixel; elementCounter++)
-					data[currentByte + elementCounter] = data[dataOffset + elementCounter];
+				for(u32 elementCounter=0; elementCounter < bytesPerPixel; elementCounter++)
+					out[currentByte + elementCounter] = rle.Pixel[elementCounter];
 
 				currentByte += bytesPerPixel;
 			}
 		}
+		else
+		{
+			file->read(&out[currentByte], bytesPerPixel * count);
+			currentByte += bytesPerPixel * count;
+		}
+		rle.Count -= count;
 	}
+}
+
 
-	return data;
+//! converts rows in file order into the image format
+void CImageLoaderTGA::convertRows(const STGAHeader& header, const u32* palette, const u8* in, u8* out, u32 rows, bool flip) const
+{
+	switch(header.PixelDepth)
+	{
+	case 8:
+		if (header.ImageType==3) // grey image
+			CColorConverter::convert8BitTo24Bit(in, out, header.ImageWidth, rows, 0, 0, flip);
+		else
+			CColorConverter::convert8BitTo16Bit(in, (s16*)out, header.ImageWidth, rows, (const s32*)palette, 0, flip);
+		break;
+	case 16:
+		CColorConverter::convert16BitTo16Bit((const s16*)in, (s16*)out, header.ImageWidth, rows, 0, flip);
+		break;
+	case 24:
+		CColorConverter::convert24BitTo24Bit(in, out, header.ImageWidth, rows, 0, flip, true);
+		break;
+	case 32:
+		CColorConverter::convert32BitTo32Bit((const s32*)in, (s32*)out, header.ImageWidth, rows, 0, flip);
+		break;
+	}
 }
 
 
@@ -94,6 +133,21 @@ bool CImageLoaderTGA::isALoadableFileFormat(io::IReadFile* file) const
 
 //! creates a surface from the file
 IImage* CImageLoaderTGA::loadImage(io::IReadFile* file) const
+{
+	IRR_PROFILE(CProfileScope p1(EPID_IL_TGA);)
+	return decodeImage(file, 0, 1);
+}
+
+
+//! creates a surface from a part of the file
+IImage* CImageLoaderTGA::loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const
+{
+	return decodeImage(file, &sourceRect, scaleDenom);
+}
+
+
+//! decodes the whole image when sourceRect is 0, otherwise only the requested part
+IImage* CImageLoaderTGA::decodeImage(io::IReadFile* file, const core::rect<s32>* sourceRect, u32 scaleDenom) const
 {
 	STGAHeader header;
 	u32 *palette = 0;
@@ -106,6 +160,45 @@ IImage* CImageLoaderTGA::loadImage(io::IReadFile* file) const
 	header.ImageHeight = os::Byteswap::byteswap(header.ImageHeight);
 #endif
 
+	if (	header.ImageType != 1 && // Uncompressed, color-mapped images.
+			header.ImageType != 2 && // Uncompressed, RGB images
+			header.ImageType != 3 && // Uncompressed, black and white images
+			header.ImageType != 10 // Runlength encoded RGB images
+		)
+	{
+		os::Printer::log("Unsupported TGA file type", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	ECOLOR_FORMAT format;
+	switch(header.PixelDepth)
+	{
+	case 8:
+		format = (header.ImageType==3) ? ECF_R8G8B8 : ECF_A1R5G5B5;
+		break;
+	case 16:
+		format = ECF_A1R5G5B5;
+		break;
+	case 24:
+		format = ECF_R8G8B8;
+		break;
+	case 32:
+		format = ECF_A8R8G8B8;
+		break;
+	default:
+		os::Printer::log("Unsupported TGA format", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const core::dimension2d<u32> dim(header.ImageWidth, header.ImageHeight);
+	core::rect<s32> partRect;
+	if (sourceRect)
+	{
+		partRect = getImagePartRect(dim, *sourceRect, scaleDenom);
+		if (partRect.getWidth() <= 0 || partRect.getHeight() <= 0)
+			return 0;
+	}
+
 	// skip image identification field
 	if (header.IdLength)
 		file->seek(header.IdLength, true);
@@ -135,88 +228,75 @@ IImage* CImageLoaderTGA::loadImage(io::IReadFile* file) const
 		delete [] colorMap;
 	}
 
-	// read image
-
-	u8* data = 0;
+	// read image in strips of rows, so we never need a copy of the whole file data
+	const bool flip = (header.ImageDescriptor&0x20)==0;
+	const u32 rowSize = header.ImageWidth * header.PixelDepth/8;
+	const u32 stripRows = core::max_(IMAGE_LOADER_BLOCK_SIZE / core::max_(rowSize, 1u), 1u);
+	const long dataStart = file->getPos();
+	SRLEState rle;
+	IImage* image = 0;
 
-	if (	header.ImageType == 1 || // Uncompressed, color-mapped images.
-			header.ImageType == 2 || // Uncompressed, RGB images
-			header.ImageType == 3 // Uncompressed, black and white images
-		)
+	if (!sourceRect)
 	{
-		const s32 imageSize = header.ImageHeight * header.ImageWidth * header.PixelDepth/8;
-		data = new u8[imageSize];
-	  	file->read(data, imageSize);
-	}
-	else
-	if(header.ImageType == 10)
-	{
-		// Runlength encoded RGB images
-		data = loadCompressedImage(file, header);
+		image = new CImage(format, dim);
+		u8* strip = new u8[stripRows * rowSize];
+
+		for (u32 y=0; y<dim.Height; y+=stripRows)
+		{
+			const u32 rows = core::min_(stripRows, dim.Height - y);
+			readRows(file, header, rle, strip, rows);
+
+			// bottom-up images fill the image from the end
+			const u32 targetRow = flip ? dim.Height - y - rows : y;
+			convertRows(header, palette, strip, (u8*)image->getData() + targetRow * image->getPitch(), rows, flip);
+		}
+		delete [] strip;
 	}
 	else
 	{
-		os::Printer::log("Unsupported TGA file type", file->getFileName(), ELL_ERROR);
-		delete [] palette;
-		return 0;
-	}
-
-	IImage* image = 0;
+		CImageRowSink sink(format, dim, partRect, scaleDenom);
+		u8* converted = new u8[dim.Width * IImage::getBitsPerPixelFromFormat(format) / 8];
 
-	switch(header.PixelDepth)
-	{
-	case 8:
+		if (header.ImageType != 10)
 		{
-			if (header.ImageType==3) // grey image
+			// uncompressed rows can be read directly
+			u8* row = new u8[rowSize];
+			for (u32 y=0; y<sink.getEndRow(); ++y)
 			{
-				image = new CImage(ECF_R8G8B8,
-					core::dimension2d<u32>(header.ImageWidth, header.ImageHeight));
-				if (image)
-					CColorConverter::convert8BitTo24Bit((u8*)data,
-						(u8*)image->getData(),
-						header.ImageWidth,header.ImageHeight,
-						0, 0, (header.ImageDescriptor&0x20)==0);
+				if (!sink.wantsRow(y))
+					continue;
+				const u32 fileRow = flip ? dim.Height - 1 - y : y;
+				file->seek(dataStart + (long)fileRow * rowSize);
+				readRows(file, header, rle, row, 1);
+				convertRows(header, palette, row, converted, 1, false);
+				sink.writeRow(y, converted);
 			}
-			else
+			delete [] row;
+		}
+		else
+		{
+			u8* strip = new u8[stripRows * rowSize];
+			for (u32 fileRow=0; fileRow<dim.Height && !sink.isComplete(); fileRow+=stripRows)
 			{
-				image = new CImage(ECF_A1R5G5B5,
-					core::dimension2d<u32>(header.ImageWidth, header.ImageHeight));
-				if (image)
-					CColorConverter::convert8BitTo16Bit((u8*)data,
-						(s16*)image->getData(),
-						header.ImageWidth,header.ImageHeight,
-						(s32*) palette, 0,
-						(header.ImageDescriptor&0x20)==0);
+				const u32 rows = core::min_(stripRows, dim.Height - fileRow);
+				readRows(file, header, rle, strip, rows);
+
+				for (u32 i=0; i<rows; ++i)
+				{
+					const u32 y = flip ? dim.Height - 1 - (fileRow + i) : fileRow + i;
+					if (!sink.wantsRow(y))
+						continue;
+					convertRows(header, palette, strip + i * rowSize, converted, 1, false);
+					sink.writeRow(y, converted);
+				}
 			}
+			delete [] strip;
 		}
-		break;
-	case 16:
-		image = new CImage(ECF_A1R5G5B5,
-			core::dimension2d<u32>(header.ImageWidth, header.ImageHeight));
-		if (image)
-			CColorConverter::convert16BitTo16Bit((s16*)data,
-				(s16*)image->getData(), header.ImageWidth,	header.ImageHeight, 0, (header.ImageDescriptor&0x20)==0);
-		break;
-	case 24:
-			image = new CImage(ECF_R8G8B8,
-				core::dimension2d<u32>(header.ImageWidth, header.ImageHeight));
-			if (image)
-				CColorConverter::convert24BitTo24Bit(
-					(u8*)data, (u8*)image->getData(), header.ImageWidth, header.ImageHeight, 0, (header.ImageDescriptor&0x20)==0, true);
-		break;
-	case 32:
-			image = new CImage(ECF_A8R8G8B8,
-				core::dimension2d<u32>(header.ImageWidth, header.ImageHeight));
-			if (image)
-				CColorConverter::convert32BitTo32Bit((s32*)data,
-					(s32*)image->getData(), header.ImageWidth, header.ImageHeight, 0, (header.ImageDescriptor&0x20)==0);
-		break;
-	default:
-		os::Printer::log("Unsupported TGA format", file->getFileName(), ELL_ERROR);
-		break;
+
+		delete [] converted;
+		image = sink.grabImage();
 	}
 
-	delete [] data;
 	delete [] palette;
 
 	return image;
@@ -67,10 +67,36 @@ public:
 	//! creates a surface from the file
 	virtual IImage* loadImage(io::IReadFile* file) const _IRR_OVERRIDE_;
 
+	//! tgas are decoded in strips of rows, uncompressed ones only read the needed rows
+	virtual bool isImagePartLoadingSupported() const _IRR_OVERRIDE_
+	{
+		return true;
+	}
+
+	//! creates a surface from a part of the file
+	virtual IImage* loadImagePart(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom) const _IRR_OVERRIDE_;
+
 private:
 
-	//! loads a compressed tga. Was written and sent in by Jon Pry, thank you very much!
-	u8* loadCompressedImage(io::IReadFile *file, const STGAHeader& header) const;
+	//! state of the run length decoding which is kept between strips
+	struct SRLEState
+	{
+		SRLEState() : Count(0), Run(false) {}
+
+		u32 Count;
+		bool Run;
+		u8 Pixel[4];
+	};
+
+	//! decodes the whole image when sourceRect is 0, otherwise only the requested part
+	IImage* decodeImage(io::IReadFile* file, const core::rect<s32>* sourceRect, u32 scaleDenom) const;
+
+	//! reads the next rows in file order, decompressing them if needed.
+	//! RLE decompression was written and sent in by Jon Pry, thank you very much!
+	void readRows(io::IReadFile *file, const STGAHeader& header, SRLEState& rle, u8* out, u32 rows) const;
+
+	//! converts rows in file order into the image format
+	void convertRows(const STGAHeader& header, const u32* palette, const u8* in, u8* out, u32 rows, bool flip) const;
 };
 
 #endif // compiled with loader
@@ -13,6 +13,8 @@
 #include "IFileSystem.h"
 #include "IReadFile.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -73,6 +75,7 @@ bool CImageLoaderLMP::isALoadableFileFormat(irr::io::IReadFile* file) const
 */
 IImage* CImageLoaderLMP::loadImage(irr::io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_WAL);)
 	SLMPHeader header;
 
 	file->seek(0);
@@ -162,6 +165,7 @@ bool CImageLoaderWAL2::isALoadableFileFormat(irr::io::IReadFile* file) const
 */
 IImage* CImageLoaderWAL2::loadImage(irr::io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_WAL);)
 	miptex_halflife header;
 
 	file->seek(0);
@@ -239,6 +243,7 @@ bool CImageLoaderWAL::isALoadableFileFormat(irr::io::IReadFile* file) const
 */
 IImage* CImageLoaderWAL::loadImage(irr::io::IReadFile* file) const
 {
+	IRR_PROFILE(CProfileScope p1(EPID_IL_WAL);)
 	miptex_quake2 header;
 
 	file->seek(0);
@@ -0,0 +1,128 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IMAGE_ROW_SINK_H_INCLUDED__
+#define __C_IMAGE_ROW_SINK_H_INCLUDED__
+
+#include "IImageLoader.h"
+#include "CImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Upper limit for the temporary buffers image loaders use while streaming from a file
+const u32 IMAGE_LOADER_BLOCK_SIZE = 65536;
+
+//! Collects the rows of a decoded image which belong to a requested image part.
+/** Used by the image loaders to implement IImageLoader::loadImagePart.
+Loaders decode rows of the full image width (in the color format of the
+target image) and pass on those for which wantsRow() returns true.
+Downscaling is done by point sampling every step-th pixel of every step-th
+row, loaders which can decode at a lower resolution themselves do so and
+pass a smaller step. */
+class CImageRowSink
+{
+public:
+
+	//! constructor
+	/** \param format Color format of the rows passed to writeRow.
+	\param decodedSize Size of the image as decoded by the loader.
+	\param partRect Requested area, in pixels of the final downscaled image (see getImagePartRect).
+	\param step Downscaling which is still left to do on the decoded rows. */
+	CImageRowSink(ECOLOR_FORMAT format, const core::dimension2d<u32>& decodedSize,
+			const core::rect<s32>& partRect, u32 step)
+		: Image(0), DecodedSize(decodedSize), PartRect(partRect), Step(step ? step : 1),
+		BytesPerPixel(IImage::getBitsPerPixelFromFormat(format) / 8), RowsLeft(0)
+	{
+		if (PartRect.getWidth() > 0 && PartRect.getHeight() > 0)
+		{
+			Image = new CImage(format, core::dimension2d<u32>(PartRect.getWidth(), PartRect.getHeight()));
+			RowsLeft = Image->getDimension().Height;
+		}
+	}
+
+	//! destructor
+	~CImageRowSink()
+	{
+		if (Image)
+			Image->drop();
+	}
+
+	//! Returns true when the row y of the decoded image is needed
+	bool wantsRow(u32 y) const
+	{
+		if (!Image || y % Step)
+			return false;
+		const s32 row = (s32)(y / Step);
+		return row >= PartRect.UpperLeftCorner.Y && row < PartRect.LowerRightCorner.Y;
+	}
+
+	//! Returns the first decoded row after which no more rows are needed
+	u32 getEndRow() const
+	{
+		return core::min_((u32)PartRect.LowerRightCorner.Y * Step, DecodedSize.Height);
+	}
+
+	//! Returns true when all rows of the image part have been written
+	bool isComplete() const
+	{
+		return RowsLeft == 0;
+	}
+
+	//! Stores the part of a decoded row which falls into the image part
+	/** \param y Index of the row in the decoded image, wantsRow(y) must be true.
+	\param row Full width row in the color format of the target image. */
+	void writeRow(u32 y, const void* row)
+	{
+		const u8* in = (const u8*)row;
+		u8* out = (u8*)Image->getData() + (y / Step - PartRect.UpperLeftCorner.Y) * Image->getPitch();
+		const u32 width = Image->getDimension().Width;
+		const u32 lastX = DecodedSize.Width ? DecodedSize.Width - 1 : 0;
+
+		if (Step == 1)
+			memcpy(out, in + PartRect.UpperLeftCorner.X * BytesPerPixel, width * BytesPerPixel);
+		else
+		{
+			for (u32 x = 0; x < width; ++x)
+			{
+				const u32 srcX = core::min_((PartRect.UpperLeftCorner.X + x) * Step, lastX);
+				memcpy(out + x * BytesPerPixel, in + srcX * BytesPerPixel, BytesPerPixel);
+			}
+		}
+
+		if (RowsLeft)
+			--RowsLeft;
+	}
+
+	//! Hands the finished image over to the caller
+	/** \return The image part, or 0 when the part was empty or incomplete. */
+	IImage* grabImage()
+	{
+		IImage* result = 0;
+		if (isComplete())
+		{
+			result = Image;
+			Image = 0;
+		}
+		return result;
+	}
+
+private:
+
+	IImage* Image;
+	core::dimension2d<u32> DecodedSize;
+	core::rect<s32> PartRect;
+	u32 Step;
+	u32 BytesPerPixel;
+	u32 RowsLeft;
+};
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,123 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageWriterPVR.h"
+
+#ifdef _IRR_COMPILE_WITH_PVR_WRITER_
+
+#include "CImageLoaderPVR.h"
+#include "IWriteFile.h"
+#include "irrString.h"
+#include "os.h"
+
+namespace irr
+{
+namespace video
+{
+
+IImageWriter* createImageWriterPVR()
+{
+	return new CImageWriterPVR;
+}
+
+CImageWriterPVR::CImageWriterPVR()
+{
+#ifdef _DEBUG
+	setDebugName("CImageWriterPVR");
+#endif
+}
+
+bool CImageWriterPVR::isAWriteableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension ( filename, "pvr" );
+}
+
+bool CImageWriterPVR::writeImage(io::IWriteFile *file, IImage *image,u32 param) const
+{
+	u64 pixelFormat = 0;
+	switch (image->getColorFormat())
+	{
+	case ECF_A1R5G5B5:
+		pixelFormat = 0x505050162677261ULL;
+		break;
+	case ECF_R5G6B5:
+		pixelFormat = 0x5060500626772ULL;
+		break;
+	case ECF_R8G8B8:
+		pixelFormat = 0x8080800626772ULL;
+		break;
+	case ECF_A8R8G8B8:
+		pixelFormat = 0x808080861726762ULL;
+		break;
+	case ECF_ETC1:
+		pixelFormat = 6;
+		break;
+	case ECF_DXT1:
+		pixelFormat = 7;
+		break;
+	case ECF_DXT3:
+		pixelFormat = 9;
+		break;
+	case ECF_DXT5:
+		pixelFormat = 11;
+		break;
+	case ECF_ETC2_RGB:
+		pixelFormat = 22;
+		break;
+	case ECF_ETC2_ARGB:
+		pixelFormat = 23;
+		break;
+	default:
+		os::Printer::log("PVR writer does not support this color format.", ELL_WARNING);
+		return false;
+	}
+
+	const core::dimension2du& size = image->getDimension();
+
+	// size of all levels below level 0, they follow each other in the file and in the image
+	u32 mipMapCount = 1;
+	u32 mipMapsDataSize = 0;
+	if (image->getMipMapsData())
+	{
+		core::dimension2du mipSize(size);
+		while (mipSize.Width > 1 || mipSize.Height > 1)
+		{
+			mipSize = IImage::getMipMapsSize(mipSize, 1);
+			mipMapsDataSize += IImage::getDataSizeFromFormat(image->getColorFormat(), mipSize.Width, mipSize.Height);
+			++mipMapCount;
+		}
+	}
+
+	SPVRHeader header;
+	header.Version = 0x03525650;
+	header.Flags = 0;
+	header.PixelFormat = pixelFormat;
+	header.ColourSpace = 0;
+	header.ChannelType = 0;
+	header.Height = size.Height;
+	header.Width = size.Width;
+	header.Depth = 1;
+	header.NumSurfaces = 1;
+	header.NumFaces = 1;
+	header.MipMapCount = mipMapCount;
+	header.MetDataSize = 0;
+
+	if (file->write(&header, sizeof(SPVRHeader)) != sizeof(SPVRHeader))
+		return false;
+
+	const u32 dataSize = image->getImageDataSizeInBytes();
+	if (file->write(image->getData(), dataSize) != (size_t)dataSize)
+		return false;
+
+	if (mipMapsDataSize && file->write(image->getMipMapsData(), mipMapsDataSize) != (size_t)mipMapsDataSize)
+		return false;
+
+	return true;
+}
+
+} // namespace video
+} // namespace irr
+
+#endif
+
@@ -0,0 +1,542 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_MESH_LOADER_
+
+#include "CIrrBinMeshFileLoader.h"
+#include "CMeshTextureLoader.h"
+#include "ISceneManager.h"
+#include "IReadFile.h"
+#include "SAnimatedMesh.h"
+#include "SMesh.h"
+#include "SMeshBuffer.h"
+#include "SMeshBufferLightMap.h"
+#include "SMeshBufferTangents.h"
+#include "CDynamicMeshBuffer.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
+#include "os.h"
+
+#ifdef _IRR_COMPILE_WITH_SKINNED_MESH_SUPPORT_
+#include "CSkinnedMesh.h"
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	//! converts the 32 bit values of records from the byte order of the file
+	void swapRecords(void* data, u32 size)
+	{
+#ifdef __BIG_ENDIAN__
+		u32* words = (u32*)data;
+		for (u32 i=0; i<size/4; ++i)
+			words[i] = os::Byteswap::byteswap(words[i]);
+#endif
+	}
+
+	//! the boolean material flags, stored as bits in SIrrBinMeshMaterial::Flags
+	const video::E_MATERIAL_FLAG materialFlags[] =
+	{
+		video::EMF_WIREFRAME, video::EMF_POINTCLOUD, video::EMF_GOURAUD_SHADING,
+		video::EMF_LIGHTING, video::EMF_BACK_FACE_CULLING, video::EMF_FRONT_FACE_CULLING,
+		video::EMF_FOG_ENABLE, video::EMF_NORMALIZE_NORMALS, video::EMF_USE_MIP_MAPS
+	};
+
+	//! true when count records of the given size fit into the file after the offset
+	bool fits(u32 offset, u32 count, u32 size, u32 fileSize)
+	{
+		return !count || (offset <= fileSize && count <= (fileSize - offset) / size);
+	}
+}
+
+
+//! Constructor
+CIrrBinMeshFileLoader::CIrrBinMeshFileLoader(ISceneManager* smgr)
+	: SceneManager(smgr)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrBinMeshFileLoader");
+	#endif
+
+	TextureLoader = new CMeshTextureLoader(SceneManager->getFileSystem(), SceneManager->getVideoDriver());
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".cob")
+bool CIrrBinMeshFileLoader::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "irrbinmesh");
+}
+
+
+//! creates/loads an animated mesh from the file.
+//! \return Pointer to the created mesh. Returns 0 if loading failed.
+//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+//! See IReferenceCounted::drop() for more information.
+IAnimatedMesh* CIrrBinMeshFileLoader::createMesh(io::IReadFile* file)
+{
+	IRR_PROFILE(CProfileScope p1(EPID_ML_IRR_BIN_MESH);)
+	if (!file)
+		return 0;
+
+	SReadState state;
+	state.File = file;
+	state.Start = file->getPos();
+	const long size = file->getSize() - state.Start;
+	if (size < (long)sizeof(SIrrBinMeshHeader))
+	{
+		os::Printer::log("Mesh file is too small", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+	state.Size = (u32)size;
+
+	SIrrBinMeshHeader header;
+	if (file->read(&header, sizeof(header)) != sizeof(header))
+		return 0;
+	swapRecords(&header.Version, sizeof(header) - 4);
+
+	if (memcmp(header.Magic, IRRBINMESH_MAGIC, 4))
+	{
+		os::Printer::log("Not a cooked mesh file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (header.Version > IRRBINMESH_VERSION)
+	{
+		os::Printer::log("Unsupported version of cooked mesh file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	// each string takes at least 5 bytes
+	if (!fits(header.StringTableOffset, header.StringTableSize, 1, state.Size) ||
+		header.StringCount > header.StringTableSize / 5 ||
+		!fits(header.MaterialOffset, header.MaterialCount, sizeof(SIrrBinMeshMaterial), state.Size) ||
+		!fits(header.BufferOffset, header.BufferCount, sizeof(SIrrBinMeshBuffer), state.Size) ||
+		!fits(header.JointOffset, header.JointCount, sizeof(SIrrBinMeshJoint), state.Size))
+	{
+		os::Printer::log("Cooked mesh file is corrupt", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (getMeshTextureLoader())
+		getMeshTextureLoader()->setMeshFile(file);
+
+	readStrings(state, header);
+	if (!state.Failed)
+		readMaterials(state, header);
+
+	core::array<SIrrBinMeshBuffer> buffers;
+	buffers.set_used(header.BufferCount);
+	readStream(state, header.BufferOffset, buffers.pointer(), header.BufferCount * sizeof(SIrrBinMeshBuffer), 4);
+	for (u32 i=0; i<buffers.size() && !state.Failed; ++i)
+	{
+		const SIrrBinMeshBuffer& buffer = buffers[i];
+		if (buffer.VertexType > video::EVT_TANGENTS || buffer.IndexType > video::EIT_32BIT ||
+			buffer.PrimitiveType > EPT_POINT_SPRITES || buffer.Material >= state.Materials.size() ||
+			buffer.MappingHintVertex > EHM_STREAM || buffer.MappingHintIndex > EHM_STREAM ||
+			!fits(buffer.VertexOffset, buffer.VertexCount, video::getVertexPitchFromType((video::E_VERTEX_TYPE)buffer.VertexType), state.Size) ||
+			!fits(buffer.IndexOffset, buffer.IndexCount, buffer.IndexType == video::EIT_16BIT ? 2 : 4, state.Size))
+			state.Failed = true;
+	}
+
+	IAnimatedMesh* mesh = 0;
+	if (!state.Failed)
+	{
+		if (header.Flags & EIBMF_SKINNED)
+			mesh = createSkinnedMesh(state, header, buffers);
+		else
+			mesh = createStaticMesh(state, header, buffers);
+	}
+
+	if (!mesh)
+		os::Printer::log("Cooked mesh file is corrupt", file->getFileName(), ELL_ERROR);
+
+	return mesh;
+}
+
+
+//! reads size bytes at the offset of the file into data
+void CIrrBinMeshFileLoader::readStream(SReadState& state, u32 offset, void* data, u32 size, u32 swapSize) const
+{
+	if (state.Failed || !size)
+		return;
+
+	if (!fits(offset, size, 1, state.Size) || !state.File->seek(state.Start + offset) ||
+		state.File->read(data, size) != (size_t)size)
+	{
+		state.Failed = true;
+		return;
+	}
+
+#ifdef __BIG_ENDIAN__
+	if (swapSize == 2)
+	{
+		u16* values = (u16*)data;
+		for (u32 i=0; i<size/2; ++i)
+			values[i] = os::Byteswap::byteswap(values[i]);
+	}
+	else
+		swapRecords(data, size);
+#endif
+}
+
+
+//! reads the string table
+void CIrrBinMeshFileLoader::readStrings(SReadState& state, const SIrrBinMeshHeader& header) const
+{
+	state.StringData.set_used(header.StringTableSize);
+	readStream(state, header.StringTableOffset, state.StringData.pointer(), header.StringTableSize, 1);
+
+	// the strings are used directly from the table
+	state.Strings.reallocate(header.StringCount);
+	u32 pos = 0;
+	for (u32 i=0; i<header.StringCount && !state.Failed; ++i)
+	{
+		if (header.StringTableSize - pos < 4)
+		{
+			state.Failed = true;
+			break;
+		}
+		u32 length;
+		memcpy(&length, &state.StringData[pos], 4);
+		swapRecords(&length, 4);
+		pos += 4;
+
+		if (length >= header.StringTableSize - pos || state.StringData[pos + length])
+		{
+			state.Failed = true;
+			break;
+		}
+		state.Strings.push_back(&state.StringData[pos]);
+		pos += length + 1;
+	}
+}
+
+
+//! reads the materials and gets their textures
+void CIrrBinMeshFileLoader::readMaterials(SReadState& state, const SIrrBinMeshHeader& header)
+{
+	state.Textures.set_used(state.Strings.size());
+	state.TexturesLoaded.set_used(state.Strings.size());
+	for (u32 i=0; i<state.Strings.size(); ++i)
+	{
+		state.Textures[i] = 0;
+		state.TexturesLoaded[i] = false;
+	}
+
+	state.Materials.reallocate(header.MaterialCount);
+	u32 offset = header.MaterialOffset;
+	for (u32 i=0; i<header.MaterialCount && !state.Failed; ++i)
+	{
+		SIrrBinMeshMaterial record;
+		readStream(state, offset, &record, sizeof(record), 4);
+		offset += sizeof(record);
+		if (state.Failed || !fits(offset, record.LayerCount, sizeof(SIrrBinMeshMaterialLayer), state.Size))
+		{
+			state.Failed = true;
+			break;
+		}
+
+		video::SMaterial material;
+		material.MaterialType = (video::E_MATERIAL_TYPE)record.MaterialType;
+		material.AmbientColor.color = record.AmbientColor;
+		material.DiffuseColor.color = record.DiffuseColor;
+		material.EmissiveColor.color = record.EmissiveColor;
+		material.SpecularColor.color = record.SpecularColor;
+		material.Shininess = record.Shininess;
+		material.MaterialTypeParam = record.MaterialTypeParam;
+		material.MaterialTypeParam2 = record.MaterialTypeParam2;
+		material.Thickness = record.Thickness;
+		material.ZBuffer = (u8)record.ZBuffer;
+		material.AntiAliasing = (u8)record.AntiAliasing;
+		material.ColorMask = record.ColorMask;
+		material.ColorMaterial = record.ColorMaterial;
+		material.BlendOperation = (video::E_BLEND_OPERATION)record.BlendOperation;
+		material.BlendFactor = record.BlendFactor;
+		material.PolygonOffsetFactor = record.PolygonOffsetFactor;
+		material.PolygonOffsetDirection = (video::E_POLYGON_OFFSET)record.PolygonOffsetDirection;
+		material.PolygonOffsetDepthBias = record.PolygonOffsetDepthBias;
+		material.PolygonOffsetSlopeScale = record.PolygonOffsetSlopeScale;
+		material.ZWriteEnable = (video::E_ZWRITE)record.ZWriteEnable;
+		for (u32 j=0; j<sizeof(materialFlags)/sizeof(materialFlags[0]); ++j)
+			material.setFlag(materialFlags[j], (record.Flags & materialFlags[j]) != 0);
+
+		// layers which this build of the engine does not have are skipped
+		for (u32 j=0; j<record.LayerCount && !state.Failed; ++j)
+		{
+			SIrrBinMeshMaterialLayer layerRecord;
+			readStream(state, offset, &layerRecord, sizeof(layerRecord), 4);
+			offset += sizeof(layerRecord);
+			if (state.Failed || j >= video::MATERIAL_MAX_TEXTURES)
+				continue;
+
+			video::SMaterialLayer& layer = material.TextureLayer[j];
+			const u32 texture = layerRecord.Texture;
+			if (texture != IRRBINMESH_NO_INDEX)
+			{
+				if (texture >= state.Strings.size())
+				{
+					state.Failed = true;
+					break;
+				}
+				if (!state.TexturesLoaded[texture])
+				{
+					state.TexturesLoaded[texture] = true;
+					if (getMeshTextureLoader())
+						state.Textures[texture] = getMeshTextureLoader()->getTexture(state.Strings[texture]);
+					if (!state.Textures[texture])
+						os::Printer::log("Could not load texture", state.Strings[texture], ELL_WARNING);
+				}
+				layer.Texture = state.Textures[texture];
+			}
+			layer.TextureWrapU = layerRecord.TextureWrapU;
+			layer.TextureWrapV = layerRecord.TextureWrapV;
+			layer.TextureWrapW = layerRecord.TextureWrapW;
+			layer.BilinearFilter = layerRecord.BilinearFilter != 0;
+			layer.TrilinearFilter = layerRecord.TrilinearFilter != 0;
+			layer.AnisotropicFilter = (u8)layerRecord.AnisotropicFilter;
+			layer.LODBias = (s8)layerRecord.LODBias;
+
+			core::matrix4 textureMatrix(core::matrix4::EM4CONST_NOTHING);
+			textureMatrix.setM(layerRecord.TextureMatrix);
+			if (!textureMatrix.isIdentity())
+				layer.setTextureMatrix(textureMatrix);
+		}
+
+		state.Materials.push_back(material);
+	}
+}
+
+
+//! reads the vertices and indices of a buffer into the mesh buffer
+void CIrrBinMeshFileLoader::readBuffer(SReadState& state, const SIrrBinMeshBuffer& buffer, IMeshBuffer* mb) const
+{
+	readStream(state, buffer.VertexOffset, mb->getVertices(),
+		buffer.VertexCount * video::getVertexPitchFromType(mb->getVertexType()), 4);
+	const u32 indexSize = (buffer.IndexType == video::EIT_16BIT) ? 2 : 4;
+	readStream(state, buffer.IndexOffset, mb->getIndices(), buffer.IndexCount * indexSize, indexSize);
+
+	mb->getMaterial() = state.Materials[buffer.Material];
+	mb->setPrimitiveType((E_PRIMITIVE_TYPE)buffer.PrimitiveType);
+	mb->setHardwareMappingHint((E_HARDWARE_MAPPING)buffer.MappingHintVertex, EBT_VERTEX);
+	mb->setHardwareMappingHint((E_HARDWARE_MAPPING)buffer.MappingHintIndex, EBT_INDEX);
+
+	const f32* box = buffer.BoundingBox;
+	mb->setBoundingBox(core::aabbox3df(box[0], box[1], box[2], box[3], box[4], box[5]));
+}
+
+
+//! creates a static mesh from the buffers
+IAnimatedMesh* CIrrBinMeshFileLoader::createStaticMesh(SReadState& state, const SIrrBinMeshHeader& header,
+	const core::array<SIrrBinMeshBuffer>& buffers)
+{
+	SMesh* mesh = new SMesh();
+
+	for (u32 i=0; i<buffers.size() && !state.Failed; ++i)
+	{
+		const SIrrBinMeshBuffer& buffer = buffers[i];
+		IMeshBuffer* mb = 0;
+
+		if (buffer.IndexType == video::EIT_16BIT)
+		{
+			switch (buffer.VertexType)
+			{
+			case video::EVT_STANDARD:
+				{
+					SMeshBuffer* b = new SMeshBuffer();
+					b->Vertices.set_used(buffer.VertexCount);
+					b->Indices.set_used(buffer.IndexCount);
+					mb = b;
+				}
+				break;
+			case video::EVT_2TCOORDS:
+				{
+					SMeshBufferLightMap* b = new SMeshBufferLightMap();
+					b->Vertices.set_used(buffer.VertexCount);
+					b->Indices.set_used(buffer.IndexCount);
+					mb = b;
+				}
+				break;
+			case video::EVT_TANGENTS:
+				{
+					SMeshBufferTangents* b = new SMeshBufferTangents();
+					b->Vertices.set_used(buffer.VertexCount);
+					b->Indices.set_used(buffer.IndexCount);
+					mb = b;
+				}
+				break;
+			}
+		}
+		else
+		{
+			CDynamicMeshBuffer* b = new CDynamicMeshBuffer((video::E_VERTEX_TYPE)buffer.VertexType, video::EIT_32BIT);
+			b->getVertexBuffer().set_used(buffer.VertexCount);
+			b->getIndexBuffer().set_used(buffer.IndexCount);
+			mb = b;
+		}
+
+		readBuffer(state, buffer, mb);
+		mesh->addMeshBuffer(mb);
+		mb->drop();
+	}
+
+	if (state.Failed)
+	{
+		mesh->drop();
+		return 0;
+	}
+
+	const f32* box = header.BoundingBox;
+	mesh->setBoundingBox(core::aabbox3df(box[0], box[1], box[2], box[3], box[4], box[5]));
+
+	SAnimatedMesh* animatedMesh = new SAnimatedMesh(mesh);
+	mesh->drop();
+	return animatedMesh;
+}
+
+
+//! creates a skinned mesh from the buffers and joints
+IAnimatedMesh* CIrrBinMeshFileLoader::createSkinnedMesh(SReadState& state, const SIrrBinMeshHeader& header,
+	const core::array<SIrrBinMeshBuffer>& buffers)
+{
+#ifdef _IRR_COMPILE_WITH_SKINNED_MESH_SUPPORT_
+	CSkinnedMesh* mesh = new CSkinnedMesh();
+
+	for (u32 i=0; i<buffers.size() && !state.Failed; ++i)
+	{
+		const SIrrBinMeshBuffer& buffer = buffers[i];
+		// skinned mesh buffers only have 16 bit indices
+		if (buffer.IndexType != video::EIT_16BIT)
+		{
+			state.Failed = true;
+			break;
+		}
+
+		SSkinMeshBuffer* mb = mesh->addMeshBuffer();
+		mb->VertexType = (video::E_VERTEX_TYPE)buffer.VertexType;
+		switch (mb->VertexType)
+		{
+		case video::EVT_STANDARD:
+			mb->Vertices_Standard.set_used(buffer.VertexCount);
+			break;
+		case video::EVT_2TCOORDS:
+			mb->Vertices_2TCoords.set_used(buffer.VertexCount);
+			break;
+		case video::EVT_TANGENTS:
+			mb->Vertices_Tangents.set_used(buffer.VertexCount);
+			break;
+		}
+		mb->Indices.set_used(buffer.IndexCount);
+
+		readBuffer(state, buffer, mb);
+		mb->Transformation.setM(buffer.Transformation);
+	}
+
+	core::array<SIrrBinMeshJoint> records;
+	records.set_used(header.JointCount);
+	readStream(state, header.JointOffset, records.pointer(), header.JointCount * sizeof(SIrrBinMeshJoint), 4);
+
+	core::array<ISkinnedMesh::SJoint*>& joints = mesh->getAllJoints();
+	for (u32 i=0; i<records.size() && !state.Failed; ++i)
+		mesh->addJoint(0);
+
+	core::array<u32> weights;
+	for (u32 i=0; i<records.size() && !state.Failed; ++i)
+	{
+		const SIrrBinMeshJoint& record = records[i];
+		ISkinnedMesh::SJoint* joint = joints[i];
+
+		if (record.Name >= state.Strings.size() ||
+			(record.Parent != IRRBINMESH_NO_INDEX && record.Parent >= records.size()) ||
+			!fits(record.AttachedMeshOffset, record.AttachedMeshCount, 4, state.Size) ||
+			!fits(record.PositionKeyOffset, record.PositionKeyCount, sizeof(ISkinnedMesh::SPositionKey), state.Size) ||
+			!fits(record.ScaleKeyOffset, record.ScaleKeyCount, sizeof(ISkinnedMesh::SScaleKey), state.Size) ||
+			!fits(record.RotationKeyOffset, record.RotationKeyCount, sizeof(ISkinnedMesh::SRotationKey), state.Size) ||
+			!fits(record.WeightOffset, record.WeightCount, 12, state.Size))
+		{
+			state.Failed = true;
+			break;
+		}
+
+		// a joint must not be its own ancestor
+		u32 parent = record.Parent;
+		for (u32 depth=0; parent != IRRBINMESH_NO_INDEX; ++depth)
+		{
+			if (depth == records.size())
+			{
+				state.Failed = true;
+				break;
+			}
+			parent = records[parent].Parent;
+		}
+		if (state.Failed)
+			break;
+		if (record.Parent != IRRBINMESH_NO_INDEX)
+			joints[record.Parent]->Children.push_back(joint);
+
+		joint->Name = state.Strings[record.Name];
+		joint->LocalMatrix.setM(record.LocalMatrix);
+		joint->GlobalInversedMatrix.setM(record.GlobalInversedMatrix);
+
+		joint->AttachedMeshes.set_used(record.AttachedMeshCount);
+		readStream(state, record.AttachedMeshOffset, joint->AttachedMeshes.pointer(), record.AttachedMeshCount * 4, 4);
+		for (u32 j=0; j<joint->AttachedMeshes.size(); ++j)
+		{
+			if (joint->AttachedMeshes[j] >= buffers.size())
+				state.Failed = true;
+		}
+
+		// the keys have the same layout in the file and in memory
+		joint->PositionKeys.set_used(record.PositionKeyCount);
+		readStream(state, record.PositionKeyOffset, joint->PositionKeys.pointer(),
+			record.PositionKeyCount * sizeof(ISkinnedMesh::SPositionKey), 4);
+		joint->ScaleKeys.set_used(record.ScaleKeyCount);
+		readStream(state, record.ScaleKeyOffset, joint->ScaleKeys.pointer(),
+			record.ScaleKeyCount * sizeof(ISkinnedMesh::SScaleKey), 4);
+		joint->RotationKeys.set_used(record.RotationKeyCount);
+		readStream(state, record.RotationKeyOffset, joint->RotationKeys.pointer(),
+			record.RotationKeyCount * sizeof(ISkinnedMesh::SRotationKey), 4);
+
+		// the weights have cached data for skinning, finalize checks the ids
+		weights.set_used(record.WeightCount * 3);
+		readStream(state, record.WeightOffset, weights.pointer(), record.WeightCount * 12, 4);
+		joint->Weights.reallocate(record.WeightCount);
+		for (u32 j=0; j<record.WeightCount && !state.Failed; ++j)
+		{
+			ISkinnedMesh::SWeight weight;
+			weight.buffer_id = (u16)core::min_(weights[j*3], (u32)0xffff);
+			weight.vertex_id = weights[j*3+1];
+			memcpy(&weight.strength, &weights[j*3+2], 4);
+			joint->Weights.push_back(weight);
+		}
+	}
+
+	if (state.Failed)
+	{
+		mesh->drop();
+		return 0;
+	}
+
+	mesh->setAnimationSpeed(header.AnimationSpeed);
+	mesh->finalize();
+	return mesh;
+#else
+	os::Printer::log("Skinned meshes are not supported by this build of the engine", state.File->getFileName(), ELL_ERROR);
+	return 0;
+#endif
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BIN_MESH_LOADER_
+
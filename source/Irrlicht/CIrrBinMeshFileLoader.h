@@ -0,0 +1,96 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IRR_BIN_MESH_FILE_LOADER_H_INCLUDED__
+#define __C_IRR_BIN_MESH_FILE_LOADER_H_INCLUDED__
+
+#include "IMeshLoader.h"
+#include "SIrrBinMesh.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace video
+{
+	struct SMaterial;
+	class ITexture;
+}
+
+namespace scene
+{
+
+class ISceneManager;
+class IMeshBuffer;
+
+//! Meshloader for cooked binary .irrbinmesh meshes, see SIrrBinMesh.h
+/** The streams of the file are read with one read each straight into the
+arrays of the mesh buffers and joints, which is a plain copy for memory
+files and no parsing for any file. */
+class CIrrBinMeshFileLoader : public IMeshLoader
+{
+public:
+
+	//! Constructor
+	CIrrBinMeshFileLoader(ISceneManager* smgr);
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".cob")
+	virtual bool isALoadableFileExtension(const io::path& filename) const _IRR_OVERRIDE_;
+
+	//! creates/loads an animated mesh from the file.
+	//! \return Pointer to the created mesh. Returns 0 if loading failed.
+	//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+	//! See IReferenceCounted::drop() for more information.
+	virtual IAnimatedMesh* createMesh(io::IReadFile* file) _IRR_OVERRIDE_;
+
+	//! Only gets textures from the video driver
+	virtual bool isThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
+private:
+
+	//! Data of the file which is currently loaded
+	struct SReadState
+	{
+		SReadState() : File(0), Start(0), Size(0), Failed(false) {}
+
+		io::IReadFile* File;
+		long Start;
+		u32 Size;
+		bool Failed;
+
+		core::array<c8> StringData;
+		core::array<const c8*> Strings;
+		core::array<video::SMaterial> Materials;
+		core::array<video::ITexture*> Textures;
+		core::array<bool> TexturesLoaded;
+	};
+
+	//! reads size bytes at the offset of the file into data
+	void readStream(SReadState& state, u32 offset, void* data, u32 size, u32 swapSize) const;
+
+	//! reads the string table
+	void readStrings(SReadState& state, const SIrrBinMeshHeader& header) const;
+
+	//! reads the materials and gets their textures
+	void readMaterials(SReadState& state, const SIrrBinMeshHeader& header);
+
+	//! reads the vertices and indices of a buffer into the mesh buffer
+	void readBuffer(SReadState& state, const SIrrBinMeshBuffer& buffer, IMeshBuffer* mb) const;
+
+	//! creates a static mesh from the buffers
+	IAnimatedMesh* createStaticMesh(SReadState& state, const SIrrBinMeshHeader& header,
+		const core::array<SIrrBinMeshBuffer>& buffers);
+
+	//! creates a skinned mesh from the buffers and joints
+	IAnimatedMesh* createSkinnedMesh(SReadState& state, const SIrrBinMeshHeader& header,
+		const core::array<SIrrBinMeshBuffer>& buffers);
+
+	ISceneManager* SceneManager;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,371 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_MESH_WRITER_
+
+#include "CIrrBinMeshWriter.h"
+#include "ISkinnedMesh.h"
+#include "SSkinMeshBuffer.h"
+#include "IFileSystem.h"
+#include "IWriteFile.h"
+#include "ITexture.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	//! appends size bytes to the data and returns a pointer to them
+	u8* appendBytes(core::array<u8>& data, u32 size)
+	{
+		const u32 pos = data.size();
+		// set_used alone would reallocate for each record
+		if (data.allocated_size() < pos + size)
+			data.reallocate(core::max_(pos + size, data.allocated_size() * 2));
+		data.set_used(pos + size);
+		return data.pointer() + pos;
+	}
+
+	//! converts the 32 bit values of records to the byte order of the file
+	void swapRecords(void* data, u32 size)
+	{
+#ifdef __BIG_ENDIAN__
+		u32* words = (u32*)data;
+		for (u32 i=0; i<size/4; ++i)
+			words[i] = os::Byteswap::byteswap(words[i]);
+#endif
+	}
+
+	//! the boolean material flags, stored as bits in SIrrBinMeshMaterial::Flags
+	const video::E_MATERIAL_FLAG materialFlags[] =
+	{
+		video::EMF_WIREFRAME, video::EMF_POINTCLOUD, video::EMF_GOURAUD_SHADING,
+		video::EMF_LIGHTING, video::EMF_BACK_FACE_CULLING, video::EMF_FRONT_FACE_CULLING,
+		video::EMF_FOG_ENABLE, video::EMF_NORMALIZE_NORMALS, video::EMF_USE_MIP_MAPS
+	};
+}
+
+
+//! Constructor
+CIrrBinMeshWriter::CIrrBinMeshWriter(io::IFileSystem* fs)
+	: FileSystem(fs)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrBinMeshWriter");
+	#endif
+}
+
+
+//! Returns the type of the mesh writer
+EMESH_WRITER_TYPE CIrrBinMeshWriter::getType() const
+{
+	return EMWT_IRR_BIN_MESH;
+}
+
+
+//! writes a mesh
+bool CIrrBinMeshWriter::writeMesh(io::IWriteFile* file, scene::IMesh* mesh, s32 flags)
+{
+	if (!file || !mesh)
+		return false;
+
+	os::Printer::log("Writing mesh", file->getFileName());
+
+	Strings.set_used(0);
+	StringIndices.clear();
+	Materials.set_used(0);
+	MaterialData.set_used(0);
+	Streams.set_used(0);
+	FileDir = FileSystem->getFileDir(file->getFileName());
+
+	ISkinnedMesh* skinnedMesh = 0;
+	if (mesh->getMeshType() == EAMT_SKINNED)
+		skinnedMesh = static_cast<ISkinnedMesh*>(mesh);
+
+	// the buffers, offsets are counted from the start of the streams until all sizes are known
+	const u32 bufferCount = mesh->getMeshBufferCount();
+	core::array<SIrrBinMeshBuffer> buffers;
+	buffers.set_used(bufferCount);
+	for (u32 i=0; i<bufferCount; ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		SIrrBinMeshBuffer& buffer = buffers[i];
+
+		buffer.VertexType = mb->getVertexType();
+		buffer.IndexType = mb->getIndexType();
+		buffer.PrimitiveType = mb->getPrimitiveType();
+		buffer.Material = addMaterial(mb->getMaterial());
+		buffer.MappingHintVertex = mb->getHardwareMappingHint_Vertex();
+		buffer.MappingHintIndex = mb->getHardwareMappingHint_Index();
+
+		buffer.VertexCount = mb->getVertexCount();
+		buffer.VertexOffset = addStream(mb->getVertices(),
+			buffer.VertexCount * video::getVertexPitchFromType(mb->getVertexType()), 4);
+		const u32 indexSize = (mb->getIndexType() == video::EIT_16BIT) ? 2 : 4;
+		buffer.IndexCount = mb->getIndexCount();
+		buffer.IndexOffset = addStream(mb->getIndices(), buffer.IndexCount * indexSize, indexSize);
+
+		const core::aabbox3df& box = mb->getBoundingBox();
+		memcpy(buffer.BoundingBox, &box, sizeof(buffer.BoundingBox));
+		if (skinnedMesh)
+			memcpy(buffer.Transformation, skinnedMesh->getMeshBuffers()[i]->Transformation.pointer(), sizeof(buffer.Transformation));
+		else
+			memcpy(buffer.Transformation, core::IdentityMatrix.pointer(), sizeof(buffer.Transformation));
+	}
+
+	// the joints
+	core::array<SIrrBinMeshJoint> joints;
+	if (skinnedMesh)
+	{
+		const core::array<ISkinnedMesh::SJoint*>& allJoints = skinnedMesh->getAllJoints();
+		joints.set_used(allJoints.size());
+		for (u32 i=0; i<joints.size(); ++i)
+			joints[i].Parent = IRRBINMESH_NO_INDEX;
+		for (u32 i=0; i<allJoints.size(); ++i)
+		{
+			for (u32 j=0; j<allJoints[i]->Children.size(); ++j)
+			{
+				const s32 child = allJoints.linear_search(allJoints[i]->Children[j]);
+				if (child != -1)
+					joints[child].Parent = i;
+			}
+		}
+
+		core::array<u32> weights;
+		for (u32 i=0; i<allJoints.size(); ++i)
+		{
+			const ISkinnedMesh::SJoint* joint = allJoints[i];
+			SIrrBinMeshJoint& record = joints[i];
+
+			record.Name = addString(joint->Name);
+			memcpy(record.LocalMatrix, joint->LocalMatrix.pointer(), sizeof(record.LocalMatrix));
+			memcpy(record.GlobalInversedMatrix, joint->GlobalInversedMatrix.pointer(), sizeof(record.GlobalInversedMatrix));
+
+			record.AttachedMeshCount = joint->AttachedMeshes.size();
+			record.AttachedMeshOffset = addStream(joint->AttachedMeshes.const_pointer(), record.AttachedMeshCount * 4, 4);
+			record.PositionKeyCount = joint->PositionKeys.size();
+			record.PositionKeyOffset = addStream(joint->PositionKeys.const_pointer(),
+				record.PositionKeyCount * sizeof(ISkinnedMesh::SPositionKey), 4);
+			record.ScaleKeyCount = joint->ScaleKeys.size();
+			record.ScaleKeyOffset = addStream(joint->ScaleKeys.const_pointer(),
+				record.ScaleKeyCount * sizeof(ISkinnedMesh::SScaleKey), 4);
+			record.RotationKeyCount = joint->RotationKeys.size();
+			record.RotationKeyOffset = addStream(joint->RotationKeys.const_pointer(),
+				record.RotationKeyCount * sizeof(ISkinnedMesh::SRotationKey), 4);
+
+			weights.set_used(joint->Weights.size() * 3);
+			for (u32 j=0; j<joint->Weights.size(); ++j)
+			{
+				weights[j*3] = joint->Weights[j].buffer_id;
+				weights[j*3+1] = joint->Weights[j].vertex_id;
+				memcpy(&weights[j*3+2], &joint->Weights[j].strength, 4);
+			}
+			record.WeightCount = joint->Weights.size();
+			record.WeightOffset = addStream(weights.const_pointer(), weights.size() * 4, 4);
+		}
+	}
+
+	// the string table
+	core::array<u8> stringTable;
+	for (u32 i=0; i<Strings.size(); ++i)
+	{
+		const u32 length = Strings[i].size();
+		u8* data = appendBytes(stringTable, 4 + length + 1);
+
+		u32 value = length;
+		swapRecords(&value, 4);
+		memcpy(data, &value, 4);
+		memcpy(data + 4, Strings[i].c_str(), length + 1);
+	}
+
+	SIrrBinMeshHeader header;
+	memcpy(header.Magic, IRRBINMESH_MAGIC, 4);
+	header.Version = IRRBINMESH_VERSION;
+	header.Flags = skinnedMesh ? EIBMF_SKINNED : 0;
+	header.AnimationSpeed = skinnedMesh ? skinnedMesh->getAnimationSpeed() : 0.f;
+	const core::aabbox3df& box = mesh->getBoundingBox();
+	memcpy(header.BoundingBox, &box, sizeof(header.BoundingBox));
+	header.StringTableOffset = sizeof(SIrrBinMeshHeader);
+	header.StringTableSize = stringTable.size();
+	header.StringCount = Strings.size();
+	header.MaterialOffset = header.StringTableOffset + header.StringTableSize;
+	header.MaterialCount = Materials.size();
+	header.BufferOffset = header.MaterialOffset + MaterialData.size();
+	header.BufferCount = buffers.size();
+	header.JointOffset = header.BufferOffset + buffers.size() * sizeof(SIrrBinMeshBuffer);
+	header.JointCount = joints.size();
+
+	const u32 tablesEnd = header.JointOffset + joints.size() * sizeof(SIrrBinMeshJoint);
+	const u32 streamsOffset = alignIrrBinMeshOffset(tablesEnd);
+
+	// move the offsets to the start of the streams
+	for (u32 i=0; i<buffers.size(); ++i)
+	{
+		buffers[i].VertexOffset += streamsOffset;
+		buffers[i].IndexOffset += streamsOffset;
+	}
+	for (u32 i=0; i<joints.size(); ++i)
+	{
+		joints[i].AttachedMeshOffset += streamsOffset;
+		joints[i].PositionKeyOffset += streamsOffset;
+		joints[i].ScaleKeyOffset += streamsOffset;
+		joints[i].RotationKeyOffset += streamsOffset;
+		joints[i].WeightOffset += streamsOffset;
+	}
+
+	swapRecords(&header.Version, sizeof(header) - 4);
+	swapRecords(buffers.pointer(), buffers.size() * sizeof(SIrrBinMeshBuffer));
+	swapRecords(joints.pointer(), joints.size() * sizeof(SIrrBinMeshJoint));
+
+	const u8 padding[IRRBINMESH_ALIGNMENT] = { 0 };
+	bool result = file->write(&header, sizeof(header)) == sizeof(header);
+	if (result && stringTable.size())
+		result = file->write(stringTable.const_pointer(), stringTable.size()) == (size_t)stringTable.size();
+	if (result && MaterialData.size())
+		result = file->write(MaterialData.const_pointer(), MaterialData.size()) == (size_t)MaterialData.size();
+	if (result && buffers.size())
+		result = file->write(buffers.const_pointer(), buffers.size() * sizeof(SIrrBinMeshBuffer)) == buffers.size() * sizeof(SIrrBinMeshBuffer);
+	if (result && joints.size())
+		result = file->write(joints.const_pointer(), joints.size() * sizeof(SIrrBinMeshJoint)) == joints.size() * sizeof(SIrrBinMeshJoint);
+	if (result && streamsOffset != tablesEnd)
+		result = file->write(padding, streamsOffset - tablesEnd) == (size_t)(streamsOffset - tablesEnd);
+	if (result && Streams.size())
+		result = file->write(Streams.const_pointer(), Streams.size()) == (size_t)Streams.size();
+
+	if (!result)
+		os::Printer::log("Could not write mesh file", file->getFileName(), ELL_ERROR);
+
+	// free the memory of big meshes again
+	Strings.clear();
+	StringIndices.clear();
+	Materials.clear();
+	MaterialData.clear();
+	Streams.clear();
+
+	return result;
+}
+
+
+//! returns the index of the string in the string table, adds it when needed
+u32 CIrrBinMeshWriter::addString(const core::stringc& str)
+{
+	core::map<core::stringc, u32>::Node* node = StringIndices.find(str);
+	if (node)
+		return node->getValue();
+
+	const u32 index = Strings.size();
+	Strings.push_back(str);
+	StringIndices.insert(str, index);
+	return index;
+}
+
+
+//! returns the index of the material, adds it when needed
+u32 CIrrBinMeshWriter::addMaterial(const video::SMaterial& material)
+{
+	for (u32 i=0; i<Materials.size(); ++i)
+	{
+		if (*Materials[i] == material)
+			return i;
+	}
+	Materials.push_back(&material);
+
+	// only the layers up to the last one which is used are written
+	const video::SMaterialLayer defaultLayer;
+	u32 layerCount = video::MATERIAL_MAX_TEXTURES;
+	while (layerCount && material.TextureLayer[layerCount-1] == defaultLayer)
+		--layerCount;
+
+	SIrrBinMeshMaterial record;
+	record.MaterialType = material.MaterialType;
+	record.AmbientColor = material.AmbientColor.color;
+	record.DiffuseColor = material.DiffuseColor.color;
+	record.EmissiveColor = material.EmissiveColor.color;
+	record.SpecularColor = material.SpecularColor.color;
+	record.Shininess = material.Shininess;
+	record.MaterialTypeParam = material.MaterialTypeParam;
+	record.MaterialTypeParam2 = material.MaterialTypeParam2;
+	record.Thickness = material.Thickness;
+	record.ZBuffer = material.ZBuffer;
+	record.AntiAliasing = material.AntiAliasing;
+	record.ColorMask = material.ColorMask;
+	record.ColorMaterial = material.ColorMaterial;
+	record.BlendOperation = material.BlendOperation;
+	record.BlendFactor = material.BlendFactor;
+	record.PolygonOffsetFactor = material.PolygonOffsetFactor;
+	record.PolygonOffsetDirection = material.PolygonOffsetDirection;
+	record.PolygonOffsetDepthBias = material.PolygonOffsetDepthBias;
+	record.PolygonOffsetSlopeScale = material.PolygonOffsetSlopeScale;
+	record.ZWriteEnable = material.ZWriteEnable;
+	record.Flags = 0;
+	for (u32 i=0; i<sizeof(materialFlags)/sizeof(materialFlags[0]); ++i)
+	{
+		if (material.getFlag(materialFlags[i]))
+			record.Flags |= materialFlags[i];
+	}
+	record.LayerCount = layerCount;
+	swapRecords(&record, sizeof(record));
+	memcpy(appendBytes(MaterialData, sizeof(record)), &record, sizeof(record));
+
+	for (u32 i=0; i<layerCount; ++i)
+	{
+		const video::SMaterialLayer& layer = material.TextureLayer[i];
+
+		SIrrBinMeshMaterialLayer layerRecord;
+		layerRecord.Texture = IRRBINMESH_NO_INDEX;
+		if (layer.Texture)
+			layerRecord.Texture = addString(core::stringc(FileSystem->getRelativeFilename(layer.Texture->getName().getPath(), FileDir)));
+		layerRecord.TextureWrapU = layer.TextureWrapU;
+		layerRecord.TextureWrapV = layer.TextureWrapV;
+		layerRecord.TextureWrapW = layer.TextureWrapW;
+		layerRecord.BilinearFilter = layer.BilinearFilter;
+		layerRecord.TrilinearFilter = layer.TrilinearFilter;
+		layerRecord.AnisotropicFilter = layer.AnisotropicFilter;
+		layerRecord.LODBias = layer.LODBias;
+		memcpy(layerRecord.TextureMatrix, layer.getTextureMatrix().pointer(), sizeof(layerRecord.TextureMatrix));
+		swapRecords(&layerRecord, sizeof(layerRecord));
+		memcpy(appendBytes(MaterialData, sizeof(layerRecord)), &layerRecord, sizeof(layerRecord));
+	}
+
+	return Materials.size() - 1;
+}
+
+
+//! appends an array to the streams and returns its offset in the streams
+u32 CIrrBinMeshWriter::addStream(const void* data, u32 size, u32 swapSize)
+{
+	const u32 pos = Streams.size();
+	const u32 offset = alignIrrBinMeshOffset(pos);
+	if (!size)
+		return offset;
+
+	u8* target = appendBytes(Streams, offset - pos + size);
+	memset(target, 0, offset - pos);
+	target += offset - pos;
+	memcpy(target, data, size);
+
+#ifdef __BIG_ENDIAN__
+	if (swapSize == 2)
+	{
+		u16* values = (u16*)target;
+		for (u32 i=0; i<size/2; ++i)
+			values[i] = os::Byteswap::byteswap(values[i]);
+	}
+	else
+		swapRecords(target, size);
+#endif
+	return offset;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BIN_MESH_WRITER_
+
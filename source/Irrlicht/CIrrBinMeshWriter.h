@@ -0,0 +1,71 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IRR_BIN_MESH_WRITER_H_INCLUDED__
+#define __C_IRR_BIN_MESH_WRITER_H_INCLUDED__
+
+#include "IMeshWriter.h"
+#include "SIrrBinMesh.h"
+#include "irrArray.h"
+#include "irrMap.h"
+#include "irrString.h"
+#include "path.h"
+
+namespace irr
+{
+namespace io
+{
+	class IFileSystem;
+}
+namespace video
+{
+	struct SMaterial;
+}
+
+namespace scene
+{
+
+//! Writes meshes into the cooked binary mesh format (.irrbinmesh)
+/** Static meshes and skinned meshes with their joints and animation keys
+are written, see SIrrBinMesh.h for the layout. Meshes are written in their
+current pose, so skinned meshes should be written before they are animated. */
+class CIrrBinMeshWriter : public IMeshWriter
+{
+public:
+
+	//! Constructor
+	CIrrBinMeshWriter(io::IFileSystem* fs);
+
+	//! Returns the type of the mesh writer
+	virtual EMESH_WRITER_TYPE getType() const _IRR_OVERRIDE_;
+
+	//! writes a mesh
+	virtual bool writeMesh(io::IWriteFile* file, scene::IMesh* mesh, s32 flags=EMWF_NONE) _IRR_OVERRIDE_;
+
+private:
+
+	//! returns the index of the string in the string table, adds it when needed
+	u32 addString(const core::stringc& str);
+
+	//! returns the index of the material, adds it when needed
+	u32 addMaterial(const video::SMaterial& material);
+
+	//! appends an array to the streams and returns its offset in the streams
+	u32 addStream(const void* data, u32 size, u32 swapSize);
+
+	io::IFileSystem* FileSystem;
+	io::path FileDir;
+
+	core::array<core::stringc> Strings;
+	core::map<core::stringc, u32> StringIndices;
+	core::array<const video::SMaterial*> Materials;
+	core::array<u8> MaterialData;
+	core::array<u8> Streams;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
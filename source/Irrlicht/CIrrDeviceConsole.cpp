@@ -203,6 +203,7 @@ bool CIrrDeviceConsole::run()
 {
 	// increment timer
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 
 	// process Windows console input
 #ifdef _IRR_WINDOWS_NT_CONSOLE_
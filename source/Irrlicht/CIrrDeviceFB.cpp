@@ -277,6 +277,7 @@ void CIrrDeviceFB::createDriver()
 bool CIrrDeviceFB::run()
 {
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 
 	struct input_event ev;
 	if (EventDevice>=0)
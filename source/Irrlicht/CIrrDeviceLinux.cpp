@@ -1111,6 +1111,7 @@ EKEY_CODE CIrrDeviceLinux::getKeyCode(XEvent &event)
 bool CIrrDeviceLinux::run()
 {
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 
 #ifdef _IRR_COMPILE_WITH_X11_
 
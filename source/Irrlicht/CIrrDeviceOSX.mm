@@ -1178,6 +1178,7 @@ bool CIrrDeviceMacOSX::run()
 	irr::SEvent	ievent;
 
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 	storeMouseLocation();
 
 	gui::IGUIElement* focusElement = getGUIEnvironment()->getFocus();
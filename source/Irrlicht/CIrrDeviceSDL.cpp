@@ -541,6 +541,7 @@ void CIrrDeviceSDL::createDriver()
 bool CIrrDeviceSDL::run()
 {
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 
 	SEvent irrevent;
 	SDL_Event SDL_event;
@@ -447,6 +447,7 @@ void CIrrDeviceSDL2::checkAndUpdateIMEState() {
 bool CIrrDeviceSDL2::run()
 {
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 
 	checkAndUpdateIMEState();
 
@@ -449,6 +449,7 @@ void CIrrDeviceSDL3::checkAndUpdateIMEState() {
 bool CIrrDeviceSDL3::run()
 {
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 
 	checkAndUpdateIMEState();
 
@@ -13,6 +13,8 @@
 #include "CLogger.h"
 #include "irrString.h"
 #include "IRandomizer.h"
+#include "CJobSystem.h"
+#include "CNullDriver.h"
 
 namespace irr
 {
@@ -20,7 +22,7 @@ namespace irr
 CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 : IrrlichtDevice(), VideoDriver(0), GUIEnvironment(0), SceneManager(0),
 	Timer(0), CursorControl(0), UserReceiver(params.EventReceiver),
-	Logger(0), Operator(0), Randomizer(0), FileSystem(0),
+	Logger(0), Operator(0), Randomizer(0), JobSystem(0), FileSystem(0),
 	InputReceivingSceneManager(0), ShouldTransformTouchEvents(false), TouchEmulatedDoubleClickMaxOffset(0),
 	VideoModeList(0), ContextManager(0),
 	CreationParams(params), Close(false)
@@ -38,9 +40,14 @@ CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 		os::Printer::Logger = Logger;
 	}
 	Logger->setLogLevel(CreationParams.LoggingLevel);
+	if (CreationParams.LoggingThread)
+		Logger->setThreaded(true);
 
 	os::Printer::Logger = Logger;
 	Randomizer = createDefaultRandomizer();
+	CJobSystem* jobSystem = new CJobSystem(CreationParams.JobThreads);
+	Logger->setJobSystem(jobSystem);
+	JobSystem = jobSystem;
 
 	FileSystem = io::createFileSystem();
 	VideoModeList = new video::CVideoModeList();
@@ -55,6 +62,12 @@ CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 
 CIrrDeviceStub::~CIrrDeviceStub()
 {
+	// jobs may still use everything else, the driver and the scene manager
+	// hold the job system until they are gone
+	JobSystem->waitForAll();
+	Logger->setJobSystem(0);
+	JobSystem->drop();
+
 	VideoModeList->drop();
 
 	if (GUIEnvironment)
@@ -101,8 +114,12 @@ void CIrrDeviceStub::createGUIAndScene()
 	GUIEnvironment = gui::createGUIEnvironment(FileSystem, VideoDriver, Operator);
 	#endif
 
+	// jobs load textures and meshes through the main thread
+	if (VideoDriver)
+		static_cast<video::CNullDriver*>(VideoDriver)->setJobSystem(JobSystem);
+
 	// create Scene manager
-	SceneManager = scene::createSceneManager(VideoDriver, FileSystem, CursorControl, GUIEnvironment);
+	SceneManager = scene::createSceneManager(VideoDriver, FileSystem, CursorControl, GUIEnvironment, JobSystem);
 
 	setEventReceiver(UserReceiver);
 }
@@ -357,6 +374,13 @@ IOSOperator* CIrrDeviceStub::getOSOperator()
 }
 
 
+//! Returns the job system.
+IJobSystem* CIrrDeviceStub::getJobSystem()
+{
+	return JobSystem;
+}
+
+
 //! Provides access to the engine's currently set randomizer.
 IRandomizer* CIrrDeviceStub::getRandomizer() const
 {
@@ -10,6 +10,7 @@
 #include "SIrrCreationParameters.h"
 #include "CVideoModeList.h"
 #include "IContextManager.h"
+#include "IJobSystem.h"
 
 namespace irr
 {
@@ -28,7 +29,8 @@ namespace irr
 	namespace scene
 	{
 		ISceneManager* createSceneManager(video::IVideoDriver* driver,
-			io::IFileSystem* fs, gui::ICursorControl* cc, gui::IGUIEnvironment *gui);
+			io::IFileSystem* fs, gui::ICursorControl* cc, gui::IGUIEnvironment *gui,
+			IJobSystem* jobs);
 	}
 
 	namespace io
@@ -111,6 +113,9 @@ namespace irr
 		//! Creates a new default randomizer.
 		virtual IRandomizer* createDefaultRandomizer() const _IRR_OVERRIDE_;
 
+		//! Returns the job system.
+		virtual IJobSystem* getJobSystem() _IRR_OVERRIDE_;
+
 		//! Returns the operation system opertator object.
 		virtual IOSOperator* getOSOperator() _IRR_OVERRIDE_;
 
@@ -213,6 +218,7 @@ namespace irr
 		CLogger* Logger;
 		IOSOperator* Operator;
 		IRandomizer* Randomizer;
+		IJobSystem* JobSystem;
 		io::IFileSystem* FileSystem;
 		scene::ISceneManager* InputReceivingSceneManager;
 
@@ -2417,6 +2417,7 @@ bool CIrrDeviceWayland::run()
     if(!VideoDriver)
         return false;
     os::Timer::tick();
+    JobSystem->runMainThreadJobs();
 
     checkAndUpdateIMEState();
 
@@ -1440,6 +1440,7 @@ void CIrrDeviceWin32::checkAndUpdateIMEState() {
 bool CIrrDeviceWin32::run()
 {
 	os::Timer::tick();
+	JobSystem->runMainThreadJobs();
 
 	static_cast<CCursorControl*>(CursorControl)->update();
 
@@ -419,6 +419,8 @@ namespace irr
 
     bool CIrrDeviceiOS::run()
     {
+		JobSystem->runMainThreadJobs();
+
 		if (!Close)
 		{
 			const CFTimeInterval timeInSeconds = 0.000002;
@@ -15,6 +15,8 @@
 #include "IMeshSceneNode.h"
 #include "CDynamicMeshBuffer.h"
 #include "SMeshBufferLightMap.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -49,6 +51,7 @@ bool CIrrMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CIrrMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_IRR_MESH);)
 	io::IXMLReader* reader = FileSystem->createXMLReader(file);
 	if (!reader)
 		return 0;
@@ -0,0 +1,561 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CJobSystem.h"
+#include "irrAtomic.h"
+#include "irrMath.h"
+
+namespace irr
+{
+
+//! The job system of the calling thread and the index of its deque in there
+static _IRR_THREAD_LOCAL CJobSystem* ThreadSystem = 0;
+static _IRR_THREAD_LOCAL s32 ThreadIndex = 0;
+
+namespace
+{
+	//! Distance between two deque positions, also when they wrapped around
+	inline s32 distance(s32 from, s32 to)
+	{
+		return (s32)((u32)to - (u32)from);
+	}
+
+	inline s32 next(s32 position)
+	{
+		return (s32)((u32)position + 1);
+	}
+}
+
+//! Called by the owning thread only
+bool CJobSystem::SDeque::push(SJob* job)
+{
+	const s32 bottom = Bottom;
+	if (distance(Top, bottom) >= SIZE)
+		return false;
+
+	Jobs[bottom & (SIZE - 1)] = job;
+	os::memoryBarrier();
+	Bottom = next(bottom);
+	return true;
+}
+
+//! Called by the owning thread only, takes the job which was pushed last
+CJobSystem::SJob* CJobSystem::SDeque::pop()
+{
+	const s32 bottom = (s32)((u32)Bottom - 1);
+	os::atomicExchange(&Bottom, bottom);
+	const s32 top = Top;
+	if (distance(top, bottom) < 0)
+	{
+		Bottom = next(bottom);
+		return 0;
+	}
+
+	SJob* job = Jobs[bottom & (SIZE - 1)];
+	if (bottom != top)
+		return job;
+
+	// the last job, other threads may steal it at the same time
+	if (!os::atomicCompareExchange(&Top, next(top), top))
+		job = 0;
+	Bottom = next(bottom);
+	return job;
+}
+
+//! Called by other threads, takes the job which was pushed first
+CJobSystem::SJob* CJobSystem::SDeque::steal()
+{
+	const s32 top = Top;
+	os::memoryBarrier();
+	const s32 bottom = Bottom;
+	if (distance(top, bottom) <= 0)
+		return 0;
+
+	SJob* job = Jobs[top & (SIZE - 1)];
+	if (!os::atomicCompareExchange(&Top, next(top), top))
+		return 0;
+	return job;
+}
+
+void CJobSystem::SSharedQueue::push(SJob* job)
+{
+	os::spinLock(&Lock);
+	Jobs.push_back(job);
+	os::spinUnlock(&Lock);
+}
+
+CJobSystem::SJob* CJobSystem::SSharedQueue::pop()
+{
+	SJob* job = 0;
+	os::spinLock(&Lock);
+	if (First < Jobs.size())
+	{
+		job = Jobs[First++];
+		if (First == Jobs.size())
+		{
+			Jobs.set_used(0);
+			First = 0;
+		}
+	}
+	os::spinUnlock(&Lock);
+	return job;
+}
+
+//! constructor
+CJobSystem::CJobSystem(u32 threadCount)
+	: ChunkCount(0), PoolLock(0), SleepingWorkers(0), StopWorkers(0),
+	ActiveJobs(0), ThreadCount(1), RunningAddedJobs(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CJobSystem");
+	#endif
+
+	if (threadCount == 0)
+		threadCount = os::Thread::getProcessorCount();
+	threadCount = core::clamp(threadCount, 1u, 64u);
+
+	if (!ThreadSystem)
+	{
+		ThreadSystem = this;
+		ThreadIndex = 0;
+	}
+
+	// all deques exist before the workers look at them
+	Deques.reallocate(threadCount);
+	for (u32 i=0; i<threadCount; ++i)
+		Deques.push_back(new SDeque());
+
+	for (u32 i=1; i<threadCount; ++i)
+	{
+		SWorker* worker = new SWorker();
+		worker->System = this;
+		worker->Index = i;
+		if (!worker->Thread.start(runWorker, worker))
+		{
+			delete worker;
+			break;
+		}
+		Workers.push_back(worker);
+	}
+	ThreadCount = Workers.size() + 1;
+}
+
+//! destructor
+CJobSystem::~CJobSystem()
+{
+	waitForAll();
+
+	os::atomicExchange(&StopWorkers, 1);
+	for (u32 i=0; i<Workers.size(); ++i)
+		WorkerWake.post();
+	for (u32 i=0; i<Workers.size(); ++i)
+	{
+		Workers[i]->Thread.join();
+		delete Workers[i];
+	}
+
+	for (u32 i=0; i<Deques.size(); ++i)
+		delete Deques[i];
+	for (s32 i=0; i<ChunkCount; ++i)
+		delete [] Chunks[i];
+
+	if (ThreadSystem == this)
+		ThreadSystem = 0;
+}
+
+u32 CJobSystem::getThreadCount() const
+{
+	return ThreadCount;
+}
+
+SJobHandle CJobSystem::addJob(JobFunction function, void* data,
+	const SJobHandle* dependencies, u32 dependencyCount)
+{
+	SJob* job = allocate();
+	if (!job)
+	{
+		// too many jobs, run it right away
+		for (u32 i=0; i<dependencyCount; ++i)
+			wait(dependencies[i]);
+		function(data);
+		return SJobHandle();
+	}
+
+	job->Function = function;
+	job->RangeFunction = 0;
+	job->Data = data;
+	job->MainThread = false;
+	const SJobHandle handle = add(job, dependencies, dependencyCount);
+	runAddedJobs();
+	return handle;
+}
+
+SJobHandle CJobSystem::addParallelFor(JobRangeFunction function, void* data, u32 count, u32 grainSize,
+	const SJobHandle* dependencies, u32 dependencyCount)
+{
+	SJob* job = allocate();
+	if (!job)
+	{
+		for (u32 i=0; i<dependencyCount; ++i)
+			wait(dependencies[i]);
+		if (count)
+			function(data, 0, count);
+		return SJobHandle();
+	}
+
+	if (grainSize == 0)
+		grainSize = core::max_(count / (ThreadCount * 4), 1u);
+
+	job->Function = 0;
+	job->RangeFunction = function;
+	job->Data = data;
+	job->Count = (s32)count;
+	job->GrainSize = (s32)grainSize;
+	job->MainThread = false;
+	const SJobHandle handle = add(job, dependencies, dependencyCount);
+	runAddedJobs();
+	return handle;
+}
+
+SJobHandle CJobSystem::addMainThreadJob(JobFunction function, void* data,
+	const SJobHandle* dependencies, u32 dependencyCount)
+{
+	SJob* job = allocate();
+	if (!job)
+	{
+		for (u32 i=0; i<dependencyCount; ++i)
+			wait(dependencies[i]);
+		function(data);
+		return SJobHandle();
+	}
+
+	job->Function = function;
+	job->RangeFunction = 0;
+	job->Data = data;
+	job->MainThread = true;
+	const SJobHandle handle = add(job, dependencies, dependencyCount);
+	runAddedJobs();
+	return handle;
+}
+
+u32 CJobSystem::runMainThreadJobs()
+{
+	u32 count = 0;
+	SJob* job;
+	while ((job = MainThreadJobs.pop()))
+	{
+		execute(job);
+		++count;
+	}
+
+	// without workers nobody else runs the jobs of other threads
+	if (Workers.empty())
+	{
+		while ((job = findJob(true)))
+		{
+			execute(job);
+			++count;
+		}
+	}
+	return count;
+}
+
+bool CJobSystem::isDone(const SJobHandle& job) const
+{
+	const SJob* data = getJob(job.Index);
+	return !data || data->Generation != (s32)job.Generation;
+}
+
+void CJobSystem::wait(const SJobHandle& job)
+{
+	while (!isDone(job))
+	{
+		SJob* data = findJob(true);
+		if (data)
+			execute(data);
+		else
+			os::Thread::yield();
+	}
+}
+
+void CJobSystem::waitForAll()
+{
+	while (ActiveJobs > 0)
+	{
+		SJob* data = findJob(true);
+		if (data)
+			execute(data);
+		else
+			os::Thread::yield();
+	}
+}
+
+bool CJobSystem::isMainThread() const
+{
+	return getThreadIndex() == 0;
+}
+
+bool CJobSystem::isWorkerThread() const
+{
+	return getThreadIndex() > 0;
+}
+
+//! Registers the job at its dependencies and schedules it if they are done
+SJobHandle CJobSystem::add(SJob* job, const SJobHandle* dependencies, u32 dependencyCount)
+{
+	job->NextIndex = 0;
+	job->FinishedIndices = 0;
+	job->Pending = 1;
+	job->References = 1;
+	os::atomicAdd(&ActiveJobs, 1);
+
+	for (u32 i=0; i<dependencyCount; ++i)
+	{
+		SJob* dependency = getJob(dependencies[i].Index);
+		if (!dependency)
+			continue;
+
+		os::spinLock(&dependency->Lock);
+		if (dependency->Generation == (s32)dependencies[i].Generation)
+		{
+			dependency->Dependents.push_back(job->Index);
+			os::atomicAdd(&job->Pending, 1);
+		}
+		os::spinUnlock(&dependency->Lock);
+	}
+
+	// the job may be done and used again as soon as it is scheduled
+	SJobHandle handle;
+	handle.Index = job->Index;
+	handle.Generation = (u32)job->Generation;
+
+	if (os::atomicAdd(&job->Pending, -1) == 0)
+		schedule(job);
+	return handle;
+}
+
+CJobSystem::SJob* CJobSystem::allocate()
+{
+	SJob* job = 0;
+	os::spinLock(&PoolLock);
+	if (!FreeJobs.empty())
+	{
+		job = FreeJobs.getLast();
+		FreeJobs.set_used(FreeJobs.size() - 1);
+	}
+	else if (ChunkCount < MAX_CHUNKS)
+	{
+		SJob* chunk = new SJob[JOBS_PER_CHUNK];
+		for (u32 i=0; i<JOBS_PER_CHUNK; ++i)
+		{
+			chunk[i].Index = (u32)ChunkCount * JOBS_PER_CHUNK + i;
+			chunk[i].Generation = 0;
+			chunk[i].Lock = 0;
+		}
+		Chunks[ChunkCount] = chunk;
+		os::memoryBarrier();
+		os::atomicAdd(&ChunkCount, 1);
+
+		for (u32 i=JOBS_PER_CHUNK-1; i>0; --i)
+			FreeJobs.push_back(&chunk[i]);
+		job = chunk;
+	}
+	os::spinUnlock(&PoolLock);
+	return job;
+}
+
+//! Drops a reference of the job, the last one puts it back into the pool
+void CJobSystem::release(SJob* job)
+{
+	if (os::atomicAdd(&job->References, -1) != 0)
+		return;
+
+	os::spinLock(&PoolLock);
+	FreeJobs.push_back(job);
+	os::spinUnlock(&PoolLock);
+}
+
+CJobSystem::SJob* CJobSystem::getJob(u32 index) const
+{
+	const u32 chunk = index / JOBS_PER_CHUNK;
+	if (chunk >= (u32)ChunkCount)
+		return 0;
+	return Chunks[chunk] + index % JOBS_PER_CHUNK;
+}
+
+//! Puts a job whose dependencies are done into the queues
+void CJobSystem::schedule(SJob* job)
+{
+	if (job->MainThread)
+	{
+		os::atomicAdd(&job->References, 1);
+		MainThreadJobs.push(job);
+		return;
+	}
+
+	if (job->RangeFunction && job->Count == 0)
+	{
+		finish(job);
+		return;
+	}
+
+	// parallel fors are queued once for each thread which can help
+	u32 copies = 1;
+	if (job->RangeFunction)
+		copies = core::min_((u32)((job->Count - 1) / job->GrainSize + 1), ThreadCount);
+
+	os::atomicAdd(&job->References, (s32)copies);
+	const s32 thread = getThreadIndex();
+	for (u32 i=0; i<copies; ++i)
+	{
+		if (thread < 0 || !Deques[thread]->push(job))
+			SharedJobs.push(job);
+	}
+	wakeWorkers(copies);
+}
+
+//! Runs a job or, for a parallel for, the ranges which no other thread took yet
+void CJobSystem::execute(SJob* job)
+{
+	if (job->RangeFunction)
+	{
+		for (;;)
+		{
+			const s32 begin = os::atomicAdd(&job->NextIndex, job->GrainSize) - job->GrainSize;
+			if (begin >= job->Count)
+				break;
+
+			const s32 end = core::min_(begin + job->GrainSize, job->Count);
+			job->RangeFunction(job->Data, (u32)begin, (u32)end);
+			if (os::atomicAdd(&job->FinishedIndices, end - begin) == job->Count)
+				finish(job);
+		}
+	}
+	else
+	{
+		job->Function(job->Data);
+		finish(job);
+	}
+	release(job);
+}
+
+//! Marks the job as done and schedules the jobs which waited only for it
+void CJobSystem::finish(SJob* job)
+{
+	os::spinLock(&job->Lock);
+	os::atomicAdd(&job->Generation, 1);
+	os::spinUnlock(&job->Lock);
+
+	// no dependents are added after the generation changed
+	for (u32 i=0; i<job->Dependents.size(); ++i)
+	{
+		SJob* dependent = getJob(job->Dependents[i]);
+		if (os::atomicAdd(&dependent->Pending, -1) == 0)
+			schedule(dependent);
+	}
+	job->Dependents.set_used(0);
+
+	os::atomicAdd(&ActiveJobs, -1);
+	release(job);
+}
+
+//! Returns a job which the calling thread can run
+CJobSystem::SJob* CJobSystem::findJob(bool mainThread)
+{
+	const s32 thread = getThreadIndex();
+	SJob* job = 0;
+	if (thread >= 0)
+		job = Deques[thread]->pop();
+	if (!job && mainThread && thread == 0)
+		job = MainThreadJobs.pop();
+	if (!job && !SharedJobs.isEmpty())
+		job = SharedJobs.pop();
+
+	const u32 count = Deques.size();
+	const u32 first = thread >= 0 ? (u32)thread + 1 : 0;
+	for (u32 i=0; !job && i<count; ++i)
+	{
+		const u32 victim = (first + i) % count;
+		if ((s32)victim != thread)
+			job = Deques[victim]->steal();
+	}
+	return job;
+}
+
+bool CJobSystem::hasWork() const
+{
+	if (!SharedJobs.isEmpty())
+		return true;
+	for (u32 i=0; i<Deques.size(); ++i)
+	{
+		if (!Deques[i]->isEmpty())
+			return true;
+	}
+	return false;
+}
+
+void CJobSystem::wakeWorkers(u32 count)
+{
+	// workers count themselves as sleeping before they look for jobs a last time
+	os::memoryBarrier();
+	for (u32 i=0; i<count; ++i)
+	{
+		s32 sleeping = SleepingWorkers;
+		while (sleeping > 0 && !os::atomicCompareExchange(&SleepingWorkers, sleeping - 1, sleeping))
+			sleeping = SleepingWorkers;
+		if (sleeping <= 0)
+			return;
+		WorkerWake.post();
+	}
+}
+
+//! Without workers the main thread runs the jobs which it adds before the add returns
+void CJobSystem::runAddedJobs()
+{
+	if (!Workers.empty() || RunningAddedJobs || getThreadIndex() != 0)
+		return;
+
+	RunningAddedJobs = true;
+	SJob* job;
+	while ((job = findJob(true)))
+		execute(job);
+	RunningAddedJobs = false;
+}
+
+s32 CJobSystem::getThreadIndex() const
+{
+	return ThreadSystem == this ? ThreadIndex : -1;
+}
+
+void CJobSystem::runWorker(void* data)
+{
+	SWorker* worker = (SWorker*)data;
+	CJobSystem* system = worker->System;
+	ThreadSystem = system;
+	ThreadIndex = (s32)worker->Index;
+
+	while (!system->StopWorkers)
+	{
+		SJob* job = system->findJob(false);
+		if (job)
+		{
+			system->execute(job);
+			continue;
+		}
+
+		os::atomicAdd(&system->SleepingWorkers, 1);
+		if (system->hasWork() || system->StopWorkers)
+		{
+			// take the sleep back, unless a thread which added jobs already did
+			s32 sleeping = system->SleepingWorkers;
+			while (sleeping > 0 && !os::atomicCompareExchange(&system->SleepingWorkers, sleeping - 1, sleeping))
+				sleeping = system->SleepingWorkers;
+			continue;
+		}
+		system->WorkerWake.wait();
+	}
+	ThreadSystem = 0;
+}
+
+} // end namespace irr
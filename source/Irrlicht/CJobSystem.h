@@ -0,0 +1,157 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_JOB_SYSTEM_H_INCLUDED__
+#define __C_JOB_SYSTEM_H_INCLUDED__
+
+#include "IJobSystem.h"
+#include "irrArray.h"
+#include "os.h"
+
+namespace irr
+{
+
+//! Job system with a work stealing deque per thread
+class CJobSystem : public IJobSystem
+{
+public:
+
+	//! Starts threadCount-1 worker threads, 0 starts one thread per processor
+	CJobSystem(u32 threadCount);
+
+	//! Runs the remaining jobs and stops the worker threads
+	virtual ~CJobSystem();
+
+	virtual u32 getThreadCount() const _IRR_OVERRIDE_;
+
+	virtual SJobHandle addJob(JobFunction function, void* data,
+		const SJobHandle* dependencies, u32 dependencyCount) _IRR_OVERRIDE_;
+
+	virtual SJobHandle addParallelFor(JobRangeFunction function, void* data, u32 count, u32 grainSize,
+		const SJobHandle* dependencies, u32 dependencyCount) _IRR_OVERRIDE_;
+
+	virtual SJobHandle addMainThreadJob(JobFunction function, void* data,
+		const SJobHandle* dependencies, u32 dependencyCount) _IRR_OVERRIDE_;
+
+	virtual u32 runMainThreadJobs() _IRR_OVERRIDE_;
+
+	virtual bool isDone(const SJobHandle& job) const _IRR_OVERRIDE_;
+
+	virtual void wait(const SJobHandle& job) _IRR_OVERRIDE_;
+
+	virtual void waitForAll() _IRR_OVERRIDE_;
+
+	virtual bool isMainThread() const _IRR_OVERRIDE_;
+
+	//! Returns true when called from one of the worker threads
+	bool isWorkerThread() const;
+
+private:
+
+	struct SJob
+	{
+		JobFunction Function;
+		JobRangeFunction RangeFunction;
+		void* Data;
+
+		//! Indices of a parallel for, the next one to start and the number of finished ones
+		s32 Count;
+		s32 GrainSize;
+		volatile s32 NextIndex;
+		volatile s32 FinishedIndices;
+
+		//! Dependencies which are not done, plus one while the job is added
+		volatile s32 Pending;
+		//! Copies in the queues, plus one until the job is done
+		volatile s32 References;
+		//! Changes when the job is done
+		volatile s32 Generation;
+		//! Guards Dependents and Generation
+		volatile s32 Lock;
+		core::array<u32> Dependents;
+
+		u32 Index;
+		bool MainThread;
+	};
+
+	//! Queue of one thread, which pushes and pops at the bottom while other threads steal at the top
+	struct SDeque
+	{
+		SDeque() : Top(0), Bottom(0) {}
+
+		bool push(SJob* job);
+		SJob* pop();
+		SJob* steal();
+		bool isEmpty() const { return Bottom - Top <= 0; }
+
+		enum { SIZE = 1024 };
+		SJob* volatile Jobs[SIZE];
+		volatile s32 Top;
+		volatile s32 Bottom;
+	};
+
+	//! Queue guarded by a lock for threads which have no deque and for the main thread jobs
+	struct SSharedQueue
+	{
+		SSharedQueue() : First(0), Lock(0) {}
+
+		void push(SJob* job);
+		SJob* pop();
+		bool isEmpty() const { return First >= Jobs.size(); }
+
+		core::array<SJob*> Jobs;
+		u32 First;
+		volatile s32 Lock;
+	};
+
+	struct SWorker
+	{
+		CJobSystem* System;
+		u32 Index;
+		os::Thread Thread;
+	};
+
+	SJobHandle add(SJob* job, const SJobHandle* dependencies, u32 dependencyCount);
+	SJob* allocate();
+	void release(SJob* job);
+	SJob* getJob(u32 index) const;
+	void schedule(SJob* job);
+	void execute(SJob* job);
+	void finish(SJob* job);
+	SJob* findJob(bool mainThread);
+	bool hasWork() const;
+	void wakeWorkers(u32 count);
+	void runAddedJobs();
+	s32 getThreadIndex() const;
+
+	static void runWorker(void* data);
+
+	enum { JOBS_PER_CHUNK = 256, MAX_CHUNKS = 1024 };
+
+	SJob* volatile Chunks[MAX_CHUNKS];
+	volatile s32 ChunkCount;
+	core::array<SJob*> FreeJobs;
+	volatile s32 PoolLock;
+
+	//! Deque of each thread, the main thread has the first one
+	core::array<SDeque*> Deques;
+	SSharedQueue SharedJobs;
+	SSharedQueue MainThreadJobs;
+
+	core::array<SWorker*> Workers;
+	os::Semaphore WorkerWake;
+	volatile s32 SleepingWorkers;
+	volatile s32 StopWorkers;
+
+	//! Jobs which are added and not done
+	volatile s32 ActiveJobs;
+	u32 ThreadCount;
+
+	//! The main thread runs the jobs it adds when there are no workers
+	bool RunningAddedJobs;
+};
+
+} // end namespace irr
+
+#endif
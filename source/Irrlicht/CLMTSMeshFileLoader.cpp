@@ -78,6 +78,8 @@ Version 1.0 - 29 July 2004
 #include "IAttributes.h"
 #include "ISceneManager.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -134,6 +136,7 @@ bool CLMTSMeshFileLoader::isALoadableFileExtension(const io::path& filename) con
 
 IAnimatedMesh* CLMTSMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_LMTS);)
 	if ( getMeshTextureLoader() )
 		getMeshTextureLoader()->setMeshFile(file);
 
@@ -15,6 +15,8 @@
 #include "IFileSystem.h"
 #include "IVideoDriver.h"
 #include "IMeshManipulator.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -151,6 +153,7 @@ bool CLWOMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! creates/loads an animated mesh from the file.
 IAnimatedMesh* CLWOMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_LWO);)
 	if ( getMeshTextureLoader() )
 		getMeshTextureLoader()->setMeshFile(file);
 
@@ -43,6 +43,9 @@ public:
 	//! See IUnknown::drop() for more information.
 	virtual IAnimatedMesh* createMesh(io::IReadFile* file) _IRR_OVERRIDE_;
 
+	//! Only gets textures from the video driver
+	virtual bool isThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
 private:
 
 	struct tLWOMaterial;
@@ -3,16 +3,28 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CLogger.h"
+#include <string.h>
 
 namespace irr
 {
 
 	CLogger::CLogger(IEventReceiver* r)
-		: LogLevel(ELL_INFORMATION), Receiver(r)
+		: LogLevel(ELL_INFORMATION), Receiver(r), JobSystem(0), Head(&Stub), Tail(&Stub),
+		WriterSleeping(0), StopWriter(0), Threaded(0), Producers(0), Repeats(0), RepeatsStart(0)
 	{
 		#ifdef _DEBUG
 		setDebugName("CLogger");
 		#endif
+
+		Stub.Next = 0;
+		Stub.Flushed = 0;
+		Stub.Text[0] = 0;
+	}
+
+	//! Prints out the texts which are still queued
+	CLogger::~CLogger()
+	{
+		setThreaded(false);
 	}
 
 	//! Returns the current set log level.
@@ -39,11 +51,36 @@ namespace irr
 			event.EventType = EET_LOG_TEXT_EVENT;
 			event.LogEvent.Text = text;
 			event.LogEvent.Level = ll;
-			if (Receiver->OnEvent(event))
+
+			// receivers expect their events on the main thread
+			if (JobSystem && JobSystem->isWorkerThread())
+			{
+				SReceiverCall call = { Receiver, &event, false };
+				JobSystem->runOnMainThread(receiveOnMainThread, &call);
+				if (call.Received)
+					return;
+			}
+			else if (Receiver->OnEvent(event))
 				return;
 		}
 
-		os::Printer::print(text);
+		if (!beginPush())
+		{
+			os::Printer::print(text);
+			return;
+		}
+
+		const size_t length = strlen(text);
+		SRecord* record = (SRecord*)new c8[sizeof(SRecord) + length];
+		record->Flushed = 0;
+		memcpy(record->Text, text, length + 1);
+		push(record);
+		wakeWriter();
+		endPush();
+
+		// errors are often followed by a crash which would lose them
+		if (ll == ELL_ERROR)
+			flush();
 	}
 
 
@@ -91,12 +128,223 @@ namespace irr
 		log( text, s2.c_str(), ll);
 	}
 
+	//! Waits until all texts logged so far are printed out
+	void CLogger::flush()
+	{
+		if (!beginPush())
+			return;
+
+		os::Semaphore flushed;
+		SRecord record;
+		record.Flushed = &flushed;
+		record.Text[0] = 0;
+		push(&record);
+		wakeWriter();
+		endPush();
+		flushed.wait();
+	}
+
 	//! Sets a new event receiver
 	void CLogger::setReceiver(IEventReceiver* r)
 	{
 		Receiver = r;
 	}
 
+	//! Sets the job system whose threads pass their log events to the main thread
+	void CLogger::setJobSystem(CJobSystem* jobSystem)
+	{
+		JobSystem = jobSystem;
+	}
+
+	//! Passes a log event of another thread to the receiver
+	void CLogger::receiveOnMainThread(void* data)
+	{
+		SReceiverCall* call = (SReceiverCall*)data;
+		call->Received = call->Receiver->OnEvent(*call->Event);
+	}
+
+	//! Prints the texts in a thread of its own or again on the thread which logs
+	bool CLogger::setThreaded(bool threaded)
+	{
+		if (threaded == (Threaded != 0))
+			return true;
+
+		if (threaded)
+		{
+			StopWriter = 0;
+			if (!Writer.start(writeRecords, this))
+				return false;
+			os::atomicExchange(&Threaded, 1);
+			return true;
+		}
+
+		// new texts are printed right away, wait until the threads which
+		// still push records have linked them
+		os::atomicExchange(&Threaded, 0);
+		while (Producers)
+			os::Thread::yield();
+
+		// the writer prints all queued texts before it stops
+		os::atomicExchange(&StopWriter, 1);
+		WriterWake.post();
+		Writer.join();
+
+		// nothing is pushed anymore, print what the writer might have left
+		SRecord* record;
+		while ((record = pop()))
+			print(record);
+		printRepeats();
+		LastText = "";
+		return true;
+	}
+
+	//! Registers a thread which pushes a record
+	/** \return False if the texts are printed right away instead. */
+	bool CLogger::beginPush()
+	{
+		os::atomicAdd(&Producers, 1);
+		if (Threaded)
+			return true;
+		os::atomicAdd(&Producers, -1);
+		return false;
+	}
+
+	//! Ends the registration of beginPush after the record was linked
+	void CLogger::endPush()
+	{
+		os::atomicAdd(&Producers, -1);
+	}
+
+	//! Adds a record to the queue, can be called by any thread
+	void CLogger::push(SRecord* record)
+	{
+		record->Next = 0;
+		SRecord* previous = (SRecord*)os::atomicExchange((void* volatile*)&Head, record);
+		// the writer doesn't see record until it is linked here
+		previous->Next = record;
+	}
+
+	//! Removes the oldest record from the queue, only called by the writer
+	/** Returns 0 when the queue is empty or the next record is not linked yet. */
+	CLogger::SRecord* CLogger::pop()
+	{
+		SRecord* tail = Tail;
+		SRecord* next = tail->Next;
+		if (tail == &Stub)
+		{
+			if (!next)
+				return 0;
+			Tail = next;
+			tail = next;
+			next = next->Next;
+		}
+
+		if (next)
+		{
+			Tail = next;
+			return tail;
+		}
+
+		if (tail != Head)
+			return 0;
+
+		// tail is the last record, the stub takes its place in the queue
+		push(&Stub);
+		next = tail->Next;
+		if (next)
+		{
+			Tail = next;
+			return tail;
+		}
+		return 0;
+	}
+
+	//! Wakes up the writer if it sleeps
+	/** Called after a record was linked in push. The barrier keeps the read of
+	WriterSleeping from moving ahead of the link, otherwise the writer could set
+	WriterSleeping, miss the record and never be woken. */
+	void CLogger::wakeWriter()
+	{
+		os::memoryBarrier();
+		if (WriterSleeping && os::atomicExchange(&WriterSleeping, 0))
+			WriterWake.post();
+	}
+
+	//! Prints a record on the writer thread and releases it
+	void CLogger::print(const SRecord* record)
+	{
+		if (record->Flushed)
+		{
+			printRepeats();
+			// the record is owned by the waiting thread
+			record->Flushed->post();
+			return;
+		}
+
+		if (LastText == record->Text)
+		{
+			if (Repeats++ == 0)
+				RepeatsStart = os::Timer::getRealTime();
+			else if (os::Timer::getRealTime() - RepeatsStart >= 1000)
+				printRepeats();
+		}
+		else
+		{
+			printRepeats();
+			LastText = record->Text;
+			os::Printer::print(record->Text);
+		}
+		delete [] (c8*)record;
+	}
+
+	//! Prints how often the last text was repeated since it was printed
+	void CLogger::printRepeats()
+	{
+		if (!Repeats)
+			return;
+
+		c8 text[64];
+		snprintf_irr(text, 64, "Last message repeated %u times.", Repeats);
+		os::Printer::print(text);
+		Repeats = 0;
+	}
+
+	//! Function of the writer thread
+	void CLogger::writeRecords(void* data)
+	{
+		CLogger* logger = (CLogger*)data;
+		for (;;)
+		{
+			SRecord* record = logger->pop();
+			if (record)
+			{
+				logger->print(record);
+				continue;
+			}
+
+			if (logger->StopWriter)
+			{
+				// all records were linked before StopWriter was set
+				os::memoryBarrier();
+				while ((record = logger->pop()))
+					logger->print(record);
+				break;
+			}
+
+			// producers wake the writer after they linked their record, so
+			// a record linked before WriterSleeping is set is found here
+			os::atomicExchange(&logger->WriterSleeping, 1);
+			record = logger->pop();
+			if (record)
+			{
+				os::atomicExchange(&logger->WriterSleeping, 0);
+				logger->print(record);
+				continue;
+			}
+			logger->WriterWake.wait();
+		}
+	}
+
 
 } // end namespace irr
 
@@ -9,17 +9,27 @@
 #include "os.h"
 #include "irrString.h"
 #include "IEventReceiver.h"
+#include "CJobSystem.h"
+#include "irrAtomic.h"
 
 namespace irr
 {
 
 //! Class for logging messages, warnings and errors to stdout
+/** With setThreaded the texts are printed by a thread of its own. The texts
+are copied into records which go through a lock-free queue with one consumer,
+so threads logging at the same time don't wait for each other or for the console.
+The receiver is still called on the thread which logs, or on the main thread
+for texts of the worker threads of the job system. */
 class CLogger : public ILogger
 {
 public:
 
 	CLogger(IEventReceiver* r);
 
+	//! Prints out the texts which are still queued
+	virtual ~CLogger();
+
 	//! Returns the current set log level.
 	virtual ELOG_LEVEL getLogLevel() const _IRR_OVERRIDE_;
 
@@ -41,13 +51,75 @@ public:
 	//! Prints out a text into the log
 	virtual void log(const wchar_t* text, const wchar_t* hint, ELOG_LEVEL ll=ELL_INFORMATION) _IRR_OVERRIDE_;
 
+	//! Waits until all texts logged so far are printed out
+	virtual void flush() _IRR_OVERRIDE_;
+
 	//! Sets a new event receiver
 	void setReceiver(IEventReceiver* r);
 
+	//! Sets the job system whose threads pass their log events to the main thread
+	/** The job system is not grabbed, set it to 0 before it is dropped. */
+	void setJobSystem(CJobSystem* jobSystem);
+
+	//! Prints the texts in a thread of its own or again on the thread which logs
+	/** Only possible where threads are supported.
+	\return True if texts are printed as wanted now. */
+	bool setThreaded(bool threaded);
+
 private:
 
+	//! Text in the queue, allocated together with its characters
+	struct SRecord
+	{
+		SRecord* volatile Next;
+		//! Posted when the writer reached this record, which has no text
+		os::Semaphore* Flushed;
+		c8 Text[1];
+	};
+
+	bool beginPush();
+	void endPush();
+	//! Log event which a thread passes to the main thread
+	struct SReceiverCall
+	{
+		IEventReceiver* Receiver;
+		const SEvent* Event;
+		bool Received;
+	};
+
+	static void receiveOnMainThread(void* data);
+
+	void push(SRecord* record);
+	SRecord* pop();
+	void wakeWriter();
+	void print(const SRecord* record);
+	void printRepeats();
+
+	static void writeRecords(void* data);
+
 	ELOG_LEVEL LogLevel;
 	IEventReceiver* Receiver;
+	CJobSystem* JobSystem;
+
+	//! Producers link their records behind Head, the writer pops at Tail
+	SRecord* volatile Head;
+	SRecord* Tail;
+	SRecord Stub;
+
+	os::Thread Writer;
+	os::Semaphore WriterWake;
+	volatile s32 WriterSleeping;
+	volatile s32 StopWriter;
+	//! Set while records are queued, Producers counts the threads which push right now
+	volatile s32 Threaded;
+	volatile s32 Producers;
+
+	//! The writer prints repeated texts once with their number
+	/** The number is printed when another text or a flush arrives, when the
+	writer stops, or with the next repeat once a second has passed. */
+	core::stringc LastText;
+	u32 Repeats;
+	u32 RepeatsStart;
 };
 
 } // end namespace
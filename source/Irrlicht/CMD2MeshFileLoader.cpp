@@ -8,6 +8,8 @@
 #include "CMD2MeshFileLoader.h"
 #include "CAnimatedMeshMD2.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -103,6 +105,7 @@ bool CMD2MeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CMD2MeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_MD2);)
 	IAnimatedMesh* msh = new CAnimatedMeshMD2();
 	if (msh)
 	{
@@ -8,6 +8,8 @@
 #include "CMD3MeshFileLoader.h"
 #include "CAnimatedMeshMD3.h"
 #include "irrString.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -37,6 +39,7 @@ bool CMD3MeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 
 IAnimatedMesh* CMD3MeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_MD3);)
 	CAnimatedMeshMD3 * mesh = new CAnimatedMeshMD3();
 
 	if ( mesh->loadModelFile ( 0, file, SceneManager->getFileSystem(), SceneManager->getVideoDriver() ) )
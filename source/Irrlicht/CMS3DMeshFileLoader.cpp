@@ -10,6 +10,8 @@
 #include "os.h"
 #include "CMS3DMeshFileLoader.h"
 #include "CSkinnedMesh.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 
 namespace irr
@@ -161,6 +163,7 @@ bool CMS3DMeshFileLoader::isALoadableFileExtension(const io::path& filename) con
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CMS3DMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_MS3D);)
 	if (!file)
 		return 0;
 
@@ -21,6 +21,8 @@
 
 #include "CMY3DHelper.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 // v3.15 - May 16, 2005
 
@@ -81,6 +83,7 @@ bool CMY3DMeshFileLoader::isALoadableFileExtension(const io::path& filename) con
 
 IAnimatedMesh* CMY3DMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_MY3D);)
 	if ( getMeshTextureLoader() )
 	{
 		getMeshTextureLoader()->setMeshFile(file);
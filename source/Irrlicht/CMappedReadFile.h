@@ -0,0 +1,84 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_MAPPED_READ_FILE_H_INCLUDED__
+#define __C_MAPPED_READ_FILE_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+
+#include "IMemoryReadFile.h"
+#include "irrString.h"
+
+namespace irr
+{
+
+namespace io
+{
+
+	/*!
+		Class for reading a file from disk which is mapped into memory.
+	*/
+	class CMappedReadFile : public IMemoryReadFile
+	{
+	public:
+
+		//! Destructor
+		virtual ~CMappedReadFile();
+
+		//! returns how much was read
+		virtual size_t read(void* buffer, size_t sizeToRead) _IRR_OVERRIDE_;
+
+		//! changes position in file, returns true if successful
+		virtual bool seek(long finalPos, bool relativeMovement = false) _IRR_OVERRIDE_;
+
+		//! returns size of file
+		virtual long getSize() const _IRR_OVERRIDE_;
+
+		//! returns where in the file we are.
+		virtual long getPos() const _IRR_OVERRIDE_;
+
+		//! returns name of file
+		virtual const io::path& getFileName() const _IRR_OVERRIDE_;
+
+		//! Get the type of the class implementing this interface
+		virtual EREAD_FILE_TYPE getType() const _IRR_OVERRIDE_
+		{
+			return ERFT_MAPPED_READ_FILE;
+		}
+
+		//! Get direct access to the mapped file
+		virtual const void *getBuffer() const _IRR_OVERRIDE_
+		{
+			return Buffer;
+		}
+
+		//! maps a file on disk into memory, returns 0 if that is not possible
+		static IReadFile* createMappedReadFile(const io::path& fileName);
+
+	private:
+
+		//! Constructor
+		CMappedReadFile(const io::path& fileName);
+
+		//! maps the file
+		void mapFile();
+
+		const void* Buffer;
+		long Len;
+		long Pos;
+		io::path Filename;
+#if defined(_IRR_WINDOWS_API_)
+		void* Mapping;
+#endif
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+
+#endif
+
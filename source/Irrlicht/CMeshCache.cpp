@@ -5,13 +5,17 @@
 #include "CMeshCache.h"
 #include "IAnimatedMesh.h"
 #include "IMesh.h"
+#include "irrAtomic.h"
 
 namespace irr
 {
 namespace scene
 {
 
-static const io::SNamedPath emptyNamedPath;
+CMeshCache::CMeshCache()
+	: Lock(0)
+{
+}
 
 
 CMeshCache::~CMeshCache()
@@ -28,7 +32,9 @@ void CMeshCache::addMesh(const io::path& filename, IAnimatedMesh* mesh)
 	MeshEntry e ( filename );
 	e.Mesh = mesh;
 
+	os::spinLock(&Lock);
 	Meshes.push_back(e);
+	os::spinUnlock(&Lock);
 }
 
 
@@ -37,15 +43,17 @@ void CMeshCache::removeMesh(const IMesh* const mesh)
 {
 	if ( !mesh )
 		return;
+	os::spinLock(&Lock);
 	for (u32 i=0; i<Meshes.size(); ++i)
 	{
 		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
 		{
 			Meshes[i].Mesh->drop();
 			Meshes.erase(i);
-			return;
+			break;
 		}
 	}
+	os::spinUnlock(&Lock);
 }
 
 
@@ -59,23 +67,32 @@ u32 CMeshCache::getMeshCount() const
 //! Returns current number of the mesh
 s32 CMeshCache::getMeshIndex(const IMesh* const mesh) const
 {
+	s32 index = -1;
+	os::spinLock(&Lock);
 	for (u32 i=0; i<Meshes.size(); ++i)
 	{
 		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
-			return (s32)i;
+		{
+			index = (s32)i;
+			break;
+		}
 	}
+	os::spinUnlock(&Lock);
 
-	return -1;
+	return index;
 }
 
 
 //! Returns a mesh based on its index number
 IAnimatedMesh* CMeshCache::getMeshByIndex(u32 number)
 {
-	if (number >= Meshes.size())
-		return 0;
+	IAnimatedMesh* mesh = 0;
+	os::spinLock(&Lock);
+	if (number < Meshes.size())
+		mesh = Meshes[number].Mesh;
+	os::spinUnlock(&Lock);
 
-	return Meshes[number].Mesh;
+	return mesh;
 }
 
 
@@ -83,62 +100,81 @@ IAnimatedMesh* CMeshCache::getMeshByIndex(u32 number)
 IAnimatedMesh* CMeshCache::getMeshByName(const io::path& name)
 {
 	MeshEntry e ( name );
+	os::spinLock(&Lock);
 	s32 id = Meshes.binary_search(e);
-	return (id != -1) ? Meshes[id].Mesh : 0;
+	IAnimatedMesh* mesh = (id != -1) ? Meshes[id].Mesh : 0;
+	os::spinUnlock(&Lock);
+	return mesh;
 }
 
 
 //! Get the name of a loaded mesh, based on its index.
-const io::SNamedPath& CMeshCache::getMeshName(u32 index) const
+io::SNamedPath CMeshCache::getMeshName(u32 index) const
 {
-	if (index >= Meshes.size())
-		return emptyNamedPath;
+	io::SNamedPath name;
+	os::spinLock(&Lock);
+	if (index < Meshes.size())
+		name = Meshes[index].NamedPath;
+	os::spinUnlock(&Lock);
 
-	return Meshes[index].NamedPath;
+	return name;
 }
 
 
 //! Get the name of a loaded mesh, if there is any.
-const io::SNamedPath& CMeshCache::getMeshName(const IMesh* const mesh) const
+io::SNamedPath CMeshCache::getMeshName(const IMesh* const mesh) const
 {
+	io::SNamedPath name;
 	if (!mesh)
-		return emptyNamedPath;
+		return name;
 
+	os::spinLock(&Lock);
 	for (u32 i=0; i<Meshes.size(); ++i)
 	{
 		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
-			return Meshes[i].NamedPath;
+		{
+			name = Meshes[i].NamedPath;
+			break;
+		}
 	}
+	os::spinUnlock(&Lock);
 
-	return emptyNamedPath;
+	return name;
 }
 
 //! Renames a loaded mesh.
 bool CMeshCache::renameMesh(u32 index, const io::path& name)
 {
-	if (index >= Meshes.size())
-		return false;
-
-	Meshes[index].NamedPath.setPath(name);
-	Meshes.sort();
-	return true;
+	os::spinLock(&Lock);
+	const bool found = index < Meshes.size();
+	if (found)
+	{
+		Meshes[index].NamedPath.setPath(name);
+		Meshes.sort();
+	}
+	os::spinUnlock(&Lock);
+	return found;
 }
 
 
 //! Renames a loaded mesh.
 bool CMeshCache::renameMesh(const IMesh* const mesh, const io::path& name)
 {
+	bool found = false;
+	os::spinLock(&Lock);
 	for (u32 i=0; i<Meshes.size(); ++i)
 	{
 		if (Meshes[i].Mesh == mesh || (Meshes[i].Mesh && Meshes[i].Mesh->getMesh(0) == mesh))
 		{
 			Meshes[i].NamedPath.setPath(name);
 			Meshes.sort();
-			return true;
+			found = true;
+			break;
 		}
 	}
+	os::spinUnlock(&Lock);
 
-	return false;
+	return found;
 }
 
 
@@ -152,15 +188,18 @@ bool CMeshCache::isMeshLoaded(const io::path& name)
 //! Clears the whole mesh cache, removing all meshes.
 void CMeshCache::clear()
 {
+	os::spinLock(&Lock);
 	for (u32 i=0; i<Meshes.size(); ++i)
 		Meshes[i].Mesh->drop();
 
 	Meshes.clear();
+	os::spinUnlock(&Lock);
 }
 
 //! Clears all meshes that are held in the mesh cache but not used anywhere else.
 void CMeshCache::clearUnusedMeshes()
 {
+	os::spinLock(&Lock);
 	for (u32 i=0; i<Meshes.size(); ++i)
 	{
 		if (Meshes[i].Mesh->getReferenceCount() == 1)
@@ -170,6 +209,7 @@ void CMeshCache::clearUnusedMeshes()
 			--i;
 		}
 	}
+	os::spinUnlock(&Lock);
 }
 
 
@@ -17,6 +17,8 @@ namespace scene
 	{
 	public:
 
+		CMeshCache();
+
 		virtual ~CMeshCache();
 
 		//! Adds a mesh to the internal list of loaded meshes.
@@ -60,12 +62,12 @@ namespace scene
 		//! Get the name of a loaded mesh, based on its index.
 		/** \param index: Index of the mesh, number between 0 and getMeshCount()-1.
 		\return The name if mesh was found and has a name, else	the path is empty. */
-		virtual const io::SNamedPath& getMeshName(u32 index) const _IRR_OVERRIDE_;
+		virtual io::SNamedPath getMeshName(u32 index) const _IRR_OVERRIDE_;
 
 		//! Get the name of a loaded mesh, if there is any.
 		/** \param mesh Pointer to mesh to query.
 		\return The name if mesh was found and has a name, else	the path is empty. */
-		virtual const io::SNamedPath& getMeshName(const IMesh* const mesh) const _IRR_OVERRIDE_;
+		virtual io::SNamedPath getMeshName(const IMesh* const mesh) const _IRR_OVERRIDE_;
 
 		//! Renames a loaded mesh.
 		/** Note that renaming meshes might change the ordering of the
@@ -113,6 +115,10 @@ namespace scene
 
 		//! loaded meshes
 		core::array<MeshEntry> Meshes;
+
+		//! guards Meshes, jobs which load meshes add them from other threads
+		/** Even lookups take it, binary_search sorts the array. */
+		mutable volatile s32 Lock;
 	};
 
 
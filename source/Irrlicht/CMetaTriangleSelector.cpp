@@ -220,6 +220,18 @@ const ITriangleSelector* CMetaTriangleSelector::getSelector(u32 index) const
 }
 
 
+//! Returns true if all triangle selectors are thread safe
+bool CMetaTriangleSelector::isThreadSafe() const
+{
+	for (u32 i=0; i<TriangleSelectors.size(); ++i)
+	{
+		if (!TriangleSelectors[i]->isThreadSafe())
+			return false;
+	}
+	return true;
+}
+
+
 } // end namespace scene
 } // end namespace irr
 
@@ -66,6 +66,9 @@ public:
 	// Get the TriangleSelector based on index based on getSelectorCount
 	virtual const ITriangleSelector* getSelector(u32 index) const _IRR_OVERRIDE_;
 
+	//! Returns true if all triangle selectors are thread safe
+	virtual bool isThreadSafe() const _IRR_OVERRIDE_;
+
 private:
 
 	core::array<ITriangleSelector*> TriangleSelectors;
@@ -0,0 +1,357 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMipMapGenerator.h"
+#include "irrMath.h"
+#include <string.h>
+#include <math.h>
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+//! number of taps of the kaiser filter
+const s32 KAISER_TAPS = 12;
+
+//! 8 bit channels are truncated like in Resample_subSampling, this only absorbs the float error of x/255*255
+const f32 TRUNCATE_BIAS = 0.001f;
+
+//! Conversion tables which are the same for all generators
+struct SMipMapTables
+{
+	SMipMapTables()
+	{
+		u32 i;
+		for (i = 0; i < 256; ++i)
+		{
+			const f64 c = i / 255.0;
+			ToLinear[i] = (f32)(c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4));
+		}
+		// linear values from SRGBUpper[i] on are sRGB value i+1 or above.
+		// Rounds down like Resample_subSampling, so levels look like they always did
+		for (i = 0; i < 255; ++i)
+			SRGBUpper[i] = ToLinear[i + 1];
+		SRGBUpper[255] = 2.f;
+
+		// sinc windowed by a kaiser window (alpha 4) of 3 target texels radius.
+		// Tap i is at distance i-5.5 source texels from the target texel center.
+		const f64 alpha = 4.0;
+		f64 sum = 0.0;
+		f64 w[KAISER_TAPS];
+		for (i = 0; i < (u32)KAISER_TAPS; ++i)
+		{
+			const f64 t = (i - 5.5) * 0.5;
+			const f64 x = t / 3.0;
+			const f64 sinc = sin(core::PI64 * t) / (core::PI64 * t);
+			w[i] = sinc * besselI0(alpha * sqrt(1.0 - x * x)) / besselI0(alpha);
+			sum += w[i];
+		}
+		for (i = 0; i < (u32)KAISER_TAPS; ++i)
+			Kaiser[i] = (f32)(w[i] / sum);
+	}
+
+	static f64 besselI0(f64 x)
+	{
+		f64 sum = 1.0;
+		f64 term = 1.0;
+		for (u32 k = 1; k < 32; ++k)
+		{
+			term *= (x * 0.5 / k) * (x * 0.5 / k);
+			sum += term;
+		}
+		return sum;
+	}
+
+	f32 ToLinear[256];
+	f32 SRGBUpper[256];
+	f32 Kaiser[KAISER_TAPS];
+};
+
+const SMipMapTables Tables;
+
+//! nearest sRGB value of a linear value in [0;1]
+inline u32 linearToSRGB(const f32 x)
+{
+	u32 y = 0;
+	y += Tables.SRGBUpper[y + 127] <= x ? 128 : 0;
+	y += Tables.SRGBUpper[y + 63] <= x ? 64 : 0;
+	y += Tables.SRGBUpper[y + 31] <= x ? 32 : 0;
+	y += Tables.SRGBUpper[y + 15] <= x ? 16 : 0;
+	y += Tables.SRGBUpper[y + 7] <= x ? 8 : 0;
+	y += Tables.SRGBUpper[y + 3] <= x ? 4 : 0;
+	y += Tables.SRGBUpper[y + 1] <= x ? 2 : 0;
+	y += Tables.SRGBUpper[y] <= x ? 1 : 0;
+	return y;
+}
+
+//! weighted sum of the kaiser taps, index are the tap positions in units of stride floats
+inline void kaiserTexel(f32* target, const f32* src, const s32* index, u32 stride)
+{
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	__m128 sum = _mm_setzero_ps();
+	for (s32 k = 0; k < KAISER_TAPS; ++k)
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + index[k] * stride), _mm_set1_ps(Tables.Kaiser[k])));
+	_mm_storeu_ps(target, sum);
+#else
+	target[0] = target[1] = target[2] = target[3] = 0.f;
+	for (s32 k = 0; k < KAISER_TAPS; ++k)
+	{
+		const f32* texel = src + index[k] * stride;
+		const f32 w = Tables.Kaiser[k];
+		target[0] += texel[0] * w;
+		target[1] += texel[1] * w;
+		target[2] += texel[2] * w;
+		target[3] += texel[3] * w;
+	}
+#endif
+}
+
+//! source texel indices of the kaiser taps for each target texel, clamped to the border
+void kaiserIndices(core::array<s32>& indices, u32 sourceSize, u32 targetSize)
+{
+	indices.set_used(targetSize * KAISER_TAPS);
+	for (u32 i = 0; i < targetSize; ++i)
+	{
+		for (s32 k = 0; k < KAISER_TAPS; ++k)
+			indices[i * KAISER_TAPS + k] = core::s32_clamp((s32)i * 2 - 5 + k, 0, (s32)sourceSize - 1);
+	}
+}
+
+} // end anonymous namespace
+
+
+CMipMapGenerator::CMipMapGenerator(const IImage* image, E_MIPMAP_FILTER filter, bool sRGB)
+	: Filter(filter), SRGB(sRGB), Valid(false)
+{
+	if (!image || image->getColorFormat() != ECF_A8R8G8B8 || !image->getData())
+		return;
+
+	Size = image->getDimension();
+	Level.set_used(Size.Width * Size.Height * 4);
+
+	f32* p = Level.pointer();
+	for (u32 y = 0; y < Size.Height; ++y)
+	{
+		const u32* src = (const u32*)((const u8*)image->getData() + y * image->getPitch());
+		for (u32 x = 0; x < Size.Width; ++x, p += 4)
+		{
+			const u32 c = src[x];
+			if (SRGB)
+			{
+				p[0] = Tables.ToLinear[c & 0xFF];
+				p[1] = Tables.ToLinear[(c >> 8) & 0xFF];
+				p[2] = Tables.ToLinear[(c >> 16) & 0xFF];
+			}
+			else
+			{
+				p[0] = (c & 0xFF) * (1.f / 255.f);
+				p[1] = ((c >> 8) & 0xFF) * (1.f / 255.f);
+				p[2] = ((c >> 16) & 0xFF) * (1.f / 255.f);
+			}
+			p[3] = (c >> 24) * (1.f / 255.f);
+		}
+	}
+	Valid = true;
+}
+
+
+bool CMipMapGenerator::generate(IImage* image)
+{
+	if (!Valid)
+		return false;
+
+	NextSize = getHalfSize(Size);
+	if (!image || image->getColorFormat() != ECF_A8R8G8B8 || !image->getData() ||
+		NextSize.Width == 0 || image->getDimension() != NextSize)
+	{
+		Valid = false;
+		return false;
+	}
+
+	Next.set_used(NextSize.Width * NextSize.Height * 4);
+	if (Filter == EMMF_KAISER)
+		filterKaiser(Next.pointer());
+	else
+		filterBox(Next.pointer());
+
+	// clamp the level (the kaiser filter overshoots) and write it
+	f32* p = Next.pointer();
+	for (u32 y = 0; y < NextSize.Height; ++y)
+	{
+		u32* dst = (u32*)((u8*)image->getData() + y * image->getPitch());
+		for (u32 x = 0; x < NextSize.Width; ++x, p += 4)
+		{
+#ifdef _IRR_COMPILE_WITH_SSE2_
+			const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(p), _mm_setzero_ps()), _mm_set1_ps(1.f));
+			_mm_storeu_ps(p, v);
+			if (!SRGB)
+			{
+				__m128i i = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.f)), _mm_set1_ps(TRUNCATE_BIAS)));
+				i = _mm_packs_epi32(i, i);
+				dst[x] = (u32)_mm_cvtsi128_si32(_mm_packus_epi16(i, i));
+				continue;
+			}
+#else
+			for (u32 i = 0; i < 4; ++i)
+				p[i] = core::clamp(p[i], 0.f, 1.f);
+			if (!SRGB)
+			{
+				dst[x] = (u32)(p[0] * 255.f + TRUNCATE_BIAS) |
+					(u32)(p[1] * 255.f + TRUNCATE_BIAS) << 8 |
+					(u32)(p[2] * 255.f + TRUNCATE_BIAS) << 16 |
+					(u32)(p[3] * 255.f + TRUNCATE_BIAS) << 24;
+				continue;
+			}
+#endif
+			dst[x] = linearToSRGB(p[0]) |
+				linearToSRGB(p[1]) << 8 |
+				linearToSRGB(p[2]) << 16 |
+				(u32)(p[3] * 255.f + TRUNCATE_BIAS) << 24;
+		}
+	}
+
+	Level.swap(Next);
+	Size = NextSize;
+	return true;
+}
+
+
+//! 2x2 box, sides of size 1 use the same texel twice
+void CMipMapGenerator::filterBox(f32* target)
+{
+	const u32 stepX = Size.Width > 1 ? 8 : 0;
+	const u32 stepY = Size.Height > 1 ? Size.Width * 4 : 0;
+	const u32 rowStep = Size.Height > 1 ? Size.Width * 8 : Size.Width * 4;
+
+	const f32* row = Level.const_pointer();
+	for (u32 y = 0; y < NextSize.Height; ++y, row += rowStep)
+	{
+		const f32* a = row;
+		for (u32 x = 0; x < NextSize.Width; ++x, a += stepX, target += 4)
+		{
+			const f32* b = a + (stepX ? 4 : 0);
+			const f32* c = a + stepY;
+			const f32* d = b + stepY;
+#ifdef _IRR_COMPILE_WITH_SSE2_
+			const __m128 s = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)),
+				_mm_add_ps(_mm_loadu_ps(c), _mm_loadu_ps(d)));
+			_mm_storeu_ps(target, _mm_mul_ps(s, _mm_set1_ps(0.25f)));
+#else
+			for (u32 i = 0; i < 4; ++i)
+				target[i] = (a[i] + b[i] + c[i] + d[i]) * 0.25f;
+#endif
+		}
+	}
+}
+
+
+//! separable kaiser filter, first along x into Temp, then along y
+void CMipMapGenerator::filterKaiser(f32* target)
+{
+	core::array<s32> indices;
+
+	const f32* src = Level.const_pointer();
+	u32 width = Size.Width;
+	if (Size.Width > 1)
+	{
+		kaiserIndices(indices, Size.Width, NextSize.Width);
+		Temp.set_used(NextSize.Width * Size.Height * 4);
+		f32* dst = Temp.pointer();
+		for (u32 y = 0; y < Size.Height; ++y)
+		{
+			const f32* row = src + y * Size.Width * 4;
+			for (u32 x = 0; x < NextSize.Width; ++x, dst += 4)
+				kaiserTexel(dst, row, indices.const_pointer() + x * KAISER_TAPS, 4);
+		}
+		src = Temp.const_pointer();
+		width = NextSize.Width;
+	}
+
+	if (Size.Height == 1)
+	{
+		memcpy(target, src, NextSize.Width * 4 * sizeof(f32));
+		return;
+	}
+
+	kaiserIndices(indices, Size.Height, NextSize.Height);
+	for (u32 y = 0; y < NextSize.Height; ++y)
+	{
+		const s32* index = indices.const_pointer() + y * KAISER_TAPS;
+		for (u32 x = 0; x < width; ++x, target += 4)
+			kaiserTexel(target, src + x * 4, index, width * 4);
+	}
+}
+
+
+bool CMipMapGenerator::halveBox(const IImage* source, IImage* target)
+{
+	if (!source || !target ||
+		source->getColorFormat() != ECF_A8R8G8B8 || target->getColorFormat() != ECF_A8R8G8B8)
+		return false;
+
+	const core::dimension2du& size = source->getDimension();
+	const core::dimension2du targetSize = getHalfSize(size);
+	if (targetSize.Width == 0 || target->getDimension() != targetSize)
+		return false;
+
+	const u8* srcData = (const u8*)source->getData();
+	u8* dstData = (u8*)target->getData();
+	if (!srcData || !dstData)
+		return false;
+
+	const u32 stepX = size.Width > 1 ? 2 : 0;
+	const u32 stepY = size.Height > 1 ? source->getPitch() : 0;
+
+	for (u32 y = 0; y < targetSize.Height; ++y)
+	{
+		const u32* a = (const u32*)(srcData + (size.Height > 1 ? y * 2 : y) * source->getPitch());
+		const u32* c = (const u32*)((const u8*)a + stepY);
+		u32* dst = (u32*)(dstData + y * target->getPitch());
+		for (u32 x = 0; x < targetSize.Width; ++x, a += stepX, c += stepX)
+		{
+			const u32 b = stepX ? 1 : 0;
+#ifdef _IRR_COMPILE_WITH_SSE2_
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int)a[0]), _mm_cvtsi32_si128((int)a[b])), zero);
+			const __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int)c[0]), _mm_cvtsi32_si128((int)c[b])), zero);
+			__m128i sum = _mm_add_epi16(top, bottom);
+			sum = _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_si128(sum, 8)), 2);
+			dst[x] = (u32)_mm_cvtsi128_si32(_mm_packus_epi16(sum, sum));
+#else
+			u32 result = 0;
+			for (u32 shift = 0; shift < 32; shift += 8)
+			{
+				const u32 sum = ((a[0] >> shift) & 0xFF) + ((a[b] >> shift) & 0xFF) +
+					((c[0] >> shift) & 0xFF) + ((c[b] >> shift) & 0xFF);
+				result |= (sum >> 2) << shift;
+			}
+			dst[x] = result;
+#endif
+		}
+	}
+	return true;
+}
+
+
+core::dimension2du CMipMapGenerator::getHalfSize(const core::dimension2du& size)
+{
+	if ((size.Width > 1 && (size.Width & 1)) || (size.Height > 1 && (size.Height & 1)) ||
+		(size.Width <= 1 && size.Height <= 1))
+		return core::dimension2du(0, 0);
+
+	return core::dimension2du(size.Width > 1 ? size.Width / 2 : 1,
+		size.Height > 1 ? size.Height / 2 : 1);
+}
+
+} // end namespace video
+} // end namespace irr
+
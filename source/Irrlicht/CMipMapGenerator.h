@@ -0,0 +1,82 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_MIP_MAP_GENERATOR_H_INCLUDED__
+#define __C_MIP_MAP_GENERATOR_H_INCLUDED__
+
+#include "IImage.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Filters which can be used to create the mip map levels
+enum E_MIPMAP_FILTER
+{
+	//! Average of 2x2 texels
+	EMMF_BOX = 0,
+
+	//! Windowed sinc (Kaiser) filter with 12 taps, sharper than box
+	EMMF_KAISER
+};
+
+//! Creates mip map chains for A8R8G8B8 images.
+/** Each level is calculated from the previous one, which is kept with
+floating point precision in linear color space, so there is no loss by
+rounding or by the sRGB conversion from level to level. Uses SSE2 when
+_IRR_COMPILE_WITH_SSE2_ is defined.
+Only halving is supported, so levels of images with odd sizes can't be
+created and generate() fails. The caller has to fall back to a general
+resampling then. */
+class CMipMapGenerator
+{
+public:
+
+	//! Constructor
+	/** \param image: Level 0 of the chain.
+	\param filter: Filter used for all levels.
+	\param sRGB: Color channels are sRGB encoded and are filtered in linear
+	space, alpha is always linear. */
+	CMipMapGenerator(const IImage* image, E_MIPMAP_FILTER filter, bool sRGB);
+
+	//! Writes the next level into image
+	/** \param image: A8R8G8B8 image with half the size of the previous
+	level. Sides which are 1 already stay 1.
+	\return False if the level can't be created. The generator is
+	unusable afterwards. */
+	bool generate(IImage* image);
+
+	//! Halves an A8R8G8B8 image with a 2x2 box filter
+	/** Channels are averaged in 8 bit and rounded down, like
+	IImage::copyToScalingBoxFilter does without bias.
+	\return False if target is not half the size of source or the
+	formats are not A8R8G8B8 */
+	static bool halveBox(const IImage* source, IImage* target);
+
+	//! Returns the size of the level below size, or 0,0 if it can't be halved
+	static core::dimension2du getHalfSize(const core::dimension2du& size);
+
+private:
+
+	void filterBox(f32* target);
+	void filterKaiser(f32* target);
+
+	//! current level, 4 linear floats per texel in b,g,r,a order
+	core::array<f32> Level;
+	core::array<f32> Next;
+	core::array<f32> Temp;
+	core::dimension2du Size;
+	core::dimension2du NextSize;
+	E_MIPMAP_FILTER Filter;
+	bool SRGB;
+	bool Valid;
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -14,8 +14,13 @@
 #include "IAnimatedMeshSceneNode.h"
 #include "CMeshManipulator.h"
 #include "CColorConverter.h"
+#include "irrHash.h"
+#include "CTextureCompressor.h"
 #include "IAttributeExchangingObject.h"
 #include "IRenderTarget.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
+#include "IJobSystem.h"
 
 
 namespace irr
@@ -84,9 +89,12 @@ IImageWriter* createImageWriterPNG();
 //! creates a writer which is able to save ppm images
 IImageWriter* createImageWriterPPM();
 
+//! creates a writer which is able to save pvr images
+IImageWriter* createImageWriterPVR();
+
 //! constructor
 CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
-	: SharedRenderTarget(0), CurrentRenderTarget(0), CurrentRenderTargetSize(0, 0), FileSystem(io), MeshManipulator(0),
+	: SharedRenderTarget(0), CurrentRenderTarget(0), CurrentRenderTargetSize(0, 0), FileSystem(io), JobSystem(0), MeshManipulator(0),
 	ViewPort(0, 0, 0, 0), ScreenSize(screenSize), PrimitivesDrawn(0), MinVertexCountForVBO(500),
 	TextureCreationFlags(0), OverrideMaterial2DEnabled(false), AllowZWriteOnTransparent(false)
 {
@@ -125,6 +133,25 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 	if (FileSystem)
 		FileSystem->grab();
 
+	IRR_PROFILE(
+		static bool initProfile = false;
+		if (!initProfile )
+		{
+			initProfile = true;
+			getProfiler().add(EPID_IL_BMP, L"bmp", L"Image loaders");
+			getProfiler().add(EPID_IL_DDS, L"dds", L"Image loaders");
+			getProfiler().add(EPID_IL_JPG, L"jpg", L"Image loaders");
+			getProfiler().add(EPID_IL_PCX, L"pcx", L"Image loaders");
+			getProfiler().add(EPID_IL_PNG, L"png", L"Image loaders");
+			getProfiler().add(EPID_IL_PPM, L"ppm", L"Image loaders");
+			getProfiler().add(EPID_IL_PSD, L"psd", L"Image loaders");
+			getProfiler().add(EPID_IL_PVR, L"pvr", L"Image loaders");
+			getProfiler().add(EPID_IL_RGB, L"rgb", L"Image loaders");
+			getProfiler().add(EPID_IL_TGA, L"tga", L"Image loaders");
+			getProfiler().add(EPID_IL_WAL, L"wal", L"Image loaders");
+		}
+	)
+
 	// create surface loader
 
 #ifdef _IRR_COMPILE_WITH_WAL_LOADER_
@@ -172,6 +199,9 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 #ifdef _IRR_COMPILE_WITH_PCX_WRITER_
 	SurfaceWriter.push_back(video::createImageWriterPCX());
 #endif
+#ifdef _IRR_COMPILE_WITH_PVR_WRITER_
+	SurfaceWriter.push_back(video::createImageWriterPVR());
+#endif
 #ifdef _IRR_COMPILE_WITH_PSD_WRITER_
 	SurfaceWriter.push_back(video::createImageWriterPSD());
 #endif
@@ -219,6 +249,9 @@ CNullDriver::~CNullDriver()
 	if (FileSystem)
 		FileSystem->drop();
 
+	if (JobSystem)
+		JobSystem->drop();
+
 	if (MeshManipulator)
 		MeshManipulator->drop();
 
@@ -328,6 +361,7 @@ bool CNullDriver::endScene()
 	FPSCounter.registerFrame(os::Timer::getRealTime(), PrimitivesDrawn);
 	updateAllHardwareBuffers();
 	updateAllOcclusionQueries();
+	IRR_PROFILE(getProfiler().endFrame();)
 	return true;
 }
 
@@ -556,6 +590,13 @@ ITexture* CNullDriver::addTextureCubemap(const irr::u32 sideLen, const io::path&
 //! loads a Texture
 ITexture* CNullDriver::getTexture(const io::path& filename)
 {
+	if (JobSystem && !JobSystem->isMainThread())
+	{
+		SMainThreadCall call = { this, &filename, 0, 0, 0.f };
+		JobSystem->runOnMainThread(getTextureOnMainThread, &call);
+		return call.Texture;
+	}
+
 	// Identify textures by their absolute filenames if possible.
 	const io::path absolutePath = FileSystem->getAbsolutePath(filename);
 
@@ -618,6 +659,13 @@ ITexture* CNullDriver::getTexture(const io::path& filename)
 //! loads a Texture
 ITexture* CNullDriver::getTexture(io::IReadFile* file)
 {
+	if (JobSystem && !JobSystem->isMainThread())
+	{
+		SMainThreadCall call = { this, 0, file, 0, 0.f };
+		JobSystem->runOnMainThread(getTextureOnMainThread, &call);
+		return call.Texture;
+	}
+
 	ITexture* texture = 0;
 
 	if (file)
@@ -647,6 +695,27 @@ ITexture* CNullDriver::getTexture(io::IReadFile* file)
 }
 
 
+void CNullDriver::getTextureOnMainThread(void* data)
+{
+	SMainThreadCall* call = (SMainThreadCall*)data;
+	CNullDriver* driver = const_cast<CNullDriver*>(call->Driver);
+	if (call->Filename)
+		call->Texture = driver->getTexture(*call->Filename);
+	else
+		call->Texture = driver->getTexture(call->File);
+}
+
+
+void CNullDriver::setJobSystem(IJobSystem* jobs)
+{
+	if (jobs)
+		jobs->grab();
+	if (JobSystem)
+		JobSystem->drop();
+	JobSystem = jobs;
+}
+
+
 //! opens the file and loads it into the surface
 video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io::path& hashName )
 {
@@ -654,7 +723,19 @@ video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io:
 
 	E_TEXTURE_TYPE type = ETT_2D;
 
-	core::array<IImage*> imageArray = createImagesFromFile(file, &type);
+	core::array<IImage*> imageArray;
+
+	const ECOLOR_FORMAT compression = getTextureCreationFlag(ETCF_ALLOW_COMPRESSION) ?
+		getTextureCompressionFormat() : ECF_UNKNOWN;
+	if (compression != ECF_UNKNOWN)
+	{
+		IImage* image = createCompressedImage(file, compression, imageArray, type);
+		if (image)
+			imageArray.push_back(image);
+	}
+
+	if (imageArray.empty())
+		imageArray = createImagesFromFile(file, &type);
 
 	if (checkImage(imageArray))
 	{
@@ -688,6 +769,138 @@ video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io:
 }
 
 
+static const u32 TEXTURE_COMPRESSION_CACHE_VERSION = 1;
+
+//! Returns the format used for textures loaded with ETCF_ALLOW_COMPRESSION
+ECOLOR_FORMAT CNullDriver::getTextureCompressionFormat() const
+{
+	if (queryFeature(EVDF_TEXTURE_COMPRESSED_DXT))
+		return ECF_DXT1;
+	if (queryFeature(EVDF_TEXTURE_COMPRESSED_ETC2))
+		return ECF_ETC2_RGB;
+	return ECF_UNKNOWN;
+}
+
+
+//! Loads the compressed texture from the texture cache or compresses it into the cache
+IImage* CNullDriver::createCompressedImage(io::IReadFile* file, ECOLOR_FORMAT format,
+		core::array<IImage*>& images, E_TEXTURE_TYPE& type)
+{
+#if defined(_IRR_COMPILE_WITH_PVR_LOADER_) && defined(_IRR_COMPILE_WITH_PVR_WRITER_)
+	if (!file || TextureCacheDirectory.empty() || !CTextureCompressor::canCompress(format))
+		return 0;
+
+	const bool dxt = (format == ECF_DXT1 || format == ECF_DXT5);
+	const bool mipMaps = getTextureCreationFlag(ETCF_CREATE_MIP_MAPS);
+
+	// the cache file is named by a hash of the file content and of the settings
+	const u32 settings[] = { TEXTURE_COMPRESSION_CACHE_VERSION, dxt ? 1u : 2u, mipMaps ? 1u : 0u };
+	u64 hash = os::hash(settings, sizeof(settings));
+
+	core::array<u8> buffer;
+	buffer.set_used(0x10000);
+	file->seek(0);
+	size_t read;
+	while ((read = file->read(buffer.pointer(), buffer.size())) > 0)
+		hash = os::hash(buffer.pointer(), read, hash);
+	file->seek(0);
+
+	c8 buf[32];
+	snprintf_irr(buf, sizeof(buf), "%08x%08x.pvr", (u32)(hash >> 32), (u32)hash);
+	const io::path cacheName = TextureCacheDirectory + buf;
+
+	io::IReadFile* cacheFile = FileSystem->createAndOpenFile(cacheName);
+	if (cacheFile)
+	{
+		core::array<IImage*> cached = createImagesFromFile(cacheFile, &type);
+		cacheFile->drop();
+
+		IImage* image = 0;
+		if (cached.size() == 1 && cached[0])
+		{
+			const ECOLOR_FORMAT cachedFormat = cached[0]->getColorFormat();
+			if (dxt ? (cachedFormat == ECF_DXT1 || cachedFormat == ECF_DXT5) :
+				(cachedFormat == ECF_ETC2_RGB || cachedFormat == ECF_ETC2_ARGB))
+			{
+				image = cached[0];
+				image->grab();
+			}
+		}
+		for (u32 i = 0; i < cached.size(); ++i)
+		{
+			if (cached[i])
+				cached[i]->drop();
+		}
+		if (image)
+			return image;
+
+		os::Printer::log("Ignoring invalid compressed texture cache file", cacheName, ELL_WARNING);
+	}
+
+	images = createImagesFromFile(file, &type);
+	if (type != ETT_2D || images.size() != 1 || !images[0])
+		return 0;
+
+	const ECOLOR_FORMAT targetFormat = CTextureCompressor::getFormatForImage(images[0], format);
+	const core::dimension2du& size = images[0]->getDimension();
+	if (targetFormat == ECF_UNKNOWN || size.getOptimalSize(true, false) != size)
+		return 0;
+
+	IImage* image = CTextureCompressor::compress(images[0], targetFormat, mipMaps);
+	if (!image)
+		return 0;
+
+	if (!writeImageToFile(image, cacheName))
+		os::Printer::log("Could not write compressed texture cache file", cacheName, ELL_WARNING);
+
+	images[0]->drop();
+	images.clear();
+	type = ETT_2D;
+
+	return image;
+#else
+	return 0;
+#endif
+}
+
+
+//! Compresses a texture file into the texture cache directory
+bool CNullDriver::addTextureToCompressionCache(const io::path& filename, ECOLOR_FORMAT format)
+{
+	if (TextureCacheDirectory.empty())
+	{
+		os::Printer::log("No texture cache directory set, can't cache compressed texture", filename, ELL_WARNING);
+		return false;
+	}
+
+	io::IReadFile* file = FileSystem->createAndOpenFile(filename);
+	if (!file)
+	{
+		os::Printer::log("Could not open file of texture", filename, ELL_WARNING);
+		return false;
+	}
+
+	core::array<IImage*> images;
+	E_TEXTURE_TYPE type = ETT_2D;
+	IImage* image = createCompressedImage(file, format, images, type);
+	file->drop();
+
+	for (u32 i = 0; i < images.size(); ++i)
+	{
+		if (images[i])
+			images[i]->drop();
+	}
+
+	if (!image)
+	{
+		os::Printer::log("Could not compress texture", filename, ELL_WARNING);
+		return false;
+	}
+
+	image->drop();
+	return true;
+}
+
 //! adds a surface, not loaded or created by the Irrlicht Engine
 void CNullDriver::addTexture(video::ITexture* texture)
 {
@@ -795,6 +1008,8 @@ void CNullDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 	if ((iType==EIT_16BIT) && (vertexCount>65536))
 		os::Printer::log("Too many vertices for 16bit index type, render artifacts may occur.");
 	PrimitivesDrawn += primitiveCount;
+	IRR_PROFILE(getProfiler().addToCounter(EPC_DRAW_CALLS, 1);)
+	IRR_PROFILE(getProfiler().addToCounter(EPC_PRIMITIVES, primitiveCount);)
 }
 
 
@@ -1321,6 +1536,13 @@ void CNullDriver::makeNormalMapTexture(video::ITexture* texture, f32 amplitude)
 	if (!texture)
 		return;
 
+	if (JobSystem && !JobSystem->isMainThread())
+	{
+		SMainThreadCall call = { this, 0, 0, texture, amplitude };
+		JobSystem->runOnMainThread(makeNormalMapTextureOnMainThread, &call);
+		return;
+	}
+
 	if (texture->getColorFormat() != ECF_A1R5G5B5 &&
 		texture->getColorFormat() != ECF_A8R8G8B8 )
 	{
@@ -1431,6 +1653,13 @@ void CNullDriver::makeNormalMapTexture(video::ITexture* texture, f32 amplitude)
 }
 
 
+void CNullDriver::makeNormalMapTextureOnMainThread(void* data)
+{
+	SMainThreadCall* call = (SMainThreadCall*)data;
+	call->Driver->makeNormalMapTexture(call->Texture, call->Amplitude);
+}
+
+
 //! Returns the maximum amount of primitives (mostly vertices) which
 //! the device is able to render with one drawIndexedTriangleList
 //! call.
@@ -1567,6 +1796,23 @@ bool CNullDriver::getTextureCreationFlag(E_TEXTURE_CREATION_FLAG flag) const
 	return (TextureCreationFlags & flag)!=0;
 }
 
+
+//! Sets a directory in which drivers can keep data they compute from textures.
+void CNullDriver::setTextureCacheDirectory(const io::path& path)
+{
+	TextureCacheDirectory = path;
+	if (TextureCacheDirectory.size() && TextureCacheDirectory.lastChar() != '/' &&
+		TextureCacheDirectory.lastChar() != '\\')
+		TextureCacheDirectory.append('/');
+}
+
+
+//! Returns the directory set with setTextureCacheDirectory()
+const io::path& CNullDriver::getTextureCacheDirectory() const
+{
+	return TextureCacheDirectory;
+}
+
 core::array<IImage*> CNullDriver::createImagesFromFile(const io::path& filename, E_TEXTURE_TYPE* type)
 {
 	// TO-DO -> use 'move' feature from C++11 standard.
@@ -1651,6 +1897,88 @@ core::array<IImage*> CNullDriver::createImagesFromFile(io::IReadFile* file, E_TE
 }
 
 
+//! Creates a software image from a part of an image file.
+IImage* CNullDriver::createImagePartFromFile(const io::path& filename, const core::rect<s32>& sourceRect, u32 scaleDenom)
+{
+	IImage* image = 0;
+
+	if (filename.size() > 0)
+	{
+		io::IReadFile* file = FileSystem->createAndOpenFile(filename);
+
+		if (file)
+		{
+			image = createImagePartFromFile(file, sourceRect, scaleDenom);
+			file->drop();
+		}
+		else
+			os::Printer::log("Could not open file of image", filename, ELL_WARNING);
+	}
+
+	return image;
+}
+
+
+//! Creates a software image from a part of an image file.
+IImage* CNullDriver::createImagePartFromFile(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom)
+{
+	if (!file)
+		return 0;
+
+	IImageLoader* loader = 0;
+	s32 i;
+
+	// find loader based on file extension first and on what is in the file second
+	for (i = SurfaceLoader.size() - 1; i >= 0 && !loader; --i)
+	{
+		if (SurfaceLoader[i]->isALoadableFileExtension(file->getFileName()))
+			loader = SurfaceLoader[i];
+	}
+
+	for (i = SurfaceLoader.size() - 1; i >= 0 && !loader; --i)
+	{
+		file->seek(0);
+		if (SurfaceLoader[i]->isALoadableFileFormat(file))
+			loader = SurfaceLoader[i];
+	}
+
+	if (!loader)
+		return 0;
+
+	file->seek(0);
+	if (loader->isImagePartLoadingSupported())
+		return loader->loadImagePart(file, sourceRect, scaleDenom);
+
+	// loader can't decode parts, so crop and scale the full image
+	IImage* image = loader->loadImage(file);
+	if (!image)
+		return 0;
+
+	if (IImage::isCompressedFormat(image->getColorFormat()))
+	{
+		os::Printer::log("Can't create image part from compressed image", file->getFileName(), ELL_WARNING);
+		image->drop();
+		return 0;
+	}
+
+	const core::rect<s32> partRect = getImagePartRect(image->getDimension(), sourceRect, scaleDenom);
+	IImage* part = 0;
+	if (partRect.getWidth() > 0 && partRect.getHeight() > 0)
+	{
+		const u32 step = scaleDenom > 1 ? scaleDenom : 1;
+		part = new CImage(image->getColorFormat(), core::dimension2d<u32>(partRect.getWidth(), partRect.getHeight()));
+		for (u32 y=0; y<part->getDimension().Height; ++y)
+		{
+			for (u32 x=0; x<part->getDimension().Width; ++x)
+				part->setPixel(x, y, image->getPixel((partRect.UpperLeftCorner.X + x) * step, (partRect.UpperLeftCorner.Y + y) * step));
+		}
+	}
+	image->drop();
+
+	return part;
+}
+
+
 //! Writes the provided image to disk file
 bool CNullDriver::writeImageToFile(IImage* image, const io::path& filename,u32 param)
 {
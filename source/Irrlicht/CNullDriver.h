@@ -28,6 +28,7 @@
 
 namespace irr
 {
+class IJobSystem;
 namespace io
 {
 	class IWriteFile;
@@ -361,10 +362,33 @@ namespace video
 		//! Returns if a texture creation flag is enabled or disabled.
 		virtual bool getTextureCreationFlag(E_TEXTURE_CREATION_FLAG flag) const _IRR_OVERRIDE_;
 
+		//! Sets a directory in which drivers can keep data they compute from textures.
+		virtual void setTextureCacheDirectory(const io::path& path) _IRR_OVERRIDE_;
+
+		//! Returns the directory set with setTextureCacheDirectory()
+		virtual const io::path& getTextureCacheDirectory() const _IRR_OVERRIDE_;
+
+		//! Compresses a texture file into the texture cache directory
+		virtual bool addTextureToCompressionCache(const io::path& filename, ECOLOR_FORMAT format) _IRR_OVERRIDE_;
+
+		//! Returns the file system used by the driver
+		io::IFileSystem* getFileSystem() const { return FileSystem; }
+
+		//! Sets the job system whose main thread owns the driver
+		/** Jobs which load textures or make normal maps leave that work
+		to the main thread then. */
+		void setJobSystem(IJobSystem* jobs);
+
 		virtual core::array<IImage*> createImagesFromFile(const io::path& filename, E_TEXTURE_TYPE* type = 0) _IRR_OVERRIDE_;
 
 		virtual core::array<IImage*> createImagesFromFile(io::IReadFile* file, E_TEXTURE_TYPE* type = 0) _IRR_OVERRIDE_;
 
+		//! Creates a software image from a part of an image file.
+		virtual IImage* createImagePartFromFile(const io::path& filename, const core::rect<s32>& sourceRect, u32 scaleDenom=1) _IRR_OVERRIDE_;
+
+		//! Creates a software image from a part of an image file.
+		virtual IImage* createImagePartFromFile(io::IReadFile* file, const core::rect<s32>& sourceRect, u32 scaleDenom=1) _IRR_OVERRIDE_;
+
 		//! Creates a software image from a byte array.
 		/** \param useForeignMemory: If true, the image will use the data pointer
 		directly and own it from now on, which means it will also try to delete [] the
@@ -713,6 +737,31 @@ namespace video
 		//! opens the file and loads it into the surface
 		ITexture* loadTextureFromFile(io::IReadFile* file, const io::path& hashName = "");
 
+		//! Arguments of a texture call which another thread left to the main thread
+		struct SMainThreadCall
+		{
+			const CNullDriver* Driver;
+			const io::path* Filename;
+			io::IReadFile* File;
+			ITexture* Texture;
+			f32 Amplitude;
+		};
+
+		static void getTextureOnMainThread(void* data);
+		static void makeNormalMapTextureOnMainThread(void* data);
+
+		//! Returns the format used for textures loaded with ETCF_ALLOW_COMPRESSION
+		/** ECF_DXT1 or ECF_ETC2_RGB for the format families, or ECF_UNKNOWN
+		when the driver supports neither. */
+		virtual ECOLOR_FORMAT getTextureCompressionFormat() const;
+
+		//! Loads the compressed texture from the texture cache or compresses it into the cache
+		/** \param images Receives the decoded images of file when it had to
+		be decoded but could not be compressed.
+		\return Compressed image or 0. */
+		IImage* createCompressedImage(io::IReadFile* file, ECOLOR_FORMAT format,
+			core::array<IImage*>& images, E_TEXTURE_TYPE& type);
+
 		//! adds a surface, not loaded or created by the Irrlicht Engine
 		void addTexture(ITexture* surface);
 		
@@ -878,6 +927,7 @@ namespace video
 		core::map< const scene::IMeshBuffer* , SHWBufferLink* > HWBufferMap;
 
 		io::IFileSystem* FileSystem;
+		IJobSystem* JobSystem;
 
 		//! mesh manipulator
 		scene::IMeshManipulator* MeshManipulator;
@@ -892,6 +942,7 @@ namespace video
 		u32 MinVertexCountForVBO;
 
 		u32 TextureCreationFlags;
+		io::path TextureCacheDirectory;
 
 		f32 FogStart;
 		f32 FogEnd;
@@ -17,6 +17,8 @@
 #include "fast_atof.h"
 #include "coreutil.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -66,6 +68,7 @@ bool COBJMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_OBJ);)
 	if (!file)
 		return 0;
 
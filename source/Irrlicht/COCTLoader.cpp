@@ -21,6 +21,8 @@
 #include "SMeshBufferLightMap.h"
 #include "irrString.h"
 #include "ISceneManager.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -85,6 +87,7 @@ void COCTLoader::OCTLoadLights(io::IReadFile* file, scene::ISceneNode * parent,
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* COCTLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_OCT);)
 	if (!file)
 		return 0;
 
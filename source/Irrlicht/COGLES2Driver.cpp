@@ -561,6 +561,7 @@ COGLES2Driver::~COGLES2Driver()
 		IRR_PROFILE(CProfileScope p1(EPID_ES2_UPDATE_VERTEX_HW_BUF);)
 
 		const scene::IMeshBuffer* mb = HWBuffer->MeshBuffer;
+		IRR_PROFILE(getProfiler().addToCounter(EPC_BUFFER_UPLOADS, 1);)
 		const void* vertices = mb->getVertices();
 		const u32 vertexCount = mb->getVertexCount();
 		const E_VERTEX_TYPE vType = mb->getVertexType();
@@ -612,6 +613,7 @@ COGLES2Driver::~COGLES2Driver()
 		IRR_PROFILE(CProfileScope p1(EPID_ES2_UPDATE_INDEX_HW_BUF);)
 
 		const scene::IMeshBuffer* mb = HWBuffer->MeshBuffer;
+		IRR_PROFILE(getProfiler().addToCounter(EPC_BUFFER_UPLOADS, 1);)
 
 		const void* indices = mb->getIndices();
 		u32 indexCount = mb->getIndexCount();
@@ -282,6 +282,7 @@ bool COGLES1Driver::updateVertexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 		return false;
 
 	const scene::IMeshBuffer* mb = HWBuffer->MeshBuffer;
+	IRR_PROFILE(getProfiler().addToCounter(EPC_BUFFER_UPLOADS, 1);)
 	const void* vertices=mb->getVertices();
 	const u32 vertexCount=mb->getVertexCount();
 	const E_VERTEX_TYPE vType=mb->getVertexType();
@@ -370,6 +371,7 @@ bool COGLES1Driver::updateIndexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 		return false;
 
 	const scene::IMeshBuffer* mb = HWBuffer->MeshBuffer;
+	IRR_PROFILE(getProfiler().addToCounter(EPC_BUFFER_UPLOADS, 1);)
 
 	const void* indices=mb->getIndices();
 	u32 indexCount= mb->getIndexCount();
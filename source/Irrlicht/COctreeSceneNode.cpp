@@ -13,6 +13,8 @@
 #include "IMeshCache.h"
 #include "IAnimatedMesh.h"
 #include "IMaterialRenderer.h"
+#include "IFileSystem.h"
+#include "IJobSystem.h"
 #include "os.h"
 #ifdef _IRR_COMPILE_WITH_SHADOW_VOLUME_SCENENODE_
 #include "CShadowVolumeSceneNode.h"
@@ -27,19 +29,61 @@ namespace irr
 namespace scene
 {
 
+//! Reads the octree of the meshes from the octree cache or creates it and writes it there
+template <class T>
+Octree<T>* createOctree(const core::array<typename Octree<T>::SMeshChunk>& meshes,
+	s32 minimalPolysPerNode, IJobSystem* jobs,
+	io::IFileSystem* fileSystem, const io::path& cacheDirectory)
+{
+	u64 hash = 0;
+	if (!cacheDirectory.empty())
+	{
+		hash = Octree<T>::getCacheHash(meshes, minimalPolysPerNode);
+
+		u32 nodeCount = 0;
+		io::IReadFile* file = openOctreeCache(fileSystem, cacheDirectory, hash, nodeCount);
+		if (file)
+		{
+			Octree<T>* octree = new Octree<T>(meshes, file);
+			file->drop();
+			if (octree->isValid() && octree->getNodeCount() == nodeCount)
+				return octree;
+
+			os::Printer::log("Octree cache file is invalid", getOctreeCacheName(cacheDirectory, hash), ELL_WARNING);
+			delete octree;
+		}
+	}
+
+	Octree<T>* octree = new Octree<T>(meshes, minimalPolysPerNode, jobs);
+
+	if (!cacheDirectory.empty())
+	{
+		io::IWriteFile* file = createOctreeCache(fileSystem, cacheDirectory, hash, octree->getNodeCount());
+		if (file)
+		{
+			octree->write(file);
+			file->drop();
+		}
+	}
+	return octree;
+}
+
 
 //! constructor
 COctreeSceneNode::COctreeSceneNode(ISceneNode* parent, ISceneManager* mgr,
-					 s32 id, s32 minimalPolysPerNode)
+					 s32 id, s32 minimalPolysPerNode, IJobSystem* jobs)
 	: IOctreeSceneNode(parent, mgr, id), StdOctree(0), LightMapOctree(0),
 	TangentsOctree(0), VertexType((video::E_VERTEX_TYPE)-1),
 	MinimalPolysPerNode(minimalPolysPerNode), Mesh(0), Shadow(0),
-	UseVBOs(EOV_NO_VBO), PolygonChecks(EOPC_BOX)
+	Jobs(jobs), UseVBOs(EOV_NO_VBO), PolygonChecks(EOPC_BOX)
 {
 #ifdef _DEBUG
 	setDebugName("COctreeSceneNode");
 #endif
 
+	if (Jobs)
+		Jobs->grab();
+
 	IRR_PROFILE(
 		static bool initProfile = false;
 		if (!initProfile )
@@ -58,6 +102,8 @@ COctreeSceneNode::~COctreeSceneNode()
 	if (Shadow)
 		Shadow->drop();
 	deleteTree();
+	if (Jobs)
+		Jobs->drop();
 }
 
 
@@ -390,6 +436,9 @@ bool COctreeSceneNode::createTree(IMesh* mesh)
 
 	Box = mesh->getBoundingBox();
 
+	const io::path cacheDirectory = SceneManager->getParameters()->getAttributeAsString(OCTREE_CACHE_DIRECTORY);
+	io::IFileSystem* fileSystem = SceneManager->getFileSystem();
+
 	if (mesh->getMeshBufferCount())
 	{
 		// check for "largest" buffer types
@@ -456,7 +505,8 @@ bool COctreeSceneNode::createTree(IMesh* mesh)
 					}
 				}
 
-				StdOctree = new Octree<video::S3DVertex>(StdMeshes, MinimalPolysPerNode);
+				StdOctree = createOctree<video::S3DVertex>(StdMeshes, MinimalPolysPerNode,
+					Jobs, fileSystem, cacheDirectory);
 				nodeCount = StdOctree->getNodeCount();
 			}
 			break;
@@ -508,7 +558,8 @@ bool COctreeSceneNode::createTree(IMesh* mesh)
 					}
 				}
 
-				LightMapOctree = new Octree<video::S3DVertex2TCoords>(LightMapMeshes, MinimalPolysPerNode);
+				LightMapOctree = createOctree<video::S3DVertex2TCoords>(LightMapMeshes, MinimalPolysPerNode,
+					Jobs, fileSystem, cacheDirectory);
 				nodeCount = LightMapOctree->getNodeCount();
 			}
 			break;
@@ -558,7 +609,8 @@ bool COctreeSceneNode::createTree(IMesh* mesh)
 					}
 				}
 
-				TangentsOctree = new Octree<video::S3DVertexTangents>(TangentsMeshes, MinimalPolysPerNode);
+				TangentsOctree = createOctree<video::S3DVertexTangents>(TangentsMeshes, MinimalPolysPerNode,
+					Jobs, fileSystem, cacheDirectory);
 				nodeCount = TangentsOctree->getNodeCount();
 			}
 			break;
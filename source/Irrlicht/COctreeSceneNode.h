@@ -10,6 +10,8 @@
 
 namespace irr
 {
+class IJobSystem;
+
 namespace scene
 {
 	class COctreeSceneNode;
@@ -20,8 +22,9 @@ namespace scene
 	public:
 
 		//! constructor
+		/** \param jobs When not 0, the octree is created in parallel with it. */
 		COctreeSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
-			s32 minimalPolysPerNode=512);
+			s32 minimalPolysPerNode=512, IJobSystem* jobs=0);
 
 		//! destructor
 		virtual ~COctreeSceneNode();
@@ -120,6 +123,7 @@ namespace scene
 
 		IMesh * Mesh;
 		IShadowVolumeSceneNode* Shadow;
+		IJobSystem* Jobs;
 
 		EOCTREENODE_VBO UseVBOs;
 		EOCTREE_POLYGON_CHECKS PolygonChecks;
@@ -4,6 +4,7 @@
 
 #include "COctreeTriangleSelector.h"
 #include "ISceneNode.h"
+#include "Octree.h"
 
 #include "os.h"
 
@@ -14,7 +15,8 @@ namespace scene
 
 //! constructor
 COctreeTriangleSelector::COctreeTriangleSelector(const IMesh* mesh,
-		ISceneNode* node, s32 minimalPolysPerNode)
+		ISceneNode* node, s32 minimalPolysPerNode, IJobSystem* jobs,
+		io::IFileSystem* fileSystem, const io::path& cacheDirectory)
 	: CTriangleSelector(mesh, node, false)
 	, Root(0), NodeCount(0)
 	, MinimalPolysPerNode(minimalPolysPerNode)
@@ -23,23 +25,11 @@ COctreeTriangleSelector::COctreeTriangleSelector(const IMesh* mesh,
 	setDebugName("COctreeTriangleSelector");
 	#endif
 
-	if (!Triangles.empty())
-	{
-		const u32 start = os::Timer::getRealTime();
-
-		// create the triangle octree
-		Root = new SOctreeNode();
-		Root->Triangles = Triangles;
-		constructOctree(Root);
-
-		c8 tmp[256];
-		sprintf(tmp, "Needed %ums to create OctreeTriangleSelector.(%d nodes, %u polys)",
-			os::Timer::getRealTime() - start, NodeCount, Triangles.size());
-		os::Printer::log(tmp, ELL_INFORMATION);
-	}
+	createOctree(jobs, fileSystem, cacheDirectory);
 }
 
-COctreeTriangleSelector::COctreeTriangleSelector(const IMeshBuffer* meshBuffer, irr::u32 materialIndex, ISceneNode* node, s32 minimalPolysPerNode)
+COctreeTriangleSelector::COctreeTriangleSelector(const IMeshBuffer* meshBuffer, irr::u32 materialIndex, ISceneNode* node, s32 minimalPolysPerNode,
+		IJobSystem* jobs, io::IFileSystem* fileSystem, const io::path& cacheDirectory)
 	: CTriangleSelector(meshBuffer, materialIndex, node)
 	, Root(0), NodeCount(0)
 	, MinimalPolysPerNode(minimalPolysPerNode)
@@ -48,54 +38,239 @@ COctreeTriangleSelector::COctreeTriangleSelector(const IMeshBuffer* meshBuffer,
 	setDebugName("COctreeTriangleSelector");
 	#endif
 
-	if (!Triangles.empty())
+	createOctree(jobs, fileSystem, cacheDirectory);
+}
+
+//! destructor
+COctreeTriangleSelector::~COctreeTriangleSelector()
+{
+	delete Root;
+}
+
+
+//! Reads the octree from the octree cache or constructs it
+void COctreeTriangleSelector::createOctree(IJobSystem* jobs,
+		io::IFileSystem* fileSystem, const io::path& cacheDirectory)
+{
+	if (Triangles.empty())
+		return;
+
+	const u32 start = os::Timer::getRealTime();
+
+	u64 hash = 0;
+	if (!cacheDirectory.empty())
 	{
-		const u32 start = os::Timer::getRealTime();
+		hash = getCacheHash();
+
+		u32 nodeCount = 0;
+		io::IReadFile* file = openOctreeCache(fileSystem, cacheDirectory, hash, nodeCount);
+		if (file)
+		{
+			// each triangle of the mesh has to be in exactly one node
+			core::array<u8> read;
+			read.set_used(Triangles.size());
+			memset(read.pointer(), 0, read.size());
+			u32 triangleCount = 0;
+			Root = readOctree(file, 0, read, triangleCount);
+			file->drop();
+			if (Root && NodeCount == (s32)nodeCount && triangleCount == Triangles.size())
+			{
+				c8 tmp[256];
+				sprintf(tmp, "Needed %ums to read OctreeTriangleSelector from cache.(%d nodes, %u polys)",
+					os::Timer::getRealTime() - start, NodeCount, Triangles.size());
+				os::Printer::log(tmp, ELL_INFORMATION);
+				return;
+			}
+
+			os::Printer::log("Octree cache file is invalid", getOctreeCacheName(cacheDirectory, hash), ELL_WARNING);
+			delete Root;
+			NodeCount = 0;
+		}
+	}
+
+	if (jobs && jobs->getThreadCount() < 2)
+		jobs = 0;
 
-		// create the triangle octree
-		Root = new SOctreeNode();
-		Root->Triangles = Triangles;
-		constructOctree(Root);
+	// create the triangle octree
+	Root = new SOctreeNode();
+	Root->Indices.set_used(Triangles.size());
+	for (u32 i=0; i<Triangles.size(); ++i)
+		Root->Indices[i] = i;
+	NodeCount = constructOctree(Root, 0, jobs);
 
-		c8 tmp[256];
-		sprintf(tmp, "Needed %ums to create OctreeTriangleSelector.(%d nodes, %u polys)",
-			os::Timer::getRealTime() - start, NodeCount, Triangles.size());
-		os::Printer::log(tmp, ELL_INFORMATION);
+	if (!cacheDirectory.empty())
+	{
+		io::IWriteFile* file = createOctreeCache(fileSystem, cacheDirectory, hash, NodeCount);
+		if (file)
+		{
+			writeOctree(file, Root);
+			file->drop();
+		}
 	}
+	clearIndices(Root);
+
+	c8 tmp[256];
+	sprintf(tmp, "Needed %ums to create OctreeTriangleSelector.(%d nodes, %u polys)",
+		os::Timer::getRealTime() - start, NodeCount, Triangles.size());
+	os::Printer::log(tmp, ELL_INFORMATION);
 }
 
-//! destructor
-COctreeTriangleSelector::~COctreeTriangleSelector()
+
+//! Returns a hash of the triangles and the settings, used as name in the octree cache
+u64 COctreeTriangleSelector::getCacheHash() const
 {
-	delete Root;
+	// the triangle count keeps the hash apart from the ones of the octree scene node
+	const u32 settings[] = {
+		OCTREE_CACHE_VERSION,
+		sizeof(core::triangle3df),
+		(u32)MinimalPolysPerNode,
+		Triangles.size()
+	};
+	const u64 seed = os::hash(settings, sizeof(settings), 0x7472697367656c73ULL);
+	return os::hash(Triangles.const_pointer(),
+		Triangles.size() * sizeof(core::triangle3df), seed);
 }
 
 
-void COctreeTriangleSelector::constructOctree(SOctreeNode* node)
+//! Reads a node written by writeOctree and its children
+/** The nodes store indices into Triangles, so the triangles always come from
+the mesh. read marks the triangles which are in a node already. */
+COctreeTriangleSelector::SOctreeNode* COctreeTriangleSelector::readOctree(
+		io::IReadFile* file, u32 depth, core::array<u8>& read, u32& triangleCount)
 {
+	SOctreeNode* node = new SOctreeNode();
 	++NodeCount;
 
-	node->Box.reset(node->Triangles[0].pointA);
+	u32 childMask = 0;
+	u32 count = 0;
+	bool valid = file->read(&node->Box, sizeof(node->Box)) == sizeof(node->Box) &&
+		file->read(&childMask, sizeof(childMask)) == sizeof(childMask) &&
+		file->read(&count, sizeof(count)) == sizeof(count) &&
+		childMask <= 0xff && (!childMask || depth < OCTREE_CACHE_MAX_DEPTH) &&
+		count <= Triangles.size() - triangleCount;
+
+	if (valid && count)
+	{
+		node->Indices.set_used(count);
+		valid = file->read(node->Indices.pointer(), count * sizeof(u32)) ==
+			(size_t)(count * sizeof(u32));
+		for (u32 i=0; valid && i<count; ++i)
+		{
+			const u32 index = node->Indices[i];
+			valid = index < Triangles.size() && !read[index];
+			if (valid)
+				read[index] = 1;
+		}
+		if (valid)
+			copyTriangles(node);
+		node->Indices.clear();
+		triangleCount += count;
+	}
+
+	for (u32 i=0; valid && i!=8; ++i)
+	{
+		if (childMask & (1 << i))
+		{
+			node->Child[i] = readOctree(file, depth+1, read, triangleCount);
+			valid = node->Child[i] != 0;
+		}
+	}
+
+	if (!valid)
+	{
+		delete node;
+		return 0;
+	}
+	return node;
+}
+
+
+//! Writes the box, the triangle indices and the children of a node
+void COctreeTriangleSelector::writeOctree(io::IWriteFile* file, const SOctreeNode* node) const
+{
+	u32 childMask = 0;
+	for (u32 i=0; i!=8; ++i)
+	{
+		if (node->Child[i])
+			childMask |= 1 << i;
+	}
+	const u32 count = node->Indices.size();
+
+	file->write(&node->Box, sizeof(node->Box));
+	file->write(&childMask, sizeof(childMask));
+	file->write(&count, sizeof(count));
+	if (count)
+		file->write(node->Indices.const_pointer(), count * sizeof(u32));
+
+	for (u32 i=0; i!=8; ++i)
+	{
+		if (node->Child[i])
+			writeOctree(file, node->Child[i]);
+	}
+}
+
+
+//! Copies the triangles of the indices of a node from the mesh
+void COctreeTriangleSelector::copyTriangles(SOctreeNode* node) const
+{
+	const u32 count = node->Indices.size();
+	node->Triangles.set_used(count);
+	for (u32 i=0; i<count; ++i)
+		node->Triangles[i] = Triangles[node->Indices[i]];
+}
+
+
+//! Releases the indices of a node and its children, which are only needed to create the octree
+void COctreeTriangleSelector::clearIndices(SOctreeNode* node)
+{
+	node->Indices.clear();
+	for (u32 i=0; i!=8; ++i)
+	{
+		if (node->Child[i])
+			clearIndices(node->Child[i]);
+	}
+}
+
+
+//! Constructs the children of a node, called from the job system
+void COctreeTriangleSelector::constructChildren(void* data, u32 begin, u32 end)
+{
+	SConstructData& construct = *(SConstructData*)data;
+	for (u32 ch=begin; ch<end; ++ch)
+	{
+		SOctreeNode* child = construct.Node->Child[ch];
+		construct.NodeCount[ch] = child ? construct.Selector->constructOctree(child, construct.Depth, construct.Jobs) : 0;
+	}
+}
+
+
+//! Constructs the node and its children, returns the number of nodes
+s32 COctreeTriangleSelector::constructOctree(SOctreeNode* node, u32 depth, IJobSystem* jobs)
+{
+	s32 nodeCount = 1;
+
+	node->Box.reset(Triangles[node->Indices[0]].pointA);
 
 	// get bounding box
-	const u32 cnt = node->Triangles.size();
+	const u32 cnt = node->Indices.size();
 	for (u32 i=0; i<cnt; ++i)
 	{
-		node->Box.addInternalPoint(node->Triangles[i].pointA);
-		node->Box.addInternalPoint(node->Triangles[i].pointB);
-		node->Box.addInternalPoint(node->Triangles[i].pointC);
+		const core::triangle3df& triangle = Triangles[node->Indices[i]];
+		node->Box.addInternalPoint(triangle.pointA);
+		node->Box.addInternalPoint(triangle.pointB);
+		node->Box.addInternalPoint(triangle.pointC);
 	}
 
 	// calculate children
 
-	if (!node->Box.isEmpty() && (s32)node->Triangles.size() > MinimalPolysPerNode)
+	if (!node->Box.isEmpty() && (s32)node->Indices.size() > MinimalPolysPerNode)
 	{
 		const core::vector3df& middle = node->Box.getCenter();
 		core::vector3df edges[8];
 		node->Box.getEdges(edges);
 
 		core::aabbox3d<f32> box;
-		core::array<core::triangle3df> keepTriangles(node->Triangles.size()); // reserving enough memory, so we don't get re-allocations per child
+		core::array<u32> keepIndices(node->Indices.size()); // reserving enough memory, so we don't get re-allocations per child
 
 		for (s32 ch=0; ch<8; ++ch)
 		{
@@ -103,43 +278,57 @@ void COctreeTriangleSelector::constructOctree(SOctreeNode* node)
 			box.addInternalPoint(edges[ch]);
 			node->Child[ch] = new SOctreeNode();
 
-			for (s32 i=0; i<(s32)node->Triangles.size(); ++i)
+			for (s32 i=0; i<(s32)node->Indices.size(); ++i)
 			{
-				if (node->Triangles[i].isTotalInsideBox(box))
-				{
-					node->Child[ch]->Triangles.push_back(node->Triangles[i]);
-					//node->Triangles.erase(i);
-					//--i;
-				}
+				if (Triangles[node->Indices[i]].isTotalInsideBox(box))
+					node->Child[ch]->Indices.push_back(node->Indices[i]);
 				else
-				{
-					keepTriangles.push_back(node->Triangles[i]);
-				}
+					keepIndices.push_back(node->Indices[i]);
 			}
-			memcpy(node->Triangles.pointer(), keepTriangles.pointer(),
-				sizeof(core::triangle3df)*keepTriangles.size());
+			memcpy(node->Indices.pointer(), keepIndices.pointer(),
+				sizeof(u32)*keepIndices.size());
 
-			node->Triangles.set_used(keepTriangles.size());
-			keepTriangles.set_used(0);
+			node->Indices.set_used(keepIndices.size());
+			keepIndices.set_used(0);
 		}
-		keepTriangles.clear();	// release memory early, for large meshes it can matter.
-		node->Triangles.reallocate(node->Triangles.size(), true); // shrink memory to minimum necessary
+		keepIndices.clear();	// release memory early, for large meshes it can matter.
+		node->Indices.reallocate(node->Indices.size(), true); // shrink memory to minimum necessary
+		copyTriangles(node);
 
 		// Note: We use an extra loop to construct child-nodes instead of doing
 		// that in above loop to avoid memory fragmentation which happens if
 		// the code has to switch between allocating memory for this node and
 		// the child nodes (thanks @Squarefox for noting this).
+		// The upper children are constructed in parallel when there are jobs.
+		u32 childCount = 0;
 		for (s32 ch=0; ch<8; ++ch)
 		{
-			if (node->Child[ch]->Triangles.empty())
+			if (node->Child[ch]->Indices.empty())
 			{
 				delete node->Child[ch];
 				node->Child[ch] = 0;
 			}
 			else
-				constructOctree(node->Child[ch]);
+				++childCount;
 		}
+
+		SConstructData construct;
+		construct.Selector = this;
+		construct.Node = node;
+		construct.Depth = depth+1;
+		construct.Jobs = depth < 1 ? jobs : 0;
+		if (jobs && childCount > 1)
+			jobs->parallelFor(constructChildren, &construct, 8, 1);
+		else
+			constructChildren(&construct, 0, 8);
+
+		for (s32 ch=0; ch<8; ++ch)
+			nodeCount += construct.NodeCount[ch];
 	}
+	else
+		copyTriangles(node);
+
+	return nodeCount;
 }
 
 
@@ -196,7 +385,8 @@ void COctreeTriangleSelector::getTrianglesFromOctree(
 		s32 maximumSize, const core::aabbox3d<f32>& box,
 		const core::matrix4* mat, core::triangle3df* triangles) const
 {
-	if (!box.intersectsWithBox(node->Box))
+	// the array may be full after a sibling node
+	if (trianglesWritten == maximumSize || !box.intersectsWithBox(node->Box))
 		return;
 
 	const u32 cnt = node->Triangles.size();
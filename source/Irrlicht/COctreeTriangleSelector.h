@@ -6,9 +6,19 @@
 #define __C_OCTREE_TRIANGLE_SELECTOR_H_INCLUDED__
 
 #include "CTriangleSelector.h"
+#include "path.h"
 
 namespace irr
 {
+class IJobSystem;
+
+namespace io
+{
+	class IFileSystem;
+	class IReadFile;
+	class IWriteFile;
+} // end namespace io
+
 namespace scene
 {
 
@@ -20,10 +30,16 @@ class COctreeTriangleSelector : public CTriangleSelector
 public:
 
 	//! Constructs a selector based on a mesh
-	COctreeTriangleSelector(const IMesh* mesh, ISceneNode* node, s32 minimalPolysPerNode);
+	/** \param jobs When not 0, the octree is created in parallel with it.
+	\param fileSystem,cacheDirectory When the directory is not empty, the octree
+	is read from there or written there after it was created, see
+	scene::OCTREE_CACHE_DIRECTORY. */
+	COctreeTriangleSelector(const IMesh* mesh, ISceneNode* node, s32 minimalPolysPerNode,
+		IJobSystem* jobs=0, io::IFileSystem* fileSystem=0, const io::path& cacheDirectory="");
 
 	//! Constructs a selector based on a meshbuffer
-	COctreeTriangleSelector(const IMeshBuffer* meshBuffer, irr::u32 materialIndex, ISceneNode* node, s32 minimalPolysPerNode);
+	COctreeTriangleSelector(const IMeshBuffer* meshBuffer, irr::u32 materialIndex, ISceneNode* node, s32 minimalPolysPerNode,
+		IJobSystem* jobs=0, io::IFileSystem* fileSystem=0, const io::path& cacheDirectory="");
 
 	virtual ~COctreeTriangleSelector();
 
@@ -38,6 +54,9 @@ public:
 		const core::matrix4* transform, bool useNodeTransform, 
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const _IRR_OVERRIDE_;
 
+	//! The box queries only read the octree of the static mesh
+	virtual bool isThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
 private:
 
 	struct SOctreeNode
@@ -55,12 +74,31 @@ private:
 		}
 
 		core::array<core::triangle3df> Triangles;
+		//! indices of the triangles into the selector, only while the octree is created
+		core::array<u32> Indices;
 		SOctreeNode* Child[8];
 		core::aabbox3d<f32> Box;
 	};
 
 
-	void constructOctree(SOctreeNode* node);
+	// the children of a node which are constructed in parallel
+	struct SConstructData
+	{
+		COctreeTriangleSelector* Selector;
+		SOctreeNode* Node;
+		s32 NodeCount[8];
+		u32 Depth;
+		IJobSystem* Jobs;
+	};
+
+	void createOctree(IJobSystem* jobs, io::IFileSystem* fileSystem, const io::path& cacheDirectory);
+	s32 constructOctree(SOctreeNode* node, u32 depth, IJobSystem* jobs);
+	static void constructChildren(void* data, u32 begin, u32 end);
+	u64 getCacheHash() const;
+	SOctreeNode* readOctree(io::IReadFile* file, u32 depth, core::array<u8>& read, u32& triangleCount);
+	void writeOctree(io::IWriteFile* file, const SOctreeNode* node) const;
+	void copyTriangles(SOctreeNode* node) const;
+	void clearIndices(SOctreeNode* node);
 	void deleteEmptyNodes(SOctreeNode* node);
 	void getTrianglesFromOctree(SOctreeNode* node, s32& trianglesWritten,
 			s32 maximumSize, const core::aabbox3d<f32>& box,
@@ -14,6 +14,8 @@
 #include "IReadFile.h"
 #include "fast_atof.h"
 #include "coreutil.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 #ifdef _DEBUG
 #define IRR_OGRE_LOADER_DEBUG
@@ -112,6 +114,7 @@ bool COgreMeshFileLoader::isALoadableFileExtension(const io::path& filename) con
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* COgreMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_OGRE);)
 	if ( !file )
 		return 0;
 
@@ -19,6 +19,8 @@
 
 #include "COpenGLCoreTexture.h"
 #include "COpenGLCoreRenderTarget.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -344,6 +346,7 @@ bool COpenGLDriver::updateVertexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 
 #if defined(GL_ARB_vertex_buffer_object)
 	const scene::IMeshBuffer* mb = HWBuffer->MeshBuffer;
+	IRR_PROFILE(getProfiler().addToCounter(EPC_BUFFER_UPLOADS, 1);)
 	const void* vertices=mb->getVertices();
 	const u32 vertexCount=mb->getVertexCount();
 	const E_VERTEX_TYPE vType=mb->getVertexType();
@@ -448,6 +451,7 @@ bool COpenGLDriver::updateIndexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 
 #if defined(GL_ARB_vertex_buffer_object)
 	const scene::IMeshBuffer* mb = HWBuffer->MeshBuffer;
+	IRR_PROFILE(getProfiler().addToCounter(EPC_BUFFER_UPLOADS, 1);)
 
 	const void* indices=mb->getIndices();
 	u32 indexCount= mb->getIndexCount();
@@ -13,6 +13,8 @@
 #include "IReadFile.h"
 #include "fast_atof.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -56,6 +58,7 @@ bool CPLYMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! creates/loads an animated mesh from the file.
 IAnimatedMesh* CPLYMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_PLY);)
 	if (!file)
 		return 0;
 
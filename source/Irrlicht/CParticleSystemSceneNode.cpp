@@ -24,6 +24,8 @@
 #include "CParticleRotationAffector.h"
 #include "CParticleScaleAffector.h"
 #include "SViewFrustum.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -410,6 +412,7 @@ const core::aabbox3d<f32>& CParticleSystemSceneNode::getBoundingBox() const
 
 void CParticleSystemSceneNode::doParticleSystem(u32 time)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_AM_PARTICLES);)
 	if (LastEmitTime==0)
 	{
 		LastEmitTime = time;
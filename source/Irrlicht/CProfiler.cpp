@@ -4,9 +4,26 @@
 
 #include "CProfiler.h"
 #include "CTimer.h"
+#include "IWriteFile.h"
+#include "irrAtomic.h"
+#include "irrMap.h"
+#include "os.h"
 
 namespace irr
 {
+
+//! Number of events kept per thread, must be a power of two
+static const u32 TRACE_EVENTS_PER_THREAD = 1 << 15;
+
+//! Only the address is used, it is different for each running thread
+static _IRR_THREAD_LOCAL c8 ThreadToken;
+
+//! The profiler which was used last by the calling thread, and the state of the thread in it
+static _IRR_THREAD_LOCAL u32 CachedSerial = 0;
+static _IRR_THREAD_LOCAL void* CachedThread = 0;
+
+static volatile s32 NextSerial = 0;
+
 IRRLICHT_API IProfiler& IRRCALLCONV getProfiler()
 {
 	static CProfiler profiler;
@@ -14,8 +31,17 @@ IRRLICHT_API IProfiler& IRRCALLCONV getProfiler()
 }
 
 CProfiler::CProfiler()
+	: Threads(0), ThreadCount(0)
 {
 	Timer = new CTimer(true);
+	StartTime = os::Timer::getRealTimeNanoseconds();
+	Serial = (u32)os::atomicAdd(&NextSerial, 1);
+
+	for ( u32 i=0; i < EPC_COUNT; ++i )
+	{
+		Counters[i] = 0;
+		LastCounters[i] = 0;
+	}
 
 	addGroup(L"overview");
 }
@@ -24,6 +50,360 @@ CProfiler::~CProfiler()
 {
 	if ( Timer )
 		Timer->drop();
+
+	while ( Threads )
+	{
+		SThread* next = Threads->Next;
+		delete [] Threads->Events;
+		delete Threads;
+		Threads = next;
+	}
+}
+
+CProfiler::SThread* CProfiler::getThread()
+{
+	if ( CachedSerial == Serial )
+		return (SThread*)CachedThread;
+
+	// the thread might have used this profiler before it used another one.
+	// A new thread can also get the state of a finished one, which is fine as it's no longer used.
+	const void* token = &ThreadToken;
+	SThread* thread = Threads;
+	while ( thread && thread->Token != token )
+		thread = thread->Next;
+
+	if ( !thread )
+	{
+		thread = new SThread();
+		thread->Token = token;
+		thread->Number = (u32)(os::atomicAdd(&ThreadCount, 1) - 1);
+		thread->Events = new SEvent[TRACE_EVENTS_PER_THREAD];
+
+		do
+		{
+			thread->Next = Threads;
+		} while ( !os::atomicCompareExchange((void* volatile*)&Threads, thread, thread->Next) );
+	}
+
+	CachedSerial = Serial;
+	CachedThread = thread;
+	return thread;
+}
+
+void CProfiler::addEvent(SThread* thread, u64 time, s32 id, u32 begin)
+{
+	const u32 written = thread->Written;
+	SEvent& event = thread->Events[written & (TRACE_EVENTS_PER_THREAD-1)];
+	event.Time = time;
+	event.Id = id;
+	event.Begin = begin;
+
+	// readers must not see the new count before the event
+	os::memoryBarrier();
+	if ( written == TRACE_EVENTS_PER_THREAD-1 )
+		thread->Full = true;
+	thread->Written = written + 1;
+}
+
+void CProfiler::startIndex(u32 index)
+{
+	SThread* thread = getThread();
+	while ( thread->Zones.size() <= index )
+		thread->Zones.push_back(SZone());
+
+	SZone& zone = thread->Zones[index];
+	++zone.Counter;
+	if ( zone.Counter == 1 )
+	{
+		zone.Started = os::Timer::getRealTimeNanoseconds();
+		addEvent(thread, zone.Started, ProfileDatas[index].Id, 1);
+	}
+}
+
+void CProfiler::stopIndex(u32 index)
+{
+	const u64 timeNow = os::Timer::getRealTimeNanoseconds();
+	SThread* thread = getThread();
+
+	// ignore additional stop calls
+	if ( index >= thread->Zones.size() || thread->Zones[index].Counter <= 0 )
+		return;
+
+	SZone& zone = thread->Zones[index];
+	--zone.Counter;
+	if ( zone.Counter == 0 )
+	{
+		const u64 diffTime = timeNow - zone.Started;
+
+		// update data for this id
+		SProfileData &data = ProfileDatas[index];
+		os::atomicAdd(&data.CountCalls, 1);
+		os::atomicAdd(&data.TimeSum, diffTime);
+		os::atomicMax(&data.LongestTime, diffTime);
+
+		// update data of it's group
+		SProfileData & group = ProfileGroups[data.GroupIndex];
+		os::atomicAdd(&group.CountCalls, 1);
+		os::atomicAdd(&group.TimeSum, diffTime);
+		os::atomicMax(&group.LongestTime, diffTime);
+
+		addEvent(thread, timeNow, data.Id, 0);
+	}
+}
+
+void CProfiler::addTimeIndex(u32 index, u64 nanoseconds)
+{
+	SProfileData &data = ProfileDatas[index];
+	os::atomicAdd(&data.CountCalls, 1);
+	os::atomicAdd(&data.TimeSum, nanoseconds);
+	os::atomicMax(&data.LongestTime, nanoseconds);
+
+	SProfileData & group = ProfileGroups[data.GroupIndex];
+	os::atomicAdd(&group.CountCalls, 1);
+	os::atomicAdd(&group.TimeSum, nanoseconds);
+	os::atomicMax(&group.LongestTime, nanoseconds);
+}
+
+void CProfiler::addToCounter(E_PROFILE_COUNTER counter, u64 value)
+{
+	os::atomicAdd(&Counters[counter], value);
+}
+
+u64 CProfiler::getCounter(E_PROFILE_COUNTER counter, bool lastFrame) const
+{
+	return lastFrame ? LastCounters[counter] : Counters[counter];
+}
+
+void CProfiler::endFrame()
+{
+	for ( u32 i=0; i < EPC_COUNT; ++i )
+	{
+		// other threads might count while we move the value, they end up in the next frame
+		const u64 value = Counters[i];
+		LastCounters[i] = value;
+		os::atomicAdd(&Counters[i], (u64)0 - value);
+	}
+}
+
+void CProfiler::setThreadName(const core::stringc& name)
+{
+	getThread()->Name = name;
+}
+
+void CProfiler::clearTrace()
+{
+	for ( SThread* thread = Threads; thread; thread = thread->Next )
+	{
+		thread->Full = false;
+		thread->Written = 0;
+	}
+}
+
+void CProfiler::copyEvents(const SThread* thread, core::array<SEvent>& events) const
+{
+	events.set_used(0);
+
+	const u32 written = thread->Written;
+	os::memoryBarrier();
+	const u32 count = thread->Full ? TRACE_EVENTS_PER_THREAD : written;
+	const u32 first = written - count;
+	events.reallocate(count);
+	for ( u32 i = first; i != written; ++i )
+		events.push_back(thread->Events[i & (TRACE_EVENTS_PER_THREAD-1)]);
+	os::memoryBarrier();
+
+	// meanwhile the thread can have overwritten the oldest events, and it might be writing the next one
+	const s32 overwritten = (s32)(thread->Written + 1 - TRACE_EVENTS_PER_THREAD - first);
+	if ( overwritten > 0 )
+		events.erase(0, core::min_((u32)overwritten, events.size()));
+}
+
+//! utf-8 version of a wide string
+static core::stringc toUTF8(const core::stringw& text)
+{
+	core::array<c8> buffer;
+	buffer.set_used(text.size() * 4 + 1);
+	core::wcharToUtf8(text.c_str(), buffer.pointer(), buffer.size());
+	return core::stringc(buffer.const_pointer());
+}
+
+//! Appends text as JSON string
+static void appendJSONString(core::stringc& out, const core::stringc& text)
+{
+	out += '"';
+	for ( u32 i=0; i < text.size(); ++i )
+	{
+		const c8 c = text[i];
+		if ( c == '"' || c == '\\' )
+		{
+			out += '\\';
+			out += c;
+		}
+		else if ( (u8)c < 0x20 )
+		{
+			c8 escaped[8];
+			snprintf_irr(escaped, 8, "\\u%04x", (u32)(u8)c);
+			out += escaped;
+		}
+		else
+			out += c;
+	}
+	out += '"';
+}
+
+//! Writes out to file when it got large or when flush is set
+static bool flushTrace(io::IWriteFile* file, core::stringc& out, bool flush)
+{
+	if ( !flush && out.size() < 0x10000 )
+		return true;
+	const bool written = file->write(out.c_str(), out.size()) == out.size();
+	out = "";
+	return written;
+}
+
+bool CProfiler::writeTrace(io::IWriteFile* file, E_PROFILE_TRACE_FORMAT format) const
+{
+	if ( !file )
+		return false;
+
+	switch ( format )
+	{
+	case EPTF_CHROME_JSON:
+		return writeChromeTrace(file);
+	case EPTF_BINARY:
+		return writeBinaryTrace(file);
+	}
+	return false;
+}
+
+bool CProfiler::writeChromeTrace(io::IWriteFile* file) const
+{
+	// names are written in utf-8 once
+	core::array<core::stringc> names;
+	core::array<core::stringc> groups;
+	for ( u32 i=0; i < ProfileDatas.size(); ++i )
+	{
+		core::stringc name;
+		appendJSONString(name, toUTF8(ProfileDatas[i].getName()));
+		names.push_back(name);
+		core::stringc group;
+		appendJSONString(group, toUTF8(ProfileGroups[ProfileDatas[i].getGroupIndex()].getName()));
+		groups.push_back(group);
+	}
+
+	bool result = true;
+	bool first = true;
+	core::stringc out("{\"traceEvents\":[");
+	core::array<SEvent> events;
+	for ( const SThread* thread = Threads; thread; thread = thread->Next )
+	{
+		c8 buffer[128];
+
+		if ( thread->Name.size() )
+		{
+			snprintf_irr(buffer, 128, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":",
+				first ? "" : ",", thread->Number);
+			out += buffer;
+			appendJSONString(out, thread->Name);
+			out += "}}";
+			first = false;
+		}
+
+		// zones become complete events, so zones of different ids don't have to be nested
+		core::map<s32, u64> started;
+		copyEvents(thread, events);
+		for ( u32 i=0; i < events.size() && result; ++i )
+		{
+			const SEvent& event = events[i];
+			if ( event.Begin )
+			{
+				started.set(event.Id, event.Time);
+				continue;
+			}
+
+			// zones which started before the oldest event are skipped
+			core::map<s32, u64>::Node* begin = started.find(event.Id);
+			const s32 index = getDataIndex(event.Id);
+			if ( !begin || index < 0 )
+				continue;
+
+			snprintf_irr(buffer, 128, "%s\n{\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+				first ? "" : ",", thread->Number,
+				(f64)(s64)(begin->getValue() - StartTime) / 1000.0, (f64)(event.Time - begin->getValue()) / 1000.0);
+			out += buffer;
+			out += names[index];
+			out += ",\"cat\":";
+			out += groups[index];
+			out += "}";
+			first = false;
+			started.remove(begin);
+
+			result = flushTrace(file, out, false);
+		}
+	}
+	out += "\n]}\n";
+
+	return result && flushTrace(file, out, true);
+}
+
+//! Appends a little endian number to a binary trace
+template <class T>
+static void appendBinary(core::array<u8>& out, T value)
+{
+#ifdef __BIG_ENDIAN__
+	value = os::Byteswap::byteswap(value);
+#endif
+	const u32 size = out.size();
+	out.set_used(size + sizeof(T));
+	memcpy(out.pointer() + size, &value, sizeof(T));
+}
+
+//! Appends a string with its length to a binary trace
+static void appendBinary(core::array<u8>& out, const core::stringc& text)
+{
+	appendBinary(out, (u32)text.size());
+	const u32 size = out.size();
+	out.set_used(size + text.size());
+	memcpy(out.pointer() + size, text.c_str(), text.size());
+}
+
+bool CProfiler::writeBinaryTrace(io::IWriteFile* file) const
+{
+	core::array<u8> out;
+	out.set_used(4);
+	memcpy(out.pointer(), "IRTR", 4);
+	appendBinary(out, (u32)1);
+	appendBinary(out, ProfileDatas.size());
+
+	u32 threadCount = 0;
+	for ( const SThread* thread = Threads; thread; thread = thread->Next )
+		++threadCount;
+	appendBinary(out, threadCount);
+
+	for ( u32 i=0; i < ProfileDatas.size(); ++i )
+	{
+		appendBinary(out, ProfileDatas[i].Id);
+		appendBinary(out, toUTF8(ProfileDatas[i].getName()));
+		appendBinary(out, toUTF8(ProfileGroups[ProfileDatas[i].getGroupIndex()].getName()));
+	}
+
+	core::array<SEvent> events;
+	for ( const SThread* thread = Threads; thread; thread = thread->Next )
+	{
+		copyEvents(thread, events);
+		appendBinary(out, thread->Number);
+		appendBinary(out, thread->Name);
+		appendBinary(out, events.size());
+		out.reallocate(out.size() + events.size() * 16);
+		for ( u32 i=0; i < events.size(); ++i )
+		{
+			appendBinary(out, (u64)(events[i].Time - StartTime));
+			appendBinary(out, events[i].Id);
+			appendBinary(out, events[i].Begin);
+		}
+	}
+
+	return file->write(out.const_pointer(), out.size()) == out.size();
 }
 
 void CProfiler::printAll(core::stringw &ostream, bool includeOverview, bool suppressUncalled) const
@@ -34,6 +414,24 @@ void CProfiler::printAll(core::stringw &ostream, bool includeOverview, bool supp
     {
         printGroup( ostream, i, suppressUncalled );
     }
+
+	// counters of the last frame, when anything was counted
+	core::stringw counters;
+	for ( u32 i=0; i < EPC_COUNT; ++i )
+	{
+		if ( LastCounters[i] > 0 )
+		{
+			counters += ProfileCounterNames[i];
+			counters += L": ";
+			counters += core::stringw((u32)core::min_(LastCounters[i], (u64)0xffffffff));
+			counters += L"\n";
+		}
+	}
+	if ( !counters.empty() )
+	{
+		ostream += L"counters (last frame)\n";
+		ostream += counters;
+	}
 }
 
 void CProfiler::printGroup(core::stringw &ostream, u32 idxGroup, bool suppressUncalled) const
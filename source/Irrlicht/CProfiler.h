@@ -23,9 +23,92 @@ public:
 	//! Write the profile data of one group into a string
     virtual void printGroup(core::stringw &result, u32 groupIndex, bool suppressUncalled) const  _IRR_OVERRIDE_;
 
+	//! Write the latest start/stop events of all threads into a file
+	virtual bool writeTrace(io::IWriteFile* file, E_PROFILE_TRACE_FORMAT format) const _IRR_OVERRIDE_;
+
+	//! Removes the recorded events of all threads
+	virtual void clearTrace() _IRR_OVERRIDE_;
+
+	//! Name the calling thread in traces
+	virtual void setThreadName(const core::stringc& name) _IRR_OVERRIDE_;
+
+	//! Add to a counter of the current frame
+	virtual void addToCounter(E_PROFILE_COUNTER counter, u64 value) _IRR_OVERRIDE_;
+
+	//! Get the value of a counter
+	virtual u64 getCounter(E_PROFILE_COUNTER counter, bool lastFrame) const _IRR_OVERRIDE_;
+
+	//! Finish the frame of the counters
+	virtual void endFrame() _IRR_OVERRIDE_;
+
 protected:
+	virtual void startIndex(u32 index) _IRR_OVERRIDE_;
+	virtual void stopIndex(u32 index) _IRR_OVERRIDE_;
+	virtual void addTimeIndex(u32 index, u64 nanoseconds) _IRR_OVERRIDE_;
+
 	core::stringw makeTitleString() const;
 	core::stringw getAsString(const SProfileData& data) const;
+
+private:
+
+	//! A start or stop of a zone
+	struct SEvent
+	{
+		u64 Time;
+		s32 Id;
+		u32 Begin;
+	};
+
+	//! Run-counter and start time of an id in one thread
+	struct SZone
+	{
+		SZone() : Counter(0), Started(0) {}
+		s32 Counter;
+		u64 Started;
+	};
+
+	//! State of a thread which used the profiler. Only that thread writes to it.
+	struct SThread
+	{
+		SThread() : Next(0), Token(0), Number(0), Events(0), Written(0), Full(false) {}
+
+		SThread* Next;
+		//! Address of a thread local variable, unique for each running thread
+		const void* Token;
+		u32 Number;
+		core::stringc Name;
+		core::array<SZone> Zones;
+
+		//! Ring buffer of the latest events
+		SEvent* Events;
+		volatile u32 Written;
+		volatile bool Full;
+	};
+
+	//! Returns the state of the calling thread, creates it on first use
+	SThread* getThread();
+
+	//! Adds an event to the ring buffer of thread
+	static void addEvent(SThread* thread, u64 time, s32 id, u32 begin);
+
+	//! Copies the events of a thread which were not overwritten while copying
+	void copyEvents(const SThread* thread, core::array<SEvent>& events) const;
+
+	bool writeChromeTrace(io::IWriteFile* file) const;
+	bool writeBinaryTrace(io::IWriteFile* file) const;
+
+	//! Threads which used the profiler, a lock-free list
+	SThread* volatile Threads;
+	volatile s32 ThreadCount;
+
+	//! Time at creation, traces start from it
+	u64 StartTime;
+	//! Unique for each profiler, so a thread can cache its state
+	u32 Serial;
+
+	//! Counters of the current and of the last frame
+	volatile u64 Counters[EPC_COUNT];
+	u64 LastCounters[EPC_COUNT];
 };
 } // namespace irr
 
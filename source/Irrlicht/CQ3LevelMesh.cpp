@@ -43,6 +43,10 @@ CQ3LevelMesh::CQ3LevelMesh(io::IFileSystem* fs, scene::ISceneManager* smgr,
 		Mesh[i] = 0;
 	}
 
+	VisData.numOfClusters = 0;
+	VisData.bytesPerCluster = 0;
+	VisData.pBitsets = 0;
+
 	Driver = smgr ? smgr->getVideoDriver() : 0;
 	if (Driver)
 		Driver->grab();
@@ -59,6 +63,7 @@ CQ3LevelMesh::CQ3LevelMesh(io::IFileSystem* fs, scene::ISceneManager* smgr,
 CQ3LevelMesh::~CQ3LevelMesh()
 {
 	cleanLoader ();
+	cleanVisibility();
 
 	if (Driver)
 		Driver->drop();
@@ -137,6 +142,7 @@ bool CQ3LevelMesh::loadFile(io::IReadFile* file)
 	}
 
 	ReleaseEntity();
+	cleanVisibility();
 
 	// load everything
 	loadEntities(&Lumps[kEntities], file);			// load the entities
@@ -176,10 +182,6 @@ void CQ3LevelMesh::cleanLoader ()
 	delete [] Vertices; Vertices = 0;
 	delete [] Faces; Faces = 0;
 	delete [] Models; Models = 0;
-	delete [] Planes; Planes = 0;
-	delete [] Nodes; Nodes = 0;
-	delete [] Leafs; Leafs = 0;
-	delete [] LeafFaces; LeafFaces = 0;
 	delete [] MeshVerts; MeshVerts = 0;
 	delete [] Brushes; Brushes = 0;
 
@@ -187,6 +189,22 @@ void CQ3LevelMesh::cleanLoader ()
 	Tex.clear();
 }
 
+/*!
+	The bsp tree and the visibility data are kept after loading
+*/
+void CQ3LevelMesh::cleanVisibility()
+{
+	delete [] Planes; Planes = 0; NumPlanes = 0;
+	delete [] Nodes; Nodes = 0; NumNodes = 0;
+	delete [] Leafs; Leafs = 0; NumLeafs = 0;
+	delete [] LeafFaces; LeafFaces = 0; NumLeafFaces = 0;
+	delete [] VisData.pBitsets; VisData.pBitsets = 0;
+	VisData.numOfClusters = 0;
+	VisData.bytesPerCluster = 0;
+
+	FaceIndices.clear();
+}
+
 //! returns the amount of frames in milliseconds. If the amount is 1, it is a static (=non animated) mesh.
 u32 CQ3LevelMesh::getFrameCount() const
 {
@@ -314,7 +332,24 @@ void CQ3LevelMesh::loadFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumPlanes = l->length / sizeof(tBSPPlane);
+	if (!NumPlanes)
+		return;
+	Planes = new tBSPPlane[NumPlanes];
+
+	file->seek(l->offset);
+	file->read(Planes, NumPlanes * sizeof(tBSPPlane));
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumPlanes; i++)
+		{
+			Planes[i].vNormal[0] = os::Byteswap::byteswap(Planes[i].vNormal[0]);
+			Planes[i].vNormal[1] = os::Byteswap::byteswap(Planes[i].vNormal[1]);
+			Planes[i].vNormal[2] = os::Byteswap::byteswap(Planes[i].vNormal[2]);
+			Planes[i].d = os::Byteswap::byteswap(Planes[i].d);
+		}
+	}
 }
 
 
@@ -322,7 +357,23 @@ void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumNodes = l->length / sizeof(tBSPNode);
+	if (!NumNodes)
+		return;
+	Nodes = new tBSPNode[NumNodes];
+
+	file->seek(l->offset);
+	file->read(Nodes, NumNodes * sizeof(tBSPNode));
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumNodes; i++)
+		{
+			Nodes[i].plane = os::Byteswap::byteswap(Nodes[i].plane);
+			Nodes[i].front = os::Byteswap::byteswap(Nodes[i].front);
+			Nodes[i].back = os::Byteswap::byteswap(Nodes[i].back);
+		}
+	}
 }
 
 
@@ -330,7 +381,26 @@ void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafs = l->length / sizeof(tBSPLeaf);
+	if (!NumLeafs)
+		return;
+	Leafs = new tBSPLeaf[NumLeafs];
+
+	file->seek(l->offset);
+	file->read(Leafs, NumLeafs * sizeof(tBSPLeaf));
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumLeafs; i++)
+		{
+			Leafs[i].cluster = os::Byteswap::byteswap(Leafs[i].cluster);
+			Leafs[i].area = os::Byteswap::byteswap(Leafs[i].area);
+			Leafs[i].leafface = os::Byteswap::byteswap(Leafs[i].leafface);
+			Leafs[i].numOfLeafFaces = os::Byteswap::byteswap(Leafs[i].numOfLeafFaces);
+			Leafs[i].leafBrush = os::Byteswap::byteswap(Leafs[i].leafBrush);
+			Leafs[i].numOfLeafBrushes = os::Byteswap::byteswap(Leafs[i].numOfLeafBrushes);
+		}
+	}
 }
 
 
@@ -338,7 +408,19 @@ void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafFaces = l->length / sizeof(s32);
+	if (!NumLeafFaces)
+		return;
+	LeafFaces = new s32[NumLeafFaces];
+
+	file->seek(l->offset);
+	file->read(LeafFaces, NumLeafFaces * sizeof(s32));
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumLeafFaces; i++)
+			LeafFaces[i] = os::Byteswap::byteswap(LeafFaces[i]);
+	}
 }
 
 
@@ -346,7 +428,28 @@ void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadVisData(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	if ( l->length < 8 )
+		return;
+
+	s32 header[2];
+	file->seek(l->offset);
+	file->read(header, sizeof(header));
+
+	if ( LoadParam.swapHeader )
+	{
+		header[0] = os::Byteswap::byteswap(header[0]);
+		header[1] = os::Byteswap::byteswap(header[1]);
+	}
+
+	// a level with broken visibility data is drawn without it
+	if ( header[0] <= 0 || header[1] <= 0 || header[1] < (header[0] + 7) / 8 ||
+		(s64) header[0] * header[1] > l->length - 8 )
+		return;
+
+	VisData.numOfClusters = header[0];
+	VisData.bytesPerCluster = header[1];
+	VisData.pBitsets = new c8[header[0] * header[1]];
+	file->read(VisData.pBitsets, header[0] * header[1]);
 }
 
 
@@ -965,6 +1068,15 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 			}
 
 
+			// remember where the faces of the level geometry are for the visibility tests
+			const bool levelGeometry = num == 0 && item[g].index == E_Q3_MESH_GEOMETRY;
+			if ( levelGeometry )
+			{
+				SFaceIndices& faceIndices = FaceIndices[i];
+				faceIndices.MeshBuffer = newmesh[E_Q3_MESH_GEOMETRY]->MeshBuffers.linear_reverse_search(buffer);
+				faceIndices.FirstIndex = buffer->getIndexCount();
+			}
+
 			switch(Faces[i].type)
 			{
 				case 4: // billboards
@@ -1018,6 +1130,9 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 					break;
 
 			} // end switch
+
+			if ( levelGeometry )
+				FaceIndices[i].IndexCount = buffer->getIndexCount() - FaceIndices[i].FirstIndex;
 		}
 	}
 
@@ -1054,6 +1169,11 @@ void CQ3LevelMesh::constructMesh()
 
 	s32 i, j;
 
+	FaceIndices.clear();
+	FaceIndices.reallocate(NumFaces);
+	for (i = 0; i < NumFaces; i++)
+		FaceIndices.push_back(SFaceIndices());
+
 	// First the main level
 	SMesh **tmp = buildMesh(0);
 
@@ -1491,6 +1611,119 @@ IMesh* CQ3LevelMesh::getBrushEntityMesh(quake3::IEntity &ent) const
 }
 
 
+/*!
+	walks the bsp tree down to the leaf which contains position
+*/
+s32 CQ3LevelMesh::getCluster(const core::vector3df& position) const
+{
+	if ( 0 == NumNodes || 0 == NumLeafs )
+		return -1;
+
+	// the bsp tree uses the quake coordinate system, y and z are swapped in the mesh
+	const f32 pos[3] = { position.X, position.Z, position.Y };
+
+	s32 index = 0;
+	while ( index >= 0 )
+	{
+		if ( index >= NumNodes )
+			return -1;
+
+		const tBSPNode& node = Nodes[index];
+		if ( node.plane < 0 || node.plane >= NumPlanes )
+			return -1;
+
+		const tBSPPlane& plane = Planes[node.plane];
+		const f32 distance = plane.vNormal[0] * pos[0] + plane.vNormal[1] * pos[1] +
+				plane.vNormal[2] * pos[2] - plane.d;
+
+		index = distance >= 0.f ? node.front : node.back;
+	}
+
+	const s32 leaf = -(index + 1);
+	if ( leaf >= NumLeafs )
+		return -1;
+
+	return Leafs[leaf].cluster;
+}
+
+
+/*!
+*/
+bool CQ3LevelMesh::isClusterVisible(s32 from, s32 to) const
+{
+	if ( from < 0 || to < 0 || 0 == VisData.pBitsets ||
+		from >= VisData.numOfClusters || to >= VisData.numOfClusters )
+		return true;
+
+	const u8 bits = (u8) VisData.pBitsets[from * VisData.bytesPerCluster + (to >> 3)];
+	return (bits & (1 << (to & 7))) != 0;
+}
+
+
+/*!
+	collects the faces of all leafs in the potentially visible set of a cluster
+*/
+u32 CQ3LevelMesh::getVisibleIndices(s32 cluster, core::array<core::array<u16> >& indices) const
+{
+	const SMesh* mesh = Mesh[E_Q3_MESH_GEOMETRY];
+	if ( !mesh )
+		return 0;
+
+	const u32 bufferCount = mesh->MeshBuffers.size();
+	while ( indices.size() < bufferCount )
+		indices.push_back(core::array<u16>());
+	if ( indices.size() > bufferCount )
+		indices.erase(bufferCount, indices.size() - bufferCount);
+
+	for ( u32 i = 0; i < bufferCount; ++i )
+		indices[i].set_used(0);
+
+	// faces can be in several leafs, mark them first and add them once in their original order
+	const u32 faceCount = FaceIndices.size();
+	core::array<u8> visible;
+	visible.set_used(faceCount);
+	memset(visible.pointer(), cluster < 0 || 0 == NumLeafs ? 1 : 0, faceCount);
+
+	if ( cluster >= 0 )
+	{
+		for ( s32 l = 0; l < NumLeafs; ++l )
+		{
+			const tBSPLeaf& leaf = Leafs[l];
+			if ( leaf.cluster < 0 || !isClusterVisible(cluster, leaf.cluster) )
+				continue;
+
+			for ( s32 f = 0; f < leaf.numOfLeafFaces; ++f )
+			{
+				const s32 leafFace = leaf.leafface + f;
+				if ( leafFace < 0 || leafFace >= NumLeafFaces )
+					break;
+
+				const u32 face = (u32) LeafFaces[leafFace];
+				if ( face < faceCount )
+					visible[face] = 1;
+			}
+		}
+	}
+
+	u32 triangles = 0;
+	for ( u32 f = 0; f < faceCount; ++f )
+	{
+		const SFaceIndices& face = FaceIndices[f];
+		if ( !visible[f] || face.MeshBuffer < 0 || 0 == face.IndexCount )
+			continue;
+
+		const u16* source = ((const SMeshBufferLightMap*)mesh->MeshBuffers[face.MeshBuffer])->Indices.const_pointer() + face.FirstIndex;
+		core::array<u16>& target = indices[face.MeshBuffer];
+		for ( u32 i = 0; i < face.IndexCount; ++i )
+			target.push_back(source[i]);
+
+		triangles += face.IndexCount / 3;
+	}
+
+	return triangles;
+}
+
+
 /*!
 */
 const IShader * CQ3LevelMesh::getShader(u32 index) const
@@ -1777,7 +2010,20 @@ void CQ3LevelMesh::cleanMeshes()
 	{
 		bool texture0important = ( i == 0 );
 
-		cleanMesh(Mesh[i], texture0important);
+		if ( i == E_Q3_MESH_GEOMETRY )
+		{
+			core::array<s32> remap;
+			cleanMesh(Mesh[i], texture0important, &remap);
+
+			// faces of removed buffers are never visible
+			for (u32 f = 0; f < FaceIndices.size(); ++f)
+			{
+				if ( FaceIndices[f].MeshBuffer >= 0 )
+					FaceIndices[f].MeshBuffer = remap[FaceIndices[f].MeshBuffer];
+			}
+		}
+		else
+			cleanMesh(Mesh[i], texture0important);
 	}
 
 	// Then the brush entities
@@ -1787,7 +2033,7 @@ void CQ3LevelMesh::cleanMeshes()
 	}
 }
 
-void CQ3LevelMesh::cleanMesh(SMesh *m, const bool texture0important)
+void CQ3LevelMesh::cleanMesh(SMesh *m, const bool texture0important, core::array<s32>* remap)
 {
 	// delete all buffers without geometry in it.
 	u32 run = 0;
@@ -1815,6 +2061,12 @@ void CQ3LevelMesh::cleanMesh(SMesh *m, const bool texture0important)
 	s32 blockstart = -1;
 	s32 blockcount = 0;
 
+	if ( remap )
+	{
+		remap->set_used(0);
+		remap->reallocate(m->MeshBuffers.size());
+	}
+
 	while( i < m->MeshBuffers.size())
 	{
 		run += 1;
@@ -1838,6 +2090,8 @@ void CQ3LevelMesh::cleanMesh(SMesh *m, const bool texture0important)
 			remove += 1;
 			b->drop();
 			m->MeshBuffers.erase(i);
+			if ( remap )
+				remap->push_back(-1);
 		}
 		else
 		{
@@ -1855,6 +2109,8 @@ void CQ3LevelMesh::cleanMesh(SMesh *m, const bool texture0important)
 				}
 				blockstart = -1;
 			}
+			if ( remap )
+				remap->push_back(i);
 			i += 1;
 		}
 	}
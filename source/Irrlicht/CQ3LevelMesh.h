@@ -89,6 +89,15 @@ namespace scene
 		//! returns the requested brush entity
 		virtual IMesh* getBrushEntityMesh(quake3::IEntity &ent) const _IRR_OVERRIDE_;
 
+		//! returns the visibility cluster which contains a position
+		virtual s32 getCluster(const core::vector3df& position) const _IRR_OVERRIDE_;
+
+		//! returns if anything of one cluster can be seen from another one
+		virtual bool isClusterVisible(s32 from, s32 to) const _IRR_OVERRIDE_;
+
+		//! collects the level geometry which can be seen from a cluster
+		virtual u32 getVisibleIndices(s32 cluster, core::array<core::array<u16> >& indices) const _IRR_OVERRIDE_;
+
 		//Link to held meshes? ...
 
 
@@ -404,6 +413,19 @@ namespace scene
 		s32 *LeafFaces;
 		s32 NumLeafFaces;
 
+		tBSPVisData VisData;
+
+		//! Indices of a face in a mesh buffer of the level geometry
+		struct SFaceIndices
+		{
+			SFaceIndices() : MeshBuffer(-1), FirstIndex(0), IndexCount(0) {}
+
+			s32 MeshBuffer;
+			u32 FirstIndex;
+			u32 IndexCount;
+		};
+		core::array<SFaceIndices> FaceIndices;
+
 		s32 *MeshVerts;           // The vertex offsets for a mesh
 		s32 NumMeshVerts;
 
@@ -474,8 +496,9 @@ namespace scene
 		};
 
 		void cleanMeshes();
-		void cleanMesh(SMesh *m, const bool texture0important = false);
+		void cleanMesh(SMesh *m, const bool texture0important = false, core::array<s32>* remap = 0);
 		void cleanLoader ();
+		void cleanVisibility();
 		void calcBoundingBoxes();
 		c8 buf[128];
 		f32 FramesPerSecond;
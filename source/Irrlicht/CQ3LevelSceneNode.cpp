@@ -0,0 +1,289 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+
+#include "CQ3LevelSceneNode.h"
+#include "ISceneManager.h"
+#include "IMeshCache.h"
+#include "IVideoDriver.h"
+#include "ICameraSceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Number of clusters for which the visible faces are kept
+const u32 VISIBLE_SET_CACHE_SIZE = 16;
+
+//! constructor
+CQ3LevelSceneNode::CQ3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent,
+		ISceneManager* mgr, s32 id)
+	: ISceneNode(parent, mgr, id), Mesh(0), NextVisibleSet(0),
+	CurrentCluster(-2), PassCount(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CQ3LevelSceneNode");
+	#endif
+
+	setMesh(mesh);
+}
+
+
+//! destructor
+CQ3LevelSceneNode::~CQ3LevelSceneNode()
+{
+	setMesh(0);
+}
+
+
+//! Sets a new level, 0 removes the level
+void CQ3LevelSceneNode::setMesh(IQ3LevelMesh* mesh)
+{
+	if (mesh)
+		mesh->grab();
+	if (Mesh)
+		Mesh->drop();
+	Mesh = mesh;
+
+	for (u32 i = 0; i < Buffers.size(); ++i)
+		Buffers[i]->drop();
+	Buffers.clear();
+	Materials.clear();
+	VisibleSets.clear();
+	NextVisibleSet = 0;
+	CurrentCluster = -2;
+	Box.reset(0.f, 0.f, 0.f);
+
+	IMesh* geometry = Mesh ? Mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY) : 0;
+	if (!geometry)
+		return;
+
+	Box = geometry->getBoundingBox();
+
+	// own copies of the vertices, the indices change with the cluster of the camera
+	for (u32 i = 0; i < geometry->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* original = geometry->getMeshBuffer(i);
+
+		SMeshBufferLightMap* buffer = new SMeshBufferLightMap();
+		buffer->Material = original->getMaterial();
+		buffer->BoundingBox = original->getBoundingBox();
+		buffer->setHardwareMappingHint(EHM_STATIC, EBT_VERTEX);
+		buffer->setHardwareMappingHint(EHM_DYNAMIC, EBT_INDEX);
+
+		if (original->getVertexType() == video::EVT_2TCOORDS)
+		{
+			const video::S3DVertex2TCoords* vertices = (const video::S3DVertex2TCoords*)original->getVertices();
+			buffer->Vertices.reallocate(original->getVertexCount());
+			for (u32 v = 0; v < original->getVertexCount(); ++v)
+				buffer->Vertices.push_back(vertices[v]);
+		}
+
+		Buffers.push_back(buffer);
+		Materials.push_back(buffer->Material);
+	}
+}
+
+
+void CQ3LevelSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Mesh)
+	{
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		PassCount = 0;
+		u32 transparentCount = 0;
+		u32 solidCount = 0;
+
+		// count transparent and solid materials in this scene node
+		for (u32 i=0; i<Materials.size(); ++i)
+		{
+			if (driver->needsTransparentRenderPass(Materials[i]))
+				++transparentCount;
+			else
+				++solidCount;
+
+			if (solidCount && transparentCount)
+				break;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+
+		ISceneNode::OnRegisterSceneNode();
+	}
+}
+
+
+//! renders the node.
+void CQ3LevelSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	if (!Mesh || !driver)
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	++PassCount;
+
+	if (PassCount == 1)
+		updateVisibleSet();
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	for (u32 i = 0; i < Buffers.size(); ++i)
+	{
+		if (Buffers[i]->Indices.empty())
+			continue;
+
+		const bool transparent = driver->needsTransparentRenderPass(Materials[i]);
+
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(Materials[i]);
+			driver->drawMeshBuffer(Buffers[i]);
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible && PassCount == 1)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & scene::EDS_BBOX)
+			driver->draw3DBox(Box, video::SColor(255,255,255,255));
+
+		if (DebugDataVisible & scene::EDS_BBOX_BUFFERS)
+		{
+			for (u32 i = 0; i < Buffers.size(); ++i)
+			{
+				if (!Buffers[i]->Indices.empty())
+					driver->draw3DBox(Buffers[i]->BoundingBox, video::SColor(255,190,128,128));
+			}
+		}
+	}
+}
+
+
+//! Finds the cluster of the active camera and updates the indices of the buffers
+void CQ3LevelSceneNode::updateVisibleSet()
+{
+	s32 cluster = -1;
+
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (camera)
+	{
+		core::vector3df position = camera->getAbsolutePosition();
+		core::matrix4 worldToLevel;
+		if (AbsoluteTransformation.getInverse(worldToLevel))
+		{
+			worldToLevel.transformVect(position);
+			cluster = Mesh->getCluster(position);
+		}
+	}
+
+	if (cluster == CurrentCluster)
+		return;
+
+	CurrentCluster = cluster;
+
+	const SVisibleSet& set = getVisibleSet(cluster);
+	for (u32 i = 0; i < Buffers.size() && i < set.Indices.size(); ++i)
+	{
+		Buffers[i]->Indices = set.Indices[i];
+		Buffers[i]->setDirty(EBT_INDEX);
+	}
+}
+
+
+//! Returns the faces which can be seen from cluster, looks them up only once for recent clusters
+const CQ3LevelSceneNode::SVisibleSet& CQ3LevelSceneNode::getVisibleSet(s32 cluster)
+{
+	for (u32 i = 0; i < VisibleSets.size(); ++i)
+	{
+		if (VisibleSets[i].Cluster == cluster)
+			return VisibleSets[i];
+	}
+
+	if (VisibleSets.size() < VISIBLE_SET_CACHE_SIZE)
+	{
+		VisibleSets.push_back(SVisibleSet());
+		NextVisibleSet = VisibleSets.size() - 1;
+	}
+
+	SVisibleSet& set = VisibleSets[NextVisibleSet];
+	NextVisibleSet = (NextVisibleSet + 1) % VISIBLE_SET_CACHE_SIZE;
+
+	set.Cluster = cluster;
+	Mesh->getVisibleIndices(cluster, set.Indices);
+
+	return set;
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CQ3LevelSceneNode::getBoundingBox() const
+{
+	return Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CQ3LevelSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CQ3LevelSceneNode::getMaterialCount() const
+{
+	return Materials.size();
+}
+
+
+//! Writes attributes of the scene node.
+void CQ3LevelSceneNode::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
+{
+	ISceneNode::serializeAttributes(out, options);
+
+	out->addString("Mesh", Mesh ? SceneManager->getMeshCache()->getMeshName(Mesh).getPath().c_str() : "");
+}
+
+
+//! Reads attributes of the scene node.
+void CQ3LevelSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options)
+{
+	const io::path meshName = in->getAttributeAsString("Mesh");
+	if (meshName.size() && (!Mesh || meshName != SceneManager->getMeshCache()->getMeshName(Mesh).getPath()))
+	{
+		IAnimatedMesh* mesh = SceneManager->getMesh(meshName);
+		if (mesh && mesh->getMeshType() == EAMT_BSP)
+			setMesh((IQ3LevelMesh*)mesh);
+	}
+
+	ISceneNode::deserializeAttributes(in, options);
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BSP_LOADER_
+
@@ -0,0 +1,85 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+#define __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "IQ3LevelMesh.h"
+#include "SMeshBufferLightMap.h"
+
+namespace irr
+{
+namespace scene
+{
+	//! Draws the geometry of a quake 3 level which can be seen from the cluster of the camera
+	class CQ3LevelSceneNode : public ISceneNode
+	{
+	public:
+
+		//! constructor
+		CQ3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id);
+
+		//! destructor
+		virtual ~CQ3LevelSceneNode();
+
+		virtual void OnRegisterSceneNode() _IRR_OVERRIDE_;
+
+		//! renders the node.
+		virtual void render() _IRR_OVERRIDE_;
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const _IRR_OVERRIDE_;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) _IRR_OVERRIDE_;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const _IRR_OVERRIDE_;
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const _IRR_OVERRIDE_ { return ESNT_Q3_LEVEL; }
+
+		//! Writes attributes of the scene node.
+		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const _IRR_OVERRIDE_;
+
+		//! Reads attributes of the scene node.
+		virtual void deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options=0) _IRR_OVERRIDE_;
+
+		//! Sets a new level, 0 removes the level
+		void setMesh(IQ3LevelMesh* mesh);
+
+		//! Returns the level
+		IQ3LevelMesh* getMesh() const { return Mesh; }
+
+	private:
+
+		//! Indices of the faces which can be seen from a cluster
+		struct SVisibleSet
+		{
+			s32 Cluster;
+			core::array<core::array<u16> > Indices;
+		};
+
+		//! Finds the cluster of the active camera and updates the indices of the buffers
+		void updateVisibleSet();
+		const SVisibleSet& getVisibleSet(s32 cluster);
+
+		IQ3LevelMesh* Mesh;
+		core::array<SMeshBufferLightMap*> Buffers;
+		core::array<video::SMaterial> Materials;
+		core::aabbox3d<f32> Box;
+
+		//! Visible sets of the last clusters the camera was in
+		core::array<SVisibleSet> VisibleSets;
+		u32 NextVisibleSet;
+		s32 CurrentCluster;
+		s32 PassCount;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
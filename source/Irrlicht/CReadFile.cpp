@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CReadFile.h"
+#include "CMappedReadFile.h"
 
 namespace irr
 {
@@ -101,7 +102,21 @@ IReadFile* CReadFile::createReadFile(const io::path& fileName)
 {
 	CReadFile* file = new CReadFile(fileName);
 	if (file->isOpen())
+	{
+#ifdef _IRR_COMPILE_WITH_MAPPED_READ_FILE_
+		// large files are mapped into memory instead
+		if (file->getSize() >= _IRR_MAPPED_READ_FILE_MIN_SIZE_)
+		{
+			IReadFile* mapped = CMappedReadFile::createMappedReadFile(fileName);
+			if (mapped)
+			{
+				file->drop();
+				return mapped;
+			}
+		}
+#endif
 		return file;
+	}
 
 	file->drop();
 	return 0;
@@ -14,6 +14,8 @@
 #include "coreutil.h"
 #include "os.h"
 #include "IVideoDriver.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -34,6 +36,7 @@ bool CSMFMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! Creates/loads an animated mesh from the file.
 IAnimatedMesh* CSMFMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_SMF);)
 	if ( !file )
 		return 0;
 
@@ -35,6 +35,9 @@ public:
 
 	//! Creates/loads an animated mesh from the file.
 	virtual IAnimatedMesh* createMesh(io::IReadFile* file) _IRR_OVERRIDE_;
+
+	//! Does not use the video driver
+	virtual bool isThreadSafe() const _IRR_OVERRIDE_ { return true; }
 private:
 
 	void loadLimb(io::IReadFile* file, scene::SMesh* mesh, const core::matrix4 &parentTransformation);
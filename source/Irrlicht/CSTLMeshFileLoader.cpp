@@ -14,6 +14,8 @@
 #include "fast_atof.h"
 #include "coreutil.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -36,6 +38,7 @@ bool CSTLMeshFileLoader::isALoadableFileExtension(const io::path& filename) cons
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CSTLMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_STL);)
 	const long filesize = file->getSize();
 	if (filesize < 6) // we need a header
 		return 0;
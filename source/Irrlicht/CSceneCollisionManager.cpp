@@ -7,9 +7,12 @@
 #include "ICameraSceneNode.h"
 #include "ITriangleSelector.h"
 #include "SViewFrustum.h"
+#include "IJobSystem.h"
 
 #include "os.h"
 #include "irrMath.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -26,6 +29,18 @@ CSceneCollisionManager::CSceneCollisionManager(ISceneManager* smanager, video::I
 
 	if (Driver)
 		Driver->grab();
+
+	IRR_PROFILE(
+		static bool initProfile = false;
+		if (!initProfile )
+		{
+			initProfile = true;
+			getProfiler().add(EPID_CM_NODE_FROM_RAY_BB, L"nodeFromRayBB", L"Collision");
+			getProfiler().add(EPID_CM_NODE_AND_POINT_FROM_RAY, L"nodeAndPoint", L"Collision");
+			getProfiler().add(EPID_CM_COLLISION_POINT, L"collisionPoint", L"Collision");
+			getProfiler().add(EPID_CM_COLLISION_RESPONSE, L"response", L"Collision");
+		}
+	)
 }
 
 
@@ -57,6 +72,7 @@ ISceneNode* CSceneCollisionManager::getSceneNodeFromRayBB(
 		const core::line3d<f32>& ray,
 		s32 idBitMask, bool noDebugObjects, scene::ISceneNode* root)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_CM_NODE_FROM_RAY_BB);)
 	ISceneNode* best = 0;
 	f32 dist = FLT_MAX;
 
@@ -231,6 +247,7 @@ ISceneNode* CSceneCollisionManager::getSceneNodeAndCollisionPointFromRay(
 						ISceneNode * collisionRootNode,
 						bool noDebugObjects)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_CM_NODE_AND_POINT_FROM_RAY);)
 	if(0 == collisionRootNode)
 		collisionRootNode = SceneManager->getRootSceneNode();
 
@@ -339,6 +356,7 @@ ISceneNode* CSceneCollisionManager::getSceneNodeFromCameraBB(
 
 bool CSceneCollisionManager::getCollisionPoint(SCollisionHit& hitResult, const core::line3d<f32>& ray, ITriangleSelector* selector)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_CM_COLLISION_POINT);)
 	if (!selector)
 	{
 		return false;
@@ -434,13 +452,130 @@ core::vector3df CSceneCollisionManager::getCollisionResultPosition(
 		f32 slidingSpeed,
 		const core::vector3df& gravity)
 {
-	return collideEllipsoidWithWorld(selector, position,
-		radius, direction, slidingSpeed, gravity, triout, hitPosition, outFalling, outNode);
+	SCollisionResponse response;
+	response.Selector = selector;
+	response.Position = position;
+	response.Radius = radius;
+	response.Direction = direction;
+	response.Gravity = gravity;
+	response.SlidingSpeed = slidingSpeed;
+	response.Triangle = triout;
+	response.HitPosition = hitPosition;
+	response.Falling = outFalling;
+	response.Node = outNode;
+
+	getCollisionResultPositions(&response, 1, 0);
+
+	triout = response.Triangle;
+	hitPosition = response.HitPosition;
+	outFalling = response.Falling;
+	outNode = response.Node;
+	return response.ResultPosition;
+}
+
+
+//! Collides many moving ellipsoids with their worlds at once
+void CSceneCollisionManager::getCollisionResultPositions(SCollisionResponse* responses,
+		u32 count, IJobSystem* jobs)
+{
+	IRR_PROFILE(CProfileScope p1(EPID_CM_COLLISION_RESPONSE);)
+
+	// This code is based on the paper "Improved Collision detection and Response"
+	// by Kasper Fauerby, but some parts are modified.
+
+	u32 bodyCount = 0;
+	for (u32 i=0; i<count; ++i)
+	{
+		SCollisionResponse& response = responses[i];
+		response.ResultPosition = response.Position;
+		if (!response.Selector || response.Radius.X == 0.0f ||
+			response.Radius.Y == 0.0f || response.Radius.Z == 0.0f)
+			continue;
+
+		if (bodyCount == Bodies.size())
+			Bodies.push_back(SCollisionBody());
+		SCollisionBody& body = Bodies[bodyCount++];
+		body.Response = &response;
+		body.Collide = true;
+
+		SCollisionData& colData = body.Data;
+		colData = SCollisionData();
+		colData.R3Position = response.Position;
+		colData.R3Velocity = response.Direction;
+		colData.eRadius = response.Radius;
+		colData.nearestDistance = FLT_MAX;
+		colData.selector = response.Selector;
+		colData.slidingSpeed = response.SlidingSpeed;
+		colData.triangleHits = 0;
+		colData.node = 0;
+
+		body.Position = colData.R3Position / colData.eRadius;
+		body.Velocity = colData.R3Velocity / colData.eRadius;
+	}
+
+	// the first pass moves the ellipsoids, the second one adds gravity
+	for (u32 pass=0; pass<2; ++pass)
+	{
+		if (pass == 1)
+		{
+			for (u32 i=0; i<bodyCount; ++i)
+			{
+				SCollisionBody& body = Bodies[i];
+				const core::vector3df& gravity = body.Response->Gravity;
+				body.Collide = (gravity != core::vector3df(0,0,0));
+				if (body.Collide)
+				{
+					body.Data.R3Position = body.Position * body.Data.eRadius;
+					body.Data.R3Velocity = gravity;
+					body.Data.triangleHits = 0;
+					body.Velocity = gravity / body.Data.eRadius;
+				}
+			}
+		}
+
+		// the selectors which aren't thread safe are asked one body after another
+		const bool parallel = jobs && bodyCount > 1;
+		for (u32 i=0; i<bodyCount; ++i)
+		{
+			SCollisionBody& body = Bodies[i];
+			body.TrianglesFetched = body.Collide &&
+				!(parallel && body.Data.selector->isThreadSafe());
+			if (body.TrianglesFetched)
+				getBodyTriangles(body, &Triangles);
+		}
+
+		if (parallel)
+			jobs->parallelFor(collideBodies, this, bodyCount);
+		else
+			collideBodies(this, 0, bodyCount);
+	}
+
+	for (u32 i=0; i<bodyCount; ++i)
+	{
+		const SCollisionBody& body = Bodies[i];
+		const SCollisionData& colData = body.Data;
+		SCollisionResponse& response = *body.Response;
+
+		// Collide is still set when gravity was added
+		response.Falling = body.Collide && colData.triangleHits == 0;
+
+		if (colData.triangleHits)
+		{
+			response.Triangle = colData.intersectionTriangle;
+			response.Triangle.pointA *= colData.eRadius;
+			response.Triangle.pointB *= colData.eRadius;
+			response.Triangle.pointC *= colData.eRadius;
+			response.Node = colData.node;
+		}
+
+		response.ResultPosition = body.Position * colData.eRadius;
+		response.HitPosition = colData.intersectionPoint * colData.eRadius;
+	}
 }
 
 
 bool CSceneCollisionManager::testTriangleIntersection(SCollisionData* colData,
-			const core::triangle3df& triangle)
+			const core::triangle3df& triangle) const
 {
 	const core::plane3d<f32> trianglePlane = triangle.getPlane();
 
@@ -689,78 +824,76 @@ bool CSceneCollisionManager::testTriangleIntersection(SCollisionData* colData,
 }
 
 
-//! Collides a moving ellipsoid with a 3d world with gravity and returns
-//! the resulting new position of the ellipsoid.
-core::vector3df CSceneCollisionManager::collideEllipsoidWithWorld(
-		ITriangleSelector* selector, const core::vector3df &position,
-		const core::vector3df& radius,  const core::vector3df& velocity,
-		f32 slidingSpeed,
-		const core::vector3df& gravity,
-		core::triangle3df& triout,
-		core::vector3df& hitPosition,
-		bool& outFalling,
-		ISceneNode*& outNode)
+//! gets the triangles which the current pass of the body might touch from its selector
+void CSceneCollisionManager::getBodyTriangles(SCollisionBody& body,
+		core::array<core::triangle3df>* buffer) const
 {
-	if (!selector || radius.X == 0.0f || radius.Y == 0.0f || radius.Z == 0.0f)
-		return position;
-
-	// This code is based on the paper "Improved Collision detection and Response"
-	// by Kasper Fauerby, but some parts are modified.
-
-	SCollisionData colData;
-	colData.R3Position = position;
-	colData.R3Velocity = velocity;
-	colData.eRadius = radius;
-	colData.nearestDistance = FLT_MAX;
-	colData.selector = selector;
-	colData.slidingSpeed = slidingSpeed;
-	colData.triangleHits = 0;
-	colData.node = 0;
+	const SCollisionData& colData = body.Data;
 
-	core::vector3df eSpacePosition = colData.R3Position / colData.eRadius;
-	core::vector3df eSpaceVelocity = colData.R3Velocity / colData.eRadius;
-
-	// iterate until we have our final position
-
-	core::vector3df finalPos = collideWithWorld(
-		0, colData, eSpacePosition, eSpaceVelocity);
+	// get all triangles with which we might collide
+	core::aabbox3d<f32> box(colData.R3Position);
+	box.addInternalPoint(colData.R3Position + colData.R3Velocity);
+	box.MinEdge -= colData.eRadius;
+	box.MaxEdge += colData.eRadius;
 
-	outFalling = false;
+	const s32 totalTriangleCnt = colData.selector->getTriangleCount();
 
-	// add gravity
+	core::matrix4 scaleMatrix;
+	scaleMatrix.setScale(
+			core::vector3df(1.0f / colData.eRadius.X,
+					1.0f / colData.eRadius.Y,
+					1.0f / colData.eRadius.Z));
 
-	if (gravity != core::vector3df(0,0,0))
+	// the box does not change during a pass, so the recursion can reuse the triangles
+	s32 triangleCnt = 0;
+	if (buffer)
 	{
-		colData.R3Position = finalPos * colData.eRadius;
-		colData.R3Velocity = gravity;
-		colData.triangleHits = 0;
-
-		eSpaceVelocity = gravity/colData.eRadius;
+		buffer->set_used(totalTriangleCnt);
+		body.TriangleRanges.set_used(0);
+		colData.selector->getTriangles(buffer->pointer(), totalTriangleCnt, triangleCnt, box, &scaleMatrix, true, &body.TriangleRanges);
 
-		finalPos = collideWithWorld(0, colData,
-			finalPos, eSpaceVelocity);
-
-		outFalling = (colData.triangleHits == 0);
+		body.Triangles.set_used(triangleCnt);
+		for (s32 i=0; i<triangleCnt; ++i)
+			body.Triangles[i] = (*buffer)[i];
 	}
-
-	if (colData.triangleHits)
+	else
 	{
-		triout = colData.intersectionTriangle;
-		triout.pointA *= colData.eRadius;
-		triout.pointB *= colData.eRadius;
-		triout.pointC *= colData.eRadius;
-		outNode = colData.node;
+		// a thread safe selector fills the whole array when it has more triangles
+		s32 arraySize = core::min_(core::max_((s32)body.Triangles.allocated_size(), 64), totalTriangleCnt);
+		for (;;)
+		{
+			body.Triangles.set_used(arraySize);
+			body.TriangleRanges.set_used(0);
+			colData.selector->getTriangles(body.Triangles.pointer(), arraySize, triangleCnt, box, &scaleMatrix, true, &body.TriangleRanges);
+			if (triangleCnt < arraySize || arraySize == totalTriangleCnt)
+				break;
+			arraySize = core::min_(arraySize*2, totalTriangleCnt);
+		}
+		body.Triangles.set_used(triangleCnt);
 	}
+}
+
 
-	finalPos *= colData.eRadius;
-	hitPosition = colData.intersectionPoint * colData.eRadius;
-	return finalPos;
+//! runs the current pass of the bodies begin to end-1
+void CSceneCollisionManager::collideBodies(void* data, u32 begin, u32 end)
+{
+	CSceneCollisionManager* manager = (CSceneCollisionManager*)data;
+	for (u32 i=begin; i<end; ++i)
+	{
+		SCollisionBody& body = manager->Bodies[i];
+		if (!body.Collide)
+			continue;
+		if (!body.TrianglesFetched)
+			manager->getBodyTriangles(body, 0);
+		body.Position = manager->collideWithWorld(0, body, body.Position, body.Velocity);
+	}
 }
 
 
 core::vector3df CSceneCollisionManager::collideWithWorld(s32 recursionDepth,
-	SCollisionData &colData, const core::vector3df& pos, const core::vector3df& vel)
+	SCollisionBody& body, const core::vector3df& pos, const core::vector3df& vel) const
 {
+	SCollisionData& colData = body.Data;
 	f32 veryCloseDistance = colData.slidingSpeed;
 
 	if (recursionDepth > 5)
@@ -775,41 +908,23 @@ core::vector3df CSceneCollisionManager::collideWithWorld(s32 recursionDepth,
 
 	//------------------ collide with world
 
-	// get all triangles with which we might collide
-	core::aabbox3d<f32> box(colData.R3Position);
-	box.addInternalPoint(colData.R3Position + colData.R3Velocity);
-	box.MinEdge -= colData.eRadius;
-	box.MaxEdge += colData.eRadius;
-
-	s32 totalTriangleCnt = colData.selector->getTriangleCount();
-	Triangles.set_used(totalTriangleCnt);
-
-	core::matrix4 scaleMatrix;
-	scaleMatrix.setScale(
-			core::vector3df(1.0f / colData.eRadius.X,
-					1.0f / colData.eRadius.Y,
-					1.0f / colData.eRadius.Z));
-
-	irr::core::array<SCollisionTriangleRange> outTriangleInfo;
-	s32 triangleCnt = 0;
-	colData.selector->getTriangles(Triangles.pointer(), totalTriangleCnt, triangleCnt, box, &scaleMatrix, true, &outTriangleInfo);
-
 	// Find closest intersection
 	irr::s32 nearestTriangleIndex = -1;
+	const s32 triangleCnt = (s32)body.Triangles.size();
 	for (s32 i=0; i<triangleCnt; ++i)
 	{
-		if(testTriangleIntersection(&colData, Triangles[i]))
+		if(testTriangleIntersection(&colData, body.Triangles[i]))
 		{
 			nearestTriangleIndex = i;
 		}
 	}
 	if ( nearestTriangleIndex >= 0 )
 	{
-		for ( irr::u32 t=0; t<outTriangleInfo.size(); ++t )
+		for ( irr::u32 t=0; t<body.TriangleRanges.size(); ++t )
 		{
-			if ( outTriangleInfo[t].isIndexInRange(nearestTriangleIndex) )
+			if ( body.TriangleRanges[t].isIndexInRange(nearestTriangleIndex) )
 			{
-				colData.node = outTriangleInfo[t].SceneNode;
+				colData.node = body.TriangleRanges[t].SceneNode;
 				break;
 			}
 		}
@@ -855,7 +970,7 @@ core::vector3df CSceneCollisionManager::collideWithWorld(s32 recursionDepth,
 	if (newVelocityVector.getLength() < veryCloseDistance)
 		return newBasePoint;
 
-	return collideWithWorld(recursionDepth+1, colData,
+	return collideWithWorld(recursionDepth+1, body,
 		newBasePoint, newVelocityVector);
 }
 
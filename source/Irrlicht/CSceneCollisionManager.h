@@ -59,6 +59,10 @@ namespace scene
 			f32 slidingSpeed,
 			const core::vector3df& gravityDirectionAndSpeed) _IRR_OVERRIDE_;
 
+		//! Collides many moving ellipsoids with their worlds at once
+		virtual void getCollisionResultPositions(SCollisionResponse* responses, u32 count,
+			IJobSystem* jobs) _IRR_OVERRIDE_;
+
 		//! Returns a 3d ray which would go through the 2d screen coordinates.
 		virtual core::line3d<f32> getRayFromScreenCoordinates(
 			const core::position2d<s32> & pos, const ICameraSceneNode* camera = 0) _IRR_OVERRIDE_;
@@ -117,32 +121,53 @@ namespace scene
 			ITriangleSelector* selector;
 		};
 
+		//! Ellipsoid of getCollisionResultPositions
+		struct SCollisionBody
+		{
+			SCollisionResponse* Response;
+			SCollisionData Data;
+
+			//! Position and velocity of the current pass in ellipsoid space
+			core::vector3df Position;
+			core::vector3df Velocity;
+
+			//! False when the current pass has nothing to do
+			bool Collide;
+
+			//! True when the triangles of the current pass were taken on the calling thread
+			bool TrianglesFetched;
+
+			//! Triangles which the current pass might touch, in ellipsoid space
+			core::array<core::triangle3df> Triangles;
+			core::array<SCollisionTriangleRange> TriangleRanges;
+		};
+
 		//! Tests the current collision data against an individual triangle.
 		/**
 		\param colData: the collision data.
 		\param triangle: the triangle to test against.
 		\return true if the triangle is hit (and is the closest hit), false otherwise */
 		bool testTriangleIntersection(SCollisionData* colData,
-			const core::triangle3df& triangle);
+			const core::triangle3df& triangle) const;
 
-		//! recursive method for doing collision response
-		core::vector3df collideEllipsoidWithWorld(ITriangleSelector* selector,
-			const core::vector3df &position,
-			const core::vector3df& radius,  const core::vector3df& velocity,
-			f32 slidingSpeed,
-			const core::vector3df& gravity, core::triangle3df& triout,
-			core::vector3df& hitPosition,
-			bool& outFalling,
-			ISceneNode*& outNode);
+		//! gets the triangles which the current pass of the body might touch from its selector
+		/** Without a buffer for all triangles of the selector, the triangles
+		of the body grow until the thread safe selector has no more. */
+		void getBodyTriangles(SCollisionBody& body, core::array<core::triangle3df>* buffer) const;
+
+		//! recursive method for doing collision response, only uses the triangles of the body
+		core::vector3df collideWithWorld(s32 recursionDepth, SCollisionBody& body,
+			const core::vector3df& pos, const core::vector3df& vel) const;
 
-		core::vector3df collideWithWorld(s32 recursionDepth, SCollisionData &colData,
-			const core::vector3df& pos, const core::vector3df& vel);
+		//! runs the current pass of the bodies begin to end-1
+		static void collideBodies(void* data, u32 begin, u32 end);
 
 		inline bool getLowestRoot(f32 a, f32 b, f32 c, f32 maxR, f32* root) const;
 
 		ISceneManager* SceneManager;
 		video::IVideoDriver* Driver;
 		core::array<core::triangle3df> Triangles; // triangle buffer
+		core::array<SCollisionBody> Bodies; // ellipsoids of getCollisionResultPositions
 	};
 
 
@@ -17,7 +17,7 @@ namespace scene
 
 //! Constructor
 CSceneLoaderIrr::CSceneLoaderIrr(ISceneManager *smgr, io::IFileSystem* fs)
- : SceneManager(smgr), FileSystem(fs),
+ : SceneManager(smgr), FileSystem(fs), Attributes(0),
    IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type"),
    IRR_XML_FORMAT_ATTRIBUTES(L"attributes"), IRR_XML_FORMAT_MATERIALS(L"materials"),
    IRR_XML_FORMAT_ANIMATORS(L"animators"), IRR_XML_FORMAT_USERDATA(L"userData")
@@ -28,7 +28,8 @@ CSceneLoaderIrr::CSceneLoaderIrr(ISceneManager *smgr, io::IFileSystem* fs)
 //! Destructor
 CSceneLoaderIrr::~CSceneLoaderIrr()
 {
-
+	if (Attributes)
+		Attributes->drop();
 }
 
 //! Returns true if the class might be able to load this file.
@@ -124,7 +125,7 @@ void CSceneLoaderIrr::readSceneNode(io::IXMLReader* reader, ISceneNode* parent,
 			if (IRR_XML_FORMAT_ATTRIBUTES == name)
 			{
 				// read attributes
-				io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+				io::IAttributes* attr = createEmptyAttributes();
 				attr->read(reader, true);
 
 				if (node)
@@ -183,7 +184,7 @@ void CSceneLoaderIrr::readMaterials(io::IXMLReader* reader, ISceneNode* node)
 			if (IRR_XML_FORMAT_ATTRIBUTES == name)
 			{
 				// read materials from attribute list
-				io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+				io::IAttributes* attr = createEmptyAttributes();
 				attr->read(reader);
 
 				if (node && node->getMaterialCount() > nr)
@@ -220,7 +221,7 @@ void CSceneLoaderIrr::readAnimators(io::IXMLReader* reader, ISceneNode* node)
 			if (IRR_XML_FORMAT_ATTRIBUTES == name)
 			{
 				// read animator data from attribute list
-				io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+				io::IAttributes* attr = createEmptyAttributes();
 				attr->read(reader);
 
 				if (node)
@@ -262,7 +263,7 @@ void CSceneLoaderIrr::readUserData(io::IXMLReader* reader, ISceneNode* node, ISc
 			if (IRR_XML_FORMAT_ATTRIBUTES == name)
 			{
 				// read user data from attribute list
-				io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+				io::IAttributes* attr = createEmptyAttributes();
 				attr->read(reader);
 
 				if (node && userDataSerializer)
@@ -279,6 +280,28 @@ void CSceneLoaderIrr::readUserData(io::IXMLReader* reader, ISceneNode* node, ISc
 	}
 }
 
+
+//! Returns an empty attribute list
+io::IAttributes* CSceneLoaderIrr::createEmptyAttributes()
+{
+	// Reuse the list of the previous element when nobody else kept it,
+	// so its attribute objects are recycled instead of allocated again.
+	if (Attributes && Attributes->getReferenceCount() == 1)
+	{
+		Attributes->clear();
+		Attributes->grab();
+		return Attributes;
+	}
+
+	io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+	if (!Attributes)
+	{
+		Attributes = attr;
+		Attributes->grab();
+	}
+	return attr;
+}
+
 } // scene
 } // irr
 
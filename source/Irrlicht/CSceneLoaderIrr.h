@@ -15,6 +15,7 @@ namespace irr
 namespace io
 {
 	class IFileSystem;
+	class IAttributes;
 }
 
 namespace scene
@@ -60,8 +61,12 @@ private:
 	void readUserData(io::IXMLReader* reader, ISceneNode* node,
 		ISceneUserDataSerializer* userDataSerializer);
 
+	//! returns an empty attribute list, drop it when done
+	io::IAttributes* createEmptyAttributes();
+
 	ISceneManager   *SceneManager;
 	io::IFileSystem *FileSystem;
+	io::IAttributes *Attributes;
 
 	//! constants for reading and writing XML.
 	//! Not made static due to portability problems.
@@ -0,0 +1,620 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_SCENE_LOADER_
+
+#include "CSceneLoaderIrrBin.h"
+#include "ISceneNodeAnimatorFactory.h"
+#include "ISceneUserDataSerializer.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "IMemoryReadFile.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Constructor
+CSceneLoaderIrrBin::CSceneLoaderIrrBin(ISceneManager *smgr, io::IFileSystem* fs)
+ : SceneManager(smgr), FileSystem(fs), Attributes(0)
+{
+
+}
+
+//! Destructor
+CSceneLoaderIrrBin::~CSceneLoaderIrrBin()
+{
+	if (Attributes)
+		Attributes->drop();
+}
+
+//! Returns true if the class might be able to load this file.
+bool CSceneLoaderIrrBin::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "irrbin");
+}
+
+//! Returns true if the class might be able to load this file.
+bool CSceneLoaderIrrBin::isALoadableFileFormat(io::IReadFile *file) const
+{
+	if (!file)
+		return false;
+
+	const long pos = file->getPos();
+	c8 magic[4];
+	const bool result = file->read(magic, 4) == 4 && !memcmp(magic, IRRBIN_MAGIC, 4);
+	file->seek(pos);
+
+	return result;
+}
+
+//! Loads the scene into the scene manager.
+bool CSceneLoaderIrrBin::loadScene(io::IReadFile* file, ISceneUserDataSerializer* userDataSerializer,
+	ISceneNode* rootNode)
+{
+	if (!file)
+	{
+		os::Printer::log("Unable to open scene file", ELL_ERROR);
+		return false;
+	}
+
+	const long size = file->getSize() - file->getPos();
+	if (size < (long)sizeof(SIrrBinSceneHeader))
+	{
+		os::Printer::log("Scene file is too small", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	// get the whole file at once, memory files are used without copying them
+	core::array<u8> fileData;
+	const u8* data = 0;
+	if (file->getType() == io::ERFT_MEMORY_READ_FILE || file->getType() == io::ERFT_MAPPED_READ_FILE)
+	{
+		data = (const u8*)static_cast<io::IMemoryReadFile*>(file)->getBuffer() + file->getPos();
+		file->seek(size, true);
+	}
+	else
+	{
+		fileData.set_used(size);
+		if (file->read(fileData.pointer(), size) != (size_t)size)
+		{
+			os::Printer::log("Could not read scene file", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+		data = fileData.const_pointer();
+	}
+
+	SIrrBinSceneHeader header;
+	memcpy(&header, data, sizeof(header));
+
+#ifdef __BIG_ENDIAN__
+	header.Version = os::Byteswap::byteswap(header.Version);
+	header.StringTableOffset = os::Byteswap::byteswap(header.StringTableOffset);
+	header.StringCount = os::Byteswap::byteswap(header.StringCount);
+	header.ResourceTableOffset = os::Byteswap::byteswap(header.ResourceTableOffset);
+	header.ResourceCount = os::Byteswap::byteswap(header.ResourceCount);
+	header.NodesOffset = os::Byteswap::byteswap(header.NodesOffset);
+	header.NodesSize = os::Byteswap::byteswap(header.NodesSize);
+#endif
+
+	if (memcmp(header.Magic, IRRBIN_MAGIC, 4))
+	{
+		os::Printer::log("Not a binary scene file", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	if (header.Version > IRRBIN_VERSION)
+	{
+		os::Printer::log("Unsupported version of binary scene file", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	// each string takes at least 5 bytes, each resource 8
+	const u32 fileSize = (u32)size;
+	if (header.StringTableOffset > fileSize || header.StringCount > (fileSize - header.StringTableOffset) / 5 ||
+		header.ResourceTableOffset > fileSize || header.ResourceCount > (fileSize - header.ResourceTableOffset) / 8 ||
+		header.NodesOffset > fileSize || header.NodesSize > fileSize - header.NodesOffset)
+	{
+		os::Printer::log("Binary scene file is corrupt", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	SReadState state;
+
+	// string table, the strings are used directly from the file data
+	state.Pos = data + header.StringTableOffset;
+	state.End = data + fileSize;
+	state.Strings.reallocate(header.StringCount);
+	for (u32 i=0; i<header.StringCount && !state.Failed; ++i)
+	{
+		const u32 length = readU32(state);
+		if (state.Failed || length >= (u32)(state.End - state.Pos) || state.Pos[length])
+		{
+			state.Failed = true;
+			break;
+		}
+		state.Strings.push_back((const c8*)state.Pos);
+		state.Pos += length + 1;
+	}
+
+	// resource table
+	state.Pos = data + header.ResourceTableOffset;
+	state.Resources.reallocate(header.ResourceCount * 2);
+	for (u32 i=0; i<header.ResourceCount && !state.Failed; ++i)
+	{
+		const u32 type = readU32(state);
+		const u32 path = readU32(state);
+		if (type >= EIBR_COUNT || path >= state.Strings.size())
+			state.Failed = true;
+		state.Resources.push_back(type);
+		state.Resources.push_back(path);
+	}
+	state.Textures.set_used(header.ResourceCount);
+	state.TexturesLoaded.set_used(header.ResourceCount);
+	for (u32 i=0; i<header.ResourceCount; ++i)
+	{
+		state.Textures[i] = 0;
+		state.TexturesLoaded[i] = false;
+	}
+
+	if (!state.Failed && header.NodesSize)
+	{
+		state.Pos = data + header.NodesOffset;
+		state.End = state.Pos + header.NodesSize;
+
+		bool oldColladaSingleMesh = SceneManager->getParameters()->getAttributeAsBool(COLLADA_CREATE_SCENE_INSTANCES);
+		SceneManager->getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, false);
+
+		readSceneNode(state, rootNode, userDataSerializer, 0);
+
+		// restore old collada parameters
+		SceneManager->getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, oldColladaSingleMesh);
+	}
+
+	if (state.Failed)
+	{
+		os::Printer::log("Binary scene file is corrupt", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	return true;
+}
+
+
+//! Reads a node record
+void CSceneLoaderIrrBin::readSceneNode(SReadState& state, ISceneNode* parent,
+	ISceneUserDataSerializer* userDataSerializer, u32 depth)
+{
+	if (depth > IRRBIN_MAX_DEPTH)
+	{
+		state.Failed = true;
+		return;
+	}
+
+	scene::ISceneNode* node = 0;
+
+	const u32 type = readU32(state);
+	if (type == IRRBIN_NO_INDEX)
+		node = parent ? parent : SceneManager->getRootSceneNode();
+	else
+	{
+		// find node type and create it
+		if (state.Failed || type >= state.Strings.size())
+		{
+			state.Failed = true;
+			return;
+		}
+		const c8* typeName = state.Strings[type];
+
+		if (parent)
+		{
+			node = SceneManager->addSceneNode(typeName, parent);
+
+			if (!node)
+				os::Printer::log("Could not create scene node of unknown type", typeName);
+		}
+	}
+
+	// read attributes
+	io::IAttributes* attr = createEmptyAttributes();
+	readAttributes(state, attr);
+	if (node && !state.Failed)
+		node->deserializeAttributes(attr);
+	attr->drop();
+
+	// read materials
+	const u32 materialCount = readU32(state);
+	for (u32 nr=0; nr<materialCount && !state.Failed; ++nr)
+	{
+		attr = createEmptyAttributes();
+		readAttributes(state, attr);
+
+		if (node && node->getMaterialCount() > nr && !state.Failed)
+		{
+			SceneManager->getVideoDriver()->fillMaterialStructureFromAttributes(
+				node->getMaterial(nr), attr);
+		}
+
+		attr->drop();
+	}
+
+	// read animators
+	const u32 animatorCount = readU32(state);
+	for (u32 i=0; i<animatorCount && !state.Failed; ++i)
+	{
+		attr = createEmptyAttributes();
+		readAttributes(state, attr);
+
+		if (node && !state.Failed)
+		{
+			core::stringc typeName = attr->getAttributeAsString("Type");
+			ISceneNodeAnimator* anim = SceneManager->createSceneNodeAnimator(typeName.c_str(), node);
+
+			if (anim)
+			{
+				anim->deserializeAttributes(attr);
+				anim->drop();
+			}
+		}
+
+		attr->drop();
+	}
+
+	// read user data
+	if (readU32(state) && !state.Failed)
+	{
+		attr = createEmptyAttributes();
+		readAttributes(state, attr);
+
+		if (node && userDataSerializer && !state.Failed)
+			userDataSerializer->OnReadUserData(node, attr);
+
+		attr->drop();
+	}
+
+	// read children
+	const u32 childCount = readU32(state);
+	for (u32 i=0; i<childCount && !state.Failed; ++i)
+		readSceneNode(state, node, userDataSerializer, depth+1);
+
+	if (node && userDataSerializer && !state.Failed)
+		userDataSerializer->OnCreateNode(node);
+}
+
+
+//! reads an attribute list
+void CSceneLoaderIrrBin::readAttributes(SReadState& state, io::IAttributes* attr)
+{
+	const u32 count = readU32(state);
+	for (u32 i=0; i<count && !state.Failed; ++i)
+	{
+		const u32 type = readU32(state);
+		const c8* name = readString(state);
+		if (!name)
+			return;
+
+		switch (type)
+		{
+		case EIBA_INT:
+			attr->addInt(name, readS32(state));
+			break;
+		case EIBA_FLOAT:
+			attr->addFloat(name, readF32(state));
+			break;
+		case EIBA_STRING:
+			{
+				const wchar_t* value = readStringW(state);
+				if (value)
+					attr->addString(name, value);
+			}
+			break;
+		case EIBA_BOOL:
+			attr->addBool(name, readU32(state) != 0);
+			break;
+		case EIBA_ENUM:
+			{
+				const c8* value = readString(state);
+				if (value)
+					attr->addEnum(name, value, 0);
+			}
+			break;
+		case EIBA_COLOR:
+			attr->addColor(name, video::SColor(readU32(state)));
+			break;
+		case EIBA_COLORF:
+			{
+				video::SColorf c;
+				c.r = readF32(state);
+				c.g = readF32(state);
+				c.b = readF32(state);
+				c.a = readF32(state);
+				attr->addColorf(name, c);
+			}
+			break;
+		case EIBA_VECTOR3D:
+			{
+				core::vector3df v;
+				v.X = readF32(state);
+				v.Y = readF32(state);
+				v.Z = readF32(state);
+				attr->addVector3d(name, v);
+			}
+			break;
+		case EIBA_POSITION2D:
+			{
+				core::position2di v;
+				v.X = readS32(state);
+				v.Y = readS32(state);
+				attr->addPosition2d(name, v);
+			}
+			break;
+		case EIBA_VECTOR2D:
+			{
+				core::vector2df v;
+				v.X = readF32(state);
+				v.Y = readF32(state);
+				attr->addVector2d(name, v);
+			}
+			break;
+		case EIBA_RECT:
+			{
+				core::rect<s32> r;
+				r.UpperLeftCorner.X = readS32(state);
+				r.UpperLeftCorner.Y = readS32(state);
+				r.LowerRightCorner.X = readS32(state);
+				r.LowerRightCorner.Y = readS32(state);
+				attr->addRect(name, r);
+			}
+			break;
+		case EIBA_MATRIX:
+			{
+				core::matrix4 m(core::matrix4::EM4CONST_NOTHING);
+				for (u32 n=0; n<16; ++n)
+					m[n] = readF32(state);
+				attr->addMatrix(name, m);
+			}
+			break;
+		case EIBA_QUATERNION:
+			{
+				core::quaternion q;
+				q.X = readF32(state);
+				q.Y = readF32(state);
+				q.Z = readF32(state);
+				q.W = readF32(state);
+				attr->addQuaternion(name, q);
+			}
+			break;
+		case EIBA_BBOX:
+			{
+				core::aabbox3df b;
+				b.MinEdge.X = readF32(state);
+				b.MinEdge.Y = readF32(state);
+				b.MinEdge.Z = readF32(state);
+				b.MaxEdge.X = readF32(state);
+				b.MaxEdge.Y = readF32(state);
+				b.MaxEdge.Z = readF32(state);
+				attr->addBox3d(name, b);
+			}
+			break;
+		case EIBA_PLANE:
+			{
+				core::plane3df p;
+				p.Normal.X = readF32(state);
+				p.Normal.Y = readF32(state);
+				p.Normal.Z = readF32(state);
+				p.D = readF32(state);
+				attr->addPlane3d(name, p);
+			}
+			break;
+		case EIBA_TRIANGLE3D:
+			{
+				core::triangle3df t;
+				t.pointA.X = readF32(state);
+				t.pointA.Y = readF32(state);
+				t.pointA.Z = readF32(state);
+				t.pointB.X = readF32(state);
+				t.pointB.Y = readF32(state);
+				t.pointB.Z = readF32(state);
+				t.pointC.X = readF32(state);
+				t.pointC.Y = readF32(state);
+				t.pointC.Z = readF32(state);
+				attr->addTriangle3d(name, t);
+			}
+			break;
+		case EIBA_LINE2D:
+			{
+				core::line2df l;
+				l.start.X = readF32(state);
+				l.start.Y = readF32(state);
+				l.end.X = readF32(state);
+				l.end.Y = readF32(state);
+				attr->addLine2d(name, l);
+			}
+			break;
+		case EIBA_LINE3D:
+			{
+				core::line3df l;
+				l.start.X = readF32(state);
+				l.start.Y = readF32(state);
+				l.start.Z = readF32(state);
+				l.end.X = readF32(state);
+				l.end.Y = readF32(state);
+				l.end.Z = readF32(state);
+				attr->addLine3d(name, l);
+			}
+			break;
+		case EIBA_STRINGWARRAY:
+			{
+				const u32 size = readU32(state);
+				core::array<core::stringw> a;
+				for (u32 n=0; n<size && !state.Failed; ++n)
+				{
+					const wchar_t* value = readStringW(state);
+					if (value)
+						a.push_back(value);
+				}
+				attr->addArray(name, a);
+			}
+			break;
+		case EIBA_BINARY:
+			{
+				const c8* value = readString(state);
+				if (value)
+				{
+					attr->addBinary(name, 0, 0);
+					attr->setAttribute(attr->getAttributeCount()-1, value);
+				}
+			}
+			break;
+		case EIBA_TEXTURE:
+			{
+				const u32 index = readU32(state);
+				if (index == IRRBIN_NO_INDEX)
+				{
+					attr->addTexture(name, 0);
+					break;
+				}
+
+				const c8* path = getResource(state, EIBR_TEXTURE, index);
+				if (!path)
+					break;
+
+				// each texture is only searched once
+				if (!state.TexturesLoaded[index])
+				{
+					video::IVideoDriver* driver = SceneManager->getVideoDriver();
+					state.Textures[index] = driver ? driver->getTexture(path) : 0;
+					state.TexturesLoaded[index] = true;
+				}
+				attr->addTexture(name, state.Textures[index], path);
+			}
+			break;
+		case EIBA_DIMENSION2D:
+			{
+				core::dimension2du d;
+				d.Width = readU32(state);
+				d.Height = readU32(state);
+				attr->addDimension2d(name, d);
+			}
+			break;
+		case EIBA_MESH:
+			{
+				const c8* path = getResource(state, EIBR_MESH, readU32(state));
+				if (path)
+					attr->addString(name, toWide(state, path));
+			}
+			break;
+		default:
+			// the size of unknown values is not known, so nothing after it can be read
+			state.Failed = true;
+			break;
+		}
+	}
+}
+
+
+u32 CSceneLoaderIrrBin::readU32(SReadState& state) const
+{
+	if (state.Failed || state.End - state.Pos < 4)
+	{
+		state.Failed = true;
+		return 0;
+	}
+
+	u32 value;
+	memcpy(&value, state.Pos, 4);
+	state.Pos += 4;
+#ifdef __BIG_ENDIAN__
+	value = os::Byteswap::byteswap(value);
+#endif
+	return value;
+}
+
+
+f32 CSceneLoaderIrrBin::readF32(SReadState& state) const
+{
+	const u32 value = readU32(state);
+	f32 result;
+	memcpy(&result, &value, 4);
+	return result;
+}
+
+
+//! reads a string index and returns the string, or 0 on errors
+const c8* CSceneLoaderIrrBin::readString(SReadState& state) const
+{
+	const u32 index = readU32(state);
+	if (index >= state.Strings.size())
+	{
+		state.Failed = true;
+		return 0;
+	}
+	return state.Strings[index];
+}
+
+
+//! reads a string index and returns the string converted to wchar
+const wchar_t* CSceneLoaderIrrBin::readStringW(SReadState& state) const
+{
+	const c8* str = readString(state);
+	return str ? toWide(state, str) : 0;
+}
+
+
+//! converts a string of the file to wchar
+const wchar_t* CSceneLoaderIrrBin::toWide(SReadState& state, const c8* str) const
+{
+	// utf-8 never has less bytes than characters
+	const u32 size = (u32)strlen(str) + 1;
+	if (state.WideBuffer.size() < size)
+		state.WideBuffer.set_used(size);
+
+	core::utf8ToWchar(str, state.WideBuffer.pointer(), size * sizeof(wchar_t));
+	return state.WideBuffer.const_pointer();
+}
+
+
+//! returns the path of a resource, or 0 on errors
+const c8* CSceneLoaderIrrBin::getResource(SReadState& state, E_IRRBIN_RESOURCE_TYPE type, u32 index) const
+{
+	if (state.Failed || index >= state.Resources.size() / 2 || state.Resources[index*2] != (u32)type)
+	{
+		state.Failed = true;
+		return 0;
+	}
+	return state.Strings[state.Resources[index*2+1]];
+}
+
+
+//! Returns an empty attribute list
+io::IAttributes* CSceneLoaderIrrBin::createEmptyAttributes()
+{
+	// Reuse the list of the previous element when nobody else kept it,
+	// so its attribute objects are recycled instead of allocated again.
+	if (Attributes && Attributes->getReferenceCount() == 1)
+	{
+		Attributes->clear();
+		Attributes->grab();
+		return Attributes;
+	}
+
+	io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+	if (!Attributes)
+	{
+		Attributes = attr;
+		Attributes->grab();
+	}
+	return attr;
+}
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BIN_SCENE_LOADER_
+
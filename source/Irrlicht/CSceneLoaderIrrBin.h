@@ -0,0 +1,109 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_LOADER_IRR_BIN_H_INCLUDED__
+#define __C_SCENE_LOADER_IRR_BIN_H_INCLUDED__
+
+#include "ISceneLoader.h"
+#include "SIrrBinScene.h"
+#include "irrArray.h"
+
+namespace irr
+{
+
+namespace io
+{
+	class IFileSystem;
+	class IAttributes;
+}
+
+namespace video
+{
+	class ITexture;
+}
+
+namespace scene
+{
+
+class ISceneManager;
+
+//! Class which can load binary .irrbin scenes into the scene manager.
+/** The whole file is read at once (or used directly when it is a memory
+file) and nodes are created from it without any parsing of text. */
+class CSceneLoaderIrrBin : public virtual ISceneLoader
+{
+public:
+
+	//! Constructor
+	CSceneLoaderIrrBin(ISceneManager *smgr, io::IFileSystem* fs);
+
+	//! Destructor
+	virtual ~CSceneLoaderIrrBin();
+
+	//! Returns true if the class might be able to load this file.
+	virtual bool isALoadableFileExtension(const io::path& filename) const _IRR_OVERRIDE_;
+
+	//! Returns true if the class might be able to load this file.
+	virtual bool isALoadableFileFormat(io::IReadFile *file) const _IRR_OVERRIDE_;
+
+	//! Loads the scene into the scene manager.
+	virtual bool loadScene(io::IReadFile* file,
+		ISceneUserDataSerializer* userDataSerializer=0,
+		ISceneNode* rootNode=0) _IRR_OVERRIDE_;
+
+private:
+
+	//! Data of the file which is currently loaded
+	struct SReadState
+	{
+		SReadState() : Pos(0), End(0), Failed(false) {}
+
+		const u8* Pos;
+		const u8* End;
+		bool Failed;
+
+		core::array<const c8*> Strings;
+		core::array<u32> Resources;
+		core::array<video::ITexture*> Textures;
+		core::array<bool> TexturesLoaded;
+		core::array<wchar_t> WideBuffer;
+	};
+
+	//! Recursively reads a node record, depth is the number of its parent records
+	void readSceneNode(SReadState& state, ISceneNode* parent,
+		ISceneUserDataSerializer* userDataSerializer, u32 depth);
+
+	//! reads an attribute list into attr
+	void readAttributes(SReadState& state, io::IAttributes* attr);
+
+	u32 readU32(SReadState& state) const;
+	s32 readS32(SReadState& state) const { return (s32)readU32(state); }
+	f32 readF32(SReadState& state) const;
+
+	//! reads a string index and returns the string, or 0 on errors
+	const c8* readString(SReadState& state) const;
+
+	//! reads a string index and returns the string converted to wchar
+	const wchar_t* readStringW(SReadState& state) const;
+
+	//! converts a string of the file to wchar
+	const wchar_t* toWide(SReadState& state, const c8* str) const;
+
+	//! returns the path of a resource, or 0 on errors
+	const c8* getResource(SReadState& state, E_IRRBIN_RESOURCE_TYPE type, u32 index) const;
+
+	//! returns an empty attribute list, drop it when done
+	io::IAttributes* createEmptyAttributes();
+
+	ISceneManager   *SceneManager;
+	io::IFileSystem *FileSystem;
+	io::IAttributes *Attributes;
+};
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -17,6 +17,7 @@
 #include "ISceneLoader.h"
 #include "EProfileIDs.h"
 #include "IProfiler.h"
+#include "IJobSystem.h"
 
 #include "os.h"
 
@@ -30,6 +31,10 @@
 #include "CIrrMeshFileLoader.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_MESH_LOADER_
+#include "CIrrBinMeshFileLoader.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_BSP_LOADER_
 #include "CBSPMeshFileLoader.h"
 #endif
@@ -114,6 +119,14 @@
 #include "CSceneLoaderIrr.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_SCENE_LOADER_
+#include "CSceneLoaderIrrBin.h"
+#endif
+
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_SCENE_WRITER_
+#include "CSceneWriterIrrBin.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_COLLADA_WRITER_
 #include "CColladaMeshWriter.h"
 #endif
@@ -138,6 +151,10 @@
 #include "CB3DMeshWriter.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_MESH_WRITER_
+#include "CIrrBinMeshWriter.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_CUBE_SCENENODE_
 #include "CCubeSceneNode.h"
 #endif // _IRR_COMPILE_WITH_CUBE_SCENENODE_
@@ -179,6 +196,7 @@
 #include "CEmptySceneNode.h"
 #include "CTextSceneNode.h"
 #include "CQuake3ShaderSceneNode.h"
+#include "CQ3LevelSceneNode.h"
 #include "CVolumeLightSceneNode.h"
 
 #include "CDefaultSceneNodeFactory.h"
@@ -215,12 +233,13 @@ namespace scene
 //! constructor
 CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 		gui::ICursorControl* cursorControl, IMeshCache* cache,
-		gui::IGUIEnvironment* gui)
+		gui::IGUIEnvironment* gui, IJobSystem* jobs)
 : ISceneNode(0, 0), Driver(driver), FileSystem(fs), GUIEnvironment(gui),
 	CursorControl(cursorControl), CollisionManager(0),
 	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0), Parameters(0),
 	MeshCache(cache), CurrentRenderPass(ESNRP_NONE), LightManager(0),
-	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
+	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type"),
+	AnimationJobs(0), ParallelAnimationTime(0), MeshLoadJobs(jobs)
 {
 	#ifdef _DEBUG
 	ISceneManager::setDebugName("CSceneManager ISceneManager");
@@ -242,6 +261,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	if (GUIEnvironment)
 		GUIEnvironment->grab();
 
+	if (MeshLoadJobs)
+		MeshLoadJobs->grab();
+
 	// create mesh cache if not there already
 	if (!MeshCache)
 		MeshCache = new CMeshCache();
@@ -307,6 +329,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	#ifdef _IRR_COMPILE_WITH_IRR_MESH_LOADER_
 	MeshLoaderList.push_back(new CIrrMeshFileLoader(this, FileSystem));
 	#endif
+	#ifdef _IRR_COMPILE_WITH_IRR_BIN_MESH_LOADER_
+	MeshLoaderList.push_back(new CIrrBinMeshFileLoader(this));
+	#endif
 	#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
 	MeshLoaderList.push_back(new CBSPMeshFileLoader(this, FileSystem));
 	#endif
@@ -333,6 +358,10 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	#ifdef _IRR_COMPILE_WITH_IRR_SCENE_LOADER_
 	SceneLoaderList.push_back(new CSceneLoaderIrr(this, FileSystem));
 	#endif
+	// after the .irr loader, as that one accepts all files
+	#ifdef _IRR_COMPILE_WITH_IRR_BIN_SCENE_LOADER_
+	SceneLoaderList.push_back(new CSceneLoaderIrrBin(this, FileSystem));
+	#endif
 
 	// factories
 	ISceneNodeFactory* factory = new CDefaultSceneNodeFactory(this);
@@ -359,6 +388,33 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 			getProfiler().add(EPID_SM_RENDER_EFFECT, L"effectnodes", L"Irrlicht scene");
 			getProfiler().add(EPID_SM_RENDER_GUI_NODES, L"guinodes", L"Irrlicht scene");
 			getProfiler().add(EPID_SM_REGISTER, L"reg.render.node", L"Irrlicht scene");
+
+			getProfiler().add(EPID_ML_3DS, L"3ds", L"Mesh loaders");
+			getProfiler().add(EPID_ML_B3D, L"b3d", L"Mesh loaders");
+			getProfiler().add(EPID_ML_BSP, L"bsp", L"Mesh loaders");
+			getProfiler().add(EPID_ML_COLLADA, L"collada", L"Mesh loaders");
+			getProfiler().add(EPID_ML_CSM, L"csm", L"Mesh loaders");
+			getProfiler().add(EPID_ML_DMF, L"dmf", L"Mesh loaders");
+			getProfiler().add(EPID_ML_HALFLIFE, L"halflife mdl", L"Mesh loaders");
+			getProfiler().add(EPID_ML_IRR_MESH, L"irrmesh", L"Mesh loaders");
+			getProfiler().add(EPID_ML_IRR_BIN_MESH, L"irrbinmesh", L"Mesh loaders");
+			getProfiler().add(EPID_ML_LMTS, L"lmts", L"Mesh loaders");
+			getProfiler().add(EPID_ML_LWO, L"lwo", L"Mesh loaders");
+			getProfiler().add(EPID_ML_MD2, L"md2", L"Mesh loaders");
+			getProfiler().add(EPID_ML_MD3, L"md3", L"Mesh loaders");
+			getProfiler().add(EPID_ML_MS3D, L"ms3d", L"Mesh loaders");
+			getProfiler().add(EPID_ML_MY3D, L"my3d", L"Mesh loaders");
+			getProfiler().add(EPID_ML_OBJ, L"obj", L"Mesh loaders");
+			getProfiler().add(EPID_ML_OCT, L"oct", L"Mesh loaders");
+			getProfiler().add(EPID_ML_OGRE, L"ogre", L"Mesh loaders");
+			getProfiler().add(EPID_ML_PLY, L"ply", L"Mesh loaders");
+			getProfiler().add(EPID_ML_SMF, L"smf", L"Mesh loaders");
+			getProfiler().add(EPID_ML_STL, L"stl", L"Mesh loaders");
+			getProfiler().add(EPID_ML_X, L"x", L"Mesh loaders");
+
+			getProfiler().add(EPID_AM_ANIMATE_MESH, L"animate skinned", L"Animation");
+			getProfiler().add(EPID_AM_SKIN_MESH, L"skin", L"Animation");
+			getProfiler().add(EPID_AM_PARTICLES, L"particles", L"Animation");
 		}
  	)
 }
@@ -367,6 +423,14 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 //! destructor
 CSceneManager::~CSceneManager()
 {
+	// the requests use the loaders and the mesh cache
+	waitForMeshLoadRequests();
+	for (u32 r=0; r<MeshLoadRequests.size(); ++r)
+		MeshLoadRequests[r]->drop();
+
+	if (MeshLoadJobs)
+		MeshLoadJobs->drop();
+
 	clearDeletionList();
 
 	//! force to remove hardwareTextures from the driver
@@ -416,6 +480,9 @@ CSceneManager::~CSceneManager()
 	if (LightManager)
 		LightManager->drop();
 
+	if (AnimationJobs)
+		AnimationJobs->drop();
+
 	// remove all nodes and animators before dropping the driver
 	// as render targets may be destroyed twice
 
@@ -435,6 +502,12 @@ IAnimatedMesh* CSceneManager::getMesh(const io::path& filename, const io::path&
 	if (msh)
 		return msh;
 
+	// a request may be loading it
+	waitForMeshLoadRequests();
+	msh = MeshCache->getMeshByName(cacheName);
+	if (msh)
+		return msh;
+
 	io::IReadFile* file = FileSystem->createAndOpenFile(filename);
 	if (!file)
 	{
@@ -461,6 +534,11 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 	if (msh)
 		return msh;
 
+	waitForMeshLoadRequests();
+	msh = MeshCache->getMeshByName(name);
+	if (msh)
+		return msh;
+
 	msh = getUncachedMesh(file, name, name);
 
 	return msh;
@@ -468,24 +546,33 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 
 // load and create a mesh which we know already isn't in the cache and put it in there
 IAnimatedMesh* CSceneManager::getUncachedMesh(io::IReadFile* file, const io::path& filename, const io::path& cachename)
+{
+	IAnimatedMesh* msh = createMesh(MeshLoaderList.const_pointer(), MeshLoaderList.size(), file, filename);
+	if (msh)
+	{
+		MeshCache->addMesh(cachename, msh);
+		msh->drop();
+	}
+
+	return msh;
+}
+
+
+//! tries the loaders which load the extension, the last one first, returns a mesh which has to be dropped
+IAnimatedMesh* CSceneManager::createMesh(IMeshLoader* const* loaders, u32 count, io::IReadFile* file, const io::path& filename)
 {
 	IAnimatedMesh* msh = 0;
 
 	// iterate the list in reverse order so user-added loaders can override the built-in ones
-	s32 count = MeshLoaderList.size();
-	for (s32 i=count-1; i>=0; --i)
+	for (s32 i=(s32)count-1; i>=0; --i)
 	{
-		if (MeshLoaderList[i]->isALoadableFileExtension(filename))
+		if (loaders[i]->isALoadableFileExtension(filename))
 		{
 			// reset file to avoid side effects of previous calls to createMesh
 			file->seek(0);
-			msh = MeshLoaderList[i]->createMesh(file);
+			msh = loaders[i]->createMesh(file);
 			if (msh)
-			{
-				MeshCache->addMesh(cachename, msh);
-				msh->drop();
 				break;
-			}
 		}
 	}
 
@@ -497,6 +584,154 @@ IAnimatedMesh* CSceneManager::getUncachedMesh(io::IReadFile* file, const io::pat
 	return msh;
 }
 
+
+//! Starts loading a mesh on the job threads of the device
+IMeshLoadRequest* CSceneManager::createMeshLoadRequest(const io::path& filename, const io::path& alternativeCacheName)
+{
+	const io::path cacheName = alternativeCacheName.empty() ? filename : alternativeCacheName;
+
+	// the requests which are done are only removed here
+	for (u32 i=0; i<MeshLoadRequests.size(); ++i)
+	{
+		CMeshLoadRequest* pending = MeshLoadRequests[i];
+		if (pending->isDone())
+		{
+			pending->drop();
+			MeshLoadRequests.erase(i);
+			--i;
+		}
+		else if (pending->CacheName == cacheName)
+		{
+			pending->grab();
+			return pending;
+		}
+	}
+
+	CMeshLoadRequest* request = new CMeshLoadRequest(MeshCache, cacheName);
+	request->Mesh = MeshCache->getMeshByName(cacheName);
+	if (!request->Mesh && !MeshLoadJobs)
+		request->Mesh = getMesh(filename, alternativeCacheName);
+	if (request->Mesh)
+	{
+		request->Mesh->grab();
+		return request;
+	}
+	if (!MeshLoadJobs)
+		return request;
+
+	io::IReadFile* file = FileSystem->createAndOpenFile(filename);
+	if (!file)
+	{
+		os::Printer::log("Could not load mesh, because file could not be opened: ", filename, ELL_ERROR);
+		return request;
+	}
+
+	// files in archives read through the file of the archive, which the main thread goes on using
+	if (file->getType() == io::ERFT_LIMIT_READ_FILE)
+	{
+		const long size = file->getSize();
+		c8* data = new c8[size];
+		const size_t bytesRead = file->read(data, size);
+		io::IReadFile* memoryFile = FileSystem->createMemoryReadFile(data, (s32)bytesRead, file->getFileName(), true);
+		file->drop();
+		file = memoryFile;
+	}
+
+	// only loaders which load the extension can be used
+	bool threadSafe = true;
+	for (u32 i=0; i<MeshLoaderList.size(); ++i)
+	{
+		if (MeshLoaderList[i]->isALoadableFileExtension(filename))
+		{
+			MeshLoaderList[i]->grab();
+			request->Loaders.push_back(MeshLoaderList[i]);
+			threadSafe &= MeshLoaderList[i]->isThreadSafe();
+		}
+	}
+
+	request->Filename = filename;
+	request->File = file;
+	request->Jobs = MeshLoadJobs;
+	MeshLoadJobs->grab();
+
+	request->grab();
+	MeshLoadRequests.push_back(request);
+	if (threadSafe)
+		request->Job = MeshLoadJobs->addJob(CMeshLoadRequest::load, request, &LastMeshLoad, 1);
+	else
+		request->Job = MeshLoadJobs->addMainThreadJob(CMeshLoadRequest::load, request, &LastMeshLoad, 1);
+	LastMeshLoad = request->Job;
+
+	return request;
+}
+
+
+//! waits until the mesh load requests are done, loaders don't run twice at the same time
+void CSceneManager::waitForMeshLoadRequests()
+{
+	if (MeshLoadJobs)
+		MeshLoadJobs->wait(LastMeshLoad);
+}
+
+
+CSceneManager::CMeshLoadRequest::CMeshLoadRequest(IMeshCache* cache, const io::path& cacheName)
+	: Cache(cache), CacheName(cacheName), File(0), Jobs(0), Mesh(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CMeshLoadRequest");
+	#endif
+}
+
+
+//! the scene manager only lets the last reference go when the job is done
+CSceneManager::CMeshLoadRequest::~CMeshLoadRequest()
+{
+	if (Mesh)
+		Mesh->drop();
+
+	if (File)
+		File->drop();
+
+	for (u32 i=0; i<Loaders.size(); ++i)
+		Loaders[i]->drop();
+
+	if (Jobs)
+		Jobs->drop();
+}
+
+
+bool CSceneManager::CMeshLoadRequest::isDone() const
+{
+	return !Jobs || Jobs->isDone(Job);
+}
+
+
+IAnimatedMesh* CSceneManager::CMeshLoadRequest::getMesh() const
+{
+	return isDone() ? Mesh : 0;
+}
+
+
+IAnimatedMesh* CSceneManager::CMeshLoadRequest::wait()
+{
+	if (Jobs)
+		Jobs->wait(Job);
+	return Mesh;
+}
+
+
+void CSceneManager::CMeshLoadRequest::load(void* data)
+{
+	CMeshLoadRequest* request = (CMeshLoadRequest*)data;
+	IAnimatedMesh* mesh = createMesh(request->Loaders.const_pointer(), request->Loaders.size(),
+		request->File, request->Filename);
+
+	// only the job knows the mesh until the cache has it
+	if (mesh)
+		request->Cache->addMesh(request->CacheName, mesh);
+	request->Mesh = mesh;
+}
+
 //! returns the video driver
 video::IVideoDriver* CSceneManager::getVideoDriver()
 {
@@ -587,6 +822,24 @@ IMeshSceneNode* CSceneManager::addQuake3SceneNode(const IMeshBuffer* meshBuffer,
 }
 
 
+//! Adds a scene node, which draws the visible geometry of a quake3 level
+ISceneNode* CSceneManager::addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+					ISceneNode* parent, s32 id)
+{
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+	if (!parent)
+		parent = this;
+
+	CQ3LevelSceneNode* node = new CQ3LevelSceneNode(mesh, parent, this, id);
+	node->drop();
+
+	return node;
+#else
+	return 0;
+#endif
+}
+
+
 //! adds Volume Lighting Scene Node.
 //! the returned pointer must not be dropped.
 IVolumeLightSceneNode* CSceneManager::addVolumeLightSceneNode(
@@ -731,7 +984,7 @@ IOctreeSceneNode* CSceneManager::addOctreeSceneNode(IMesh* mesh, ISceneNode* par
 	if (!parent)
 		parent = this;
 
-	COctreeSceneNode* node = new COctreeSceneNode(parent, this, id, minimalPolysPerNode);
+	COctreeSceneNode* node = new COctreeSceneNode(parent, this, id, minimalPolysPerNode, MeshLoadJobs);
 
 	if (node)
 	{
@@ -1473,7 +1726,11 @@ void CSceneManager::drawAll()
 
 	// do animations and other stuff.
 	IRR_PROFILE(getProfiler().start(EPID_SM_ANIMATE));
-	OnAnimate(os::Timer::getTime());
+	const u32 timeMs = os::Timer::getTime();
+	if (AnimationJobs)
+		animateInParallel(timeMs);
+	OnAnimate(timeMs);
+	endParallelAnimation();
 	IRR_PROFILE(getProfiler().stop(EPID_SM_ANIMATE));
 
 	/*!
@@ -1770,6 +2027,216 @@ void CSceneManager::setLightManager(ILightManager* lightManager)
 }
 
 
+//! Lets drawAll() animate the scene on the threads of a job system
+void CSceneManager::setAnimationJobSystem(IJobSystem* jobs)
+{
+	if (jobs)
+		jobs->grab();
+	if (AnimationJobs)
+		AnimationJobs->drop();
+
+	AnimationJobs = jobs;
+}
+
+
+//! runs the thread safe animators and updates the absolute positions on the job threads
+void CSceneManager::animateInParallel(u32 timeMs)
+{
+	ParallelAnimatedNodes.set_used(0);
+	for (u32 i=0; i<ParallelAnimationLevels.size(); ++i)
+		ParallelAnimationLevels[i].set_used(0);
+	CollisionAnimatedNodes.set_used(0);
+	CollisionAnimators.set_used(0);
+
+	// the scene manager is the root node on level 0
+	collectParallelAnimation(this, 0, true);
+
+	// endParallelAnimation resets them, also when they are removed until then
+	EarlyAnimatedNodes.set_used(0);
+	for (u32 i=0; i<ParallelAnimatedNodes.size(); ++i)
+		EarlyAnimatedNodes.push_back(ParallelAnimatedNodes[i]);
+	for (u32 i=0; i<ParallelAnimationLevels.size(); ++i)
+	{
+		for (u32 j=0; j<ParallelAnimationLevels[i].size(); ++j)
+			EarlyAnimatedNodes.push_back(ParallelAnimationLevels[i][j]);
+	}
+	for (u32 i=0; i<CollisionAnimatedNodes.size(); ++i)
+		EarlyAnimatedNodes.push_back(CollisionAnimatedNodes[i]);
+	for (u32 i=0; i<EarlyAnimatedNodes.size(); ++i)
+		EarlyAnimatedNodes[i]->grab();
+
+	// the animators only change their own node, so they all run at once
+	ParallelAnimationTime = timeMs;
+	AnimationJobs->parallelFor(runEarlyAnimators, this, ParallelAnimatedNodes.size());
+
+	// each level needs the absolute positions of the level above, a node
+	// on no level has no children on the next one
+	for (u32 i=0; i<ParallelAnimationLevels.size() && !ParallelAnimationLevels[i].empty(); ++i)
+		AnimationJobs->parallelFor(updateEarlyAbsolutePositions, &ParallelAnimationLevels[i], ParallelAnimationLevels[i].size());
+
+	if (!CollisionAnimatedNodes.empty())
+	{
+		// the nodes which won't move anymore before OnAnimate reaches them
+		SettledNodes.set_used(0);
+		for (u32 i=0; i<ParallelAnimationLevels.size(); ++i)
+		{
+			for (u32 j=0; j<ParallelAnimationLevels[i].size(); ++j)
+				SettledNodes.push_back(ParallelAnimationLevels[i][j]);
+		}
+		SettledNodes.sort();
+		animateCollisionResponses(timeMs);
+	}
+}
+
+
+//! resets the early animation of the nodes which OnAnimate didn't reach
+void CSceneManager::endParallelAnimation()
+{
+	for (u32 i=0; i<EarlyAnimatedNodes.size(); ++i)
+	{
+		EarlyAnimatedNodes[i]->endEarlyAnimation();
+		EarlyAnimatedNodes[i]->drop();
+	}
+	EarlyAnimatedNodes.set_used(0);
+}
+
+
+//! returns true if the nodes of the triangles of a selector won't move anymore in OnAnimate
+bool CSceneManager::isSettled(const ITriangleSelector* selector) const
+{
+	const u32 count = selector->getSelectorCount();
+	if (count == 1 && selector->getSelector(0) == selector)
+	{
+		ISceneNode* node = selector->getSceneNodeForTriangle(0);
+		return !node || SettledNodes.binary_search(node) != -1;
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		const ITriangleSelector* part = selector->getSelector(i);
+		if (!part || part == selector || !isSettled(part))
+			return false;
+	}
+	return true;
+}
+
+
+//! collides the nodes with only a collision response animator in one batch
+void CSceneManager::animateCollisionResponses(u32 timeMs)
+{
+	u32 count = 0;
+	for (u32 i=0; i<CollisionAnimatedNodes.size(); ++i)
+	{
+		// the world has to be in the state in which OnAnimate would
+		// collide the node, otherwise OnAnimate collides it
+		const ITriangleSelector* world = CollisionAnimators[i]->getWorld();
+		if (!world || !isSettled(world))
+			continue;
+
+		if (count == CollisionResponses.size())
+			CollisionResponses.push_back(SCollisionResponse());
+		if (CollisionAnimators[i]->beginBatchedCollision(CollisionAnimatedNodes[i], timeMs, CollisionResponses[count]))
+		{
+			CollisionAnimatedNodes[count] = CollisionAnimatedNodes[i];
+			CollisionAnimators[count] = CollisionAnimators[i];
+			++count;
+		}
+	}
+
+	getSceneCollisionManager()->getCollisionResultPositions(CollisionResponses.pointer(), count, AnimationJobs);
+
+	// the collision callbacks may remove nodes and animators
+	for (u32 i=0; i<count; ++i)
+	{
+		CollisionAnimatedNodes[i]->grab();
+		CollisionAnimators[i]->grab();
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		// an earlier callback may have removed or disabled the animator,
+		// it must not keep the result for a later animation then
+		ISceneNode* node = CollisionAnimatedNodes[i];
+		ISceneNodeAnimator* animator = CollisionAnimators[i];
+		const ISceneNodeAnimatorList& animators = node->getAnimators();
+		ISceneNodeAnimatorList::ConstIterator it = animators.begin();
+		while (it != animators.end() && *it != animator)
+			++it;
+		if (it == animators.end() || !animator->isEnabled())
+			continue;
+
+		CollisionAnimators[i]->endBatchedCollision(CollisionResponses[i]);
+		node->animateEarly(timeMs);
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		CollisionAnimators[i]->drop();
+		CollisionAnimatedNodes[i]->drop();
+	}
+}
+
+
+//! adds the node and its children to the lists for animateInParallel
+void CSceneManager::collectParallelAnimation(ISceneNode* node, u32 level, bool updateAbsolutePosition)
+{
+	// OnAnimate skips the invisible nodes with their children
+	if (!node->isVisible())
+		return;
+
+	u32 animated = 0;
+	bool threadSafe = true;
+	ISceneNodeAnimator* animator = 0;
+	const ISceneNodeAnimatorList& animators = node->getAnimators();
+	for (ISceneNodeAnimatorList::ConstIterator it = animators.begin(); it != animators.end(); ++it)
+	{
+		if ((*it)->isEnabled())
+		{
+			++animated;
+			threadSafe &= (*it)->isThreadSafe();
+			animator = *it;
+		}
+	}
+	if (animated && threadSafe)
+		ParallelAnimatedNodes.push_back(node);
+	else if (animated == 1 && animator->getType() == ESNAT_COLLISION_RESPONSE)
+	{
+		CollisionAnimatedNodes.push_back(node);
+		CollisionAnimators.push_back((ISceneNodeAnimatorCollisionResponse*)animator);
+	}
+
+	// other animators move the node only later in OnAnimate, and animated
+	// meshes need their frame from OnAnimate for the MD3 tags
+	updateAbsolutePosition &= threadSafe && node->getType() != ESNT_ANIMATED_MESH;
+	if (updateAbsolutePosition)
+	{
+		if (level >= ParallelAnimationLevels.size())
+			ParallelAnimationLevels.push_back(core::array<ISceneNode*>());
+		ParallelAnimationLevels[level].push_back(node);
+	}
+
+	const ISceneNodeList& children = node->getChildren();
+	for (ISceneNodeList::ConstIterator it = children.begin(); it != children.end(); ++it)
+		collectParallelAnimation(*it, level+1, updateAbsolutePosition);
+}
+
+
+void CSceneManager::runEarlyAnimators(void* data, u32 begin, u32 end)
+{
+	CSceneManager* smgr = (CSceneManager*)data;
+	for (u32 i=begin; i<end; ++i)
+		smgr->ParallelAnimatedNodes[i]->animateEarly(smgr->ParallelAnimationTime);
+}
+
+
+void CSceneManager::updateEarlyAbsolutePositions(void* data, u32 begin, u32 end)
+{
+	const core::array<ISceneNode*>& nodes = *(core::array<ISceneNode*>*)data;
+	for (u32 i=begin; i<end; ++i)
+		nodes[i]->updateAbsolutePositionEarly();
+}
+
+
 //! Sets the color of stencil buffers shadows drawn by the scene manager.
 void CSceneManager::setShadowColor(video::SColor color)
 {
@@ -1994,7 +2461,8 @@ ITriangleSelector* CSceneManager::createOctreeTriangleSelector(IMesh* mesh,
 	if (!mesh)
 		return 0;
 
-	return new COctreeTriangleSelector(mesh, node, minimalPolysPerNode);
+	return new COctreeTriangleSelector(mesh, node, minimalPolysPerNode, MeshLoadJobs,
+		FileSystem, Parameters->getAttributeAsString(OCTREE_CACHE_DIRECTORY));
 }
 
 ITriangleSelector* CSceneManager::createOctreeTriangleSelector(IMeshBuffer* meshBuffer, irr::u32 materialIndex,
@@ -2003,7 +2471,8 @@ ITriangleSelector* CSceneManager::createOctreeTriangleSelector(IMeshBuffer* mesh
 	if ( !meshBuffer)
 		return 0;
 
-	return new COctreeTriangleSelector(meshBuffer, materialIndex, node, minimalPolysPerNode);
+	return new COctreeTriangleSelector(meshBuffer, materialIndex, node, minimalPolysPerNode, MeshLoadJobs,
+		FileSystem, Parameters->getAttributeAsString(OCTREE_CACHE_DIRECTORY));
 }
 
 //! Creates a meta triangle selector.
@@ -2199,7 +2668,7 @@ IMeshCache* CSceneManager::getMeshCache()
 //! Creates a new scene manager.
 ISceneManager* CSceneManager::createNewSceneManager(bool cloneContent)
 {
-	CSceneManager* manager = new CSceneManager(Driver, FileSystem, CursorControl, MeshCache, GUIEnvironment);
+	CSceneManager* manager = new CSceneManager(Driver, FileSystem, CursorControl, MeshCache, GUIEnvironment, MeshLoadJobs);
 
 	if (cloneContent)
 		manager->cloneMembers(this, manager);
@@ -2303,6 +2772,14 @@ bool CSceneManager::saveScene(io::IWriteFile* file, ISceneUserDataSerializer* us
 		return false;
 	}
 
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_SCENE_WRITER_
+	if (core::hasFileExtension(file->getFileName(), "irrbin"))
+	{
+		CSceneWriterIrrBin binWriter(this, FileSystem);
+		return binWriter.writeScene(file, userDataSerializer, node);
+	}
+#endif
+
 	bool result=false;
 	io::IXMLWriter* writer = FileSystem->createXMLWriter(file);
 	if (!writer)
@@ -2331,7 +2808,11 @@ bool CSceneManager::saveScene(io::IXMLWriter* writer, const io::path& currentPat
 	setlocale(LC_NUMERIC, "C");	// float number should to be saved with dots in this format independent of current locale settings.
 
 	writer->writeXMLHeader();
-	writeSceneNode(writer, node, userDataSerializer, currentPath.c_str(), true);
+
+	// one attribute list for all nodes, so its attributes get recycled
+	io::IAttributes* attr = FileSystem->createEmptyAttributes(Driver);
+	writeSceneNode(writer, node, userDataSerializer, attr, currentPath.c_str(), true);
+	attr->drop();
 
 	setlocale(LC_NUMERIC, oldLocale);
 
@@ -2382,7 +2863,7 @@ bool CSceneManager::loadScene(io::IReadFile* file, ISceneUserDataSerializer* use
 
 //! writes a scene node
 void CSceneManager::writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer,
-		const fschar_t* currentPath, bool init)
+		io::IAttributes* attr, const fschar_t* currentPath, bool init)
 {
 	if (!writer || !node || node->isDebugObject())
 		return;
@@ -2407,7 +2888,7 @@ void CSceneManager::writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISc
 
 	// write properties
 
-	io::IAttributes* attr = FileSystem->createEmptyAttributes(Driver);
+	attr->clear();
 	io::SAttributeReadWriteOptions options;
 	if (currentPath)
 	{
@@ -2496,17 +2977,15 @@ void CSceneManager::writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISc
 	// if parent is not scene manager, we need to write out node first
 	if (init && (node != this))
 	{
-		writeSceneNode(writer, node, userDataSerializer, currentPath);
+		writeSceneNode(writer, node, userDataSerializer, attr, currentPath);
 	}
 	else
 	{
 		ISceneNodeList::ConstIterator it = node->getChildren().begin();
 		for (; it != node->getChildren().end(); ++it)
-			writeSceneNode(writer, (*it), userDataSerializer, currentPath);
+			writeSceneNode(writer, (*it), userDataSerializer, attr, currentPath);
 	}
 
-	attr->drop();
-
 	writer->writeClosingTag(name);
 	writer->writeLineBreak();
 	writer->writeLineBreak();
@@ -2609,6 +3088,7 @@ void CSceneManager::deserializeAttributes(io::IAttributes* in, io::SAttributeRea
 	RelativeTranslation.set(0,0,0);
 	RelativeRotation.set(0,0,0);
 	RelativeScale.set(1,1,1);
+	RelativeTransformationChanged = true;
 	IsVisible = true;
 	AutomaticCullingState = scene::EAC_BOX;
 	DebugDataVisible = scene::EDS_OFF;
@@ -2685,6 +3165,13 @@ IMeshWriter* CSceneManager::createMeshWriter(EMESH_WRITER_TYPE type)
 #else
 		return 0;
 #endif
+
+	case EMWT_IRR_BIN_MESH:
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_MESH_WRITER_
+		return new CIrrBinMeshWriter(FileSystem);
+#else
+		return 0;
+#endif
 	}
 
 	return 0;
@@ -2694,9 +3181,9 @@ IMeshWriter* CSceneManager::createMeshWriter(EMESH_WRITER_TYPE type)
 // creates a scenemanager
 ISceneManager* createSceneManager(video::IVideoDriver* driver,
 		io::IFileSystem* fs, gui::ICursorControl* cursorcontrol,
-		gui::IGUIEnvironment *guiEnvironment)
+		gui::IGUIEnvironment *guiEnvironment, IJobSystem* jobs)
 {
-	return new CSceneManager(driver, fs, cursorcontrol, 0, guiEnvironment );
+	return new CSceneManager(driver, fs, cursorcontrol, 0, guiEnvironment, jobs);
 }
 
 
@@ -11,8 +11,10 @@
 #include "irrString.h"
 #include "irrArray.h"
 #include "IMeshLoader.h"
+#include "IMeshLoadRequest.h"
 #include "CAttributes.h"
 #include "ILightManager.h"
+#include "ISceneCollisionManager.h"
 
 namespace irr
 {
@@ -35,7 +37,7 @@ namespace scene
 		//! constructor
 		CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 			gui::ICursorControl* cursorControl, IMeshCache* cache = 0,
-			gui::IGUIEnvironment *guiEnvironment = 0);
+			gui::IGUIEnvironment *guiEnvironment = 0, IJobSystem* jobs = 0);
 
 		//! destructor
 		virtual ~CSceneManager();
@@ -46,6 +48,10 @@ namespace scene
 		//! gets an animateable mesh. loads it if needed. returned pointer must not be dropped.
 		virtual IAnimatedMesh* getMesh(io::IReadFile* file) _IRR_OVERRIDE_;
 
+		//! Starts loading a mesh on the job threads of the device
+		virtual IMeshLoadRequest* createMeshLoadRequest(const io::path& filename,
+			const io::path& alternativeCacheName) _IRR_OVERRIDE_;
+
 		//! Returns an interface to the mesh cache which is shared between all existing scene managers.
 		virtual IMeshCache* getMeshCache() _IRR_OVERRIDE_;
 
@@ -203,6 +209,9 @@ namespace scene
 		virtual IMeshSceneNode* addQuake3SceneNode(const IMeshBuffer* meshBuffer, const quake3::IShader * shader,
 			ISceneNode* parent=0, s32 id=-1) _IRR_OVERRIDE_;
 
+		//! Adds a scene node, which draws the visible geometry of a quake3 level
+		virtual ISceneNode* addQuake3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent=0, s32 id=-1) _IRR_OVERRIDE_;
+
 
 		//! Adds a Hill Plane mesh to the mesh pool. The mesh is
 		//! generated on the fly and looks like a plane with some hills
@@ -534,16 +543,77 @@ namespace scene
 		//! returns if node is culled
 		virtual bool isCulled(const ISceneNode* node) const _IRR_OVERRIDE_;
 
+		//! Lets drawAll() animate the scene on the threads of a job system
+		virtual void setAnimationJobSystem(IJobSystem* jobs) _IRR_OVERRIDE_;
+
+		//! Returns the job system which animates the scene, or 0
+		virtual IJobSystem* getAnimationJobSystem() const _IRR_OVERRIDE_ { return AnimationJobs; }
+
 	private:
 
+		//! Loads a mesh on a job thread or on the main thread and adds it to the mesh cache
+		class CMeshLoadRequest : public IMeshLoadRequest
+		{
+		public:
+
+			CMeshLoadRequest(IMeshCache* cache, const io::path& cacheName);
+			virtual ~CMeshLoadRequest();
+
+			virtual const io::path& getName() const _IRR_OVERRIDE_ { return CacheName; }
+			virtual bool isDone() const _IRR_OVERRIDE_;
+			virtual IAnimatedMesh* getMesh() const _IRR_OVERRIDE_;
+			virtual IAnimatedMesh* wait() _IRR_OVERRIDE_;
+			virtual SJobHandle getJob() const _IRR_OVERRIDE_ { return Job; }
+
+			//! the job, loads the mesh and adds it to the mesh cache
+			static void load(void* data);
+
+			IMeshCache* Cache;
+			io::path CacheName;
+			io::path Filename;
+			io::IReadFile* File;
+			//! loaders which load the extension, grabbed on the main thread
+			core::array<IMeshLoader*> Loaders;
+			IJobSystem* Jobs;
+			SJobHandle Job;
+			//! the loaded mesh, grabbed by the request
+			IAnimatedMesh* Mesh;
+		};
+
 		// load and create a mesh which we know already isn't in the cache and put it in there
 		IAnimatedMesh* getUncachedMesh(io::IReadFile* file, const io::path& filename, const io::path& cachename);
 
+		//! tries the loaders which load the extension, the last one first, returns a mesh which has to be dropped
+		static IAnimatedMesh* createMesh(IMeshLoader* const* loaders, u32 count, io::IReadFile* file, const io::path& filename);
+
+		//! waits until the mesh load requests are done, loaders don't run twice at the same time
+		void waitForMeshLoadRequests();
+
 		//! clears the deletion list
 		void clearDeletionList();
 
+		//! runs the thread safe animators and updates the absolute positions on the job threads
+		void animateInParallel(u32 timeMs);
+
+		//! adds the node and its children to the lists for animateInParallel
+		void collectParallelAnimation(ISceneNode* node, u32 level, bool updateAbsolutePosition);
+
+		//! collides the nodes with only a collision response animator in one batch
+		void animateCollisionResponses(u32 timeMs);
+
+		//! resets the early animation of the nodes which OnAnimate didn't reach
+		void endParallelAnimation();
+
+		//! returns true if the nodes of the triangles of a selector won't move anymore in OnAnimate
+		bool isSettled(const ITriangleSelector* selector) const;
+
+		static void runEarlyAnimators(void* data, u32 begin, u32 end);
+		static void updateEarlyAbsolutePositions(void* data, u32 begin, u32 end);
+
 		//! writes a scene node
-		void writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer, const fschar_t* currentPath=0, bool init=false);
+		/** \param attr Attribute list used for serializing the node, cleared before each use. */
+		void writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer,
+			io::IAttributes* attr, const fschar_t* currentPath=0, bool init=false);
 
 		struct DefaultNodeEntry
 		{
@@ -667,6 +737,28 @@ namespace scene
 		const core::stringw IRR_XML_FORMAT_NODE_ATTR_TYPE;
 
 		IGeometryCreator* GeometryCreator;
+
+		//! job system for the parallel animation, the nodes with only thread safe
+		//! animators and the nodes per level which can update their absolute position early
+		IJobSystem* AnimationJobs;
+		core::array<ISceneNode*> ParallelAnimatedNodes;
+		core::array<core::array<ISceneNode*> > ParallelAnimationLevels;
+		u32 ParallelAnimationTime;
+
+		//! nodes for animateCollisionResponses with their animators and ellipsoids
+		core::array<ISceneNode*> CollisionAnimatedNodes;
+		core::array<ISceneNodeAnimatorCollisionResponse*> CollisionAnimators;
+		core::array<SCollisionResponse> CollisionResponses;
+		//! sorted nodes whose absolute position was updated before the batch
+		core::array<ISceneNode*> SettledNodes;
+		//! grabbed nodes which may have work of the parallel animation left for OnAnimate
+		core::array<ISceneNode*> EarlyAnimatedNodes;
+
+		//! job system which loads the meshes, the requests which may not be done
+		//! and the request which was started last, which the next one waits for
+		IJobSystem* MeshLoadJobs;
+		core::array<CMeshLoadRequest*> MeshLoadRequests;
+		SJobHandle LastMeshLoad;
 	};
 
 } // end namespace video
@@ -23,9 +23,9 @@ CSceneNodeAnimatorCollisionResponse::CSceneNodeAnimatorCollisionResponse(
 		f32 slidingSpeed)
 : Radius(ellipsoidRadius), Gravity(gravityPerSecond), Translation(ellipsoidTranslation),
 	World(world), Object(object), SceneManager(scenemanager), LastTime(0),
-	SlidingSpeed(slidingSpeed), CollisionNode(0), CollisionCallback(0),
+	SlidingSpeed(slidingSpeed), CollisionNode(0), CollisionCallback(0), DiffSec(0.f),
 	Falling(false), IsCamera(false), AnimateCameraTarget(true), CollisionOccurred(false),
-	FirstUpdate(true)
+	FirstUpdate(true), CollisionFalling(false), BatchedCollision(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CSceneNodeAnimatorCollisionResponse");
@@ -139,6 +139,17 @@ ITriangleSelector* CSceneNodeAnimatorCollisionResponse::getWorld() const
 
 void CSceneNodeAnimatorCollisionResponse::animateNode(ISceneNode* node, u32 timeMs)
 {
+	// the scene manager did already collide the node
+	if (BatchedCollision)
+	{
+		BatchedCollision = false;
+		if (node == Object)
+		{
+			endCollision();
+			return;
+		}
+	}
+
 	CollisionOccurred = false;
 
 	if (node != Object)
@@ -147,6 +158,62 @@ void CSceneNodeAnimatorCollisionResponse::animateNode(ISceneNode* node, u32 time
 	if(!Object || !World)
 		return;
 
+	beginCollision(timeMs);
+
+	// core::vector3df force = vel + FallingVelocity;
+
+	if ( AnimateCameraTarget )
+	{
+		// TODO: divide SlidingSpeed by frame time
+
+		CollisionResultPosition
+			= SceneManager->getSceneCollisionManager()->getCollisionResultPosition(
+				World, LastPosition-Translation,
+				Radius, Velocity, CollisionTriangle, CollisionPoint, CollisionFalling,
+				CollisionNode, SlidingSpeed, FallingVelocity*DiffSec);
+	}
+
+	endCollision();
+}
+
+
+//! Starts the next animateNode() call for a batch of collisions
+bool CSceneNodeAnimatorCollisionResponse::beginBatchedCollision(ISceneNode* node, u32 timeMs, SCollisionResponse& response)
+{
+	if (node != Object || !Object || !World || !AnimateCameraTarget)
+		return false;
+
+	CollisionOccurred = false;
+	beginCollision(timeMs);
+
+	response.Selector = World;
+	response.Position = LastPosition-Translation;
+	response.Radius = Radius;
+	response.Direction = Velocity;
+	response.Gravity = FallingVelocity*DiffSec;
+	response.SlidingSpeed = SlidingSpeed;
+	response.Triangle = CollisionTriangle;
+	response.HitPosition = CollisionPoint;
+	response.Falling = CollisionFalling;
+	response.Node = CollisionNode;
+	return true;
+}
+
+
+//! Passes the result of the batch, the next animateNode() call uses it
+void CSceneNodeAnimatorCollisionResponse::endBatchedCollision(const SCollisionResponse& response)
+{
+	CollisionResultPosition = response.ResultPosition;
+	CollisionTriangle = response.Triangle;
+	CollisionPoint = response.HitPosition;
+	CollisionFalling = response.Falling;
+	CollisionNode = response.Node;
+	BatchedCollision = true;
+}
+
+
+void CSceneNodeAnimatorCollisionResponse::beginCollision(u32 timeMs)
+{
 	// trigger reset
 	if ( timeMs == 0 )
 	{
@@ -164,45 +231,39 @@ void CSceneNodeAnimatorCollisionResponse::animateNode(ISceneNode* node, u32 time
 		FirstUpdate = false;
 	}
 
-	const f32 diffSec = (f32)(timeMs - LastTime)*0.001f;
+	DiffSec = (f32)(timeMs - LastTime)*0.001f;
 	LastTime = timeMs;
 
 	CollisionResultPosition = Object->getPosition();
-	core::vector3df vel = CollisionResultPosition - LastPosition;
+	Velocity = CollisionResultPosition - LastPosition;
 
-	FallingVelocity += Gravity * diffSec;
+	FallingVelocity += Gravity * DiffSec;
 
 	CollisionTriangle = RefTriangle;
 	CollisionPoint = core::vector3df();
 	CollisionResultPosition = core::vector3df();
 	CollisionNode = 0;
+	CollisionFalling = false;
+}
 
-	// core::vector3df force = vel + FallingVelocity;
 
+void CSceneNodeAnimatorCollisionResponse::endCollision()
+{
 	if ( AnimateCameraTarget )
 	{
-		// TODO: divide SlidingSpeed by frame time
-
-		bool f = false;
-		CollisionResultPosition
-			= SceneManager->getSceneCollisionManager()->getCollisionResultPosition(
-				World, LastPosition-Translation,
-				Radius, vel, CollisionTriangle, CollisionPoint, f,
-				CollisionNode, SlidingSpeed, FallingVelocity*diffSec);
-
 		CollisionOccurred = (CollisionTriangle != RefTriangle);
 
 		CollisionResultPosition += Translation;
 
-		if ( diffSec > 0 )	// don't change the state when there was no time
+		if ( DiffSec > 0 )	// don't change the state when there was no time
 		{
-			if (f)//CollisionTriangle == RefTriangle)
+			if (CollisionFalling)//CollisionTriangle == RefTriangle)
 			{
 				Falling = true;
 			}
 			else
 			{
-				if ( CollisionOccurred )	// f can also happen to be false when FallingVelocity was already 0 (p.e. at top of a jump)
+				if ( CollisionOccurred )	// CollisionFalling can also happen to be false when FallingVelocity was already 0 (p.e. at top of a jump)
 					Falling = false;
 				FallingVelocity.set(0, 0, 0);
 			}
@@ -220,7 +281,7 @@ void CSceneNodeAnimatorCollisionResponse::animateNode(ISceneNode* node, u32 time
 	// move camera target
 	if (AnimateCameraTarget && IsCamera)
 	{
-		const core::vector3df pdiff = Object->getPosition() - LastPosition - vel;
+		const core::vector3df pdiff = Object->getPosition() - LastPosition - Velocity;
 		ICameraSceneNode* cam = (ICameraSceneNode*)Object;
 		cam->setTarget(cam->getTarget() + pdiff);
 	}
@@ -119,10 +119,22 @@ namespace scene
 		*/
 		virtual void setCollisionCallback(ICollisionCallback* callback) _IRR_OVERRIDE_;
 
+		//! Starts the next animateNode() call for a batch of collisions
+		virtual bool beginBatchedCollision(ISceneNode* node, u32 timeMs, SCollisionResponse& response) _IRR_OVERRIDE_;
+
+		//! Passes the result of the batch, the next animateNode() call uses it
+		virtual void endBatchedCollision(const SCollisionResponse& response) _IRR_OVERRIDE_;
+
 	private:
 
 		void setNode(ISceneNode* node);
 
+		//! updates the time and the velocities and resets the collision results
+		void beginCollision(u32 timeMs);
+
+		//! moves the node to the collision result
+		void endCollision();
+
 		core::vector3df Radius;
 		core::vector3df Gravity;
 		core::vector3df Translation;
@@ -143,11 +155,17 @@ namespace scene
 		ISceneNode * CollisionNode;
 		ICollisionCallback* CollisionCallback;
 
+		// movement of the current animation
+		core::vector3df Velocity;
+		f32 DiffSec;
+
 		bool Falling;
 		bool IsCamera;
 		bool AnimateCameraTarget;
 		bool CollisionOccurred;
 		bool FirstUpdate;
+		bool CollisionFalling;
+		bool BatchedCollision;
 	};
 
 } // end namespace scene
@@ -0,0 +1,533 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BIN_SCENE_WRITER_
+
+#include "CSceneWriterIrrBin.h"
+#include "ISceneManager.h"
+#include "ISceneNodeAnimator.h"
+#include "ISceneUserDataSerializer.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "IWriteFile.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	//! appends size bytes to the data and returns a pointer to them
+	u8* appendBytes(core::array<u8>& data, u32 size)
+	{
+		const u32 pos = data.size();
+		// set_used alone would reallocate for each value
+		if (data.allocated_size() < pos + size)
+			data.reallocate(core::max_(pos + size, data.allocated_size() * 2));
+		data.set_used(pos + size);
+		return data.pointer() + pos;
+	}
+}
+
+//! Constructor
+CSceneWriterIrrBin::CSceneWriterIrrBin(ISceneManager* smgr, io::IFileSystem* fs)
+	: SceneManager(smgr), FileSystem(fs), Attributes(0)
+{
+}
+
+
+//! Destructor
+CSceneWriterIrrBin::~CSceneWriterIrrBin()
+{
+	if (Attributes)
+		Attributes->drop();
+}
+
+
+//! Writes the scene, or the given node and its children, into the file
+bool CSceneWriterIrrBin::writeScene(io::IWriteFile* file, ISceneUserDataSerializer* userDataSerializer, ISceneNode* node)
+{
+	if (!file)
+		return false;
+
+	Nodes.set_used(0);
+	Strings.set_used(0);
+	StringIndices.clear();
+	Resources.set_used(0);
+	for (u32 i=0; i<EIBR_COUNT; ++i)
+		ResourceIndices[i].clear();
+
+	if (!Attributes)
+		Attributes = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
+
+	const io::path currentPath = FileSystem->getFileDir(FileSystem->getAbsolutePath(file->getFileName()));
+	io::SAttributeReadWriteOptions options;
+	options.Filename = currentPath.c_str();
+	options.Flags |= io::EARWF_USE_RELATIVE_PATHS;
+
+	if (!node)
+		node = SceneManager->getRootSceneNode();
+
+	if (!node->isDebugObject())
+		writeSceneNode(node, userDataSerializer, options, true);
+
+	// the string table
+	core::array<u8> stringTable;
+	for (u32 i=0; i<Strings.size(); ++i)
+	{
+		const u32 length = Strings[i].size();
+		u8* data = appendBytes(stringTable, 4 + length + 1);
+
+		u32 value = length;
+#ifdef __BIG_ENDIAN__
+		value = os::Byteswap::byteswap(value);
+#endif
+		memcpy(data, &value, 4);
+		memcpy(data + 4, Strings[i].c_str(), length + 1);
+	}
+
+	// the resource table
+	for (u32 i=0; i<Resources.size(); ++i)
+	{
+#ifdef __BIG_ENDIAN__
+		Resources[i] = os::Byteswap::byteswap(Resources[i]);
+#endif
+	}
+
+	SIrrBinSceneHeader header;
+	memcpy(header.Magic, IRRBIN_MAGIC, 4);
+	header.Version = IRRBIN_VERSION;
+	header.StringTableOffset = sizeof(SIrrBinSceneHeader);
+	header.StringCount = Strings.size();
+	header.ResourceTableOffset = header.StringTableOffset + stringTable.size();
+	header.ResourceCount = Resources.size() / 2;
+	header.NodesOffset = header.ResourceTableOffset + Resources.size() * 4;
+	header.NodesSize = Nodes.size();
+
+#ifdef __BIG_ENDIAN__
+	header.Version = os::Byteswap::byteswap(header.Version);
+	header.StringTableOffset = os::Byteswap::byteswap(header.StringTableOffset);
+	header.StringCount = os::Byteswap::byteswap(header.StringCount);
+	header.ResourceTableOffset = os::Byteswap::byteswap(header.ResourceTableOffset);
+	header.ResourceCount = os::Byteswap::byteswap(header.ResourceCount);
+	header.NodesOffset = os::Byteswap::byteswap(header.NodesOffset);
+	header.NodesSize = os::Byteswap::byteswap(header.NodesSize);
+#endif
+
+	bool result = file->write(&header, sizeof(header)) == sizeof(header);
+	if (result && stringTable.size())
+		result = file->write(stringTable.const_pointer(), stringTable.size()) == (size_t)stringTable.size();
+	if (result && Resources.size())
+		result = file->write(Resources.const_pointer(), Resources.size() * 4) == (size_t)Resources.size() * 4;
+	if (result && Nodes.size())
+		result = file->write(Nodes.const_pointer(), Nodes.size()) == (size_t)Nodes.size();
+
+	if (!result)
+		os::Printer::log("Could not write scene file", file->getFileName(), ELL_ERROR);
+
+	// free the memory of big scenes again
+	Nodes.clear();
+	Strings.clear();
+	StringIndices.clear();
+	Resources.clear();
+	for (u32 i=0; i<EIBR_COUNT; ++i)
+		ResourceIndices[i].clear();
+
+	return result;
+}
+
+
+//! writes a node record and the records of its children
+void CSceneWriterIrrBin::writeSceneNode(ISceneNode* node, ISceneUserDataSerializer* userDataSerializer,
+	io::SAttributeReadWriteOptions& options, bool init)
+{
+	// the scene itself is written with the attributes of the root node,
+	// the node to save is its only child then
+	ISceneNode* tmpNode = node;
+	if (init)
+	{
+		node = SceneManager->getRootSceneNode();
+		writeU32(IRRBIN_NO_INDEX);
+	}
+	else
+		writeU32(addString(core::stringc(SceneManager->getSceneNodeTypeName(node->getType()))));
+
+	// write properties
+
+	Attributes->clear();
+	node->serializeAttributes(Attributes, &options);
+	writeAttributes(Attributes);
+
+	// write materials
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (driver)
+	{
+		writeU32(node->getMaterialCount());
+		for (u32 i=0; i < node->getMaterialCount(); ++i)
+		{
+			io::IAttributes* tmp_attr =
+				driver->createAttributesFromMaterial(node->getMaterial(i), &options);
+			writeAttributes(tmp_attr);
+			tmp_attr->drop();
+		}
+	}
+	else
+		writeU32(0);
+
+	// write animators
+
+	writeU32(node->getAnimators().size());
+	ISceneNodeAnimatorList::ConstIterator ait = node->getAnimators().begin();
+	for (; ait != node->getAnimators().end(); ++ait)
+	{
+		Attributes->clear();
+		Attributes->addString("Type", SceneManager->getAnimatorTypeName((*ait)->getType()));
+
+		(*ait)->serializeAttributes(Attributes);
+
+		writeAttributes(Attributes);
+	}
+
+	// write possible user data
+
+	io::IAttributes* userData = userDataSerializer ? userDataSerializer->createUserData(node) : 0;
+	if (userData)
+	{
+		writeU32(1);
+		writeAttributes(userData);
+		userData->drop();
+	}
+	else
+		writeU32(0);
+
+	// write children once root node is written
+	// if parent is not scene manager, we need to write out node first
+	if (init && (tmpNode != node))
+	{
+		writeU32(1);
+		writeSceneNode(tmpNode, userDataSerializer, options);
+	}
+	else
+	{
+		u32 count = 0;
+		ISceneNodeList::ConstIterator it = node->getChildren().begin();
+		for (; it != node->getChildren().end(); ++it)
+			if (!(*it)->isDebugObject())
+				++count;
+
+		writeU32(count);
+		for (it = node->getChildren().begin(); it != node->getChildren().end(); ++it)
+			if (!(*it)->isDebugObject())
+				writeSceneNode((*it), userDataSerializer, options);
+	}
+}
+
+
+//! writes an attribute list
+void CSceneWriterIrrBin::writeAttributes(io::IAttributes* attr)
+{
+	// the count is patched once we know which attributes could be written
+	const u32 countPos = Nodes.size();
+	writeU32(0);
+	u32 count = 0;
+
+	for (u32 i=0; i<attr->getAttributeCount(); ++i)
+	{
+		const u32 name = addString(core::stringc(attr->getAttributeName(i)));
+
+		switch (attr->getAttributeType(i))
+		{
+		case io::EAT_INT:
+			writeU32(EIBA_INT);
+			writeU32(name);
+			writeS32(attr->getAttributeAsInt(i));
+			break;
+		case io::EAT_FLOAT:
+			writeU32(EIBA_FLOAT);
+			writeU32(name);
+			writeF32(attr->getAttributeAsFloat(i));
+			break;
+		case io::EAT_STRING:
+			{
+				const core::stringw value = attr->getAttributeAsStringW(i);
+				if (value.size() && core::stringc("Mesh") == attr->getAttributeName(i))
+				{
+					writeU32(EIBA_MESH);
+					writeU32(name);
+					writeU32(addResource(EIBR_MESH, core::stringc(attr->getAttributeAsString(i))));
+				}
+				else
+				{
+					writeU32(EIBA_STRING);
+					writeU32(name);
+					writeU32(addString(value));
+				}
+			}
+			break;
+		case io::EAT_BOOL:
+			writeU32(EIBA_BOOL);
+			writeU32(name);
+			writeU32(attr->getAttributeAsBool(i) ? 1 : 0);
+			break;
+		case io::EAT_ENUM:
+			writeU32(EIBA_ENUM);
+			writeU32(name);
+			writeU32(addString(core::stringc(attr->getAttributeAsEnumeration(i))));
+			break;
+		case io::EAT_COLOR:
+			writeU32(EIBA_COLOR);
+			writeU32(name);
+			writeU32(attr->getAttributeAsColor(i).color);
+			break;
+		case io::EAT_COLORF:
+			{
+				const video::SColorf c = attr->getAttributeAsColorf(i);
+				writeU32(EIBA_COLORF);
+				writeU32(name);
+				writeF32(c.r);
+				writeF32(c.g);
+				writeF32(c.b);
+				writeF32(c.a);
+			}
+			break;
+		case io::EAT_VECTOR3D:
+			{
+				const core::vector3df v = attr->getAttributeAsVector3d(i);
+				writeU32(EIBA_VECTOR3D);
+				writeU32(name);
+				writeF32(v.X);
+				writeF32(v.Y);
+				writeF32(v.Z);
+			}
+			break;
+		case io::EAT_POSITION2D:
+			{
+				const core::position2di v = attr->getAttributeAsPosition2d(i);
+				writeU32(EIBA_POSITION2D);
+				writeU32(name);
+				writeS32(v.X);
+				writeS32(v.Y);
+			}
+			break;
+		case io::EAT_VECTOR2D:
+			{
+				const core::vector2df v = attr->getAttributeAsVector2d(i);
+				writeU32(EIBA_VECTOR2D);
+				writeU32(name);
+				writeF32(v.X);
+				writeF32(v.Y);
+			}
+			break;
+		case io::EAT_RECT:
+			{
+				const core::rect<s32> r = attr->getAttributeAsRect(i);
+				writeU32(EIBA_RECT);
+				writeU32(name);
+				writeS32(r.UpperLeftCorner.X);
+				writeS32(r.UpperLeftCorner.Y);
+				writeS32(r.LowerRightCorner.X);
+				writeS32(r.LowerRightCorner.Y);
+			}
+			break;
+		case io::EAT_MATRIX:
+			{
+				const core::matrix4 m = attr->getAttributeAsMatrix(i);
+				writeU32(EIBA_MATRIX);
+				writeU32(name);
+				for (u32 n=0; n<16; ++n)
+					writeF32(m[n]);
+			}
+			break;
+		case io::EAT_QUATERNION:
+			{
+				const core::quaternion q = attr->getAttributeAsQuaternion(i);
+				writeU32(EIBA_QUATERNION);
+				writeU32(name);
+				writeF32(q.X);
+				writeF32(q.Y);
+				writeF32(q.Z);
+				writeF32(q.W);
+			}
+			break;
+		case io::EAT_BBOX:
+			{
+				const core::aabbox3df b = attr->getAttributeAsBox3d(i);
+				writeU32(EIBA_BBOX);
+				writeU32(name);
+				writeF32(b.MinEdge.X);
+				writeF32(b.MinEdge.Y);
+				writeF32(b.MinEdge.Z);
+				writeF32(b.MaxEdge.X);
+				writeF32(b.MaxEdge.Y);
+				writeF32(b.MaxEdge.Z);
+			}
+			break;
+		case io::EAT_PLANE:
+			{
+				const core::plane3df p = attr->getAttributeAsPlane3d(i);
+				writeU32(EIBA_PLANE);
+				writeU32(name);
+				writeF32(p.Normal.X);
+				writeF32(p.Normal.Y);
+				writeF32(p.Normal.Z);
+				writeF32(p.D);
+			}
+			break;
+		case io::EAT_TRIANGLE3D:
+			{
+				const core::triangle3df t = attr->getAttributeAsTriangle3d(i);
+				writeU32(EIBA_TRIANGLE3D);
+				writeU32(name);
+				writeF32(t.pointA.X);
+				writeF32(t.pointA.Y);
+				writeF32(t.pointA.Z);
+				writeF32(t.pointB.X);
+				writeF32(t.pointB.Y);
+				writeF32(t.pointB.Z);
+				writeF32(t.pointC.X);
+				writeF32(t.pointC.Y);
+				writeF32(t.pointC.Z);
+			}
+			break;
+		case io::EAT_LINE2D:
+			{
+				const core::line2df l = attr->getAttributeAsLine2d(i);
+				writeU32(EIBA_LINE2D);
+				writeU32(name);
+				writeF32(l.start.X);
+				writeF32(l.start.Y);
+				writeF32(l.end.X);
+				writeF32(l.end.Y);
+			}
+			break;
+		case io::EAT_LINE3D:
+			{
+				const core::line3df l = attr->getAttributeAsLine3d(i);
+				writeU32(EIBA_LINE3D);
+				writeU32(name);
+				writeF32(l.start.X);
+				writeF32(l.start.Y);
+				writeF32(l.start.Z);
+				writeF32(l.end.X);
+				writeF32(l.end.Y);
+				writeF32(l.end.Z);
+			}
+			break;
+		case io::EAT_STRINGWARRAY:
+			{
+				const core::array<core::stringw> a = attr->getAttributeAsArray(i);
+				writeU32(EIBA_STRINGWARRAY);
+				writeU32(name);
+				writeU32(a.size());
+				for (u32 n=0; n<a.size(); ++n)
+					writeU32(addString(a[n]));
+			}
+			break;
+		case io::EAT_BINARY:
+			writeU32(EIBA_BINARY);
+			writeU32(name);
+			writeU32(addString(attr->getAttributeAsString(i)));
+			break;
+		case io::EAT_TEXTURE:
+			{
+				const core::stringc path = attr->getAttributeAsString(i);
+				writeU32(EIBA_TEXTURE);
+				writeU32(name);
+				writeU32(path.size() ? addResource(EIBR_TEXTURE, path) : IRRBIN_NO_INDEX);
+			}
+			break;
+		case io::EAT_DIMENSION2D:
+			{
+				const core::dimension2du d = attr->getAttributeAsDimension2d(i);
+				writeU32(EIBA_DIMENSION2D);
+				writeU32(name);
+				writeU32(d.Width);
+				writeU32(d.Height);
+			}
+			break;
+		default:
+			// user pointers and number lists can't be read back from .irr files either
+			continue;
+		}
+
+		++count;
+	}
+
+#ifdef __BIG_ENDIAN__
+	count = os::Byteswap::byteswap(count);
+#endif
+	memcpy(&Nodes[countPos], &count, 4);
+}
+
+
+//! returns the index of the string in the string table, adds it when needed
+u32 CSceneWriterIrrBin::addString(const core::stringc& str)
+{
+	core::map<core::stringc, u32>::Node* n = StringIndices.find(str);
+	if (n)
+		return n->getValue();
+
+	const u32 index = Strings.size();
+	Strings.push_back(str);
+	StringIndices.insert(str, index);
+	return index;
+}
+
+
+//! same as addString, for wide strings which are stored as utf-8
+u32 CSceneWriterIrrBin::addString(const core::stringw& str)
+{
+	// up to 4 bytes for each character
+	const u32 size = str.size() * 4 + 1;
+	if (Utf8Buffer.size() < size)
+		Utf8Buffer.set_used(size);
+
+	core::wcharToUtf8(str.c_str(), Utf8Buffer.pointer(), size);
+	return addString(core::stringc(Utf8Buffer.const_pointer()));
+}
+
+
+//! returns the index of the resource in the resource table, adds it when needed
+u32 CSceneWriterIrrBin::addResource(E_IRRBIN_RESOURCE_TYPE type, const core::stringc& path)
+{
+	core::map<core::stringc, u32>::Node* n = ResourceIndices[type].find(path);
+	if (n)
+		return n->getValue();
+
+	const u32 index = Resources.size() / 2;
+	Resources.push_back(type);
+	Resources.push_back(addString(path));
+	ResourceIndices[type].insert(path, index);
+	return index;
+}
+
+
+void CSceneWriterIrrBin::writeU32(u32 value)
+{
+#ifdef __BIG_ENDIAN__
+	value = os::Byteswap::byteswap(value);
+#endif
+	memcpy(appendBytes(Nodes, 4), &value, 4);
+}
+
+
+void CSceneWriterIrrBin::writeF32(f32 value)
+{
+#ifdef __BIG_ENDIAN__
+	value = os::Byteswap::byteswap(value);
+#endif
+	memcpy(appendBytes(Nodes, 4), &value, 4);
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BIN_SCENE_WRITER_
+
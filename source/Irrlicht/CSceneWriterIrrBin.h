@@ -0,0 +1,86 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_WRITER_IRR_BIN_H_INCLUDED__
+#define __C_SCENE_WRITER_IRR_BIN_H_INCLUDED__
+
+#include "SIrrBinScene.h"
+#include "irrArray.h"
+#include "irrMap.h"
+#include "irrString.h"
+
+namespace irr
+{
+
+namespace io
+{
+	class IFileSystem;
+	class IAttributes;
+	class IWriteFile;
+	struct SAttributeReadWriteOptions;
+}
+
+namespace scene
+{
+
+class ISceneManager;
+class ISceneNode;
+class ISceneUserDataSerializer;
+
+//! Writes a scene into the binary scene format (.irrbin)
+/** Writes the same data as CSceneManager does for .irr files, see
+SIrrBinScene.h for the layout. */
+class CSceneWriterIrrBin
+{
+public:
+
+	//! Constructor
+	CSceneWriterIrrBin(ISceneManager* smgr, io::IFileSystem* fs);
+
+	//! Destructor
+	~CSceneWriterIrrBin();
+
+	//! Writes the scene, or the given node and its children, into the file
+	bool writeScene(io::IWriteFile* file, ISceneUserDataSerializer* userDataSerializer, ISceneNode* node);
+
+private:
+
+	//! writes a node record and the records of its children
+	void writeSceneNode(ISceneNode* node, ISceneUserDataSerializer* userDataSerializer,
+		io::SAttributeReadWriteOptions& options, bool init=false);
+
+	//! writes an attribute list
+	void writeAttributes(io::IAttributes* attr);
+
+	//! returns the index of the string in the string table, adds it when needed
+	u32 addString(const core::stringc& str);
+
+	//! same as addString, for wide strings which are stored as utf-8
+	u32 addString(const core::stringw& str);
+
+	//! returns the index of the resource in the resource table, adds it when needed
+	u32 addResource(E_IRRBIN_RESOURCE_TYPE type, const core::stringc& path);
+
+	void writeU32(u32 value);
+	void writeS32(s32 value) { writeU32((u32)value); }
+	void writeF32(f32 value);
+
+	ISceneManager* SceneManager;
+	io::IFileSystem* FileSystem;
+	io::IAttributes* Attributes;
+
+	core::array<u8> Nodes;
+	core::array<core::stringc> Strings;
+	core::map<core::stringc, u32> StringIndices;
+	core::array<u32> Resources;
+	core::map<core::stringc, u32> ResourceIndices[EIBR_COUNT];
+	core::array<c8> Utf8Buffer;
+};
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -9,6 +9,8 @@
 #include "CBoneSceneNode.h"
 #include "IAnimatedMeshSceneNode.h"
 #include "os.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 namespace
 {
@@ -170,6 +172,8 @@ void CSkinnedMesh::animateMesh(f32 frame, f32 blend)
 	if (!HasAnimation || LastAnimatedFrame==frame)
 		return;
 
+	IRR_PROFILE(CProfileScope p1(EPID_AM_ANIMATE_MESH);)
+
 	LastAnimatedFrame=frame;
 	SkinnedLastFrame=false;
 
@@ -524,6 +528,8 @@ void CSkinnedMesh::skinMesh()
 	if (!HasAnimation || SkinnedLastFrame)
 		return;
 
+	IRR_PROFILE(CProfileScope p1(EPID_AM_SKIN_MESH);)
+
 	//----------------
 	// This is marked as "Temp!".  A shiny dubloon to whomever can tell me why.
 	buildAllGlobalAnimatedMatrices();
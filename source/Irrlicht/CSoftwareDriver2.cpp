@@ -14,6 +14,8 @@
 #include "S3DVertex.h"
 #include "S4DVertex.h"
 #include "CBlit.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 
 // Matrix now here
@@ -249,6 +251,59 @@ namespace irr
 namespace video
 {
 
+#ifdef _IRR_COMPILE_WITH_PROFILING_
+//! Times of the pipeline stages and the work of one draw call.
+/** A triangle takes too short for start/stop, so everything is summed up and added once. */
+struct SBurningDrawStats
+{
+	SBurningDrawStats() : Last(os::Timer::getRealTimeNanoseconds()), Triangles(0), Spans(0), Texels(0)
+	{
+		for (u32 i = 0; i < 4; ++i)
+			Time[i] = 0;
+	}
+
+	~SBurningDrawStats()
+	{
+		IProfiler& profiler = getProfiler();
+		for (u32 i = 0; i < 4; ++i)
+		{
+			if (Time[i])
+				profiler.addTime(EPID_BV_TRANSFORM + i, Time[i]);
+		}
+		if (Triangles)
+		{
+			profiler.addToCounter(EPC_TRIANGLES, Triangles);
+			profiler.addToCounter(EPC_SPANS, Spans);
+			profiler.addToCounter(EPC_TEXELS, Texels);
+		}
+	}
+
+	//! The time since the end of the last stage belongs to stage
+	void endStage(EPROFILE_ID stage)
+	{
+		const u64 now = os::Timer::getRealTimeNanoseconds();
+		Time[stage - EPID_BV_TRANSFORM] += now - Last;
+		Last = now;
+	}
+
+	//! Counts a triangle in device coordinates, the shaders fill the rows between the rounded up y values
+	void addTriangle(f32 y0, f32 y1, f32 y2, f32 area, size_t textures)
+	{
+		Triangles += 1;
+		const s32 rows = core::ceil32(core::max_(y0, y1, y2)) - core::ceil32(core::min_(y0, y1, y2));
+		if (rows > 0)
+			Spans += rows;
+		Texels += (u64)core::abs_(area) * textures;
+	}
+
+	u64 Time[4];
+	u64 Last;
+	u64 Triangles;
+	u64 Spans;
+	u64 Texels;
+};
+#endif
+
 //! constructor
 CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters& params, io::IFileSystem* io, video::IImagePresenter* presenter)
 	: CNullDriver(io, params.WindowSize), BackBuffer(0), Presenter(presenter),
@@ -265,6 +320,9 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 
 	VertexCache_map_source_format();
 
+	Batch2D.Texture = 0;
+	Batch2D.Flushing = false;
+
 	//Use AntiAlias(hack) to shrink BackBuffer Size and keep ScreenSize the same as Input
 	scale_setup scale;
 	get_scale(scale, params);
@@ -380,12 +438,30 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 
 	// select the right renderer
 	setMaterial(Material.org);
+
+	IRR_PROFILE(
+		static bool initProfile = false;
+		if (!initProfile )
+		{
+			initProfile = true;
+			getProfiler().add(EPID_BV_DRAW_PRIMITIVES, L"drawPrim", L"Burnings");
+			getProfiler().add(EPID_BV_TRANSFORM, L"transform", L"Burnings");
+			getProfiler().add(EPID_BV_CLIP, L"clip", L"Burnings");
+			getProfiler().add(EPID_BV_SETUP, L"setup", L"Burnings");
+			getProfiler().add(EPID_BV_RASTER, L"raster", L"Burnings");
+			getProfiler().add(EPID_BV_CLEAR, L"clear", L"Burnings");
+			getProfiler().add(EPID_BV_PRESENT, L"present", L"Burnings");
+		}
+	)
 }
 
 
 //! destructor
 CBurningVideoDriver::~CBurningVideoDriver()
 {
+	if (Batch2D.Texture)
+		Batch2D.Texture->drop();
+
 	// delete Backbuffer
 	if (BackBuffer)
 	{
@@ -573,6 +649,8 @@ void CBurningVideoDriver::transform_calc(E_TRANSFORMATION_STATE_BURNING_VIDEO st
 //! sets transformation
 void CBurningVideoDriver::setTransform(E_TRANSFORMATION_STATE state, const core::matrix4& mat)
 {
+	flushBatch2D();
+
 	size_t* flag = TransformationFlag[TransformationStack];
 	core::matrix4* matrix = Transformation[TransformationStack];
 
@@ -672,8 +750,10 @@ bool CBurningVideoDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clear
 
 bool CBurningVideoDriver::endScene()
 {
+	flushBatch2D();
 	CNullDriver::endScene();
 
+	IRR_PROFILE(CProfileScope p1(EPID_BV_PRESENT);)
 	return Presenter->present(BackBuffer, WindowId, SceneSourceRect);
 }
 
@@ -708,6 +788,8 @@ bool CBurningVideoDriver::setRenderTarget(video::ITexture* texture, bool clearBa
 
 bool CBurningVideoDriver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag, SColor clearColor, f32 clearDepth, u8 clearStencil)
 {
+	flushBatch2D();
+
 #if !defined(PATCH_SUPERTUX_8_0_1_with_1_9_0)
 	if (target && target->getDriverType() != EDT_BURNINGSVIDEO)
 	{
@@ -819,6 +901,8 @@ void buildNDCToDCMatrix(f32* m, const core::rect<s32>& viewport, f32 tx)
 //! sets a viewport
 void CBurningVideoDriver::setViewPort(const core::rect<s32>& area)
 {
+	flushBatch2D();
+
 	ViewPort = area;
 
 	core::rect<s32> rendert(0, 0, RenderTargetSize.Width, RenderTargetSize.Height);
@@ -833,6 +917,8 @@ void CBurningVideoDriver::setViewPort(const core::rect<s32>& area)
 
 void CBurningVideoDriver::setScissor(int x, int y, int width, int height)
 {
+	flushBatch2D();
+
 	//openGL
 	//y = rt.Height - y - height;
 
@@ -2114,11 +2200,17 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 	E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
 
 {
+	flushBatch2D();
+
 	if (!checkPrimitiveCount(primitiveCount))
 		return;
 
+	IRR_PROFILE(CProfileScope p1(EPID_BV_DRAW_PRIMITIVES);)
 	CNullDriver::drawVertexPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
 
+	// the stages of the triangles are timed together and added at the end
+	IRR_PROFILE(SBurningDrawStats stats;)
+
 	if (VertexCache_reset(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType))
 		return;
 
@@ -2146,6 +2238,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 	{
 		//collect pointer to face vertices
 		VertexCache_get(face);
+		IRR_PROFILE(stats.endStage(EPID_BV_TRANSFORM);)
 
 		size_t clipMask_i;
 		size_t clipMask_o;
@@ -2190,6 +2283,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 			// to DC Space, project homogenous vertex
 			ndc_2_dc_and_project(Clipper.data + s4DVertex_proj(0), Clipper.data + s4DVertex_ofs(0), s4DVertex_ofs(vOut));
+			IRR_PROFILE(stats.endStage(EPID_BV_CLIP);)
 		}
 #else
 		{
@@ -2233,6 +2327,9 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 			if (Material.CullFlag & sign)
 				break; //continue;
 
+			IRR_PROFILE(stats.addTriangle((face[0] + s4DVertex_proj(0))->Pos.y, (face[1] + s4DVertex_proj(0))->Pos.y,
+				(face[2] + s4DVertex_proj(0))->Pos.y, dc_area, VertexCache.vSize[VertexCache.vType].TexSize);)
+
 			//select mipmap ratio between drawing space and texture space (for multiply divide here)
 			dc_area = reciprocal_zero(dc_area);
 
@@ -2264,7 +2361,9 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 				select_polygon_mipmap_inside(face, m, tex->getTexBound());
 			}
 			
+			IRR_PROFILE(stats.endStage(EPID_BV_SETUP);)
 			CurrentShader->drawWireFrameTriangle(face[0] + s4DVertex_proj(0), face[1] + s4DVertex_proj(0), face[2] + s4DVertex_proj(0));
+			IRR_PROFILE(stats.endStage(EPID_BV_RASTER);)
 			vertex_from_clipper = 1;
 		}
 
@@ -2412,6 +2511,8 @@ u32 CBurningVideoDriver::getMaximalDynamicLightAmount() const
 //! sets a material
 void CBurningVideoDriver::setMaterial(const SMaterial& material)
 {
+	flushBatch2D();
+
 	// ---------- Override
 	Material.org = material;
 	OverrideMaterial.apply(Material.org);
@@ -2944,6 +3045,7 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 //! Enable the 2d override material
 void CBurningVideoDriver::enableMaterial2D(bool enable)
 {
+	flushBatch2D();
 	CNullDriver::enableMaterial2D(enable);
 	burning_setbit(TransformationFlag[1][ETS_PROJECTION], 0, ETF_VALID);
 }
@@ -3049,11 +3151,88 @@ void CBurningVideoDriver::setRenderStates3DMode()
 	TransformationStack = 0;
 }
 
+//! adds the quad in Quad2DVertices to the 2d batch
+/** Quads with the same texture, color, alpha usage and scissor are drawn
+	as one triangle list, which saves the setup of the states and the
+	transformation for each call. The batch is flushed before anything else
+	draws, changes states or reads the render target. */
+void CBurningVideoDriver::addQuad2D(const video::ITexture* texture, const video::SColor& color,
+	bool useAlphaChannelOfTexture, const core::rect<s32>* scissor)
+{
+	// 16 bit indices limit the size of a batch
+	if (!Batch2DVertices.empty() &&
+		(Batch2D.Texture != texture || Batch2D.Color != color ||
+		Batch2D.UseAlphaChannelOfTexture != useAlphaChannelOfTexture ||
+		Batch2D.Scissor != (scissor != 0) || (scissor && Batch2D.ScissorRect != *scissor) ||
+		Batch2DVertices.size() > 0x10000 - 4))
+	{
+		flushBatch2D();
+	}
+
+	if (Batch2DVertices.empty())
+	{
+		// the batch keeps the texture alive until it is drawn
+		Batch2D.Texture = texture;
+		if (texture)
+			texture->grab();
+		Batch2D.Color = color;
+		Batch2D.UseAlphaChannelOfTexture = useAlphaChannelOfTexture;
+		Batch2D.Scissor = scissor != 0;
+		if (scissor)
+			Batch2D.ScissorRect = *scissor;
+	}
+
+	const u16 first = (u16)Batch2DVertices.size();
+	for (u32 i = 0; i < 4; ++i)
+		Batch2DVertices.push_back(Quad2DVertices[i]);
+	for (u32 i = 0; i < 6; ++i)
+		Batch2DIndices.push_back(first + quad_triangle_indexList[i]);
+}
+
+//! draws the collected 2d quads
+void CBurningVideoDriver::flushBatch2D()
+{
+	// drawing the batch sets states which would flush again
+	if (Batch2DVertices.empty() || Batch2D.Flushing)
+		return;
+	Batch2D.Flushing = true;
+
+	if (Batch2D.Scissor)
+	{
+		//glEnable(GL_SCISSOR_TEST);
+		EyeSpace.TL_Flag |= TL_SCISSOR;
+		setScissor(Batch2D.ScissorRect.UpperLeftCorner.X, Batch2D.ScissorRect.UpperLeftCorner.Y,
+			Batch2D.ScissorRect.getWidth(), Batch2D.ScissorRect.getHeight());
+	}
+
+	setRenderStates2DMode(Batch2D.Color, Batch2D.Texture, Batch2D.UseAlphaChannelOfTexture);
+
+	drawVertexPrimitiveList(Batch2DVertices.const_pointer(), Batch2DVertices.size(),
+		Batch2DIndices.const_pointer(), Batch2DIndices.size() / 3,
+		EVT_STANDARD, scene::EPT_TRIANGLES, EIT_16BIT);
+
+	if (Batch2D.Scissor)
+		EyeSpace.TL_Flag &= ~TL_SCISSOR;
+
+	setRenderStates3DMode();
+
+	Batch2DVertices.set_used(0);
+	Batch2DIndices.set_used(0);
+	if (Batch2D.Texture)
+	{
+		Batch2D.Texture->drop();
+		Batch2D.Texture = 0;
+	}
+	Batch2D.Flushing = false;
+}
+
 //! draws a vertex primitive list in 2d
 void CBurningVideoDriver::draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount,
 	const void* indexList, u32 primitiveCount,
 	E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
 {
+	flushBatch2D();
+
 	if (!checkPrimitiveCount(primitiveCount))
 		return;
 
@@ -3141,14 +3320,20 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture, const core
 	Quad2DVertices[2].TCoords = core::vector2df(tcoords.LowerRightCorner.X, tcoords.LowerRightCorner.Y);
 	Quad2DVertices[3].TCoords = core::vector2df(tcoords.UpperLeftCorner.X, tcoords.LowerRightCorner.Y);
 
-	setRenderStates2DMode(color, texture, useAlphaChannelOfTexture);
-
-	drawVertexPrimitiveList(Quad2DVertices, 4,
-		quad_triangle_indexList, 2,
-		EVT_STANDARD, scene::EPT_TRIANGLES, EIT_16BIT);
+	addQuad2D(texture, color, useAlphaChannelOfTexture, 0);
+}
 
-	setRenderStates3DMode();
 
+//! draws a set of 2d images, the quads go into the 2d batch
+void CBurningVideoDriver::draw2DImageBatch(const video::ITexture* texture,
+	const core::array<core::position2d<s32> >& positions,
+	const core::array<core::rect<s32> >& sourceRects,
+	const core::rect<s32>* clipRect, SColor color,
+	bool useAlphaChannelOfTexture)
+{
+	const u32 drawCount = core::min_<u32>(positions.size(), sourceRects.size());
+	for (u32 i = 0; i < drawCount; ++i)
+		draw2DImage(texture, positions[i], sourceRects[i], clipRect, color, useAlphaChannelOfTexture);
 }
 
 
@@ -3193,32 +3378,14 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture, const core
 	Quad2DVertices[3].TCoords = core::vector2df(tcoords.UpperLeftCorner.X, tcoords.LowerRightCorner.Y);
 
 
-	if (clipRect)
-	{
-		if (!clipRect->isValid())
-			return;
-
-		//glEnable(GL_SCISSOR_TEST);
-		EyeSpace.TL_Flag |= TL_SCISSOR;
-		setScissor(clipRect->UpperLeftCorner.X, clipRect->UpperLeftCorner.Y,//renderTargetSize.Height - clipRect->LowerRightCorner.Y
-			clipRect->getWidth(), clipRect->getHeight());
-	}
+	// the clip rectangle is a scissor when the batch is drawn
+	if (clipRect && !clipRect->isValid())
+		return;
 
 	video::SColor alphaTest;
 	alphaTest.color = useColor[0].color & useColor[0].color & useColor[0].color & useColor[0].color;
 
-
-	setRenderStates2DMode(alphaTest,texture, useAlphaChannelOfTexture);
-
-	drawVertexPrimitiveList(Quad2DVertices, 4,
-		quad_triangle_indexList, 2,
-		EVT_STANDARD, scene::EPT_TRIANGLES, EIT_16BIT);
-
-	if (clipRect)
-		EyeSpace.TL_Flag &= ~TL_SCISSOR;
-
-	setRenderStates3DMode();
-
+	addQuad2D(texture, alphaTest, useAlphaChannelOfTexture, clipRect);
 }
 
 
@@ -3257,14 +3424,7 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 
 	video::SColor alphaTest;
 	alphaTest.color = colorLeftUp.color & colorRightUp.color & colorRightDown.color & colorLeftDown.color;
-	setRenderStates2DMode(alphaTest, 0, 0);
-
-	drawVertexPrimitiveList(Quad2DVertices, 4,
-		quad_triangle_indexList, 2,
-		EVT_STANDARD, scene::EPT_TRIANGLES, EIT_16BIT);
-
-	setRenderStates3DMode();
-
+	addQuad2D(0, alphaTest, false, 0);
 }
 
 
@@ -3279,6 +3439,7 @@ void CBurningVideoDriver::draw2DLine(const core::position2d<s32>& start,
 	const core::position2d<s32>& end,
 	SColor color)
 {
+	flushBatch2D();
 	drawLine(RenderTargetSurface, start, end, color);
 }
 
@@ -3286,6 +3447,7 @@ void CBurningVideoDriver::draw2DLine(const core::position2d<s32>& start,
 //! Draws a pixel
 void CBurningVideoDriver::drawPixel(u32 x, u32 y, const SColor& color)
 {
+	flushBatch2D();
 	RenderTargetSurface->setPixel(x, y, color, true);
 }
 
@@ -3294,6 +3456,8 @@ void CBurningVideoDriver::drawPixel(u32 x, u32 y, const SColor& color)
 //! the window was resized.
 void CBurningVideoDriver::OnResize(const core::dimension2d<u32>& size)
 {
+	flushBatch2D();
+
 	// make sure width and height are multiples of 2
 	core::dimension2d<u32> realSize(size);
 	/*
@@ -3340,6 +3504,8 @@ const core::dimension2d<u32>& CBurningVideoDriver::getCurrentRenderTargetSize()
 void CBurningVideoDriver::draw3DLine(const core::vector3df& start,
 	const core::vector3df& end, SColor color_start)
 {
+	flushBatch2D();
+
 	SColor color_end = color_start;
 
 	VertexCache.primitiveHasVertex = 2;
@@ -3452,7 +3618,9 @@ ITexture* CBurningVideoDriver::addRenderTargetTexture(const core::dimension2d<u3
 	//IImage* img = createImage(SOFTWARE_DRIVER_2_RENDERTARGET_COLOR_FORMAT, size);
 	//empty proxy image
 	IImage* img = createImageFromData(format, size, 0, true, false);
-	ITexture* tex = new CSoftwareTexture2(img, name, CSoftwareTexture2::IS_RENDERTARGET /*| CSoftwareTexture2::GEN_MIPMAP */, this);
+	const u32 flags = CSoftwareTexture2::IS_RENDERTARGET /*| CSoftwareTexture2::GEN_MIPMAP */
+		| ((TextureCreationFlags & ETCF_ALLOW_NON_POWER_2) ? CSoftwareTexture2::ALLOW_NPOT : 0);
+	ITexture* tex = new CSoftwareTexture2(img, name, flags, this);
 	if ( img ) img->drop();
 	addTexture(tex);
 	tex->drop();
@@ -3461,6 +3629,8 @@ ITexture* CBurningVideoDriver::addRenderTargetTexture(const core::dimension2d<u3
 
 void CBurningVideoDriver::clearBuffers(u16 flag, SColor color, f32 depth, u8 stencil)
 {
+	flushBatch2D();
+	IRR_PROFILE(CProfileScope p1(EPID_BV_CLEAR);)
 	if ((flag & ECBF_COLOR) && RenderTargetSurface) image_fill(RenderTargetSurface, color, Interlaced);
 	if ((flag & ECBF_DEPTH) && DepthBuffer) DepthBuffer->clear(depth, Interlaced);
 	if ((flag & ECBF_STENCIL) && StencilBuffer) StencilBuffer->clear(stencil, Interlaced);
@@ -3489,6 +3659,8 @@ void CBurningVideoDriver::saveBuffer()
 //! Returns an image created from the last rendered frame.
 IImage* CBurningVideoDriver::createScreenShot(video::ECOLOR_FORMAT format, video::E_RENDER_TARGET target)
 {
+	flushBatch2D();
+
 	if (target != video::ERT_FRAME_BUFFER)
 		return 0;
 
@@ -3512,6 +3684,7 @@ ITexture* CBurningVideoDriver::createDeviceDependentTexture(const io::path& name
 		| ((TextureCreationFlags & ETCF_AUTO_GENERATE_MIP_MAPS) ? CSoftwareTexture2::GEN_MIPMAP_AUTO : 0)
 #endif
 		| ((TextureCreationFlags & ETCF_ALLOW_NON_POWER_2) ? CSoftwareTexture2::ALLOW_NPOT : 0)
+		| ((TextureCreationFlags & ETCF_OPTIMIZED_FOR_QUALITY) ? CSoftwareTexture2::MIPMAP_KAISER : 0)
 #if defined(IRRLICHT_sRGB)
 		| ((TextureCreationFlags & ETCF_IMAGE_IS_LINEAR) ? CSoftwareTexture2::IMAGE_IS_LINEAR : 0)
 		| ((TextureCreationFlags & ETCF_TEXTURE_IS_LINEAR) ? CSoftwareTexture2::TEXTURE_IS_LINEAR : 0)
@@ -3541,6 +3714,8 @@ u32 CBurningVideoDriver::getMaximalPrimitiveCount() const
 //! volume. Next use IVideoDriver::drawStencilShadow() to visualize the shadow.
 void CBurningVideoDriver::drawStencilShadowVolume(const core::array<core::vector3df>& triangles, bool zfail, u32 debugDataVisible)
 {
+	flushBatch2D();
+
 	const u32 count = triangles.size();
 	if (!StencilBuffer || !count)
 		return;
@@ -3605,6 +3780,8 @@ void CBurningVideoDriver::drawStencilShadowVolume(const core::array<core::vector
 void CBurningVideoDriver::drawStencilShadow(bool clearStencilBuffer, video::SColor leftUpEdge,
 	video::SColor rightUpEdge, video::SColor leftDownEdge, video::SColor rightDownEdge)
 {
+	flushBatch2D();
+
 	if (!StencilBuffer)
 		return;
 
@@ -124,6 +124,16 @@ namespace video
 				const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
 				const video::SColor* const colors=0, bool useAlphaChannelOfTexture=false) _IRR_OVERRIDE_;
 
+#if defined(SOFTWARE_DRIVER_2_2D_AS_3D)
+		//! Draws a set of 2d images, all quads go into one triangle list
+		virtual void draw2DImageBatch(const video::ITexture* texture,
+				const core::array<core::position2d<s32> >& positions,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::rect<s32>* clipRect=0,
+				SColor color=SColor(255,255,255,255),
+				bool useAlphaChannelOfTexture=false) _IRR_OVERRIDE_;
+#endif
+
 		//! Draws a 3d line.
 		virtual void draw3DLine(const core::vector3df& start,
 			const core::vector3df& end, SColor color_start) _IRR_OVERRIDE_;
@@ -367,6 +377,14 @@ namespace video
 		void setRenderStates2DMode(const video::SColor& color,const video::ITexture* texture,bool useAlphaChannelOfTexture);
 		void setRenderStates3DMode();
 
+		//! adds the quad in Quad2DVertices to the 2d batch, the batch is drawn first if the states differ
+		void addQuad2D(const video::ITexture* texture, const video::SColor& color,
+			bool useAlphaChannelOfTexture, const core::rect<s32>* scissor);
+		public:
+		//! draws the collected 2d quads, called before anything else changes the render target or states
+		void flushBatch2D();
+		protected:
+
 		//ETS_CLIPSCALE, // moved outside to stay at 16 matrices
 		f32 Transformation_ETS_CLIPSCALE[2][4];
 		void transform_calc(E_TRANSFORMATION_STATE_BURNING_VIDEO state);
@@ -425,6 +443,20 @@ namespace video
 
 		//! Built-in 2D quad for 2D rendering.
 		S3DVertex Quad2DVertices[4];
+		core::array<S3DVertex> Batch2DVertices;
+		core::array<u16> Batch2DIndices;
+
+		//! states of the quads in Batch2DVertices
+		struct SBatch2D
+		{
+			const ITexture* Texture;
+			SColor Color;
+			bool UseAlphaChannelOfTexture;
+			bool Scissor;
+			core::rect<s32> ScissorRect;
+			bool Flushing;
+		};
+		SBatch2D Batch2D;
 		interlaced_control Interlaced;
 
 #if defined(PATCH_SUPERTUX_8_0_1_with_1_9_0)
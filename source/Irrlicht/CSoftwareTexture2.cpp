@@ -10,6 +10,11 @@
 #include "CSoftwareTexture2.h"
 #include "CSoftwareDriver2.h"
 #include "CBlit.h"
+#include "CMipMapGenerator.h"
+#include "irrHash.h"
+#include "IFileSystem.h"
+#include "IReadFile.h"
+#include "IWriteFile.h"
 #include "os.h"
 
 namespace irr
@@ -198,23 +203,14 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* data)
 
 	if (HasMipMaps && ((Flags & GEN_MIPMAP_AUTO) || 0 == data))
 	{
-		//need memory also if autogen mipmap disabled
-		for (i = 1; i < array_size(MipMap); ++i)
+		//precomputed chain of the same data
+		const bool useCache = !IsRenderTarget && MipMap[0] && Driver->getTextureCacheDirectory().size();
+		const u64 hash = useCache ? getMipMapCacheHash() : 0;
+		if (!useCache || !loadMipMapCache(hash))
 		{
-			const core::dimension2du& upperDim = MipMap[i - 1]->getDimension();
-			//isotropic
-			newSize.Width = core::s32_max(SOFTWARE_DRIVER_2_MIPMAPPING_MIN_SIZE, upperDim.Width >> 1);
-			newSize.Height = core::s32_max(SOFTWARE_DRIVER_2_MIPMAPPING_MIN_SIZE, upperDim.Height >> 1);
-			if (upperDim == newSize)
-				break;
-
-			MipMap[i] = new CImage(ColorFormat, newSize);
-#if defined(IRRLICHT_sRGB)
-			MipMap[i]->set_sRGB(MipMap[i - 1]->get_sRGB());
-#endif
-			//MipMap[i]->fill ( 0xFFFF4040 );
-			//MipMap[i-1]->copyToScalingBoxFilter( MipMap[i], 0, false );
-			Resample_subSampling(BLITTER_TEXTURE, MipMap[i], 0, MipMap[0], 0, Flags);
+			generateMipMapLevels();
+			if (useCache)
+				saveMipMapCache(hash);
 		}
 	}
 	else if (HasMipMaps && data)
@@ -333,6 +329,163 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* data)
 	calcDerivative();
 }
 
+void CSoftwareTexture2::generateMipMapLevels()
+{
+#if defined(IRRLICHT_sRGB)
+	const bool sRGB = MipMap[0]->get_sRGB() != 0;
+#else
+	const bool sRGB = (Flags & TEXTURE_IS_LINEAR) == 0;
+#endif
+	// halves the previous level. falls back to resampling level 0 for odd sizes
+	CMipMapGenerator generator(MipMap[0], (Flags & MIPMAP_KAISER) ? EMMF_KAISER : EMMF_BOX, sRGB);
+
+	core::dimension2d<u32> newSize;
+
+	//need memory also if autogen mipmap disabled
+	for (size_t i = 1; i < array_size(MipMap); ++i)
+	{
+		const core::dimension2du& upperDim = MipMap[i - 1]->getDimension();
+		//isotropic
+		newSize.Width = core::s32_max(SOFTWARE_DRIVER_2_MIPMAPPING_MIN_SIZE, upperDim.Width >> 1);
+		newSize.Height = core::s32_max(SOFTWARE_DRIVER_2_MIPMAPPING_MIN_SIZE, upperDim.Height >> 1);
+		if (upperDim == newSize)
+			break;
+
+		MipMap[i] = new CImage(ColorFormat, newSize);
+#if defined(IRRLICHT_sRGB)
+		MipMap[i]->set_sRGB(MipMap[i - 1]->get_sRGB());
+#endif
+		//MipMap[i]->fill ( 0xFFFF4040 );
+		if (!generator.generate(MipMap[i]))
+			Resample_subSampling(BLITTER_TEXTURE, MipMap[i], 0, MipMap[0], 0, Flags);
+	}
+}
+
+
+//! header of the mipmap chains in the texture cache directory
+struct SMipMapCacheHeader
+{
+	c8 Magic[4];
+	u32 Version;
+	u32 ColorFormat;
+	u32 Width;
+	u32 Height;
+	u32 LevelCount;
+	u64 Hash;
+};
+
+static const c8 MIPMAP_CACHE_MAGIC[4] = { 'I', 'M', 'I', 'P' };
+static const u32 MIPMAP_CACHE_VERSION = 2;
+
+static io::path getMipMapCacheName(const io::path& directory, u64 hash)
+{
+	char buf[32];
+	snprintf_irr(buf, sizeof(buf), "%08x%08x.mip", (u32)(hash >> 32), (u32)hash);
+	return directory + buf;
+}
+
+u64 CSoftwareTexture2::getMipMapCacheHash() const
+{
+	const u32 settings[] = {
+		MIPMAP_CACHE_VERSION,
+		(u32)ColorFormat,
+		MipMap[0]->getDimension().Width,
+		MipMap[0]->getDimension().Height,
+		Flags & (MIPMAP_KAISER | TEXTURE_IS_LINEAR | IMAGE_IS_LINEAR),
+#if defined(IRRLICHT_sRGB)
+		MipMap[0]->get_sRGB(),
+#endif
+		SOFTWARE_DRIVER_2_MIPMAPPING_MAX,
+		SOFTWARE_DRIVER_2_MIPMAPPING_MIN_SIZE
+	};
+	const u64 seed = os::hash(settings, sizeof(settings));
+	return os::hash(MipMap[0]->getData(), MipMap[0]->getImageDataSizeInBytes(), seed);
+}
+
+bool CSoftwareTexture2::loadMipMapCache(u64 hash)
+{
+	io::IReadFile* file = Driver->getFileSystem()->createAndOpenFile(
+		getMipMapCacheName(Driver->getTextureCacheDirectory(), hash));
+	if (!file)
+		return false;
+
+	SMipMapCacheHeader header;
+	bool success = file->read(&header, sizeof(header)) == sizeof(header) &&
+		memcmp(header.Magic, MIPMAP_CACHE_MAGIC, 4) == 0 &&
+		header.Version == MIPMAP_CACHE_VERSION &&
+		header.ColorFormat == (u32)ColorFormat &&
+		header.Width == MipMap[0]->getDimension().Width &&
+		header.Height == MipMap[0]->getDimension().Height &&
+		header.Hash == hash;
+
+	core::dimension2d<u32> newSize;
+	u32 levels = 0;
+	for (size_t i = 1; success && i < array_size(MipMap); ++i)
+	{
+		const core::dimension2du& upperDim = MipMap[i - 1]->getDimension();
+		newSize.Width = core::s32_max(SOFTWARE_DRIVER_2_MIPMAPPING_MIN_SIZE, upperDim.Width >> 1);
+		newSize.Height = core::s32_max(SOFTWARE_DRIVER_2_MIPMAPPING_MIN_SIZE, upperDim.Height >> 1);
+		if (upperDim == newSize)
+			break;
+
+		MipMap[i] = new CImage(ColorFormat, newSize);
+#if defined(IRRLICHT_sRGB)
+		MipMap[i]->set_sRGB(MipMap[i - 1]->get_sRGB());
+#endif
+		const size_t size = MipMap[i]->getImageDataSizeInBytes();
+		success = file->read(MipMap[i]->getData(), size) == size;
+		levels += 1;
+	}
+	success = success && levels == header.LevelCount;
+	file->drop();
+
+	if (!success)
+	{
+		for (size_t i = 1; i < array_size(MipMap); ++i)
+		{
+			if (MipMap[i])
+			{
+				MipMap[i]->drop();
+				MipMap[i] = 0;
+			}
+		}
+	}
+	return success;
+}
+
+void CSoftwareTexture2::saveMipMapCache(u64 hash) const
+{
+	io::IWriteFile* file = Driver->getFileSystem()->createAndWriteFile(
+		getMipMapCacheName(Driver->getTextureCacheDirectory(), hash));
+	if (!file)
+	{
+		os::Printer::log("Burningvideo: Could not write to texture cache", Driver->getTextureCacheDirectory(), ELL_WARNING);
+		return;
+	}
+
+	SMipMapCacheHeader header;
+	memcpy(header.Magic, MIPMAP_CACHE_MAGIC, 4);
+	header.Version = MIPMAP_CACHE_VERSION;
+	header.ColorFormat = (u32)ColorFormat;
+	header.Width = MipMap[0]->getDimension().Width;
+	header.Height = MipMap[0]->getDimension().Height;
+	header.LevelCount = 0;
+	header.Hash = hash;
+	for (size_t i = 1; i < array_size(MipMap) && MipMap[i]; ++i)
+		header.LevelCount += 1;
+
+	file->write(&header, sizeof(header));
+	for (size_t i = 1; i <= header.LevelCount; ++i)
+		file->write(MipMap[i]->getData(), MipMap[i]->getImageDataSizeInBytes());
+	file->drop();
+}
+
+void CSoftwareTexture2::flushDriverBatch2D()
+{
+	if (Driver)
+		Driver->flushBatch2D();
+}
+
 void CSoftwareTexture2::calcDerivative()
 {
 	//reset current MipMap
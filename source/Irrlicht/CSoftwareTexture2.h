@@ -46,6 +46,7 @@ public:
 		ALLOW_NPOT			= 8,		//allow non power of two
 		IMAGE_IS_LINEAR		= 16,
 		TEXTURE_IS_LINEAR	= 32,
+		MIPMAP_KAISER		= 64,		// sharper mipmap filter
 	};
 	CSoftwareTexture2(IImage* surface, const io::path& name, u32 flags /*eTex2Flags*/, CBurningVideoDriver* driver);
 
@@ -68,6 +69,10 @@ public:
 	virtual void* lock(E_TEXTURE_LOCK_MODE mode, u32 mipmapLevel, u32 layer, E_TEXTURE_LOCK_FLAGS lockFlags = ETLF_FLIP_Y_UP_RTT) _IRR_OVERRIDE_
 #endif
 	{
+		// quads of the driver which are not drawn yet might use the old content
+		if (mode != ETLM_READ_ONLY)
+			flushDriverBatch2D();
+
 		if (Flags & GEN_MIPMAP)
 		{
 			//called from outside. must test
@@ -146,6 +151,21 @@ public:
 private:
 	void calcDerivative();
 
+	//! draws the 2d batch of the driver
+	void flushDriverBatch2D();
+
+	//! creates the mipmap levels below level 0
+	void generateMipMapLevels();
+
+	//! returns the hash of level 0 and all settings which change the mipmap chain
+	u64 getMipMapCacheHash() const;
+
+	//! loads the mipmap levels from the texture cache directory of the driver
+	bool loadMipMapCache(u64 hash);
+
+	//! writes the mipmap levels into the texture cache directory of the driver
+	void saveMipMapCache(u64 hash) const;
+
 	//! controls MipmapSelection. relation between drawn area and image size
 	u32 MipMapLOD; // 0 .. original Texture pot -SOFTWARE_DRIVER_2_MIPMAPPING_MAX
 	u32 Flags; //eTex2Flags
@@ -0,0 +1,720 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTextureCompressor.h"
+#include "CImage.h"
+#include "CColorConverter.h"
+#include "CMipMapGenerator.h"
+#include "irrArray.h"
+#include "irrMath.h"
+#include "os.h"
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+//! modifier tables of etc1/etc2 (+a, +b, -a, -b)
+const s32 ETCModifiers[8][4] =
+{
+	{  2,   8,  -2,   -8 },
+	{  5,  17,  -5,  -17 },
+	{  9,  29,  -9,  -29 },
+	{ 13,  42, -13,  -42 },
+	{ 18,  60, -18,  -60 },
+	{ 24,  80, -24,  -80 },
+	{ 33, 106, -33, -106 },
+	{ 47, 183, -47, -183 }
+};
+
+//! modifier tables of the eac alpha blocks of etc2
+const s32 EACModifiers[16][8] =
+{
+	{ -3, -6,  -9, -15, 2, 5, 8, 14 },
+	{ -3, -7, -10, -13, 2, 6, 9, 12 },
+	{ -2, -5,  -8, -13, 1, 4, 7, 12 },
+	{ -2, -4,  -6, -13, 1, 3, 5, 12 },
+	{ -3, -6,  -8, -12, 2, 5, 7, 11 },
+	{ -3, -7,  -9, -11, 2, 6, 8, 10 },
+	{ -4, -7,  -8, -11, 3, 6, 7, 10 },
+	{ -3, -5,  -8, -11, 2, 4, 7, 10 },
+	{ -2, -6,  -8, -10, 1, 5, 7,  9 },
+	{ -2, -5,  -8, -10, 1, 4, 7,  9 },
+	{ -2, -4,  -8, -10, 1, 3, 7,  9 },
+	{ -2, -5,  -7, -10, 1, 4, 6,  9 },
+	{ -3, -4,  -7, -10, 2, 3, 6,  9 },
+	{ -1, -2,  -3, -10, 0, 1, 2,  9 },
+	{ -4, -6,  -8,  -9, 3, 5, 7,  8 },
+	{ -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+//! texels of a block as r,g,b,a in row order
+struct SBlock
+{
+	s32 Texel[16][4];
+};
+
+inline s32 square(s32 x)
+{
+	return x * x;
+}
+
+inline s32 colorError(const s32* a, const s32* b)
+{
+	return square(a[0] - b[0]) + square(a[1] - b[1]) + square(a[2] - b[2]);
+}
+
+// ----- DXT -----
+
+inline u16 packColor565(f32 r, f32 g, f32 b)
+{
+	const s32 r5 = core::s32_clamp(core::round32(r * (31.f / 255.f)), 0, 31);
+	const s32 g6 = core::s32_clamp(core::round32(g * (63.f / 255.f)), 0, 63);
+	const s32 b5 = core::s32_clamp(core::round32(b * (31.f / 255.f)), 0, 31);
+	return (u16)((r5 << 11) | (g6 << 5) | b5);
+}
+
+inline void unpackColor565(u16 c, s32* rgb)
+{
+	const s32 r = (c >> 11) & 31;
+	const s32 g = (c >> 5) & 63;
+	const s32 b = c & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+//! finds the nearest palette entries for the endpoints, returns the error
+s32 fitColorIndices(const SBlock& block, u16 c0, u16 c1, u8* indices)
+{
+	s32 palette[4][3];
+	unpackColor565(c0, palette[0]);
+	unpackColor565(c1, palette[1]);
+	for (u32 i = 0; i < 3; ++i)
+	{
+		palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+		palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+	}
+
+	s32 error = 0;
+	for (u32 t = 0; t < 16; ++t)
+	{
+		s32 best = colorError(block.Texel[t], palette[0]);
+		indices[t] = 0;
+		for (u8 k = 1; k < 4; ++k)
+		{
+			const s32 e = colorError(block.Texel[t], palette[k]);
+			if (e < best)
+			{
+				best = e;
+				indices[t] = k;
+			}
+		}
+		error += best;
+	}
+	return error;
+}
+
+//! least squares fit of the endpoints to the current indices
+bool refineEndpoints(const SBlock& block, const u8* indices, u16& c0, u16& c1)
+{
+	static const f32 weight[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+
+	f32 aa = 0.f, ab = 0.f, bb = 0.f;
+	f32 ax[3] = { 0.f, 0.f, 0.f };
+	f32 bx[3] = { 0.f, 0.f, 0.f };
+	for (u32 t = 0; t < 16; ++t)
+	{
+		const f32 b = weight[indices[t]];
+		const f32 a = 1.f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (u32 i = 0; i < 3; ++i)
+		{
+			ax[i] += a * block.Texel[t][i];
+			bx[i] += b * block.Texel[t][i];
+		}
+	}
+
+	const f32 det = aa * bb - ab * ab;
+	if (core::iszero(det))
+		return false;
+
+	const f32 f = 1.f / det;
+	f32 e0[3], e1[3];
+	for (u32 i = 0; i < 3; ++i)
+	{
+		e0[i] = (bb * ax[i] - ab * bx[i]) * f;
+		e1[i] = (aa * bx[i] - ab * ax[i]) * f;
+	}
+	c0 = packColor565(e0[0], e0[1], e0[2]);
+	c1 = packColor565(e1[0], e1[1], e1[2]);
+	return true;
+}
+
+//! dxt1 color block, also used for dxt5
+void encodeColorBlock(const SBlock& block, u8* out)
+{
+	// principal axis of the colors
+	f32 mean[3] = { 0.f, 0.f, 0.f };
+	s32 minC[3] = { 255, 255, 255 };
+	s32 maxC[3] = { 0, 0, 0 };
+	u32 t, i;
+	for (t = 0; t < 16; ++t)
+	{
+		for (i = 0; i < 3; ++i)
+		{
+			mean[i] += block.Texel[t][i];
+			minC[i] = core::min_(minC[i], block.Texel[t][i]);
+			maxC[i] = core::max_(maxC[i], block.Texel[t][i]);
+		}
+	}
+	for (i = 0; i < 3; ++i)
+		mean[i] *= 1.f / 16.f;
+
+	u16 c0, c1;
+	u8 indices[16];
+	if (minC[0] == maxC[0] && minC[1] == maxC[1] && minC[2] == maxC[2])
+	{
+		c0 = c1 = packColor565((f32)minC[0], (f32)minC[1], (f32)minC[2]);
+		for (t = 0; t < 16; ++t)
+			indices[t] = 0;
+	}
+	else
+	{
+		f32 cov[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+		for (t = 0; t < 16; ++t)
+		{
+			const f32 r = block.Texel[t][0] - mean[0];
+			const f32 g = block.Texel[t][1] - mean[1];
+			const f32 b = block.Texel[t][2] - mean[2];
+			cov[0] += r * r;
+			cov[1] += r * g;
+			cov[2] += r * b;
+			cov[3] += g * g;
+			cov[4] += g * b;
+			cov[5] += b * b;
+		}
+		f32 axis[3] = { (f32)(maxC[0] - minC[0]), (f32)(maxC[1] - minC[1]), (f32)(maxC[2] - minC[2]) };
+		for (u32 k = 0; k < 8; ++k)
+		{
+			const f32 x = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2];
+			const f32 y = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4];
+			const f32 z = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+			const f32 len = core::max_(core::abs_(x), core::abs_(y), core::abs_(z));
+			if (len < 1e-6f)
+				break;
+			axis[0] = x / len;
+			axis[1] = y / len;
+			axis[2] = z / len;
+		}
+
+		// texels with the smallest and largest projection, moved a bit inside
+		f32 minP = FLT_MAX, maxP = -FLT_MAX;
+		u32 minT = 0, maxT = 0;
+		for (t = 0; t < 16; ++t)
+		{
+			const f32 p = block.Texel[t][0] * axis[0] + block.Texel[t][1] * axis[1] + block.Texel[t][2] * axis[2];
+			if (p < minP)
+			{
+				minP = p;
+				minT = t;
+			}
+			if (p > maxP)
+			{
+				maxP = p;
+				maxT = t;
+			}
+		}
+		f32 e0[3], e1[3];
+		for (i = 0; i < 3; ++i)
+		{
+			const f32 inset = (block.Texel[maxT][i] - block.Texel[minT][i]) / 16.f;
+			e0[i] = block.Texel[maxT][i] - inset;
+			e1[i] = block.Texel[minT][i] + inset;
+		}
+		c0 = packColor565(e0[0], e0[1], e0[2]);
+		c1 = packColor565(e1[0], e1[1], e1[2]);
+		s32 error = fitColorIndices(block, c0, c1, indices);
+
+		for (u32 k = 0; k < 2 && error > 0; ++k)
+		{
+			u16 r0, r1;
+			u8 refined[16];
+			if (!refineEndpoints(block, indices, r0, r1))
+				break;
+			const s32 refinedError = fitColorIndices(block, r0, r1, refined);
+			if (refinedError >= error)
+				break;
+			c0 = r0;
+			c1 = r1;
+			error = refinedError;
+			memcpy(indices, refined, 16);
+		}
+	}
+
+	// c0 > c1 selects the 4 color mode
+	if (c0 < c1)
+	{
+		core::swap(c0, c1);
+		for (t = 0; t < 16; ++t)
+			indices[t] ^= 1;
+	}
+	else if (c0 == c1)
+	{
+		for (t = 0; t < 16; ++t)
+			indices[t] = 0;
+	}
+
+	u32 bits = 0;
+	for (t = 0; t < 16; ++t)
+		bits |= (u32)indices[t] << (t * 2);
+
+	out[0] = (u8)(c0 & 0xFF);
+	out[1] = (u8)(c0 >> 8);
+	out[2] = (u8)(c1 & 0xFF);
+	out[3] = (u8)(c1 >> 8);
+	out[4] = (u8)(bits & 0xFF);
+	out[5] = (u8)((bits >> 8) & 0xFF);
+	out[6] = (u8)((bits >> 16) & 0xFF);
+	out[7] = (u8)(bits >> 24);
+}
+
+//! finds the nearest entries of an alpha palette, returns the error
+s32 fitAlphaIndices(const SBlock& block, const s32* palette, u8* indices)
+{
+	s32 error = 0;
+	for (u32 t = 0; t < 16; ++t)
+	{
+		s32 best = INT_MAX;
+		for (u8 k = 0; k < 8; ++k)
+		{
+			const s32 e = square(block.Texel[t][3] - palette[k]);
+			if (e < best)
+			{
+				best = e;
+				indices[t] = k;
+			}
+		}
+		error += best;
+	}
+	return error;
+}
+
+//! dxt5 alpha block
+void encodeAlphaBlock(const SBlock& block, u8* out)
+{
+	s32 minA = 255, maxA = 0;
+	s32 innerMin = 255, innerMax = 0;
+	for (u32 t = 0; t < 16; ++t)
+	{
+		const s32 a = block.Texel[t][3];
+		minA = core::min_(minA, a);
+		maxA = core::max_(maxA, a);
+		if (a != 0 && a != 255)
+		{
+			innerMin = core::min_(innerMin, a);
+			innerMax = core::max_(innerMax, a);
+		}
+	}
+
+	s32 palette[8];
+	u8 indices[16];
+	s32 a0 = maxA;
+	s32 a1 = minA;
+
+	if (minA == maxA)
+	{
+		for (u32 t = 0; t < 16; ++t)
+			indices[t] = 0;
+	}
+	else
+	{
+		// 8 alpha values between a0 > a1
+		palette[0] = a0;
+		palette[1] = a1;
+		for (s32 k = 1; k < 7; ++k)
+			palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+		s32 error = fitAlphaIndices(block, palette, indices);
+
+		// 6 alpha values between a0 <= a1, plus 0 and 255
+		if (error > 0 && (minA == 0 || maxA == 255))
+		{
+			const s32 b0 = innerMin <= innerMax ? innerMin : 0;
+			const s32 b1 = innerMin <= innerMax ? innerMax : 255;
+			s32 palette6[8];
+			u8 indices6[16];
+			palette6[0] = b0;
+			palette6[1] = b1;
+			for (s32 k = 1; k < 5; ++k)
+				palette6[k + 1] = ((5 - k) * b0 + k * b1) / 5;
+			palette6[6] = 0;
+			palette6[7] = 255;
+			if (fitAlphaIndices(block, palette6, indices6) < error)
+			{
+				a0 = b0;
+				a1 = b1;
+				memcpy(indices, indices6, 16);
+			}
+		}
+	}
+
+	out[0] = (u8)a0;
+	out[1] = (u8)a1;
+	u64 bits = 0;
+	for (u32 t = 0; t < 16; ++t)
+		bits |= (u64)indices[t] << (t * 3);
+	for (u32 i = 0; i < 6; ++i)
+		out[2 + i] = (u8)(bits >> (i * 8));
+}
+
+// ----- ETC2 -----
+
+//! error of the best modifier table for texels of a sub block with this base color
+s32 fitETCSubBlock(const SBlock& block, const u32* texels, const s32* base, u32& table, u32* indices)
+{
+	s32 bestError = INT_MAX;
+	for (u32 tab = 0; tab < 8; ++tab)
+	{
+		s32 error = 0;
+		u32 modIndex[8];
+		for (u32 j = 0; j < 8 && error < bestError; ++j)
+		{
+			const s32* texel = block.Texel[texels[j]];
+			s32 best = INT_MAX;
+			for (u32 k = 0; k < 4; ++k)
+			{
+				const s32 m = ETCModifiers[tab][k];
+				s32 c[3];
+				c[0] = core::s32_clamp(base[0] + m, 0, 255);
+				c[1] = core::s32_clamp(base[1] + m, 0, 255);
+				c[2] = core::s32_clamp(base[2] + m, 0, 255);
+				const s32 e = colorError(texel, c);
+				if (e < best)
+				{
+					best = e;
+					modIndex[j] = k;
+				}
+			}
+			error += best;
+		}
+		if (error < bestError)
+		{
+			bestError = error;
+			table = tab;
+			memcpy(indices, modIndex, sizeof(modIndex));
+		}
+	}
+	return bestError;
+}
+
+//! etc2 rgb block using the individual and differential modes
+void encodeETCBlock(const SBlock& block, u8* out)
+{
+	u32 bestHeader = 0;
+	u32 bestBits = 0;
+	s32 bestError = INT_MAX;
+
+	for (u32 flip = 0; flip < 2; ++flip)
+	{
+		// texels of both sub blocks, 2x4 side by side or 4x2 on top of each other
+		u32 texels[2][8];
+		u32 count[2] = { 0, 0 };
+		f32 avg[2][3] = { { 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f } };
+		for (u32 t = 0; t < 16; ++t)
+		{
+			const u32 x = t & 3;
+			const u32 y = t >> 2;
+			const u32 sub = flip ? (y >> 1) : (x >> 1);
+			texels[sub][count[sub]++] = t;
+			for (u32 i = 0; i < 3; ++i)
+				avg[sub][i] += block.Texel[t][i] * (1.f / 8.f);
+		}
+
+		for (u32 diff = 0; diff < 2; ++diff)
+		{
+			s32 code[2][3];
+			s32 base[2][3];
+			for (u32 i = 0; i < 3; ++i)
+			{
+				if (diff)
+				{
+					code[0][i] = core::s32_clamp(core::round32(avg[0][i] * (31.f / 255.f)), 0, 31);
+					const s32 c = core::s32_clamp(core::round32(avg[1][i] * (31.f / 255.f)), 0, 31);
+					code[1][i] = code[0][i] + core::s32_clamp(c - code[0][i], -4, 3);
+					base[0][i] = (code[0][i] << 3) | (code[0][i] >> 2);
+					base[1][i] = (code[1][i] << 3) | (code[1][i] >> 2);
+				}
+				else
+				{
+					code[0][i] = core::s32_clamp(core::round32(avg[0][i] * (15.f / 255.f)), 0, 15);
+					code[1][i] = core::s32_clamp(core::round32(avg[1][i] * (15.f / 255.f)), 0, 15);
+					base[0][i] = code[0][i] * 17;
+					base[1][i] = code[1][i] * 17;
+				}
+			}
+
+			u32 table[2];
+			u32 modIndex[2][8];
+			const s32 error = fitETCSubBlock(block, texels[0], base[0], table[0], modIndex[0]) +
+				fitETCSubBlock(block, texels[1], base[1], table[1], modIndex[1]);
+			if (error >= bestError)
+				continue;
+
+			bestError = error;
+			bestHeader = 0;
+			for (u32 i = 0; i < 3; ++i)
+			{
+				const u32 c = diff ? (code[0][i] << 3) | ((code[1][i] - code[0][i]) & 7) :
+					(code[0][i] << 4) | code[1][i];
+				bestHeader |= c << (24 - i * 8);
+			}
+			bestHeader |= (table[0] << 5) | (table[1] << 2) | (diff << 1) | flip;
+
+			// texel x,y is bit x*4+y, msb of the modifier index in the upper half
+			bestBits = 0;
+			for (u32 sub = 0; sub < 2; ++sub)
+			{
+				for (u32 j = 0; j < 8; ++j)
+				{
+					const u32 t = texels[sub][j];
+					const u32 bit = (t & 3) * 4 + (t >> 2);
+					bestBits |= ((modIndex[sub][j] >> 1) << (bit + 16)) | ((modIndex[sub][j] & 1) << bit);
+				}
+			}
+		}
+	}
+
+	for (u32 i = 0; i < 4; ++i)
+	{
+		out[i] = (u8)(bestHeader >> (24 - i * 8));
+		out[4 + i] = (u8)(bestBits >> (24 - i * 8));
+	}
+}
+
+//! error of an eac alpha block
+s32 fitEACIndices(const SBlock& block, s32 base, s32 multiplier, u32 table, s32 bestError, u8* indices)
+{
+	s32 error = 0;
+	for (u32 t = 0; t < 16 && error < bestError; ++t)
+	{
+		s32 best = INT_MAX;
+		for (u8 k = 0; k < 8; ++k)
+		{
+			const s32 e = square(block.Texel[t][3] - core::s32_clamp(base + EACModifiers[table][k] * multiplier, 0, 255));
+			if (e < best)
+			{
+				best = e;
+				indices[t] = k;
+			}
+		}
+		error += best;
+	}
+	return error;
+}
+
+//! etc2 alpha block
+void encodeEACBlock(const SBlock& block, u8* out)
+{
+	s32 minA = 255, maxA = 0;
+	for (u32 t = 0; t < 16; ++t)
+	{
+		minA = core::min_(minA, block.Texel[t][3]);
+		maxA = core::max_(maxA, block.Texel[t][3]);
+	}
+
+	// table 13 has a 0 modifier
+	s32 bestBase = minA;
+	s32 bestMultiplier = 1;
+	u32 bestTable = 13;
+	u8 bestIndices[16];
+	s32 bestError = fitEACIndices(block, minA, 1, 13, INT_MAX, bestIndices);
+
+	u8 indices[16];
+	for (u32 table = 0; table < 16 && bestError > 0; ++table)
+	{
+		const s32 range = EACModifiers[table][7] - EACModifiers[table][3];
+		const s32 m = core::s32_clamp(core::round32((f32)(maxA - minA) / range), 1, 15);
+		for (s32 multiplier = core::s32_max(m - 1, 1); multiplier <= core::s32_min(m + 1, 15); ++multiplier)
+		{
+			// bases which map the smallest, the largest or both values exactly
+			const s32 bases[3] = {
+				minA - EACModifiers[table][3] * multiplier,
+				maxA - EACModifiers[table][7] * multiplier,
+				(minA + maxA + 1) / 2 - (EACModifiers[table][3] + EACModifiers[table][7]) * multiplier / 2
+			};
+			for (u32 b = 0; b < 3; ++b)
+			{
+				const s32 base = core::s32_clamp(bases[b], 0, 255);
+				const s32 error = fitEACIndices(block, base, multiplier, table, bestError, indices);
+				if (error < bestError)
+				{
+					bestError = error;
+					bestBase = base;
+					bestMultiplier = multiplier;
+					bestTable = table;
+					memcpy(bestIndices, indices, 16);
+				}
+			}
+		}
+	}
+
+	// texel x,y is the x*4+y'th 3 bit index, starting at the most significant bits
+	u64 bits = 0;
+	for (u32 t = 0; t < 16; ++t)
+	{
+		const u32 i = (t & 3) * 4 + (t >> 2);
+		bits |= (u64)bestIndices[t] << (45 - i * 3);
+	}
+	out[0] = (u8)bestBase;
+	out[1] = (u8)((bestMultiplier << 4) | bestTable);
+	for (u32 i = 0; i < 6; ++i)
+		out[2 + i] = (u8)(bits >> (40 - i * 8));
+}
+
+} // end anonymous namespace
+
+
+bool CTextureCompressor::canCompress(ECOLOR_FORMAT format)
+{
+	return format == ECF_DXT1 || format == ECF_DXT5 ||
+		format == ECF_ETC2_RGB || format == ECF_ETC2_ARGB;
+}
+
+
+ECOLOR_FORMAT CTextureCompressor::getFormatForImage(const IImage* image, ECOLOR_FORMAT format)
+{
+	if (!image || !canCompress(format) || IImage::isCompressedFormat(image->getColorFormat()))
+		return ECF_UNKNOWN;
+
+	const bool dxt = format == ECF_DXT1 || format == ECF_DXT5;
+	bool alpha = false;
+	switch (image->getColorFormat())
+	{
+	case ECF_A8R8G8B8:
+		{
+			const u8* data = (const u8*)image->getData();
+			const u32 count = image->getDimension().getArea();
+			for (u32 i = 0; i < count && !alpha; ++i)
+				alpha = (((const u32*)data)[i] >> 24) != 0xFF;
+		}
+		break;
+	case ECF_A1R5G5B5:
+		{
+			const u16* data = (const u16*)image->getData();
+			const u32 count = image->getDimension().getArea();
+			for (u32 i = 0; i < count && !alpha; ++i)
+				alpha = (data[i] & 0x8000) == 0;
+		}
+		break;
+	case ECF_R8G8B8:
+	case ECF_R5G6B5:
+		break;
+	default:
+		return ECF_UNKNOWN;
+	}
+
+	if (dxt)
+		return alpha ? ECF_DXT5 : ECF_DXT1;
+	return alpha ? ECF_ETC2_ARGB : ECF_ETC2_RGB;
+}
+
+
+IImage* CTextureCompressor::compress(const IImage* image, ECOLOR_FORMAT format, bool mipMaps)
+{
+	if (!image || !canCompress(format) || IImage::isCompressedFormat(image->getColorFormat()))
+		return 0;
+
+	const core::dimension2du& size = image->getDimension();
+	if (size.getOptimalSize(true, false) != size)
+	{
+		os::Printer::log("Only images with power of two sizes can be compressed.", ELL_WARNING);
+		return 0;
+	}
+
+	// the encoders work on A8R8G8B8
+	CImage* level = new CImage(ECF_A8R8G8B8, size);
+	CColorConverter::convert_viaFormat(image->getData(), image->getColorFormat(), size.getArea(),
+		level->getData(), ECF_A8R8G8B8);
+
+	CImage* result = new CImage(format, size);
+	compressLevel((const u32*)level->getData(), size.Width, size.Height, format, (u8*)result->getData());
+
+	if (mipMaps && (size.Width > 1 || size.Height > 1))
+	{
+		core::array<u8> mipData;
+		CMipMapGenerator generator(level, EMMF_BOX, false);
+		core::dimension2du mipSize = size;
+		while (mipSize.Width > 1 || mipSize.Height > 1)
+		{
+			mipSize = CMipMapGenerator::getHalfSize(mipSize);
+			CImage* next = new CImage(ECF_A8R8G8B8, mipSize);
+			if (!generator.generate(next))
+				level->copyToScalingBoxFilter(next);
+			level->drop();
+			level = next;
+
+			const u32 offset = mipData.size();
+			mipData.set_used(offset + IImage::getDataSizeFromFormat(format, mipSize.Width, mipSize.Height));
+			compressLevel((const u32*)level->getData(), mipSize.Width, mipSize.Height, format, mipData.pointer() + offset);
+		}
+		result->setMipMapsData(mipData.pointer(), false, true);
+	}
+	level->drop();
+
+	return result;
+}
+
+
+void CTextureCompressor::compressLevel(const u32* texels, u32 width, u32 height, ECOLOR_FORMAT format, u8* target)
+{
+	const u32 blockSize = (format == ECF_DXT1 || format == ECF_ETC2_RGB) ? 8 : 16;
+
+	SBlock block;
+	for (u32 by = 0; by < height; by += 4)
+	{
+		for (u32 bx = 0; bx < width; bx += 4, target += blockSize)
+		{
+			// texels outside of the image repeat the border
+			for (u32 t = 0; t < 16; ++t)
+			{
+				const u32 x = core::min_(bx + (t & 3), width - 1);
+				const u32 y = core::min_(by + (t >> 2), height - 1);
+				const u32 c = texels[y * width + x];
+				block.Texel[t][0] = (c >> 16) & 0xFF;
+				block.Texel[t][1] = (c >> 8) & 0xFF;
+				block.Texel[t][2] = c & 0xFF;
+				block.Texel[t][3] = c >> 24;
+			}
+
+			switch (format)
+			{
+			case ECF_DXT1:
+				encodeColorBlock(block, target);
+				break;
+			case ECF_DXT5:
+				encodeAlphaBlock(block, target);
+				encodeColorBlock(block, target + 8);
+				break;
+			case ECF_ETC2_RGB:
+				encodeETCBlock(block, target);
+				break;
+			case ECF_ETC2_ARGB:
+				encodeEACBlock(block, target);
+				encodeETCBlock(block, target + 8);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+} // end namespace video
+} // end namespace irr
+
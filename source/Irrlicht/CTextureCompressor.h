@@ -0,0 +1,52 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_TEXTURE_COMPRESSOR_H_INCLUDED__
+#define __C_TEXTURE_COMPRESSOR_H_INCLUDED__
+
+#include "IImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Encodes images into the block compressed formats DXT1, DXT5, ETC2 and ETC2 with alpha
+/** The encoders aim for a reasonable quality at a speed which is fine for
+caching the results, they are no replacement for offline tools with
+exhaustive searches. ETC2 blocks use only the modes known from ETC1, so
+ECF_ETC2_RGB data can be read by ETC1 decoders as well. */
+class CTextureCompressor
+{
+public:
+
+	//! Returns if images can be compressed into this format
+	static bool canCompress(ECOLOR_FORMAT format);
+
+	//! Returns the format which should be used for image
+	/** \param format: ECF_DXT1 or ECF_DXT5 selects DXT, ECF_ETC2_RGB or
+	ECF_ETC2_ARGB selects ETC2. The format with alpha channel is
+	used only when the image has texels which are not opaque.
+	\return The format or ECF_UNKNOWN if format can't be compressed. */
+	static ECOLOR_FORMAT getFormatForImage(const IImage* image, ECOLOR_FORMAT format);
+
+	//! Creates a compressed copy of image
+	/** \param image: Uncompressed image, width and height must be
+	powers of two.
+	\param format: Format of the copy, see canCompress().
+	\param mipMaps: Create all mip map levels of the copy with a box filter.
+	\return New image, drop it when done, or 0 on errors. */
+	static IImage* compress(const IImage* image, ECOLOR_FORMAT format, bool mipMaps);
+
+	//! Compresses one level of 4x4 blocks
+	/** \param texels: A8R8G8B8 data of width*height texels.
+	\param target: Memory for IImage::getDataSizeFromFormat(format, width, height) bytes. */
+	static void compressLevel(const u32* texels, u32 width, u32 height, ECOLOR_FORMAT format, u8* target);
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -13,9 +13,17 @@ namespace irr
 namespace scene
 {
 
+//! Selectors with less triangles are searched without grid
+const u32 GRID_MIN_TRIANGLES = 64;
+//! Average number of triangles per grid cell
+const u32 GRID_TRIANGLES_PER_CELL = 4;
+//! Maximal number of cells along an axis
+const u32 GRID_MAX_SIZE = 64;
+
 //! constructor
 CTriangleSelector::CTriangleSelector(ISceneNode* node)
-: SceneNode(node), MeshBuffer(0), MaterialIndex(0), AnimatedNode(0), LastMeshFrame(0)
+: SceneNode(node), MeshBuffer(0), MaterialIndex(0), AnimatedNode(0), LastMeshFrame(0), GridValid(false), QueryStamp(0), TransformedStamp(1),
+	NodeTransformationVersion(0), NodeTransformationValid(false), NodeTransformationInvertible(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CTriangleSelector");
@@ -27,7 +35,8 @@ CTriangleSelector::CTriangleSelector(ISceneNode* node)
 
 //! constructor
 CTriangleSelector::CTriangleSelector(const core::aabbox3d<f32>& box, ISceneNode* node)
-: SceneNode(node), MeshBuffer(0), MaterialIndex(0), AnimatedNode(0), LastMeshFrame(0)
+: SceneNode(node), MeshBuffer(0), MaterialIndex(0), AnimatedNode(0), LastMeshFrame(0), GridValid(false), QueryStamp(0), TransformedStamp(1),
+	NodeTransformationVersion(0), NodeTransformationValid(false), NodeTransformationInvertible(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CTriangleSelector");
@@ -40,7 +49,8 @@ CTriangleSelector::CTriangleSelector(const core::aabbox3d<f32>& box, ISceneNode*
 
 //! constructor
 CTriangleSelector::CTriangleSelector(const IMesh* mesh, ISceneNode* node, bool separateMeshbuffers)
-: SceneNode(node), MeshBuffer(0), MaterialIndex(0), AnimatedNode(0), LastMeshFrame(0)
+: SceneNode(node), MeshBuffer(0), MaterialIndex(0), AnimatedNode(0), LastMeshFrame(0), GridValid(false), QueryStamp(0), TransformedStamp(1),
+	NodeTransformationVersion(0), NodeTransformationValid(false), NodeTransformationInvertible(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CTriangleSelector");
@@ -50,7 +60,8 @@ CTriangleSelector::CTriangleSelector(const IMesh* mesh, ISceneNode* node, bool s
 }
 
 CTriangleSelector::CTriangleSelector(const IMeshBuffer* meshBuffer, irr::u32 materialIndex, ISceneNode* node)
-	: SceneNode(node), MeshBuffer(meshBuffer), MaterialIndex(materialIndex), AnimatedNode(0), LastMeshFrame(0)
+	: SceneNode(node), MeshBuffer(meshBuffer), MaterialIndex(materialIndex), AnimatedNode(0), LastMeshFrame(0), GridValid(false), QueryStamp(0), TransformedStamp(1),
+	NodeTransformationVersion(0), NodeTransformationValid(false), NodeTransformationInvertible(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CTriangleSelector");
@@ -60,7 +71,8 @@ CTriangleSelector::CTriangleSelector(const IMeshBuffer* meshBuffer, irr::u32 mat
 }
 
 CTriangleSelector::CTriangleSelector(IAnimatedMeshSceneNode* node, bool separateMeshbuffers)
-: SceneNode(node), AnimatedNode(node), LastMeshFrame(0)
+: SceneNode(node), MeshBuffer(0), MaterialIndex(0), AnimatedNode(node), LastMeshFrame(0), GridValid(false), QueryStamp(0), TransformedStamp(1),
+	NodeTransformationVersion(0), NodeTransformationValid(false), NodeTransformationInvertible(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CTriangleSelector");
@@ -84,6 +96,7 @@ CTriangleSelector::CTriangleSelector(IAnimatedMeshSceneNode* node, bool separate
 void CTriangleSelector::createFromMesh(const IMesh* mesh, bool createBufferRanges)
 {
 	BufferRanges.clear();
+	BufferStates.clear();
 	Triangles.clear();
 
 	const u32 cnt = mesh->getMeshBufferCount();
@@ -105,6 +118,7 @@ void CTriangleSelector::createFromMesh(const IMesh* mesh, bool createBufferRange
 		totalFaceCount += range.RangeSize;
 	}
 	Triangles.set_used(totalFaceCount);
+	BoundingBox.reset(0.f, 0.f, 0.f);
 
 	updateFromMesh(mesh);
 }
@@ -155,11 +169,34 @@ void CTriangleSelector::updateFromMesh(const IMesh* mesh) const
 	bool skinnnedMesh = mesh->getMeshType() == EAMT_SKINNED;
 	u32 meshBuffers = mesh->getMeshBufferCount();
 	u32 triangleCount = 0;
+	bool changed = false;
+
+	if (BufferStates.size() != meshBuffers)
+	{
+		BufferStates.clear();
+		BufferStates.set_used(meshBuffers);
+	}
 
 	for (u32 i = 0; i < meshBuffers; ++i)
 	{
 		IMeshBuffer* buf = mesh->getMeshBuffer(i);
 		u32 idxCnt = buf->getIndexCount();
+
+		// Only read the meshbuffers again which changed since the last update
+		SBufferState& state = BufferStates[i];
+		if (state.MeshBuffer == buf &&
+			state.ChangedID_Vertex == buf->getChangedID_Vertex() &&
+			state.ChangedID_Index == buf->getChangedID_Index() &&
+			(!skinnnedMesh || state.Transformation == ((scene::SSkinMeshBuffer*)buf)->Transformation))
+		{
+			triangleCount += idxCnt / 3;
+			continue;
+		}
+		state.MeshBuffer = buf;
+		state.ChangedID_Vertex = buf->getChangedID_Vertex();
+		state.ChangedID_Index = buf->getChangedID_Index();
+		changed = true;
+
 		u32 vertexPitch = getVertexPitchFromType(buf->getVertexType());
 		u8* vertices = (u8*)buf->getVertices();
 
@@ -167,6 +204,7 @@ void CTriangleSelector::updateFromMesh(const IMesh* mesh) const
 		if ( skinnnedMesh )
 		{
 			bufferTransform = &(((scene::SSkinMeshBuffer*)buf)->Transformation);
+			state.Transformation = *bufferTransform;
 			if ( bufferTransform->isIdentity() )
 				bufferTransform = 0;
 		}
@@ -188,8 +226,12 @@ void CTriangleSelector::updateFromMesh(const IMesh* mesh) const
 		}
 	}
 
-	// Update bounding box
-	updateBoundingBox();
+	if (changed)
+	{
+		// Update bounding box
+		updateBoundingBox();
+		trianglesChanged();
+	}
 }
 
 void CTriangleSelector::updateFromMeshBuffer(const IMeshBuffer* meshBuffer) const
@@ -216,6 +258,9 @@ void CTriangleSelector::updateFromMeshBuffer(const IMeshBuffer* meshBuffer) cons
 		}
 		break;
 	}
+
+	updateBoundingBox();
+	trianglesChanged();
 }
 
 void CTriangleSelector::updateBoundingBox() const
@@ -237,6 +282,224 @@ void CTriangleSelector::updateBoundingBox() const
 	}
 }
 
+void CTriangleSelector::trianglesChanged() const
+{
+	GridValid = false;
+	invalidateTransformedTriangles();
+}
+
+void CTriangleSelector::invalidateTransformedTriangles() const
+{
+	if (++TransformedStamp == 0)
+	{
+		for (u32 i=0; i < TransformedStamps.size(); ++i)
+			TransformedStamps[i] = 0;
+		TransformedStamp = 1;
+	}
+}
+
+//! Returns the cell of the grid along an axis which contains pos
+static inline u32 getGridCell(f32 pos, f32 gridMin, f32 scale, u32 size)
+{
+	const f32 cell = (pos - gridMin) * scale;
+	if (!(cell > 0.f))
+		return 0;
+	if (cell >= (f32)size)
+		return size - 1;
+	return (u32)cell;
+}
+
+void CTriangleSelector::buildGrid() const
+{
+	GridValid = true;
+	GridCells.set_used(0);
+	GridTriangles.set_used(0);
+
+	const u32 cnt = Triangles.size();
+	if (cnt < GRID_MIN_TRIANGLES)
+		return;
+
+	GridBox.reset(Triangles[0].pointA);
+	for (u32 i=0; i < cnt; ++i)
+	{
+		GridBox.addInternalPoint(Triangles[i].pointA);
+		GridBox.addInternalPoint(Triangles[i].pointB);
+		GridBox.addInternalPoint(Triangles[i].pointC);
+	}
+
+	// Split only the axes which are not flat, to get cells with some triangles each
+	const core::vector3df extent = GridBox.getExtent();
+	const f32 extents[3] = { extent.X, extent.Y, extent.Z };
+	const f32 minExtent = core::max_(extent.X, extent.Y, extent.Z) * 0.01f;
+	f32 volume = 1.f;
+	u32 axes = 0;
+	for (u32 a=0; a < 3; ++a)
+	{
+		if (extents[a] > minExtent)
+		{
+			volume *= extents[a];
+			++axes;
+		}
+	}
+	if (!axes)
+		return;
+
+	const f32 cellSize = powf(volume * GRID_TRIANGLES_PER_CELL / cnt, 1.f / axes);
+	f32 scale[3];
+	for (u32 a=0; a < 3; ++a)
+	{
+		GridSize[a] = 1;
+		if (extents[a] > minExtent)
+			GridSize[a] = core::clamp((u32)(extents[a] / cellSize + 0.5f), 1u, GRID_MAX_SIZE);
+		scale[a] = (extents[a] > 0.f) ? GridSize[a] / extents[a] : 0.f;
+	}
+	GridCellScale.set(scale[0], scale[1], scale[2]);
+
+	// Count the triangles per cell, each triangle is added to all cells its box touches
+	const u32 cellCount = GridSize[0] * GridSize[1] * GridSize[2];
+	GridCells.set_used(cellCount + 1);
+	for (u32 c=0; c <= cellCount; ++c)
+		GridCells[c] = 0;
+
+	for (u32 pass=0; pass < 2; ++pass)
+	{
+		for (u32 i=0; i < cnt; ++i)
+		{
+			core::aabbox3df box(Triangles[i].pointA);
+			box.addInternalPoint(Triangles[i].pointB);
+			box.addInternalPoint(Triangles[i].pointC);
+
+			u32 first[3];
+			u32 last[3];
+			getGridCells(box, first, last);
+			for (u32 z=first[2]; z <= last[2]; ++z)
+				for (u32 y=first[1]; y <= last[1]; ++y)
+					for (u32 x=first[0]; x <= last[0]; ++x)
+					{
+						const u32 c = (z * GridSize[1] + y) * GridSize[0] + x;
+						if (pass == 0)
+							++GridCells[c + 1];
+						else
+							GridTriangles[GridCells[c]++] = i;
+					}
+		}
+
+		if (pass == 0)
+		{
+			// Start of each cell
+			for (u32 c=0; c < cellCount; ++c)
+				GridCells[c + 1] += GridCells[c];
+			GridTriangles.set_used(GridCells[cellCount]);
+		}
+		else
+		{
+			// The starts were moved to the ends of the cells while adding
+			for (u32 c=cellCount; c > 0; --c)
+				GridCells[c] = GridCells[c - 1];
+			GridCells[0] = 0;
+		}
+	}
+
+	QueryStamps.set_used(cnt);
+	for (u32 i=0; i < cnt; ++i)
+		QueryStamps[i] = 0;
+	QueryStamp = 0;
+}
+
+void CTriangleSelector::getGridCells(const core::aabbox3df& box, u32* first, u32* last) const
+{
+	first[0] = getGridCell(box.MinEdge.X, GridBox.MinEdge.X, GridCellScale.X, GridSize[0]);
+	first[1] = getGridCell(box.MinEdge.Y, GridBox.MinEdge.Y, GridCellScale.Y, GridSize[1]);
+	first[2] = getGridCell(box.MinEdge.Z, GridBox.MinEdge.Z, GridCellScale.Z, GridSize[2]);
+	last[0] = getGridCell(box.MaxEdge.X, GridBox.MinEdge.X, GridCellScale.X, GridSize[0]);
+	last[1] = getGridCell(box.MaxEdge.Y, GridBox.MinEdge.Y, GridCellScale.Y, GridSize[1]);
+	last[2] = getGridCell(box.MaxEdge.Z, GridBox.MinEdge.Z, GridCellScale.Z, GridSize[2]);
+}
+
+void CTriangleSelector::getGridCandidates(const core::aabbox3df& box) const
+{
+	Candidates.set_used(0);
+
+	if (++QueryStamp == 0)
+	{
+		for (u32 i=0; i < QueryStamps.size(); ++i)
+			QueryStamps[i] = 0;
+		QueryStamp = 1;
+	}
+
+	u32 first[3];
+	u32 last[3];
+	getGridCells(box, first, last);
+	for (u32 z=first[2]; z <= last[2]; ++z)
+		for (u32 y=first[1]; y <= last[1]; ++y)
+			for (u32 x=first[0]; x <= last[0]; ++x)
+			{
+				const u32 c = (z * GridSize[1] + y) * GridSize[0] + x;
+				for (u32 j=GridCells[c]; j < GridCells[c + 1]; ++j)
+				{
+					const u32 i = GridTriangles[j];
+					if (QueryStamps[i] != QueryStamp)
+					{
+						QueryStamps[i] = QueryStamp;
+						Candidates.push_back(i);
+					}
+				}
+			}
+
+	// Same order as without grid, the buffer ranges depend on it
+	Candidates.sort();
+}
+
+void CTriangleSelector::updateNodeTransformation() const
+{
+	const u32 version = SceneNode->getAbsoluteTransformationVersion();
+	if (!NodeTransformationValid || version != NodeTransformationVersion)
+	{
+		NodeTransformationValid = true;
+		NodeTransformationVersion = version;
+		NodeTransformationInvertible = SceneNode->getAbsoluteTransformation().getInverse(InverseNodeTransformation);
+		invalidateTransformedTriangles();
+	}
+}
+
+void CTriangleSelector::updateTransformedTriangles(const core::matrix4* transform) const
+{
+	const core::matrix4& matrix = transform ? *transform : core::IdentityMatrix;
+	if (!(TransformedMatrix == matrix))
+	{
+		TransformedMatrix = matrix;
+		invalidateTransformedTriangles();
+	}
+
+	if (TransformedStamps.size() != Triangles.size())
+	{
+		TransformedTriangles.set_used(Triangles.size());
+		TransformedStamps.set_used(Triangles.size());
+		for (u32 i=0; i < TransformedStamps.size(); ++i)
+			TransformedStamps[i] = 0;
+	}
+}
+
+void CTriangleSelector::getTransformedTriangle(core::triangle3df& out, u32 i, const core::matrix4& mat, bool cached) const
+{
+	if (cached && TransformedStamps[i] == TransformedStamp)
+	{
+		out = TransformedTriangles[i];
+		return;
+	}
+
+	out = Triangles[i];
+	mat.transformVect(out.pointA);
+	mat.transformVect(out.pointB);
+	mat.transformVect(out.pointC);
+
+	if (cached)
+	{
+		TransformedTriangles[i] = out;
+		TransformedStamps[i] = TransformedStamp;
+	}
+}
+
 void CTriangleSelector::update(void) const
 {
 	if (!AnimatedNode)
@@ -278,12 +541,9 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 	if (SceneNode&&useNodeTransform)
 		mat *= SceneNode->getAbsoluteTransformation();
 
-	for (u32 i=0; i<cnt; ++i)
-	{
-		mat.transformVect( triangles[i].pointA, Triangles[i].pointA );
-		mat.transformVect( triangles[i].pointB, Triangles[i].pointB );
-		mat.transformVect( triangles[i].pointC, Triangles[i].pointC );
-	}
+	// the corners of the triangles are one array of vectors
+	if (cnt)
+		mat.transformVects(&triangles[0].pointA, &Triangles[0].pointA, cnt*3);
 
 	if ( outTriangleInfo )
 	{
@@ -338,11 +598,13 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 
 	core::matrix4 mat(core::matrix4::EM4CONST_NOTHING);
 	core::aabbox3df tBox(box);
+	const bool nodeTransform = SceneNode && useNodeTransform;
 
-	if (SceneNode && useNodeTransform)
+	if (nodeTransform)
 	{
-		if ( SceneNode->getAbsoluteTransformation().getInverse(mat) )
-			mat.transformBoxEx(tBox);
+		updateNodeTransformation();
+		if ( NodeTransformationInvertible )
+			InverseNodeTransformation.transformBoxEx(tBox);
 		else
 		{
 			// TODO: else is not yet handled optimally. 
@@ -350,12 +612,13 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 			return getTriangles(triangles, arraySize, outTriangleCount,
 					transform, useNodeTransform, outTriangleInfo );
 		}
+		updateTransformedTriangles(transform);
 	}
 	if (transform)
 		mat = *transform;
 	else
 		mat.makeIdentity();
-	if (SceneNode && useNodeTransform)
+	if (nodeTransform)
 		mat *= SceneNode->getAbsoluteTransformation();
 
 	outTriangleCount = 0;
@@ -363,8 +626,20 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 	if (!tBox.intersectsWithBox(BoundingBox))
 		return;
 
+	// Only the triangles in the grid cells touching the box are checked
+	if (!GridValid)
+		buildGrid();
+
+	const u32* candidates = 0;
+	u32 cnt = Triangles.size();
+	if (!GridCells.empty())
+	{
+		getGridCandidates(tBox);
+		candidates = Candidates.const_pointer();
+		cnt = Candidates.size();
+	}
+
 	s32 triangleCount = 0;
-	const u32 cnt = Triangles.size();
 
 	if ( outTriangleInfo && !BufferRanges.empty() )
 	{
@@ -376,14 +651,16 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 		triRange.MeshBuffer = BufferRanges[activeRange].MeshBuffer;
 		triRange.MaterialIndex = BufferRanges[activeRange].MaterialIndex;
 
-		for (u32 i=0; i<cnt; ++i)
+		for (u32 c=0; c<cnt; ++c)
 		{
+			const u32 i = candidates ? candidates[c] : c;
+
 			// This isn't an accurate test, but it's fast, and the
 			// API contract doesn't guarantee complete accuracy.
 			if (Triangles[i].isTotalOutsideBox(tBox))
 			   continue;
 
-			if ( i >= BufferRanges[activeRange].RangeStart + BufferRanges[activeRange].RangeSize )
+			while ( i >= BufferRanges[activeRange].RangeStart + BufferRanges[activeRange].RangeSize )
 			{
 				triRange.RangeSize = triangleCount-triRange.RangeStart;
 				if ( triRange.RangeSize > 0 )
@@ -395,10 +672,7 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 				triRange.MaterialIndex = BufferRanges[activeRange].MaterialIndex;
 			}
 
-			triangles[triangleCount] = Triangles[i];
-			mat.transformVect(triangles[triangleCount].pointA);
-			mat.transformVect(triangles[triangleCount].pointB);
-			mat.transformVect(triangles[triangleCount].pointC);
+			getTransformedTriangle(triangles[triangleCount], i, mat, nodeTransform);
 
 			++triangleCount;
 
@@ -411,17 +685,16 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 	}
 	else
 	{
-		for (u32 i=0; i<cnt; ++i)
+		for (u32 c=0; c<cnt; ++c)
 		{
+			const u32 i = candidates ? candidates[c] : c;
+
 			// This isn't an accurate test, but it's fast, and the
 			// API contract doesn't guarantee complete accuracy.
 			if (Triangles[i].isTotalOutsideBox(tBox))
 			   continue;
 
-			triangles[triangleCount] = Triangles[i];
-			mat.transformVect(triangles[triangleCount].pointA);
-			mat.transformVect(triangles[triangleCount].pointB);
-			mat.transformVect(triangles[triangleCount].pointC);
+			getTransformedTriangle(triangles[triangleCount], i, mat, nodeTransform);
 
 			++triangleCount;
 
@@ -18,7 +18,10 @@ namespace scene
 class ISceneNode;
 class IAnimatedMeshSceneNode;
 
-//! Stupid triangle selector without optimization
+//! Triangle selector which keeps all triangles in an array
+/** Box and line queries use a uniform grid over the triangles, and the
+triangles which were transformed by the scene node are cached until the
+absolute transformation of the node changes. */
 class CTriangleSelector : public ITriangleSelector
 {
 public:
@@ -86,6 +89,30 @@ protected:
 	//! Update bounding box from triangles
 	void updateBoundingBox() const;
 
+	//! Has to be called when Triangles changed, invalidates the grid and the transformed triangles
+	void trianglesChanged() const;
+
+	//! Marks all cached transformed triangles as invalid
+	void invalidateTransformedTriangles() const;
+
+	//! Builds the grid over Triangles for box queries
+	void buildGrid() const;
+
+	//! Returns the range of grid cells which touch the box
+	void getGridCells(const core::aabbox3df& box, u32* first, u32* last) const;
+
+	//! Collects the sorted indices of all triangles in the grid cells which touch the box
+	void getGridCandidates(const core::aabbox3df& box) const;
+
+	//! Updates the inverse node transformation when the absolute transformation of the node changed
+	void updateNodeTransformation() const;
+
+	//! Checks if the cached transformed triangles are still valid for the transformation
+	void updateTransformedTriangles(const core::matrix4* transform) const;
+
+	//! Returns triangle i transformed by mat, from the cache if possible
+	void getTransformedTriangle(core::triangle3df& out, u32 i, const core::matrix4& mat, bool cached) const;
+
 	//! Update the triangle selector, which will only have an effect if it
 	//! was built from an animated mesh and that mesh's frame has changed
 	//! since the last time it was updated.
@@ -101,6 +128,43 @@ protected:
 	irr::u32 MaterialIndex;		// Only set when MeshBuffer is non-zero
 	IAnimatedMeshSceneNode* AnimatedNode;
 	mutable u32 LastMeshFrame;
+
+	//! State of a meshbuffer when its triangles were read, to skip unchanged meshbuffers in update()
+	struct SBufferState
+	{
+		SBufferState() : MeshBuffer(0), ChangedID_Vertex(0), ChangedID_Index(0) {}
+
+		const IMeshBuffer* MeshBuffer;
+		u32 ChangedID_Vertex;
+		u32 ChangedID_Index;
+		core::matrix4 Transformation;
+	};
+	mutable core::array<SBufferState> BufferStates;
+
+	// Uniform grid over Triangles. GridCells holds the start of each cell in GridTriangles.
+	mutable core::array<u32> GridCells;
+	mutable core::array<u32> GridTriangles;
+	mutable core::aabbox3df GridBox;
+	mutable core::vector3df GridCellScale;
+	mutable u32 GridSize[3];
+	mutable bool GridValid;
+
+	// Candidates of the last box query, QueryStamps marks the triangles already added
+	mutable core::array<u32> Candidates;
+	mutable core::array<u32> QueryStamps;
+	mutable u32 QueryStamp;
+
+	// Triangles transformed by the node, valid when the entry in TransformedStamps equals TransformedStamp
+	mutable core::array<core::triangle3df> TransformedTriangles;
+	mutable core::array<u32> TransformedStamps;
+	mutable u32 TransformedStamp;
+	mutable core::matrix4 TransformedMatrix;
+	mutable u32 NodeTransformationVersion;
+	mutable bool NodeTransformationValid;
+
+	// Inverse of the absolute transformation of the node with version NodeTransformationVersion
+	mutable core::matrix4 InverseNodeTransformation;
+	mutable bool NodeTransformationInvertible;
 };
 
 } // end namespace scene
@@ -16,6 +16,8 @@
 #include "IVideoDriver.h"
 #include "IFileSystem.h"
 #include "IReadFile.h"
+#include "EProfileIDs.h"
+#include "IProfiler.h"
 
 #ifdef _DEBUG
 #define _XREADER_DEBUG
@@ -55,6 +57,7 @@ bool CXMeshFileLoader::isALoadableFileExtension(const io::path& filename) const
 //! See IReferenceCounted::drop() for more information.
 IAnimatedMesh* CXMeshFileLoader::createMesh(io::IReadFile* file)
 {
+	IRR_PROFILE(CProfileScope p1(EPID_ML_X);)
 	if (!file)
 		return 0;
 
@@ -484,14 +487,14 @@ bool CXMeshFileLoader::parseFile()
 //! Parses the next Data object in the file
 bool CXMeshFileLoader::parseDataObject()
 {
-	core::stringc objectName = getNextToken();
+	SXToken objectName = getNextToken();
 
-	if (objectName.size() == 0)
+	if (objectName.empty())
 		return false;
 
 	// parse specific object
 #ifdef _XREADER_DEBUG
-	os::Printer::log("debug DataObject:", objectName.c_str(), ELL_DEBUG);
+	os::Printer::log("debug DataObject:", objectName.str().c_str(), ELL_DEBUG);
 #endif
 
 	if (objectName == "template")
@@ -529,7 +532,7 @@ bool CXMeshFileLoader::parseDataObject()
 	{
 		// template materials now available thanks to joeWright
 		TemplateMaterials.push_back(SXTemplateMaterial());
-		TemplateMaterials.getLast().Name = getNextToken();
+		TemplateMaterials.getLast().Name = getNextToken().str();
 		return parseDataObjectMaterial(TemplateMaterials.getLast().Material);
 	}
 	else
@@ -539,7 +542,7 @@ bool CXMeshFileLoader::parseDataObject()
 		return true;
 	}
 
-	os::Printer::log("Unknown data object in animation of .x file", objectName.c_str(), ELL_WARNING);
+	os::Printer::log("Unknown data object in animation of .x file", objectName.str().c_str(), ELL_WARNING);
 
 	return parseUnknownDataObject();
 }
@@ -568,12 +571,12 @@ bool CXMeshFileLoader::parseDataObjectTemplate()
 	// read and ignore data members
 	while(true)
 	{
-		core::stringc s = getNextToken();
+		const SXToken s = getNextToken();
 
 		if (s == "}")
 			break;
 
-		if (s.size() == 0)
+		if (s.empty())
 			return false;
 	}
 
@@ -642,13 +645,13 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in frame:", objectName.c_str(), ELL_DEBUG);
+		os::Printer::log("debug DataObject in frame:", objectName.str().c_str(), ELL_DEBUG);
 #endif
 
-		if (objectName.size() == 0)
+		if (objectName.empty())
 		{
 			os::Printer::log("Unexpected ending found in Frame in x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -695,7 +698,7 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in frame in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in frame in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -800,8 +803,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			mesh.Indices.set_used(mesh.Indices.size() + ((triangles-1)*3));
 			mesh.IndexCountPerFace[k] = (u16)(triangles * 3);
 
-			for (u32 f=0; f<fcnt; ++f)
-				polygonfaces[f] = readInt();
+			readInts(polygonfaces.pointer(), fcnt);
 
 			for (u32 jk=0; jk<triangles; ++jk)
 			{
@@ -814,9 +816,8 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			mesh.Indices[currentIndex++] = readInt();
-			mesh.Indices[currentIndex++] = readInt();
-			mesh.Indices[currentIndex++] = readInt();
+			readInts(&mesh.Indices[currentIndex], 3);
+			currentIndex += 3;
 			mesh.IndexCountPerFace[k] = 3;
 		}
 	}
@@ -831,9 +832,9 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.empty())
 		{
 			os::Printer::log("Unexpected ending found in Mesh in x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -846,7 +847,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in mesh:", objectName.c_str(), ELL_DEBUG);
+		os::Printer::log("debug DataObject in mesh:", objectName.str().c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName == "MeshNormals")
@@ -1089,7 +1090,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in mesh in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in mesh in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1249,8 +1250,8 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 	normals.set_used(nNormals);
 
 	// read normals
-	for (u32 i=0; i<nNormals; ++i)
-		readVector3(normals[i]);
+	if (nNormals)
+		readFloats(&normals[0].X, nNormals*3);
 
 	if (!checkForTwoFollowingSemicolons())
 	{
@@ -1292,8 +1293,7 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 		{
 			polygonfaces.set_used(fcnt);
 			// multiple triangles in this face
-			for (u32 h=0; h<fcnt; ++h)
-				polygonfaces[h] = readInt();
+			readInts(polygonfaces.pointer(), fcnt);
 
 			for (u32 jk=0; jk<triangles; ++jk)
 			{
@@ -1450,9 +1450,9 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.empty())
 		{
 			os::Printer::log("Unexpected ending found in Mesh Material list in .x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1469,7 +1469,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 			// template materials now available thanks to joeWright
 			objectName = getNextToken();
 			for (u32 i=0; i<TemplateMaterials.size(); ++i)
-				if (TemplateMaterials[i].Name == objectName)
+				if (objectName == TemplateMaterials[i].Name)
 					mesh.Materials.push_back(TemplateMaterials[i].Material);
 			getNextToken(); // skip }
 		}
@@ -1487,7 +1487,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material list in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in material list in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1525,9 +1525,9 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 	int textureLayer=0;
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.empty())
 		{
 			os::Printer::log("Unexpected ending found in Mesh Material in .x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1567,7 +1567,7 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material in .x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in material in .x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1595,9 +1595,9 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.empty())
 		{
 			os::Printer::log("Unexpected ending found in Animation set in x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1616,7 +1616,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation set in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation set in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1679,9 +1679,9 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.empty())
 		{
 			os::Printer::log("Unexpected ending found in Animation in x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1709,7 +1709,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		if (objectName == "{")
 		{
 			// read frame name
-			FrameName = getNextToken();
+			FrameName = getNextToken().str();
 
 			if (!checkForClosingBrace())
 			{
@@ -1720,7 +1720,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1829,10 +1829,8 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 					return false;
 				}
 
-				f32 W = -readFloat();
-				f32 X = -readFloat();
-				f32 Y = -readFloat();
-				f32 Z = -readFloat();
+				f32 wxyz[4];
+				readFloats(wxyz, 4);
 
 				if (!checkForTwoFollowingSemicolons())
 				{
@@ -1842,7 +1840,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 
 				ISkinnedMesh::SRotationKey *key=AnimatedMesh->addRotationKey(joint);
 				key->frame=time;
-				key->rotation.set(X,Y,Z,W);
+				key->rotation.set(-wxyz[1],-wxyz[2],-wxyz[3],-wxyz[0]);
 				key->rotation.normalize();
 			}
 			break;
@@ -1988,9 +1986,9 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 	// find opening delimiter
 	while(true)
 	{
-		core::stringc t = getNextToken();
+		const SXToken t = getNextToken();
 
-		if (t.size() == 0)
+		if (t.empty())
 			return false;
 
 		if (t == "{")
@@ -2003,9 +2001,9 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 
 	while(counter)
 	{
-		core::stringc t = getNextToken();
+		const SXToken t = getNextToken();
 
-		if (t.size() == 0)
+		if (t.empty())
 			return false;
 
 		if (t == "{")
@@ -2066,11 +2064,11 @@ bool CXMeshFileLoader::checkForTwoFollowingSemicolons()
 //! if there is one
 bool CXMeshFileLoader::readHeadOfDataObject(core::stringc* outname)
 {
-	core::stringc nameOrBrace = getNextToken();
+	const SXToken nameOrBrace = getNextToken();
 	if (nameOrBrace != "{")
 	{
 		if (outname)
-			(*outname) = nameOrBrace;
+			(*outname) = nameOrBrace.str();
 
 		if (getNextToken() != "{")
 			return false;
@@ -2080,11 +2078,9 @@ bool CXMeshFileLoader::readHeadOfDataObject(core::stringc* outname)
 }
 
 
-//! returns next parseable token. Returns empty string if no token there
-core::stringc CXMeshFileLoader::getNextToken()
+//! returns next parseable token. Returns empty token if no token there
+CXMeshFileLoader::SXToken CXMeshFileLoader::getNextToken()
 {
-	core::stringc s;
-
 	// process binary-formatted file
 	if (BinaryFormat)
 	{
@@ -2098,82 +2094,86 @@ core::stringc CXMeshFileLoader::getNextToken()
 		switch (tok) {
 			case 1:
 				// name token
-				len = readBinDWord();
-				s = core::stringc(P, len);
-				P += len;
-				return s;
+				{
+					len = readBinDWord();
+					const SXToken s(P, len);
+					P += len;
+					return s;
+				}
 			case 2:
 				// string token
-				len = readBinDWord();
-				s = core::stringc(P, len);
-				P += (len + 2);
-				return s;
+				{
+					len = readBinDWord();
+					const SXToken s(P, len);
+					P += (len + 2);
+					return s;
+				}
 			case 3:
 				// integer token
 				P += 4;
-				return "<integer>";
+				return SXToken("<integer>");
 			case 5:
 				// GUID token
 				P += 16;
-				return "<guid>";
+				return SXToken("<guid>");
 			case 6:
 				len = readBinDWord();
 				P += (len * 4);
-				return "<int_list>";
+				return SXToken("<int_list>");
 			case 7:
 				len = readBinDWord();
 				P += (len * FloatSize);
-				return "<flt_list>";
+				return SXToken("<flt_list>");
 			case 0x0a:
-				return "{";
+				return SXToken("{");
 			case 0x0b:
-				return "}";
+				return SXToken("}");
 			case 0x0c:
-				return "(";
+				return SXToken("(");
 			case 0x0d:
-				return ")";
+				return SXToken(")");
 			case 0x0e:
-				return "[";
+				return SXToken("[");
 			case 0x0f:
-				return "]";
+				return SXToken("]");
 			case 0x10:
-				return "<";
+				return SXToken("<");
 			case 0x11:
-				return ">";
+				return SXToken(">");
 			case 0x12:
-				return ".";
+				return SXToken(".");
 			case 0x13:
-				return ",";
+				return SXToken(",");
 			case 0x14:
-				return ";";
+				return SXToken(";");
 			case 0x1f:
-				return "template";
+				return SXToken("template");
 			case 0x28:
-				return "WORD";
+				return SXToken("WORD");
 			case 0x29:
-				return "DWORD";
+				return SXToken("DWORD");
 			case 0x2a:
-				return "FLOAT";
+				return SXToken("FLOAT");
 			case 0x2b:
-				return "DOUBLE";
+				return SXToken("DOUBLE");
 			case 0x2c:
-				return "CHAR";
+				return SXToken("CHAR");
 			case 0x2d:
-				return "UCHAR";
+				return SXToken("UCHAR");
 			case 0x2e:
-				return "SWORD";
+				return SXToken("SWORD");
 			case 0x2f:
-				return "SDWORD";
+				return SXToken("SDWORD");
 			case 0x30:
-				return "void";
+				return SXToken("void");
 			case 0x31:
-				return "string";
+				return SXToken("string");
 			case 0x32:
-				return "unicode";
+				return SXToken("unicode");
 			case 0x33:
-				return "cstring";
+				return SXToken("cstring");
 			case 0x34:
-				return "array";
+				return SXToken("array");
 		}
 	}
 	// process text-formatted file
@@ -2182,25 +2182,23 @@ core::stringc CXMeshFileLoader::getNextToken()
 		findNextNoneWhiteSpace();
 
 		if (P >= End)
-			return s;
+			return SXToken();
 
+		const c8* start = P;
 		while((P < End) && !core::isspace(P[0]))
 		{
 			// either keep token delimiters when already holding a token, or return if first valid char
 			if (P[0]==';' || P[0]=='}' || P[0]=='{' || P[0]==',')
 			{
-				if (!s.size())
-				{
-					s.append(P[0]);
+				if (P == start)
 					++P;
-				}
 				break; // stop for delimiter
 			}
-			s.append(P[0]);
 			++P;
 		}
+		return SXToken(start, (u32)(P - start));
 	}
-	return s;
+	return SXToken();
 }
 
 
@@ -2256,7 +2254,7 @@ bool CXMeshFileLoader::getNextTokenAsString(core::stringc& out)
 {
 	if (BinaryFormat)
 	{
-		out=getNextToken();
+		out=getNextToken().str();
 		return true;
 	}
 	findNextNoneWhiteSpace();
@@ -2268,11 +2266,10 @@ bool CXMeshFileLoader::getNextTokenAsString(core::stringc& out)
 		return false;
 	++P;
 
+	const c8* start = P;
 	while(P < End && P[0]!='"')
-	{
-		out.append(P[0]);
 		++P;
-	}
+	out += core::stringc(start, (u32)(P - start));
 
 	if ( P[1] != ';' || P[0] != '"')
 		return false;
@@ -2397,11 +2394,46 @@ f32 CXMeshFileLoader::readFloat()
 }
 
 
+//! reads count integers, which may span several lists
+void CXMeshFileLoader::readInts(u32* out, u32 count)
+{
+	if (BinaryFormat)
+	{
+		for (u32 i=0; i<count; ++i)
+			out[i] = readInt();
+		return;
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		findNextNoneWhiteSpaceNumber();
+		out[i] = core::strtoul10(P, &P);
+	}
+}
+
+
+//! reads count floats, which may span several vectors
+void CXMeshFileLoader::readFloats(f32* out, u32 count)
+{
+	if (BinaryFormat)
+	{
+		for (u32 i=0; i<count; ++i)
+			out[i] = readFloat();
+		return;
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		findNextNoneWhiteSpaceNumber();
+		P = core::fast_atof_move(P, out[i]);
+	}
+}
+
+
 // read 2-dimensional vector. Stops at semicolon after second value for text file format
 bool CXMeshFileLoader::readVector2(core::vector2df& vec)
 {
-	vec.X = readFloat();
-	vec.Y = readFloat();
+	readFloats(&vec.X, 2);
 	return true;
 }
 
@@ -2409,9 +2441,7 @@ bool CXMeshFileLoader::readVector2(core::vector2df& vec)
 // read 3-dimensional vector. Stops at semicolon after third value for text file format
 bool CXMeshFileLoader::readVector3(core::vector3df& vec)
 {
-	vec.X = readFloat();
-	vec.Y = readFloat();
-	vec.Z = readFloat();
+	readFloats(&vec.X, 3);
 	return true;
 }
 
@@ -2420,9 +2450,7 @@ bool CXMeshFileLoader::readVector3(core::vector3df& vec)
 bool CXMeshFileLoader::readRGB(video::SColor& color)
 {
 	video::SColorf tmpColor;
-	tmpColor.r = readFloat();
-	tmpColor.g = readFloat();
-	tmpColor.b = readFloat();
+	readFloats(&tmpColor.r, 3);
 	color = tmpColor.toSColor();
 	return checkForOneFollowingSemicolons();
 }
@@ -2432,10 +2460,7 @@ bool CXMeshFileLoader::readRGB(video::SColor& color)
 bool CXMeshFileLoader::readRGBA(video::SColor& color)
 {
 	video::SColorf tmpColor;
-	tmpColor.r = readFloat();
-	tmpColor.g = readFloat();
-	tmpColor.b = readFloat();
-	tmpColor.a = readFloat();
+	readFloats(&tmpColor.r, 4);
 	color = tmpColor.toSColor();
 	return checkForOneFollowingSemicolons();
 }
@@ -2444,8 +2469,7 @@ bool CXMeshFileLoader::readRGBA(video::SColor& color)
 // read matrix from list of floats
 bool CXMeshFileLoader::readMatrix(core::matrix4& mat)
 {
-	for (u32 i=0; i<16; ++i)
-		mat[i] = readFloat();
+	readFloats(mat.pointer(), 16);
 	return checkForOneFollowingSemicolons();
 }
 
@@ -39,6 +39,9 @@ public:
 	//! See IReferenceCounted::drop() for more information.
 	virtual IAnimatedMesh* createMesh(io::IReadFile* file) _IRR_OVERRIDE_;
 
+	//! Only gets textures from the video driver
+	virtual bool isThreadSafe() const _IRR_OVERRIDE_ { return true; }
+
 	struct SXTemplateMaterial
 	{
 		core::stringc Name; // template name from Xfile
@@ -86,6 +89,53 @@ public:
 
 private:
 
+	//! A token pointing into the file buffer, which is not zero terminated
+	struct SXToken
+	{
+		SXToken() : Text(""), Length(0) {}
+		SXToken(const c8* text, u32 length) : Text(text), Length(length) {}
+		explicit SXToken(const c8* text) : Text(text), Length((u32)strlen(text)) {}
+
+		bool empty() const
+		{
+			return Length == 0;
+		}
+
+		bool operator==(const c8* str) const
+		{
+			return strlen(str) == Length && !memcmp(Text, str, Length);
+		}
+
+		bool operator!=(const c8* str) const
+		{
+			return !(*this == str);
+		}
+
+		bool operator==(const core::stringc& str) const
+		{
+			return str.size() == Length && !memcmp(Text, str.c_str(), Length);
+		}
+
+		bool equals_ignore_case(const c8* str) const
+		{
+			if (strlen(str) != Length)
+				return false;
+			for (u32 i=0; i<Length; ++i)
+				if (core::locale_lower(Text[i]) != core::locale_lower(str[i]))
+					return false;
+			return true;
+		}
+
+		//! copies the token into a string
+		core::stringc str() const
+		{
+			return core::stringc(Text, Length);
+		}
+
+		const c8* Text;
+		u32 Length;
+	};
+
 	bool load(io::IReadFile* file);
 
 	bool readFileIntoMemory(io::IReadFile* file);
@@ -135,8 +185,8 @@ private:
 	// and ignores comments
 	void findNextNoneWhiteSpaceNumber();
 
-	//! returns next parseable token. Returns empty string if no token there
-	core::stringc getNextToken();
+	//! returns next parseable token. Returns empty token if no token there
+	SXToken getNextToken();
 
 	//! reads header of dataobject including the opening brace.
 	//! returns false if error happened, and writes name of object
@@ -161,6 +211,8 @@ private:
 	u32 readBinDWord();
 	u32 readInt();
 	f32 readFloat();
+	void readInts(u32* out, u32 count);
+	void readFloats(f32* out, u32 count);
 	bool readVector2(core::vector2df& vec);
 	bool readVector3(core::vector3df& vec);
 	bool readMatrix(core::matrix4& mat);
@@ -25,6 +25,7 @@ namespace irr
 		EPID_SM_RENDER_SHADOWS,
 		EPID_SM_RENDER_TRANSPARENT,
 		EPID_SM_RENDER_EFFECT,
+		EPID_SM_RENDER_GUI_NODES,
 		EPID_SM_REGISTER,
 
 		//! octrees
@@ -46,7 +47,64 @@ namespace irr
 		EPID_ES2_SET_RENDERSTATE_3D,
 		EPID_ES2_SET_RENDERSTATE_BASIC,
 		EPID_ES2_SET_RENDERSTATE_TEXTURE,
-		EPID_ES2_DRAW_SHADOW
+		EPID_ES2_DRAW_SHADOW,
+
+		//! mesh loaders
+		EPID_ML_3DS,
+		EPID_ML_B3D,
+		EPID_ML_BSP,
+		EPID_ML_COLLADA,
+		EPID_ML_CSM,
+		EPID_ML_DMF,
+		EPID_ML_HALFLIFE,
+		EPID_ML_IRR_MESH,
+		EPID_ML_IRR_BIN_MESH,
+		EPID_ML_LMTS,
+		EPID_ML_LWO,
+		EPID_ML_MD2,
+		EPID_ML_MD3,
+		EPID_ML_MS3D,
+		EPID_ML_MY3D,
+		EPID_ML_OBJ,
+		EPID_ML_OCT,
+		EPID_ML_OGRE,
+		EPID_ML_PLY,
+		EPID_ML_SMF,
+		EPID_ML_STL,
+		EPID_ML_X,
+
+		//! image loaders
+		EPID_IL_BMP,
+		EPID_IL_DDS,
+		EPID_IL_JPG,
+		EPID_IL_PCX,
+		EPID_IL_PNG,
+		EPID_IL_PPM,
+		EPID_IL_PSD,
+		EPID_IL_PVR,
+		EPID_IL_RGB,
+		EPID_IL_TGA,
+		EPID_IL_WAL,
+
+		//! collision manager
+		EPID_CM_NODE_FROM_RAY_BB,
+		EPID_CM_NODE_AND_POINT_FROM_RAY,
+		EPID_CM_COLLISION_POINT,
+		EPID_CM_COLLISION_RESPONSE,
+
+		//! animation
+		EPID_AM_ANIMATE_MESH,
+		EPID_AM_SKIN_MESH,
+		EPID_AM_PARTICLES,
+
+		//! burnings video driver, the stages of drawVertexPrimitiveList follow each other
+		EPID_BV_DRAW_PRIMITIVES,
+		EPID_BV_TRANSFORM,
+		EPID_BV_CLIP,
+		EPID_BV_SETUP,
+		EPID_BV_RASTER,
+		EPID_BV_CLEAR,
+		EPID_BV_PRESENT
     };
 #endif
 } // end namespace irr
@@ -10,6 +10,12 @@
 #include "aabbox3d.h"
 #include "irrArray.h"
 #include "CMeshBuffer.h"
+#include "IJobSystem.h"
+#include "IFileSystem.h"
+#include "IReadFile.h"
+#include "IWriteFile.h"
+#include "irrHash.h"
+#include "os.h"
 
 /**
 	Flags for Octree
@@ -20,6 +26,85 @@
 namespace irr
 {
 
+//! Header of the files in the octree cache, see scene::OCTREE_CACHE_DIRECTORY
+struct SOctreeCacheHeader
+{
+	c8 Magic[4];
+	u32 Version;
+	u64 Hash;
+	u32 NodeCount;
+	u32 Padding;
+};
+
+static const c8 OCTREE_CACHE_MAGIC[4] = { 'I', 'O', 'C', 'T' };
+static const u32 OCTREE_CACHE_VERSION = 2;
+
+//! Deepest node which is read from the octree cache, deeper trees are built again
+static const u32 OCTREE_CACHE_MAX_DEPTH = 64;
+
+//! Returns the name of the file in the octree cache for a hash
+inline io::path getOctreeCacheName(const io::path& directory, u64 hash)
+{
+	c8 buf[32];
+	snprintf_irr(buf, sizeof(buf), "%08x%08x.octree", (u32)(hash >> 32), (u32)hash);
+	if (directory.size() && directory.lastChar() != '/' && directory.lastChar() != '\\')
+		return directory + "/" + buf;
+	return directory + buf;
+}
+
+//! Opens the file of the octree cache for a hash
+/** \return The file positioned after the header and the node count of the
+tree in it, or 0 when there is no file with a valid header. */
+inline io::IReadFile* openOctreeCache(io::IFileSystem* fileSystem,
+	const io::path& directory, u64 hash, u32& nodeCount)
+{
+	if (!fileSystem || directory.empty())
+		return 0;
+
+	const io::path name = getOctreeCacheName(directory, hash);
+	if (!fileSystem->existFile(name))
+		return 0;
+
+	io::IReadFile* file = fileSystem->createAndOpenFile(name);
+	if (!file)
+		return 0;
+
+	SOctreeCacheHeader header;
+	if (file->read(&header, sizeof(header)) != sizeof(header) ||
+		memcmp(header.Magic, OCTREE_CACHE_MAGIC, 4) != 0 ||
+		header.Version != OCTREE_CACHE_VERSION || header.Hash != hash)
+	{
+		file->drop();
+		return 0;
+	}
+	nodeCount = header.NodeCount;
+	return file;
+}
+
+//! Creates the file of the octree cache for a hash and writes its header
+inline io::IWriteFile* createOctreeCache(io::IFileSystem* fileSystem,
+	const io::path& directory, u64 hash, u32 nodeCount)
+{
+	if (!fileSystem || directory.empty())
+		return 0;
+
+	io::IWriteFile* file = fileSystem->createAndWriteFile(getOctreeCacheName(directory, hash));
+	if (!file)
+	{
+		os::Printer::log("Could not write to octree cache", directory, ELL_WARNING);
+		return 0;
+	}
+
+	SOctreeCacheHeader header;
+	memcpy(header.Magic, OCTREE_CACHE_MAGIC, 4);
+	header.Version = OCTREE_CACHE_VERSION;
+	header.Hash = hash;
+	header.NodeCount = nodeCount;
+	header.Padding = 0;
+	file->write(&header, sizeof(header));
+	return file;
+}
+
 //! template octree.
 /** T must be a vertex type which has a member
 called .Pos, which is a core::vertex3df position. */
@@ -66,10 +151,13 @@ public:
 
 
 	//! Constructor
-	Octree(const core::array<SMeshChunk>& meshes, s32 minimalPolysPerNode=128) :
+	/** \param jobs When not 0, the children of the upper nodes are built
+	in parallel. The tree is the same as without jobs. */
+	Octree(const core::array<SMeshChunk>& meshes, s32 minimalPolysPerNode=128,
+		IJobSystem* jobs=0) :
 		IndexData(0), IndexDataCount(meshes.size()), NodeCount(0)
 	{
-		IndexData = new SIndexData[IndexDataCount];
+		createIndexData(meshes);
 
 		// construct array of all indices
 
@@ -77,10 +165,6 @@ public:
 		indexChunks->reallocate(meshes.size());
 		for (u32 i=0; i!=meshes.size(); ++i)
 		{
-			IndexData[i].CurrentSize = 0;
-			IndexData[i].MaxSize = meshes[i].Indices.size();
-			IndexData[i].Indices = new u16[IndexData[i].MaxSize];
-
 			indexChunks->push_back(SIndexChunk());
 			SIndexChunk& tic = indexChunks->getLast();
 
@@ -88,8 +172,72 @@ public:
 			tic.Indices = meshes[i].Indices;
 		}
 
+		if (jobs && jobs->getThreadCount() < 2)
+			jobs = 0;
+
 		// create tree
-		Root = new OctreeNode(NodeCount, 0, meshes, indexChunks, minimalPolysPerNode);
+		Root = new OctreeNode(NodeCount, 0, meshes, indexChunks, minimalPolysPerNode, jobs);
+	}
+
+	//! Constructor which reads the tree written by write()
+	/** The file has to be written for the same meshes. Use isValid() to
+	find out if the tree could be read. */
+	Octree(const core::array<SMeshChunk>& meshes, io::IReadFile* file) :
+		Root(0), IndexData(0), IndexDataCount(meshes.size()), NodeCount(0)
+	{
+		createIndexData(meshes);
+
+		// each index has to be in exactly one node
+		core::array<u32> indexCount;
+		indexCount.set_used(meshes.size());
+		for (u32 i=0; i!=meshes.size(); ++i)
+			indexCount[i] = 0;
+
+		bool valid = true;
+		Root = new OctreeNode(NodeCount, 0, meshes, file, indexCount, valid);
+
+		for (u32 i=0; valid && i!=meshes.size(); ++i)
+			valid = indexCount[i] == meshes[i].Indices.size();
+
+		if (!valid)
+		{
+			delete Root;
+			Root = 0;
+		}
+	}
+
+	//! Returns false when the tree could not be read from a file
+	bool isValid() const
+	{
+		return Root != 0;
+	}
+
+	//! Writes the nodes of the tree, the meshes are not written
+	void write(io::IWriteFile* file) const
+	{
+		if (Root)
+			Root->write(file, IndexDataCount);
+	}
+
+	//! Returns a hash of the vertices and indices of the meshes and of the settings
+	/** Used as name of the tree in the octree cache. */
+	static u64 getCacheHash(const core::array<SMeshChunk>& meshes, s32 minimalPolysPerNode)
+	{
+		const u32 settings[] = {
+			OCTREE_CACHE_VERSION,
+			sizeof(T),
+			(u32)minimalPolysPerNode,
+			meshes.size()
+		};
+		u64 hash = os::hash(settings, sizeof(settings));
+		for (u32 i=0; i!=meshes.size(); ++i)
+		{
+			hash = os::hash(meshes[i].Vertices.const_pointer(),
+				meshes[i].Vertices.size() * sizeof(T), hash);
+			hash = os::hash(meshes[i].Indices.const_pointer(),
+				meshes[i].Indices.size() * sizeof(u16), hash);
+		}
+		return hash;
 	}
 
 	//! returns all ids of polygons partially or fully enclosed
@@ -145,6 +293,18 @@ public:
 	}
 
 private:
+
+	void createIndexData(const core::array<SMeshChunk>& meshes)
+	{
+		IndexData = new SIndexData[IndexDataCount];
+		for (u32 i=0; i!=meshes.size(); ++i)
+		{
+			IndexData[i].CurrentSize = 0;
+			IndexData[i].MaxSize = meshes[i].Indices.size();
+			IndexData[i].Indices = new u16[IndexData[i].MaxSize];
+		}
+	}
+
 	// private inner class
 	class OctreeNode
 	{
@@ -154,7 +314,7 @@ private:
 		OctreeNode(u32& nodeCount, u32 currentdepth,
 			const core::array<SMeshChunk>& allmeshdata,
 			core::array<SIndexChunk>* indices,
-			s32 minimalPolysPerNode) : IndexData(0),
+			s32 minimalPolysPerNode, IJobSystem* jobs) : IndexData(0),
 			Depth(currentdepth+1)
 		{
 			++nodeCount;
@@ -207,6 +367,7 @@ private:
 			// calculate all children
 			core::aabbox3d<f32> box;
 			core::array<u16> keepIndices;
+			SChildrenData children;
 
 			if (totalPrimitives > minimalPolysPerNode && !Box.isEmpty())
 			for (u32 ch=0; ch!=8; ++ch)
@@ -250,14 +411,81 @@ private:
 				}
 
 				if (added)
-					Children[ch] = new OctreeNode(nodeCount, Depth,
-						allmeshdata, cindexChunks, minimalPolysPerNode);
+				{
+					children.Child[children.Count] = ch;
+					children.Indices[children.Count] = cindexChunks;
+					++children.Count;
+				}
 				else
 					delete cindexChunks;
 
 			} // end for all possible children
 
 			IndexData = indices;
+
+			// the children are only created after the indices of all of them
+			// are known, so the upper ones can be created in parallel
+			children.Node = this;
+			children.Meshes = &allmeshdata;
+			children.MinimalPolysPerNode = minimalPolysPerNode;
+			children.Jobs = (jobs && Depth < 3) ? jobs : 0;
+			if (children.Count > 1 && children.Jobs)
+				jobs->parallelFor(createChildren, &children, children.Count, 1);
+			else
+				createChildren(&children, 0, children.Count);
+
+			for (i=0; i!=children.Count; ++i)
+				nodeCount += children.NodeCount[i];
+		}
+
+		// constructor which reads the node written by write()
+		OctreeNode(u32& nodeCount, u32 currentdepth,
+			const core::array<SMeshChunk>& allmeshdata, io::IReadFile* file,
+			core::array<u32>& indexCount, bool& valid) : IndexData(0),
+			Depth(currentdepth+1)
+		{
+			++nodeCount;
+
+			u32 i;
+			for (i=0; i!=8; ++i)
+				Children[i] = 0;
+
+			u32 childMask = 0;
+			if (file->read(&Box, sizeof(Box)) != sizeof(Box) ||
+				file->read(&childMask, sizeof(childMask)) != sizeof(childMask) ||
+				childMask > 0xff || (childMask && Depth >= OCTREE_CACHE_MAX_DEPTH))
+			{
+				valid = false;
+				return;
+			}
+
+			IndexData = new core::array<SIndexChunk>;
+			IndexData->reallocate(allmeshdata.size());
+			for (i=0; valid && i!=allmeshdata.size(); ++i)
+			{
+				IndexData->push_back(SIndexChunk());
+				SIndexChunk& tic = IndexData->getLast();
+				tic.MaterialId = allmeshdata[i].MaterialId;
+
+				u32 count = 0;
+				valid = file->read(&count, sizeof(count)) == sizeof(count) &&
+					count % 3 == 0 && count <= allmeshdata[i].Indices.size() - indexCount[i];
+				if (!valid || !count)
+					continue;
+
+				tic.Indices.set_used(count);
+				valid = file->read(tic.Indices.pointer(), count * sizeof(u16)) == (size_t)(count * sizeof(u16));
+				const u32 vertexCount = allmeshdata[i].Vertices.size();
+				for (u32 j=0; valid && j!=count; ++j)
+					valid = tic.Indices[j] < vertexCount;
+				indexCount[i] += count;
+			}
+
+			for (i=0; valid && i!=8; ++i)
+			{
+				if (childMask & (1 << i))
+					Children[i] = new OctreeNode(nodeCount, Depth, allmeshdata, file, indexCount, valid);
+			}
 		}
 
 		// destructor
@@ -355,6 +583,34 @@ private:
 					Children[i]->getPolys(frustum, idxdata,parentTest);
 		}
 
+		// writes the node and its children
+		void write(io::IWriteFile* file, u32 chunkCount) const
+		{
+			u32 childMask = 0;
+			u32 i;
+			for (i=0; i!=8; ++i)
+			{
+				if (Children[i])
+					childMask |= 1 << i;
+			}
+			file->write(&Box, sizeof(Box));
+			file->write(&childMask, sizeof(childMask));
+
+			for (i=0; i!=chunkCount; ++i)
+			{
+				const u32 count = IndexData ? (*IndexData)[i].Indices.size() : 0;
+				file->write(&count, sizeof(count));
+				if (count)
+					file->write((*IndexData)[i].Indices.const_pointer(), count * sizeof(u16));
+			}
+
+			for (i=0; i!=8; ++i)
+			{
+				if (Children[i])
+					Children[i]->write(file, chunkCount);
+			}
+		}
+
 		//! for debug purposes only, collects the bounding boxes of the node
 		void getBoundingBoxes(const core::aabbox3d<f32>& box,
 			core::array< const core::aabbox3d<f32>* >&outBoxes) const
@@ -371,6 +627,33 @@ private:
 
 	private:
 
+		// the children which are created after the indices are split
+		struct SChildrenData
+		{
+			SChildrenData() : Count(0) {}
+
+			OctreeNode* Node;
+			const core::array<SMeshChunk>* Meshes;
+			core::array<SIndexChunk>* Indices[8];
+			u32 Child[8];
+			u32 NodeCount[8];
+			u32 Count;
+			s32 MinimalPolysPerNode;
+			IJobSystem* Jobs;
+		};
+
+		static void createChildren(void* data, u32 begin, u32 end)
+		{
+			SChildrenData& children = *(SChildrenData*)data;
+			for (u32 i=begin; i<end; ++i)
+			{
+				children.NodeCount[i] = 0;
+				children.Node->Children[children.Child[i]] = new OctreeNode(children.NodeCount[i],
+					children.Node->Depth, *children.Meshes, children.Indices[i],
+					children.MinimalPolysPerNode, children.Jobs);
+			}
+		}
+
 		core::aabbox3df Box;
 		core::array<SIndexChunk>* IndexData;
 		OctreeNode* Children[8];
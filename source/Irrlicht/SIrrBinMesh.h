@@ -0,0 +1,173 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_IRR_BIN_MESH_H_INCLUDED__
+#define __S_IRR_BIN_MESH_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace scene
+{
+
+/*
+	Cooked binary meshes (.irrbinmesh)
+
+	Contains the mesh buffers and materials of a mesh, and for skinned
+	meshes the joints and animation keys, in the layout the engine uses in
+	memory. Loading a file copies each stream with one read into the arrays
+	of the mesh, nothing is parsed or converted per vertex. All numbers are
+	32 bit little endian values, only 16 bit indices are 16 bit values.
+
+	file:
+		header          SIrrBinMeshHeader
+		string table    StringCount times: u32 length, length bytes, terminating 0
+		materials       MaterialCount times SIrrBinMeshMaterial, each followed by
+		                LayerCount times SIrrBinMeshMaterialLayer
+		buffers         BufferCount times SIrrBinMeshBuffer
+		joints          JointCount times SIrrBinMeshJoint
+		streams         the arrays the buffers and joints point to, each one
+		                starting at an offset aligned to IRRBINMESH_ALIGNMENT
+
+	streams:
+		vertices        VertexCount times video::S3DVertex, S3DVertex2TCoords
+		                or S3DVertexTangents, depending on the VertexType
+		indices         IndexCount times u16 or u32, depending on the IndexType
+		attached meshes AttachedMeshCount times u32 buffer index
+		position keys   PositionKeyCount times f32 frame, 3 f32 position
+		scale keys      ScaleKeyCount times f32 frame, 3 f32 scale
+		rotation keys   RotationKeyCount times f32 frame, 4 f32 x y z w
+		weights         WeightCount times u32 buffer, u32 vertex, f32 strength
+
+	All offsets are counted from the start of the header.
+*/
+
+//! Magic number at the start of cooked mesh files
+const c8 IRRBINMESH_MAGIC[4] = { 'I', 'R', 'B', 'M' };
+
+//! Version written into new files. Loaders accept versions up to this one.
+const u32 IRRBINMESH_VERSION = 1;
+
+//! Alignment of the streams in the file
+const u32 IRRBINMESH_ALIGNMENT = 16;
+
+//! Returns the offset moved up to the next multiple of IRRBINMESH_ALIGNMENT
+inline u32 alignIrrBinMeshOffset(u32 offset)
+{
+	return (offset + IRRBINMESH_ALIGNMENT - 1) & ~(IRRBINMESH_ALIGNMENT - 1);
+}
+
+//! Marks a missing string or joint
+const u32 IRRBINMESH_NO_INDEX = 0xffffffff;
+
+//! Flags in the header of cooked mesh files
+enum E_IRRBINMESH_FLAGS
+{
+	//! The mesh is a skinned mesh with joints
+	EIBMF_SKINNED = 0x1
+};
+
+//! Header at the start of cooked mesh files
+struct SIrrBinMeshHeader
+{
+	c8 Magic[4];
+	u32 Version;
+	u32 Flags;
+	f32 AnimationSpeed;
+	f32 BoundingBox[6];
+	u32 StringTableOffset;
+	u32 StringTableSize;
+	u32 StringCount;
+	u32 MaterialOffset;
+	u32 MaterialCount;
+	u32 BufferOffset;
+	u32 BufferCount;
+	u32 JointOffset;
+	u32 JointCount;
+};
+
+//! Material of cooked mesh files
+/** The flags are the E_MATERIAL_FLAG values of the boolean material flags. */
+struct SIrrBinMeshMaterial
+{
+	u32 MaterialType;
+	u32 AmbientColor;
+	u32 DiffuseColor;
+	u32 EmissiveColor;
+	u32 SpecularColor;
+	f32 Shininess;
+	f32 MaterialTypeParam;
+	f32 MaterialTypeParam2;
+	f32 Thickness;
+	u32 ZBuffer;
+	u32 AntiAliasing;
+	u32 ColorMask;
+	u32 ColorMaterial;
+	u32 BlendOperation;
+	f32 BlendFactor;
+	u32 PolygonOffsetFactor;
+	u32 PolygonOffsetDirection;
+	f32 PolygonOffsetDepthBias;
+	f32 PolygonOffsetSlopeScale;
+	u32 ZWriteEnable;
+	u32 Flags;
+	u32 LayerCount;
+};
+
+//! Texture layer of a material in cooked mesh files
+struct SIrrBinMeshMaterialLayer
+{
+	u32 Texture;		// string index of the texture name, IRRBINMESH_NO_INDEX for none
+	u32 TextureWrapU;
+	u32 TextureWrapV;
+	u32 TextureWrapW;
+	u32 BilinearFilter;
+	u32 TrilinearFilter;
+	u32 AnisotropicFilter;
+	s32 LODBias;
+	f32 TextureMatrix[16];
+};
+
+//! Mesh buffer of cooked mesh files
+struct SIrrBinMeshBuffer
+{
+	u32 VertexType;
+	u32 IndexType;
+	u32 PrimitiveType;
+	u32 Material;
+	u32 MappingHintVertex;
+	u32 MappingHintIndex;
+	u32 VertexCount;
+	u32 VertexOffset;
+	u32 IndexCount;
+	u32 IndexOffset;
+	f32 BoundingBox[6];
+	f32 Transformation[16];
+};
+
+//! Joint of skinned meshes in cooked mesh files
+struct SIrrBinMeshJoint
+{
+	u32 Name;
+	u32 Parent;			// joint index, IRRBINMESH_NO_INDEX for root joints
+	f32 LocalMatrix[16];
+	f32 GlobalInversedMatrix[16];
+	u32 AttachedMeshCount;
+	u32 AttachedMeshOffset;
+	u32 PositionKeyCount;
+	u32 PositionKeyOffset;
+	u32 ScaleKeyCount;
+	u32 ScaleKeyOffset;
+	u32 RotationKeyCount;
+	u32 RotationKeyOffset;
+	u32 WeightCount;
+	u32 WeightOffset;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
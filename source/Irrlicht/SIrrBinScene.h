@@ -0,0 +1,110 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_IRR_BIN_SCENE_H_INCLUDED__
+#define __S_IRR_BIN_SCENE_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace scene
+{
+
+/*
+	Binary scene files (.irrbin)
+
+	Contains the same data as an .irr file, but the attributes are stored
+	with their binary values and all strings are kept once in a string table.
+	All numbers are 32 bit little endian values.
+
+	file:
+		header          SIrrBinSceneHeader
+		string table    StringCount times: u32 length, length bytes, terminating 0
+		resource table  ResourceCount times: u32 E_IRRBIN_RESOURCE_TYPE, u32 string index of the path
+		nodes           NodesSize bytes with one node record for the scene, empty when nothing was saved
+
+	node record:
+		u32 string index of the node type name, IRRBIN_NO_INDEX for the scene itself
+		attribute list of the node
+		u32 material count, followed by one attribute list per material
+		u32 animator count, followed by one attribute list per animator
+		u32 1 when an attribute list with user data follows, else 0
+		u32 child count, followed by one node record per child
+
+	attribute list:
+		u32 attribute count, followed for each attribute by
+		u32 E_IRRBIN_ATTRIBUTE_TYPE, u32 string index of the name, value as listed below
+*/
+
+//! Magic number at the start of binary scene files
+const c8 IRRBIN_MAGIC[4] = { 'I', 'R', 'R', 'S' };
+
+//! Version written into new files. Loaders accept versions up to this one.
+const u32 IRRBIN_VERSION = 1;
+
+//! Marks a missing string or resource
+const u32 IRRBIN_NO_INDEX = 0xffffffff;
+
+//! Deepest node record which is loaded, files with deeper nodes are corrupt
+const u32 IRRBIN_MAX_DEPTH = 1024;
+
+//! Header at the start of binary scene files
+struct SIrrBinSceneHeader
+{
+	c8 Magic[4];
+	u32 Version;
+	u32 StringTableOffset;
+	u32 StringCount;
+	u32 ResourceTableOffset;
+	u32 ResourceCount;
+	u32 NodesOffset;
+	u32 NodesSize;
+};
+
+//! Attribute types in binary scene files.
+/** The values are part of the file format and must not change. */
+enum E_IRRBIN_ATTRIBUTE_TYPE
+{
+	EIBA_INT = 0,		// s32
+	EIBA_FLOAT,			// f32
+	EIBA_STRING,		// string index
+	EIBA_BOOL,			// u32, 0 or 1
+	EIBA_ENUM,			// string index of the value
+	EIBA_COLOR,			// u32 A8R8G8B8
+	EIBA_COLORF,		// 4 f32, r g b a
+	EIBA_VECTOR3D,		// 3 f32
+	EIBA_POSITION2D,	// 2 s32
+	EIBA_VECTOR2D,		// 2 f32
+	EIBA_RECT,			// 4 s32, upper left x y, lower right x y
+	EIBA_MATRIX,		// 16 f32
+	EIBA_QUATERNION,	// 4 f32, x y z w
+	EIBA_BBOX,			// 6 f32, min edge, max edge
+	EIBA_PLANE,			// 4 f32, normal, d
+	EIBA_TRIANGLE3D,	// 9 f32, three points
+	EIBA_LINE2D,		// 4 f32, start, end
+	EIBA_LINE3D,		// 6 f32, start, end
+	EIBA_STRINGWARRAY,	// u32 count, count string indices
+	EIBA_BINARY,		// string index of the data in hex
+	EIBA_TEXTURE,		// resource index, IRRBIN_NO_INDEX for no texture
+	EIBA_DIMENSION2D,	// 2 u32
+	EIBA_MESH,			// resource index of a mesh, loaded as string attribute
+
+	EIBA_COUNT
+};
+
+//! Types of entries in the resource table
+enum E_IRRBIN_RESOURCE_TYPE
+{
+	EIBR_TEXTURE = 0,
+	EIBR_MESH,
+
+	EIBR_COUNT
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,136 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_ATOMIC_H_INCLUDED__
+#define __IRR_ATOMIC_H_INCLUDED__
+
+#include "irrTypes.h"
+#include "os.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//! Storage class of variables which exist once per thread
+#if defined(_MSC_VER)
+#define _IRR_THREAD_LOCAL __declspec(thread)
+#else
+#define _IRR_THREAD_LOCAL __thread
+#endif
+
+namespace irr
+{
+namespace os
+{
+	//! Adds value to target, returns the new value
+	inline s32 atomicAdd(volatile s32* target, s32 value)
+	{
+#if defined(_MSC_VER)
+		return _InterlockedExchangeAdd((volatile long*)target, value) + value;
+#else
+		return __sync_add_and_fetch(target, value);
+#endif
+	}
+
+	//! Sets target to exchange if it still is comparand, returns true when it did
+	inline bool atomicCompareExchange(volatile s32* target, s32 exchange, s32 comparand)
+	{
+#if defined(_MSC_VER)
+		return _InterlockedCompareExchange((volatile long*)target, exchange, comparand) == comparand;
+#else
+		return __sync_bool_compare_and_swap(target, comparand, exchange);
+#endif
+	}
+
+	//! Sets target to exchange if it still is comparand, returns true when it did
+	inline bool atomicCompareExchange(volatile u64* target, u64 exchange, u64 comparand)
+	{
+#if defined(_MSC_VER)
+		return (u64)_InterlockedCompareExchange64((volatile __int64*)target, (__int64)exchange, (__int64)comparand) == comparand;
+#else
+		return __sync_bool_compare_and_swap(target, comparand, exchange);
+#endif
+	}
+
+	//! Sets target to exchange if it still is comparand, returns true when it did
+	inline bool atomicCompareExchange(void* volatile* target, void* exchange, void* comparand)
+	{
+#if defined(_MSC_VER)
+		return _InterlockedCompareExchangePointer(target, exchange, comparand) == comparand;
+#else
+		return __sync_bool_compare_and_swap(target, comparand, exchange);
+#endif
+	}
+
+	//! Sets target to value, returns the old value
+	inline s32 atomicExchange(volatile s32* target, s32 value)
+	{
+#if defined(_MSC_VER)
+		return _InterlockedExchange((volatile long*)target, value);
+#else
+		s32 old = *target;
+		while (!__sync_bool_compare_and_swap(target, old, value))
+			old = *target;
+		return old;
+#endif
+	}
+
+	//! Sets target to value, returns the old value
+	inline void* atomicExchange(void* volatile* target, void* value)
+	{
+#if defined(_MSC_VER)
+		return _InterlockedExchangePointer(target, value);
+#else
+		void* old = *target;
+		while (!atomicCompareExchange(target, value, old))
+			old = *target;
+		return old;
+#endif
+	}
+
+	//! Adds value to target, also on 32 bit systems
+	inline void atomicAdd(volatile u64* target, u64 value)
+	{
+		u64 old = *target;
+		while (!atomicCompareExchange(target, old + value, old))
+			old = *target;
+	}
+
+	//! Raises target to value if it is smaller
+	inline void atomicMax(volatile u64* target, u64 value)
+	{
+		u64 old = *target;
+		while (old < value && !atomicCompareExchange(target, value, old))
+			old = *target;
+	}
+
+	//! Memory accesses before the barrier are visible to other threads before those after it
+	inline void memoryBarrier()
+	{
+#if defined(_MSC_VER)
+		long dummy = 0;
+		_InterlockedExchange(&dummy, 0);
+#else
+		__sync_synchronize();
+#endif
+	}
+
+	//! Takes a lock which is only held for a few instructions, lets other threads run while it waits
+	inline void spinLock(volatile s32* lock)
+	{
+		while (atomicExchange(lock, 1))
+			Thread::yield();
+	}
+
+	//! Releases a lock taken with spinLock
+	inline void spinUnlock(volatile s32* lock)
+	{
+		atomicExchange(lock, 0);
+	}
+
+} // end namespace os
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,48 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_HASH_H_INCLUDED__
+#define __IRR_HASH_H_INCLUDED__
+
+#include "irrTypes.h"
+#include <string.h>
+
+namespace irr
+{
+namespace os
+{
+	//! 64 bit hash of some memory, used to find data in the caches on disk
+	/** The files of the caches are named after it, so changing it
+	invalidates all caches. Chain calls with seed to hash several blocks. */
+	inline u64 hash(const void* data, size_t size, u64 seed=0)
+	{
+		const u64 prime = 0x100000001B3ULL;
+		const u64 mix = 0x9E3779B97F4A7C15ULL;
+
+		u64 h = (seed ^ 0xCBF29CE484222325ULL) ^ ((u64)size * mix);
+		const u8* p = (const u8*)data;
+		const u8* end = p + (size & ~(size_t)7);
+		for (; p != end; p += 8)
+		{
+			u64 word;
+			memcpy(&word, p, 8);
+			word *= mix;
+			h = (h ^ word ^ (word >> 32)) * prime;
+		}
+		for (size_t i = 0; i < (size & 7); ++i)
+			h = (h ^ p[i]) * prime;
+
+		// final avalanche
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDULL;
+		h ^= h >> 33;
+		h *= 0xC4CEB9FE1A85EC53ULL;
+		h ^= h >> 33;
+		return h;
+	}
+
+} // end namespace os
+} // end namespace irr
+
+#endif
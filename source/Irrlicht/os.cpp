@@ -146,6 +146,21 @@ namespace os
 		return GetTickCount();
 	}
 
+	u64 Timer::getRealTimeNanoseconds()
+	{
+		// no affinity workaround like in getRealTime, it costs far more than the profiled code
+		static LARGE_INTEGER frequency = { 0 };
+		LARGE_INTEGER nTime;
+		if (!frequency.QuadPart && !QueryPerformanceFrequency(&frequency))
+			frequency.QuadPart = -1;
+		if (frequency.QuadPart < 0 || !QueryPerformanceCounter(&nTime))
+			return (u64)GetTickCount() * 1000000;
+
+		const u64 seconds = nTime.QuadPart / frequency.QuadPart;
+		const u64 rest = nTime.QuadPart % frequency.QuadPart;
+		return seconds * 1000000000 + rest * 1000000000 / frequency.QuadPart;
+	}
+
 } // end namespace os
 
 
@@ -156,6 +171,7 @@ namespace os
 // ----------------------------------------------------------------
 
 #include <android/log.h>
+#include <time.h>
 
 namespace irr
 {
@@ -210,6 +226,13 @@ namespace os
 		gettimeofday(&tv, 0);
 		return (u32)(tv.tv_sec * 1000) + (tv.tv_usec / 1000);
 	}
+
+	u64 Timer::getRealTimeNanoseconds()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
 } // end namespace os
 
 #elif defined(_IRR_EMSCRIPTEN_PLATFORM_)
@@ -262,6 +285,11 @@ namespace os
         double time = emscripten_get_now();
         return (u32)(time);
 	}
+
+	u64 Timer::getRealTimeNanoseconds()
+	{
+		return (u64)(emscripten_get_now() * 1000000.0);
+	}
 } // end namespace os
 
 #else
@@ -296,6 +324,13 @@ namespace os
 		gettimeofday(&tv, 0);
 		return (u32)(tv.tv_sec * 1000) + (tv.tv_usec / 1000);
 	}
+
+	u64 Timer::getRealTimeNanoseconds()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
 } // end namespace os
 
 #endif // end linux / emscripten / android / windows
@@ -305,30 +340,6 @@ namespace os
 	// The platform independent implementation of the printer
 	ILogger* Printer::Logger = 0;
 
-	void Printer::log(const c8* message, ELOG_LEVEL ll)
-	{
-		if (Logger)
-			Logger->log(message, ll);
-	}
-
-	void Printer::log(const wchar_t* message, ELOG_LEVEL ll)
-	{
-		if (Logger)
-			Logger->log(message, ll);
-	}
-
-	void Printer::log(const c8* message, const c8* hint, ELOG_LEVEL ll)
-	{
-		if (Logger)
-			Logger->log(message, hint, ll);
-	}
-
-	void Printer::log(const c8* message, const io::path& hint, ELOG_LEVEL ll)
-	{
-		if (Logger)
-			Logger->log(message, hint.c_str(), ll);
-	}
-
 	// our Randomizer is not really os specific, so we
 	// code one for all, which should work on every platform the same,
 	// which is desirable.
@@ -486,3 +497,171 @@ namespace os
 } // end namespace irr
 
 
+
+
+// ----------------------------------------------------------------
+// threads
+// ----------------------------------------------------------------
+
+#if !defined(_IRR_WINDOWS_API_)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace irr
+{
+namespace os
+{
+namespace
+{
+	struct SThreadStart
+	{
+		Thread::Function Func;
+		void* Data;
+	};
+
+#if defined(_IRR_WINDOWS_API_)
+	DWORD WINAPI threadStart(LPVOID param)
+#else
+	void* threadStart(void* param)
+#endif
+	{
+		const SThreadStart start = *(SThreadStart*)param;
+		delete (SThreadStart*)param;
+		start.Func(start.Data);
+		return 0;
+	}
+
+#if !defined(_IRR_WINDOWS_API_)
+	struct SSemaphore
+	{
+		pthread_mutex_t Mutex;
+		pthread_cond_t Condition;
+		u32 Count;
+	};
+#endif
+}
+
+	Thread::Thread() : Handle(0)
+	{
+	}
+
+	Thread::~Thread()
+	{
+		join();
+	}
+
+	bool Thread::start(Function function, void* data)
+	{
+		if (Handle)
+			return false;
+
+		SThreadStart* start = new SThreadStart;
+		start->Func = function;
+		start->Data = data;
+#if defined(_IRR_WINDOWS_API_)
+		Handle = CreateThread(0, 0, threadStart, start, 0, 0);
+#else
+		pthread_t* thread = new pthread_t;
+		if (pthread_create(thread, 0, threadStart, start) == 0)
+			Handle = thread;
+		else
+			delete thread;
+#endif
+		if (!Handle)
+			delete start;
+		return Handle != 0;
+	}
+
+	void Thread::join()
+	{
+		if (!Handle)
+			return;
+#if defined(_IRR_WINDOWS_API_)
+		WaitForSingleObject((HANDLE)Handle, INFINITE);
+		CloseHandle((HANDLE)Handle);
+#else
+		pthread_join(*(pthread_t*)Handle, 0);
+		delete (pthread_t*)Handle;
+#endif
+		Handle = 0;
+	}
+
+	u32 Thread::getProcessorCount()
+	{
+#if defined(_IRR_XBOX_PLATFORM_)
+		return 1;
+#elif defined(_IRR_WINDOWS_API_)
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return core::max_((u32)info.dwNumberOfProcessors, 1u);
+#else
+		const long count = sysconf(_SC_NPROCESSORS_ONLN);
+		return count > 0 ? (u32)count : 1;
+#endif
+	}
+
+	void Thread::yield()
+	{
+#if defined(_IRR_WINDOWS_API_)
+		Sleep(0);
+#else
+		sched_yield();
+#endif
+	}
+
+	Semaphore::Semaphore()
+	{
+#if defined(_IRR_WINDOWS_API_)
+		Handle = CreateSemaphore(0, 0, 0x7fffffff, 0);
+#else
+		SSemaphore* semaphore = new SSemaphore;
+		pthread_mutex_init(&semaphore->Mutex, 0);
+		pthread_cond_init(&semaphore->Condition, 0);
+		semaphore->Count = 0;
+		Handle = semaphore;
+#endif
+	}
+
+	Semaphore::~Semaphore()
+	{
+#if defined(_IRR_WINDOWS_API_)
+		CloseHandle((HANDLE)Handle);
+#else
+		SSemaphore* semaphore = (SSemaphore*)Handle;
+		pthread_cond_destroy(&semaphore->Condition);
+		pthread_mutex_destroy(&semaphore->Mutex);
+		delete semaphore;
+#endif
+	}
+
+	void Semaphore::post()
+	{
+#if defined(_IRR_WINDOWS_API_)
+		ReleaseSemaphore((HANDLE)Handle, 1, 0);
+#else
+		SSemaphore* semaphore = (SSemaphore*)Handle;
+		pthread_mutex_lock(&semaphore->Mutex);
+		++semaphore->Count;
+		pthread_cond_signal(&semaphore->Condition);
+		pthread_mutex_unlock(&semaphore->Mutex);
+#endif
+	}
+
+	void Semaphore::wait()
+	{
+#if defined(_IRR_WINDOWS_API_)
+		WaitForSingleObject((HANDLE)Handle, INFINITE);
+#else
+		SSemaphore* semaphore = (SSemaphore*)Handle;
+		pthread_mutex_lock(&semaphore->Mutex);
+		while (semaphore->Count == 0)
+			pthread_cond_wait(&semaphore->Condition, &semaphore->Mutex);
+		--semaphore->Count;
+		pthread_mutex_unlock(&semaphore->Mutex);
+#endif
+	}
+
+} // end namespace os
+} // end namespace irr
@@ -37,13 +37,84 @@ namespace os
 	public:
 		// prints out a string to the console out stdout or debug log or whatever
 		static void print(const c8* message, ELOG_LEVEL ll = ELL_INFORMATION);
-		static void log(const c8* message, ELOG_LEVEL ll = ELL_INFORMATION);
-		static void log(const wchar_t* message, ELOG_LEVEL ll = ELL_INFORMATION);
-		static void log(const c8* message, const c8* hint, ELOG_LEVEL ll = ELL_INFORMATION);
-		static void log(const c8* message, const io::path& hint, ELOG_LEVEL ll = ELL_INFORMATION);
+
+		// messages below _IRR_COMPILE_LOG_LEVEL_ are removed by the compiler
+		static void log(const c8* message, ELOG_LEVEL ll = ELL_INFORMATION)
+		{
+			if (ll >= _IRR_COMPILE_LOG_LEVEL_ && Logger)
+				Logger->log(message, ll);
+		}
+		static void log(const wchar_t* message, ELOG_LEVEL ll = ELL_INFORMATION)
+		{
+			if (ll >= _IRR_COMPILE_LOG_LEVEL_ && Logger)
+				Logger->log(message, ll);
+		}
+		static void log(const c8* message, const c8* hint, ELOG_LEVEL ll = ELL_INFORMATION)
+		{
+			if (ll >= _IRR_COMPILE_LOG_LEVEL_ && Logger)
+				Logger->log(message, hint, ll);
+		}
+		static void log(const c8* message, const io::path& hint, ELOG_LEVEL ll = ELL_INFORMATION)
+		{
+			if (ll >= _IRR_COMPILE_LOG_LEVEL_ && Logger)
+				Logger->log(message, hint.c_str(), ll);
+		}
 		static ILogger* Logger;
 	};
 
+	//! Runs a function in a thread of its own
+	class Thread
+	{
+	public:
+		typedef void (*Function)(void* data);
+
+		Thread();
+
+		//! Waits until the function returned
+		~Thread();
+
+		//! Starts the function, returns false when no thread could be created
+		bool start(Function function, void* data);
+
+		//! Waits until the function returned
+		void join();
+
+		//! Returns true from start until join
+		bool isRunning() const { return Handle != 0; }
+
+		//! Returns how many threads the processors can run at the same time
+		static u32 getProcessorCount();
+
+		//! Lets the system run other threads before the calling one continues
+		static void yield();
+
+	private:
+		Thread(const Thread&);
+		Thread& operator=(const Thread&);
+
+		void* Handle;
+	};
+
+	//! Counting semaphore which lets threads sleep until others post it
+	class Semaphore
+	{
+	public:
+		Semaphore();
+		~Semaphore();
+
+		//! Increments the count and wakes up a waiting thread
+		void post();
+
+		//! Sleeps until the count is above zero and decrements it
+		void wait();
+
+	private:
+		Semaphore(const Semaphore&);
+		Semaphore& operator=(const Semaphore&);
+
+		void* Handle;
+	};
+
 
 	// congruential pseudo-random generator
 	// numbers identical to std::minstd_rand0
@@ -115,6 +186,9 @@ namespace os
 		//! returns the current real time in milliseconds
 		static u32 getRealTime();
 
+		//! returns a monotonic time in nanoseconds, only differences between calls are meaningful
+		static u64 getRealTimeNanoseconds();
+
 	private:
 
 		static void initVirtualTimer();
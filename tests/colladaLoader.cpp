@@ -0,0 +1,157 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! A quad and a triangle in a polylist, with some whitespace around the numbers
+const c8 polylistScene[] =
+	"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+	"<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+	"<library_geometries>\n"
+	" <geometry id=\"shape\"><mesh>\n"
+	"  <source id=\"pos\">\n"
+	"   <float_array id=\"pos-array\" count=\"15\">\n"
+	"     0 0 0  1 0 0  1 1 0  0 1 0\n"
+	"     2 0.5 0\n"
+	"   </float_array>\n"
+	"   <technique_common><accessor source=\"#pos-array\" count=\"5\" stride=\"3\">\n"
+	"    <param name=\"X\" type=\"float\"/><param name=\"Y\" type=\"float\"/><param name=\"Z\" type=\"float\"/>\n"
+	"   </accessor></technique_common>\n"
+	"  </source>\n"
+	"  <vertices id=\"verts\"><input semantic=\"POSITION\" source=\"#pos\"/></vertices>\n"
+	"  <polylist count=\"2\">\n"
+	"   <input semantic=\"VERTEX\" source=\"#verts\" offset=\"0\"/>\n"
+	"   <vcount> 4 3 </vcount>\n"
+	"   <p>\n 0 1 2 3\n 1 4 2\n </p>\n"
+	"  </polylist>\n"
+	" </mesh></geometry>\n"
+	"</library_geometries>\n"
+	"<library_visual_scenes>\n"
+	" <visual_scene id=\"scene\"><node><instance_geometry url=\"#shape\"/></node></visual_scene>\n"
+	"</library_visual_scenes>\n"
+	"<scene><instance_visual_scene url=\"#scene\"/></scene>\n"
+	"</COLLADA>\n";
+
+//! Returns the mesh of the first mesh scene node
+IMesh* getInstancedMesh(ISceneManager* smgr)
+{
+	array<ISceneNode*> nodes;
+	smgr->getSceneNodesFromType(ESNT_MESH, nodes);
+	return nodes.size() ? ((IMeshSceneNode*)nodes[0])->getMesh() : 0;
+}
+
+u32 getTriangleCount(IMesh* mesh)
+{
+	u32 count = 0;
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i)
+		count += mesh->getMeshBuffer(i)->getIndexCount() / 3;
+	return count;
+}
+
+//! Polygons of a polylist are split into fans of triangles
+bool loadPolylist(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(
+		polylistScene, sizeof(polylistScene) - 1, "polylist.dae");
+	const bool loaded = smgr->getMesh(file) != 0;
+	file->drop();
+
+	IMesh* mesh = getInstancedMesh(smgr);
+	if (!loaded || !mesh || mesh->getMeshBufferCount() != 1)
+	{
+		logTestString("The polylist was not loaded.\n");
+		return false;
+	}
+
+	// both triangles of the quad share its first corner
+	const IMeshBuffer* buffer = mesh->getMeshBuffer(0);
+	u32 fanTriangles = 0;
+	for (u32 i = 0; i + 2 < buffer->getIndexCount(); i += 3)
+	{
+		for (u32 j = 0; j < 3; ++j)
+		{
+			if (buffer->getPosition(buffer->getIndices()[i + j]) == vector3df(0.f, 0.f, 0.f))
+				++fanTriangles;
+		}
+	}
+
+	const bool result = buffer->getVertexCount() == 5 && getTriangleCount(mesh) == 3 &&
+		fanTriangles == 2 &&
+		mesh->getBoundingBox() == aabbox3df(0.f, 0.f, 0.f, 2.f, 1.f, 0.f);
+	if (!result)
+		logTestString("The polylist was not split into triangles correctly.\n");
+	smgr->clear();
+	return result;
+}
+
+//! Writes a large mesh into a Collada file and loads it again, mostly as a
+//! speed test for the element lookup and the array parsing of the loader.
+bool loadLargeScene(IrrlichtDevice* device)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	const io::path filename = "results/largeScene.dae";
+
+	IMesh* hills = smgr->getGeometryCreator()->createHillPlaneMesh(dimension2df(1.f, 1.f),
+		dimension2du(200, 200), 0, 10.f, dimension2df(3.f, 3.f), dimension2df(10.f, 10.f));
+
+	IMeshWriter* writer = smgr->createMeshWriter(EMWT_COLLADA);
+	io::IWriteFile* file = device->getFileSystem()->createAndWriteFile(filename);
+	bool result = writer && file && writer->writeMesh(file, hills);
+	if (file)
+		file->drop();
+	if (writer)
+		writer->drop();
+
+	const u32 then = timer->getRealTime();
+	result &= smgr->getMesh(filename) != 0;
+	const u32 loadTime = timer->getRealTime() - then;
+
+	logTestString("Speed test for %s with %d triangles\n    load time = %d\n",
+		filename.c_str(), getTriangleCount(hills), loadTime);
+
+	IMesh* mesh = getInstancedMesh(smgr);
+	if (!result || !mesh || getTriangleCount(mesh) != getTriangleCount(hills) ||
+		!mesh->getBoundingBox().MinEdge.equals(hills->getBoundingBox().MinEdge, 0.001f) ||
+		!mesh->getBoundingBox().MaxEdge.equals(hills->getBoundingBox().MaxEdge, 0.001f))
+	{
+		logTestString("The large scene was not loaded correctly.\n");
+		result = false;
+	}
+	hills->drop();
+	smgr->clear();
+	return result;
+}
+
+}
+
+/** Loads a Collada polylist and a large scene written by the Collada writer. */
+bool colladaLoader(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	device->getSceneManager()->getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, true);
+
+	bool result = loadPolylist(device);
+	result &= loadLargeScene(device);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		assert_log(false);
+
+	return result;
+}
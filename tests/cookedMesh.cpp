@@ -0,0 +1,224 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Writes the mesh as cooked mesh
+bool writeCookedMesh(IrrlichtDevice* device, IMesh* mesh, const io::path& filename)
+{
+	IMeshWriter* writer = device->getSceneManager()->createMeshWriter(EMWT_IRR_BIN_MESH);
+	io::IWriteFile* file = device->getFileSystem()->createAndWriteFile(filename);
+	bool result = writer && file && writer->getType() == EMWT_IRR_BIN_MESH && writer->writeMesh(file, mesh);
+	if (file)
+		file->drop();
+	if (writer)
+		writer->drop();
+	return result;
+}
+
+//! Compares the buffers of both meshes byte by byte
+bool compareBuffers(IMesh* original, IMesh* cooked)
+{
+	if (original->getMeshBufferCount() != cooked->getMeshBufferCount())
+		return false;
+
+	for (u32 i = 0; i < original->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* a = original->getMeshBuffer(i);
+		const IMeshBuffer* b = cooked->getMeshBuffer(i);
+		const u32 indexSize = (a->getIndexType() == video::EIT_16BIT) ? 2 : 4;
+		if (a->getVertexType() != b->getVertexType() || a->getIndexType() != b->getIndexType() ||
+			a->getVertexCount() != b->getVertexCount() || a->getIndexCount() != b->getIndexCount() ||
+			a->getPrimitiveType() != b->getPrimitiveType() ||
+			a->getHardwareMappingHint_Vertex() != b->getHardwareMappingHint_Vertex() ||
+			memcmp(a->getVertices(), b->getVertices(), a->getVertexCount() * video::getVertexPitchFromType(a->getVertexType())) ||
+			memcmp(a->getIndices(), b->getIndices(), a->getIndexCount() * indexSize) ||
+			a->getMaterial() != b->getMaterial() ||
+			a->getBoundingBox() != b->getBoundingBox())
+		{
+			logTestString("Mesh buffer %d differs in the cooked mesh.\n", i);
+			return false;
+		}
+	}
+	return true;
+}
+
+template <class T>
+bool compareKeys(const array<T>& a, const array<T>& b)
+{
+	return a.size() == b.size() && (!a.size() || !memcmp(a.const_pointer(), b.const_pointer(), a.size() * sizeof(T)));
+}
+
+//! Compares the joints of both skinned meshes
+bool compareJoints(ISkinnedMesh* original, ISkinnedMesh* cooked)
+{
+	const array<ISkinnedMesh::SJoint*>& a = original->getAllJoints();
+	const array<ISkinnedMesh::SJoint*>& b = cooked->getAllJoints();
+	if (a.size() != b.size() || !a.size())
+		return false;
+
+	for (u32 i = 0; i < a.size(); ++i)
+	{
+		bool result = a[i]->Name == b[i]->Name && a[i]->Children.size() == b[i]->Children.size() &&
+			a[i]->LocalMatrix == b[i]->LocalMatrix && a[i]->AttachedMeshes == b[i]->AttachedMeshes &&
+			compareKeys(a[i]->PositionKeys, b[i]->PositionKeys) &&
+			compareKeys(a[i]->ScaleKeys, b[i]->ScaleKeys) &&
+			compareKeys(a[i]->RotationKeys, b[i]->RotationKeys) &&
+			a[i]->Weights.size() == b[i]->Weights.size();
+		for (u32 j = 0; result && j < a[i]->Weights.size(); ++j)
+		{
+			result = a[i]->Weights[j].buffer_id == b[i]->Weights[j].buffer_id &&
+				a[i]->Weights[j].vertex_id == b[i]->Weights[j].vertex_id &&
+				a[i]->Weights[j].strength == b[i]->Weights[j].strength;
+		}
+		if (!result)
+		{
+			logTestString("Joint %s differs in the cooked mesh.\n", a[i]->Name.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+//! A static mesh with 32 bit indices, tangents and a material with some changes
+IMesh* createStaticMesh(video::IVideoDriver* driver)
+{
+	CDynamicMeshBuffer* buffer = new CDynamicMeshBuffer(video::EVT_TANGENTS, video::EIT_32BIT);
+	for (u32 i = 0; i < 70000; ++i)
+	{
+		const f32 x = (f32)(i % 300);
+		const f32 z = (f32)(i / 300);
+		buffer->getVertexBuffer().push_back(video::S3DVertexTangents(x, (f32)(i % 7), z,
+			0.f, 1.f, 0.f, video::SColor(255, i % 256, 128, 0), x / 300.f, z / 300.f,
+			1.f, 0.f, 0.f, 0.f, 0.f, 1.f));
+	}
+	for (u32 i = 0; i + 301 < 70000; ++i)
+	{
+		buffer->getIndexBuffer().push_back(i);
+		buffer->getIndexBuffer().push_back(i + 300);
+		buffer->getIndexBuffer().push_back(i + 1);
+	}
+	buffer->recalculateBoundingBox();
+	buffer->setHardwareMappingHint(EHM_STATIC);
+
+	video::SMaterial& material = buffer->getMaterial();
+	material.MaterialType = video::EMT_NORMAL_MAP_SOLID;
+	material.Lighting = false;
+	material.BackfaceCulling = false;
+	material.DiffuseColor.set(255, 10, 20, 30);
+	material.Shininess = 20.f;
+	material.setTexture(0, driver->getTexture("../media/rockwall.jpg"));
+	material.setTexture(1, driver->getTexture("../media/rockwall_height.bmp"));
+	material.TextureLayer[1].TextureWrapU = video::ETC_CLAMP;
+	material.getTextureMatrix(0).setTextureScale(2.f, 3.f);
+
+	SMeshBuffer* second = new SMeshBuffer();
+	second->Vertices.push_back(video::S3DVertex(0, 0, 0, 0, 0, 1, video::SColor(255, 255, 255, 255), 0, 0));
+	second->Vertices.push_back(video::S3DVertex(1, 0, 0, 0, 0, 1, video::SColor(255, 255, 255, 255), 1, 0));
+	second->Vertices.push_back(video::S3DVertex(0, 1, 0, 0, 0, 1, video::SColor(255, 255, 255, 255), 0, 1));
+	second->Indices.push_back(0);
+	second->Indices.push_back(1);
+	second->Indices.push_back(2);
+	second->recalculateBoundingBox();
+	second->setPrimitiveType(EPT_POINTS);
+
+	SMesh* mesh = new SMesh();
+	mesh->addMeshBuffer(buffer);
+	mesh->addMeshBuffer(second);
+	mesh->recalculateBoundingBox();
+	buffer->drop();
+	second->drop();
+	return mesh;
+}
+
+}
+
+/** Cooks a skinned and a static mesh, loads them again and compares them with
+the original meshes, also after animating both skinned meshes. */
+bool cookedMesh(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	// a skinned mesh
+	IAnimatedMesh* ninja = smgr->getMesh("../media/ninja.b3d");
+	bool result = ninja && ninja->getMeshType() == EAMT_SKINNED &&
+		writeCookedMesh(device, ninja, "results/ninja.irrbinmesh");
+	IAnimatedMesh* cookedNinja = result ? smgr->getMesh("results/ninja.irrbinmesh") : 0;
+	result &= cookedNinja && cookedNinja->getMeshType() == EAMT_SKINNED;
+	if (!result)
+	{
+		logTestString("The skinned mesh could not be cooked.\n");
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	result &= compareBuffers(ninja, cookedNinja);
+	result &= compareJoints((ISkinnedMesh*)ninja, (ISkinnedMesh*)cookedNinja);
+	result &= ninja->getAnimationSpeed() == cookedNinja->getAnimationSpeed() &&
+		ninja->getFrameCount() == cookedNinja->getFrameCount();
+	result &= cookedNinja->getMeshBuffer(0)->getMaterial().getTexture(0) != 0;
+
+	// both animate the same way
+	result &= compareBuffers(ninja->getMesh(10), cookedNinja->getMesh(10));
+	if (!result)
+		logTestString("The cooked skinned mesh differs.\n");
+
+	// a static mesh
+	IMesh* mesh = createStaticMesh(smgr->getVideoDriver());
+	result &= writeCookedMesh(device, mesh, "results/static.irrbinmesh");
+	IAnimatedMesh* cooked = smgr->getMesh("results/static.irrbinmesh");
+	result &= cooked && cooked->getMeshType() != EAMT_SKINNED && compareBuffers(mesh, cooked->getMesh(0));
+	result &= cooked && cooked->getBoundingBox() == mesh->getBoundingBox();
+	mesh->drop();
+	if (!result)
+		logTestString("The cooked static mesh differs.\n");
+
+	// broken files are not loaded
+	io::IReadFile* file = device->getFileSystem()->createAndOpenFile("results/static.irrbinmesh");
+	if (file)
+	{
+		array<c8> data;
+		data.set_used(file->getSize());
+		file->read(data.pointer(), data.size());
+		file->drop();
+
+		io::IReadFile* truncated = device->getFileSystem()->createMemoryReadFile(
+			data.pointer(), data.size() / 2, "truncated.irrbinmesh");
+		result &= !smgr->getMesh(truncated);
+		truncated->drop();
+
+		data[0] = 'X';
+		io::IReadFile* wrongMagic = device->getFileSystem()->createMemoryReadFile(
+			data.pointer(), data.size(), "wrongMagic.irrbinmesh");
+		result &= !smgr->getMesh(wrongMagic);
+		wrongMagic->drop();
+	}
+	else
+		result = false;
+	if (!result)
+		logTestString("A broken cooked mesh was loaded.\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		assert_log(false);
+
+	return result;
+}
+
@@ -83,12 +83,76 @@ bool testImageFormats()
 
 	return result;
 }
+
+// Compare image parts with point sampling the full image
+bool testImagePart(video::IVideoDriver* driver, const io::path& filename, const core::recti& sourceRect, u32 scaleDenom)
+{
+	video::IImage* full = driver->createImageFromFile(filename);
+	video::IImage* part = driver->createImagePartFromFile(filename, sourceRect, scaleDenom);
+
+	bool result = full && part;
+	if (result)
+	{
+		const core::recti partRect = video::getImagePartRect(full->getDimension(), sourceRect, scaleDenom);
+		result = part->getDimension() == core::dimension2du(partRect.getWidth(), partRect.getHeight());
+
+		for (s32 y=0; result && y<partRect.getHeight(); ++y)
+		{
+			for (s32 x=0; result && x<partRect.getWidth(); ++x)
+			{
+				result = part->getPixel(x, y) == full->getPixel((partRect.UpperLeftCorner.X+x)*scaleDenom, (partRect.UpperLeftCorner.Y+y)*scaleDenom);
+			}
+		}
+	}
+
+	if (!result)
+		logTestString("Image part of %s (scale %d) does not match the full image\n", filename.c_str(), scaleDenom);
+
+	if (full)
+		full->drop();
+	if (part)
+		part->drop();
+	return result;
+}
+
+bool testImageParts()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_NULL);
+
+	if (device == 0)
+		return true; // could not create selected driver.
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	bool result = testImagePart(driver, "../media/water.jpg", core::recti(), 1);
+	result &= testImagePart(driver, "../media/water.jpg", core::recti(10,20,90,60), 1);
+	result &= testImagePart(driver, "media/grey.tga", core::recti(), 3);
+	result &= testImagePart(driver, "media/grey.tga", core::recti(5,7,40,33), 2);
+	result &= testImagePart(driver, "../media/irrlichtlogo2.png", core::recti(16,0,100,64), 3);
+	result &= testImagePart(driver, "../media/fire.bmp", core::recti(3,3,50,50), 5);
+
+	// jpgs use the scaled decoder, so only the size is exact
+	video::IImage* image = driver->createImagePartFromFile("../media/water.jpg", core::recti(), 4);
+	video::IImage* full = driver->createImageFromFile("../media/water.jpg");
+	result &= image && full && image->getDimension() == core::dimension2du(full->getDimension().Width/4, full->getDimension().Height/4);
+	if (image)
+		image->drop();
+	if (full)
+		full->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
 }
 
 bool createImage()
 {
 	bool result = testImageCreation();
 	result &= testImageFormats();
+	result &= testImageParts();
 	return result;
 }
 
@@ -182,6 +182,190 @@ bool testExactPlacement(video::E_DRIVER_TYPE driverType)
 	return result;
 }
 
+
+// draws text with the batched font and compares it with glyphs drawn one by one
+bool testFontBatch(video::E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice *device = createDevice(driverType, core::dimension2d<u32>(160,120), 32);
+
+	if (device == 0)
+		return true; // could not create selected driver.
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	gui::IGUIFont* font = device->getGUIEnvironment()->getBuiltInFont();
+
+	if (!font || font->getType() != gui::EGFT_BITMAP)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return true;
+	}
+
+	stabilizeScreenBackground(driver);
+
+	logTestString("Testing driver %ls\n", driver->getName());
+
+	gui::IGUIFontBitmap* bitmapFont = (gui::IGUIFontBitmap*)font;
+	const core::stringw text(L"Batched text, 0123456789!");
+	const video::SColor color(255,255,255,0);
+
+	// the layout is created at the first position and moved at the second one
+	video::IImage* screenshot[2] = { 0, 0 };
+	for (u32 pass = 0; pass < 3; ++pass)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,40,40,255));
+		if (pass == 0)
+			font->draw(text, core::recti(2,2,158,20), color);
+		else if (pass == 1)
+			font->draw(text, core::recti(5,50,155,70), color, true, true);
+		else
+		{
+			const core::dimension2du size = font->getDimension(text.c_str());
+			const core::position2di origin(5 + (150 - (s32)size.Width) / 2, 50 + (20 - (s32)size.Height) / 2);
+
+			core::array<u32> indices;
+			core::array<core::position2di> positions;
+			for (u32 i = 0; i < text.size(); ++i)
+			{
+				if (text[i] == L' ')
+					continue;
+				indices.push_back(bitmapFont->getSpriteNoFromChar(&text[i]));
+				positions.push_back(origin + core::position2di(font->getDimension(text.subString(0, i).c_str()).Width, 0));
+			}
+			for (u32 i = 0; i < indices.size(); ++i)
+				bitmapFont->getSpriteBank()->draw2DSprite(indices[i], positions[i], 0, color);
+		}
+		driver->endScene();
+
+		if (pass > 0)
+			screenshot[pass - 1] = driver->createScreenShot();
+	}
+
+	bool result = true;
+	if (screenshot[0] && screenshot[1])
+	{
+		const u32 size = screenshot[0]->getImageDataSizeInBytes();
+		result = size == screenshot[1]->getImageDataSizeInBytes() &&
+			memcmp(screenshot[0]->getData(), screenshot[1]->getData(), size) == 0;
+		if (!result)
+			logTestString("Batched text differs from single glyphs\n");
+	}
+
+	for (u32 i = 0; i < 2; ++i)
+		if (screenshot[i])
+			screenshot[i]->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+
+// fills a 32 or 16 bit texture with a color
+void fillTexture(video::ITexture* texture, video::SColor color)
+{
+	u8* data = (u8*)texture->lock();
+	if (!data)
+		return;
+	for (u32 y = 0; y < texture->getSize().Height; ++y)
+	{
+		for (u32 x = 0; x < texture->getSize().Width; ++x)
+		{
+			if (texture->getColorFormat() == video::ECF_A1R5G5B5)
+				((u16*)(data + y * texture->getPitch()))[x] = video::A8R8G8B8toA1R5G5B5(color.color);
+			else
+				((u32*)(data + y * texture->getPitch()))[x] = color.color;
+		}
+	}
+	texture->unlock();
+}
+
+
+// many 2d calls which can be drawn together, interrupted by everything which has to see them drawn
+bool testCallBatching(video::E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice *device = createDevice(driverType, core::dimension2d<u32>(160,120), 32);
+
+	if (device == 0)
+		return true; // could not create selected driver.
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	if (!driver->queryFeature(video::EVDF_RENDER_TO_TARGET))
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return true;
+	}
+
+	stabilizeScreenBackground(driver);
+
+	logTestString("Testing driver %ls\n", driver->getName());
+
+	video::ITexture* fireball = driver->getTexture("../media/fireball.bmp");
+	video::ITexture* water = driver->getTexture("../media/water.jpg");
+	video::ITexture* changed = driver->addTexture(core::dimension2du(16, 16), "changed");
+	video::ITexture* renderTarget = driver->addRenderTargetTexture(core::dimension2du(64, 64), "batchRT");
+	gui::IGUIFont* font = device->getGUIEnvironment()->getBuiltInFont();
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	smgr->addCameraSceneNode(0, core::vector3df(0, 0, -40), core::vector3df(0, 0, 0));
+	scene::ISceneNode* cube = smgr->addCubeSceneNode(10.f, 0, -1, core::vector3df(14, -8, 0), core::vector3df(30, 30, 0));
+	cube->setMaterialFlag(video::EMF_LIGHTING, false);
+	cube->setMaterialTexture(0, water);
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,40,40,255));
+
+	// rectangles and images with the same states, then with changing colors and clipping
+	for (s32 i = 0; i < 16; ++i)
+		driver->draw2DRectangle(video::SColor(255,200,0,0), core::recti(i * 10, 0, i * 10 + 8, 8));
+	for (s32 i = 0; i < 16; ++i)
+		driver->draw2DImage(fireball, core::position2di(i * 10, 10), core::recti(i, i, i + 8, i + 8));
+	for (s32 i = 0; i < 16; ++i)
+		driver->draw2DRectangle(video::SColor(128 + i * 8,0,i * 16,0), core::recti(i * 10, 4, i * 10 + 8, 16));
+	const core::recti clip(20, 20, 100, 40);
+	for (s32 i = 0; i < 8; ++i)
+	{
+		driver->draw2DImage(water, core::recti(i * 16, 20, i * 16 + 24, 44), core::recti(0, 0, 64, 64), i & 1 ? &clip : 0);
+		driver->draw2DImage(fireball, core::position2di(i * 16, 30), core::recti(0, 0, 16, 16), 0,
+			video::SColor(255,255,255,255), true);
+	}
+	font->draw(L"Text between images", core::recti(0, 44, 160, 56), video::SColor(255,255,255,0));
+
+	// a 3d scene and a line after images
+	driver->draw2DImage(water, core::position2di(0, 56), core::recti(0, 0, 40, 20));
+	smgr->drawAll();
+	driver->draw2DImage(fireball, core::position2di(10, 60), core::recti(0, 0, 30, 30));
+	driver->draw2DLine(core::position2di(0, 80), core::position2di(60, 62), video::SColor(255,255,255,255));
+
+	// a texture which changes after it was drawn
+	fillTexture(changed, video::SColor(255,0,255,255));
+	driver->draw2DImage(changed, core::position2di(70, 60));
+	fillTexture(changed, video::SColor(255,255,128,0));
+	driver->draw2DImage(changed, core::position2di(90, 60));
+
+	// images drawn into a render target and the render target drawn on the screen
+	driver->draw2DImage(water, core::position2di(100, 80), core::recti(0, 0, 20, 20));
+	driver->setRenderTarget(renderTarget, true, true, video::SColor(255,0,0,0));
+	driver->draw2DImage(fireball, core::position2di(0, 0), core::recti(0, 0, 32, 32));
+	driver->draw2DRectangle(video::SColor(255,0,0,255), core::recti(32, 32, 64, 64));
+	driver->setRenderTarget(0, false, false);
+	driver->draw2DImage(renderTarget, core::position2di(0, 80), core::recti(0, 0, 40, 40));
+	driver->endScene();
+
+	bool result = takeScreenshotAndCompareAgainstReference(driver, "-draw2DCallBatching.png", 100.f);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 }
 
 bool draw2DImage()
@@ -192,5 +376,7 @@ bool draw2DImage()
 	// TODO D3D driver moves image 1 pixel top-left in case of down scaling
 	TestWithAllDrivers(testExactPlacement);
 	TestWithAllDrivers(testRectangles);
+	TestWithAllDrivers(testFontBatch);
+	TestWithAllDrivers(testCallBatching);
 	return result;
 }
@@ -1,4 +1,5 @@
 #include "testUtils.h"
+#include "IMemoryReadFile.h"
 
 using namespace irr;
 using namespace core;
@@ -122,6 +123,54 @@ static bool testgetRelativeFilename(io::IFileSystem* fs)
 	return result;
 }
 
+//! Large files are mapped into memory, small ones are read with stdio
+static bool testMappedFiles(io::IFileSystem* fs)
+{
+	array<u8> data;
+	data.set_used(300000);
+	for (u32 i=0; i<data.size(); ++i)
+		data[i] = (u8)(i*7+i/256);
+
+	io::IWriteFile* out = fs->createAndWriteFile("results/mappedFile.bin");
+	if (!out)
+		return false;
+	out->write(data.const_pointer(), data.size());
+	out->drop();
+
+	io::IReadFile* file = fs->createAndOpenFile("results/mappedFile.bin");
+	if (!file)
+		return false;
+
+	bool result = file->getSize() == (long)data.size();
+	if (file->getType() == io::ERFT_MAPPED_READ_FILE)
+	{
+		result &= !memcmp(static_cast<io::IMemoryReadFile*>(file)->getBuffer(), data.const_pointer(), data.size());
+	}
+	else
+	{
+		logTestString("Large file was not mapped into memory.\n");
+		result = false;
+	}
+
+	u8 buffer[16];
+	result &= file->seek(1000) && file->read(buffer, 16) == 16 && !memcmp(buffer, &data[1000], 16);
+	result &= file->seek(-16, true) && file->getPos() == 1000;
+	result &= !file->seek(data.size()+1) && file->getPos() == 1000;
+	result &= file->seek(data.size()-10) && file->read(buffer, 16) == 10 && !memcmp(buffer, &data[data.size()-10], 10);
+	result &= file->read(buffer, 16) == 0;
+	file->drop();
+
+	// a small file is not mapped
+	file = fs->createAndOpenFile("media/test.xml");
+	result &= file && file->getType() == io::ERFT_READ_FILE;
+	if (file)
+		file->drop();
+
+	if (!result)
+		logTestString("Reading the mapped file failed.\n");
+	return result;
+}
+
 bool filesystem(void)
 {
 	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2d<u32>(1, 1));
@@ -173,6 +222,7 @@ bool filesystem(void)
 	result &= testFlattenFilename(fs);
 	result &= testgetAbsoluteFilename(fs);
 	result &= testgetRelativeFilename(fs);
+	result &= testMappedFiles(fs);
 
 	device->closeDevice();
 	device->run();
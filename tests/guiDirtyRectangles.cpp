@@ -0,0 +1,248 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+namespace
+{
+
+//! Finds the element at a point by testing all children like before the index
+IGUIElement* elementFromPointByWalk(IGUIElement* element, const position2d<s32>& point)
+{
+	if (!element->isVisible())
+		return 0;
+
+	const list<IGUIElement*>& children = element->getChildren();
+	list<IGUIElement*>::ConstIterator it = children.getLast();
+	for (; it != children.end(); --it)
+	{
+		IGUIElement* target = elementFromPointByWalk(*it, point);
+		if (target)
+			return target;
+	}
+
+	return element->isPointInside(point) ? element : 0;
+}
+
+//! Compares the element found with the index to the walk over all elements
+bool sameElementsAtPoints(IGUIEnvironment* env, const c8* state)
+{
+	IGUIElement* root = env->getRootGUIElement();
+	u32 wrong = 0;
+	for (s32 y = -10; y < 250; y += 3)
+	{
+		for (s32 x = -10; x < 330; x += 3)
+		{
+			const position2d<s32> point(x, y);
+			if (root->getElementFromPoint(point) != elementFromPointByWalk(root, point))
+				++wrong;
+		}
+	}
+
+	if (wrong)
+		logTestString("%u points hit the wrong element %s.\n", wrong, state);
+	return wrong == 0;
+}
+
+//! The index of many children finds the same elements as testing all of them
+bool elementsAtPoints()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2d<u32>(320, 240));
+	if (!device)
+		return false;
+
+	IGUIEnvironment* env = device->getGUIEnvironment();
+
+	// overlapping buttons, some hidden ones and a few larger panels
+	array<IGUIButton*> buttons;
+	for (s32 i = 0; i < 300; ++i)
+	{
+		const s32 x = (i * 37) % 300;
+		const s32 y = (i * 23) % 220;
+		buttons.push_back(env->addButton(rect<s32>(x, y, x + 12 + i % 20, y + 10 + i % 15)));
+		buttons.getLast()->setVisible(i % 7 != 0);
+	}
+	IGUIWindow* window = env->addWindow(rect<s32>(40, 40, 200, 160));
+	for (s32 i = 0; i < 40; ++i)
+		env->addCheckBox(false, rect<s32>(5 + (i % 8) * 19, 25 + (i / 8) * 18, 22 + (i % 8) * 19, 40 + (i / 8) * 18), window);
+
+	// a child which is drawn and hit outside of its parent
+	IGUIStaticText* text = env->addStaticText(L"", rect<s32>(10, 10, 20, 20), false, true, buttons[5]);
+	text->setNotClipped(true);
+	text->setRelativePosition(rect<s32>(-30, -30, 60, 60));
+
+	bool result = sameElementsAtPoints(env, "after adding");
+
+	// changes of the children and their positions
+	for (u32 i = 0; i < 300; i += 3)
+		buttons[i]->move(position2d<s32>(7, -5));
+	env->getRootGUIElement()->bringToFront(buttons[20]);
+	env->getRootGUIElement()->sendToBack(window);
+	buttons[30]->remove();
+	buttons[31]->setVisible(false);
+	text->setNotClipped(false);
+	result &= sameElementsAtPoints(env, "after changes");
+
+	// modal screens are hit everywhere
+	IGUIElement* modal = env->addModalScreen(window);
+	env->addButton(rect<s32>(10, 10, 50, 30), modal);
+	result &= sameElementsAtPoints(env, "with a modal screen");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+//! Draws a frame and returns a screenshot
+video::IImage* drawFrame(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	device->getGUIEnvironment()->drawAll();
+	driver->endScene();
+	return driver->createScreenShot();
+}
+
+//! Draws everything without the dirty rectangle mode and compares it to image
+bool sameAsFullDraw(IrrlichtDevice* device, video::IImage* image, const c8* state)
+{
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	env->setDirtyRectangleMode(false);
+	video::IImage* full = drawFrame(device);
+	env->setDirtyRectangleMode(true, video::SColor(255,100,101,140));
+
+	bool result = image && full && image->getDimension() == full->getDimension();
+	for (u32 y = 0; result && y < full->getDimension().Height; ++y)
+		for (u32 x = 0; result && x < full->getDimension().Width; ++x)
+			result = image->getPixel(x, y) == full->getPixel(x, y);
+
+	if (!result)
+		logTestString("Dirty rectangles differ from the full drawing %s.\n", state);
+	if (full)
+		full->drop();
+	return result;
+}
+
+//! Returns the area of the redrawn rectangles
+s32 redrawnArea(IGUIEnvironment* env)
+{
+	s32 area = 0;
+	const array<rect<s32> >& redrawn = env->getRedrawnRectangles();
+	for (u32 i = 0; i < redrawn.size(); ++i)
+		area += redrawn[i].getArea();
+	return area;
+}
+
+//! Only the changed parts are drawn again and the result looks like drawing everything
+bool dirtyRedraw(video::E_DRIVER_TYPE driverType)
+{
+	// the software driver renders only into textures with a power of two size
+	IrrlichtDevice* device = createDevice(driverType, dimension2d<u32>(256, 128), 32);
+	if (!device)
+		return true; // No error if device does not exist
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	if (!driver->queryFeature(video::EVDF_RENDER_TO_TARGET))
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return true;
+	}
+
+	logTestString("Testing driver %ls\n", driver->getName());
+
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	env->setDirtyRectangleMode(true, video::SColor(255,100,101,140));
+
+	IGUIStaticText* text = env->addStaticText(L"Hello", rect<s32>(5, 5, 75, 20), true);
+	IGUIButton* button = env->addButton(rect<s32>(5, 25, 75, 45), 0, -1, L"Button");
+	IGUIWindow* window = env->addWindow(rect<s32>(80, 5, 155, 110), false, L"Window");
+	IGUIListBox* listBox = env->addListBox(rect<s32>(5, 20, 70, 100), window);
+	for (u32 i = 0; i < 20; ++i)
+		listBox->addItem((stringw(L"item ") + stringw(i)).c_str());
+
+	// everything is drawn at first
+	video::IImage* image = drawFrame(device);
+	bool result = redrawnArea(env) == 256 * 128;
+	result &= sameAsFullDraw(device, image, "at first");
+	image->drop();
+
+	// without changes nothing is drawn
+	image = drawFrame(device);
+	image->drop();
+	image = drawFrame(device);
+	result &= env->getRedrawnRectangles().empty();
+	result &= sameAsFullDraw(device, image, "without changes");
+	image->drop();
+
+	// new text
+	image = drawFrame(device);
+	image->drop();
+	text->setText(L"World");
+	image = drawFrame(device);
+	result &= redrawnArea(env) > 0 && redrawnArea(env) <= text->getAbsolutePosition().getArea();
+	result &= sameAsFullDraw(device, image, "after new text");
+	image->drop();
+
+	// moved button, below the text
+	image = drawFrame(device);
+	image->drop();
+	button->move(position2d<s32>(0, 40));
+	image = drawFrame(device);
+	result &= redrawnArea(env) > 0 && redrawnArea(env) < 256 * 128 / 4;
+	result &= sameAsFullDraw(device, image, "after moving");
+	image->drop();
+
+	// clicks into the list box select an item
+	image = drawFrame(device);
+	image->drop();
+	SEvent event;
+	event.EventType = EET_MOUSE_INPUT_EVENT;
+	event.MouseInput.X = 100;
+	event.MouseInput.Y = 40;
+	event.MouseInput.ButtonStates = 0;
+	event.MouseInput.Shift = false;
+	event.MouseInput.Control = false;
+	event.MouseInput.Event = EMIE_LMOUSE_PRESSED_DOWN;
+	device->postEventFromUser(event);
+	event.MouseInput.Event = EMIE_LMOUSE_LEFT_UP;
+	device->postEventFromUser(event);
+	image = drawFrame(device);
+	result &= listBox->getSelected() >= 0;
+	result &= redrawnArea(env) > 0 && redrawnArea(env) <= window->getAbsolutePosition().getArea();
+	result &= sameAsFullDraw(device, image, "after selecting");
+	image->drop();
+
+	// hidden window
+	image = drawFrame(device);
+	image->drop();
+	window->setVisible(false);
+	image = drawFrame(device);
+	result &= sameAsFullDraw(device, image, "after hiding");
+	image->drop();
+
+	if (!result)
+		logTestString("Wrong redrawn rectangles, last area %d.\n", redrawnArea(env));
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+}
+
+bool guiDirtyRectangles(void)
+{
+	bool result = elementsAtPoints();
+	TestWithAllDrivers(dirtyRedraw);
+	return result;
+}
@@ -0,0 +1,264 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+namespace
+{
+
+//! Draws only the given element and returns a screenshot
+video::IImage* drawOnly(IrrlichtDevice* device, IGUIElement* element)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	const core::list<IGUIElement*>& children = device->getGUIEnvironment()->getRootGUIElement()->getChildren();
+	for (core::list<IGUIElement*>::ConstIterator it = children.begin(); it != children.end(); ++it)
+		(*it)->setVisible(*it == element);
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+	device->getGUIEnvironment()->drawAll();
+	driver->endScene();
+	return driver->createScreenShot();
+}
+
+//! Compares the pixels left of x
+bool sameLeftPart(video::IImage* a, video::IImage* b, u32 x)
+{
+	if (!a || !b || a->getDimension() != b->getDimension())
+		return false;
+	for (u32 j = 0; j < a->getDimension().Height; ++j)
+		for (u32 i = 0; i < x; ++i)
+			if (a->getPixel(i, j) != b->getPixel(i, j))
+				return false;
+	return true;
+}
+
+//! Clicks into the text of the tree from top to bottom and returns the texts of the hit nodes
+core::stringw clickRows(IGUITreeView* tree)
+{
+	core::stringw texts;
+	IGUITreeViewNode* last = 0;
+	SEvent event;
+	event.EventType = EET_MOUSE_INPUT_EVENT;
+	event.MouseInput.Event = EMIE_LMOUSE_LEFT_UP;
+	event.MouseInput.X = tree->getAbsolutePosition().UpperLeftCorner.X + 60;
+	event.MouseInput.ButtonStates = 0;
+	for (s32 y = 1; y < tree->getAbsolutePosition().getHeight() - 20; ++y)
+	{
+		event.MouseInput.Y = tree->getAbsolutePosition().UpperLeftCorner.Y + y;
+		tree->OnEvent(event);
+		IGUITreeViewNode* node = tree->getSelected();
+		if (node && node != last)
+		{
+			texts += node->getText();
+			texts += L" ";
+		}
+		last = node;
+	}
+	return texts;
+}
+
+//! Sorting keeps rows with the same text in order and tracks the selection
+bool tableOrder(IGUIEnvironment* env)
+{
+	IGUITable* table = env->addTable(core::rect<s32>(0, 0, 150, 100));
+	table->addColumn(L"key");
+	table->addColumn(L"index");
+
+	const wchar_t* keys[] = { L"b", L"a", L"c", L"a", L"b", L"a" };
+	for (u32 i = 0; i < 6; ++i)
+	{
+		table->addRow(i);
+		table->setCellText(i, 0, keys[i]);
+		table->setCellText(i, 1, core::stringw(i).c_str());
+	}
+	table->setSelected(4);
+
+	table->orderRows(0, EGOM_ASCENDING);
+	core::stringw order;
+	for (s32 i = 0; i < table->getRowCount(); ++i)
+		order += table->getCellText(i, 1);
+	bool result = order == L"135042";
+	result &= core::stringw(table->getCellText(table->getSelected(), 1)) == L"4";
+
+	table->orderRows(0, EGOM_DESCENDING);
+	order = L"";
+	for (s32 i = 0; i < table->getRowCount(); ++i)
+		order += table->getCellText(i, 1);
+	result &= order == L"204135";
+	result &= core::stringw(table->getCellText(table->getSelected(), 1)) == L"4";
+	if (!result)
+		logTestString("Wrong table order %ls.\n", order.c_str());
+
+	// rows added and removed in the middle
+	table->addRow(2);
+	table->setCellText(2, 1, L"x");
+	table->removeRow(4);
+	order = L"";
+	for (s32 i = 0; i < table->getRowCount(); ++i)
+		order += table->getCellText(i, 1);
+	result &= order == L"20x435";
+	if (!result)
+		logTestString("Wrong rows after add and remove %ls.\n", order.c_str());
+
+	table->remove();
+	return result;
+}
+
+//! Nodes are hit where they are drawn after the tree changed
+bool treeHits(IGUIEnvironment* env)
+{
+	IGUITreeView* tree = env->addTreeView(core::rect<s32>(0, 0, 150, 120));
+	IGUITreeViewNode* a = tree->getRoot()->addChildBack(L"a");
+	for (u32 i = 0; i < 3; ++i)
+		a->addChildBack((core::stringw(L"a") + core::stringw(i)).c_str());
+	IGUITreeViewNode* b = tree->getRoot()->addChildBack(L"b");
+	IGUITreeViewNode* c = tree->getRoot()->addChildBack(L"c");
+	env->drawAll();
+
+	core::stringw texts = clickRows(tree);
+	bool result = texts == L"a b c ";
+
+	a->setExpanded(true);
+	texts += clickRows(tree);
+	result &= texts == L"a b c a a0 a1 a2 b c ";
+
+	tree->getRoot()->deleteChild(b);
+	c->addChildBack(L"c0");
+	c->setExpanded(true);
+	a->moveChildDown(a->getFirstChild());
+	texts += clickRows(tree);
+	result &= texts == L"a b c a a0 a1 a2 b c a a1 a0 a2 c c0 ";
+
+	a->setExpanded(false);
+	texts += clickRows(tree);
+	result &= texts == L"a b c a a0 a1 a2 b c a a1 a0 a2 c c0 a c c0 ";
+	if (!result)
+		logTestString("Wrong tree hits %ls.\n", texts.c_str());
+
+	tree->remove();
+	return result;
+}
+
+//! Long lists only draw their visible part, which looks like the short list
+bool drawLongLists(IrrlichtDevice* device)
+{
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	const u32 width = 120;
+
+	IGUIListBox* shortList = env->addListBox(core::rect<s32>(0, 0, width + 40, 120));
+	IGUIListBox* longList = env->addListBox(core::rect<s32>(0, 0, width + 40, 120));
+	for (u32 i = 0; i < 10000; ++i)
+	{
+		const core::stringw text = core::stringw(L"item ") + core::stringw(i);
+		if (i < 20)
+			shortList->addItem(text.c_str());
+		longList->addItem(text.c_str());
+	}
+
+	video::IImage* shortImage = drawOnly(device, shortList);
+	video::IImage* longImage = drawOnly(device, longList);
+	bool result = sameLeftPart(shortImage, longImage, width);
+	if (!result)
+		logTestString("Long list box is drawn differently.\n");
+	shortImage->drop();
+	longImage->drop();
+	shortList->remove();
+	longList->remove();
+
+	// a sorted long table looks like one filled in the sorted order
+	IGUITable* sorted = env->addTable(core::rect<s32>(0, 0, width + 40, 120));
+	IGUITable* filled = env->addTable(core::rect<s32>(0, 0, width + 40, 120));
+	sorted->addColumn(L"row");
+	filled->addColumn(L"row");
+	sorted->setColumnWidth(0, 80);
+	filled->setColumnWidth(0, 80);
+	for (u32 i = 0; i < 5000; ++i)
+	{
+		c8 text[16];
+		snprintf_irr(text, 16, "row %04u", i);
+		sorted->addRow(i);
+		sorted->setCellText(i, 0, text);
+		snprintf_irr(text, 16, "row %04u", 4999 - i);
+		filled->addRow(i);
+		filled->setCellText(i, 0, text);
+	}
+	sorted->orderRows(0, EGOM_DESCENDING);
+
+	video::IImage* sortedImage = drawOnly(device, sorted);
+	video::IImage* filledImage = drawOnly(device, filled);
+	const bool sameTable = sameLeftPart(sortedImage, filledImage, width + 40);
+	if (!sameTable)
+		logTestString("Sorted long table is drawn differently.\n");
+	result &= sameTable;
+	sortedImage->drop();
+	filledImage->drop();
+	sorted->remove();
+	filled->remove();
+
+	// a long tree scrolled down looks like a short tree with the nodes from there on
+	IGUITreeView* longTree = env->addTreeView(core::rect<s32>(0, 0, width + 40, 120));
+	IGUITreeView* shortTree = env->addTreeView(core::rect<s32>(0, 0, width + 40, 120));
+	for (u32 i = 0; i < 2000; ++i)
+	{
+		const core::stringw text = core::stringw(L"node ") + core::stringw(i);
+		longTree->getRoot()->addChildBack(text.c_str());
+		if (i >= 1000 && i < 1040)
+			shortTree->getRoot()->addChildBack(text.c_str());
+	}
+	env->drawAll();
+
+	// the height of the nodes is where clicking selects the second node
+	SEvent event;
+	event.EventType = EET_MOUSE_INPUT_EVENT;
+	event.MouseInput.Event = EMIE_LMOUSE_LEFT_UP;
+	event.MouseInput.X = 60;
+	event.MouseInput.ButtonStates = 0;
+	s32 itemHeight = 0;
+	for (s32 y = 1; y < 60 && !itemHeight; ++y)
+	{
+		event.MouseInput.Y = y;
+		shortTree->OnEvent(event);
+		if (shortTree->getSelected() && shortTree->getSelected() != shortTree->getRoot()->getFirstChild())
+			itemHeight = y - 1;
+	}
+	if (shortTree->getSelected())
+		shortTree->getSelected()->setSelected(false);
+
+	longTree->getVerticalScrollBar()->setPos(1000 * itemHeight);
+	video::IImage* longTreeImage = drawOnly(device, longTree);
+	video::IImage* shortTreeImage = drawOnly(device, shortTree);
+	const bool sameTree = itemHeight > 0 && sameLeftPart(longTreeImage, shortTreeImage, width);
+	if (!sameTree)
+		logTestString("Scrolled long tree is drawn differently, node height %d.\n", itemHeight);
+	result &= sameTree;
+	longTreeImage->drop();
+	shortTreeImage->drop();
+	longTree->remove();
+	shortTree->remove();
+
+	return result;
+}
+
+}
+
+bool guiLists(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return true; // No error if device does not exist
+
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	bool result = tableOrder(env);
+	result &= treeHits(env);
+	result &= drawLongLists(device);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
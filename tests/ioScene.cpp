@@ -124,9 +124,178 @@ static bool loadScene(void)
 	return result;
 }
 
+// Saves a scene in the binary format, loads it again and compares the result
+// as .irr file with the original scene.
+static bool saveLoadBinaryScene(void)
+{
+	IrrlichtDevice *device = createDevice(EDT_NULL, dimension2d<u32>(160, 120), 32);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	IFileSystem* fs = device->getFileSystem();
+
+	// the relative paths in the scene are correct from there
+	fs->changeWorkingDirectoryTo("results");
+	bool result = smgr->loadScene("../../media/example.irr");
+
+	result &= smgr->saveScene("example.irr");
+	result &= smgr->saveScene("example.irrbin");
+
+	smgr->clear();
+
+	result &= smgr->loadScene("example.irrbin");
+	result &= smgr->saveScene("example2.irr");
+	fs->changeWorkingDirectoryTo("..");
+
+	if (!result)
+		logTestString("Saving or loading the binary scene failed.\n");
+	else if (!xmlCompareFiles(fs, "results/example.irr", "results/example2.irr"))
+	{
+		logTestString("Scene loaded from the binary file differs.\n");
+		result = false;
+	}
+
+	// a part of the scene, loaded below another node
+	ISceneNode* node = smgr->getSceneNodeFromId(128);
+	if (node)
+	{
+		result &= smgr->saveScene("results/example3.irrbin", 0, node);
+		const u32 childCount = node->getChildren().size();
+		result &= smgr->loadScene("results/example3.irrbin", 0, node);
+		if (node->getChildren().size() != childCount+1)
+		{
+			logTestString("Loading binary scene as child failed.\n");
+			result = false;
+		}
+	}
+	else
+		result = false;
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+// Saves and loads a scene with many nodes, mostly as a speed test for the
+// attribute serialization.
+static bool saveLoadLargeScene(const c8* filename)
+{
+	IrrlichtDevice *device = createDevice(EDT_NULL, dimension2d<u32>(160, 120), 32);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+
+	const u32 NODE_COUNT = 50000;
+	ISceneNode* parent = smgr->getRootSceneNode();
+	for (u32 i=0; i<NODE_COUNT; ++i)
+	{
+		// some hierarchy, but not so deep that the recursive writer is in trouble
+		ISceneNode* node = smgr->addEmptySceneNode((i%10) ? parent : 0, (s32)i);
+		node->setName(stringc("node") + stringc(i));
+		node->setPosition(vector3df((f32)i, (f32)(i%100), -(f32)i));
+		node->setRotation(vector3df(0.f, (f32)(i%360), 0.f));
+		if ((i%10) == 0)
+			parent = node;
+	}
+
+	u32 then = timer->getRealTime();
+	bool result = smgr->saveScene(filename);
+	const u32 saveTime = timer->getRealTime() - then;
+
+	smgr->clear();
+
+	then = timer->getRealTime();
+	result &= smgr->loadScene(filename);
+	const u32 loadTime = timer->getRealTime() - then;
+
+	logTestString("Speed test for %s with %d nodes\n    save time = %d\n    load time = %d\n",
+		filename, NODE_COUNT, saveTime, loadTime);
+
+	array<ISceneNode*> nodes;
+	smgr->getSceneNodesFromType(ESNT_EMPTY, nodes);
+	if (nodes.size() != NODE_COUNT)
+	{
+		logTestString("Loaded %d nodes instead of %d.\n", nodes.size(), NODE_COUNT);
+		result = false;
+	}
+
+	const s32 checkIds[] = { 0, 1, 12345, (s32)NODE_COUNT-1 };
+	for (u32 i=0; i<sizeof(checkIds)/sizeof(checkIds[0]); ++i)
+	{
+		const s32 id = checkIds[i];
+		ISceneNode* node = smgr->getSceneNodeFromId(id);
+		if (!node || stringc("node") + stringc(id) != node->getName() ||
+			!node->getPosition().equals(vector3df((f32)id, (f32)(id%100), -(f32)id)) ||
+			!node->getRotation().equals(vector3df(0.f, (f32)(id%360), 0.f)))
+		{
+			logTestString("Node %d was not loaded correctly.\n", id);
+			result = false;
+		}
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+// Binary scenes with too deeply nested nodes are rejected instead of
+// overflowing the stack of the recursive loader.
+static bool loadDeepBinaryScene(void)
+{
+	IrrlichtDevice *device = createDevice(EDT_NULL, dimension2d<u32>(160, 120), 32);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	ISceneNode* parent = smgr->getRootSceneNode();
+	for (u32 i=0; i<2000; ++i)
+	{
+		parent = smgr->addEmptySceneNode(parent, (s32)i);
+		if (i == 999)
+			smgr->saveScene("results/deepScene.irrbin");
+	}
+	bool result = smgr->saveScene("results/tooDeepScene.irrbin");
+
+	smgr->clear();
+	result &= smgr->loadScene("results/deepScene.irrbin");
+	if (!smgr->getSceneNodeFromId(999))
+	{
+		logTestString("Loading the deep binary scene failed.\n");
+		result = false;
+	}
+
+	smgr->clear();
+	if (smgr->loadScene("results/tooDeepScene.irrbin"))
+	{
+		logTestString("Binary scene with too deep nodes was loaded.\n");
+		result = false;
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 bool ioScene(void)
 {
 	bool result = saveScene();
 	result &= loadScene();
+	result &= saveLoadBinaryScene();
+	result &= loadDeepBinaryScene();
+	result &= saveLoadLargeScene("results/largeScene.irr");
+	result &= saveLoadLargeScene("results/largeScene.irrbin");
 	return result;
 }
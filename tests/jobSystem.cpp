@@ -0,0 +1,178 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+
+namespace
+{
+
+//! Each index is written by exactly one call
+void countIndices(void* data, u32 begin, u32 end)
+{
+	u32* counts = (u32*)data;
+	for (u32 i = begin; i < end; ++i)
+		++counts[i];
+}
+
+struct SOrder
+{
+	SOrder() : Count(0) {}
+	u32 Entries[8];
+	u32 Count;
+};
+
+struct SOrderJob
+{
+	SOrder* Order;
+	u32 Id;
+	core::array<u32>* Counts;
+};
+
+//! Appends its id, the jobs of one order never run at the same time
+void appendId(void* data)
+{
+	SOrderJob* job = (SOrderJob*)data;
+	job->Order->Entries[job->Order->Count++] = job->Id;
+}
+
+//! Checks that all indices were counted once before it runs
+void checkCounts(void* data)
+{
+	SOrderJob* job = (SOrderJob*)data;
+	bool complete = true;
+	for (u32 i = 0; i < job->Counts->size(); ++i)
+		complete &= (*job->Counts)[i] == 1;
+	job->Order->Entries[job->Order->Count++] = complete ? job->Id : 0;
+}
+
+struct SSum
+{
+	IJobSystem* Jobs;
+	u32 Begin;
+	u32 End;
+	u32 Sum;
+};
+
+//! Sums up the numbers from Begin to End-1 by splitting the range into jobs which wait for each other
+void sumRange(void* data)
+{
+	SSum* sum = (SSum*)data;
+	if (sum->End - sum->Begin <= 64)
+	{
+		sum->Sum = 0;
+		for (u32 i = sum->Begin; i < sum->End; ++i)
+			sum->Sum += i;
+		return;
+	}
+
+	const u32 middle = (sum->Begin + sum->End) / 2;
+	SSum parts[2] = { { sum->Jobs, sum->Begin, middle, 0 }, { sum->Jobs, middle, sum->End, 0 } };
+	const SJobHandle first = sum->Jobs->addJob(sumRange, &parts[0]);
+	sumRange(&parts[1]);
+	sum->Jobs->wait(first);
+	sum->Sum = parts[0].Sum + parts[1].Sum;
+}
+
+void setFlag(void* data)
+{
+	*(bool*)data = true;
+}
+
+//! Runs the same jobs with the given number of threads
+bool runJobs(u32 threads)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.JobThreads = threads;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	IJobSystem* jobs = device->getJobSystem();
+	bool result = jobs->getThreadCount() >= 1 && (threads == 0 || jobs->getThreadCount() <= threads);
+
+	// parallel for with the default and with small ranges
+	core::array<u32> counts;
+	counts.set_used(100000);
+	for (u32 grain = 0; grain < 20; grain += 7)
+	{
+		memset(counts.pointer(), 0, counts.size() * sizeof(u32));
+		jobs->parallelFor(countIndices, counts.pointer(), counts.size(), grain);
+		for (u32 i = 0; i < counts.size(); ++i)
+			result &= counts[i] == 1;
+	}
+	if (!result)
+		logTestString("Parallel for with %u threads counted wrong.\n", threads);
+
+	// a chain of jobs and a job which waits for a parallel for and the chain
+	memset(counts.pointer(), 0, counts.size() * sizeof(u32));
+	SOrder order;
+	SOrderJob orderJobs[4];
+	for (u32 i = 0; i < 4; ++i)
+	{
+		orderJobs[i].Order = &order;
+		orderJobs[i].Id = i + 1;
+		orderJobs[i].Counts = &counts;
+	}
+	SJobHandle handles[3];
+	handles[0] = jobs->addJob(appendId, &orderJobs[0]);
+	handles[1] = jobs->addJob(appendId, &orderJobs[1], &handles[0], 1);
+	handles[2] = jobs->addParallelFor(countIndices, counts.pointer(), counts.size(), 100);
+	SJobHandle both[2] = { handles[1], handles[2] };
+	const SJobHandle last = jobs->addJob(checkCounts, &orderJobs[2], both, 2);
+	jobs->wait(last);
+	result &= jobs->isDone(handles[0]) && jobs->isDone(handles[2]);
+	result &= order.Count == 3 && order.Entries[0] == 1 && order.Entries[1] == 2 && order.Entries[2] == 3;
+	if (!result)
+		logTestString("Dependencies with %u threads ran in the wrong order.\n", threads);
+
+	// jobs which add jobs and wait for them
+	SSum sum = { jobs, 0, 50000, 0 };
+	jobs->wait(jobs->addJob(sumRange, &sum));
+	result &= sum.Sum == 50000u * 49999u / 2;
+	if (!result)
+		logTestString("Nested jobs with %u threads summed up %u.\n", threads, sum.Sum);
+
+	// main thread jobs only run when the main thread looks for them
+	bool mainThreadJobDone = false;
+	const SJobHandle mainThreadJob = jobs->addMainThreadJob(setFlag, &mainThreadJobDone, &handles[2], 1);
+	const SJobHandle other = jobs->addParallelFor(countIndices, counts.pointer(), counts.size());
+	while (!jobs->isDone(other))
+		device->sleep(1);
+	// without workers the main thread ran it already when it added it
+	result &= jobs->getThreadCount() == 1 || (!mainThreadJobDone && !jobs->isDone(mainThreadJob));
+	device->run();
+	result &= mainThreadJobDone && jobs->isDone(mainThreadJob);
+	if (!result)
+		logTestString("Main thread job with %u threads ran at the wrong time.\n", threads);
+
+	// a default handle is always done
+	result &= jobs->isDone(SJobHandle());
+
+	// many small jobs which nobody waits for
+	memset(counts.pointer(), 0, counts.size() * sizeof(u32));
+	for (u32 i = 0; i < 2000; ++i)
+		jobs->addParallelFor(countIndices, counts.pointer() + i * 50, 50, 10);
+	jobs->waitForAll();
+	for (u32 i = 0; i < counts.size(); ++i)
+		result &= counts[i] == 1;
+	if (!result)
+		logTestString("Jobs with %u threads are lost.\n", threads);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+}
+
+bool jobSystem(void)
+{
+	bool result = runJobs(1);
+	result &= runJobs(4);
+	result &= runJobs(0);
+	return result;
+}
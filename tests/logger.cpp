@@ -0,0 +1,311 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+#if defined(_IRR_POSIX_API_)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+using namespace irr;
+
+namespace
+{
+
+//! Counts the texts it gets and keeps the warnings away from the console
+class LogReceiver : public IEventReceiver
+{
+public:
+	LogReceiver() : Texts(0) {}
+
+	virtual bool OnEvent(const SEvent& event)
+	{
+		if (event.EventType != EET_LOG_TEXT_EVENT)
+			return false;
+		++Texts;
+		return event.LogEvent.Level == ELL_WARNING;
+	}
+
+	u32 Texts;
+};
+
+//! The receiver gets the texts on the thread which logs them
+bool receiverTexts()
+{
+	LogReceiver receiver;
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.EventReceiver = &receiver;
+	params.LoggingLevel = ELL_INFORMATION;
+	params.LoggingThread = true;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	ILogger* logger = device->getLogger();
+	receiver.Texts = 0;
+	for (u32 i = 0; i < 10; ++i)
+		logger->log("logger test warning", ELL_WARNING);
+	logger->log("logger test", L"wide hint", ELL_INFORMATION);
+	logger->log("logger test debug text", ELL_DEBUG);
+	const bool result = receiver.Texts == 11;
+	if (!result)
+		logTestString("Receiver got %u texts.\n", receiver.Texts);
+
+	logger->flush();
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+#if defined(_IRR_POSIX_API_)
+
+struct SLoggingThread
+{
+	ILogger* Logger;
+	ELOG_LEVEL Level;
+	u32 Id;
+};
+
+const u32 TextsPerThread = 500;
+
+void* logTexts(void* data)
+{
+	const SLoggingThread* thread = (const SLoggingThread*)data;
+	for (u32 i = 0; i < TextsPerThread; ++i)
+	{
+		c8 text[64];
+		snprintf_irr(text, 64, "thread %u text %u", thread->Id, i);
+		thread->Logger->log(text, thread->Level);
+	}
+	return 0;
+}
+
+//! Logs from several threads while the console is redirected into a file
+bool printedTexts()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.LoggingThread = true;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+	ILogger* logger = device->getLogger();
+	logger->flush();
+
+	FILE* file = tmpfile();
+	if (!file)
+	{
+		device->drop();
+		return true;
+	}
+	fflush(stdout);
+	const int console = dup(fileno(stdout));
+	dup2(fileno(file), fileno(stdout));
+
+	const u32 threadCount = 4;
+	SLoggingThread threads[threadCount];
+	pthread_t handles[threadCount];
+	for (u32 t = 0; t < threadCount; ++t)
+	{
+		threads[t].Logger = logger;
+		threads[t].Level = ELL_INFORMATION;
+		threads[t].Id = t;
+		pthread_create(&handles[t], 0, logTexts, &threads[t]);
+	}
+	for (u32 t = 0; t < threadCount; ++t)
+		pthread_join(handles[t], 0);
+
+	// repeated texts are collapsed
+	logger->log("logger test repeat", ELL_INFORMATION);
+	for (u32 i = 0; i < 99; ++i)
+		logger->log("logger test repeat", ELL_INFORMATION);
+	logger->log("logger test end", ELL_INFORMATION);
+	logger->flush();
+
+	fflush(stdout);
+	dup2(console, fileno(stdout));
+	close(console);
+
+	// the texts of each thread are printed in order
+	u32 next[threadCount] = { 0 };
+	u32 printedRepeats = 0;
+	u32 repeats = 0;
+	u32 ends = 0;
+	u32 wrong = 0;
+	rewind(file);
+	c8 line[256];
+	while (fgets(line, 256, file))
+	{
+		u32 id, index;
+		if (sscanf(line, "thread %u text %u", &id, &index) == 2)
+		{
+			if (id >= threadCount || index != next[id]++)
+				++wrong;
+		}
+		else if (strcmp(line, "logger test repeat\n") == 0)
+		{
+			++printedRepeats;
+			++repeats;
+		}
+		else if (sscanf(line, "Last message repeated %u times.", &index) == 1)
+			repeats += index;
+		else if (strcmp(line, "logger test end\n") == 0)
+			++ends;
+	}
+	fclose(file);
+
+	bool result = wrong == 0 && printedRepeats == 1 && repeats == 100 && ends == 1;
+	for (u32 t = 0; t < threadCount; ++t)
+		result &= next[t] == TextsPerThread;
+	if (!result)
+		logTestString("Wrong printed texts, %u out of order, %u of %u repeats printed, %u %u %u %u texts.\n",
+			wrong, printedRepeats, repeats, next[0], next[1], next[2], next[3]);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+//! Logs errors from several threads, each error waits until the writer printed it
+bool printedErrors()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.LoggingThread = true;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+	ILogger* logger = device->getLogger();
+	logger->flush();
+
+	FILE* file = tmpfile();
+	if (!file)
+	{
+		device->drop();
+		return true;
+	}
+	fflush(stdout);
+	const int console = dup(fileno(stdout));
+	dup2(fileno(file), fileno(stdout));
+
+	// a lost wakeup of the writer lets one of the threads wait forever
+	const u32 threadCount = 8;
+	SLoggingThread threads[threadCount];
+	pthread_t handles[threadCount];
+	for (u32 t = 0; t < threadCount; ++t)
+	{
+		threads[t].Logger = logger;
+		threads[t].Level = ELL_ERROR;
+		threads[t].Id = t;
+		pthread_create(&handles[t], 0, logTexts, &threads[t]);
+	}
+	for (u32 t = 0; t < threadCount; ++t)
+		pthread_join(handles[t], 0);
+	logger->flush();
+
+	fflush(stdout);
+	dup2(console, fileno(stdout));
+	close(console);
+
+	u32 next[threadCount] = { 0 };
+	u32 wrong = 0;
+	rewind(file);
+	c8 line[256];
+	while (fgets(line, 256, file))
+	{
+		u32 id, index;
+		if (sscanf(line, "thread %u text %u", &id, &index) == 2)
+		{
+			if (id >= threadCount || index != next[id]++)
+				++wrong;
+		}
+	}
+	fclose(file);
+
+	bool result = wrong == 0;
+	for (u32 t = 0; t < threadCount; ++t)
+		result &= next[t] == TextsPerThread;
+	if (!result)
+		logTestString("Wrong printed errors, %u out of order.\n", wrong);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+//! Notes if the texts arrive on another thread than the main thread
+class ThreadReceiver : public IEventReceiver
+{
+public:
+	ThreadReceiver() : Texts(0), OtherThread(0) {}
+
+	virtual bool OnEvent(const SEvent& event)
+	{
+		if (event.EventType != EET_LOG_TEXT_EVENT)
+			return false;
+		++Texts;
+		if (!pthread_equal(pthread_self(), MainThread))
+			++OtherThread;
+		return true;
+	}
+
+	pthread_t MainThread;
+	u32 Texts;
+	u32 OtherThread;
+};
+
+void logFromJob(void* data)
+{
+	((ILogger*)data)->log("logger test job text", ELL_WARNING);
+}
+
+//! Texts of the job threads reach the receiver on the main thread
+bool jobTexts()
+{
+	ThreadReceiver receiver;
+	receiver.MainThread = pthread_self();
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.EventReceiver = &receiver;
+	params.JobThreads = 4;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	IJobSystem* jobs = device->getJobSystem();
+	receiver.Texts = 0;
+	core::array<SJobHandle> handles;
+	for (u32 i = 0; i < 16; ++i)
+		handles.push_back(jobs->addJob(logFromJob, device->getLogger()));
+	for (u32 i = 0; i < handles.size(); ++i)
+		jobs->wait(handles[i]);
+
+	const bool result = receiver.Texts == 16 && receiver.OtherThread == 0;
+	if (!result)
+		logTestString("Receiver got %u job texts, %u on other threads.\n", receiver.Texts, receiver.OtherThread);
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+	return result;
+}
+
+#endif
+
+}
+
+bool logger(void)
+{
+	bool result = receiverTexts();
+#if defined(_IRR_POSIX_API_)
+	result &= printedTexts();
+	result &= printedErrors();
+	result &= jobTexts();
+#endif
+	return result;
+}
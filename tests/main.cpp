@@ -84,8 +84,16 @@ int main(int argumentCount, char * arguments[])
 	TEST(removeCustomAnimator);
 	TEST(sceneCollisionManager);
 	TEST(sceneNodeAnimator);
+	TEST(parallelAnimation);
+	TEST(sceneNodeTransformation);
+	TEST(meshLoadRequest);
 	TEST(meshLoaders);
+	TEST(cookedMesh);
+	TEST(colladaLoader);
 	TEST(testTimer);
+	TEST(profiler);
+	TEST(logger);
+	TEST(jobSystem);
 	TEST(testCoreutil);
 	// software drivers only
 	TEST(softwareDevice);
@@ -96,6 +104,8 @@ int main(int argumentCount, char * arguments[])
 	TEST(cursorSetVisible);
 	TEST(flyCircleAnimator);
 	TEST(guiDisabledMenu);
+	TEST(guiLists);
+	TEST(guiDirtyRectangles);
 	TEST(makeColorKeyTexture);
 	TEST(md2Animation);
 	TEST(meshTransform);
@@ -129,6 +139,7 @@ int main(int argumentCount, char * arguments[])
 	TEST(planeMatrix);
 	TEST(terrainSceneNode);
 	TEST(lightMaps);
+	TEST(q3LevelSceneNode);
 	TEST(triangleSelector);
 	TEST(line2DTest);
 #endif
@@ -449,6 +449,109 @@ void calltest()
 	f1 = f1+f2+f3+f4+*pf1+*pf2; // getting rid of unused variable warnings.
 }
 
+// random values between -100 and 100, always the same ones
+f32 randomValue(u32& seed)
+{
+	seed = seed * 1664525 + 1013904223;
+	return (f32)(seed >> 8) / (f32)(1 << 24) * 200.f - 100.f;
+}
+
+bool closeEnough(f32 a, f32 b)
+{
+	return core::equals(a, b, 0.00001f * core::max_(1.f, fabsf(a)));
+}
+
+bool closeEnough(const vector3df& a, const vector3df& b)
+{
+	return closeEnough(a.X, b.X) && closeEnough(a.Y, b.Y) && closeEnough(a.Z, b.Z);
+}
+
+// The SIMD kernels of the f32 matrix have to match the scalar reference
+bool simdPrecision(void)
+{
+	const u32 count = 100;
+	u32 seed = 1;
+	core::array<matrix4> a, b, products, reference;
+	a.set_used(count);
+	b.set_used(count);
+	reference.set_used(count);
+	for (u32 i=0; i<count; ++i)
+	{
+		for (u32 k=0; k<16; ++k)
+		{
+			a[i][k] = randomValue(seed);
+			b[i][k] = randomValue(seed);
+		}
+		multiplyMatrix4Scalar(reference[i].pointer(), a[i].pointer(), b[i].pointer());
+	}
+
+	bool result = true;
+	for (u32 i=0; i<count; ++i)
+	{
+		matrix4 product(a[i] * b[i]);
+		matrix4 byProduct;
+		byProduct.setbyproduct(a[i], b[i]);
+		for (u32 k=0; k<16; ++k)
+			result &= closeEnough(product[k], reference[i][k]) && closeEnough(byProduct[k], reference[i][k]);
+	}
+
+	// batch products, also in place
+	products.set_used(count);
+	matrix4::setbyproducts(products.pointer(), a.const_pointer(), b.const_pointer(), count);
+	matrix4::setbyproducts(a.pointer(), a.const_pointer(), b.const_pointer(), count);
+	for (u32 i=0; i<count; ++i)
+	{
+		for (u32 k=0; k<16; ++k)
+			result &= closeEnough(products[i][k], reference[i][k]) && closeEnough(a[i][k], reference[i][k]);
+	}
+	if (!result)
+		logTestString("SIMD matrix products differ from the scalar ones.\n");
+
+	// vectors, also in place
+	core::array<vector3df> vectors, transformed, expected;
+	for (u32 i=0; i<count; ++i)
+		vectors.push_back(vector3df(randomValue(seed), randomValue(seed), randomValue(seed)));
+	transformed.set_used(count);
+	expected.set_used(count);
+	b[0].transformVects(transformed.pointer(), vectors.const_pointer(), count);
+	transformVectsMatrix4Scalar(b[0].pointer(), expected.pointer(), vectors.const_pointer(), count);
+	b[0].transformVects(vectors.pointer(), vectors.const_pointer(), count);
+	for (u32 i=0; i<count; ++i)
+	{
+		if (!closeEnough(transformed[i], expected[i]) || !closeEnough(vectors[i], expected[i]))
+		{
+			logTestString("SIMD vector transformation differs from the scalar one.\n");
+			result = false;
+			break;
+		}
+	}
+
+	// boxes
+	for (u32 i=0; i<count; ++i)
+	{
+		aabbox3df box;
+		box.reset(randomValue(seed), randomValue(seed), randomValue(seed));
+		box.addInternalPoint(randomValue(seed), randomValue(seed), randomValue(seed));
+		aabbox3df expectedBox(box);
+		b[i].transformBoxEx(box);
+		transformBoxMatrix4Scalar(b[i].pointer(), expectedBox);
+		if (!closeEnough(box.MinEdge, expectedBox.MinEdge) || !closeEnough(box.MaxEdge, expectedBox.MaxEdge))
+		{
+			logTestString("SIMD box transformation differs from the scalar one.\n");
+			result = false;
+			break;
+		}
+	}
+
+	// the scalar version is used for other types
+	CMatrix4<f64> d1, d2;
+	d1.setTranslation(vector3d<f64>(1, 2, 3));
+	d2.setScale(vector3d<f64>(2, 2, 2));
+	result &= (d1 * d2).getTranslation() == vector3d<f64>(1, 2, 3);
+
+	return result;
+}
+
 }
 
 bool matrixOps(void)
@@ -460,6 +563,7 @@ bool matrixOps(void)
 	result &= isOrthogonal();
 	result &= transformations();
 	result &= setRotationAxis();
+	result &= simdPrecision();
 	return result;
 }
 
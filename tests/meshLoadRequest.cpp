@@ -0,0 +1,104 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Returns true when each mesh buffer of the mesh got a texture
+bool hasTextures(IAnimatedMesh* mesh)
+{
+	if (!mesh || !mesh->getMeshBufferCount())
+		return false;
+
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i)
+	{
+		if (!mesh->getMeshBuffer(i)->getMaterial().getTexture(0))
+			return false;
+	}
+	return true;
+}
+
+}
+
+/** Loads meshes with requests, which share one request per mesh and add
+the meshes to the mesh cache. The .x meshes load on the job threads and get
+their textures from the main thread. */
+bool meshLoadRequest(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.JobThreads = 4;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	IMeshCache* cache = smgr->getMeshCache();
+	const u32 meshCount = cache->getMeshCount();
+
+	// the .b3d loader runs on the main thread and the .x mesh waits for it
+	IMeshLoadRequest* ninja = smgr->createMeshLoadRequest("../media/ninja.b3d");
+	IMeshLoadRequest* dwarf = smgr->createMeshLoadRequest("../media/dwarf.x");
+	IMeshLoadRequest* again = smgr->createMeshLoadRequest("../media/dwarf.x");
+	bool result = again == dwarf && !dwarf->isDone() && !dwarf->getMesh() && !ninja->isDone();
+	if (!result)
+		logTestString("Requests for the same mesh were not shared.\n");
+	again->drop();
+
+	IAnimatedMesh* mesh = dwarf->wait();
+	result &= mesh && dwarf->isDone() && dwarf->getMesh() == mesh && hasTextures(mesh);
+	result &= ninja->isDone() && ninja->getMesh() && hasTextures(ninja->getMesh());
+	result &= cache->getMeshByName("../media/dwarf.x") == mesh && smgr->getMesh("../media/dwarf.x") == mesh;
+	result &= dwarf->getName() == "../media/dwarf.x";
+	if (!result)
+		logTestString("The requested meshes were not loaded.\n");
+
+	// the mesh cache has it already
+	IMeshLoadRequest* cached = smgr->createMeshLoadRequest("../media/dwarf.x");
+	result &= cached != dwarf && cached->isDone() && cached->getMesh() == mesh;
+	cached->drop();
+	dwarf->drop();
+	ninja->drop();
+
+	// the main thread loads the textures while it runs the device
+	IMeshLoadRequest* earth = smgr->createMeshLoadRequest("../media/earth.x", "earth");
+	u32 runs = 0;
+	while (!earth->isDone() && runs++ < 10000)
+	{
+		device->run();
+		device->sleep(1);
+	}
+	result &= earth->isDone() && hasTextures(earth->getMesh()) && cache->getMeshByName("earth") == earth->getMesh();
+	result &= !cache->isMeshLoaded("../media/earth.x");
+	earth->drop();
+
+	// getMesh waits for the request instead of loading the mesh again
+	IMeshLoadRequest* sydney = smgr->createMeshLoadRequest("../media/sydney.md2");
+	IAnimatedMesh* loaded = smgr->getMesh("../media/sydney.md2");
+	result &= loaded && sydney->isDone() && sydney->getMesh() == loaded;
+	sydney->drop();
+	result &= cache->getMeshCount() == meshCount + 4;
+	if (!result)
+		logTestString("The mesh cache has the wrong meshes.\n");
+
+	// failed requests are done without a mesh
+	IMeshLoadRequest* missing = smgr->createMeshLoadRequest("../media/missing.x");
+	result &= !missing->wait() && missing->isDone() && !missing->getMesh();
+	missing->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		assert_log(false);
+
+	return result;
+}
@@ -0,0 +1,330 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Counts its calls and moves the node, thread safe as long as it animates one node
+class CCountingAnimator : public ISceneNodeAnimator
+{
+public:
+	CCountingAnimator() : Calls(0) {}
+
+	virtual void animateNode(ISceneNode* node, u32 timeMs)
+	{
+		++Calls;
+		node->setScale(vector3df(1.f + (timeMs % 100) * 0.01f));
+	}
+
+	virtual ISceneNodeAnimator* createClone(ISceneNode* node, ISceneManager* newManager=0)
+	{
+		return new CCountingAnimator();
+	}
+
+	virtual bool isThreadSafe() const { return true; }
+
+	u32 Calls;
+};
+
+//! Logs the order of its calls and moves the node, is not thread safe
+class CLoggingAnimator : public ISceneNodeAnimator
+{
+public:
+	CLoggingAnimator(array<s32>& log) : Log(log) {}
+
+	virtual void animateNode(ISceneNode* node, u32 timeMs)
+	{
+		Log.push_back(node->getID());
+		node->setPosition(vector3df((f32)(timeMs % 7), (f32)node->getID(), 0.f));
+	}
+
+	virtual ISceneNodeAnimator* createClone(ISceneNode* node, ISceneManager* newManager=0)
+	{
+		return new CLoggingAnimator(Log);
+	}
+
+	array<s32>& Log;
+};
+
+//! Lifts the node with the time, is not thread safe
+class CLiftAnimator : public ISceneNodeAnimator
+{
+public:
+	virtual void animateNode(ISceneNode* node, u32 timeMs)
+	{
+		node->setPosition(vector3df(0.f, (timeMs % 1000) * 0.005f, -4.f));
+	}
+
+	virtual ISceneNodeAnimator* createClone(ISceneNode* node, ISceneManager* newManager=0)
+	{
+		return new CLiftAnimator();
+	}
+};
+
+//! Hides another node, is not thread safe
+class CHidingAnimator : public ISceneNodeAnimator
+{
+public:
+	CHidingAnimator(ISceneNode* other) : Other(other) {}
+
+	virtual void animateNode(ISceneNode* node, u32 timeMs)
+	{
+		Other->setVisible(false);
+	}
+
+	virtual ISceneNodeAnimator* createClone(ISceneNode* node, ISceneManager* newManager=0)
+	{
+		return new CHidingAnimator(Other);
+	}
+
+	ISceneNode* Other;
+};
+
+void addAnimator(ISceneNode* node, ISceneNodeAnimator* animator)
+{
+	node->addAnimator(animator);
+	animator->drop();
+}
+
+//! Builds the same scene in each scene manager
+void buildScene(ISceneManager* smgr, array<s32>& log, array<CCountingAnimator*>& counters)
+{
+	array<vector3df> points;
+	points.push_back(vector3df(0, 0, 0));
+	points.push_back(vector3df(10, 5, 0));
+	points.push_back(vector3df(-3, 20, 8));
+
+	s32 id = 0;
+	for (u32 i = 0; i < 20; ++i)
+	{
+		ISceneNode* node = smgr->addEmptySceneNode(0, ++id);
+		if (i % 5 == 0)
+			addAnimator(node, new CLoggingAnimator(log));
+		else
+			addAnimator(node, smgr->createFlyCircleAnimator(vector3df(0, 0, (f32)i), 10.f, 0.001f * i));
+
+		for (u32 j = 0; j < 4; ++j)
+		{
+			ISceneNode* child = smgr->addEmptySceneNode(node, ++id);
+			child->setPosition(vector3df((f32)j, 1.f, 0.f));
+			addAnimator(child, smgr->createRotationAnimator(vector3df(0.3f * j, 0.1f, 0.f)));
+			CCountingAnimator* counter = new CCountingAnimator();
+			counters.push_back(counter);
+			addAnimator(child, counter);
+
+			ISceneNode* grandChild = smgr->addEmptySceneNode(child, ++id);
+			grandChild->setRotation(vector3df(0.f, 45.f, 0.f));
+			if (j == 1)
+				addAnimator(grandChild, new CLoggingAnimator(log));
+			else if (j == 2)
+				addAnimator(grandChild, smgr->createFollowSplineAnimator(0, points, 2.f));
+
+			ISceneNode* leaf = smgr->addEmptySceneNode(grandChild, ++id);
+			leaf->setPosition(vector3df(0.f, 0.f, 2.f));
+			if (j == 3)
+			{
+				ISceneNodeAnimator* flyStraight = smgr->createFlyStraightAnimator(vector3df(0, 0, 0), vector3df(5, 5, 5), 500, true);
+				flyStraight->setEnabled(i % 2 == 0);
+				addAnimator(leaf, flyStraight);
+			}
+		}
+
+		if (i % 7 == 3)
+		{
+			ISceneNode* hidden = smgr->addEmptySceneNode(node, ++id);
+			hidden->setVisible(false);
+			CCountingAnimator* counter = new CCountingAnimator();
+			counters.push_back(counter);
+			addAnimator(hidden, counter);
+		}
+	}
+}
+
+//! Adds walkers with collision response animators on a hill in front of a wall
+/** Some walkers also collide with a lift, which moves in OnAnimate before
+them, so they can't be batched. */
+void addWalkers(ISceneManager* smgr)
+{
+	IMeshSceneNode* lift = smgr->addCubeSceneNode(10.f, 0, 902);
+	addAnimator(lift, new CLiftAnimator());
+
+	IMesh* hill = smgr->getGeometryCreator()->createHillPlaneMesh(dimension2df(5.f, 5.f),
+		dimension2du(16, 16), 0, 8.f, dimension2df(2.f, 2.f), dimension2df(1.f, 1.f));
+	IMeshSceneNode* ground = smgr->addMeshSceneNode(hill, 0, 900);
+	hill->drop();
+	IMeshSceneNode* wall = smgr->addCubeSceneNode(10.f, 0, 901, vector3df(25.f, 5.f, 0.f));
+
+	IMetaTriangleSelector* world = smgr->createMetaTriangleSelector();
+	ITriangleSelector* selector = smgr->createTriangleSelector(ground->getMesh(), ground);
+	world->addTriangleSelector(selector);
+	selector->drop();
+	selector = smgr->createTriangleSelectorFromBoundingBox(wall);
+	world->addTriangleSelector(selector);
+	selector->drop();
+
+	IMetaTriangleSelector* liftWorld = smgr->createMetaTriangleSelector();
+	liftWorld->addTriangleSelector(world);
+	selector = smgr->createTriangleSelectorFromBoundingBox(lift);
+	liftWorld->addTriangleSelector(selector);
+	selector->drop();
+
+	for (u32 i = 0; i < 12; ++i)
+	{
+		ISceneNode* walker = smgr->addEmptySceneNode(0, 1000 + i);
+		walker->setPosition(vector3df(i * 3.f - 10.f, 4.f + (i % 4) * 3.f, (i % 3) * 4.f - 4.f));
+		addAnimator(walker, smgr->createCollisionResponseAnimator((i % 3) ? world : liftWorld, walker,
+			vector3df(1.f, 2.f, 1.f), vector3df(0.f, (i % 4) * -100.f, 0.f)));
+	}
+	world->drop();
+	liftWorld->drop();
+}
+
+//! Moves the walkers like a game would before drawing the scene
+void moveWalkers(ISceneManager* smgr)
+{
+	for (u32 i = 0; i < 12; ++i)
+	{
+		ISceneNode* walker = smgr->getSceneNodeFromId(1000 + i);
+		walker->setPosition(walker->getPosition() + vector3df(2.f, 0.f, (i % 2) ? 0.5f : -0.5f));
+	}
+}
+
+//! Compares the state of the collision response animators of the walkers
+bool compareWalkers(ISceneManager* serial, ISceneManager* parallel, u32& collisions)
+{
+	bool result = true;
+	for (u32 i = 0; i < 12; ++i)
+	{
+		ISceneNodeAnimatorCollisionResponse* a = (ISceneNodeAnimatorCollisionResponse*)
+			*serial->getSceneNodeFromId(1000 + i)->getAnimators().begin();
+		ISceneNodeAnimatorCollisionResponse* b = (ISceneNodeAnimatorCollisionResponse*)
+			*parallel->getSceneNodeFromId(1000 + i)->getAnimators().begin();
+		result &= a->isFalling() == b->isFalling() && a->collisionOccurred() == b->collisionOccurred() &&
+			a->getCollisionPoint() == b->getCollisionPoint() &&
+			a->getCollisionTriangle() == b->getCollisionTriangle() &&
+			a->getCollisionResultPosition() == b->getCollisionResultPosition() &&
+			(a->getCollisionNode() != 0) == (b->getCollisionNode() != 0);
+		collisions += a->collisionOccurred();
+	}
+	if (!result)
+		logTestString("The batched collision response differs.\n");
+	return result;
+}
+
+bool compareNodes(ISceneNode* serial, ISceneNode* parallel)
+{
+	bool result = serial->getID() == parallel->getID() &&
+		serial->getAbsoluteTransformation() == parallel->getAbsoluteTransformation();
+	if (!result)
+		logTestString("Node %d differs after the parallel animation.\n", serial->getID());
+
+	const ISceneNodeList& serialChildren = serial->getChildren();
+	const ISceneNodeList& parallelChildren = parallel->getChildren();
+	if (serialChildren.size() != parallelChildren.size())
+		return false;
+	ISceneNodeList::ConstIterator it = serialChildren.begin();
+	ISceneNodeList::ConstIterator pit = parallelChildren.begin();
+	for (; it != serialChildren.end(); ++it, ++pit)
+		result &= compareNodes(*it, *pit);
+	return result;
+}
+
+}
+
+/** Animates the same scene one node after another and with the parallel
+animation, which has to give the same positions and call the animators
+which aren't thread safe in the same order. The collision response
+animators of the walkers are batched, unless their world moves in OnAnimate. */
+bool parallelAnimation(void)
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.JobThreads = 4;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* serial = device->getSceneManager();
+	ISceneManager* parallel = serial->createNewSceneManager(false);
+	parallel->setAnimationJobSystem(device->getJobSystem());
+	bool result = parallel->getAnimationJobSystem() == device->getJobSystem() && !serial->getAnimationJobSystem();
+
+	// the animators take their start time from the timer
+	ITimer* timer = device->getTimer();
+	timer->stop();
+	timer->setTime(500);
+
+	array<s32> serialLog;
+	array<s32> parallelLog;
+	array<CCountingAnimator*> serialCounters;
+	array<CCountingAnimator*> parallelCounters;
+	buildScene(serial, serialLog, serialCounters);
+	buildScene(parallel, parallelLog, parallelCounters);
+	addWalkers(serial);
+	addWalkers(parallel);
+	u32 collisions = 0;
+
+	for (u32 frame = 0; frame < 10; ++frame)
+	{
+		timer->setTime(1000 + frame * 37);
+		moveWalkers(serial);
+		moveWalkers(parallel);
+		serial->drawAll();
+		parallel->drawAll();
+		result &= compareWalkers(serial, parallel, collisions);
+	}
+	result &= collisions > 0;
+
+	result &= compareNodes(serial->getRootSceneNode(), parallel->getRootSceneNode());
+
+	result &= serialLog.size() == 10 * 24 && serialLog.size() == parallelLog.size();
+	for (u32 i = 0; result && i < serialLog.size(); ++i)
+		result &= serialLog[i] == parallelLog[i];
+	if (!result)
+		logTestString("The animators which aren't thread safe ran in another order.\n");
+
+	// each visible counting animator ran once per frame
+	for (u32 i = 0; i < serialCounters.size(); ++i)
+	{
+		const u32 calls = serialCounters[i]->Calls;
+		result &= parallelCounters[i]->Calls == calls && (calls == 10 || calls == 0);
+	}
+	if (!result)
+		logTestString("The parallel animation called animators more or less often.\n");
+
+	// a node which is hidden after it was animated early is animated as
+	// usual in the next frame, also without the job system
+	ISceneManager* hiding = serial->createNewSceneManager(false);
+	hiding->setAnimationJobSystem(device->getJobSystem());
+	ISceneNode* hider = hiding->addEmptySceneNode();
+	ISceneNode* hidden = hiding->addEmptySceneNode();
+	addAnimator(hider, new CHidingAnimator(hidden));
+	CCountingAnimator* counter = new CCountingAnimator();
+	hidden->addAnimator(counter);
+	hiding->drawAll();
+	hider->removeAnimators();
+	hidden->setVisible(true);
+	hiding->setAnimationJobSystem(0);
+	hiding->drawAll();
+	if (counter->Calls != 2)
+	{
+		logTestString("A hidden node kept its early animation, %u calls.\n", counter->Calls);
+		result = false;
+	}
+	counter->drop();
+	hiding->drop();
+
+	parallel->drop();
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,187 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+
+namespace
+{
+
+//! Busy wait so the zones take some microseconds
+void spin(ITimer* timer)
+{
+	const u32 start = timer->getRealTime();
+	volatile u32 sum = 0;
+	for (u32 i = 0; i < 20000 && timer->getRealTime() == start; ++i)
+		sum += i;
+}
+
+//! Counts how often part is in text
+u32 countOf(const core::stringc& text, const c8* part)
+{
+	u32 count = 0;
+	s32 pos = text.find(part);
+	while (pos >= 0)
+	{
+		++count;
+		pos = text.find(part, pos + 1);
+	}
+	return count;
+}
+
+//! Checks ids, nested zones and the nanosecond times
+bool zones(ITimer* timer)
+{
+	IProfiler& profiler = getProfiler();
+
+	// ids from the application range, an automatic one and one far away from the lookup tables
+	profiler.add(7, L"zone a", L"profiler test");
+	const s32 autoId = profiler.add(L"zone b", L"profiler test");
+	profiler.add(5000000, L"zone c", L"profiler test");
+
+	bool result = profiler.add(L"zone b", L"profiler test") == autoId;
+
+	for (u32 i = 0; i < 3; ++i)
+	{
+		CProfileScope scope(7);
+		profiler.start(autoId);
+		profiler.start(autoId);	// nested starts count once
+		spin(timer);
+		profiler.stop(autoId);
+		profiler.stop(autoId);
+		profiler.stop(autoId);	// ignored
+		profiler.start(5000000);
+		profiler.stop(5000000);
+	}
+
+	const SProfileData* a = profiler.getProfileDataById(7);
+	const SProfileData* b = profiler.getProfileDataById(autoId);
+	const SProfileData* c = profiler.getProfileDataById(5000000);
+	result &= a && b && c;
+	if (!result)
+	{
+		logTestString("Profile data not found.\n");
+		return false;
+	}
+
+	result &= a->getName() == L"zone a" && b->getName() == L"zone b" && c->getName() == L"zone c";
+	result &= a->getCallsCounter() == 3 && b->getCallsCounter() == 3 && c->getCallsCounter() == 3;
+	result &= b->getTimeSumNs() > 0 && a->getTimeSumNs() >= b->getTimeSumNs();
+	result &= a->getLongestTimeNs() <= a->getTimeSumNs() && a->getLongestTimeNs() * 3 >= a->getTimeSumNs();
+	result &= a->getTimeSum() == (u32)(a->getTimeSumNs() / 1000000);
+	if (!result)
+		logTestString("Wrong profile data, calls %u %u %u, times %u %u ns.\n", a->getCallsCounter(), b->getCallsCounter(),
+			c->getCallsCounter(), (u32)a->getTimeSumNs(), (u32)b->getTimeSumNs());
+
+	// indices stay the same when ids are added
+	u32 index = 0;
+	result &= profiler.findDataIndex(index, L"zone a") && &profiler.getProfileDataByIndex(index) == a;
+	profiler.add(3, L"zone d", L"profiler test");
+	result &= &profiler.getProfileDataByIndex(index) == a && profiler.getProfileDataById(3) != 0;
+
+	return result;
+}
+
+//! Writes the events of the zones as chrome json and in the binary format
+bool traces(io::IFileSystem* fs)
+{
+	IProfiler& profiler = getProfiler();
+	profiler.setThreadName("main \"thread\"");
+
+	const u32 bufferSize = 0x10000;
+	core::array<c8> buffer;
+	buffer.set_used(bufferSize);
+
+	memset(buffer.pointer(), 0, bufferSize);
+	io::IWriteFile* file = fs->createMemoryWriteFile(buffer.pointer(), bufferSize - 1, "trace.json");
+	bool result = profiler.writeTrace(file, EPTF_CHROME_JSON);
+	file->drop();
+
+	const core::stringc json(buffer.const_pointer());
+	result &= json.find("{\"traceEvents\":[") == 0;
+	result &= countOf(json, "\"name\":\"zone a\",\"cat\":\"profiler test\"") == 3;
+	result &= countOf(json, "\"name\":\"zone b\"") == 3;
+	result &= countOf(json, "\"ph\":\"M\"") == 1 && json.find("\"name\":\"main \\\"thread\\\"\"") >= 0;
+	if (!result)
+		logTestString("Wrong chrome trace:\n%s\n", json.c_str());
+
+	memset(buffer.pointer(), 0, bufferSize);
+	file = fs->createMemoryWriteFile(buffer.pointer(), bufferSize, "trace.bin");
+	result &= profiler.writeTrace(file, EPTF_BINARY);
+	const long size = file->getPos();
+	file->drop();
+
+	u32 header[4];
+	memcpy(header, buffer.const_pointer(), sizeof(header));
+	result &= memcmp(buffer.const_pointer(), "IRTR", 4) == 0 && header[1] == 1;
+	result &= header[2] == profiler.getProfileDataCount() && header[3] == 1;
+	// one begin and one end per call of zone a, b and c
+	result &= size > 16 + 18 * 16;
+	if (!result)
+		logTestString("Wrong binary trace.\n");
+
+	// without events there are no zones in the trace
+	profiler.clearTrace();
+	memset(buffer.pointer(), 0, bufferSize);
+	file = fs->createMemoryWriteFile(buffer.pointer(), bufferSize - 1, "trace.json");
+	result &= profiler.writeTrace(file);
+	file->drop();
+	result &= countOf(core::stringc(buffer.const_pointer()), "\"ph\":\"X\"") == 0;
+
+	return result;
+}
+
+//! Counts the work of frames and adds times which were measured elsewhere
+bool counters()
+{
+	IProfiler& profiler = getProfiler();
+	profiler.endFrame();
+
+	profiler.addToCounter(EPC_SPANS, 10);
+	profiler.addToCounter(EPC_SPANS, 5);
+	bool result = profiler.getCounter(EPC_SPANS, false) == 15 && profiler.getCounter(EPC_SPANS) == 0;
+
+	profiler.endFrame();
+	result &= profiler.getCounter(EPC_SPANS) == 15 && profiler.getCounter(EPC_SPANS, false) == 0;
+
+	core::stringw text;
+	profiler.printAll(text);
+	result &= text.find(L"spans: 15") >= 0;
+
+	profiler.endFrame();
+	result &= profiler.getCounter(EPC_SPANS) == 0;
+	if (!result)
+		logTestString("Wrong counters.\n");
+
+	// the times of many short runs are added at once
+	const s32 id = profiler.add(L"zone e", L"profiler test");
+	profiler.addTime(id, 3000);
+	profiler.addTime(id, 1000);
+	const SProfileData* e = profiler.getProfileDataById(id);
+	result &= e && e->getCallsCounter() == 2 && e->getTimeSumNs() == 4000 && e->getLongestTimeNs() == 3000;
+	if (!result)
+		logTestString("Wrong added times.\n");
+
+	return result;
+}
+
+}
+
+bool profiler(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL);
+	if (!device)
+		return false;
+
+	bool result = zones(device->getTimer());
+	result &= traces(device->getFileSystem());
+	result &= counters();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,154 @@
+// Copyright (C) 2008-2012 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+
+namespace
+{
+
+//! Checks the clusters and potentially visible sets of a level
+bool visibleSets()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_NULL, core::dimension2d<u32>(160, 120));
+	if (!device)
+		return false;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	bool result = device->getFileSystem()->addFileArchive("../media/map-20kdm2.pk3");
+	scene::IAnimatedMesh* mesh = result ? smgr->getMesh("20kdm2.bsp") : 0;
+
+	if (!mesh || mesh->getMeshType() != scene::EAMT_BSP)
+	{
+		logTestString("Could not load the level\n");
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	scene::IQ3LevelMesh* level = (scene::IQ3LevelMesh*)mesh;
+	const scene::IMesh* geometry = level->getMesh(scene::quake3::E_Q3_MESH_GEOMETRY);
+
+	u32 triangles = 0;
+	for (u32 i = 0; i < geometry->getMeshBufferCount(); ++i)
+		triangles += geometry->getMeshBuffer(i)->getIndexCount() / 3;
+
+	// without a cluster everything is visible, in the original order
+	core::array<core::array<u16> > indices;
+	result &= level->getVisibleIndices(-1, indices) == triangles;
+	result &= indices.size() == geometry->getMeshBufferCount();
+	for (u32 i = 0; result && i < indices.size(); ++i)
+	{
+		const scene::IMeshBuffer* buffer = geometry->getMeshBuffer(i);
+		result &= indices[i].size() == buffer->getIndexCount() &&
+			memcmp(indices[i].const_pointer(), buffer->getIndices(), buffer->getIndexCount() * sizeof(u16)) == 0;
+	}
+
+	// a position in the level sees a part of it, and sees its own cluster
+	const s32 cluster = level->getCluster(core::vector3df(1300, 144, 1249));
+	const u32 visible = level->getVisibleIndices(cluster, indices);
+	logTestString("Cluster %d sees %u of %u triangles\n", cluster, visible, triangles);
+	result &= cluster >= 0;
+	result &= visible > 0 && visible < triangles;
+	result &= level->isClusterVisible(cluster, cluster);
+
+	// far outside of the level
+	result &= level->getCluster(core::vector3df(100000.f, 100000.f, 100000.f)) == -1;
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+
+//! Draws the visible set and compares it to the full level
+bool drawVisibleSet(video::E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice *device = createDevice(driverType, core::dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return true; // No error if device does not exist
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	logTestString("Testing driver %ls\n", driver->getName());
+
+	stabilizeScreenBackground(driver);
+
+	device->getFileSystem()->addFileArchive("../media/map-20kdm2.pk3");
+	scene::IAnimatedMesh* mesh = smgr->getMesh("20kdm2.bsp");
+	if (!mesh || mesh->getMeshType() != scene::EAMT_BSP)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	scene::IQ3LevelMesh* level = (scene::IQ3LevelMesh*)mesh;
+
+	scene::ISceneNode* fullNode = smgr->addMeshSceneNode(level->getMesh(scene::quake3::E_Q3_MESH_GEOMETRY));
+	scene::ISceneNode* levelNode = smgr->addQuake3LevelSceneNode(level);
+	bool result = levelNode != 0 && levelNode->getType() == scene::ESNT_Q3_LEVEL;
+
+	if (result)
+	{
+		fullNode->setPosition(core::vector3df(-1300,-144,-1249));
+		fullNode->setMaterialFlag(video::EMF_LIGHTING, false);
+		levelNode->setPosition(core::vector3df(-1300,-144,-1249));
+		levelNode->setMaterialFlag(video::EMF_LIGHTING, false);
+
+		smgr->addCameraSceneNode(0, core::vector3df(0,0,0), core::vector3df(-100,-10,60));
+
+		u32 primitives[2];
+		video::IImage* screenshot[2];
+		for (u32 i = 0; i < 2; ++i)
+		{
+			fullNode->setVisible(i == 0);
+			levelNode->setVisible(i == 1);
+
+			driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,100,101,140));
+			smgr->drawAll();
+			driver->endScene();
+
+			primitives[i] = driver->getPrimitiveCountDrawn();
+			screenshot[i] = driver->createScreenShot();
+		}
+
+		logTestString("Drawn triangles %u of %u\n", primitives[1], primitives[0]);
+		result &= primitives[1] < primitives[0];
+
+		// the potentially visible set contains everything the camera can see,
+		// the software driver has no z-buffer, so fewer faces also change the image there
+		if (screenshot[0] && screenshot[1] && driverType != video::EDT_SOFTWARE)
+		{
+			const u32 size = screenshot[0]->getImageDataSizeInBytes();
+			result &= size == screenshot[1]->getImageDataSizeInBytes() &&
+				memcmp(screenshot[0]->getData(), screenshot[1]->getData(), size) == 0;
+		}
+
+		for (u32 i = 0; i < 2; ++i)
+			if (screenshot[i])
+				screenshot[i]->drop();
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+}
+
+bool q3LevelSceneNode(void)
+{
+	bool result = visibleSets();
+	TestWithAllDrivers(drawVisibleSet);
+	return result;
+}
@@ -439,6 +439,95 @@ static bool compareGetSceneNodeFromRayBBWithBBIntersectsWithLine(IrrlichtDevice
 }
 
 
+// Test that a batch of ellipsoids collides like one ellipsoid after another,
+// on the threads of a job system.
+static bool testGetCollisionResultPositions()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	params.JobThreads = 4;
+	IrrlichtDevice * device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	ISceneManager * smgr = device->getSceneManager();
+	ISceneCollisionManager * collMgr = smgr->getSceneCollisionManager();
+
+	IMesh * hill = smgr->getGeometryCreator()->createHillPlaneMesh(dimension2df(10.f, 10.f),
+		dimension2du(20, 20), 0, 30.f, dimension2df(3.f, 3.f), dimension2df(1.f, 1.f));
+	IMeshSceneNode * hillNode = smgr->addMeshSceneNode(hill);
+	hill->drop();
+	IMeshSceneNode * cubeNode = smgr->addCubeSceneNode(40.f, 0, -1, vector3df(20.f, 10.f, -30.f));
+	smgr->drawAll();
+
+	// the octree is queried on the job threads, the world with the cube isn't
+	ITriangleSelector * hillSelector = smgr->createOctreeTriangleSelector(hillNode->getMesh(), hillNode, 32);
+	IMetaTriangleSelector * world = smgr->createMetaTriangleSelector();
+	world->addTriangleSelector(hillSelector);
+	ITriangleSelector * selector = smgr->createTriangleSelectorFromBoundingBox(cubeNode);
+	world->addTriangleSelector(selector);
+	selector->drop();
+
+	array<SCollisionResponse> responses;
+	for (u32 i = 0; i < 300; ++i)
+	{
+		SCollisionResponse response;
+		response.Selector = (i == 7) ? 0 : (i % 2) ? hillSelector : world;
+		response.Position.set((f32)(i % 17) * 10.f - 85.f, (f32)(i % 5) * 10.f + 5.f, (f32)(i / 17) * 10.f - 85.f);
+		response.Radius.set(3.f + (i % 3), (i == 11) ? 0.f : 5.f, 3.f);
+		response.Direction.set((f32)(i % 7) * 3.f - 9.f, (f32)(i % 4) * -2.f, (f32)(i % 9) * 2.f - 8.f);
+		if (i % 4)
+			response.Gravity.set(0.f, (f32)(i % 4) * -5.f, 0.f);
+		response.SlidingSpeed = 0.0005f * (1 + i % 2);
+		responses.push_back(response);
+	}
+
+	bool result = true;
+	u32 hits = 0;
+	u32 falling = 0;
+	array<SCollisionResponse> batch(responses);
+	collMgr->getCollisionResultPositions(batch.pointer(), batch.size(), device->getJobSystem());
+	for (u32 i = 0; i < responses.size(); ++i)
+	{
+		SCollisionResponse& single = responses[i];
+		single.ResultPosition = collMgr->getCollisionResultPosition(single.Selector,
+			single.Position, single.Radius, single.Direction, single.Triangle,
+			single.HitPosition, single.Falling, single.Node, single.SlidingSpeed, single.Gravity);
+
+		if (single.ResultPosition != batch[i].ResultPosition ||
+			single.HitPosition != batch[i].HitPosition ||
+			single.Triangle != batch[i].Triangle ||
+			single.Falling != batch[i].Falling || single.Node != batch[i].Node)
+		{
+			logTestString("Ellipsoid %d collides differently in the batch\n", i);
+			result = false;
+		}
+		hits += (single.Node != 0);
+		falling += single.Falling;
+	}
+
+	// ellipsoids which don't collide stay where they are
+	result &= batch[7].ResultPosition == batch[7].Position && batch[11].ResultPosition == batch[11].Position;
+
+	// the scene has to collide in all ways
+	if (hits < 50 || falling < 10 || hits == responses.size())
+	{
+		logTestString("Unexpected collisions %d and falling ellipsoids %d\n", hits, falling);
+		result = false;
+	}
+
+	assert_log(result);
+
+	world->drop();
+	hillSelector->drop();
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+
 /** Test functionality of the sceneCollisionManager */
 bool sceneCollisionManager(void)
 {
@@ -464,6 +553,8 @@ bool sceneCollisionManager(void)
 
 	result &= compareGetSceneNodeFromRayBBWithBBIntersectsWithLine(device, smgr, collMgr);
 
+	result &= testGetCollisionResultPositions();
+
 	device->closeDevice();
 	device->run();
 	device->drop();
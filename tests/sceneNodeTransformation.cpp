@@ -0,0 +1,139 @@
+// Copyright (C) 2008-2012 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Counts how often its absolute transformation is calculated
+class CCountingSceneNode : public ISceneNode
+{
+public:
+	CCountingSceneNode(ISceneNode* parent, ISceneManager* mgr)
+		: ISceneNode(parent, mgr), Calculations(0) {}
+
+	virtual void render() {}
+
+	virtual const aabbox3d<f32>& getBoundingBox() const { return Box; }
+
+	virtual matrix4 getRelativeTransformation() const
+	{
+		++Calculations;
+		return ISceneNode::getRelativeTransformation();
+	}
+
+	aabbox3df Box;
+	mutable u32 Calculations;
+};
+
+bool hasPosition(ISceneNode* node, const vector3df& position)
+{
+	if (node->getAbsolutePosition().equals(position))
+		return true;
+
+	logTestString("Absolute position %f %f %f instead of %f %f %f\n",
+		node->getAbsolutePosition().X, node->getAbsolutePosition().Y, node->getAbsolutePosition().Z,
+		position.X, position.Y, position.Z);
+	return false;
+}
+
+}
+
+/** Tests that absolute transformations are only calculated again when
+the relative transformation of the node or of one of its parents changed,
+and that they are still right after each kind of change. */
+bool sceneNodeTransformation(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2d<u32>(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+
+	CCountingSceneNode* first = new CCountingSceneNode(smgr->getRootSceneNode(), smgr);
+	first->setPosition(vector3df(1, 0, 0));
+	CCountingSceneNode* second = new CCountingSceneNode(first, smgr);
+	second->setPosition(vector3df(0, 2, 0));
+	CCountingSceneNode* third = new CCountingSceneNode(second, smgr);
+	third->setPosition(vector3df(0, 0, 3));
+	CCountingSceneNode* other = new CCountingSceneNode(smgr->getRootSceneNode(), smgr);
+	other->setPosition(vector3df(10, 0, 0));
+
+	smgr->drawAll();
+	bool result = hasPosition(third, vector3df(1, 2, 3));
+
+	// static nodes don't calculate anything
+	const u32 calculations = third->Calculations;
+	smgr->drawAll();
+	smgr->drawAll();
+	result &= first->Calculations == 1 && second->Calculations == 1 && third->Calculations == calculations;
+	if (!result)
+		logTestString("Static nodes calculated their absolute transformation again.\n");
+
+	// a change is passed on to the children, the other nodes stay as they are
+	second->setPosition(vector3df(0, 5, 0));
+	smgr->drawAll();
+	result &= hasPosition(third, vector3df(1, 5, 3));
+	result &= first->Calculations == 1 && second->Calculations == 2 && third->Calculations == calculations + 1;
+	result &= other->Calculations == 1;
+
+	// the rotation and the scale work the same way
+	first->setRotation(vector3df(0, 0, 90));
+	first->updateAbsolutePosition();
+	second->updateAbsolutePosition();
+	third->updateAbsolutePosition();
+	result &= hasPosition(third, vector3df(-4, 0, 3));
+	first->setRotation(vector3df(0, 0, 0));
+	first->setScale(vector3df(2, 2, 2));
+	smgr->drawAll();
+	result &= hasPosition(third, vector3df(1, 10, 6));
+
+	// a new parent
+	other->addChild(second);
+	smgr->drawAll();
+	result &= hasPosition(third, vector3df(10, 5, 3));
+	second->remove();
+	second->updateAbsolutePosition();
+	third->updateAbsolutePosition();
+	result &= hasPosition(third, vector3df(0, 5, 3));
+	first->addChild(second);
+	smgr->drawAll();
+	result &= hasPosition(third, vector3df(1, 10, 6));
+
+	// dummy transformation nodes are changed through the matrix
+	IDummyTransformationSceneNode* dummy = smgr->addDummyTransformationSceneNode(first);
+	CCountingSceneNode* child = new CCountingSceneNode(dummy, smgr);
+	smgr->drawAll();
+	result &= hasPosition(child, vector3df(1, 0, 0));
+	dummy->getRelativeTransformationMatrix().setTranslation(vector3df(0, 0, 7));
+	smgr->drawAll();
+	result &= hasPosition(child, vector3df(1, 0, 14));
+
+	// clones start with the transformation of the original
+	ISceneNode* clone = smgr->addEmptySceneNode(first);
+	clone->setPosition(vector3df(0, 0, 1));
+	ISceneNode* cloned = clone->clone(other);
+	cloned->updateAbsolutePosition();
+	result &= hasPosition(cloned, vector3df(10, 0, 1));
+
+	first->drop();
+	second->drop();
+	third->drop();
+	other->drop();
+	child->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		assert_log(false);
+
+	return result;
+}
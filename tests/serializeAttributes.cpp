@@ -224,6 +224,45 @@ bool MemorySerialization(io::IFileSystem * fs )
 	return origMock == copyMock;
 }
 
+// Serialization with an attribute list which is cleared and filled again,
+// so attributes of the first run are reused for the second one.
+bool RecycledSerialization(io::IFileSystem * fs)
+{
+	SerializableMock origMock, resetMock, copyMock;
+	origMock.set();
+	resetMock.reset();
+	copyMock.set();
+
+	io::IAttributes* attr = fs->createEmptyAttributes();
+	origMock.serializeAttributes(attr, 0);
+	attr->clear();
+	resetMock.serializeAttributes(attr, 0);
+	copyMock.deserializeAttributes(attr, 0);
+	COMPARE(resetMock == copyMock, true);
+
+	attr->clear();
+	origMock.serializeAttributes(attr, 0);
+	copyMock.deserializeAttributes(attr, 0);
+	COMPARE(origMock == copyMock, true);
+
+	// lookup after removing an attribute in the middle
+	const s32 count = (s32)attr->getAttributeCount();
+	attr->setAttribute("ValString", (const c8*)0);
+	COMPARE(attr->getAttributeCount(), (u32)count-1);
+	COMPARE(attr->existsAttribute("ValString"), false);
+	COMPARE(attr->getAttributeAsString("ValStringW"), stringc(origMock.ValStringW.c_str()));
+	COMPARE(attr->findAttribute("ValPointer"), count-2);
+
+	// with duplicate names the first attribute is found
+	attr->addInt("ValInt", origMock.ValInt+1);
+	COMPARE(attr->getAttributeAsInt("ValInt"), origMock.ValInt);
+	COMPARE(attr->getAttributeAsInt(count-1), origMock.ValInt+1);
+
+	attr->drop();
+
+	return true;
+}
+
 // Serialization to/from an xml-file
 bool XmlSerialization(io::IFileSystem * fs, video::IVideoDriver * driver )
 {
@@ -358,6 +397,12 @@ bool serializeAttributes()
 		logTestString("MemorySerialization failed in %s:%d\n", __FILE__, __LINE__ );
 	}
 
+	result &= RecycledSerialization(fs);
+	if ( !result )
+	{
+		logTestString("RecycledSerialization failed in %s:%d\n", __FILE__, __LINE__ );
+	}
+
 	result &= XmlSerialization(fs, device->getVideoDriver());
 	if ( !result )
 	{
@@ -2,6 +2,8 @@
 // No rights reserved: this software is in the public domain.
 
 #include "testUtils.h"
+#include <stdio.h>
+#include <string.h>
 
 using namespace irr;
 using namespace core;
@@ -315,6 +317,173 @@ bool lockWithAutoMipmap(video::E_DRIVER_TYPE driverType)
 	return result;
 }
 
+//! finds a file with the extension in the texture cache directory
+io::path findCacheFile(io::IFileSystem* fs, const c8* extension)
+{
+	io::path result;
+	const io::path workingDir = fs->getWorkingDirectory();
+	fs->changeWorkingDirectoryTo("results");
+	io::IFileList* list = fs->createFileList();
+	for (u32 i = 0; i < list->getFileCount(); ++i)
+	{
+		if (core::hasFileExtension(list->getFileName(i), extension))
+			result = list->getFullFileName(i);
+	}
+	list->drop();
+	fs->changeWorkingDirectoryTo(workingDir);
+	return result;
+}
+
+//! Checks the generated mip map levels of the software renderer and the mip map cache
+bool mipMapCache()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return true;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	io::IFileSystem* fs = device->getFileSystem();
+
+	// remove old chains, the test changes them
+	io::path cacheFile = findCacheFile(fs, "mip");
+	while (cacheFile.size() && remove(cacheFile.c_str()) == 0)
+		cacheFile = findCacheFile(fs, "mip");
+
+	driver->setTextureCacheDirectory("results");
+
+	// black and white checker, linear so each level is half grey (rounded down).
+	// names with "light" are linear for burnings video
+	u32 texData[64*64];
+	for (u32 i = 0; i < 64*64; ++i)
+		texData[i] = ((i ^ (i >> 6)) & 1) ? 0xffffffff : 0xff000000;
+	video::IImage* image = driver->createImageFromData(video::ECF_A8R8G8B8, core::dimension2du(64,64), texData, false);
+
+	bool result = true;
+	video::ITexture* tex = driver->addTexture("lightmap1", image);
+	for (u32 level = 1; tex && level < 7; ++level)
+	{
+		video::SColor* bits = (video::SColor*)tex->lock(video::ETLM_READ_ONLY, level);
+		result &= bits && bits[0].color == 0xff7f7f7f;
+		tex->unlock();
+	}
+	if (!result)
+		logTestString("Generated mip map levels are wrong.\n");
+
+	cacheFile = findCacheFile(fs, "mip");
+	result &= cacheFile.size() != 0;
+	if (!result)
+		logTestString("No mip map chain written to the cache.\n");
+
+	// change the 1x1 level at the end of the file, which has to show up in the next texture
+	io::IReadFile* file = cacheFile.size() ? fs->createAndOpenFile(cacheFile) : 0;
+	if (file)
+	{
+		core::array<u8> data;
+		data.set_used((u32)file->getSize());
+		file->read(data.pointer(), data.size());
+		file->drop();
+
+		const u32 marker = 0xff123456;
+		memcpy(data.pointer() + data.size() - 4, &marker, 4);
+		io::IWriteFile* out = fs->createAndWriteFile(cacheFile);
+		out->write(data.const_pointer(), data.size());
+		out->drop();
+
+		video::ITexture* tex2 = driver->addTexture("lightmap2", image);
+		video::SColor* bits = tex2 ? (video::SColor*)tex2->lock(video::ETLM_READ_ONLY, 6) : 0;
+		result &= bits && bits[0].color == marker;
+		if (tex2)
+			tex2->unlock();
+		if (!result)
+			logTestString("Mip map chain was not loaded from the cache.\n");
+		remove(cacheFile.c_str());
+	}
+	image->drop();
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+//! Compresses textures into the texture cache and loads them from there
+bool compressedTextureCache()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_NULL, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return true;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	io::IFileSystem* fs = device->getFileSystem();
+
+	io::path cacheFile = findCacheFile(fs, "pvr");
+	while (cacheFile.size() && remove(cacheFile.c_str()) == 0)
+		cacheFile = findCacheFile(fs, "pvr");
+
+	bool result = !driver->addTextureToCompressionCache("media/tools.png", video::ECF_DXT1);
+	driver->setTextureCacheDirectory("results");
+
+	// one color, so the dxt1 block is known: both endpoints 0x3333, all indices 0
+	u32 texData[64*32];
+	for (u32 i = 0; i < 64*32; ++i)
+		texData[i] = 0xff336699;
+	video::IImage* image = driver->createImageFromData(video::ECF_A8R8G8B8, core::dimension2du(64,32), texData, false);
+	driver->writeImageToFile(image, "results/compressedTexture.png");
+
+	result &= driver->addTextureToCompressionCache("results/compressedTexture.png", video::ECF_DXT5);
+	cacheFile = findCacheFile(fs, "pvr");
+	video::IImage* compressed = cacheFile.size() ? driver->createImageFromFile(cacheFile) : 0;
+	if (compressed)
+	{
+		const u8 block[8] = { 0x33, 0x33, 0x33, 0x33, 0, 0, 0, 0 };
+		result &= compressed->getColorFormat() == video::ECF_DXT1;
+		result &= compressed->getDimension() == core::dimension2du(64,32);
+		result &= memcmp(compressed->getData(), block, 8) == 0;
+
+		// levels 32x16 to 1x1 have 32+8+2+1+1+1 blocks, check the last one
+		result &= compressed->getMipMapsData() != 0 &&
+			memcmp((u8*)compressed->getMipMapsData() + 44*8, block, 8) == 0;
+		compressed->drop();
+		remove(cacheFile.c_str());
+	}
+	else
+		result = false;
+	if (!result)
+		logTestString("Opaque texture was not compressed to DXT1.\n");
+
+	// transparent texels need the format with alpha
+	for (u32 i = 0; i < 64*32; ++i)
+		texData[i] = (i & 1) ? 0x80336699 : 0xff336699;
+	image->drop();
+	image = driver->createImageFromData(video::ECF_A8R8G8B8, core::dimension2du(64,32), texData, false);
+	driver->writeImageToFile(image, "results/compressedTexture.png");
+
+	result &= driver->addTextureToCompressionCache("results/compressedTexture.png", video::ECF_ETC2_RGB);
+	cacheFile = findCacheFile(fs, "pvr");
+	compressed = cacheFile.size() ? driver->createImageFromFile(cacheFile) : 0;
+	if (compressed)
+	{
+		result &= compressed->getColorFormat() == video::ECF_ETC2_ARGB;
+		result &= compressed->getMipMapsData() != 0;
+		compressed->drop();
+		remove(cacheFile.c_str());
+	}
+	else
+		result = false;
+	if (!result)
+		logTestString("Transparent texture was not compressed to ETC2 with alpha.\n");
+
+	image->drop();
+	remove("results/compressedTexture.png");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 //! Tests locking
 bool lockCubemapTexture(video::E_DRIVER_TYPE driverType)
 {
@@ -449,6 +618,8 @@ bool textureFeatures(void)
 	TestWithAllDrivers(lockAllMipLevels);
 	TestWithAllDrivers(lockWithAutoMipmap);
 	TestWithAllDrivers(lockCubemapTexture);
+	result &= mipMapCache();
+	result &= compressedTextureCache();
 
 	return result;
 }
@@ -284,6 +284,376 @@ bool triangle()
 
 	return result;
 }
+
+//! Compares a box query with the triangles found by checking all triangles of the selector
+bool compareBoxQuery(scene::ITriangleSelector* selector, scene::ISceneNode* node,
+		const core::aabbox3df& box, const core::matrix4* transform, s32 arraySize)
+{
+	core::array<core::triangle3df> all;
+	all.set_used(selector->getTriangleCount());
+	s32 count = 0;
+	selector->getTriangles(all.pointer(), all.size(), count, 0, false);
+
+	core::matrix4 inverse;
+	node->getAbsoluteTransformation().getInverse(inverse);
+	core::aabbox3df localBox(box);
+	inverse.transformBoxEx(localBox);
+
+	core::matrix4 mat;
+	if (transform)
+		mat = *transform;
+	mat *= node->getAbsoluteTransformation();
+
+	core::array<core::triangle3df> expected;
+	for (s32 i=0; i<count && (s32)expected.size()<arraySize; ++i)
+	{
+		if (all[i].isTotalOutsideBox(localBox))
+			continue;
+
+		core::triangle3df tri(all[i]);
+		mat.transformVect(tri.pointA);
+		mat.transformVect(tri.pointB);
+		mat.transformVect(tri.pointC);
+		expected.push_back(tri);
+	}
+
+	core::array<core::triangle3df> found;
+	found.set_used(all.size());
+	selector->getTriangles(found.pointer(), arraySize, count, box, transform, true);
+
+	if (count != (s32)expected.size())
+	{
+		logTestString("Box query found %d instead of %d triangles.\n", count, expected.size());
+		return false;
+	}
+	for (s32 i=0; i<count; ++i)
+	{
+		if (found[i] != expected[i])
+		{
+			logTestString("Box query returned a wrong triangle %d.\n", i);
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Compares the triangles of two selectors
+bool compareSelectors(scene::ITriangleSelector* a, scene::ITriangleSelector* b)
+{
+	core::array<core::triangle3df> trianglesA;
+	core::array<core::triangle3df> trianglesB;
+	trianglesA.set_used(a->getTriangleCount());
+	trianglesB.set_used(b->getTriangleCount());
+	s32 countA = 0;
+	s32 countB = 0;
+	a->getTriangles(trianglesA.pointer(), trianglesA.size(), countA, 0, false);
+	b->getTriangles(trianglesB.pointer(), trianglesB.size(), countB, 0, false);
+
+	bool result = countA == countB && countA > 0;
+	for (s32 i=0; result && i<countA; ++i)
+		result = trianglesA[i] == trianglesB[i];
+	return result;
+}
+
+//! Tests box queries of triangle selectors with many triangles, which use a grid
+bool grid()
+{
+	IrrlichtDevice *device = createDevice(video::EDT_NULL);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	scene::IMesh* sphere = smgr->getGeometryCreator()->createSphereMesh(50.f, 48, 48);
+	scene::IMeshSceneNode* node = smgr->addMeshSceneNode(sphere, 0, -1,
+		core::vector3df(20, -30, 40), core::vector3df(10, 45, 0), core::vector3df(1, 2, 1));
+	scene::ITriangleSelector* selector = smgr->createTriangleSelector(sphere, node, true);
+	sphere->drop();
+
+	core::matrix4 scale;
+	scale.setScale(core::vector3df(0.5f, 1.f, 0.25f));
+
+	bool result = true;
+	u32 seed = 1;
+	for (u32 i=0; i<300; ++i)
+	{
+		// move the node sometimes, the transformed triangles have to be updated
+		if (i % 100 == 50)
+		{
+			node->setPosition(node->getPosition() + core::vector3df(5, 0, 0));
+			node->updateAbsolutePosition();
+		}
+
+		seed = seed * 1103515245 + 12345;
+		const core::vector3df center((f32)((seed >> 8) % 200) - 80.f,
+			(f32)((seed >> 16) % 300) - 180.f, (f32)(seed % 200) - 60.f);
+		const f32 size = (f32)((seed >> 4) % 40) + 1.f;
+		const core::aabbox3df box(center - core::vector3df(size), center + core::vector3df(size));
+
+		result &= compareBoxQuery(selector, node, box, (i & 1) ? &scale : 0, (i % 10) ? 10000 : 10);
+	}
+	selector->drop();
+	if (!result)
+		logTestString("Box query of a mesh selector failed.\n");
+
+	// animated meshes only read the changed meshbuffers again
+	const char* const meshes[] = { "../media/ninja.b3d", "../media/sydney.md2" };
+	for (u32 m=0; m<2; ++m)
+	{
+		scene::IAnimatedMeshSceneNode* animated = smgr->addAnimatedMeshSceneNode(smgr->getMesh(meshes[m]));
+		if (!animated)
+		{
+			result = false;
+			continue;
+		}
+		scene::ITriangleSelector* animatedSelector = smgr->createTriangleSelector(animated);
+
+		for (u32 frame=5; frame<=25; frame+=10)
+		{
+			animated->setCurrentFrame((f32)frame);
+			scene::ITriangleSelector* fresh = smgr->createTriangleSelector(animated);
+			if (!compareSelectors(animatedSelector, fresh))
+			{
+				logTestString("Animated selector of %s differs in frame %d.\n", meshes[m], frame);
+				result = false;
+			}
+			const core::aabbox3df box(-10, -10, -10, 10, 20, 10);
+			result &= compareBoxQuery(animatedSelector, animated, box, 0, 10000);
+			fresh->drop();
+		}
+		animatedSelector->drop();
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		assert_log(false);
+
+	return result;
+}
+
+//! Compares the triangles which both selectors find in some boxes
+bool compareOctreeSelectors(scene::ITriangleSelector* a, scene::ITriangleSelector* b)
+{
+	core::array<core::triangle3df> trianglesA;
+	core::array<core::triangle3df> trianglesB;
+	trianglesA.set_used(a->getTriangleCount());
+	trianglesB.set_used(b->getTriangleCount());
+
+	bool result = trianglesA.size() == trianglesB.size();
+	s32 found = 0;
+	u32 seed = 7;
+	for (u32 i=0; result && i<100; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		const core::vector3df center((f32)((seed >> 8) % 200) - 100.f,
+			(f32)((seed >> 16) % 10) - 5.f, (f32)(seed % 200) - 100.f);
+		const f32 size = (f32)((seed >> 4) % 30) + 1.f;
+		const core::aabbox3df box(center - core::vector3df(size), center + core::vector3df(size));
+
+		s32 countA = 0;
+		s32 countB = 0;
+		a->getTriangles(trianglesA.pointer(), trianglesA.size(), countA, box, 0, false);
+		b->getTriangles(trianglesB.pointer(), trianglesB.size(), countB, box, 0, false);
+		result = countA == countB;
+		for (s32 j=0; result && j<countA; ++j)
+			result = trianglesA[j] == trianglesB[j];
+		found += countA;
+	}
+	return result && found > 0;
+}
+
+//! Returns the primitives which an octree scene node draws for some camera positions
+core::array<u32> getDrawnPrimitives(scene::ISceneManager* smgr, scene::ISceneNode* node)
+{
+	core::array<u32> primitives;
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0,
+		core::vector3df(0, 20, 0), core::vector3df(100, 0, 100));
+	camera->setFarValue(100.f);
+	node->setVisible(true);
+	for (u32 i=0; i<5; ++i)
+	{
+		camera->setPosition(core::vector3df(-50.f + i * 40.f, 20.f, -50.f + i * 20.f));
+		smgr->getVideoDriver()->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(0));
+		smgr->drawAll();
+		smgr->getVideoDriver()->endScene();
+		primitives.push_back(smgr->getVideoDriver()->getPrimitiveCountDrawn(0));
+	}
+	node->setVisible(false);
+	camera->remove();
+	return primitives;
+}
+
+//! A file of the octree cache
+struct SCacheFile
+{
+	bool operator<(const SCacheFile& other) const
+	{
+		return Name < other.Name;
+	}
+
+	io::path Name;
+	core::array<c8> Data;
+};
+
+//! Reads the files of the octree cache in the results directory and removes them
+core::array<SCacheFile> takeOctreeCacheFiles(io::IFileSystem* fs)
+{
+	const io::path workingDirectory = fs->getWorkingDirectory();
+	fs->changeWorkingDirectoryTo("results");
+	io::IFileList* list = fs->createFileList();
+	fs->changeWorkingDirectoryTo(workingDirectory);
+
+	core::array<SCacheFile> files;
+	for (u32 i=0; i<list->getFileCount(); ++i)
+	{
+		if (list->isDirectory(i) || !core::hasFileExtension(list->getFileName(i), "octree"))
+			continue;
+
+		files.push_back(SCacheFile());
+		SCacheFile& cacheFile = files.getLast();
+		cacheFile.Name = list->getFileName(i);
+
+		const io::path filename = io::path("results/") + cacheFile.Name;
+		io::IReadFile* file = fs->createAndOpenFile(filename);
+		if (file)
+		{
+			cacheFile.Data.set_used(file->getSize());
+			file->read(cacheFile.Data.pointer(), cacheFile.Data.size());
+			file->drop();
+		}
+		remove(core::stringc(filename).c_str());
+	}
+	list->drop();
+	files.sort();
+	return files;
+}
+
+bool compareCacheFiles(const core::array<SCacheFile>& a, const core::array<SCacheFile>& b)
+{
+	bool result = a.size() == b.size() && a.size() > 0;
+	for (u32 i=0; result && i<a.size(); ++i)
+	{
+		result = a[i].Name == b[i].Name && a[i].Data.size() == b[i].Data.size() &&
+			a[i].Data.size() > 0 && !memcmp(a[i].Data.const_pointer(), b[i].Data.const_pointer(), a[i].Data.size());
+	}
+	return result;
+}
+
+//! Creates an octree scene node and an octree selector for a large mesh
+void createOctrees(IrrlichtDevice* device, scene::IMesh* mesh,
+	scene::ISceneNode*& node, scene::ITriangleSelector*& selector, u32& time)
+{
+	scene::ISceneManager* smgr = device->getSceneManager();
+	const u32 then = device->getTimer()->getRealTime();
+	node = smgr->addOctreeSceneNode(mesh, 0, -1, 256);
+	selector = smgr->createOctreeTriangleSelector(mesh, node, 128);
+	time = device->getTimer()->getRealTime() - then;
+	node->setVisible(false);
+}
+
+//! Tests the octree cache and the octrees which are built on several threads
+bool octreeCache()
+{
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	IrrlichtDevice* device = createDeviceEx(params);
+	assert_log(device);
+	if (!device)
+		return false;
+
+	io::IFileSystem* fs = device->getFileSystem();
+	takeOctreeCacheFiles(fs);
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	smgr->getParameters()->setAttribute(scene::OCTREE_CACHE_DIRECTORY, "results");
+	scene::IMesh* mesh = smgr->getGeometryCreator()->createHillPlaneMesh(core::dimension2df(1.f, 1.f),
+		core::dimension2du(200, 200), 0, 10.f, core::dimension2df(3.f, 3.f), core::dimension2df(10.f, 10.f));
+
+	// built on one thread and written to the cache
+	scene::ISceneNode* node;
+	scene::ITriangleSelector* selector;
+	u32 buildTime;
+	createOctrees(device, mesh, node, selector, buildTime);
+	const core::array<u32> primitives = getDrawnPrimitives(smgr, node);
+	selector->drop();
+	const core::array<SCacheFile> files = takeOctreeCacheFiles(fs);
+	bool result = files.size() == 2;
+
+	// built on several threads, gives the same trees
+	params.JobThreads = 4;
+	IrrlichtDevice* jobDevice = createDeviceEx(params);
+	smgr = jobDevice->getSceneManager();
+	smgr->getParameters()->setAttribute(scene::OCTREE_CACHE_DIRECTORY, "results/");
+
+	u32 parallelTime;
+	createOctrees(jobDevice, mesh, node, selector, parallelTime);
+	result &= getDrawnPrimitives(smgr, node) == primitives;
+	if (!compareCacheFiles(files, takeOctreeCacheFiles(fs)))
+	{
+		logTestString("The octrees built on several threads differ.\n");
+		result = false;
+	}
+
+	// written again and read from the cache
+	scene::ISceneNode* writtenNode;
+	scene::ITriangleSelector* writtenSelector;
+	u32 writeTime;
+	createOctrees(jobDevice, mesh, writtenNode, writtenSelector, writeTime);
+
+	scene::ISceneNode* cachedNode;
+	scene::ITriangleSelector* cachedSelector;
+	u32 cachedTime;
+	createOctrees(jobDevice, mesh, cachedNode, cachedSelector, cachedTime);
+	if (getDrawnPrimitives(smgr, cachedNode) != primitives ||
+		!compareOctreeSelectors(selector, cachedSelector) ||
+		!compareOctreeSelectors(selector, writtenSelector))
+	{
+		logTestString("The octrees read from the cache differ.\n");
+		result = false;
+	}
+	cachedSelector->drop();
+
+	logTestString("Octrees for %d triangles\n    built = %d, built on %d threads = %d, read from cache = %d\n",
+		selector->getTriangleCount(), buildTime, params.JobThreads, parallelTime, cachedTime);
+
+	// broken files are not used
+	const core::array<SCacheFile> cached = takeOctreeCacheFiles(fs);
+	result &= compareCacheFiles(files, cached);
+	for (u32 i=0; i<cached.size(); ++i)
+	{
+		io::IWriteFile* file = fs->createAndWriteFile(io::path("results/") + cached[i].Name);
+		file->write(cached[i].Data.const_pointer(), cached[i].Data.size() / 2);
+		file->drop();
+	}
+	createOctrees(jobDevice, mesh, cachedNode, cachedSelector, cachedTime);
+	if (getDrawnPrimitives(smgr, cachedNode) != primitives ||
+		!compareOctreeSelectors(selector, cachedSelector))
+	{
+		logTestString("Broken files of the octree cache were used.\n");
+		result = false;
+	}
+	cachedSelector->drop();
+	writtenSelector->drop();
+	selector->drop();
+	takeOctreeCacheFiles(fs);
+	mesh->drop();
+
+	jobDevice->closeDevice();
+	jobDevice->run();
+	jobDevice->drop();
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	if (!result)
+		assert_log(false);
+
+	return result;
+}
 }
 
 // Tests need not be accurate, as we just need to include at least
@@ -295,6 +665,8 @@ bool triangleSelector(void)
 
 	result &= octree();
 	result &= triangle();
+	result &= grid();
+	result &= octreeCache();
 
 	return result;
 }
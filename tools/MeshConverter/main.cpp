@@ -18,7 +18,8 @@ void usage(const char* name)
 	std::cerr << "Usage: " << name << " [options] <srcFile> <destFile>" << std::endl;
 	std::cerr << "  where options are" << std::endl;
 	std::cerr << " --createTangents: convert to tangents mesh is possible." << std::endl;
-	std::cerr << " --format=[irrmesh|collada|stl|obj|ply]: Choose target format" << std::endl;
+	std::cerr << " --format=[irrmesh|collada|stl|obj|ply|irrbinmesh]: Choose target format" << std::endl;
+	std::cerr << "  irrbinmesh cooks the mesh into a binary file which loads fast, skinned meshes keep their animations" << std::endl;
 }
 
 int main(int argc, char* argv[])
@@ -54,6 +55,8 @@ int main(int argc, char* argv[])
 					type = EMWT_OBJ;
 				else if (format=="ply")
 					type = EMWT_PLY;
+				else if (format=="irrbinmesh")
+					type = EMWT_IRR_BIN_MESH;
 				else
 					type = EMWT_IRR_MESH;
 			}
@@ -83,12 +86,14 @@ int main(int argc, char* argv[])
 
 	createTangents = createTangents && (type==EMWT_IRR_MESH);
 	std::cout << "Converting " << argv[srcmesh] << " to " << argv[destmesh] << std::endl;
-	IMesh* mesh = device->getSceneManager()->getMesh(argv[srcmesh])->getMesh(0);
-	if (!mesh)
+	IAnimatedMesh* animatedMesh = device->getSceneManager()->getMesh(argv[srcmesh]);
+	if (!animatedMesh)
 	{
 		std::cerr << "Could not load " << argv[srcmesh] << std::endl;
 		return 1;
 	}
+	// cooked meshes are written unanimated, with the joints of skinned meshes
+	IMesh* mesh = (type==EMWT_IRR_BIN_MESH) ? animatedMesh : animatedMesh->getMesh(0);
 	if (createTangents)
 	{
 		IMesh* tmp = device->getSceneManager()->getMeshManipulator()->createMeshWithTangents(mesh);
@@ -0,0 +1,60 @@
+#include <irrlicht.h>
+#include <iostream>
+
+using namespace irr;
+
+using namespace core;
+using namespace scene;
+using namespace video;
+using namespace io;
+using namespace gui;
+
+#ifdef _MSC_VER
+#pragma comment(lib, "Irrlicht.lib")
+#endif
+
+void usage(const char* name)
+{
+	std::cerr << "Usage: " << name << " <srcFile> <destFile>" << std::endl;
+	std::cerr << "  Converts scenes between the .irr and the binary .irrbin format." << std::endl;
+	std::cerr << "  The format is chosen by the file extension of destFile." << std::endl;
+	std::cerr << "  Run it from the directory which the paths in the scene are relative to," << std::endl;
+	std::cerr << "  meshes and textures have to be found to keep them in the scene." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	IrrlichtDevice *device = createDevice( video::EDT_NULL,
+			dimension2d<u32>(800, 600), 32, false, false, false, 0);
+	if (!device)
+		return 1;
+
+	device->setWindowCaption(L"Scene Converter");
+
+	std::cout << "Converting " << argv[1] << " to " << argv[2] << std::endl;
+	ISceneManager* smgr = device->getSceneManager();
+	if (!smgr->loadScene(argv[1]))
+	{
+		std::cerr << "Could not load " << argv[1] << std::endl;
+		device->drop();
+		return 1;
+	}
+
+	if (!smgr->saveScene(argv[2]))
+	{
+		std::cerr << "Could not save " << argv[2] << std::endl;
+		device->drop();
+		return 1;
+	}
+
+	device->drop();
+
+	return 0;
+}
+
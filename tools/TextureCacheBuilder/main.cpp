@@ -0,0 +1,81 @@
+#include <irrlicht.h>
+#include <iostream>
+#include <string.h>
+
+using namespace irr;
+
+using namespace core;
+using namespace scene;
+using namespace video;
+using namespace io;
+using namespace gui;
+
+#ifdef _MSC_VER
+#pragma comment(lib, "Irrlicht.lib")
+#endif
+
+void usage(const char* name)
+{
+	std::cerr << "Usage: " << name << " [-nomipmaps] <dxt|etc2> <cacheDirectory> <textureFile> [textureFile...]" << std::endl;
+	std::cerr << "  Compresses textures into the texture cache directory, applications find them" << std::endl;
+	std::cerr << "  there when they load the textures with ETCF_ALLOW_COMPRESSION and use the" << std::endl;
+	std::cerr << "  same cache directory. dxt is used by Direct3D and OpenGL on desktops, etc2 by" << std::endl;
+	std::cerr << "  OpenGL ES 3. Use -nomipmaps when the textures are loaded without mip maps." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	int arg = 1;
+	bool mipMaps = true;
+	if (arg < argc && !strcmp(argv[arg], "-nomipmaps"))
+	{
+		mipMaps = false;
+		++arg;
+	}
+
+	if (argc - arg < 3)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	ECOLOR_FORMAT format;
+	if (!strcmp(argv[arg], "dxt"))
+		format = ECF_DXT1;
+	else if (!strcmp(argv[arg], "etc2"))
+		format = ECF_ETC2_RGB;
+	else
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	++arg;
+
+	IrrlichtDevice *device = createDevice( video::EDT_NULL,
+			dimension2d<u32>(800, 600), 32, false, false, false, 0);
+	if (!device)
+		return 1;
+
+	device->setWindowCaption(L"Texture Cache Builder");
+	device->getLogger()->setLogLevel(ELL_WARNING);
+
+	IVideoDriver* driver = device->getVideoDriver();
+	driver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, mipMaps);
+	driver->setTextureCacheDirectory(argv[arg++]);
+
+	int result = 0;
+	for (; arg < argc; ++arg)
+	{
+		std::cout << "Compressing " << argv[arg] << std::endl;
+		if (!driver->addTextureToCompressionCache(argv[arg], format))
+		{
+			std::cerr << "Could not compress " << argv[arg] << std::endl;
+			result = 1;
+		}
+	}
+
+	device->drop();
+
+	return result;
+}
+